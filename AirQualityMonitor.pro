@@ -7,27 +7,109 @@ CONFIG += c++17
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 
 SOURCES += \
+    AlertEngine.cpp \
+    AnomalyDetector.cpp \
+    ApiCaptureStore.cpp \
     ApiService.cpp \
+    AqiCalculator.cpp \
+    AqiHistoryStore.cpp \
+    ArchiveImporter.cpp \
+    CacheManifest.cpp \
+    CacheQuery.cpp \
+    CorrelationMatrix.cpp \
     DataAnalyzer.cpp \
     DataParser.cpp \
+    DataRepository.cpp \
     DataStorage.cpp \
+    FleetAnalyzer.cpp \
+    HoltWintersForecaster.cpp \
     Main.cpp \
     MainWindow.cpp \
+    MultiSeriesChart.cpp \
+    QuantileSketch.cpp \
+    SensorDataCache.cpp \
+    SeriesCodec.cpp \
+    StringPool.cpp \
+    TableWriter.cpp \
+    TestAlertEngine.cpp \
+    TestAnomalyDetector.cpp \
+    TestApiCaptureStore.cpp \
+    TestApiService.cpp \
+    TestAqiCalculator.cpp \
+    TestAqiHistoryStore.cpp \
+    TestArchiveImporter.cpp \
+    TestCacheManifest.cpp \
+    TestCacheQuery.cpp \
     TestDataAnalyzer.cpp \
     TestDataParser.cpp \
+    TestDataRepository.cpp \
     TestDataStorage.cpp \
+    TestFleetAnalyzer.cpp \
+    TestHoltWintersForecaster.cpp \
+    TestMultiSeriesChart.cpp \
+    TestQuantileSketch.cpp \
+    TestSensorDataCache.cpp \
+    TestSeriesCodec.cpp \
+    TestStringPool.cpp \
+    TestTableWriter.cpp \
+    TestTimeSeriesResampler.cpp \
+    TestWriteBehindQueue.cpp \
+    TimeSeriesResampler.cpp \
+    TrendEstimator.cpp \
+    WriteBehindQueue.cpp \
     #TestMain.cpp
 
 HEADERS += \
+    AlertEngine.h \
+    AnomalyDetector.h \
+    ApiCaptureStore.h \
     ApiService.h \
+    AqiCalculator.h \
+    AqiHistoryStore.h \
+    ArchiveImporter.h \
+    CacheManifest.h \
+    CacheQuery.h \
+    CorrelationMatrix.h \
     DataAnalyzer.h \
     DataParser.h \
+    DataRepository.h \
     DataStorage.h \
     DataStructures.h \
+    FleetAnalyzer.h \
+    HoltWintersForecaster.h \
     MainWindow.h \
+    MultiSeriesChart.h \
+    QuantileSketch.h \
+    SensorDataCache.h \
+    SeriesCodec.h \
+    StringPool.h \
+    TableWriter.h \
+    TestAlertEngine.h \
+    TestAnomalyDetector.h \
+    TestApiCaptureStore.h \
+    TestApiService.h \
+    TestAqiCalculator.h \
+    TestAqiHistoryStore.h \
+    TestArchiveImporter.h \
+    TestCacheManifest.h \
+    TestCacheQuery.h \
     TestDataAnalyzer.h \
     TestDataParser.h \
-    TestDataStorage.h
+    TestDataRepository.h \
+    TestDataStorage.h \
+    TestFleetAnalyzer.h \
+    TestHoltWintersForecaster.h \
+    TestMultiSeriesChart.h \
+    TestQuantileSketch.h \
+    TestSensorDataCache.h \
+    TestSeriesCodec.h \
+    TestStringPool.h \
+    TestTableWriter.h \
+    TestTimeSeriesResampler.h \
+    TestWriteBehindQueue.h \
+    TimeSeriesResampler.h \
+    TrendEstimator.h \
+    WriteBehindQueue.h
 
 FORMS += \
     MainWindow.ui
@@ -0,0 +1,447 @@
+#include "AlertEngine.h"
+#include "AqiCalculator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// Poziom indeksu, którego dotyczy reguła AQI (ogólny lub zanieczyszczenia); -1, jeśli kod jest nieznany.
+int ruleIndexLevel(const AlertRule& rule, const AirQualityIndex& index)
+{
+    if (rule.paramCode.isEmpty()) {
+        return index.stIndexLevel;
+    }
+    const std::optional<Pollutant> pollutant = AqiCalculator::pollutantFromCode(rule.paramCode);
+    return pollutant ? index.level(*pollutant) : NoIndexLevel;
+}
+
+/// Usuwa zdarzenia nie nowsze niż `reportedMSecs` (zgłoszone już przed ponownym uruchomieniem).
+void dropReportedEvents(std::vector<AlertEvent>& events, qint64 reportedMSecs)
+{
+    events.erase(std::remove_if(events.begin(), events.end(), [reportedMSecs](const AlertEvent& event) {
+        return event.date.toMSecsSinceEpoch() <= reportedMSecs;
+    }), events.end());
+}
+
+/// Czy seria posortowana wg daty jest rosnąca (porównuje skrajne pomiary z prawidłową datą).
+bool isAscending(const std::vector<MeasurementValue>& values)
+{
+    auto first = std::find_if(values.cbegin(), values.cend(), [](const MeasurementValue& mv) { return mv.date.isValid(); });
+    auto last = std::find_if(values.crbegin(), values.crend(), [](const MeasurementValue& mv) { return mv.date.isValid(); });
+    return first != values.cend() && first->date <= last->date;
+}
+
+} // namespace
+
+bool AlertEngine::isValidRule(const AlertRule& rule)
+{
+    if (rule.source == AlertSource::Measurement && rule.paramCode.trimmed().isEmpty()) {
+        return false;
+    }
+    // Wyższy próg wyłączenia przełączałby alert przy każdym pomiarze między progami
+    return std::isnan(rule.clearThreshold) || rule.clearThreshold <= rule.threshold;
+}
+
+int AlertEngine::addRule(AlertRule rule)
+{
+    if (!isValidRule(rule)) {
+        return -1;
+    }
+    if (rule.id <= 0) {
+        rule.id = m_nextRuleId;
+    }
+    for (const AlertRule& existing : m_rules) {
+        if (existing.id == rule.id) {
+            return -1;
+        }
+    }
+    m_nextRuleId = std::max(m_nextRuleId, rule.id + 1);
+    m_rules.push_back(rule);
+    rebuild();
+    return rule.id;
+}
+
+bool AlertEngine::removeRule(int ruleId)
+{
+    auto it = std::find_if(m_rules.begin(), m_rules.end(), [ruleId](const AlertRule& rule) { return rule.id == ruleId; });
+    if (it == m_rules.end()) {
+        return false;
+    }
+    m_rules.erase(it);
+    rebuild();
+    return true;
+}
+
+void AlertEngine::setRules(const std::vector<AlertRule>& rules)
+{
+    m_reported = progress();
+    m_rules.clear();
+    m_sensors.clear();
+    m_stations.clear();
+    m_nextRuleId = 1;
+    for (const AlertRule& rule : rules) {
+        if (!isValidRule(rule)) {
+            continue;
+        }
+        AlertRule copy = rule;
+        const bool idTaken = std::any_of(m_rules.begin(), m_rules.end(), [&copy](const AlertRule& r) { return r.id == copy.id; });
+        if (copy.id <= 0 || idTaken) {
+            copy.id = -1;
+        }
+        m_rules.push_back(copy);
+        if (copy.id > 0) {
+            m_nextRuleId = std::max(m_nextRuleId, copy.id + 1);
+        }
+    }
+    // ID nadawane na końcu, aby nie kolidowały z ID podanymi w dalszych regułach
+    for (AlertRule& rule : m_rules) {
+        if (rule.id <= 0) {
+            rule.id = m_nextRuleId++;
+        }
+    }
+    rebuild();
+}
+
+std::vector<AlertRule> AlertEngine::rules() const
+{
+    return m_rules;
+}
+
+void AlertEngine::setSensors(const std::vector<Sensor>& sensors)
+{
+    for (const Sensor& sensor : sensors) {
+        const std::pair<int, QString> info(sensor.stationId, sensor.param.paramCode.trimmed().toUpper());
+        auto existing = m_sensorInfo.constFind(sensor.id);
+        if (existing != m_sensorInfo.constEnd() && *existing == info) {
+            continue;
+        }
+        m_sensorInfo.insert(sensor.id, info);
+
+        auto state = m_sensors.find(sensor.id);
+        if (state != m_sensors.end()) {
+            state->stationId = info.first;
+            if (!info.second.isEmpty()) {
+                state->paramCode = info.second;
+            }
+            rebindSensor(sensor.id, *state);
+        }
+    }
+}
+
+void AlertEngine::setStations(const std::vector<MeasuringStation>& stations)
+{
+    bool changed = false;
+    for (const MeasuringStation& station : stations) {
+        const QString province = station.city.commune.provinceName.trimmed();
+        auto existing = m_stationProvinces.constFind(station.id);
+        if (existing == m_stationProvinces.constEnd() || *existing != province) {
+            m_stationProvinces.insert(station.id, province);
+            changed = true;
+        }
+    }
+    if (changed) {
+        rebuild();
+    }
+}
+
+bool AlertEngine::matchesStation(const AlertRule& rule, int stationId) const
+{
+    if (rule.stationId > 0 && rule.stationId != stationId) {
+        return false;
+    }
+    if (!rule.provinceName.isEmpty()) {
+        const QString province = m_stationProvinces.value(stationId);
+        if (province.compare(rule.provinceName.trimmed(), Qt::CaseInsensitive) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AlertEngine::rebindSensor(int sensorId, SensorState& state) const
+{
+    std::vector<Binding> bindings;
+    auto candidates = m_measurementRules.constFind(state.paramCode);
+    if (candidates != m_measurementRules.constEnd()) {
+        for (int ruleIndex : *candidates) {
+            const AlertRule& rule = m_rules[static_cast<std::size_t>(ruleIndex)];
+            if ((rule.sensorId > 0 && rule.sensorId != sensorId) || !matchesStation(rule, state.stationId)) {
+                continue;
+            }
+            auto previous = std::find_if(state.bindings.begin(), state.bindings.end(),
+                                         [&rule](const Binding& b) { return b.ruleId == rule.id; });
+            Binding binding = previous != state.bindings.end() ? std::move(*previous) : Binding();
+            binding.ruleId = rule.id;
+            binding.ruleIndex = ruleIndex;
+            bindings.push_back(std::move(binding));
+        }
+    }
+    state.bindings = std::move(bindings);
+}
+
+void AlertEngine::rebindStation(int stationId, StationState& state) const
+{
+    std::vector<Binding> bindings;
+    for (int ruleIndex : m_indexRules) {
+        const AlertRule& rule = m_rules[static_cast<std::size_t>(ruleIndex)];
+        if (!matchesStation(rule, stationId)) {
+            continue;
+        }
+        auto previous = std::find_if(state.bindings.begin(), state.bindings.end(),
+                                     [&rule](const Binding& b) { return b.ruleId == rule.id; });
+        Binding binding = previous != state.bindings.end() ? std::move(*previous) : Binding();
+        binding.ruleId = rule.id;
+        binding.ruleIndex = ruleIndex;
+        bindings.push_back(std::move(binding));
+    }
+    state.bindings = std::move(bindings);
+}
+
+void AlertEngine::rebuild()
+{
+    m_measurementRules.clear();
+    m_indexRules.clear();
+    for (std::size_t i = 0; i < m_rules.size(); ++i) {
+        const AlertRule& rule = m_rules[i];
+        if (!rule.enabled) {
+            continue;
+        }
+        if (rule.source == AlertSource::Measurement) {
+            m_measurementRules[rule.paramCode.trimmed().toUpper()].push_back(static_cast<int>(i));
+        } else {
+            m_indexRules.push_back(static_cast<int>(i));
+        }
+    }
+
+    for (auto it = m_sensors.begin(); it != m_sensors.end(); ++it) {
+        rebindSensor(it.key(), it.value());
+    }
+    for (auto it = m_stations.begin(); it != m_stations.end(); ++it) {
+        rebindStation(it.key(), it.value());
+    }
+}
+
+void AlertEngine::evaluate(Binding& binding, double value, int sensorId, int stationId, const QDateTime& date,
+                           std::vector<AlertEvent>& events) const
+{
+    const AlertRule& rule = m_rules[static_cast<std::size_t>(binding.ruleIndex)];
+    bool changed = false;
+    if (!binding.active) {
+        const bool exceeded = rule.comparison == AlertComparison::Greater ? value > rule.threshold : value >= rule.threshold;
+        changed = exceeded;
+    } else {
+        const double clearThreshold = std::isnan(rule.clearThreshold) ? rule.threshold : rule.clearThreshold;
+        changed = value < clearThreshold;
+    }
+    if (!changed) {
+        return;
+    }
+
+    binding.active = !binding.active;
+    AlertEvent event;
+    event.ruleId = rule.id;
+    event.ruleName = rule.name;
+    event.raised = binding.active;
+    event.sensorId = sensorId;
+    event.stationId = stationId;
+    event.date = date;
+    event.value = value;
+    events.push_back(event);
+}
+
+std::vector<AlertEvent> AlertEngine::addSensorData(int sensorId, const SensorData& data)
+{
+    std::vector<AlertEvent> events;
+
+    const bool known = m_sensors.contains(sensorId);
+    SensorState& state = m_sensors[sensorId];
+    int stationId = state.stationId;
+    QString paramCode = state.paramCode;
+    auto info = m_sensorInfo.constFind(sensorId);
+    if (info != m_sensorInfo.constEnd()) {
+        stationId = info->first;
+        if (!info->second.isEmpty()) {
+            paramCode = info->second;
+        }
+    }
+    if (paramCode.isEmpty()) {
+        paramCode = data.key.trimmed().toUpper();
+    }
+    if (!known || stationId != state.stationId || paramCode != state.paramCode) {
+        state.stationId = stationId;
+        state.paramCode = paramCode;
+        rebindSensor(sensorId, state);
+    }
+
+    // Nowe pomiary są na najnowszym końcu serii - przeglądanie kończy się na pierwszym już przetworzonym,
+    // więc koszt zależy od liczby nowych pomiarów, a nie od długości historii.
+    std::vector<std::pair<qint64, const MeasurementValue*>> fresh;
+    m_lastScanned = 0;
+    auto collect = [&](const MeasurementValue& mv) {
+        ++m_lastScanned;
+        if (!mv.date.isValid()) {
+            return true;
+        }
+        const qint64 msecs = mv.date.toMSecsSinceEpoch();
+        if (msecs <= state.lastMSecs) {
+            return false;
+        }
+        if (!std::isnan(mv.value)) {
+            fresh.emplace_back(msecs, &mv);
+        }
+        return true;
+    };
+    if (isAscending(data.values)) {
+        for (auto it = data.values.crbegin(); it != data.values.crend() && collect(*it); ++it) {
+        }
+    } else {
+        for (auto it = data.values.cbegin(); it != data.values.cend() && collect(*it); ++it) {
+        }
+    }
+    if (fresh.empty()) {
+        return events;
+    }
+    std::sort(fresh.begin(), fresh.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    state.lastMSecs = fresh.back().first;
+
+    for (const auto& point : fresh) {
+        const double value = point.second->value;
+        for (Binding& binding : state.bindings) {
+            const AlertRule& rule = m_rules[static_cast<std::size_t>(binding.ruleIndex)];
+            if (rule.windowHours <= 0) {
+                evaluate(binding, value, sensorId, state.stationId, point.second->date, events);
+                continue;
+            }
+
+            const qint64 windowStart = point.first - static_cast<qint64>(rule.windowHours) * 3600 * 1000;
+            binding.window.emplace_back(point.first, value);
+            binding.windowSum += value;
+            while (!binding.window.empty() && binding.window.front().first <= windowStart) {
+                binding.windowSum -= binding.window.front().second;
+                binding.window.pop_front();
+            }
+            const double required = std::ceil(std::clamp(rule.minCoverage, 0.0, 1.0) * rule.windowHours);
+            if (static_cast<double>(binding.window.size()) >= std::max(1.0, required)) {
+                const double mean = binding.windowSum / static_cast<double>(binding.window.size());
+                evaluate(binding, mean, sensorId, state.stationId, point.second->date, events);
+            }
+        }
+    }
+    auto reported = m_reported.sensors.constFind(sensorId);
+    if (reported != m_reported.sensors.constEnd()) {
+        dropReportedEvents(events, *reported);
+    }
+    return events;
+}
+
+std::vector<AlertEvent> AlertEngine::addAirQualityIndex(const AirQualityIndex& index)
+{
+    std::vector<AlertEvent> events;
+    if (index.stationId <= 0 || m_indexRules.empty()) {
+        return events;
+    }
+
+    const bool known = m_stations.contains(index.stationId);
+    StationState& state = m_stations[index.stationId];
+    if (!known) {
+        rebindStation(index.stationId, state);
+    }
+    if (state.lastCalcDate.isValid() && (!index.stCalcDate.isValid() || index.stCalcDate <= state.lastCalcDate)) {
+        return events;
+    }
+    state.lastCalcDate = index.stCalcDate;
+
+    for (Binding& binding : state.bindings) {
+        const int level = ruleIndexLevel(m_rules[static_cast<std::size_t>(binding.ruleIndex)], index);
+        if (level >= 0) {
+            evaluate(binding, level, -1, index.stationId, index.stCalcDate, events);
+        }
+    }
+    auto reported = m_reported.stations.constFind(index.stationId);
+    if (reported != m_reported.stations.constEnd()) {
+        dropReportedEvents(events, *reported);
+    }
+    return events;
+}
+
+std::size_t AlertEngine::lastScannedCount() const
+{
+    return m_lastScanned;
+}
+
+int AlertEngine::activeAlertCount() const
+{
+    int count = 0;
+    for (const SensorState& state : m_sensors) {
+        count += static_cast<int>(std::count_if(state.bindings.begin(), state.bindings.end(),
+                                                [](const Binding& b) { return b.active; }));
+    }
+    for (const StationState& state : m_stations) {
+        count += static_cast<int>(std::count_if(state.bindings.begin(), state.bindings.end(),
+                                                [](const Binding& b) { return b.active; }));
+    }
+    return count;
+}
+
+AlertProgress AlertEngine::progress() const
+{
+    AlertProgress progress = m_reported;
+    for (auto it = m_sensors.constBegin(); it != m_sensors.constEnd(); ++it) {
+        if (it->lastMSecs != std::numeric_limits<qint64>::min()) {
+            progress.sensors.insert(it.key(), std::max(it->lastMSecs, progress.sensors.value(it.key(), it->lastMSecs)));
+        }
+    }
+    for (auto it = m_stations.constBegin(); it != m_stations.constEnd(); ++it) {
+        if (it->lastCalcDate.isValid()) {
+            const qint64 msecs = it->lastCalcDate.toMSecsSinceEpoch();
+            progress.stations.insert(it.key(), std::max(msecs, progress.stations.value(it.key(), msecs)));
+        }
+    }
+    return progress;
+}
+
+void AlertEngine::restoreProgress(const AlertProgress& progress)
+{
+    m_reported = progress;
+}
+
+QString AlertEngine::describe(const AlertEvent& event)
+{
+    QString where = event.sensorId > 0 ? QString("czujnik %1").arg(event.sensorId) : QString();
+    if (event.stationId > 0) {
+        where = where.isEmpty() ? QString("stacja %1").arg(event.stationId)
+                                : QString("%1, stacja %2").arg(where).arg(event.stationId);
+    }
+    return QString("%1: %2 (%3, wartość %4, %5)")
+        .arg(event.raised ? "Alert" : "Koniec alertu")
+        .arg(event.ruleName)
+        .arg(where)
+        .arg(QString::number(event.value, 'f', 1))
+        .arg(event.date.toString("HH:mm dd.MM"));
+}
+
+std::vector<AlertRule> AlertEngine::defaultRules()
+{
+    AlertRule pm10;
+    pm10.name = "Średnia 24h PM10 powyżej 50 µg/m³";
+    pm10.paramCode = "PM10";
+    pm10.windowHours = 24;
+    pm10.threshold = 50.0;
+    pm10.clearThreshold = 45.0;
+
+    AlertRule pm25;
+    pm25.name = "Średnia 24h PM2.5 powyżej 25 µg/m³";
+    pm25.paramCode = "PM2.5";
+    pm25.windowHours = 24;
+    pm25.threshold = 25.0;
+    pm25.clearThreshold = 22.5;
+
+    AlertRule index;
+    index.name = "Indeks jakości powietrza co najmniej \"Zły\"";
+    index.source = AlertSource::AirQualityIndex;
+    index.comparison = AlertComparison::GreaterOrEqual;
+    index.threshold = 4.0;
+
+    return {pm10, pm25, index};
+}
@@ -0,0 +1,215 @@
+/**
+ * @file AlertEngine.h
+ * @brief Definicja klasy AlertEngine - reguł przekroczeń (pomiary, indeks AQI) ocenianych przyrostowo, z histerezą.
+ */
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @enum AlertSource
+ * @brief Źródło wartości ocenianej przez regułę.
+ */
+enum class AlertSource {
+    Measurement,    ///< Pomiary czujnika (ostatni pomiar lub średnia krocząca).
+    AirQualityIndex ///< Poziom indeksu AQI stacji (0-5; ogólny lub dla zanieczyszczenia).
+};
+
+/**
+ * @enum AlertComparison
+ * @brief Warunek włączenia alertu względem progu.
+ */
+enum class AlertComparison {
+    Greater,       ///< Wartość > próg (np. "średnia PM10 powyżej 50").
+    GreaterOrEqual ///< Wartość >= próg (np. "poziom AQI co najmniej 4").
+};
+
+/**
+ * @struct AlertRule
+ * @brief Reguła alertu: predykaty (czujnik, parametr, stacja, województwo) i warunek progowy z histerezą.
+ *
+ * Puste/ujemne predykaty oznaczają "dowolny". Alert włącza się, gdy wartość spełni warunek progu, a wyłącza
+ * dopiero, gdy spadnie poniżej `clearThreshold` - wahania wokół progu nie powodują serii alertów.
+ */
+struct AlertRule {
+    int id = -1;                ///< ID reguły (nadawane przez AlertEngine::addRule(), jeśli <= 0).
+    QString name;               ///< Nazwa wyświetlana w powiadomieniach.
+    bool enabled = true;        ///< Czy reguła jest oceniana.
+    AlertSource source = AlertSource::Measurement; ///< Źródło wartości.
+    /**
+     * @brief Kod parametru (np. "PM10").
+     * Measurement: wymagany. AirQualityIndex: kod zanieczyszczenia lub pusty dla indeksu ogólnego.
+     */
+    QString paramCode;
+    int sensorId = -1;          ///< Tylko ten czujnik (-1 - dowolny).
+    int stationId = -1;         ///< Tylko ta stacja (-1 - dowolna).
+    QString provinceName;       ///< Tylko stacje z tego województwa, bez rozróżniania wielkości liter (puste - dowolne).
+    int windowHours = 0;        ///< Measurement: długość średniej kroczącej w godzinach (0 - ostatni pomiar).
+    double minCoverage = 0.75;  ///< Measurement: minimalny odsetek godzin okna z pomiarem, aby średnia była oceniana.
+    AlertComparison comparison = AlertComparison::Greater; ///< Warunek włączenia.
+    double threshold = 0.0;     ///< Próg włączenia alertu.
+    double clearThreshold = std::numeric_limits<double>::quiet_NaN(); ///< Alert wyłącza się, gdy wartość < clearThreshold (NaN - równy threshold; nie większy niż threshold).
+};
+
+/**
+ * @struct AlertProgress
+ * @brief Daty, do których zmiany stanu alertów zostały już zgłoszone (zapisywane przez DataStorage::saveAlertProgress()).
+ *
+ * Po ponownym uruchomieniu aplikacji stan alertów jest odtwarzany z pobranych danych, ale zmiany stanu
+ * dla pomiarów i indeksów nie nowszych niż zapisane daty nie są zgłaszane ponownie.
+ */
+struct AlertProgress {
+    QHash<int, qint64> sensors;  ///< ID czujnika -> data ostatniego ocenionego pomiaru (ms od epoki).
+    QHash<int, qint64> stations; ///< ID stacji -> data ostatnio ocenionego indeksu AQI (ms od epoki).
+};
+
+/**
+ * @struct AlertEvent
+ * @brief Zmiana stanu alertu (włączenie lub wyłączenie) dla jednej reguły i jednego czujnika/stacji.
+ */
+struct AlertEvent {
+    int ruleId = -1;            ///< ID reguły.
+    QString ruleName;           ///< Nazwa reguły.
+    bool raised = true;         ///< `true` - alert włączony, `false` - wyłączony (powrót poniżej progu wyłączenia).
+    int sensorId = -1;          ///< ID czujnika (-1 dla reguł AQI).
+    int stationId = -1;         ///< ID stacji (-1, jeśli nieznana).
+    QDateTime date;             ///< Data pomiaru lub obliczenia indeksu, który zmienił stan.
+    double value = 0.0;         ///< Oceniana wartość (pomiar, średnia lub poziom indeksu).
+};
+
+/**
+ * @class AlertEngine
+ * @brief Ocenia reguły alertów przyrostowo, w miarę napływu pomiarów i indeksów AQI.
+ *
+ * Reguły pomiarowe są indeksowane kodem parametru, a dla każdego czujnika zapamiętywana jest lista pasujących do niego
+ * reguł (przeliczana tylko po zmianie reguł lub metadanych czujnika/stacji). Każdy czujnik pamięta datę ostatniego przetworzonego
+ * pomiaru, a każda para (reguła, czujnik) - okno średniej kroczącej z bieżącą sumą. Koszt jest więc proporcjonalny do
+ * liczby nowych pomiarów i reguł pasujących do czujnika - nie zależy od długości historii ani od liczby pozostałych reguł.
+ *
+ * Średnie kroczące zakładają pomiary godzinowe (jak w API GIOS): okno `windowHours` godzin kończy się na bieżącym
+ * pomiarze, a średnia jest oceniana, gdy zawiera co najmniej `minCoverage · windowHours` pomiarów.
+ */
+class AlertEngine
+{
+public:
+    /** @brief Konstruktor (bez reguł). */
+    AlertEngine() = default;
+
+    /**
+     * @brief Dodaje regułę.
+     * @return ID reguły (podane w regule lub nowo nadane); -1, jeśli reguła pomiarowa nie ma kodu parametru,
+     *         `clearThreshold` jest większy niż `threshold` albo ID jest już zajęte.
+     */
+    int addRule(AlertRule rule);
+    /** @brief Usuwa regułę wraz ze stanem jej alertów. @return `false`, jeśli reguła nie istnieje. */
+    bool removeRule(int ruleId);
+    /**
+     * @brief Zastępuje wszystkie reguły (np. wczytane z DataStorage); nieprawidłowe reguły są pomijane.
+     * Stan alertów jest zerowany, a zmiany stanu dla już ocenionych danych nie są zgłaszane ponownie.
+     */
+    void setRules(const std::vector<AlertRule>& rules);
+    /** @brief Zwraca reguły w kolejności dodania. */
+    std::vector<AlertRule> rules() const;
+
+    /** @brief Dopisuje metadane czujników (ID stacji i kod parametru) używane przez predykaty. */
+    void setSensors(const std::vector<Sensor>& sensors);
+    /** @brief Dopisuje województwa stacji używane przez predykat `provinceName`. */
+    void setStations(const std::vector<MeasuringStation>& stations);
+
+    /**
+     * @brief Ocenia reguły pomiarowe dla pomiarów czujnika nowszych niż ostatnio przetworzone.
+     * @param sensorId ID czujnika.
+     * @param data Dane czujnika posortowane wg daty - malejąco (jak z API) lub rosnąco (jak z DataStorage); NaN jest
+     *             pomijany. Przeglądane są tylko pomiary od najnowszego do pierwszego już przetworzonego.
+     *             `data.key` jest kodem parametru, jeśli czujnik nie został podany w setSensors().
+     * @return Zmiany stanu alertów w kolejności czasu.
+     */
+    std::vector<AlertEvent> addSensorData(int sensorId, const SensorData& data);
+
+    /**
+     * @brief Ocenia reguły AQI dla indeksu stacji (tylko, gdy jest nowszy niż ostatnio oceniony).
+     * @return Zmiany stanu alertów.
+     */
+    std::vector<AlertEvent> addAirQualityIndex(const AirQualityIndex& index);
+
+    /** @brief Liczba aktualnie włączonych alertów. */
+    int activeAlertCount() const;
+    /** @brief Liczba pomiarów przejrzanych przez ostatnie wywołanie addSensorData() (diagnostyka kosztu aktualizacji). */
+    std::size_t lastScannedCount() const;
+
+    /** @brief Zwraca daty, do których zmiany stanu alertów zostały zgłoszone (do zapisania w DataStorage). */
+    AlertProgress progress() const;
+    /**
+     * @brief Odtwarza daty zgłoszonych zmian stanu (np. wczytane z DataStorage po uruchomieniu).
+     * Kolejne dane są oceniane w całości (odbudowa okien i stanu alertów), ale zdarzenia dla pomiarów
+     * i indeksów nie nowszych niż zapisane daty nie są zwracane.
+     */
+    void restoreProgress(const AlertProgress& progress);
+
+    /** @brief Opis zmiany stanu alertu do wyświetlenia (np. w pasku stanu). */
+    static QString describe(const AlertEvent& event);
+
+    /**
+     * @brief Reguły domyślne: średnia 24 h PM10 powyżej 50 µg/m³ i PM2.5 powyżej 25 µg/m³ (poziomy dobowe)
+     *        oraz ogólny indeks AQI co najmniej "Zły" (4).
+     */
+    static std::vector<AlertRule> defaultRules();
+
+private:
+    /// Stan reguły dla jednego czujnika lub stacji.
+    struct Binding {
+        int ruleId = -1;                        ///< ID reguły.
+        int ruleIndex = -1;                     ///< Indeks reguły w m_rules.
+        bool active = false;                    ///< Czy alert jest włączony.
+        std::deque<std::pair<qint64, double>> window; ///< Pomiary okna średniej (ms od epoki, wartość).
+        double windowSum = 0.0;                 ///< Suma wartości okna.
+    };
+
+    /// Stan czujnika: ostatni przetworzony pomiar i pasujące do niego reguły.
+    struct SensorState {
+        int stationId = -1;                     ///< ID stacji czujnika (-1 - nieznana).
+        QString paramCode;                      ///< Kod parametru (wielkie litery).
+        qint64 lastMSecs = std::numeric_limits<qint64>::min(); ///< Data ostatniego przetworzonego pomiaru.
+        std::vector<Binding> bindings;          ///< Reguły pasujące do czujnika.
+    };
+
+    /// Stan stacji dla reguł AQI.
+    struct StationState {
+        QDateTime lastCalcDate;                 ///< Data ostatnio ocenionego indeksu.
+        std::vector<Binding> bindings;          ///< Reguły AQI pasujące do stacji.
+    };
+
+    /// Czy reguła może być oceniana (kod parametru dla reguł pomiarowych, próg wyłączenia nie wyższy niż próg).
+    static bool isValidRule(const AlertRule& rule);
+    /// Czy predykaty stacji (stationId, provinceName) reguły pasują do stacji.
+    bool matchesStation(const AlertRule& rule, int stationId) const;
+    /// Wyznacza na nowo reguły czujnika, zachowując stan reguł, które nadal pasują.
+    void rebindSensor(int sensorId, SensorState& state) const;
+    /// Wyznacza na nowo reguły AQI stacji, zachowując stan reguł, które nadal pasują.
+    void rebindStation(int stationId, StationState& state) const;
+    /// Przebudowuje indeksy reguł i przypisania reguł wszystkich czujników i stacji (po zmianie reguł).
+    void rebuild();
+    /// Ocenia warunek z histerezą; dopisuje zdarzenie przy zmianie stanu.
+    void evaluate(Binding& binding, double value, int sensorId, int stationId, const QDateTime& date,
+                  std::vector<AlertEvent>& events) const;
+
+    std::vector<AlertRule> m_rules;                     ///< Reguły w kolejności dodania.
+    QHash<QString, std::vector<int>> m_measurementRules; ///< Kod parametru (wielkie litery) -> indeksy reguł pomiarowych.
+    std::vector<int> m_indexRules;                      ///< Indeksy reguł AQI.
+    QHash<int, std::pair<int, QString>> m_sensorInfo;   ///< ID czujnika -> (ID stacji, kod parametru).
+    QHash<int, QString> m_stationProvinces;             ///< ID stacji -> województwo.
+    QHash<int, SensorState> m_sensors;                  ///< Stan czujników.
+    QHash<int, StationState> m_stations;                ///< Stan stacji (reguły AQI).
+    AlertProgress m_reported;                           ///< Daty zgłoszonych zmian stanu sprzed restoreProgress()/setRules().
+    int m_nextRuleId = 1;                               ///< Kolejne wolne ID reguły.
+    std::size_t m_lastScanned = 0;                      ///< Pomiary przejrzane przez ostatnie addSensorData().
+};
+
+#endif // ALERTENGINE_H
@@ -0,0 +1,110 @@
+#include "AnomalyDetector.h"
+#include <algorithm>
+#include <cmath>
+
+AnomalyDetector::AnomalyDetector(const AnomalyDetectorOptions& options) : m_options(options)
+{
+    m_options.windowSize = std::max(3, m_options.windowSize);
+    m_options.minHistory = std::clamp(m_options.minHistory, 3, m_options.windowSize);
+    m_options.flatlineLength = std::max(2, m_options.flatlineLength);
+    m_sorted.reserve(static_cast<std::size_t>(m_options.windowSize));
+}
+
+const AnomalyDetectorOptions& AnomalyDetector::options() const
+{
+    return m_options;
+}
+
+void AnomalyDetector::reset()
+{
+    m_window.clear();
+    m_sorted.clear();
+    m_lastValue = std::numeric_limits<double>::quiet_NaN();
+    m_repeatCount = 0;
+    m_flatlineReported = false;
+}
+
+QString AnomalyDetector::typeName(AnomalyType type)
+{
+    switch (type) {
+    case AnomalyType::Spike: return QStringLiteral("pik");
+    case AnomalyType::Flatline: return QStringLiteral("zawieszenie");
+    case AnomalyType::OutOfRange: return QStringLiteral("poza zakresem");
+    }
+    return QString();
+}
+
+double AnomalyDetector::medianOfSorted(const std::vector<double>& sorted)
+{
+    const std::size_t n = sorted.size();
+    return n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+double AnomalyDetector::medianAbsoluteDeviation(const std::vector<double>& sorted, double median)
+{
+    // Odchylenia na lewo od mediany (czytane wstecz) i na prawo od niej tworzą dwa ciągi rosnące - scalanie ich
+    // do środkowej pozycji daje medianę odchyleń.
+    const std::size_t n = sorted.size();
+    std::size_t right = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), median) - sorted.begin());
+    std::size_t left = right; // kolejny element po lewej to sorted[left - 1]
+    double previous = 0.0;
+    double current = 0.0;
+    for (std::size_t k = 0; k <= n / 2; ++k) {
+        previous = current;
+        if (right < n && (left == 0 || sorted[right] - median <= median - sorted[left - 1])) {
+            current = sorted[right++] - median;
+        } else {
+            current = median - sorted[--left];
+        }
+    }
+    return n % 2 ? current : 0.5 * (previous + current);
+}
+
+std::optional<Anomaly> AnomalyDetector::add(const MeasurementValue& mv)
+{
+    if (!mv.date.isValid() || std::isnan(mv.value)) {
+        return std::nullopt;
+    }
+    const double value = mv.value;
+
+    if (value < m_options.minValue || value > m_options.maxValue) {
+        // Poza oknem (nie zaburza mediany) i poza serią powtórzeń - kolejne wartości w zakresie zaczynają nową serię.
+        m_lastValue = std::numeric_limits<double>::quiet_NaN();
+        m_repeatCount = 0;
+        m_flatlineReported = false;
+        return Anomaly{mv.date, value, AnomalyType::OutOfRange, value};
+    }
+
+    if (value == m_lastValue) {
+        m_repeatCount++;
+    } else {
+        m_lastValue = value;
+        m_repeatCount = 1;
+        m_flatlineReported = false;
+    }
+
+    std::optional<Anomaly> result;
+    if (static_cast<int>(m_window.size()) >= m_options.minHistory) {
+        const double median = medianOfSorted(m_sorted);
+        const double scale = std::max(1.4826 * medianAbsoluteDeviation(m_sorted, median), m_options.minScale);
+        const double z = (value - median) / scale;
+        if (std::abs(z) > m_options.zThreshold) {
+            result = Anomaly{mv.date, value, AnomalyType::Spike, z};
+        }
+    }
+    if (!result && !m_flatlineReported && m_repeatCount >= m_options.flatlineLength) {
+        result = Anomaly{mv.date, value, AnomalyType::Flatline, static_cast<double>(m_repeatCount)};
+        m_flatlineReported = true;
+    }
+
+    // Aktualizacja okna: usunięcie najstarszej wartości i wstawienie nowej z zachowaniem porządku
+    if (static_cast<int>(m_window.size()) == m_options.windowSize) {
+        auto oldest = std::lower_bound(m_sorted.begin(), m_sorted.end(), m_window.front());
+        m_sorted.erase(oldest);
+        m_window.pop_front();
+    }
+    m_window.push_back(value);
+    m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), value), value);
+
+    return result;
+}
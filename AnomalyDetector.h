@@ -0,0 +1,100 @@
+/**
+ * @file AnomalyDetector.h
+ * @brief Definicja klasy AnomalyDetector - strumieniowego wykrywania podejrzanych pomiarów jednego czujnika.
+ */
+#ifndef ANOMALYDETECTOR_H
+#define ANOMALYDETECTOR_H
+
+#include <QDateTime>
+#include <QString>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @enum AnomalyType
+ * @brief Rodzaj wykrytej anomalii.
+ */
+enum class AnomalyType {
+    Spike,     ///< Nagły pik - wartość odstaje od mediany okna o więcej niż zThreshold odchyleń (MAD).
+    Flatline,  ///< Zawieszony czujnik - ta sama wartość powtórzona flatlineLength razy z rzędu (raz na serię powtórzeń).
+    OutOfRange ///< Wartość poza zakresem fizycznym (np. ujemne stężenie) - zgłaszana przy każdym takim pomiarze.
+};
+
+/**
+ * @struct AnomalyDetectorOptions
+ * @brief Progi detektora anomalii.
+ */
+struct AnomalyDetectorOptions {
+    int windowSize = 24;      ///< Liczba ostatnich pomiarów, z których liczona jest mediana i MAD.
+    int minHistory = 8;       ///< Minimalna liczba pomiarów w oknie, zanim sprawdzane są piki.
+    double zThreshold = 6.0;  ///< Próg odpornego z-score: |x - mediana| / (1.4826·MAD).
+    double minScale = 2.0;    ///< Minimalna skala (µg/m³) zamiast 1.4826·MAD - chroni przed fałszywymi pikami przy stałym tle.
+    int flatlineLength = 6;   ///< Liczba identycznych kolejnych pomiarów uznawana za zawieszenie czujnika.
+    double minValue = 0.0;    ///< Najmniejsza dopuszczalna wartość.
+    double maxValue = std::numeric_limits<double>::infinity(); ///< Największa dopuszczalna wartość.
+};
+
+/**
+ * @struct Anomaly
+ * @brief Pomiar oznaczony jako podejrzany.
+ */
+struct Anomaly {
+    QDateTime date;           ///< Data pomiaru.
+    double value = 0.0;       ///< Wartość pomiaru.
+    AnomalyType type = AnomalyType::Spike; ///< Rodzaj anomalii.
+    double score = 0.0;       ///< Spike: odporny z-score; Flatline: długość serii powtórzeń; OutOfRange: wartość.
+};
+
+/**
+ * @class AnomalyDetector
+ * @brief Strumieniowy detektor anomalii dla jednego czujnika.
+ *
+ * Pomiary są podawane pojedynczo, w kolejności czasu (add()). Detektor przechowuje tylko okno ostatnich
+ * `windowSize` wartości (w kolejności napływu i posortowane), więc koszt pomiaru zależy tylko od rozmiaru okna
+ * (O(w) dla w = windowSize: wstawienie do posortowanego okna i MAD bez sortowania) - nie od długości historii.
+ * Pik jest oceniany względem mediany i MAD okna (odporne na same piki).
+ *
+ * Zawieszenie jest zgłaszane raz, gdy seria identycznych wartości osiąga `flatlineLength` (jeśli ten pomiar jest
+ * pikiem - przy następnym powtórzeniu). Wartość spoza zakresu jest zgłaszana jako OutOfRange, nie trafia do okna
+ * i przerywa serię powtórzeń.
+ */
+class AnomalyDetector
+{
+public:
+    /** @brief Konstruktor. */
+    explicit AnomalyDetector(const AnomalyDetectorOptions& options = {});
+
+    /**
+     * @brief Sprawdza kolejny pomiar i dołącza go do okna.
+     * @param value Pomiar (NaN i błędne daty są ignorowane).
+     * @return Anomalia, jeśli pomiar jest podejrzany; w przeciwnym razie std::nullopt.
+     */
+    std::optional<Anomaly> add(const MeasurementValue& value);
+
+    /** @brief Usuwa historię (okno i licznik powtórzeń). */
+    void reset();
+
+    /** @brief Opcje detektora. */
+    const AnomalyDetectorOptions& options() const;
+
+    /** @brief Nazwa rodzaju anomalii do wyświetlenia ("pik", "zawieszenie", "poza zakresem"). */
+    static QString typeName(AnomalyType type);
+
+private:
+    /// Mediana posortowanego wektora (niepustego).
+    static double medianOfSorted(const std::vector<double>& sorted);
+    /// Mediana odchyleń |v - median| dla posortowanego wektora (niepustego), w O(n) bez sortowania odchyleń.
+    static double medianAbsoluteDeviation(const std::vector<double>& sorted, double median);
+
+    AnomalyDetectorOptions m_options;
+    std::deque<double> m_window;       ///< Okno w kolejności napływu.
+    std::vector<double> m_sorted;      ///< Te same wartości, posortowane rosnąco.
+    double m_lastValue = std::numeric_limits<double>::quiet_NaN(); ///< Poprzednia wartość w zakresie.
+    int m_repeatCount = 0;             ///< Liczba kolejnych powtórzeń m_lastValue.
+    bool m_flatlineReported = false;   ///< Czy bieżącą serię powtórzeń zgłoszono już jako zawieszenie.
+};
+
+#endif // ANOMALYDETECTOR_H
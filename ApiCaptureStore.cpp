@@ -0,0 +1,164 @@
+#include "ApiCaptureStore.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+/// Długość numeru odpowiedzi w nazwie pliku - nazwy sortują się wtedy w kolejności zapisu.
+constexpr int SequenceDigits = 6;
+
+/// Dzieli zapytanie "/station/sensors/52" na katalog ("station/sensors") i nazwę ("52").
+QPair<QString, QString> splitEndpoint(const QString& endpoint)
+{
+    const QStringList parts = endpoint.split('/', Qt::SkipEmptyParts);
+    if (parts.isEmpty()) {
+        return qMakePair(QString(), QString());
+    }
+    QStringList directories = parts;
+    directories.removeLast();
+    return qMakePair(directories.join('/'), parts.last());
+}
+
+} // namespace
+
+ApiCaptureStore::ApiCaptureStore(const QString& directory) : m_directory(directory)
+{
+}
+
+QString ApiCaptureStore::directory() const
+{
+    return m_directory;
+}
+
+QString ApiCaptureStore::basePath(const QString& endpoint, int sequence) const
+{
+    const QPair<QString, QString> parts = splitEndpoint(endpoint);
+    QString name = parts.second;
+    if (sequence > 0) {
+        name += '_' + QString::number(sequence).rightJustified(SequenceDigits, '0');
+    }
+    return QDir(m_directory).filePath(parts.first.isEmpty() ? name : parts.first + '/' + name);
+}
+
+bool ApiCaptureStore::save(const QString& endpoint, const ApiResponse& response)
+{
+    const QPair<QString, QString> parts = splitEndpoint(endpoint);
+    if (parts.second.isEmpty() || response.httpStatus <= 0) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_nextSequence.contains(endpoint)) {
+        // Numeracja jest kontynuowana po odpowiedziach zapisanych wcześniej (np. w poprzednim uruchomieniu).
+        int last = 0;
+        const QDir dir(QDir(m_directory).filePath(parts.first));
+        for (const QString& name : dir.entryList(QStringList() << parts.second + "_*.json", QDir::Files)) {
+            bool ok = false;
+            const int sequence = name.mid(parts.second.size() + 1, name.size() - parts.second.size() - 6).toInt(&ok);
+            if (ok) {
+                last = std::max(last, sequence);
+            }
+        }
+        m_nextSequence.insert(endpoint, last + 1);
+    }
+    const int sequence = m_nextSequence.value(endpoint);
+    const QString base = basePath(endpoint, sequence);
+    if (!QDir().mkpath(QFileInfo(base).absolutePath())) {
+        qWarning() << "Nie można utworzyć katalogu zapisu odpowiedzi API:" << QFileInfo(base).absolutePath();
+        return false;
+    }
+
+    QByteArray headerText = "HTTP " + QByteArray::number(response.httpStatus);
+    if (!response.reasonPhrase.isEmpty()) {
+        headerText += ' ' + response.reasonPhrase.toUtf8();
+    }
+    headerText += '\n';
+    for (const auto& header : response.headers) {
+        headerText += header.first + ": " + header.second + '\n';
+    }
+
+    QFile bodyFile(base + ".json");
+    QFile headersFile(base + ".headers");
+    if (!bodyFile.open(QIODevice::WriteOnly) || bodyFile.write(response.body) != response.body.size()
+        || !headersFile.open(QIODevice::WriteOnly) || headersFile.write(headerText) != headerText.size()) {
+        qWarning() << "Nie udało się zapisać odpowiedzi API do" << base << bodyFile.errorString() << headersFile.errorString();
+        return false;
+    }
+    m_nextSequence.insert(endpoint, sequence + 1);
+    m_replayFiles.remove(endpoint); // lista plików do odtwarzania jest nieaktualna
+    return true;
+}
+
+const QStringList& ApiCaptureStore::replayFilesLocked(const QString& endpoint)
+{
+    auto it = m_replayFiles.find(endpoint);
+    if (it == m_replayFiles.end()) {
+        const QPair<QString, QString> parts = splitEndpoint(endpoint);
+        QStringList files;
+        if (!parts.second.isEmpty()) {
+            const QDir dir(QDir(m_directory).filePath(parts.first));
+            files = dir.entryList(QStringList() << parts.second + ".json" << parts.second + "_*.json", QDir::Files,
+                                  QDir::Name);
+            for (QString& name : files) {
+                name = dir.filePath(name);
+            }
+        }
+        it = m_replayFiles.insert(endpoint, files);
+    }
+    return *it;
+}
+
+std::optional<ApiResponse> ApiCaptureStore::next(const QString& endpoint)
+{
+    QString bodyPath;
+    {
+        QMutexLocker locker(&m_mutex);
+        const QStringList& files = replayFilesLocked(endpoint);
+        if (files.isEmpty()) {
+            return std::nullopt;
+        }
+        int& cursor = m_replayCursor[endpoint];
+        bodyPath = files.at(std::min(cursor, static_cast<int>(files.size()) - 1));
+        cursor = std::min(cursor + 1, static_cast<int>(files.size()));
+    }
+
+    QFile bodyFile(bodyPath);
+    if (!bodyFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Nie można odczytać zapisanej odpowiedzi API:" << bodyPath << bodyFile.errorString();
+        return std::nullopt;
+    }
+    ApiResponse response;
+    response.body = bodyFile.readAll();
+    response.httpStatus = 200;
+
+    QFile headersFile(bodyPath.left(bodyPath.size() - 5) + ".headers");
+    if (headersFile.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = headersFile.readAll().split('\n');
+        for (int i = 0; i < lines.size(); ++i) {
+            const QByteArray line = lines.at(i).trimmed();
+            if (i == 0 && line.startsWith("HTTP ")) {
+                const int reasonAt = line.indexOf(' ', 5);
+                response.httpStatus = line.mid(5, reasonAt < 0 ? -1 : reasonAt - 5).toInt();
+                response.reasonPhrase = reasonAt < 0 ? QString() : QString::fromUtf8(line.mid(reasonAt + 1));
+                continue;
+            }
+            const int colon = line.indexOf(':');
+            if (colon > 0) {
+                response.headers.append(qMakePair(line.left(colon), line.mid(colon + 1).trimmed()));
+            }
+        }
+    }
+    if (response.httpStatus < 200 || response.httpStatus >= 300) {
+        response.errorString = QStringLiteral("HTTP %1 %2").arg(response.httpStatus).arg(response.reasonPhrase).trimmed();
+    }
+    return response;
+}
+
+int ApiCaptureStore::count(const QString& endpoint)
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(replayFilesLocked(endpoint).size());
+}
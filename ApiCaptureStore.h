@@ -0,0 +1,103 @@
+/**
+ * @file ApiCaptureStore.h
+ * @brief Definicja klasy ApiCaptureStore - katalogu zapisanych odpowiedzi API GIOS (nagrywanie i odtwarzanie).
+ */
+#ifndef APICAPTURESTORE_H
+#define APICAPTURESTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+/**
+ * @struct ApiResponse
+ * @brief Odpowiedź HTTP na zapytanie do API (z sieci albo z zapisu).
+ */
+struct ApiResponse {
+    int httpStatus = 0;                              ///< Kod statusu HTTP (0, jeśli nie było odpowiedzi serwera).
+    QString reasonPhrase;                            ///< Opis statusu HTTP (np. "Not Found").
+    QList<QPair<QByteArray, QByteArray>> headers;    ///< Nagłówki odpowiedzi w kolejności z serwera.
+    QByteArray body;                                 ///< Treść odpowiedzi.
+    QString errorString;                             ///< Opis błędu (pusty, jeśli odpowiedź jest poprawna).
+
+    /** @brief Czy zapytanie zakończyło się powodzeniem (brak błędu). */
+    bool isSuccess() const { return errorString.isEmpty(); }
+};
+
+/**
+ * @struct ReplayOptions
+ * @brief Symulowane warunki sieciowe przy odtwarzaniu zapisanych odpowiedzi.
+ */
+struct ReplayOptions {
+    int latencyMs = 0;          ///< Opóźnienie każdej odpowiedzi w milisekundach.
+    qint64 bytesPerSecond = 0;  ///< Przepustowość w bajtach na sekundę (0 - bez ograniczenia).
+
+    /** @brief Czas odpowiedzi o treści `bytes` bajtów: opóźnienie plus czas przesłania treści. */
+    qint64 delayMs(qint64 bytes) const {
+        const qint64 transferMs = bytesPerSecond > 0 ? (bytes * 1000 + bytesPerSecond - 1) / bytesPerSecond : 0;
+        return (latencyMs > 0 ? latencyMs : 0) + transferMs;
+    }
+};
+
+/**
+ * @class ApiCaptureStore
+ * @brief Zapisuje odpowiedzi API do katalogu i odtwarza je w tej samej kolejności.
+ *
+ * Odpowiedź na zapytanie "/station/sensors/52" jest zapisywana jako "station/sensors/52_000001.json" (treść) i
+ * "station/sensors/52_000001.headers" (pierwszy wiersz "HTTP {status} {opis}", dalej nagłówki "Nazwa: wartość").
+ * Kolejne odpowiedzi tego samego zapytania dostają kolejne numery, także po ponownym otwarciu katalogu. Układ plików
+ * *.json odpowiada ścieżkom zapytań, więc katalog można też zaimportować do cache (ArchiveImporter).
+ *
+ * Odtwarzanie zwraca zapisane odpowiedzi zapytania po kolei (wg nazwy pliku, więc deterministycznie); po ostatniej
+ * zwracana jest ponownie ostatnia. Plik "{ID}.json" bez numeru i bez pliku nagłówków (np. przygotowany ręcznie) jest
+ * traktowany jak odpowiedź ze statusem 200. Metody są bezpieczne wątkowo.
+ */
+class ApiCaptureStore
+{
+public:
+    /**
+     * @brief Konstruktor.
+     * @param directory Katalog zapisanych odpowiedzi (przy zapisie tworzony, jeśli nie istnieje).
+     */
+    explicit ApiCaptureStore(const QString& directory);
+
+    ApiCaptureStore(const ApiCaptureStore&) = delete;
+    ApiCaptureStore& operator=(const ApiCaptureStore&) = delete;
+
+    /** @brief Zwraca katalog zapisanych odpowiedzi. */
+    QString directory() const;
+
+    /**
+     * @brief Zapisuje odpowiedź na zapytanie `endpoint` (np. "/data/getData/1234").
+     * @return `true`, jeśli zapis się powiódł. Odpowiedzi bez statusu HTTP (błąd połączenia) nie są zapisywane.
+     */
+    bool save(const QString& endpoint, const ApiResponse& response);
+
+    /**
+     * @brief Zwraca kolejną zapisaną odpowiedź na zapytanie `endpoint`.
+     * @return Odpowiedź albo std::nullopt, jeśli katalog nie ma odpowiedzi na to zapytanie.
+     */
+    std::optional<ApiResponse> next(const QString& endpoint);
+
+    /** @brief Liczba zapisanych odpowiedzi na zapytanie `endpoint`. */
+    int count(const QString& endpoint);
+
+private:
+    /// Ścieżka pliku (bez rozszerzenia) odpowiedzi zapytania o numerze `sequence` (0 - plik bez numeru).
+    QString basePath(const QString& endpoint, int sequence) const;
+    /// Pliki treści odpowiedzi zapytania posortowane po nazwie (wywoływane z zablokowanym m_mutex).
+    const QStringList& replayFilesLocked(const QString& endpoint);
+
+    QString m_directory;                       ///< Katalog zapisanych odpowiedzi.
+    QMutex m_mutex;                            ///< Chroni pola poniżej.
+    QHash<QString, int> m_nextSequence;        ///< Numer następnej zapisywanej odpowiedzi zapytania.
+    QHash<QString, QStringList> m_replayFiles; ///< Pliki odpowiedzi zapytania (wczytane przy pierwszym odtworzeniu).
+    QHash<QString, int> m_replayCursor;        ///< Indeks następnej odtwarzanej odpowiedzi zapytania.
+};
+
+#endif // APICAPTURESTORE_H
@@ -7,6 +7,7 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QFuture>
 #include <QJsonDocument>
+#include <QThread>
 #include <QThreadPool>
 #include "DataParser.h"
 
@@ -15,22 +16,97 @@ ApiService::ApiService(QObject *parent)
 {
 }
 
+void ApiService::reportError(RequestType type, int id, const QString& errorMsg)
+{
+    emit networkError(errorMsg);
+    emit requestFailed(type, id, errorMsg);
+}
+
+void ApiService::setBaseUrl(const QString& baseUrl)
+{
+    m_transport.baseUrl = baseUrl;
+}
+
+QString ApiService::baseUrl() const
+{
+    return m_transport.baseUrl;
+}
+
+void ApiService::setCaptureDirectory(const QString& directory)
+{
+    m_transport.capture = directory.isEmpty() ? nullptr : std::make_shared<ApiCaptureStore>(directory);
+}
+
+QString ApiService::captureDirectory() const
+{
+    return m_transport.capture ? m_transport.capture->directory() : QString();
+}
+
+void ApiService::setReplayDirectory(const QString& directory, const ReplayOptions& options)
+{
+    m_transport.replay = directory.isEmpty() ? nullptr : std::make_shared<ApiCaptureStore>(directory);
+    m_transport.replayOptions = options;
+}
+
+bool ApiService::isReplaying() const
+{
+    return m_transport.replay != nullptr;
+}
+
+ApiResponse ApiService::get(const QString& endpoint, const Transport& transport) const
+{
+    if (transport.replay) {
+        std::optional<ApiResponse> replayed = transport.replay->next(endpoint);
+        ApiResponse response;
+        if (replayed) {
+            response = *replayed;
+        } else {
+            response.errorString = "Brak zapisanej odpowiedzi na zapytanie " + endpoint;
+        }
+        // Wątek żądania czeka tak, jak czekałby na sieć o zadanym opóźnieniu i przepustowości.
+        const qint64 delayMs = transport.replayOptions.delayMs(response.body.size());
+        if (delayMs > 0) {
+            QThread::msleep(static_cast<unsigned long>(delayMs));
+        }
+        return response;
+    }
+
+    QNetworkAccessManager manager;
+    QNetworkRequest request(QUrl(transport.baseUrl + endpoint));
+    QScopedPointer<QNetworkReply> reply(manager.get(request));
+
+    QEventLoop loop;
+    connect(reply.data(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    ApiResponse response;
+    response.httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    response.reasonPhrase = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
+    response.headers = reply->rawHeaderPairs();
+    response.body = reply->readAll();
+    if (reply->error() != QNetworkReply::NoError) {
+        response.errorString = reply->errorString();
+    } else if (response.httpStatus < 200 || response.httpStatus >= 300) {
+        // Tak samo jak przy odtwarzaniu (ApiCaptureStore::next()) - odpowiedź bez statusu 2xx jest błędem.
+        response.errorString = QStringLiteral("HTTP %1 %2").arg(response.httpStatus).arg(response.reasonPhrase).trimmed();
+    }
+    if (transport.capture && response.httpStatus > 0 && !transport.capture->save(endpoint, response)) {
+        qWarning() << "Nie udało się zapisać odpowiedzi na zapytanie" << endpoint;
+    }
+    return response;
+}
+
 void ApiService::fetchAllStations()
 {
-    QUrl url(m_baseUrl + "/station/findAll");
+    const QString endpoint = "/station/findAll";
+    const QUrl url(m_transport.baseUrl + endpoint);
     qDebug() << "Żądanie pobrania wszystkich stacji w wątku tła z:" << url.toString();
 
-    (void)QtConcurrent::run([this, url]() {
-        QNetworkAccessManager manager;
-        QNetworkRequest request(url);
-        QScopedPointer<QNetworkReply> reply(manager.get(request));
-
-        QEventLoop loop;
-        connect(reply.data(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    (void)QtConcurrent::run([this, endpoint, transport = m_transport]() {
+        const ApiResponse response = get(endpoint, transport);
 
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray responseData = reply->readAll();
+        if (response.isSuccess()) {
+            const QByteArray& responseData = response.body;
             qDebug() << "Otrzymano dane stacji w tle, rozmiar:" << responseData.size();
             DataParser parser;
             std::vector<MeasuringStation> stations = parser.parseStations(responseData);
@@ -38,102 +114,87 @@ void ApiService::fetchAllStations()
                 emit stationsReady(stations);
             } else {
                 qWarning() << "Nie udało się sparsować danych stacji. Surowe dane:" << responseData.trimmed();
-                emit networkError("Błąd przetwarzania danych stacji.");
+                reportError(StationsRequest, -1, "Błąd przetwarzania danych stacji.");
             }
         } else {
-            qWarning() << "Błąd sieci podczas pobierania stacji:" << reply->errorString();
-            emit networkError("Błąd sieci (stacje): " + reply->errorString());
+            qWarning() << "Błąd sieci podczas pobierania stacji:" << response.errorString;
+            reportError(StationsRequest, -1, "Błąd sieci (stacje): " + response.errorString);
         }
     });
 }
 
 void ApiService::fetchSensorsForStation(int stationId)
 {
-    QUrl url(m_baseUrl + QString("/station/sensors/%1").arg(stationId));
+    const QString endpoint = QString("/station/sensors/%1").arg(stationId);
+    const QUrl url(m_transport.baseUrl + endpoint);
     qDebug() << "Żądanie pobrania czujników w wątku tła dla stacji" << stationId << "z:" << url.toString();
 
-    (void)QtConcurrent::run([this, url]() {
-        QNetworkAccessManager manager;
-        QNetworkRequest request(url);
-        QScopedPointer<QNetworkReply> reply(manager.get(request));
+    (void)QtConcurrent::run([this, endpoint, stationId, transport = m_transport]() {
+        const ApiResponse response = get(endpoint, transport);
 
-        QEventLoop loop;
-        connect(reply.data(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
-
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray responseData = reply->readAll();
+        if (response.isSuccess()) {
+            const QByteArray& responseData = response.body;
             qDebug() << "Otrzymano dane czujników w tle, rozmiar:" << responseData.size();
             DataParser parser;
             std::vector<Sensor> sensors = parser.parseSensors(responseData);
             if (!sensors.empty() || responseData == "[]") {
-                emit sensorsReady(sensors);
+                emit sensorsReady(stationId, sensors);
             } else {
                 qWarning() << "Nie udało się sparsować danych czujników. Surowe dane:" << responseData.trimmed();
-                emit networkError("Błąd przetwarzania danych czujników.");
+                reportError(SensorsRequest, stationId, "Błąd przetwarzania danych czujników.");
             }
         } else {
-            qWarning() << "Błąd sieci podczas pobierania czujników:" << reply->errorString();
-            emit networkError("Błąd sieci (czujniki): " + reply->errorString());
+            qWarning() << "Błąd sieci podczas pobierania czujników:" << response.errorString;
+            reportError(SensorsRequest, stationId, "Błąd sieci (czujniki): " + response.errorString);
         }
     });
 }
 
 void ApiService::fetchSensorData(int sensorId)
 {
-    QUrl url(m_baseUrl + QString("/data/getData/%1").arg(sensorId));
+    const QString endpoint = QString("/data/getData/%1").arg(sensorId);
+    const QUrl url(m_transport.baseUrl + endpoint);
     qDebug() << "Żądanie pobrania danych czujnika w wątku tła dla czujnika" << sensorId << "z:" << url.toString();
 
-    (void)QtConcurrent::run([this, url]() {
-        QNetworkAccessManager manager;
-        QNetworkRequest request(url);
-        QScopedPointer<QNetworkReply> reply(manager.get(request));
-
-        QEventLoop loop;
-        connect(reply.data(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    (void)QtConcurrent::run([this, endpoint, sensorId, transport = m_transport]() {
+        const ApiResponse response = get(endpoint, transport);
 
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray responseData = reply->readAll();
+        if (response.isSuccess()) {
+            const QByteArray& responseData = response.body;
             qDebug() << "Otrzymano dane czujnika w tle, rozmiar:" << responseData.size();
             DataParser parser;
             SensorData data = parser.parseSensorData(responseData);
 
             if (!data.key.isEmpty()) {
-                emit sensorDataReady(data);
+                emit sensorDataReady(sensorId, data);
             } else {
                 QJsonDocument doc = QJsonDocument::fromJson(responseData);
                 if (doc.isNull() && !responseData.isEmpty() && responseData != "[]") {
                     qWarning() << "Nie udało się sparsować danych pomiarowych czujnika. Nieprawidłowy JSON. Surowe dane:" << responseData.trimmed();
-                    emit networkError("Błąd przetwarzania danych pomiarowych (nieprawidłowy format).");
+                    reportError(SensorDataRequest, sensorId, "Błąd przetwarzania danych pomiarowych (nieprawidłowy format).");
                 } else {
                     qWarning() << "Dane czujnika sparsowane, ale brakuje klucza lub nie znaleziono prawidłowych wartości. Surowe dane:" << responseData.trimmed();
-                    emit sensorDataReady(data);
+                    emit sensorDataReady(sensorId, data);
                 }
             }
         } else {
-            qWarning() << "Błąd sieci podczas pobierania danych czujnika:" << reply->errorString();
-            emit networkError("Błąd sieci (dane pomiarowe): " + reply->errorString());
+            qWarning() << "Błąd sieci podczas pobierania danych czujnika:" << response.errorString;
+            reportError(SensorDataRequest, sensorId, "Błąd sieci (dane pomiarowe): " + response.errorString);
         }
     });
 }
 
 void ApiService::fetchAirQualityIndex(int stationId)
 {
-    QUrl url(m_baseUrl + QString("/aqindex/getIndex/%1").arg(stationId));
+    const QString endpoint = QString("/aqindex/getIndex/%1").arg(stationId);
+    const QUrl url(m_transport.baseUrl + endpoint);
     qDebug() << "Żądanie pobrania indeksu AQI w wątku tła dla stacji" << stationId << "z:" << url.toString();
 
-    (void)QtConcurrent::run([this, url]() {
-        QNetworkAccessManager manager;
-        QNetworkRequest request(url);
-        QScopedPointer<QNetworkReply> reply(manager.get(request));
-
-        QEventLoop loop;
-        connect(reply.data(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
+    (void)QtConcurrent::run([this, endpoint, url, stationId, transport = m_transport]() {
+        const ApiResponse response = get(endpoint, transport);
 
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray responseData = reply->readAll();
+        if (response.isSuccess()) {
+            const QByteArray& responseData = response.body;
             qDebug() << "Otrzymano dane indeksu AQI w tle, rozmiar:" << responseData.size();
             DataParser parser;
             AirQualityIndex index = parser.parseAirQualityIndex(responseData);
@@ -144,20 +205,19 @@ void ApiService::fetchAirQualityIndex(int stationId)
                 QJsonDocument doc = QJsonDocument::fromJson(responseData);
                 if (doc.isNull() && !responseData.isEmpty() && responseData != "[]") {
                     qWarning() << "Nie udało się sparsować danych AQI. Nieprawidłowy JSON. Surowe dane:" << responseData.trimmed();
-                    emit networkError("Błąd przetwarzania danych AQI (nieprawidłowy format).");
+                    reportError(AirQualityIndexRequest, stationId, "Błąd przetwarzania danych AQI (nieprawidłowy format).");
                 } else {
                     qWarning() << "Dane AQI sparsowane, ale wydają się nieprawidłowe (ID=-1) lub API zwróciło brak danych. Surowe dane:" << responseData.trimmed();
-                    emit networkError("Indeks Jakości Powietrza niedostępny dla tej stacji (problem z danymi API lub parsowaniem).");
+                    reportError(AirQualityIndexRequest, stationId, "Indeks Jakości Powietrza niedostępny dla tej stacji (problem z danymi API lub parsowaniem).");
                 }
             }
         } else {
-            int httpStatusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-            if (httpStatusCode == 404) {
+            if (response.httpStatus == 404) {
                 qWarning() << "Błąd sieci podczas pobierania indeksu AQI: 404 Not Found dla URL:" << url.toString();
-                emit networkError("Indeks Jakości Powietrza niedostępny dla tej stacji (nie znaleziono).");
+                reportError(AirQualityIndexRequest, stationId, "Indeks Jakości Powietrza niedostępny dla tej stacji (nie znaleziono).");
             } else {
-                qWarning() << "Błąd sieci podczas pobierania indeksu AQI:" << reply->errorString();
-                emit networkError("Błąd sieci (indeks AQI): " + reply->errorString());
+                qWarning() << "Błąd sieci podczas pobierania indeksu AQI:" << response.errorString;
+                reportError(AirQualityIndexRequest, stationId, "Błąd sieci (indeks AQI): " + response.errorString);
             }
         }
     });
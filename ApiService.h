@@ -8,7 +8,9 @@
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QUrl>
+#include <memory>
 #include <vector>
+#include "ApiCaptureStore.h"
 #include "DataStructures.h" // Zakładamy, że DataStructures.h ma już komentarze
 
 class QNetworkReply;
@@ -19,6 +21,10 @@ class QNetworkReply;
  *
  * Klasa wykonuje żądania sieciowe asynchronicznie w osobnych wątkach (używając QtConcurrent)
  * i emituje sygnały z wynikami (sparsowanymi danymi) lub informacjami o błędach sieciowych/parsowania.
+ *
+ * Odpowiedzi z sieci mogą być zapisywane do katalogu (setCaptureDirectory()), a zamiast sieci można użyć zapisanych
+ * odpowiedzi (setReplayDirectory()) z symulowanym opóźnieniem i przepustowością - np. do powtarzalnych pomiarów
+ * ścieżki pobieranie-parsowanie-zapis na komputerach bez dostępu do sieci (ApiCaptureStore).
  */
 class ApiService : public QObject
 {
@@ -31,6 +37,18 @@ public:
      */
     explicit ApiService(QObject *parent = nullptr);
 
+    /**
+     * @enum RequestType
+     * @brief Rodzaj żądania do API, przekazywany w sygnale requestFailed().
+     */
+    enum RequestType {
+        StationsRequest,        ///< Lista wszystkich stacji.
+        SensorsRequest,         ///< Lista czujników stacji.
+        SensorDataRequest,      ///< Dane pomiarowe czujnika.
+        AirQualityIndexRequest  ///< Indeks jakości powietrza stacji.
+    };
+    Q_ENUM(RequestType)
+
     /**
      * @brief Rozpoczyna asynchroniczne pobieranie listy wszystkich stacji pomiarowych z API GIOS.
      *
@@ -67,6 +85,33 @@ public:
      */
     void fetchAirQualityIndex(int stationId);
 
+    /**
+     * @brief Ustawia podstawowy URL API (domyślnie adres API GIOS), np. adres lokalnego serwera testowego.
+     * @note Dotyczy żądań rozpoczętych po wywołaniu.
+     */
+    void setBaseUrl(const QString& baseUrl);
+    /** @brief Zwraca podstawowy URL API. */
+    QString baseUrl() const;
+
+    /**
+     * @brief Włącza zapisywanie treści i nagłówków każdej odpowiedzi z sieci do katalogu.
+     * @param directory Katalog zapisu (pusty - wyłącza zapisywanie).
+     * @note Dotyczy żądań rozpoczętych po wywołaniu; odpowiedzi odtwarzane (setReplayDirectory()) nie są zapisywane.
+     */
+    void setCaptureDirectory(const QString& directory);
+    /** @brief Zwraca katalog zapisu odpowiedzi (pusty, jeśli zapisywanie jest wyłączone). */
+    QString captureDirectory() const;
+
+    /**
+     * @brief Przełącza żądania na odtwarzanie odpowiedzi zapisanych w katalogu zamiast pobierania z sieci.
+     * @param directory Katalog zapisanych odpowiedzi (pusty - powrót do pobierania z sieci).
+     * @param options Symulowane opóźnienie i przepustowość.
+     * @note Żądanie bez zapisanej odpowiedzi kończy się błędem jak przy braku sieci (networkError(), requestFailed()).
+     */
+    void setReplayDirectory(const QString& directory, const ReplayOptions& options = ReplayOptions());
+    /** @brief Czy żądania są obsługiwane z zapisanych odpowiedzi. */
+    bool isReplaying() const;
+
 signals:
     /**
      * @brief Sygnał emitowany, gdy lista stacji zostanie pomyślnie pobrana i sparsowana.
@@ -76,15 +121,17 @@ signals:
 
     /**
      * @brief Sygnał emitowany, gdy lista czujników dla danej stacji zostanie pomyślnie pobrana i sparsowana.
+     * @param stationId ID stacji, dla której wykonano żądanie.
      * @param sensors Wektor obiektów Sensor zawierający pobrane czujniki.
      */
-    void sensorsReady(const std::vector<Sensor>& sensors);
+    void sensorsReady(int stationId, const std::vector<Sensor>& sensors);
 
     /**
      * @brief Sygnał emitowany, gdy dane pomiarowe dla czujnika zostaną pomyślnie pobrane i sparsowane.
+     * @param sensorId ID czujnika, dla którego wykonano żądanie.
      * @param data Obiekt SensorData zawierający klucz parametru i wektor wartości pomiarowych. Może zawierać pusty wektor wartości, jeśli API nie zwróciło pomiarów.
      */
-    void sensorDataReady(const SensorData& data);
+    void sensorDataReady(int sensorId, const SensorData& data);
 
     /**
      * @brief Sygnał emitowany, gdy indeks jakości powietrza (AQI) dla stacji zostanie pomyślnie pobrany i sparsowany.
@@ -98,7 +145,38 @@ signals:
      */
     void networkError(const QString& errorMsg);
 
+    /**
+     * @brief Sygnał emitowany razem z networkError(), ale z informacją, którego żądania dotyczy błąd.
+     * @param type Rodzaj nieudanego żądania.
+     * @param id ID stacji lub czujnika, którego dotyczyło żądanie (-1 dla listy stacji).
+     * @param errorMsg Komunikat tekstowy opisujący napotkany błąd (ten sam co w networkError()).
+     */
+    void requestFailed(ApiService::RequestType type, int id, const QString& errorMsg);
+
 private:
+    /// Źródło odpowiedzi; kopia jest przekazywana do wątku żądania, więc zmiana ustawień nie wpływa na trwające żądania.
+    struct Transport {
+        QString baseUrl = "https://api.gios.gov.pl/pjp-api/rest"; ///< Podstawowy URL dla endpointów API GIOS.
+        std::shared_ptr<ApiCaptureStore> capture; ///< Zapis odpowiedzi z sieci (nullptr - wyłączony).
+        std::shared_ptr<ApiCaptureStore> replay;  ///< Zapisane odpowiedzi zamiast sieci (nullptr - sieć).
+        ReplayOptions replayOptions;              ///< Symulowane warunki sieciowe przy odtwarzaniu.
+    };
+
+    /**
+     * @brief Wykonuje żądanie GET (blokująco, w wątku tła) przez sieć albo z zapisanych odpowiedzi.
+     * @param endpoint Ścieżka zapytania względem Transport::baseUrl (np. "/station/findAll").
+     * @param transport Źródło odpowiedzi.
+     */
+    ApiResponse get(const QString& endpoint, const Transport& transport) const;
+
+    /**
+     * @brief Emituje networkError() oraz requestFailed() dla nieudanego żądania.
+     * @param type Rodzaj nieudanego żądania.
+     * @param id ID stacji lub czujnika (-1 dla listy stacji).
+     * @param errorMsg Komunikat błędu.
+     */
+    void reportError(RequestType type, int id, const QString& errorMsg);
+
     /**
      * @brief Manager Qt do obsługi żądań sieciowych.
      * @note W obecnej implementacji (z QtConcurrent::run i QEventLoop) ten manager nie jest bezpośrednio używany w metodach fetch*,
@@ -107,8 +185,7 @@ private:
      */
     QNetworkAccessManager *m_networkManager;
 
-    ///< Podstawowy URL dla endpointów API Głównego Inspektoratu Ochrony Środowiska.
-    const QString m_baseUrl = "https://api.gios.gov.pl/pjp-api/rest";
+    Transport m_transport; ///< Bieżące źródło odpowiedzi (ustawiane z wątku GUI).
 };
 
 #endif // APISERVICE_H
@@ -0,0 +1,151 @@
+#include "AqiCalculator.h"
+#include <QDateTime>
+#include <QTime>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace {
+
+/// Zaokrągla datę w dół do pełnej godziny.
+QDateTime truncateToHour(const QDateTime& date)
+{
+    const QTime time = date.time();
+    return date.addMSecs(-static_cast<qint64>((time.minute() * 60 + time.second()) * 1000 + time.msec()));
+}
+
+/// Zapamiętuje wyższe stężenie (kilka czujników tego samego zanieczyszczenia - decyduje gorszy odczyt).
+void keepWorse(double& slot, double value)
+{
+    if (std::isnan(slot) || value > slot) {
+        slot = value;
+    }
+}
+
+} // namespace
+
+std::optional<Pollutant> AqiCalculator::pollutantFromCode(const QString& paramCode)
+{
+    QString code = paramCode.trimmed().toUpper();
+    code.remove(QLatin1Char('.'));
+
+    if (code == QLatin1String("SO2")) return Pollutant::SO2;
+    if (code == QLatin1String("NO2")) return Pollutant::NO2;
+    if (code == QLatin1String("CO")) return Pollutant::CO;
+    if (code == QLatin1String("PM10")) return Pollutant::PM10;
+    if (code == QLatin1String("PM25")) return Pollutant::PM25;
+    if (code == QLatin1String("O3")) return Pollutant::O3;
+    if (code == QLatin1String("C6H6")) return Pollutant::C6H6;
+    return std::nullopt;
+}
+
+QString AqiCalculator::pollutantCode(Pollutant pollutant)
+{
+    switch (pollutant) {
+    case Pollutant::SO2: return QStringLiteral("SO2");
+    case Pollutant::NO2: return QStringLiteral("NO2");
+    case Pollutant::CO: return QStringLiteral("CO");
+    case Pollutant::PM10: return QStringLiteral("PM10");
+    case Pollutant::PM25: return QStringLiteral("PM2.5");
+    case Pollutant::O3: return QStringLiteral("O3");
+    case Pollutant::C6H6: return QStringLiteral("C6H6");
+    }
+    return QString();
+}
+
+AirQualityIndex AqiCalculator::buildIndex(int stationId, const Concentrations& concentrations)
+{
+    AirQualityIndex index;
+    index.stationId = stationId;
+
+    int worst = -1;
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        const int level = levelForConcentration(static_cast<Pollutant>(p), concentrations[p]);
+        index.pollutantLevels[p] = toIndexLevel(level);
+        worst = std::max(worst, level);
+    }
+    index.stIndexLevel = toIndexLevel(worst);
+    return index;
+}
+
+AirQualityIndex AqiCalculator::computeIndex(int stationId, const std::vector<SensorData>& series, int maxAgeHours)
+{
+    // Godzina indeksu: najnowszy prawidłowy pomiar dowolnego obsługiwanego zanieczyszczenia
+    QDateTime indexHour;
+    for (const SensorData& data : series) {
+        if (!pollutantFromCode(data.key)) {
+            continue;
+        }
+        for (const MeasurementValue& mv : data.values) {
+            if (mv.date.isValid() && !std::isnan(mv.value) && (!indexHour.isValid() || mv.date > indexHour)) {
+                indexHour = mv.date;
+            }
+        }
+    }
+    if (!indexHour.isValid()) {
+        return AirQualityIndex();
+    }
+    indexHour = truncateToHour(indexHour);
+
+    // Okno (indexHour - maxAgeHours, indexHour]; w każdej serii najnowszy prawidłowy pomiar z okna
+    const QDateTime windowEnd = indexHour.addSecs(3600);
+    const QDateTime windowStart = indexHour.addSecs(-3600 * static_cast<qint64>(std::max(1, maxAgeHours) - 1));
+
+    Concentrations concentrations;
+    concentrations.fill(std::numeric_limits<double>::quiet_NaN());
+    for (const SensorData& data : series) {
+        const std::optional<Pollutant> pollutant = pollutantFromCode(data.key);
+        if (!pollutant) {
+            continue;
+        }
+        const MeasurementValue* latest = nullptr;
+        for (const MeasurementValue& mv : data.values) {
+            if (!mv.date.isValid() || std::isnan(mv.value) || mv.date < windowStart || mv.date >= windowEnd) {
+                continue;
+            }
+            if (!latest || mv.date > latest->date) {
+                latest = &mv;
+            }
+        }
+        if (latest) {
+            keepWorse(concentrations[static_cast<std::size_t>(*pollutant)], latest->value);
+        }
+    }
+
+    AirQualityIndex index = buildIndex(stationId, concentrations);
+    index.stCalcDate = QDateTime::currentDateTime();
+    index.stSourceDataDate = indexHour;
+    return index;
+}
+
+std::vector<AirQualityIndex> AqiCalculator::computeHourlyIndices(int stationId, const std::vector<SensorData>& series)
+{
+    std::map<QDateTime, Concentrations> hours;
+    for (const SensorData& data : series) {
+        const std::optional<Pollutant> pollutant = pollutantFromCode(data.key);
+        if (!pollutant) {
+            continue;
+        }
+        for (const MeasurementValue& mv : data.values) {
+            if (!mv.date.isValid() || std::isnan(mv.value)) {
+                continue;
+            }
+            auto inserted = hours.try_emplace(truncateToHour(mv.date));
+            if (inserted.second) {
+                inserted.first->second.fill(std::numeric_limits<double>::quiet_NaN());
+            }
+            keepWorse(inserted.first->second[static_cast<std::size_t>(*pollutant)], mv.value);
+        }
+    }
+
+    std::vector<AirQualityIndex> indices;
+    indices.reserve(hours.size());
+    for (const auto& hour : hours) {
+        AirQualityIndex index = buildIndex(stationId, hour.second);
+        index.stCalcDate = hour.first;
+        index.stSourceDataDate = hour.first;
+        indices.push_back(index);
+    }
+    return indices;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file AqiCalculator.h
+ * @brief Definicja klasy AqiCalculator - lokalnego obliczania Polskiego Indeksu Jakości Powietrza z danych pomiarowych.
+ */
+#ifndef AQICALCULATOR_H
+#define AQICALCULATOR_H
+
+#include <QString>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @struct AqiBreakpoints
+ * @brief Progi stężeń jednego zanieczyszczenia dla kolejnych poziomów indeksu.
+ */
+struct AqiBreakpoints {
+    Pollutant pollutant;               ///< Zanieczyszczenie.
+    std::array<double, 5> upperBounds; ///< Górne granice (włącznie) poziomów 0-4 [µg/m³]; powyżej ostatniej - poziom 5.
+};
+
+/**
+ * @class AqiCalculator
+ * @brief Oblicza indeks jakości powietrza (wg progów GIOŚ) z godzinowych stężeń zapisanych w SensorData.
+ *
+ * Poziom indeksu zanieczyszczenia to pierwszy poziom, którego górna granica nie jest mniejsza od stężenia
+ * (0 - Bardzo dobry ... 5 - Bardzo zły). Indeks ogólny to najgorszy z indeksów zanieczyszczeń.
+ * Tablica progów jest stałą czasu kompilacji, więc wyznaczenie poziomu nie wymaga żadnej alokacji.
+ *
+ * Pozwala to wyświetlić indeks bez zapytania aqindex/getIndex (np. gdy jest niedostępne) oraz wyznaczyć
+ * historię indeksu godzina po godzinie, której API nie udostępnia.
+ */
+class AqiCalculator
+{
+public:
+    /// Liczba poziomów indeksu (0-5).
+    static constexpr int LevelCount = IndexLevelCount;
+
+    /// Progi stężeń [µg/m³] wg Polskiego Indeksu Jakości Powietrza, w kolejności enum Pollutant.
+    static constexpr std::array<AqiBreakpoints, PollutantCount> Breakpoints = {{
+        {Pollutant::SO2,  {{50.0, 100.0, 200.0, 350.0, 500.0}}},
+        {Pollutant::NO2,  {{40.0, 100.0, 150.0, 230.0, 400.0}}},
+        {Pollutant::CO,   {{3000.0, 7000.0, 11000.0, 15000.0, 21000.0}}},
+        {Pollutant::PM10, {{20.0, 50.0, 80.0, 110.0, 150.0}}},
+        {Pollutant::PM25, {{13.0, 35.0, 55.0, 75.0, 110.0}}},
+        {Pollutant::O3,   {{70.0, 120.0, 150.0, 180.0, 240.0}}},
+        {Pollutant::C6H6, {{6.0, 11.0, 16.0, 21.0, 51.0}}},
+    }};
+
+    /**
+     * @brief Wyznacza poziom indeksu dla stężenia zanieczyszczenia.
+     * @param pollutant Zanieczyszczenie.
+     * @param value Stężenie w µg/m³.
+     * @return Poziom 0-5; -1 dla NaN.
+     */
+    static constexpr int levelForConcentration(Pollutant pollutant, double value) {
+        if (value != value) { // NaN
+            return -1;
+        }
+        const std::array<double, 5>& bounds = Breakpoints[static_cast<std::size_t>(pollutant)].upperBounds;
+        for (std::size_t i = 0; i < bounds.size(); ++i) {
+            if (value <= bounds[i]) {
+                return static_cast<int>(i);
+            }
+        }
+        return LevelCount - 1;
+    }
+
+    /**
+     * @brief Rozpoznaje zanieczyszczenie na podstawie kodu parametru (np. "PM10", "PM2.5", "pm25").
+     * @return Zanieczyszczenie lub std::nullopt, jeśli parametr nie wchodzi do indeksu.
+     */
+    static std::optional<Pollutant> pollutantFromCode(const QString& paramCode);
+
+    /** @brief Zwraca kod parametru GIOŚ dla zanieczyszczenia (np. "PM2.5"). */
+    static QString pollutantCode(Pollutant pollutant);
+
+    /**
+     * @brief Oblicza bieżący indeks stacji z serii jej czujników.
+     *
+     * Godziną indeksu jest najnowsza godzina z prawidłowym pomiarem któregokolwiek zanieczyszczenia. Dla każdego
+     * zanieczyszczenia brany jest jego najnowszy prawidłowy pomiar z okna `maxAgeHours` godzin kończącego się
+     * w tej godzinie (gdy stacja ma kilka czujników tego samego zanieczyszczenia - wyższe stężenie).
+     *
+     * @param stationId ID stacji wpisywane do wyniku.
+     * @param series Serie czujników stacji (SensorData::key to kod parametru); nieobsługiwane parametry są pomijane.
+     * @param maxAgeHours Maksymalny wiek pomiaru względem godziny indeksu (w godzinach, min. 1).
+     * @return Indeks ze stCalcDate = bieżący czas i stSourceDataDate = godzina indeksu;
+     *         stationId = -1, jeśli żadna seria nie zawiera prawidłowego pomiaru.
+     */
+    static AirQualityIndex computeIndex(int stationId, const std::vector<SensorData>& series, int maxAgeHours = 3);
+
+    /**
+     * @brief Oblicza indeks stacji dla każdej godziny, w której jest co najmniej jeden prawidłowy pomiar.
+     *
+     * Pomiary są przypisywane do pełnych godzin; w danej godzinie indeks zanieczyszczenia bez pomiaru to
+     * "Brak indeksu" (brak przenoszenia wartości z wcześniejszych godzin).
+     *
+     * @param stationId ID stacji wpisywane do wyników.
+     * @param series Serie czujników stacji (jak w computeIndex()).
+     * @return Indeksy posortowane rosnąco po godzinie; stCalcDate = stSourceDataDate = godzina.
+     */
+    static std::vector<AirQualityIndex> computeHourlyIndices(int stationId, const std::vector<SensorData>& series);
+
+private:
+    /// Stężenia zanieczyszczeń w jednej godzinie (NaN - brak pomiaru).
+    using Concentrations = std::array<double, PollutantCount>;
+
+    /// Buduje indeks z poziomów zanieczyszczeń; poziom ogólny to najgorszy z dostępnych.
+    static AirQualityIndex buildIndex(int stationId, const Concentrations& concentrations);
+};
+
+namespace AqiCalculatorChecks {
+/// Sprawdza (w czasie kompilacji), że tablica progów jest w kolejności enum Pollutant, a progi rosną.
+constexpr bool breakpointsAreConsistent() {
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        const AqiBreakpoints& entry = AqiCalculator::Breakpoints[p];
+        if (static_cast<std::size_t>(entry.pollutant) != p) {
+            return false;
+        }
+        for (std::size_t i = 1; i < entry.upperBounds.size(); ++i) {
+            if (!(entry.upperBounds[i - 1] < entry.upperBounds[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(breakpointsAreConsistent(), "AqiCalculator::Breakpoints must follow Pollutant order with ascending bounds");
+static_assert(AqiCalculator::levelForConcentration(Pollutant::PM10, 20.0) == 0, "PM10 20 µg/m³ is 'Bardzo dobry'");
+static_assert(AqiCalculator::levelForConcentration(Pollutant::PM10, 151.0) == 5, "PM10 above 150 µg/m³ is 'Bardzo zły'");
+} // namespace AqiCalculatorChecks
+
+#endif // AQICALCULATOR_H
@@ -0,0 +1,397 @@
+#include "AqiHistoryStore.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr char Magic[4] = {'A', 'Q', 'I', 'H'};
+
+/// Nagłówek pliku: "AQIH", wersja formatu i długość rekordu (little-endian).
+QByteArray header()
+{
+    QByteArray bytes(AqiHistoryStore::HeaderSize, '\0');
+    uchar* out = reinterpret_cast<uchar*>(bytes.data());
+    std::copy(Magic, Magic + 4, bytes.data());
+    qToLittleEndian<quint16>(AqiHistoryStore::FormatVersion, out + 4);
+    qToLittleEndian<quint16>(AqiHistoryStore::RecordSize, out + 6);
+    return bytes;
+}
+
+bool isValidHeader(const uchar* in)
+{
+    return std::equal(Magic, Magic + 4, reinterpret_cast<const char*>(in))
+           && qFromLittleEndian<quint16>(in + 4) == AqiHistoryStore::FormatVersion
+           && qFromLittleEndian<quint16>(in + 6) == AqiHistoryStore::RecordSize;
+}
+
+qint64 toMSecs(const QDateTime& date, qint64 fallback)
+{
+    return date.isValid() ? date.toMSecsSinceEpoch() : fallback;
+}
+
+} // namespace
+
+AqiHistoryStore::AqiHistoryStore(const QString& storagePath) : m_storagePath(storagePath)
+{
+}
+
+QString AqiHistoryStore::fileName(int stationId)
+{
+    return QString("station_%1_aqi_history.bin").arg(stationId);
+}
+
+QString AqiHistoryStore::filePath(int stationId) const
+{
+    return m_storagePath + QDir::separator() + fileName(stationId);
+}
+
+AqiHistoryStore::Record AqiHistoryStore::toRecord(const AirQualityIndex& index)
+{
+    Record record;
+    record.calcMSecs = index.stCalcDate.toMSecsSinceEpoch();
+    record.sourceMSecs = toMSecs(index.stSourceDataDate, std::numeric_limits<qint64>::min());
+    record.stIndexLevel = index.stIndexLevel;
+    record.levels = index.pollutantLevels;
+    return record;
+}
+
+AirQualityIndex AqiHistoryStore::fromRecord(int stationId, const Record& record)
+{
+    AirQualityIndex index;
+    index.stationId = stationId;
+    index.stCalcDate = QDateTime::fromMSecsSinceEpoch(record.calcMSecs);
+    if (record.sourceMSecs != std::numeric_limits<qint64>::min()) {
+        index.stSourceDataDate = QDateTime::fromMSecsSinceEpoch(record.sourceMSecs);
+    }
+    index.stIndexLevel = toIndexLevel(record.stIndexLevel);
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        index.pollutantLevels[p] = toIndexLevel(record.levels[p]);
+    }
+    return index;
+}
+
+void AqiHistoryStore::encode(const Record& record, uchar* out)
+{
+    qToLittleEndian<qint64>(record.calcMSecs, out);
+    qToLittleEndian<qint64>(record.sourceMSecs, out + 8);
+    out[16] = static_cast<uchar>(record.stIndexLevel);
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        out[17 + p] = static_cast<uchar>(record.levels[p]);
+    }
+}
+
+AqiHistoryStore::Record AqiHistoryStore::decode(const uchar* in)
+{
+    Record record;
+    record.calcMSecs = qFromLittleEndian<qint64>(in);
+    record.sourceMSecs = qFromLittleEndian<qint64>(in + 8);
+    record.stIndexLevel = static_cast<qint8>(in[16]);
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        record.levels[p] = static_cast<qint8>(in[17 + p]);
+    }
+    return record;
+}
+
+std::vector<AqiHistoryStore::Record> AqiHistoryStore::readRecords(int stationId, qint64 fromMSecs, qint64 toMSecs) const
+{
+    std::vector<Record> records;
+    QFile file(filePath(stationId));
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return records;
+    }
+    const qint64 size = file.size();
+    if (size < HeaderSize) {
+        return records;
+    }
+
+    QByteArray buffer;
+    const uchar* data = file.map(0, size);
+    if (!data) { // np. system plików bez mapowania - odczyt całego pliku
+        buffer = file.readAll();
+        data = reinterpret_cast<const uchar*>(buffer.constData());
+    }
+    if (!isValidHeader(data)) {
+        qWarning() << "AQI history file has an unknown header, ignoring:" << file.fileName();
+        return records;
+    }
+
+    const qint64 count = (size - HeaderSize) / RecordSize; // niepełny rekord na końcu jest pomijany
+    auto calcAt = [data](qint64 i) { return qFromLittleEndian<qint64>(data + HeaderSize + i * RecordSize); };
+
+    qint64 lo = 0;
+    qint64 hi = count;
+    while (lo < hi) { // pierwszy rekord z calcMSecs >= fromMSecs
+        const qint64 mid = lo + (hi - lo) / 2;
+        if (calcAt(mid) < fromMSecs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (qint64 i = lo; i < count && calcAt(i) < toMSecs; ++i) {
+        records.push_back(decode(data + HeaderSize + i * RecordSize));
+    }
+    return records;
+}
+
+bool AqiHistoryStore::rewrite(int stationId, const std::vector<Record>& records) const
+{
+    QByteArray bytes = header();
+    bytes.resize(HeaderSize + static_cast<int>(records.size()) * RecordSize);
+    uchar* out = reinterpret_cast<uchar*>(bytes.data()) + HeaderSize;
+    for (const Record& record : records) {
+        encode(record, out);
+        out += RecordSize;
+    }
+
+    QSaveFile file(filePath(stationId));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't open AQI history for writing:" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(bytes);
+    if (!file.commit()) {
+        qWarning() << "Couldn't write AQI history:" << file.fileName() << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool AqiHistoryStore::append(const AirQualityIndex& index)
+{
+    if (index.stationId <= 0 || !index.stCalcDate.isValid()) {
+        qWarning() << "Cannot append AQI to history, invalid stationId or stCalcDate:" << index.stationId;
+        return false;
+    }
+    return appendBatch(index.stationId, {index}) > 0;
+}
+
+int AqiHistoryStore::appendBatch(int stationId, const std::vector<AirQualityIndex>& indices)
+{
+    std::vector<Record> batch;
+    batch.reserve(indices.size());
+    for (const AirQualityIndex& index : indices) {
+        if (index.stationId == stationId && index.stCalcDate.isValid()) {
+            batch.push_back(toRecord(index));
+        }
+    }
+    if (stationId <= 0 || batch.empty()) {
+        return 0;
+    }
+    auto byDate = [](const Record& a, const Record& b) { return a.calcMSecs < b.calcMSecs; };
+    auto sameDate = [](const Record& a, const Record& b) { return a.calcMSecs == b.calcMSecs; };
+    std::stable_sort(batch.begin(), batch.end(), byDate);
+    batch.erase(std::unique(batch.begin(), batch.end(), sameDate), batch.end());
+
+    QMutexLocker locker(&m_mutex);
+    QFile file(filePath(stationId));
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Couldn't open AQI history for writing:" << file.fileName() << file.errorString();
+        return -1;
+    }
+
+    qint64 size = file.size();
+    if (size < HeaderSize) { // nowy plik (lub przerwany zapis nagłówka)
+        file.resize(0);
+        file.write(header());
+        size = HeaderSize;
+    } else {
+        const QByteArray head = file.read(HeaderSize);
+        if (!isValidHeader(reinterpret_cast<const uchar*>(head.constData()))) {
+            qWarning() << "AQI history file has an unknown header, not appending:" << file.fileName();
+            return -1;
+        }
+    }
+    const qint64 wholeSize = HeaderSize + (size - HeaderSize) / RecordSize * RecordSize;
+    if (wholeSize != size) {
+        qWarning() << "Truncating incomplete AQI history record in" << file.fileName();
+        file.resize(wholeSize);
+    }
+
+    qint64 lastMSecs = std::numeric_limits<qint64>::min();
+    if (wholeSize > HeaderSize) {
+        file.seek(wholeSize - RecordSize);
+        lastMSecs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar*>(file.read(8).constData()));
+    }
+
+    if (batch.front().calcMSecs == lastMSecs) { // powtórzone odpytanie API - bez odczytu całej historii
+        batch.erase(batch.begin());
+        if (batch.empty()) {
+            return 0;
+        }
+    }
+    if (batch.front().calcMSecs > lastMSecs) { // typowy przypadek - nowsze indeksy, dopisanie na koniec
+        QByteArray bytes(static_cast<int>(batch.size()) * RecordSize, '\0');
+        uchar* out = reinterpret_cast<uchar*>(bytes.data());
+        for (const Record& record : batch) {
+            encode(record, out);
+            out += RecordSize;
+        }
+        file.seek(wholeSize);
+        if (file.write(bytes) != bytes.size() || !file.flush()) {
+            qWarning() << "Couldn't append to AQI history:" << file.fileName() << file.errorString();
+            return -1;
+        }
+        return static_cast<int>(batch.size());
+    }
+    file.close();
+
+    // Starsze indeksy - scalenie z historią i przepisanie pliku
+    const std::vector<Record> existing =
+        readRecords(stationId, std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max());
+    std::vector<Record> merged;
+    merged.reserve(existing.size() + batch.size());
+    int added = 0;
+    auto it = existing.begin();
+    for (const Record& record : batch) {
+        while (it != existing.end() && it->calcMSecs < record.calcMSecs) {
+            merged.push_back(*it++);
+        }
+        if (it != existing.end() && it->calcMSecs == record.calcMSecs) {
+            continue; // powtórzone odpytanie API - ten sam stCalcDate
+        }
+        merged.push_back(record);
+        added++;
+    }
+    merged.insert(merged.end(), it, existing.end());
+    if (added == 0) {
+        return 0;
+    }
+    return rewrite(stationId, merged) ? added : -1;
+}
+
+qint64 AqiHistoryStore::removeBefore(int stationId, const QDateTime& cutoff)
+{
+    if (!cutoff.isValid()) {
+        return 0;
+    }
+    QMutexLocker locker(&m_mutex);
+    const QFileInfo info(filePath(stationId));
+    const qint64 total = info.exists() ? (info.size() - HeaderSize) / RecordSize : 0;
+    if (total <= 0) {
+        return 0;
+    }
+    const std::vector<Record> kept =
+        readRecords(stationId, cutoff.toMSecsSinceEpoch(), std::numeric_limits<qint64>::max());
+    const qint64 removed = total - static_cast<qint64>(kept.size());
+    if (removed <= 0) {
+        return 0;
+    }
+    if (kept.empty()) {
+        return QFile::remove(filePath(stationId)) ? removed : -1;
+    }
+    return rewrite(stationId, kept) ? removed : -1;
+}
+
+std::vector<AirQualityIndex> AqiHistoryStore::range(int stationId, const QDateTime& from, const QDateTime& to) const
+{
+    QMutexLocker locker(&m_mutex);
+    const std::vector<Record> records = readRecords(stationId, toMSecs(from, std::numeric_limits<qint64>::min()),
+                                                    toMSecs(to, std::numeric_limits<qint64>::max()));
+    std::vector<AirQualityIndex> indices;
+    indices.reserve(records.size());
+    for (const Record& record : records) {
+        indices.push_back(fromRecord(stationId, record));
+    }
+    return indices;
+}
+
+AirQualityIndex AqiHistoryStore::latest(int stationId) const
+{
+    QMutexLocker locker(&m_mutex);
+    QFile file(filePath(stationId));
+    const qint64 recordCount = file.exists() ? (file.size() - HeaderSize) / RecordSize : 0;
+    if (recordCount <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return AirQualityIndex();
+    }
+    const QByteArray head = file.read(HeaderSize);
+    if (!isValidHeader(reinterpret_cast<const uchar*>(head.constData()))) {
+        return AirQualityIndex();
+    }
+    file.seek(HeaderSize + (recordCount - 1) * RecordSize);
+    const QByteArray bytes = file.read(RecordSize);
+    if (bytes.size() != RecordSize) {
+        return AirQualityIndex();
+    }
+    return fromRecord(stationId, decode(reinterpret_cast<const uchar*>(bytes.constData())));
+}
+
+qint64 AqiHistoryStore::count(int stationId) const
+{
+    QMutexLocker locker(&m_mutex);
+    QFileInfo info(filePath(stationId));
+    return info.exists() ? std::max<qint64>(0, (info.size() - HeaderSize) / RecordSize) : 0;
+}
+
+AqiLevelDurations AqiHistoryStore::levelDurations(int stationId, const QDateTime& from, const QDateTime& to,
+                                                  std::optional<Pollutant> pollutant, qint64 maxHoldSecs) const
+{
+    AqiLevelDurations result;
+    if (!from.isValid() || !to.isValid() || to <= from) {
+        return result;
+    }
+    const qint64 fromMSecs = from.toMSecsSinceEpoch();
+    const qint64 toMSecs = to.toMSecsSinceEpoch();
+    const qint64 maxHoldMSecs = std::max<qint64>(0, maxHoldSecs) * 1000;
+
+    std::vector<Record> records;
+    {
+        QMutexLocker locker(&m_mutex);
+        // Rekord obowiązujący w chwili `from` może być wcześniejszy o co najwyżej maxHoldSecs.
+        records = readRecords(stationId, fromMSecs - maxHoldMSecs, toMSecs);
+    }
+
+    std::array<qint64, IndexLevelCount> levelMSecs = {};
+    qint64 noIndexMSecs = 0;
+    qint64 coveredMSecs = 0;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const Record& record = records[i];
+        qint64 end = record.calcMSecs + maxHoldMSecs;
+        if (i + 1 < records.size()) {
+            end = std::min(end, records[i + 1].calcMSecs);
+        }
+        const qint64 begin = std::max(record.calcMSecs, fromMSecs);
+        end = std::min(end, toMSecs);
+        if (end <= begin) {
+            continue;
+        }
+
+        const int level = pollutant ? record.levels[static_cast<std::size_t>(*pollutant)] : record.stIndexLevel;
+        if (level >= 0 && level < IndexLevelCount) {
+            levelMSecs[static_cast<std::size_t>(level)] += end - begin;
+        } else {
+            noIndexMSecs += end - begin;
+        }
+        coveredMSecs += end - begin;
+    }
+
+    for (std::size_t level = 0; level < levelMSecs.size(); ++level) {
+        result.seconds[level] = levelMSecs[level] / 1000;
+    }
+    result.noIndexSeconds = noIndexMSecs / 1000;
+    result.uncoveredSeconds = (toMSecs - fromMSecs - coveredMSecs) / 1000;
+    return result;
+}
+
+std::vector<int> AqiHistoryStore::stationIds() const
+{
+    std::vector<int> ids;
+    const QString prefix = "station_";
+    const QString suffix = "_aqi_history.bin";
+    const QStringList files = QDir(m_storagePath).entryList(QStringList() << (prefix + "*" + suffix), QDir::Files);
+    for (const QString& name : files) {
+        bool ok = false;
+        const int id = name.mid(prefix.size(), name.size() - prefix.size() - suffix.size()).toInt(&ok);
+        if (ok && id > 0) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file AqiHistoryStore.h
+ * @brief Definicja klasy AqiHistoryStore - historii indeksów AQI stacji w plikach binarnych o stałej długości rekordu.
+ */
+#ifndef AQIHISTORYSTORE_H
+#define AQIHISTORYSTORE_H
+
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+#include <array>
+#include <optional>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @struct AqiLevelDurations
+ * @brief Czas, przez jaki stacja miała poszczególne poziomy indeksu w zadanym przedziale.
+ */
+struct AqiLevelDurations {
+    std::array<qint64, IndexLevelCount> seconds = {}; ///< Czas na poziomach 0-5 w sekundach (indeks tablicy = ID poziomu).
+    qint64 noIndexSeconds = 0;   ///< Czas z poziomem "Brak indeksu".
+    qint64 uncoveredSeconds = 0; ///< Czas bez żadnego indeksu w historii (przed pierwszym lub w lukach dłuższych niż maxHoldSecs).
+
+    /** @brief Czas na poziomie `levelId` w godzinach (0 dla ID spoza zakresu 0-5). */
+    double hours(int levelId) const {
+        return levelId >= 0 && levelId < IndexLevelCount ? seconds[static_cast<std::size_t>(levelId)] / 3600.0 : 0.0;
+    }
+};
+
+/**
+ * @class AqiHistoryStore
+ * @brief Historia indeksów AQI stacji (tylko dopisywanie), posortowana po dacie obliczenia indeksu (stCalcDate).
+ *
+ * Każda stacja ma własny plik "station_{stationId}_aqi_history.bin": 8-bajtowy nagłówek i rekordy o stałej długości
+ * 24 bajtów (stCalcDate i stSourceDataDate w ms od epoki, ogólny poziom i 7 poziomów zanieczyszczeń jako qint8,
+ * little-endian). Dzięki stałej długości rekordu zakres dat jest wyszukiwany binarnie w pliku zmapowanym do pamięci,
+ * bez parsowania całej historii.
+ *
+ * Ponowne odpytanie API zwracające ten sam stCalcDate nie dopisuje rekordu. Nowszy indeks jest dopisywany na koniec
+ * pliku; starszy (np. import archiwum) jest wstawiany z przepisaniem pliku. Niepełny rekord na końcu pliku (przerwany
+ * zapis) jest pomijany przy odczycie i obcinany przy następnym zapisie. Metody są bezpieczne wątkowo.
+ */
+class AqiHistoryStore
+{
+public:
+    /// Długość nagłówka pliku w bajtach ("AQIH", wersja formatu, długość rekordu).
+    static constexpr int HeaderSize = 8;
+    /// Długość rekordu w bajtach.
+    static constexpr int RecordSize = 24;
+    /// Wersja formatu pliku.
+    static constexpr quint16 FormatVersion = 1;
+
+    /**
+     * @brief Konstruktor.
+     * @param storagePath Katalog, w którym zapisywane są pliki historii (musi istnieć).
+     */
+    explicit AqiHistoryStore(const QString& storagePath = ".");
+
+    AqiHistoryStore(const AqiHistoryStore&) = delete;
+    AqiHistoryStore& operator=(const AqiHistoryStore&) = delete;
+
+    /**
+     * @brief Dopisuje indeks do historii stacji `index.stationId`.
+     * @return `true`, jeśli rekord został zapisany; `false` dla duplikatu stCalcDate, nieprawidłowego indeksu
+     *         (stationId <= 0, brak stCalcDate) lub błędu zapisu.
+     */
+    bool append(const AirQualityIndex& index);
+
+    /**
+     * @brief Dopisuje wiele indeksów jednej stacji (np. import archiwum) jednym zapisem pliku.
+     * @param stationId ID stacji; indeksy innych stacji i bez stCalcDate są pomijane.
+     * @param indices Indeksy w dowolnej kolejności; duplikaty stCalcDate (w partii i w historii) są pomijane.
+     * @return Liczba nowych rekordów; -1 w przypadku błędu zapisu.
+     */
+    int appendBatch(int stationId, const std::vector<AirQualityIndex>& indices);
+
+    /**
+     * @brief Usuwa z historii stacji indeksy z stCalcDate wcześniejszym niż `cutoff` (zasady przechowywania cache).
+     * Plik jest przepisywany tylko wtedy, gdy jest co usunąć; pusta historia jest usuwana razem z plikiem.
+     * @return Liczba usuniętych rekordów; -1 w przypadku błędu zapisu.
+     */
+    qint64 removeBefore(int stationId, const QDateTime& cutoff);
+
+    /**
+     * @brief Zwraca indeksy stacji z stCalcDate w przedziale [from, to), posortowane rosnąco.
+     * Nieprawidłowe `from`/`to` oznaczają przedział otwarty z danej strony.
+     */
+    std::vector<AirQualityIndex> range(int stationId, const QDateTime& from = QDateTime(), const QDateTime& to = QDateTime()) const;
+
+    /** @brief Zwraca najnowszy indeks z historii stacji (stationId = -1, jeśli historia jest pusta). */
+    AirQualityIndex latest(int stationId) const;
+
+    /** @brief Liczba rekordów w historii stacji. */
+    qint64 count(int stationId) const;
+
+    /**
+     * @brief Sumuje czas na poszczególnych poziomach indeksu w przedziale [from, to) (np. "godziny na poziomie Zły
+     *        w ostatnim miesiącu").
+     *
+     * Poziom z rekordu obowiązuje od jego stCalcDate do stCalcDate następnego rekordu, ale nie dłużej niż `maxHoldSecs`
+     * (dłuższe przerwy w odpytywaniu liczą się jako uncoveredSeconds). Uwzględniany jest też ostatni rekord sprzed `from`.
+     *
+     * @param stationId ID stacji.
+     * @param from Początek przedziału (musi być prawidłowy).
+     * @param to Koniec przedziału (musi być prawidłowy i późniejszy niż `from`).
+     * @param pollutant Zanieczyszczenie; std::nullopt - ogólny poziom indeksu.
+     * @param maxHoldSecs Maksymalny czas obowiązywania rekordu w sekundach.
+     */
+    AqiLevelDurations levelDurations(int stationId, const QDateTime& from, const QDateTime& to,
+                                     std::optional<Pollutant> pollutant = std::nullopt, qint64 maxHoldSecs = 2 * 3600) const;
+
+    /** @brief Zwraca ID stacji, dla których istnieje plik historii (posortowane rosnąco). */
+    std::vector<int> stationIds() const;
+
+    /// Nazwa pliku historii AQI stacji ("station_{stationId}_aqi_history.bin").
+    static QString fileName(int stationId);
+
+private:
+    /// Rekord historii w pamięci (pola jak w pliku).
+    struct Record {
+        qint64 calcMSecs = 0;
+        qint64 sourceMSecs = 0;
+        qint8 stIndexLevel = NoIndexLevel;
+        std::array<qint8, PollutantCount> levels = {};
+    };
+
+    /// Wczytuje rekordy stacji z przedziału [fromMSecs, toMSecs) (wyszukiwanie binarne w zmapowanym pliku).
+    std::vector<Record> readRecords(int stationId, qint64 fromMSecs, qint64 toMSecs) const;
+    /// Przepisuje cały plik stacji posortowanymi rekordami.
+    bool rewrite(int stationId, const std::vector<Record>& records) const;
+
+    static Record toRecord(const AirQualityIndex& index);
+    static AirQualityIndex fromRecord(int stationId, const Record& record);
+    static void encode(const Record& record, uchar* out);
+    static Record decode(const uchar* in);
+
+    QString filePath(int stationId) const;
+
+    QString m_storagePath;      ///< Katalog plików historii.
+    mutable QMutex m_mutex;     ///< Chroni pliki historii przed równoczesnym zapisem i odczytem.
+};
+
+#endif // AQIHISTORYSTORE_H
@@ -0,0 +1,371 @@
+#include "ArchiveImporter.h"
+#include "AqiHistoryStore.h"
+#include "DataParser.h"
+#include "DataStorage.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+namespace {
+
+std::optional<QByteArray> readWholeFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Nie można otworzyć pliku importu:" << path << file.errorString();
+        return std::nullopt;
+    }
+    return file.readAll();
+}
+
+} // namespace
+
+ArchiveImporter::ArchiveImporter(DataStorage* storage) : m_storage(storage)
+{
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+void ArchiveImporter::setMaxThreadCount(int count)
+{
+    m_pool.setMaxThreadCount(std::max(1, count));
+}
+
+int ArchiveImporter::maxThreadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+ArchiveImporter::CaptureKind ArchiveImporter::captureKind(const QString& filePath, int* id)
+{
+    const QStringList parts = QDir::fromNativeSeparators(filePath).split('/', Qt::SkipEmptyParts);
+    if (parts.size() < 2) {
+        return CaptureKind::Unknown;
+    }
+    const QString& name = parts.at(parts.size() - 1);
+    const QString& directory = parts.at(parts.size() - 2);
+    const QString parent = parts.size() >= 3 ? parts.at(parts.size() - 3) : QString();
+    if (directory == QLatin1String("station") && name.startsWith(QLatin1String("findAll"))) {
+        return CaptureKind::Stations;
+    }
+
+    // ID jest na początku nazwy pliku, np. "1234.json" lub "1234_20240101T120000.json".
+    int digits = 0;
+    while (digits < name.size() && name.at(digits).isDigit()) {
+        ++digits;
+    }
+    bool ok = false;
+    const int parsedId = name.left(digits).toInt(&ok);
+    if (!ok || parsedId <= 0 || (digits < name.size() && name.at(digits) != '_' && name.at(digits) != '.')) {
+        return CaptureKind::Unknown;
+    }
+    CaptureKind kind = CaptureKind::Unknown;
+    if (parent == QLatin1String("station") && directory == QLatin1String("sensors")) {
+        kind = CaptureKind::Sensors;
+    } else if (parent == QLatin1String("data") && directory == QLatin1String("getData")) {
+        kind = CaptureKind::Measurements;
+    } else if (parent == QLatin1String("aqindex") && directory == QLatin1String("getIndex")) {
+        kind = CaptureKind::AqiIndex;
+    }
+    if (kind != CaptureKind::Unknown && id) {
+        *id = parsedId;
+    }
+    return kind;
+}
+
+ImportStats ArchiveImporter::importDirectory(const QString& directoryPath)
+{
+    QStringList paths;
+    QDirIterator it(directoryPath, QStringList() << QStringLiteral("*.json") << QStringLiteral("*.csv"), QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        paths.append(it.next());
+    }
+    if (paths.isEmpty()) {
+        qWarning() << "Brak plików do importu w katalogu:" << directoryPath;
+    }
+    return importFiles(paths);
+}
+
+ImportStats ArchiveImporter::importFiles(const QStringList& filePaths)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ImportContext context;
+    context.stats.threadCount = m_pool.maxThreadCount();
+
+    // Odpowiedzi API jednego czujnika lub stacji tworzą jedno zadanie: seria czujnika jest scalana i zapisywana raz
+    // na partię, a nie raz na plik (archiwum godzinowych odpowiedzi ma tysiące plików na czujnik).
+    QStringList paths = filePaths;
+    std::sort(paths.begin(), paths.end());
+    std::vector<ImportTask> tasks;
+    QHash<QPair<int, int>, std::size_t> taskIndex; // (rodzaj, ID) -> indeks zadania
+    for (const QString& path : paths) {
+        const qint64 size = QFileInfo(path).size();
+        if (path.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive)) {
+            ImportTask task;
+            task.paths.append(path);
+            task.size = size;
+            tasks.push_back(task);
+            continue;
+        }
+        int id = -1;
+        const CaptureKind kind = captureKind(path, &id);
+        if (kind == CaptureKind::Unknown) {
+            qWarning() << "Nierozpoznany plik importu:" << path;
+            context.stats.filesFailed++;
+            continue;
+        }
+        const QPair<int, int> key(static_cast<int>(kind), id);
+        auto existing = taskIndex.constFind(key);
+        const std::size_t index = existing != taskIndex.constEnd() ? *existing : tasks.size();
+        if (index == tasks.size()) {
+            taskIndex.insert(key, index);
+            ImportTask task;
+            task.kind = kind;
+            task.id = id;
+            tasks.push_back(task);
+        }
+        ImportTask& task = tasks[index];
+        task.paths.append(path);
+        task.size += size;
+    }
+    // Największe zadania najpierw - długi import jednego pliku nie zostaje na koniec, gdy inne wątki już skończyły.
+    std::stable_sort(tasks.begin(), tasks.end(), [](const ImportTask& a, const ImportTask& b) { return a.size > b.size; });
+
+    QtConcurrent::blockingMap(&m_pool, tasks, [this, &context](const ImportTask& task) { runTask(task, context); });
+    if (!m_storage->flush()) {
+        qWarning() << "Nie udało się zapisać wszystkich zaimportowanych danych na dysk.";
+    }
+    // Zaimportowana historia nie może zniknąć przy porządkowaniu cache (DataStorage::compact()).
+    for (int sensorId : context.updatedSensors) {
+        m_storage->setSeriesRetained(sensorId);
+    }
+
+    ImportStats stats = context.stats;
+    stats.sensorsUpdated = static_cast<int>(context.updatedSensors.size());
+    stats.elapsedMs = timer.elapsed();
+    qInfo() << "Import zakończony:" << stats.filesRead << "plików," << stats.filesFailed << "błędnych,"
+            << stats.pointsAdded << "nowych pomiarów z" << stats.pointsRead << "(" << stats.duplicatesSkipped
+            << "powtórzonych)," << stats.sensorsUpdated << "czujników," << stats.indicesAdded << "indeksów AQI,"
+            << stats.elapsedMs << "ms";
+    return stats;
+}
+
+void ArchiveImporter::runTask(const ImportTask& task, ImportContext& context)
+{
+    switch (task.kind) {
+    case CaptureKind::Unknown:
+        importCsvFile(task.paths.first(), context);
+        break;
+    case CaptureKind::Measurements:
+        importMeasurements(task, context);
+        break;
+    case CaptureKind::AqiIndex:
+        importAirQualityIndices(task, context);
+        break;
+    case CaptureKind::Stations:
+    case CaptureKind::Sensors:
+        importMetadata(task, context);
+        break;
+    }
+}
+
+void ArchiveImporter::importCsvFile(const QString& path, ImportContext& context)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Nie można otworzyć pliku importu:" << path << file.errorString();
+        QMutexLocker locker(&context.mutex);
+        context.stats.filesFailed++;
+        return;
+    }
+    DataParser parser;
+    const CsvArchiveLayout layout = parser.parseCsvHeader(file.readLine());
+    if (!layout.isValid()) {
+        qWarning() << "Nieobsługiwany układ kolumn pliku CSV:" << path;
+        QMutexLocker locker(&context.mutex);
+        context.stats.filesFailed++;
+        return;
+    }
+
+    // Plik jest czytany fragmentami; parsowane są tylko pełne wiersze, a niepełny wiersz z końca fragmentu czeka
+    // na następny.
+    std::map<int, SensorData> pending;
+    quint64 rowsSkipped = 0;
+    QByteArray buffer;
+    while (true) {
+        const QByteArray block = file.read(CsvChunkBytes);
+        const bool atEnd = block.isEmpty();
+        buffer.append(block);
+        const int complete = atEnd ? buffer.size() : buffer.lastIndexOf('\n') + 1;
+        if (complete > 0) {
+            rowsSkipped += static_cast<quint64>(parser.parseCsvRows(buffer.left(complete), layout, pending));
+            buffer.remove(0, complete);
+            std::size_t pendingPoints = 0;
+            for (const auto& entry : pending) {
+                pendingPoints += entry.second.values.size();
+            }
+            if (pendingPoints >= MaxPendingPoints) {
+                flushPending(pending, context);
+            }
+        }
+        if (atEnd) {
+            break;
+        }
+    }
+    flushPending(pending, context);
+
+    QMutexLocker locker(&context.mutex);
+    context.stats.filesRead++;
+    context.stats.rowsSkipped += rowsSkipped;
+}
+
+void ArchiveImporter::importMeasurements(const ImportTask& task, ImportContext& context)
+{
+    DataParser parser;
+    std::map<int, SensorData> pending;
+    SensorData* series = &pending[task.id];
+    int filesRead = 0;
+    int filesFailed = 0;
+    for (const QString& path : task.paths) {
+        const std::optional<QByteArray> bytes = readWholeFile(path);
+        SensorData data = bytes ? parser.parseSensorData(*bytes) : SensorData();
+        if (data.key.isEmpty()) {
+            qWarning() << "Nieprawidłowa odpowiedź z danymi czujnika:" << path;
+            filesFailed++;
+            continue;
+        }
+        filesRead++;
+        if (series->key.isEmpty()) {
+            series->key = data.key;
+        } else if (series->key != data.key) {
+            qWarning() << "Pominięto plik" << path << "- parametr" << data.key << "różni się od" << series->key;
+            filesFailed++;
+            continue;
+        }
+        series->values.insert(series->values.end(), data.values.begin(), data.values.end());
+        if (series->values.size() >= MaxPendingPoints) {
+            const QString key = series->key;
+            flushPending(pending, context);
+            series = &pending[task.id];
+            series->key = key;
+        }
+    }
+    flushPending(pending, context);
+
+    QMutexLocker locker(&context.mutex);
+    context.stats.filesRead += filesRead;
+    context.stats.filesFailed += filesFailed;
+}
+
+void ArchiveImporter::importAirQualityIndices(const ImportTask& task, ImportContext& context)
+{
+    DataParser parser;
+    std::vector<AirQualityIndex> indices;
+    int filesFailed = 0;
+    for (const QString& path : task.paths) {
+        const std::optional<QByteArray> bytes = readWholeFile(path);
+        const AirQualityIndex index = bytes ? parser.parseAirQualityIndex(*bytes) : AirQualityIndex();
+        if (index.stationId != task.id || !index.stCalcDate.isValid()) {
+            qWarning() << "Nieprawidłowa odpowiedź z indeksem AQI stacji" << task.id << ":" << path;
+            filesFailed++;
+            continue;
+        }
+        indices.push_back(index);
+    }
+    // Jeden zapis pliku historii na stację; duplikaty stCalcDate pomija AqiHistoryStore.
+    const int added = indices.empty() ? 0 : m_storage->airQualityIndexHistory().appendBatch(task.id, indices);
+    if (added < 0) {
+        qWarning() << "Nie udało się zapisać historii indeksów AQI stacji" << task.id;
+    }
+
+    QMutexLocker locker(&context.mutex);
+    context.stats.filesRead += static_cast<int>(task.paths.size()) - filesFailed;
+    context.stats.filesFailed += filesFailed;
+    context.stats.indicesAdded += std::max(0, added);
+}
+
+void ArchiveImporter::importMetadata(const ImportTask& task, ImportContext& context)
+{
+    // Listy stacji i czujników nie mają dat - archiwalna lista mogłaby nadpisać aktualną, więc jest zapisywana tylko
+    // wtedy, gdy cache jej nie ma. Używana jest najnowsza poprawna odpowiedź (ostatnia wg nazwy pliku).
+    DataParser parser;
+    const bool isStations = task.kind == CaptureKind::Stations;
+    const bool cached = isStations ? !m_storage->loadStationsFromJson().empty()
+                                   : !m_storage->loadSensorsFromJson(task.id).empty();
+    bool saved = false;
+    int filesFailed = 0;
+    for (auto it = task.paths.crbegin(); it != task.paths.crend() && !cached && !saved; ++it) {
+        const std::optional<QByteArray> bytes = readWholeFile(*it);
+        if (!bytes) {
+            filesFailed++;
+            continue;
+        }
+        if (isStations) {
+            const std::vector<MeasuringStation> stations = parser.parseStations(*bytes);
+            saved = !stations.empty() && m_storage->saveStationsToJson(stations);
+        } else {
+            const std::vector<Sensor> sensors = parser.parseSensors(*bytes);
+            saved = !sensors.empty() && m_storage->saveSensorsToJson(task.id, sensors);
+        }
+        if (!saved) {
+            qWarning() << "Nieprawidłowa odpowiedź z listą" << (isStations ? "stacji:" : "czujników:") << *it;
+            filesFailed++;
+        }
+    }
+
+    QMutexLocker locker(&context.mutex);
+    context.stats.filesRead += static_cast<int>(task.paths.size()) - filesFailed;
+    context.stats.filesFailed += filesFailed;
+    context.stats.metadataSaved += saved ? 1 : 0;
+}
+
+void ArchiveImporter::flushPending(std::map<int, SensorData>& pending, ImportContext& context)
+{
+    for (auto& entry : pending) {
+        if (!entry.second.values.empty()) {
+            mergeSensorData(entry.first, std::move(entry.second), context);
+        }
+    }
+    pending.clear();
+}
+
+void ArchiveImporter::mergeSensorData(int sensorId, SensorData imported, ImportContext& context)
+{
+    // NaN nie niesie informacji - pusty pomiar z archiwum nie jest zapisywany.
+    std::vector<MeasurementValue>& incoming = imported.values;
+    incoming.erase(std::remove_if(incoming.begin(), incoming.end(), [](const MeasurementValue& mv) {
+        return !mv.date.isValid() || std::isnan(mv.value);
+    }), incoming.end());
+    const quint64 pointsRead = incoming.size();
+
+    SeriesMergeStats merge;
+    const bool saved = m_storage->mergeSensorSeries(sensorId, imported, SeriesMergePolicy::KeepExisting, &merge)
+                           .has_value();
+    if (!saved) {
+        qWarning() << "Pominięto import czujnika" << sensorId << "- parametr" << imported.key
+                   << "różni się od zapisanego, jest nieznany lub zapis się nie powiódł.";
+    }
+
+    QMutexLocker locker(&context.mutex);
+    context.stats.pointsRead += pointsRead;
+    if (!saved) {
+        context.stats.sensorsRejected++;
+        return;
+    }
+    context.stats.pointsAdded += merge.added;
+    context.stats.duplicatesSkipped += merge.unchanged;
+    if (merge.added > 0) {
+        context.updatedSensors.insert(sensorId);
+    }
+}
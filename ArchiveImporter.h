@@ -0,0 +1,138 @@
+/**
+ * @file ArchiveImporter.h
+ * @brief Definicja klasy ArchiveImporter - importu archiwalnych danych (zapisanych odpowiedzi API i plików CSV) do cache.
+ */
+#ifndef ARCHIVEIMPORTER_H
+#define ARCHIVEIMPORTER_H
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <map>
+#include <vector>
+#include "DataStructures.h"
+
+class DataStorage;
+
+/**
+ * @struct ImportStats
+ * @brief Statystyki importu.
+ */
+struct ImportStats {
+    int filesRead = 0;              ///< Wczytane pliki.
+    int filesFailed = 0;            ///< Pliki nierozpoznane, nieczytelne lub z nieprawidłową zawartością.
+    int sensorsUpdated = 0;         ///< Czujniki, których seria w cache została uzupełniona.
+    int sensorsRejected = 0;        ///< Czujniki pominięte (inny parametr niż w cache, brak kodu parametru, błąd zapisu).
+    quint64 rowsSkipped = 0;        ///< Pominięte wiersze plików CSV.
+    quint64 pointsRead = 0;         ///< Pomiary odczytane z plików (bez wartości NaN).
+    quint64 pointsAdded = 0;        ///< Pomiary dopisane do cache (nowe daty lub uzupełnione wartości NaN).
+    quint64 duplicatesSkipped = 0;  ///< Pomiary pominięte, bo dla tej daty cache ma już wartość.
+    int indicesAdded = 0;           ///< Indeksy AQI dopisane do historii.
+    int metadataSaved = 0;          ///< Zapisane listy stacji i czujników (tylko gdy brak ich w cache).
+    int threadCount = 0;            ///< Liczba wątków użytych do importu.
+    qint64 elapsedMs = 0;           ///< Czas importu w milisekundach.
+};
+
+/**
+ * @class ArchiveImporter
+ * @brief Wczytuje archiwalne dane do DataStorage - bez odpytywania API, np. do jednorazowego uzupełnienia historii.
+ *
+ * Obsługiwane pliki:
+ * - zapisane odpowiedzi API (*.json) w katalogach odpowiadających ścieżkom zapytań: "station/findAll*.json",
+ *   "station/sensors/{ID}[_*].json", "data/getData/{ID}[_*].json" i "aqindex/getIndex/{ID}[_*].json"
+ *   (przyrostek po "_", np. data zapisu, pozwala trzymać wiele odpowiedzi dla jednego ID);
+ * - pliki CSV z pomiarami w układzie długim lub szerokim (CsvArchiveLayout), np. z DataStorage::exportSensorSeries().
+ *
+ * Wszystkie pliki są parsowane przez DataParser. Pomiary są scalane z serią czujnika w cache: dla daty, która ma już
+ * wartość, zostaje wartość zapisana wcześniej (import nie nadpisuje danych, uzupełnia tylko brakujące daty i wartości
+ * NaN). Indeksy AQI trafiają do AqiHistoryStore (bez duplikatów stCalcDate), a listy stacji i czujników są zapisywane
+ * tylko wtedy, gdy cache ich nie ma. Uzupełnione serie są chronione przed porządkowaniem cache
+ * (DataStorage::setSeriesRetained()).
+ *
+ * Zadania (plik CSV, odpowiedzi jednego czujnika lub jednej stacji) są wykonywane równolegle we własnej puli wątków.
+ * Pliki CSV są czytane fragmentami, a pomiary zapisywane partiami (MaxPendingPoints), więc zużycie pamięci nie zależy
+ * od wielkości archiwum. Metody są blokujące - z GUI należy wywoływać je w tle (np. QtConcurrent::run).
+ */
+class ArchiveImporter
+{
+public:
+    /// Rodzaj zapisanej odpowiedzi API (rozpoznawany po ścieżce pliku).
+    enum class CaptureKind {
+        Unknown,      ///< Plik nie jest rozpoznaną odpowiedzią API.
+        Stations,     ///< Lista stacji.
+        Sensors,      ///< Lista czujników stacji.
+        Measurements, ///< Dane pomiarowe czujnika.
+        AqiIndex      ///< Indeks jakości powietrza stacji.
+    };
+
+    /// Rozmiar fragmentu pliku CSV wczytywanego naraz (w bajtach).
+    static constexpr qint64 CsvChunkBytes = 4 * 1024 * 1024;
+    /// Liczba zebranych pomiarów, po której zadanie zapisuje je do cache.
+    static constexpr std::size_t MaxPendingPoints = 1000000;
+
+    /**
+     * @brief Konstruktor.
+     * @param storage Magazyn danych, do którego importowane są dane (nie przejmuje własności).
+     */
+    explicit ArchiveImporter(DataStorage* storage);
+
+    ArchiveImporter(const ArchiveImporter&) = delete;
+    ArchiveImporter& operator=(const ArchiveImporter&) = delete;
+
+    /** @brief Ustawia maksymalną liczbę wątków importu (domyślnie liczba rdzeni). */
+    void setMaxThreadCount(int count);
+    /** @brief Zwraca maksymalną liczbę wątków importu. */
+    int maxThreadCount() const;
+
+    /**
+     * @brief Importuje podane pliki (*.json i *.csv).
+     * @return Statystyki importu.
+     */
+    ImportStats importFiles(const QStringList& filePaths);
+
+    /**
+     * @brief Importuje wszystkie pliki *.json i *.csv z katalogu i jego podkatalogów.
+     * @return Statystyki importu.
+     */
+    ImportStats importDirectory(const QString& directoryPath);
+
+    /**
+     * @brief Rozpoznaje zapisaną odpowiedź API po ścieżce pliku.
+     * @param filePath Ścieżka pliku.
+     * @param id Jeśli nie nullptr, otrzymuje ID stacji lub czujnika z nazwy pliku.
+     */
+    static CaptureKind captureKind(const QString& filePath, int* id = nullptr);
+
+private:
+    /// Jednostka pracy wykonywana w jednym wątku.
+    struct ImportTask {
+        CaptureKind kind = CaptureKind::Unknown; ///< Rodzaj odpowiedzi API (Unknown dla pliku CSV).
+        int id = -1;                             ///< ID czujnika lub stacji.
+        QStringList paths;                       ///< Pliki zadania (odpowiedzi jednego ID posortowane po nazwie).
+        qint64 size = 0;                         ///< Łączny rozmiar plików (większe zadania są uruchamiane pierwsze).
+    };
+
+    /// Stan wspólny zadań jednego importu.
+    struct ImportContext {
+        QMutex mutex;             ///< Chroni pola poniżej.
+        ImportStats stats;        ///< Statystyki importu.
+        QSet<int> updatedSensors; ///< Czujniki z uzupełnioną serią.
+    };
+
+    void runTask(const ImportTask& task, ImportContext& context);
+    void importCsvFile(const QString& path, ImportContext& context);
+    void importMeasurements(const ImportTask& task, ImportContext& context);
+    void importAirQualityIndices(const ImportTask& task, ImportContext& context);
+    void importMetadata(const ImportTask& task, ImportContext& context);
+    /// Zapisuje zebrane pomiary czujników do cache i czyści `pending`.
+    void flushPending(std::map<int, SensorData>& pending, ImportContext& context);
+    /// Scala pomiary czujnika z serią w cache (DataStorage::mergeSensorSeries(), bez nadpisywania wartości).
+    void mergeSensorData(int sensorId, SensorData imported, ImportContext& context);
+
+    DataStorage* m_storage; ///< Magazyn danych (nie jest własnością obiektu).
+    QThreadPool m_pool;     ///< Własna pula wątków (niezależna od globalnej).
+};
+
+#endif // ARCHIVEIMPORTER_H
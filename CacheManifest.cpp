@@ -0,0 +1,312 @@
+#include "CacheManifest.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+#include <array>
+
+namespace {
+
+/// Nazwy rodzajów danych w plikach katalogu (kolejność jak w CacheEntityType).
+const std::array<const char*, 8> TypeNames = {
+    "stations", "sensors", "sensorData", "sensorSeries", "aqi", "forecast", "alertRules", "other"
+};
+
+QString typeName(CacheEntityType type)
+{
+    return QString::fromLatin1(TypeNames[static_cast<std::size_t>(type)]);
+}
+
+CacheEntityType typeFromName(const QString& name)
+{
+    for (std::size_t i = 0; i < TypeNames.size(); ++i) {
+        if (name == QLatin1String(TypeNames[i])) {
+            return static_cast<CacheEntityType>(i);
+        }
+    }
+    return CacheEntityType::Other;
+}
+
+QJsonValue dateToJson(const QDateTime& date)
+{
+    return date.isValid() ? QJsonValue(date.toString(Qt::ISODateWithMs)) : QJsonValue();
+}
+
+QDateTime dateFromJson(const QJsonValue& value)
+{
+    return value.isString() ? QDateTime::fromString(value.toString(), Qt::ISODateWithMs) : QDateTime();
+}
+
+} // namespace
+
+CacheManifest::CacheManifest(const QString& storagePath) : m_storagePath(storagePath)
+{
+}
+
+QString CacheManifest::fileName()
+{
+    return QStringLiteral("cache_manifest.json");
+}
+
+QString CacheManifest::journalFileName()
+{
+    return QStringLiteral("cache_manifest.journal");
+}
+
+QString CacheManifest::filePath(const QString& name) const
+{
+    return m_storagePath + QDir::separator() + name;
+}
+
+bool CacheManifest::load()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_journalRecords = 0;
+
+    QFile snapshot(filePath(fileName()));
+    QFile journal(filePath(journalFileName()));
+    if (!snapshot.exists() && !journal.exists()) {
+        return false;
+    }
+
+    if (snapshot.exists()) {
+        if (!snapshot.open(QIODevice::ReadOnly)) {
+            qWarning() << "Couldn't open cache manifest:" << snapshot.fileName() << snapshot.errorString();
+            return false;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(snapshot.readAll());
+        const QJsonObject root = doc.object();
+        if (!doc.isObject() || root["version"].toInt() != FormatVersion) {
+            qWarning() << "Invalid cache manifest, ignoring:" << snapshot.fileName();
+            return false;
+        }
+        for (const QJsonValue& value : root["entries"].toArray()) {
+            std::optional<CacheEntry> entry = entryFromJson(value.toObject());
+            if (entry) {
+                m_entries.insert(entry->fileName, *entry);
+            }
+        }
+    }
+
+    bool damaged = false;
+    if (journal.open(QIODevice::ReadOnly)) {
+        while (!journal.atEnd()) {
+            const QByteArray line = journal.readLine().trimmed();
+            if (line.isEmpty()) {
+                continue;
+            }
+            const QJsonDocument doc = QJsonDocument::fromJson(line);
+            if (!doc.isObject()) {
+                qWarning() << "Skipping damaged cache manifest journal record in" << journal.fileName();
+                damaged = true;
+                continue;
+            }
+            applyRecord(doc.object());
+            m_journalRecords++;
+        }
+        journal.close();
+    }
+    if (damaged) {
+        // Uszkodzona (zwykle ucięta) linia nie może zostać na końcu dziennika - kolejny rekord zostałby do niej doklejony.
+        writeSnapshot();
+    }
+    qDebug() << "Cache manifest loaded:" << m_entries.size() << "entries," << m_journalRecords << "journal records";
+    return true;
+}
+
+void CacheManifest::update(const CacheEntry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(entry.fileName, entry);
+    appendRecord(entryToJson(entry));
+}
+
+void CacheManifest::remove(const QString& fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_entries.contains(fileName)) {
+        return;
+    }
+    m_entries.remove(fileName);
+    QJsonObject record;
+    record["file"] = fileName;
+    record["removed"] = true;
+    appendRecord(record);
+}
+
+bool CacheManifest::replaceAll(const std::vector<CacheEntry>& entries)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    for (const CacheEntry& entry : entries) {
+        m_entries.insert(entry.fileName, entry);
+    }
+    return writeSnapshot();
+}
+
+std::optional<CacheEntry> CacheManifest::entry(const QString& fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(fileName);
+    if (it == m_entries.constEnd()) {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+std::vector<CacheEntry> CacheManifest::entries() const
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<CacheEntry> result;
+    result.reserve(static_cast<std::size_t>(m_entries.size()));
+    for (const CacheEntry& entry : m_entries) {
+        result.push_back(entry);
+    }
+    std::sort(result.begin(), result.end(), [](const CacheEntry& a, const CacheEntry& b) {
+        return a.fileName < b.fileName;
+    });
+    return result;
+}
+
+std::vector<CacheEntry> CacheManifest::entries(CacheEntityType type) const
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<CacheEntry> result;
+    for (const CacheEntry& entry : m_entries) {
+        if (entry.type == type) {
+            result.push_back(entry);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const CacheEntry& a, const CacheEntry& b) {
+        return a.id != b.id ? a.id < b.id : a.fileName < b.fileName;
+    });
+    return result;
+}
+
+int CacheManifest::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+qint64 CacheManifest::totalSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 total = 0;
+    for (const CacheEntry& entry : m_entries) {
+        total += entry.size;
+    }
+    return total;
+}
+
+bool CacheManifest::compact()
+{
+    QMutexLocker locker(&m_mutex);
+    return writeSnapshot();
+}
+
+void CacheManifest::appendRecord(const QJsonObject& record)
+{
+    // Dziennik nie jest synchronizowany z dyskiem przy każdej zmianie: katalog jest indeksem, a utracony wpis
+    // oznacza tylko plik, którego nie widać w katalogu do następnego zapisu.
+    QFile journal(filePath(journalFileName()));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Couldn't append to cache manifest journal:" << journal.fileName() << journal.errorString();
+        return;
+    }
+    journal.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    journal.close();
+    m_journalRecords++;
+
+    if (m_journalRecords >= MinCompactRecords && m_journalRecords > m_entries.size()) {
+        writeSnapshot();
+    }
+}
+
+bool CacheManifest::writeSnapshot()
+{
+    std::vector<QString> names;
+    names.reserve(static_cast<std::size_t>(m_entries.size()));
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        names.push_back(it.key());
+    }
+    std::sort(names.begin(), names.end());
+
+    QJsonArray array;
+    for (const QString& name : names) {
+        array.append(entryToJson(m_entries.value(name)));
+    }
+    QJsonObject root;
+    root["version"] = FormatVersion;
+    root["entries"] = array;
+
+    QSaveFile file(filePath(fileName()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't open cache manifest for writing:" << file.fileName() << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Couldn't write cache manifest:" << file.fileName() << file.errorString();
+        return false;
+    }
+    // Migawka zawiera już wszystkie zmiany z dziennika; przerwanie przed usunięciem dziennika jest bezpieczne,
+    // bo ponowne odtworzenie rekordów daje ten sam stan.
+    QFile::remove(filePath(journalFileName()));
+    m_journalRecords = 0;
+    return true;
+}
+
+void CacheManifest::applyRecord(const QJsonObject& record)
+{
+    if (record["removed"].toBool(false)) {
+        m_entries.remove(record["file"].toString());
+        return;
+    }
+    std::optional<CacheEntry> entry = entryFromJson(record);
+    if (entry) {
+        m_entries.insert(entry->fileName, *entry);
+    }
+}
+
+QJsonObject CacheManifest::entryToJson(const CacheEntry& entry)
+{
+    QJsonObject obj;
+    obj["file"] = entry.fileName;
+    obj["type"] = typeName(entry.type);
+    obj["id"] = entry.id;
+    obj["size"] = static_cast<double>(entry.size);
+    obj["firstDate"] = dateToJson(entry.firstDate);
+    obj["lastDate"] = dateToJson(entry.lastDate);
+    obj["lastFetch"] = dateToJson(entry.lastFetch);
+    obj["formatVersion"] = entry.formatVersion;
+    obj["checksum"] = QString::number(entry.checksum, 16).rightJustified(8, '0');
+    if (entry.retained) {
+        obj["retained"] = true;
+    }
+    return obj;
+}
+
+std::optional<CacheEntry> CacheManifest::entryFromJson(const QJsonObject& obj)
+{
+    CacheEntry entry;
+    entry.fileName = obj["file"].toString();
+    if (entry.fileName.isEmpty()) {
+        return std::nullopt;
+    }
+    entry.type = typeFromName(obj["type"].toString());
+    entry.id = obj["id"].toInt(-1);
+    entry.size = static_cast<qint64>(obj["size"].toDouble(0.0));
+    entry.firstDate = dateFromJson(obj["firstDate"]);
+    entry.lastDate = dateFromJson(obj["lastDate"]);
+    entry.lastFetch = dateFromJson(obj["lastFetch"]);
+    entry.formatVersion = obj["formatVersion"].toInt(0);
+    entry.checksum = obj["checksum"].toString().toUInt(nullptr, 16);
+    entry.retained = obj["retained"].toBool(false);
+    return entry;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file CacheManifest.h
+ * @brief Definicja klasy CacheManifest - katalogu plików cache z metadanymi (rozmiar, zakres dat, suma kontrolna).
+ */
+#ifndef CACHEMANIFEST_H
+#define CACHEMANIFEST_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <optional>
+#include <vector>
+
+class QJsonObject;
+
+/**
+ * @enum CacheEntityType
+ * @brief Rodzaj danych zapisanych w pliku cache.
+ */
+enum class CacheEntityType {
+    Stations,        ///< Lista stacji.
+    Sensors,         ///< Lista czujników stacji.
+    SensorData,      ///< Dane pomiarowe czujnika w JSON (starszy format).
+    SensorSeries,    ///< Dane pomiarowe czujnika w formacie SeriesCodec.
+    AirQualityIndex, ///< Ostatni indeks AQI stacji.
+    ForecastState,   ///< Stan modelu prognozy czujnika.
+    AlertRules,      ///< Reguły alertów.
+    Other            ///< Plik nierozpoznany.
+};
+
+/**
+ * @struct CacheEntry
+ * @brief Metadane jednego pliku cache.
+ */
+struct CacheEntry {
+    QString fileName;                             ///< Nazwa pliku (względem katalogu przechowywania).
+    CacheEntityType type = CacheEntityType::Other; ///< Rodzaj danych.
+    int id = -1;                                  ///< ID czujnika lub stacji (-1 dla plików wspólnych).
+    qint64 size = 0;                              ///< Rozmiar pliku w bajtach.
+    QDateTime firstDate;                          ///< Najwcześniejszy pomiar (tylko serie; nieprawidłowy, jeśli nieznany).
+    QDateTime lastDate;                           ///< Najpóźniejszy pomiar (tylko serie; nieprawidłowy, jeśli nieznany).
+    QDateTime lastFetch;                          ///< Czas zapisu pliku.
+    int formatVersion = 0;                        ///< Wersja formatu zawartości.
+    quint32 checksum = 0;                         ///< CRC-32 zawartości (bez stopki).
+    bool retained = false;                        ///< Plik wyłączony z zasad przechowywania (np. zaimportowana historia).
+
+    bool operator==(const CacheEntry& other) const {
+        return fileName == other.fileName && type == other.type && id == other.id && size == other.size
+               && firstDate == other.firstDate && lastDate == other.lastDate && lastFetch == other.lastFetch
+               && formatVersion == other.formatVersion && checksum == other.checksum && retained == other.retained;
+    }
+    bool operator!=(const CacheEntry& other) const { return !(*this == other); }
+};
+
+/**
+ * @class CacheManifest
+ * @brief Katalog plików cache zapisanych przez DataStorage, przechowywany w jednym małym pliku.
+ *
+ * Zamiast sprawdzać system plików dla każdego ID, pytania "co mamy offline" (lista czujników z danymi, zakres dat,
+ * rozmiar cache) obsługuje odczyt katalogu przy starcie. Zmiany są zapisywane przyrostowo: każda aktualizacja lub
+ * usunięcie wpisu dopisuje jedną linię JSON do dziennika "cache_manifest.journal". Gdy dziennik urośnie (więcej linii
+ * niż wpisów, co najmniej MinCompactRecords), jest scalany z migawką "cache_manifest.json" (zapis atomowy) i czyszczony.
+ * Odczyt wczytuje migawkę i odtwarza dziennik; uszkodzona ostatnia linia (przerwany zapis) jest pomijana.
+ *
+ * Katalog jest indeksem - można go odbudować z plików (DataStorage robi to, gdy go nie ma). Metody są bezpieczne wątkowo.
+ */
+class CacheManifest
+{
+public:
+    /// Wersja formatu migawki i dziennika.
+    static constexpr int FormatVersion = 1;
+    /// Minimalna liczba linii dziennika, przy której jest on scalany z migawką.
+    static constexpr int MinCompactRecords = 256;
+
+    /**
+     * @brief Konstruktor (bez wczytywania).
+     * @param storagePath Katalog, w którym zapisywany jest katalog cache.
+     */
+    explicit CacheManifest(const QString& storagePath = ".");
+
+    CacheManifest(const CacheManifest&) = delete;
+    CacheManifest& operator=(const CacheManifest&) = delete;
+
+    /**
+     * @brief Wczytuje migawkę i odtwarza dziennik (zastępuje wpisy w pamięci).
+     * @return `false`, jeśli nie ma ani migawki, ani dziennika albo migawka jest nieprawidłowa.
+     */
+    bool load();
+
+    /** @brief Dodaje lub zastępuje wpis pliku `entry.fileName` i dopisuje zmianę do dziennika. */
+    void update(const CacheEntry& entry);
+    /** @brief Usuwa wpis pliku i dopisuje zmianę do dziennika (nic nie robi, jeśli wpisu nie ma). */
+    void remove(const QString& fileName);
+    /** @brief Zastępuje wszystkie wpisy (np. po odbudowie z plików) i zapisuje migawkę. */
+    bool replaceAll(const std::vector<CacheEntry>& entries);
+
+    /** @brief Wpis pliku; std::nullopt, jeśli pliku nie ma w katalogu. */
+    std::optional<CacheEntry> entry(const QString& fileName) const;
+    /** @brief Wszystkie wpisy, posortowane po nazwie pliku. */
+    std::vector<CacheEntry> entries() const;
+    /** @brief Wpisy danego rodzaju, posortowane po ID. */
+    std::vector<CacheEntry> entries(CacheEntityType type) const;
+    /** @brief Liczba wpisów. */
+    int size() const;
+    /** @brief Łączny rozmiar plików w bajtach. */
+    qint64 totalSize() const;
+
+    /** @brief Zapisuje migawkę ze wszystkimi wpisami i czyści dziennik. */
+    bool compact();
+
+    /// Nazwa pliku migawki ("cache_manifest.json").
+    static QString fileName();
+    /// Nazwa pliku dziennika zmian ("cache_manifest.journal").
+    static QString journalFileName();
+
+private:
+    /// Dopisuje rekord do dziennika; scala dziennik z migawką, gdy jest za długi. Wymaga zablokowanego m_mutex.
+    void appendRecord(const QJsonObject& record);
+    /// Zapisuje migawkę i usuwa dziennik. Wymaga zablokowanego m_mutex.
+    bool writeSnapshot();
+    /// Stosuje rekord dziennika do wpisów w pamięci.
+    void applyRecord(const QJsonObject& record);
+
+    static QJsonObject entryToJson(const CacheEntry& entry);
+    static std::optional<CacheEntry> entryFromJson(const QJsonObject& obj);
+
+    QString filePath(const QString& name) const;
+
+    QString m_storagePath;                  ///< Katalog przechowywania.
+    mutable QMutex m_mutex;                 ///< Chroni wpisy i pliki katalogu.
+    QHash<QString, CacheEntry> m_entries;   ///< Nazwa pliku -> wpis.
+    int m_journalRecords = 0;               ///< Liczba linii w dzienniku.
+};
+
+#endif // CACHEMANIFEST_H
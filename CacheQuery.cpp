@@ -0,0 +1,238 @@
+#include "CacheQuery.h"
+#include "CacheManifest.h"
+#include "DataStorage.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+bool matchesAny(const QStringList& accepted, const QString& value)
+{
+    if (accepted.isEmpty()) {
+        return true;
+    }
+    for (const QString& candidate : accepted) {
+        if (candidate.compare(value, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Czy zakres dat serii [first, last] nie ma części wspólnej z przedziałem [from, to).
+bool outsideRange(const CacheEntry& entry, const QDateTime& from, const QDateTime& to)
+{
+    if (!entry.firstDate.isValid() || !entry.lastDate.isValid()) {
+        return false; // zakres nieznany - plik trzeba wczytać
+    }
+    return (from.isValid() && entry.lastDate < from) || (to.isValid() && entry.firstDate >= to);
+}
+
+/// Usuwa pomiary nieprawidłowe i spoza przedziału [from, to) i sortuje pozostałe po dacie.
+void keepMatching(std::vector<MeasurementValue>& values, const QDateTime& from, const QDateTime& to)
+{
+    values.erase(std::remove_if(values.begin(), values.end(), [&](const MeasurementValue& mv) {
+        return !mv.date.isValid() || std::isnan(mv.value) || (from.isValid() && mv.date < from)
+               || (to.isValid() && mv.date >= to);
+    }), values.end());
+    std::sort(values.begin(), values.end(), [](const MeasurementValue& a, const MeasurementValue& b) {
+        return a.date < b.date;
+    });
+}
+
+} // namespace
+
+CacheQuery::CacheQuery(DataStorage* storage) : m_storage(storage)
+{
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+void CacheQuery::setMaxThreadCount(int count)
+{
+    m_pool.setMaxThreadCount(std::max(1, count));
+}
+
+int CacheQuery::maxThreadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+std::vector<CacheQuery::Candidate> CacheQuery::plan(const CacheQueryFilter& filter, QueryStats& stats)
+{
+    const bool filtersStations = !filter.provinces.isEmpty() || !filter.cities.isEmpty();
+
+    QHash<int, MeasuringStation> stations;
+    for (const MeasuringStation& station : m_storage->loadStationsFromJson()) {
+        if (matchesAny(filter.provinces, station.city.commune.provinceName) && matchesAny(filter.cities, station.city.name)) {
+            stations.insert(station.id, station);
+        }
+    }
+
+    // Listy czujników są wczytywane tylko dla stacji spełniających warunki (bez warunków - dla wszystkich).
+    std::vector<int> stationIds = m_storage->cachedSensorsStationIds();
+    if (filtersStations) {
+        stationIds.erase(std::remove_if(stationIds.begin(), stationIds.end(), [&stations](int id) {
+            return !stations.contains(id);
+        }), stationIds.end());
+    }
+    DataStorage* storage = m_storage;
+    const QList<std::vector<Sensor>> sensorLists = QtConcurrent::blockingMapped<QList<std::vector<Sensor>>>(
+        &m_pool, stationIds, [storage](int stationId) { return storage->loadSensorsFromJson(stationId); });
+
+    QHash<int, QuerySensor> metadata;
+    for (const std::vector<Sensor>& sensors : sensorLists) {
+        for (const Sensor& sensor : sensors) {
+            QuerySensor meta;
+            meta.sensorId = sensor.id;
+            meta.stationId = sensor.stationId;
+            meta.paramCode = sensor.param.paramCode;
+            auto station = stations.constFind(sensor.stationId);
+            if (station != stations.constEnd()) {
+                meta.stationName = station->stationName;
+                meta.cityName = station->city.name;
+                meta.provinceName = station->city.commune.provinceName;
+            } else if (filtersStations) {
+                continue; // lista czujników nie zgadza się z listą stacji
+            }
+            metadata.insert(sensor.id, meta);
+        }
+    }
+
+    // Serie z katalogu cache mają zakres dat, więc czujniki spoza przedziału odpadają bez czytania pliku.
+    const CacheManifest& manifest = m_storage->cacheManifest();
+    QHash<int, Candidate> candidates;
+    QSet<int> seen;
+    auto addCandidate = [&](const CacheEntry& entry, bool isSeries) {
+        if (seen.contains(entry.id)) {
+            return; // seria ma pierwszeństwo przed starszym plikiem JSON (jak w DataStorage::loadCachedSensorData)
+        }
+        seen.insert(entry.id);
+        Candidate candidate;
+        candidate.isSeries = isSeries;
+        auto meta = metadata.constFind(entry.id);
+        if (meta != metadata.constEnd()) {
+            candidate.sensor = *meta;
+            if (!candidate.sensor.paramCode.isEmpty() && !matchesAny(filter.paramCodes, candidate.sensor.paramCode)) {
+                return;
+            }
+        } else if (filtersStations) {
+            return;
+        }
+        candidate.sensor.sensorId = entry.id;
+        if (isSeries && outsideRange(entry, filter.from, filter.to)) {
+            stats.sensorsPruned++;
+            return;
+        }
+        candidates.insert(entry.id, candidate);
+    };
+    for (const CacheEntry& entry : manifest.entries(CacheEntityType::SensorSeries)) {
+        addCandidate(entry, true);
+    }
+    for (const CacheEntry& entry : manifest.entries(CacheEntityType::SensorData)) {
+        addCandidate(entry, false);
+    }
+
+    std::vector<Candidate> result;
+    result.reserve(static_cast<std::size_t>(candidates.size()));
+    for (const Candidate& candidate : candidates) {
+        result.push_back(candidate);
+    }
+    std::sort(result.begin(), result.end(), [](const Candidate& a, const Candidate& b) {
+        return a.sensor.sensorId < b.sensor.sensorId;
+    });
+    return result;
+}
+
+QueryStats CacheQuery::stream(const CacheQueryFilter& filter, const Callback& callback)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QueryStats stats;
+    stats.threadCount = m_pool.maxThreadCount();
+    std::vector<Candidate> candidates = plan(filter, stats);
+
+    DataStorage* storage = m_storage;
+    QMutex mutex; // chroni stats i serializuje wywołania callback
+    std::atomic<bool> stopped{false};
+    auto querySensor = [&](const Candidate& candidate) {
+        if (stopped.load()) {
+            return;
+        }
+        const int sensorId = candidate.sensor.sensorId;
+        SensorData data = candidate.isSeries ? storage->loadSensorSeries(sensorId, filter.from, filter.to)
+                                             : storage->loadSensorDataFromJson(DataStorage::sensorDataFileName(sensorId));
+        QuerySensor sensor = candidate.sensor;
+        if (sensor.paramCode.isEmpty()) {
+            sensor.paramCode = data.key;
+        }
+        const bool loaded = !data.key.isEmpty();
+        if (loaded && matchesAny(filter.paramCodes, sensor.paramCode)) {
+            keepMatching(data.values, filter.from, filter.to);
+        } else {
+            data.values.clear();
+        }
+        sensor.count = data.values.size();
+
+        QMutexLocker locker(&mutex);
+        stats.sensorsRead++;
+        if (!loaded) {
+            stats.failedCount++;
+            return;
+        }
+        if (data.values.empty() || stopped.load()) {
+            return;
+        }
+        stats.sensorsMatched++;
+        stats.pointCount += data.values.size();
+        if (!callback(sensor, data.values)) {
+            stopped.store(true);
+        }
+    };
+    QtConcurrent::blockingMap(&m_pool, candidates, querySensor);
+
+    stats.elapsedMs = timer.elapsed();
+    qInfo() << "Zapytanie do cache zakończone:" << stats.sensorsMatched << "czujników," << stats.pointCount << "pomiarów,"
+            << stats.sensorsRead << "wczytanych plików," << stats.sensorsPruned << "pominiętych," << stats.failedCount
+            << "błędów," << stats.elapsedMs << "ms";
+    return stats;
+}
+
+QueryResult CacheQuery::collect(const CacheQueryFilter& filter)
+{
+    std::vector<std::pair<QuerySensor, std::vector<MeasurementValue>>> parts;
+    QueryResult result;
+    result.stats = stream(filter, [&parts](const QuerySensor& sensor, const std::vector<MeasurementValue>& values) {
+        parts.emplace_back(sensor, values);
+        return true;
+    });
+    std::sort(parts.begin(), parts.end(), [](const auto& a, const auto& b) {
+        return a.first.sensorId < b.first.sensorId;
+    });
+
+    const std::size_t total = static_cast<std::size_t>(result.stats.pointCount);
+    result.sensorIds.reserve(total);
+    result.timestamps.reserve(total);
+    result.values.reserve(total);
+    result.sensors.reserve(parts.size());
+    for (auto& part : parts) {
+        QuerySensor& sensor = part.first;
+        sensor.offset = result.values.size();
+        for (const MeasurementValue& mv : part.second) {
+            result.sensorIds.push_back(sensor.sensorId);
+            result.timestamps.push_back(mv.date.toMSecsSinceEpoch());
+            result.values.push_back(mv.value);
+        }
+        result.sensors.push_back(std::move(sensor));
+        std::vector<MeasurementValue>().swap(part.second); // zwalnia pamięć fragmentu od razu po skopiowaniu
+    }
+    return result;
+}
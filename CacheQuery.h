@@ -0,0 +1,142 @@
+/**
+ * @file CacheQuery.h
+ * @brief Definicja klasy CacheQuery - zapytań o pomiary zapisane w DataStorage (województwo, miasto, parametr, zakres dat).
+ */
+#ifndef CACHEQUERY_H
+#define CACHEQUERY_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+#include <vector>
+#include "DataStructures.h"
+
+class DataStorage;
+
+/**
+ * @struct CacheQueryFilter
+ * @brief Warunki zapytania. Puste listy i nieprawidłowe daty nie ograniczają wyniku.
+ *
+ * Nazwy są porównywane bez rozróżniania wielkości liter. Warunki na województwo i miasto wymagają zapisanej listy
+ * stacji i listy czujników stacji - czujniki bez tych metadanych są wtedy pomijane.
+ */
+struct CacheQueryFilter {
+    QStringList provinces;  ///< Województwa (np. "MAŁOPOLSKIE").
+    QStringList cities;     ///< Miejscowości stacji (np. "Kraków").
+    QStringList paramCodes; ///< Kody parametrów (np. "PM10"); dla czujników bez metadanych porównywany jest klucz danych.
+    QDateTime from;         ///< Początek przedziału dat (włącznie).
+    QDateTime to;           ///< Koniec przedziału dat (wyłącznie).
+};
+
+/**
+ * @struct QuerySensor
+ * @brief Czujnik w wyniku zapytania wraz z metadanymi stacji.
+ */
+struct QuerySensor {
+    int sensorId = -1;      ///< ID czujnika.
+    int stationId = -1;     ///< ID stacji (-1, jeśli brak zapisanej listy czujników stacji).
+    QString stationName;    ///< Nazwa stacji (pusta, jeśli nieznana).
+    QString cityName;       ///< Miejscowość (pusta, jeśli nieznana).
+    QString provinceName;   ///< Województwo (puste, jeśli nieznane).
+    QString paramCode;      ///< Kod parametru (z listy czujników, a gdy jej brak - klucz danych).
+    std::size_t offset = 0; ///< Indeks pierwszego pomiaru czujnika w kolumnach QueryResult (0 w wywołaniach zwrotnych).
+    std::size_t count = 0;  ///< Liczba pomiarów czujnika w wyniku.
+};
+
+/**
+ * @struct QueryStats
+ * @brief Statystyki wykonania zapytania.
+ */
+struct QueryStats {
+    int sensorsMatched = 0;  ///< Czujniki z co najmniej jednym pasującym pomiarem.
+    int sensorsRead = 0;     ///< Czujniki, których pliki zostały wczytane.
+    int sensorsPruned = 0;   ///< Czujniki pominięte bez czytania pliku (zakres dat z katalogu cache poza przedziałem).
+    int failedCount = 0;     ///< Czujniki, których danych nie udało się wczytać.
+    quint64 pointCount = 0;  ///< Liczba zwróconych pomiarów.
+    int threadCount = 0;     ///< Liczba wątków użytych do zapytania.
+    qint64 elapsedMs = 0;    ///< Czas wykonania w milisekundach.
+};
+
+/**
+ * @struct QueryResult
+ * @brief Wynik zapytania w układzie kolumnowym: i-ty pomiar to (sensorIds[i], timestamps[i], values[i]).
+ *
+ * Pomiary są pogrupowane po czujnikach (rosnąco po ID), a w obrębie czujnika posortowane po dacie;
+ * sensors[k].offset i sensors[k].count wskazują fragment kolumn należący do czujnika.
+ */
+struct QueryResult {
+    std::vector<QuerySensor> sensors; ///< Czujniki z pasującymi pomiarami, posortowane po ID.
+    std::vector<int> sensorIds;       ///< ID czujnika każdego pomiaru.
+    std::vector<qint64> timestamps;   ///< Data pomiaru w milisekundach od epoki.
+    std::vector<double> values;       ///< Wartość pomiaru.
+    QueryStats stats;                 ///< Statystyki wykonania.
+};
+
+/**
+ * @class CacheQuery
+ * @brief Wykonuje zapytania o pomiary wszystkich czujników zapisanych w DataStorage.
+ *
+ * Zapytanie przebiega w trzech krokach:
+ * 1. Warunki na województwo, miasto i parametr są sprawdzane na zapisanej liście stacji i listach czujników stacji,
+ *    więc listy czujników są wczytywane tylko dla pasujących stacji.
+ * 2. Czujniki, których seria w katalogu cache (CacheManifest) leży w całości poza przedziałem dat, są pomijane bez
+ *    otwierania pliku.
+ * 3. Pozostałe serie są wczytywane równolegle (własna pula wątków); SeriesCodec dekoduje tylko bloki nachodzące
+ *    na przedział dat. Starsze pliki JSON są wczytywane w całości i filtrowane.
+ *
+ * Zwracane są tylko prawidłowe pomiary (z poprawną datą, bez NaN). Metody są blokujące - z GUI należy wywoływać
+ * je w tle (np. QtConcurrent::run).
+ */
+class CacheQuery
+{
+public:
+    /**
+     * @brief Funkcja wywoływana z pasującymi pomiarami jednego czujnika (posortowanymi po dacie).
+     *
+     * Jest wywoływana z wątków roboczych, ale nigdy równolegle; kolejność czujników jest dowolna.
+     * Zwrócenie `false` przerywa zapytanie (czujniki w trakcie wczytywania nie są już przekazywane).
+     */
+    using Callback = std::function<bool(const QuerySensor& sensor, const std::vector<MeasurementValue>& values)>;
+
+    /**
+     * @brief Konstruktor.
+     * @param storage Magazyn danych, z którego wczytywane są dane (nie przejmuje własności).
+     */
+    explicit CacheQuery(DataStorage* storage);
+
+    CacheQuery(const CacheQuery&) = delete;
+    CacheQuery& operator=(const CacheQuery&) = delete;
+
+    /** @brief Ustawia maksymalną liczbę wątków zapytania (domyślnie liczba rdzeni). */
+    void setMaxThreadCount(int count);
+    /** @brief Zwraca maksymalną liczbę wątków zapytania. */
+    int maxThreadCount() const;
+
+    /**
+     * @brief Przekazuje pasujące pomiary kolejnych czujników do `callback` bez gromadzenia całego wyniku.
+     * @return Statystyki wykonania.
+     */
+    QueryStats stream(const CacheQueryFilter& filter, const Callback& callback);
+
+    /**
+     * @brief Wykonuje zapytanie i zwraca wszystkie pasujące pomiary w układzie kolumnowym.
+     */
+    QueryResult collect(const CacheQueryFilter& filter);
+
+private:
+    /// Czujnik do wczytania wraz ze sposobem odczytu.
+    struct Candidate {
+        QuerySensor sensor;
+        bool isSeries = false; ///< Czy dane są w pliku SeriesCodec (w przeciwnym razie starszy JSON).
+    };
+
+    /// Wybiera czujniki pasujące do warunków na metadane i zakres dat z katalogu cache.
+    std::vector<Candidate> plan(const CacheQueryFilter& filter, QueryStats& stats);
+
+    DataStorage* m_storage; ///< Magazyn danych (nie jest własnością obiektu).
+    QThreadPool m_pool;     ///< Własna pula wątków (niezależna od globalnej).
+};
+
+#endif // CACHEQUERY_H
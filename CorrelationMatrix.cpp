@@ -0,0 +1,223 @@
+#include "CorrelationMatrix.h"
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t TileSize = 32;     ///< Liczba serii w bloku (wiersze i kolumny).
+constexpr std::size_t ChunkLength = 256; ///< Liczba kroków czasu przetwarzanych naraz (wielokrotność Lanes).
+constexpr std::size_t Lanes = 4;         ///< Niezależne akumulatory (pozwalają kompilatorowi wektoryzować pętlę).
+
+/**
+ * Serie przygotowane do obliczeń: wyśrodkowane wartości x (0 dla braków), ich kwadraty q i maska m (1 - jest wartość).
+ * Każda seria zajmuje `length` elementów (długość dopełniona zerami do wielokrotności Lanes).
+ */
+struct PreparedSeries {
+    std::size_t count = 0;
+    std::size_t length = 0;
+    std::vector<double> x;
+    std::vector<double> q;
+    std::vector<double> m;
+};
+
+/// Sumy dla pary serii po wspólnych krokach.
+struct PairSums {
+    double n = 0.0;
+    double sx = 0.0;
+    double sy = 0.0;
+    double sxx = 0.0;
+    double syy = 0.0;
+    double sxy = 0.0;
+};
+
+/// Zastępuje wartości (poza NaN) ich rangami 1..k; równe wartości dostają średnią rangę.
+void replaceWithRanks(std::vector<double>& values)
+{
+    std::vector<std::size_t> order;
+    order.reserve(values.size());
+    for (std::size_t t = 0; t < values.size(); ++t) {
+        if (!std::isnan(values[t])) {
+            order.push_back(t);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&values](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+
+    for (std::size_t first = 0; first < order.size();) {
+        std::size_t last = first + 1;
+        while (last < order.size() && values[order[last]] == values[order[first]]) {
+            ++last;
+        }
+        const double rank = 0.5 * static_cast<double>(first + 1 + last); // średnia z rang first+1 .. last
+        for (std::size_t k = first; k < last; ++k) {
+            values[order[k]] = rank;
+        }
+        first = last;
+    }
+}
+
+/// Przygotowuje i-tą serię: (rangi), wyśrodkowanie średnią, rozdzielenie na x, q i m.
+void prepareSeries(const std::vector<double>& source, CorrelationMethod method, std::size_t index, PreparedSeries& out)
+{
+    std::vector<double> values = source;
+    if (method == CorrelationMethod::Spearman) {
+        replaceWithRanks(values);
+    }
+
+    // Wyśrodkowanie ogranicza utratę precyzji przy odejmowaniu Σx·Σy/n od Σxy (np. CO rzędu tysięcy µg/m³)
+    double sum = 0.0;
+    std::size_t valid = 0;
+    for (double v : values) {
+        if (!std::isnan(v)) {
+            sum += v;
+            ++valid;
+        }
+    }
+    const double mean = valid > 0 ? sum / static_cast<double>(valid) : 0.0;
+
+    double* x = out.x.data() + index * out.length;
+    double* q = out.q.data() + index * out.length;
+    double* m = out.m.data() + index * out.length;
+    for (std::size_t t = 0; t < values.size(); ++t) {
+        if (!std::isnan(values[t])) {
+            const double centered = values[t] - mean;
+            x[t] = centered;
+            q[t] = centered * centered;
+            m[t] = 1.0;
+        }
+    }
+}
+
+/// Zamienia sumy pary na współczynnik korelacji (NaN, gdy za mało danych lub zerowa wariancja).
+double coefficientFromSums(const PairSums& s, int minPairs)
+{
+    if (s.n < std::max(2, minPairs)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double varX = s.sxx - s.sx * s.sx / s.n;
+    const double varY = s.syy - s.sy * s.sy / s.n;
+    // Stała seria (również stała tylko na wspólnych krokach) daje wariancję będącą błędem zaokrągleń
+    if (varX <= 1e-12 * s.sxx || varY <= 1e-12 * s.syy) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double r = (s.sxy - s.sx * s.sy / s.n) / std::sqrt(varX * varY);
+    return std::clamp(r, -1.0, 1.0);
+}
+
+/// Oblicza blok macierzy: wiersze [i0, i0 + TileSize), kolumny [j0, j0 + TileSize), tylko j >= i.
+void computeTile(const PreparedSeries& data, std::size_t i0, std::size_t j0, int minPairs, CorrelationMatrix& out)
+{
+    const std::size_t i1 = std::min(i0 + TileSize, data.count);
+    const std::size_t j1 = std::min(j0 + TileSize, data.count);
+    std::vector<PairSums> sums(TileSize * TileSize);
+
+    for (std::size_t t0 = 0; t0 < data.length; t0 += ChunkLength) {
+        const std::size_t t1 = std::min(t0 + ChunkLength, data.length);
+        for (std::size_t i = i0; i < i1; ++i) {
+            const double* xi = data.x.data() + i * data.length;
+            const double* qi = data.q.data() + i * data.length;
+            const double* mi = data.m.data() + i * data.length;
+            for (std::size_t j = std::max(i, j0); j < j1; ++j) {
+                const double* xj = data.x.data() + j * data.length;
+                const double* qj = data.q.data() + j * data.length;
+                const double* mj = data.m.data() + j * data.length;
+
+                double n[Lanes] = {}, sx[Lanes] = {}, sy[Lanes] = {}, sxx[Lanes] = {}, syy[Lanes] = {}, sxy[Lanes] = {};
+                for (std::size_t t = t0; t < t1; t += Lanes) {
+                    for (std::size_t l = 0; l < Lanes; ++l) {
+                        n[l] += mi[t + l] * mj[t + l];
+                        sx[l] += xi[t + l] * mj[t + l];
+                        sy[l] += mi[t + l] * xj[t + l];
+                        sxx[l] += qi[t + l] * mj[t + l];
+                        syy[l] += mi[t + l] * qj[t + l];
+                        sxy[l] += xi[t + l] * xj[t + l];
+                    }
+                }
+
+                PairSums& s = sums[(i - i0) * TileSize + (j - j0)];
+                for (std::size_t l = 0; l < Lanes; ++l) {
+                    s.n += n[l];
+                    s.sx += sx[l];
+                    s.sy += sy[l];
+                    s.sxx += sxx[l];
+                    s.syy += syy[l];
+                    s.sxy += sxy[l];
+                }
+            }
+        }
+    }
+
+    // Każdy blok zapisuje rozłączny zestaw pól (i, j) i (j, i), więc wątki nie potrzebują synchronizacji
+    for (std::size_t i = i0; i < i1; ++i) {
+        for (std::size_t j = std::max(i, j0); j < j1; ++j) {
+            const PairSums& s = sums[(i - i0) * TileSize + (j - j0)];
+            double r = coefficientFromSums(s, minPairs);
+            if (i == j && !std::isnan(r)) {
+                r = 1.0;
+            }
+            const int pairs = static_cast<int>(std::lround(s.n));
+            out.coefficients[i * out.size + j] = r;
+            out.coefficients[j * out.size + i] = r;
+            out.pairCounts[i * out.size + j] = pairs;
+            out.pairCounts[j * out.size + i] = pairs;
+        }
+    }
+}
+
+} // namespace
+
+CorrelationMatrix CorrelationMatrix::compute(const std::vector<std::vector<double>>& series, const CorrelationOptions& options)
+{
+    CorrelationMatrix result;
+    if (series.empty()) {
+        return result;
+    }
+    const std::size_t steps = series.front().size();
+    for (const std::vector<double>& s : series) {
+        if (s.size() != steps) {
+            return result;
+        }
+    }
+
+    QThreadPool localPool;
+    QThreadPool* pool = QThreadPool::globalInstance();
+    if (options.maxThreadCount > 0) {
+        localPool.setMaxThreadCount(options.maxThreadCount);
+        pool = &localPool;
+    }
+
+    PreparedSeries data;
+    data.count = series.size();
+    data.length = (steps + Lanes - 1) / Lanes * Lanes;
+    data.x.assign(data.count * data.length, 0.0);
+    data.q.assign(data.count * data.length, 0.0);
+    data.m.assign(data.count * data.length, 0.0);
+
+    std::vector<std::size_t> indices(data.count);
+    std::iota(indices.begin(), indices.end(), std::size_t(0));
+    QtConcurrent::blockingMap(pool, indices, [&series, &options, &data](std::size_t index) {
+        prepareSeries(series[index], options.method, index, data);
+    });
+
+    result.size = data.count;
+    result.coefficients.assign(data.count * data.count, std::numeric_limits<double>::quiet_NaN());
+    result.pairCounts.assign(data.count * data.count, 0);
+
+    // Bloki górnego trójkąta (wraz z przekątną)
+    std::vector<std::pair<std::size_t, std::size_t>> tiles;
+    for (std::size_t i0 = 0; i0 < data.count; i0 += TileSize) {
+        for (std::size_t j0 = i0; j0 < data.count; j0 += TileSize) {
+            tiles.emplace_back(i0, j0);
+        }
+    }
+    const int minPairs = options.minPairs;
+    QtConcurrent::blockingMap(pool, tiles, [&data, minPairs, &result](const std::pair<std::size_t, std::size_t>& tile) {
+        computeTile(data, tile.first, tile.second, minPairs, result);
+    });
+    return result;
+}
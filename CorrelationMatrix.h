@@ -0,0 +1,64 @@
+/**
+ * @file CorrelationMatrix.h
+ * @brief Definicja struktury CorrelationMatrix - macierzy korelacji wielu serii z obsługą brakujących wartości.
+ */
+#ifndef CORRELATIONMATRIX_H
+#define CORRELATIONMATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @enum CorrelationMethod
+ * @brief Rodzaj współczynnika korelacji.
+ */
+enum class CorrelationMethod {
+    Pearson, ///< Korelacja liniowa Pearsona.
+    Spearman ///< Korelacja rang Spearmana (odporna na wartości odstające i zależności nieliniowe monotoniczne).
+};
+
+/**
+ * @struct CorrelationOptions
+ * @brief Opcje obliczania macierzy korelacji.
+ */
+struct CorrelationOptions {
+    CorrelationMethod method = CorrelationMethod::Pearson; ///< Rodzaj współczynnika.
+    int minPairs = 3;        ///< Minimalna liczba wspólnych (obie wartości dostępne) kroków pary; poniżej - NaN.
+    int maxThreadCount = 0;  ///< Maksymalna liczba wątków (0 - globalna pula wątków Qt).
+};
+
+/**
+ * @struct CorrelationMatrix
+ * @brief Symetryczna macierz współczynników korelacji n serii.
+ *
+ * Braki danych są obsługiwane parami: współczynnik pary (i, j) jest liczony tylko z kroków, w których obie serie
+ * mają wartość. Dla metody Spearmana rangi są wyznaczane raz dla każdej serii (ze wszystkich jej wartości),
+ * a nie osobno dla wspólnych kroków każdej pary - przy niewielkiej liczbie braków różnica jest pomijalna.
+ *
+ * Obliczenie (compute()) sprowadza się do iloczynów macierzy serii (sumy Σx, Σx², Σxy i liczności
+ * po maskach dostępności), liczonych blokami 32×32 serii i odcinkami po 256 kroków, tak aby dane bloku
+ * mieściły się w pamięci podręcznej; bloki są rozdzielane między wątki (QtConcurrent).
+ * Przykładowo 1500 serii × 720 godzin (miesiąc) wymaga ok. 5·10⁹ operacji mnożenia-dodawania.
+ */
+struct CorrelationMatrix {
+    std::size_t size = 0;              ///< Liczba serii n.
+    std::vector<double> coefficients;  ///< Współczynniki n×n (wierszami); NaN, gdy nieokreślone.
+    std::vector<int> pairCounts;       ///< Liczby wspólnych kroków par n×n (wierszami).
+
+    /** @brief Współczynnik korelacji serii i oraz j (NaN - za mało wspólnych danych lub stała seria). */
+    double at(std::size_t i, std::size_t j) const { return coefficients[i * size + j]; }
+    /** @brief Liczba kroków, w których obie serie mają wartość. */
+    int pairCount(std::size_t i, std::size_t j) const { return pairCounts[i * size + j]; }
+    /** @brief Czy macierz jest pusta. */
+    bool isEmpty() const { return size == 0; }
+
+    /**
+     * @brief Oblicza macierz korelacji serii o jednakowej długości.
+     * @param series Serie wartości wyrównane w czasie (i-ty element każdej serii to ta sama chwila); NaN oznacza brak.
+     * @param options Opcje obliczeń.
+     * @return Macierz; pusta, jeśli serie mają różne długości lub brak serii.
+     */
+    static CorrelationMatrix compute(const std::vector<std::vector<double>>& series, const CorrelationOptions& options = {});
+};
+
+#endif // CORRELATIONMATRIX_H
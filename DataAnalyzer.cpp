@@ -3,10 +3,21 @@
 #include <limits>
 #include <cmath>
 #include <algorithm>
+#include <deque>
 
 DataAnalyzer::DataAnalyzer() {}
 
 
+void DataAnalyzer::setOptions(const AnalyzerOptions& options) {
+    m_options = options;
+}
+
+
+AnalyzerOptions DataAnalyzer::options() const {
+    return m_options;
+}
+
+
 std::vector<MeasurementValue> DataAnalyzer::filterValidValues(const std::vector<MeasurementValue>& values) {
     std::vector<MeasurementValue> validValues;
     for (const auto& mv : values) {
@@ -43,8 +54,19 @@ AnalysisResult DataAnalyzer::analyze(const std::vector<MeasurementValue>& values
     }
     result.average = sum / validValues.size();
 
+    QuantileSketch sketch;
+    for (const auto& mv : validValues) {
+        sketch.add(mv.value);
+    }
+    std::vector<double> percentiles = sketch.quantiles({0.50, 0.90, 0.98});
+    result.p50 = percentiles[0];
+    result.p90 = percentiles[1];
+    result.p98 = percentiles[2];
+
 
-    if (validValues.size() >= 2) {
+    if (validValues.size() >= 2 && m_options.trendMethod == TrendMethod::TheilSen) {
+        applyRobustTrend(validValues, result);
+    } else if (validValues.size() >= 2) {
         double n = static_cast<double>(validValues.size());
         double sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0;
 
@@ -85,3 +107,278 @@ AnalysisResult DataAnalyzer::analyze(const std::vector<MeasurementValue>& values
 
     return result;
 }
+
+
+std::vector<MeasurementValue> DataAnalyzer::sortedValidValues(const std::vector<MeasurementValue>& values) {
+    std::vector<MeasurementValue> validValues = filterValidValues(values);
+
+    std::vector<qint64> times(validValues.size());
+    for (size_t i = 0; i < validValues.size(); ++i) {
+        times[i] = validValues[i].date.toMSecsSinceEpoch();
+    }
+
+    if (std::is_sorted(times.begin(), times.end())) {
+        return validValues;
+    }
+    if (std::is_sorted(times.rbegin(), times.rend())) {
+        std::reverse(validValues.begin(), validValues.end());
+        return validValues;
+    }
+
+    std::stable_sort(validValues.begin(), validValues.end(),
+                     [](const MeasurementValue& a, const MeasurementValue& b) {
+                         return a.date < b.date;
+                     });
+    return validValues;
+}
+
+
+std::vector<MeasurementValue> DataAnalyzer::rollingMean(const std::vector<MeasurementValue>& values,
+                                                        int windowHours, int minValidCount) {
+    std::vector<MeasurementValue> result;
+    if (windowHours <= 0) {
+        return result;
+    }
+
+    std::vector<MeasurementValue> validValues = sortedValidValues(values);
+    const size_t n = validValues.size();
+    const qint64 windowSecs = static_cast<qint64>(windowHours) * 3600;
+
+    std::vector<qint64> times(n);
+    std::vector<double> prefix(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        times[i] = validValues[i].date.toSecsSinceEpoch();
+        prefix[i + 1] = prefix[i] + validValues[i].value;
+    }
+
+    result.reserve(n);
+    size_t start = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (times[start] <= times[i] - windowSecs) {
+            ++start;
+        }
+        size_t count = i - start + 1;
+        if (static_cast<int>(count) >= minValidCount) {
+            MeasurementValue mv;
+            mv.date = validValues[i].date;
+            mv.value = (prefix[i + 1] - prefix[start]) / static_cast<double>(count);
+            result.push_back(mv);
+        }
+    }
+    return result;
+}
+
+
+std::vector<MeasurementValue> DataAnalyzer::rollingMax(const std::vector<MeasurementValue>& values, int windowHours) {
+    std::vector<MeasurementValue> result;
+    if (windowHours <= 0) {
+        return result;
+    }
+
+    std::vector<MeasurementValue> validValues = sortedValidValues(values);
+    const size_t n = validValues.size();
+    const qint64 windowSecs = static_cast<qint64>(windowHours) * 3600;
+
+    std::vector<qint64> times(n);
+    for (size_t i = 0; i < n; ++i) {
+        times[i] = validValues[i].date.toSecsSinceEpoch();
+    }
+
+    // Indeksy kandydatów na maksimum; wartości w kolejce są malejące.
+    std::deque<size_t> window;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        while (!window.empty() && validValues[window.back()].value <= validValues[i].value) {
+            window.pop_back();
+        }
+        window.push_back(i);
+        while (times[window.front()] <= times[i] - windowSecs) {
+            window.pop_front();
+        }
+
+        MeasurementValue mv;
+        mv.date = validValues[i].date;
+        mv.value = validValues[window.front()].value;
+        result.push_back(mv);
+    }
+    return result;
+}
+
+
+std::vector<MeasurementValue> DataAnalyzer::dailyAggregate(const std::vector<MeasurementValue>& values,
+                                                           bool useMax, int minValidCount) {
+    std::vector<MeasurementValue> result;
+    std::vector<MeasurementValue> validValues = sortedValidValues(values);
+
+    size_t i = 0;
+    while (i < validValues.size()) {
+        QDate day = validValues[i].date.date();
+        double sum = 0.0;
+        double maxValue = validValues[i].value;
+        int count = 0;
+        while (i < validValues.size() && validValues[i].date.date() == day) {
+            sum += validValues[i].value;
+            maxValue = std::max(maxValue, validValues[i].value);
+            ++count;
+            ++i;
+        }
+        if (count >= minValidCount) {
+            MeasurementValue mv;
+            mv.date = day.startOfDay();
+            mv.value = useMax ? maxValue : sum / count;
+            result.push_back(mv);
+        }
+    }
+    return result;
+}
+
+
+std::vector<MeasurementValue> DataAnalyzer::dailyMeans(const std::vector<MeasurementValue>& values, int minValidCount) {
+    return dailyAggregate(values, false, minValidCount);
+}
+
+
+std::vector<MeasurementValue> DataAnalyzer::dailyMaxima(const std::vector<MeasurementValue>& values) {
+    return dailyAggregate(values, true, 1);
+}
+
+
+int DataAnalyzer::countExceedances(const std::vector<MeasurementValue>& values, double threshold) {
+    int count = 0;
+    for (const auto& mv : values) {
+        if (!std::isnan(mv.value) && mv.value > threshold) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+CorrelationMatrix DataAnalyzer::correlationMatrix(const std::vector<ResampledSeries>& series,
+                                                const CorrelationOptions& options) const {
+    std::vector<std::vector<double>> columns;
+    columns.reserve(series.size());
+    for (const ResampledSeries& s : series) {
+        const ResampledSeries& first = series.front();
+        if (s.startMSecs != first.startMSecs || s.stepSecs != first.stepSecs || s.size() != first.size()) {
+            return CorrelationMatrix();
+        }
+        columns.push_back(s.values);
+    }
+    return CorrelationMatrix::compute(columns, options);
+}
+
+void DataAnalyzer::updateSeriesSketch(int seriesId, const std::vector<MeasurementValue>& values) {
+    SeriesSketch& entry = m_seriesSketches[seriesId];
+    const QDateTime previousLast = entry.lastDate;
+
+    for (const auto& mv : values) {
+        if (!mv.date.isValid() || std::isnan(mv.value)) {
+            continue;
+        }
+        if (previousLast.isValid() && mv.date <= previousLast) {
+            continue;
+        }
+        entry.sketch.add(mv.value);
+        if (!entry.lastDate.isValid() || mv.date > entry.lastDate) {
+            entry.lastDate = mv.date;
+        }
+    }
+}
+
+
+const QuantileSketch* DataAnalyzer::seriesSketch(int seriesId) const {
+    auto it = m_seriesSketches.find(seriesId);
+    return it == m_seriesSketches.end() ? nullptr : &it->second.sketch;
+}
+
+
+QuantileSketch DataAnalyzer::mergedSketch(const std::vector<int>& seriesIds) const {
+    QuantileSketch merged;
+    for (int seriesId : seriesIds) {
+        auto it = m_seriesSketches.find(seriesId);
+        if (it != m_seriesSketches.end()) {
+            merged.merge(it->second.sketch);
+        }
+    }
+    return merged;
+}
+
+
+void DataAnalyzer::removeSeriesSketch(int seriesId) {
+    m_seriesSketches.erase(seriesId);
+}
+
+
+void DataAnalyzer::clearSeriesSketches() {
+    m_seriesSketches.clear();
+}
+
+
+std::vector<Anomaly> DataAnalyzer::updateSeriesAnomalies(int seriesId, const std::vector<MeasurementValue>& values) {
+    auto it = m_seriesAnomalies.find(seriesId);
+    if (it == m_seriesAnomalies.end()) {
+        it = m_seriesAnomalies.emplace(seriesId, SeriesAnomalies{AnomalyDetector(m_options.anomalyDetection), QDateTime(), {}}).first;
+    }
+    SeriesAnomalies& entry = it->second;
+
+    // Detektor wymaga kolejności czasu; sprawdzane są tylko pomiary nowsze niż poprzednio
+    std::vector<Anomaly> fresh;
+    for (const MeasurementValue& mv : sortedValidValues(values)) {
+        if (entry.lastDate.isValid() && mv.date <= entry.lastDate) {
+            continue;
+        }
+        if (std::optional<Anomaly> anomaly = entry.detector.add(mv)) {
+            fresh.push_back(*anomaly);
+        }
+        entry.lastDate = mv.date;
+    }
+
+    entry.anomalies.insert(entry.anomalies.end(), fresh.begin(), fresh.end());
+    if (entry.anomalies.size() > MaxStoredAnomalies) {
+        entry.anomalies.erase(entry.anomalies.begin(),
+                              entry.anomalies.end() - static_cast<std::ptrdiff_t>(MaxStoredAnomalies));
+    }
+    return fresh;
+}
+
+std::vector<Anomaly> DataAnalyzer::seriesAnomalies(int seriesId) const {
+    auto it = m_seriesAnomalies.find(seriesId);
+    return it == m_seriesAnomalies.end() ? std::vector<Anomaly>() : it->second.anomalies;
+}
+
+void DataAnalyzer::clearSeriesAnomalies() {
+    m_seriesAnomalies.clear();
+}
+
+void DataAnalyzer::applyRobustTrend(const std::vector<MeasurementValue>& validValues, AnalysisResult& result) const {
+    std::vector<std::pair<qint64, double>> points;
+    points.reserve(validValues.size());
+    for (const auto& mv : validValues) {
+        points.emplace_back(mv.date.toSecsSinceEpoch(), mv.value);
+    }
+    std::stable_sort(points.begin(), points.end(),
+                     [](const std::pair<qint64, double>& a, const std::pair<qint64, double>& b) {
+                         return a.first < b.first;
+                     });
+
+    const qint64 firstTime = points.front().first;
+    std::vector<double> x(points.size());
+    std::vector<double> y(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        x[i] = static_cast<double>(points[i].first - firstTime);
+        y[i] = points[i].second;
+    }
+
+    result.trendSlope = TrendEstimator::theilSenSlope(x, y);
+    MannKendallResult mk = TrendEstimator::mannKendall(y);
+    result.trendPValue = mk.pValue;
+
+    if (mk.pValue < m_options.significanceLevel && result.trendSlope > 0.0) {
+        result.trend = AnalysisResult::INCREASING;
+    } else if (mk.pValue < m_options.significanceLevel && result.trendSlope < 0.0) {
+        result.trend = AnalysisResult::DECREASING;
+    } else {
+        result.trend = AnalysisResult::STABLE;
+    }
+}
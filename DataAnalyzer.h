@@ -7,14 +7,40 @@
 
 #include <vector>
 #include <optional> // Dla opcjonalnych wyników
+#include <map>
 #include "DataStructures.h" // Potrzebuje MeasurementValue
+#include "QuantileSketch.h"
+#include "TrendEstimator.h"
+#include "CorrelationMatrix.h"
+#include "TimeSeriesResampler.h"
+#include "AnomalyDetector.h"
+
+/**
+ * @enum TrendMethod
+ * @brief Metoda wyznaczania trendu w DataAnalyzer::analyze().
+ */
+enum class TrendMethod {
+    LeastSquares, ///< Regresja liniowa (metoda najmniejszych kwadratów) z progiem nachylenia 1e-5.
+    TheilSen      ///< Mediana nachyleń (Theil-Sen) z testem istotności Manna-Kendalla - odporna na piki.
+};
+
+/**
+ * @struct AnalyzerOptions
+ * @brief Opcje analizy danych w DataAnalyzer.
+ */
+struct AnalyzerOptions {
+    TrendMethod trendMethod = TrendMethod::LeastSquares; ///< Metoda wyznaczania trendu.
+    double significanceLevel = 0.05; ///< Poziom istotności testu Manna-Kendalla (tylko dla TheilSen).
+    AnomalyDetectorOptions anomalyDetection; ///< Progi detektorów anomalii tworzonych dla nowych serii.
+};
 
 /**
  * @struct AnalysisResult
  * @brief Przechowuje wyniki prostej analizy statystycznej serii danych pomiarowych.
  *
  * Zawiera opcjonalne wartości minimalną i maksymalną (wraz z datą), średnią,
- * oraz informacje o trendzie (rosnący, malejący, stabilny) obliczonym na podstawie regresji liniowej.
+ * oraz informacje o trendzie (rosnący, malejący, stabilny) obliczonym na podstawie regresji liniowej
+ * lub (zależnie od AnalyzerOptions) estymatora Theila-Sena.
  */
 struct AnalysisResult {
     /**
@@ -50,11 +76,25 @@ struct AnalysisResult {
     Trend trend = Trend::UNKNOWN;
 
     /**
-     * @brief Nachylenie linii trendu obliczone metodą regresji liniowej.
+     * @brief Nachylenie linii trendu obliczone metodą regresji liniowej lub Theila-Sena.
      * Wartość 0.0, jeśli trend jest UNKNOWN lub idealnie stabilny.
      * Czas jest traktowany jako oś X (w sekundach od pierwszego pomiaru), wartość jako oś Y.
      */
     double trendSlope = 0.0;
+
+    /**
+     * @brief Dwustronna wartość p testu Manna-Kendalla.
+     * Ustawiana tylko dla metody TrendMethod::TheilSen i co najmniej 2 prawidłowych punktów.
+     */
+    std::optional<double> trendPValue;
+
+    /**
+     * @brief Percentyle 50, 90 i 98 ważnych wartości (z szkicu kwantyli, błąd rangi poniżej ok. 1%).
+     * Są `std::nullopt`, jeśli wejściowe dane były puste lub zawierały tylko NaN.
+     */
+    std::optional<double> p50;
+    std::optional<double> p90; ///< Percentyl 90 (patrz p50).
+    std::optional<double> p98; ///< Percentyl 98 (patrz p50).
 };
 
 /**
@@ -72,22 +112,179 @@ public:
      */
     DataAnalyzer();
 
+    /** @brief Ustawia opcje analizy (m.in. metodę wyznaczania trendu). */
+    void setOptions(const AnalyzerOptions& options);
+    /** @brief Zwraca aktualne opcje analizy. */
+    AnalyzerOptions options() const;
+
     /**
      * @brief Analizuje podany wektor danych pomiarowych.
      * @param values Wektor obiektów MeasurementValue do analizy.
      * @return Obiekt AnalysisResult zawierający wyniki analizy (min, max, średnia, trend).
      * @note Wartości NaN oraz wpisy z nieprawidłową datą są ignorowane podczas obliczeń.
      *       Trend jest obliczany tylko jeśli dostępne są co najmniej 2 prawidłowe punkty danych.
+     *       Dla TrendMethod::TheilSen trend jest rosnący/malejący tylko wtedy, gdy test Manna-Kendalla
+     *       jest istotny na poziomie AnalyzerOptions::significanceLevel; w przeciwnym razie jest stabilny.
      */
     AnalysisResult analyze(const std::vector<MeasurementValue>& values);
 
+    // --- Statystyki w oknach kroczących ---
+    // Wszystkie metody ignorują wartości NaN i błędne daty, przyjmują dane w dowolnej kolejności
+    // (np. malejącej, jak zwraca API) i zwracają serie posortowane rosnąco po czasie. Koszt: O(n)
+    // dla danych już posortowanych (rosnąco lub malejąco), w przeciwnym razie O(n log n) na sortowanie.
+
+    /**
+     * @brief Oblicza średnią kroczącą w oknie czasowym kończącym się na każdym pomiarze.
+     * Okno dla pomiaru w chwili t obejmuje przedział (t - windowHours, t]. Używa sum prefiksowych.
+     * @param values Dane pomiarowe.
+     * @param windowHours Długość okna w godzinach (np. 8 dla O3, 24 dla PM10).
+     * @param minValidCount Minimalna liczba pomiarów w oknie, aby wynik był uznany za ważny
+     *                      (np. 6 dla okna 8h i 18 dla okna 24h - 75% kompletności). Domyślnie 1.
+     * @return Seria średnich; pomiary z niewystarczającą liczbą danych w oknie są pomijane.
+     */
+    std::vector<MeasurementValue> rollingMean(const std::vector<MeasurementValue>& values,
+                                              int windowHours, int minValidCount = 1);
+
+    /**
+     * @brief Oblicza maksimum kroczące w oknie czasowym (t - windowHours, t] przy użyciu kolejki monotonicznej.
+     * @param values Dane pomiarowe.
+     * @param windowHours Długość okna w godzinach.
+     * @return Seria maksimów, po jednej wartości dla każdego prawidłowego pomiaru.
+     */
+    std::vector<MeasurementValue> rollingMax(const std::vector<MeasurementValue>& values, int windowHours);
+
+    /**
+     * @brief Oblicza średnie dobowe (dla dni kalendarzowych czasu lokalnego).
+     * @param values Dane pomiarowe.
+     * @param minValidCount Minimalna liczba pomiarów w dobie (np. 18 dla PM10). Domyślnie 1.
+     * @return Seria średnich dobowych; data każdego punktu to początek doby.
+     */
+    std::vector<MeasurementValue> dailyMeans(const std::vector<MeasurementValue>& values, int minValidCount = 1);
+
+    /**
+     * @brief Oblicza maksima dobowe (dla dni kalendarzowych czasu lokalnego).
+     * Np. `dailyMaxima(rollingMean(o3, 8, 6))` daje maksymalną dobową średnią 8-godzinną ozonu.
+     * @param values Dane pomiarowe.
+     * @return Seria maksimów dobowych; data każdego punktu to początek doby.
+     */
+    std::vector<MeasurementValue> dailyMaxima(const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Zlicza wartości serii przekraczające próg (ściśle większe).
+     * Dla serii dobowych (dailyMeans/dailyMaxima) jest to liczba dni z przekroczeniem.
+     * @param values Seria do sprawdzenia.
+     * @param threshold Próg (np. 50 µg/m³ dla średniej dobowej PM10).
+     * @return Liczba przekroczeń.
+     */
+    int countExceedances(const std::vector<MeasurementValue>& values, double threshold);
+
+    // --- Korelacje między seriami ---
+
+    /**
+     * @brief Oblicza macierz korelacji serii wyrównanych do wspólnej siatki (np. wynik TimeSeriesResampler::align()).
+     * Pozwala wskazać zanieczyszczenia i stacje, których epizody występują jednocześnie.
+     * Braki (kroki z flagą Missing) są pomijane parami - patrz CorrelationMatrix.
+     * @param series Serie o tym samym początku, kroku i liczbie kroków.
+     * @param options Rodzaj korelacji, minimalna liczba wspólnych kroków, liczba wątków.
+     * @return Macierz korelacji w kolejności serii; pusta, jeśli serie nie są wyrównane.
+     */
+    CorrelationMatrix correlationMatrix(const std::vector<ResampledSeries>& series,
+                                        const CorrelationOptions& options = {}) const;
+
+    // --- Szkice kwantyli przypisane do serii ---
+
+    /**
+     * @brief Dopisuje do szkicu kwantyli serii pomiary nowsze niż ostatnio dopisane.
+     * Dane z API obejmują przesuwające się okno kilku dni, więc kolejne wywołania z pełną serią
+     * dopisują tylko nowe godziny - szkic obejmuje całą historię widzianą od utworzenia analizatora.
+     * @param seriesId Identyfikator serii (np. ID czujnika).
+     * @param values Aktualne dane serii (kolejność dowolna; NaN i błędne daty są pomijane).
+     */
+    void updateSeriesSketch(int seriesId, const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Zwraca szkic kwantyli serii.
+     * @return Wskaźnik do szkicu lub `nullptr`, jeśli seria nie ma szkicu. Ważny do kolejnej modyfikacji szkiców.
+     */
+    const QuantileSketch* seriesSketch(int seriesId) const;
+
+    /**
+     * @brief Łączy szkice wskazanych serii (np. wszystkich czujników PM10) w jeden szkic.
+     * @param seriesIds Identyfikatory serii; serie bez szkicu są pomijane.
+     * @return Połączony szkic (pusty, jeśli żadna seria nie ma szkicu).
+     */
+    QuantileSketch mergedSketch(const std::vector<int>& seriesIds) const;
+
+    /** @brief Usuwa szkic serii. */
+    void removeSeriesSketch(int seriesId);
+    /** @brief Usuwa szkice wszystkich serii. */
+    void clearSeriesSketches();
+
+    // --- Wykrywanie anomalii w napływających danych ---
+
+    /**
+     * @brief Sprawdza detektorem anomalii serii pomiary nowsze niż ostatnio sprawdzone.
+     * Detektor serii jest tworzony przy pierwszym wywołaniu z progami AnalyzerOptions::anomalyDetection.
+     * @param seriesId Identyfikator serii (np. ID czujnika).
+     * @param values Aktualne dane serii (kolejność dowolna; NaN i błędne daty są pomijane).
+     * @return Anomalie wykryte wśród nowych pomiarów, w kolejności czasu.
+     */
+    std::vector<Anomaly> updateSeriesAnomalies(int seriesId, const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Zwraca anomalie wykryte dotąd w serii (najwyżej MaxStoredAnomalies najnowszych).
+     * @return Anomalie w kolejności czasu; pusty wektor, jeśli seria nie była sprawdzana.
+     */
+    std::vector<Anomaly> seriesAnomalies(int seriesId) const;
+
+    /** @brief Usuwa detektory i anomalie wszystkich serii. */
+    void clearSeriesAnomalies();
+
+    /// Maksymalna liczba przechowywanych anomalii na serię (starsze są usuwane).
+    static constexpr std::size_t MaxStoredAnomalies = 1000;
+
 private:
+    /// Szkic kwantyli serii wraz z datą najnowszego dopisanego pomiaru.
+    struct SeriesSketch {
+        QuantileSketch sketch;
+        QDateTime lastDate;
+    };
+
+    /// Detektor anomalii serii wraz z datą najnowszego sprawdzonego pomiaru i wykrytymi anomaliami.
+    struct SeriesAnomalies {
+        AnomalyDetector detector;
+        QDateTime lastDate;
+        std::vector<Anomaly> anomalies;
+    };
+
+    std::map<int, SeriesSketch> m_seriesSketches; ///< Szkice kwantyli wg identyfikatora serii.
+    std::map<int, SeriesAnomalies> m_seriesAnomalies; ///< Detektory anomalii wg identyfikatora serii.
+    AnalyzerOptions m_options; ///< Opcje analizy.
+
+    /**
+     * @brief Wyznacza trend metodą Theila-Sena i jego istotność testem Manna-Kendalla.
+     * @param validValues Prawidłowe pomiary (co najmniej 2), w dowolnej kolejności.
+     * @param result Wynik, w którym ustawiane są trend, trendSlope i trendPValue.
+     */
+    void applyRobustTrend(const std::vector<MeasurementValue>& validValues, AnalysisResult& result) const;
+
     /**
      * @brief Filtruje wejściowy wektor danych, zwracając tylko te pomiary, które mają prawidłową datę i wartość niebędącą NaN.
      * @param values Oryginalny wektor danych pomiarowych.
      * @return Wektor zawierający tylko prawidłowe obiekty MeasurementValue.
      */
     std::vector<MeasurementValue> filterValidValues(const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Filtruje dane jak filterValidValues() i sortuje je rosnąco po dacie.
+     * Dane posortowane malejąco są odwracane w czasie O(n), bez pełnego sortowania.
+     * @param values Oryginalny wektor danych pomiarowych.
+     * @return Prawidłowe pomiary posortowane rosnąco po dacie.
+     */
+    std::vector<MeasurementValue> sortedValidValues(const std::vector<MeasurementValue>& values);
+
+    /// Wspólna implementacja dailyMeans/dailyMaxima: grupuje posortowane dane po dniu kalendarzowym.
+    std::vector<MeasurementValue> dailyAggregate(const std::vector<MeasurementValue>& values, bool useMax, int minValidCount);
 };
 
 #endif // DATAANALYZER_H
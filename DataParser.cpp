@@ -1,11 +1,125 @@
 #include "DataParser.h"
+#include "StringPool.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QDebug>
+#include <algorithm>
+#include <charconv>
 #include <limits>
 #include <cmath>
 
+namespace {
+
+/// Pole wiersza CSV (bez cudzysłowów otaczających pole).
+struct CsvField {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    int size() const { return static_cast<int>(end - begin); }
+    bool isEmpty() const { return begin == end; }
+};
+
+/// Dzieli wiersz CSV na pola. Pole w cudzysłowach może zawierać separator; podwojone cudzysłowy nie są zamieniane.
+void splitCsvLine(const char* begin, const char* end, char separator, std::vector<CsvField>& fields)
+{
+    fields.clear();
+    const char* p = begin;
+    while (true) {
+        CsvField field;
+        if (p < end && *p == '"') {
+            const char* q = p + 1;
+            while (q < end && !(*q == '"' && (q + 1 == end || q[1] != '"'))) {
+                q += (*q == '"') ? 2 : 1;
+            }
+            field.begin = p + 1;
+            field.end = std::min(q, end);
+            p = std::find(std::min(q + 1, end), end, separator);
+        } else {
+            field.begin = p;
+            field.end = std::find(p, end, separator);
+            p = field.end;
+        }
+        fields.push_back(field);
+        if (p >= end) {
+            break;
+        }
+        ++p; // separator
+    }
+}
+
+QString csvFieldText(const CsvField& field)
+{
+    return QString::fromUtf8(field.begin, field.size()).trimmed();
+}
+
+/// Liczba zapisana `count` cyframi albo -1, jeśli któryś znak nie jest cyfrą.
+int parseDigits(const char* p, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        if (p[i] < '0' || p[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * Data z pola CSV. Formaty "yyyy-MM-dd HH:mm:ss" (czas lokalny, jak w API) i "yyyy-MM-ddTHH:mm:ss[.zzz]Z" (UTC, jak
+ * w eksporcie) są odczytywane bezpośrednio - QDateTime::fromString jest wielokrotnie wolniejsze, a wieloletnie
+ * archiwum ma dziesiątki milionów wierszy. Pozostałe formaty ISO 8601 przechodzą przez QDateTime::fromString.
+ */
+QDateTime parseCsvTimestamp(const CsvField& field)
+{
+    const char* p = field.begin;
+    const int size = field.size();
+    if (size >= 19 && p[4] == '-' && p[7] == '-' && (p[10] == ' ' || p[10] == 'T') && p[13] == ':' && p[16] == ':') {
+        const int year = parseDigits(p, 4);
+        const int month = parseDigits(p + 5, 2);
+        const int day = parseDigits(p + 8, 2);
+        const int hour = parseDigits(p + 11, 2);
+        const int minute = parseDigits(p + 14, 2);
+        const int second = parseDigits(p + 17, 2);
+        const QDate date(year, month, day);
+        const bool timeValid = hour >= 0 && hour < 24 && minute >= 0 && minute < 60 && second >= 0 && second < 60;
+        if (date.isValid() && timeValid && size == 19) {
+            return QDateTime(date, QTime(hour, minute, second));
+        }
+        int msecs = 0;
+        int zoneAt = 19;
+        if (size >= 23 && p[19] == '.') {
+            msecs = parseDigits(p + 20, 3);
+            zoneAt = 23;
+        }
+        if (date.isValid() && timeValid && msecs >= 0 && size == zoneAt + 1 && p[zoneAt] == 'Z') {
+            const qint64 days = date.toJulianDay() - QDate(1970, 1, 1).toJulianDay();
+            return QDateTime::fromMSecsSinceEpoch(((days * 24 + hour) * 60 + minute) * Q_INT64_C(60000) + second * 1000 + msecs);
+        }
+    }
+    return QDateTime::fromString(QString::fromLatin1(p, size), Qt::ISODate);
+}
+
+/// Wartość z pola CSV; NaN dla pustego pola lub tekstu, który nie jest liczbą.
+double parseCsvValue(const CsvField& field, char separator)
+{
+    if (field.isEmpty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    bool ok = false;
+    double value = 0.0;
+    if (separator == ';' && std::find(field.begin, field.end, ',') != field.end) {
+        QByteArray text(field.begin, field.size());
+        value = text.replace(',', '.').toDouble(&ok); // przecinek dziesiętny
+    } else {
+        value = QByteArray::fromRawData(field.begin, field.size()).toDouble(&ok);
+    }
+    return ok ? value : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // namespace
+
 DataParser::DataParser() {}
 
 
@@ -60,19 +174,12 @@ double DataParser::getDouble(const QJsonObject& obj, const QString& key, double
     return jsonVal.toDouble();
 }
 
-IndexLevel DataParser::parseIndexLevel(const QJsonObject& obj, const QString& baseKey) {
-    IndexLevel level;
+int DataParser::parseIndexLevel(const QJsonObject& obj, QLatin1String baseKey) {
     QJsonValue indexVal = obj.value(baseKey);
     if (indexVal.isObject()) {
-        QJsonObject indexObj = indexVal.toObject();
-        level.id = getInt(indexObj, "id", -1);
-        level.indexLevelName = getString(indexObj, "indexLevelName");
-    } else {
-
-        level.id = -1;
-        level.indexLevelName = "N/A";
+        return toIndexLevel(getInt(indexVal.toObject(), "id", NoIndexLevel));
     }
-    return level;
+    return NoIndexLevel;
 }
 
 
@@ -100,14 +207,14 @@ std::vector<MeasuringStation> DataParser::parseStations(const QByteArray& jsonDa
 
         QJsonObject cityObj = stationObj.value("city").toObject();
         station.city.id = getInt(cityObj, "id");
-        station.city.name = getString(cityObj, "name");
+        station.city.name = StringPool::intern(getString(cityObj, "name"));
         //station.city.addressStreet = getString(stationObj.value("address").toObject(), "street");
         station.city.addressStreet = getString(cityObj, "addressStreet");
 
         QJsonObject commObj = cityObj.value("commune").toObject();
-        station.city.commune.communeName = getString(commObj, "communeName");
-        station.city.commune.districtName = getString(commObj, "districtName");
-        station.city.commune.provinceName = getString(commObj, "provinceName");
+        station.city.commune.communeName = StringPool::intern(getString(commObj, "communeName"));
+        station.city.commune.districtName = StringPool::intern(getString(commObj, "districtName"));
+        station.city.commune.provinceName = StringPool::intern(getString(commObj, "provinceName"));
 
         if (station.id != -1) {
             stations.push_back(station);
@@ -137,9 +244,9 @@ std::vector<Sensor> DataParser::parseSensors(const QByteArray& jsonData) {
         sensor.stationId = getInt(sensorObj, "stationId");
 
         QJsonObject paramObj = sensorObj.value("param").toObject();
-        sensor.param.paramName = getString(paramObj, "paramName");
-        sensor.param.paramFormula = getString(paramObj, "paramFormula");
-        sensor.param.paramCode = getString(paramObj, "paramCode");
+        sensor.param.paramName = StringPool::intern(getString(paramObj, "paramName"));
+        sensor.param.paramFormula = StringPool::intern(getString(paramObj, "paramFormula"));
+        sensor.param.paramCode = StringPool::intern(getString(paramObj, "paramCode"));
         sensor.param.idParam = getInt(paramObj, "idParam");
 
         if (sensor.id != -1) {
@@ -161,7 +268,7 @@ SensorData DataParser::parseSensorData(const QByteArray& jsonData) {
     }
 
     QJsonObject dataObj = doc.object();
-    sensorData.key = getString(dataObj, "key");
+    sensorData.key = StringPool::intern(getString(dataObj, "key"));
 
     QJsonArray valuesArray = dataObj.value("values").toArray();
     for (const QJsonValue& value : valuesArray) {
@@ -230,16 +337,12 @@ AirQualityIndex DataParser::parseAirQualityIndex(const QByteArray& jsonData) {
     }
 
 
-    index.stIndexLevel = parseIndexLevel(indexObj, "stIndexLevel");
+    index.stIndexLevel = static_cast<qint8>(parseIndexLevel(indexObj, QLatin1String("stIndexLevel")));
 
 
-    index.so2IndexLevel = parseIndexLevel(indexObj, "so2IndexLevel");
-    index.no2IndexLevel = parseIndexLevel(indexObj, "no2IndexLevel");
-    index.coIndexLevel = parseIndexLevel(indexObj, "coIndexLevel");
-    index.pm10IndexLevel = parseIndexLevel(indexObj, "pm10IndexLevel");
-    index.pm25IndexLevel = parseIndexLevel(indexObj, "pm25IndexLevel");
-    index.o3IndexLevel = parseIndexLevel(indexObj, "o3IndexLevel");
-    index.c6h6IndexLevel = parseIndexLevel(indexObj, "c6h6IndexLevel");
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        index.pollutantLevels[p] = static_cast<qint8>(parseIndexLevel(indexObj, QLatin1String(PollutantIndexKeys[p])));
+    }
 
     if (index.stationId == -1) {
         qWarning() << "parseAirQualityIndex: Failed to parse valid station ID.";
@@ -247,3 +350,132 @@ AirQualityIndex DataParser::parseAirQualityIndex(const QByteArray& jsonData) {
 
     return index;
 }
+
+CsvArchiveLayout DataParser::parseCsvHeader(const QByteArray& headerLine) {
+    CsvArchiveLayout layout;
+    QByteArray line = headerLine;
+    if (line.startsWith("\xEF\xBB\xBF")) {
+        line.remove(0, 3); // BOM UTF-8
+    }
+    line = line.trimmed();
+    layout.separator = line.count(';') > line.count(',') ? ';' : ',';
+
+    std::vector<CsvField> fields;
+    splitCsvLine(line.constData(), line.constData() + line.size(), layout.separator, fields);
+    std::vector<std::pair<int, QString>> sensorColumns(fields.size(), std::make_pair(-1, QString()));
+    bool hasSensorColumns = false;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        const QString name = csvFieldText(fields[i]);
+        const int column = static_cast<int>(i);
+        if (name.compare(QLatin1String("timestamp"), Qt::CaseInsensitive) == 0) {
+            layout.timestampColumn = column;
+        } else if (name.compare(QLatin1String("sensor_id"), Qt::CaseInsensitive) == 0) {
+            layout.sensorIdColumn = column;
+        } else if (name.compare(QLatin1String("param"), Qt::CaseInsensitive) == 0) {
+            layout.paramColumn = column;
+        } else if (name.compare(QLatin1String("value"), Qt::CaseInsensitive) == 0) {
+            layout.valueColumn = column;
+        } else {
+            // Kolumna układu szerokiego "{kod}_{ID czujnika}"; kod może zawierać "_", więc ID jest po ostatnim.
+            const int separatorAt = name.lastIndexOf('_');
+            bool ok = false;
+            const int sensorId = separatorAt > 0 ? name.mid(separatorAt + 1).toInt(&ok) : -1;
+            if (ok && sensorId > 0) {
+                sensorColumns[i] = std::make_pair(sensorId, StringPool::intern(name.left(separatorAt)));
+                hasSensorColumns = true;
+            }
+        }
+    }
+    if (layout.sensorIdColumn < 0 && hasSensorColumns) {
+        layout.sensorColumns = std::move(sensorColumns);
+    }
+    if (!layout.isValid()) {
+        qWarning() << "parseCsvHeader: Unsupported CSV header:" << line.left(200);
+    }
+    return layout;
+}
+
+int DataParser::parseCsvRows(const QByteArray& rows, const CsvArchiveLayout& layout, std::map<int, SensorData>& out) {
+    if (!layout.isValid()) {
+        qWarning() << "parseCsvRows: Invalid CSV layout.";
+        return static_cast<int>(rows.count('\n'));
+    }
+    const bool wide = layout.sensorIdColumn < 0;
+    const int requiredFields = 1 + std::max({layout.timestampColumn, layout.sensorIdColumn, layout.valueColumn});
+
+    // Serie kolumn układu szerokiego są wyszukiwane raz na wywołanie (wskaźniki do elementów std::map są stabilne).
+    std::vector<SensorData*> columnSeries(layout.sensorColumns.size(), nullptr);
+    for (std::size_t c = 0; c < layout.sensorColumns.size(); ++c) {
+        const std::pair<int, QString>& column = layout.sensorColumns[c];
+        if (column.first > 0) {
+            SensorData& series = out[column.first];
+            if (series.key.isEmpty()) {
+                series.key = column.second;
+            }
+            columnSeries[c] = &series;
+        }
+    }
+
+    int skipped = 0;
+    int lastSensorId = -1;
+    SensorData* lastSeries = nullptr; // w układzie długim kolejne wiersze zwykle dotyczą tego samego czujnika
+    std::vector<CsvField> fields;
+    const char* p = rows.constData();
+    const char* const end = p + rows.size();
+    while (p < end) {
+        const char* lineEnd = std::find(p, end, '\n');
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd == p) {
+            p = next;
+            continue;
+        }
+        splitCsvLine(p, lineEnd, layout.separator, fields);
+        p = next;
+        if (static_cast<int>(fields.size()) < requiredFields) {
+            skipped++;
+            continue;
+        }
+
+        MeasurementValue mv;
+        mv.date = parseCsvTimestamp(fields[static_cast<std::size_t>(layout.timestampColumn)]);
+        if (!mv.date.isValid()) {
+            skipped++;
+            continue;
+        }
+
+        if (wide) {
+            const std::size_t columns = std::min(fields.size(), columnSeries.size());
+            for (std::size_t c = 0; c < columns; ++c) {
+                if (columnSeries[c] && !fields[c].isEmpty()) { // pusta komórka - brak pomiaru
+                    mv.value = parseCsvValue(fields[c], layout.separator);
+                    columnSeries[c]->values.push_back(mv);
+                }
+            }
+            continue;
+        }
+
+        const CsvField& idField = fields[static_cast<std::size_t>(layout.sensorIdColumn)];
+        int sensorId = -1;
+        const std::from_chars_result parsed = std::from_chars(idField.begin, idField.end, sensorId);
+        if (parsed.ec != std::errc() || parsed.ptr != idField.end || sensorId <= 0) {
+            skipped++;
+            continue;
+        }
+        if (sensorId != lastSensorId) {
+            lastSeries = &out[sensorId];
+            lastSensorId = sensorId;
+        }
+        if (lastSeries->key.isEmpty() && layout.paramColumn >= 0 && layout.paramColumn < static_cast<int>(fields.size())) {
+            lastSeries->key = StringPool::intern(csvFieldText(fields[static_cast<std::size_t>(layout.paramColumn)]));
+        }
+        mv.value = parseCsvValue(fields[static_cast<std::size_t>(layout.valueColumn)], layout.separator);
+        lastSeries->values.push_back(mv);
+    }
+    if (skipped > 0) {
+        qWarning() << "parseCsvRows: Skipped" << skipped << "invalid rows.";
+    }
+    return skipped;
+}
@@ -6,11 +6,37 @@
 #define DATAPARSER_H
 
 #include <QByteArray>
+#include <map>
+#include <utility>
 #include <vector>
 #include "DataStructures.h" // Potrzebne struktury danych
 
 class QJsonObject;
 
+/**
+ * @struct CsvArchiveLayout
+ * @brief Układ kolumn pliku CSV z archiwum pomiarów, odczytany z wiersza nagłówka przez DataParser::parseCsvHeader().
+ *
+ * Obsługiwane są dwa układy (te same, które zapisuje DataStorage::exportSensorSeries()):
+ * - długi: kolumny "sensor_id", "timestamp", "value" i opcjonalnie "param" (kod parametru) - wiersz na pomiar;
+ * - szeroki: kolumna "timestamp" i kolumny "{kod}_{ID czujnika}" (np. "PM10_123") - wiersz na datę.
+ *
+ * Separatorem jest przecinek albo średnik (wtedy w wartościach dopuszczalny jest przecinek dziesiętny).
+ */
+struct CsvArchiveLayout {
+    char separator = ',';     ///< Separator pól.
+    int timestampColumn = -1; ///< Indeks kolumny z datą pomiaru.
+    int sensorIdColumn = -1;  ///< Układ długi: indeks kolumny z ID czujnika (-1 w układzie szerokim).
+    int paramColumn = -1;     ///< Układ długi: indeks kolumny z kodem parametru (-1, jeśli brak).
+    int valueColumn = -1;     ///< Układ długi: indeks kolumny z wartością.
+    std::vector<std::pair<int, QString>> sensorColumns; ///< Układ szeroki: (ID czujnika, kod parametru) każdej kolumny (ID -1 dla kolumn bez danych czujnika).
+
+    /** @brief Czy nagłówek opisuje jeden z obsługiwanych układów. */
+    bool isValid() const {
+        return timestampColumn >= 0 && ((sensorIdColumn >= 0 && valueColumn >= 0) || !sensorColumns.empty());
+    }
+};
+
 /**
  * @class DataParser
  * @brief Odpowiada za konwersję danych w formacie JSON (jako QByteArray) na struktury C++ zdefiniowane w DataStructures.h.
@@ -59,6 +85,24 @@ public:
      */
     AirQualityIndex parseAirQualityIndex(const QByteArray& jsonData);
 
+    /**
+     * @brief Odczytuje układ kolumn z wiersza nagłówka pliku CSV z archiwum pomiarów.
+     * @param headerLine Pierwszy wiersz pliku (bez lub z końcem linii).
+     * @return Układ kolumn; CsvArchiveLayout::isValid() zwraca `false`, jeśli nagłówek nie pasuje do żadnego układu.
+     */
+    CsvArchiveLayout parseCsvHeader(const QByteArray& headerLine);
+
+    /**
+     * @brief Parsuje wiersze danych pliku CSV z archiwum i dopisuje pomiary do serii czujników.
+     * @param rows Pełne wiersze pliku (bez nagłówka) zakończone końcem linii; plik może być przetwarzany fragmentami.
+     * @param layout Układ kolumn z parseCsvHeader().
+     * @param out Serie czujników (kluczem jest ID czujnika), do których dopisywane są pomiary; pusty klucz serii jest
+     *            uzupełniany kodem parametru z pliku. Puste wartości są zapisywane jako NaN.
+     * @return Liczba pominiętych wierszy (nieprawidłowa data lub ID czujnika, za mało pól).
+     * @note Daty "yyyy-MM-dd HH:mm:ss" są czasem lokalnym (jak w API), daty ISO 8601 ze strefą - jak w zapisie.
+     */
+    int parseCsvRows(const QByteArray& rows, const CsvArchiveLayout& layout, std::map<int, SensorData>& out);
+
 private:
     /**
      * @brief Metoda pomocnicza do bezpiecznego pobierania wartości typu QString z QJsonObject.
@@ -91,10 +135,12 @@ private:
     /**
      * @brief Metoda pomocnicza do parsowania zagnieżdżonego obiektu poziomu indeksu AQI.
      * @param obj Główny obiekt JSON indeksu AQI.
-     * @param baseKey Klucz, pod którym znajduje się obiekt IndexLevel (np. "stIndexLevel", "pm10IndexLevel").
-     * @return Obiekt IndexLevel. Zwraca obiekt z wartościami domyślnymi (ID=-1, Name="N/A"), jeśli obiekt pod danym kluczem nie istnieje, jest null lub nie jest obiektem JSON.
+     * @param baseKey Klucz, pod którym znajduje się obiekt poziomu (np. "stIndexLevel", "pm10IndexLevel"); widok Latin-1,
+     *                aby odczyt kluczy z PollutantIndexKeys nie tworzył tymczasowych QString.
+     * @return ID poziomu (0-5). Zwraca NoIndexLevel (-1), jeśli obiekt pod danym kluczem nie istnieje, jest null,
+     *         nie jest obiektem JSON lub ID jest spoza zakresu. Nazwa poziomu z API jest pomijana (patrz indexLevelName()).
      */
-    IndexLevel parseIndexLevel(const QJsonObject& obj, const QString& baseKey);
+    int parseIndexLevel(const QJsonObject& obj, QLatin1String baseKey);
 };
 
 #endif // DATAPARSER_H
@@ -0,0 +1,327 @@
+#include "DataRepository.h"
+#include "DataStorage.h"
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+#include <utility>
+
+DataRepository::DataRepository(ApiService* apiService, DataStorage* storage, QObject* parent)
+    : QObject(parent), m_apiService(apiService), m_storage(storage)
+{
+    connect(m_apiService, &ApiService::stationsReady, this, &DataRepository::onStationsFetched);
+    connect(m_apiService, &ApiService::sensorsReady, this, &DataRepository::onSensorsFetched);
+    connect(m_apiService, &ApiService::sensorDataReady, this, &DataRepository::onSensorDataFetched);
+    connect(m_apiService, &ApiService::airQualityIndexReady, this, &DataRepository::onAirQualityIndexFetched);
+    connect(m_apiService, &ApiService::requestFailed, this, &DataRepository::onRequestFailed);
+}
+
+DataRepository::~DataRepository()
+{
+    // Scalanie w tle korzysta z DataStorage - musi się zakończyć przed usunięciem repozytorium (i magazynu).
+    for (QFutureWatcher<std::optional<SensorData>>* watcher : std::as_const(m_sensorDataMerges)) {
+        watcher->waitForFinished();
+    }
+}
+
+void DataRepository::setCachePolicy(const CachePolicy& policy)
+{
+    m_policy = policy;
+}
+
+CachePolicy DataRepository::cachePolicy() const
+{
+    return m_policy;
+}
+
+bool DataRepository::isFresh(const QString& filename, qint64 ttlSecs) const
+{
+    const QDateTime lastFetch = m_storage->lastFetchTime(filename);
+    if (!lastFetch.isValid()) {
+        return false;
+    }
+    return lastFetch.secsTo(QDateTime::currentDateTime()) < ttlSecs;
+}
+
+void DataRepository::requestStations(bool forceRefresh)
+{
+    std::vector<MeasuringStation> cached;
+    if (!forceRefresh) {
+        cached = m_storage->loadStationsFromJson();
+        if (!cached.empty()) {
+            emit stationsReady(cached);
+            if (isFresh(DataStorage::stationsFileName(), m_policy.stationsTtlSecs)) {
+                qDebug() << "Stacje z cache są aktualne, pomijam odświeżanie.";
+                return;
+            }
+        }
+    }
+
+    if (m_stationsPending) {
+        qDebug() << "Odświeżanie stacji już trwa.";
+        return;
+    }
+    m_stationsPending = true;
+    m_servedStations = cached;
+    m_apiService->fetchAllStations();
+}
+
+void DataRepository::requestSensors(int stationId, bool forceRefresh)
+{
+    if (stationId <= 0) return;
+
+    std::vector<Sensor> cached;
+    if (!forceRefresh) {
+        cached = m_storage->loadSensorsFromJson(stationId);
+        if (!cached.empty()) {
+            emit sensorsReady(stationId, cached);
+            if (isFresh(DataStorage::sensorsFileName(stationId), m_policy.sensorsTtlSecs)) {
+                qDebug() << "Czujniki stacji" << stationId << "z cache są aktualne, pomijam odświeżanie.";
+                return;
+            }
+        }
+    }
+
+    if (m_pendingSensors.contains(stationId)) {
+        qDebug() << "Odświeżanie czujników stacji" << stationId << "już trwa.";
+        return;
+    }
+    m_pendingSensors.insert(stationId, cached);
+    m_apiService->fetchSensorsForStation(stationId);
+}
+
+void DataRepository::requestSensorData(int sensorId, bool forceRefresh)
+{
+    if (sensorId <= 0) return;
+
+    std::shared_ptr<const SensorData> cached;
+    if (!forceRefresh) {
+        cached = loadSensorData(sensorId);
+        if (!cached->key.isEmpty() && !cached->values.empty()) {
+            emit sensorDataReady(sensorId, *cached);
+            if (isFresh(DataStorage::sensorSeriesFileName(sensorId), m_policy.sensorDataTtlSecs)) {
+                qDebug() << "Dane czujnika" << sensorId << "z cache są aktualne, pomijam odświeżanie.";
+                return;
+            }
+        } else {
+            cached.reset();
+        }
+    }
+
+    if (m_pendingSensorData.contains(sensorId)) {
+        qDebug() << "Odświeżanie danych czujnika" << sensorId << "już trwa.";
+        return;
+    }
+    m_pendingSensorData.insert(sensorId, cached);
+    m_apiService->fetchSensorData(sensorId);
+}
+
+void DataRepository::requestAirQualityIndex(int stationId, bool forceRefresh)
+{
+    if (stationId <= 0) return;
+
+    AirQualityIndex cached;
+    if (!forceRefresh) {
+        cached = m_storage->loadAirQualityIndexFromJson(stationId);
+        if (cached.stationId != -1) {
+            emit airQualityIndexReady(cached);
+            if (isFresh(DataStorage::airQualityIndexFileName(stationId), m_policy.airQualityIndexTtlSecs)) {
+                qDebug() << "AQI stacji" << stationId << "z cache jest aktualny, pomijam odświeżanie.";
+                return;
+            }
+        }
+    }
+
+    if (m_pendingAirQualityIndex.contains(stationId)) {
+        qDebug() << "Odświeżanie AQI stacji" << stationId << "już trwa.";
+        return;
+    }
+    m_pendingAirQualityIndex.insert(stationId, cached);
+    m_apiService->fetchAirQualityIndex(stationId);
+}
+
+std::shared_ptr<const SensorData> DataRepository::loadSensorData(int sensorId)
+{
+    if (sensorId <= 0) return std::make_shared<const SensorData>();
+
+    std::shared_ptr<const SensorData> inMemory = m_sensorDataCache.get(sensorId);
+    if (inMemory) {
+        qDebug() << "Dane czujnika" << sensorId << "z pamięci podręcznej (trafienia:" << m_sensorDataCache.hits()
+                 << "chybienia:" << m_sensorDataCache.misses() << ")";
+        return inMemory;
+    }
+
+    auto data = std::make_shared<const SensorData>(m_storage->loadCachedSensorData(sensorId));
+    if (!data->key.isEmpty() && !data->values.empty()) {
+        m_sensorDataCache.put(sensorId, data);
+    }
+    return data;
+}
+
+bool DataRepository::saveSensorData(int sensorId, const SensorData& data)
+{
+    std::optional<SensorData> merged = mergeIntoStorage(m_storage, sensorId, data);
+    if (merged && !merged->values.empty()) {
+        m_sensorDataCache.put(sensorId, std::move(*merged));
+    }
+    return merged.has_value();
+}
+
+ForecastState DataRepository::loadForecastState(int sensorId)
+{
+    ForecastState state;
+    // Bez wpisu w katalogu cache nie ma czego czytać - nowy czujnik nie kosztuje odczytu z dysku
+    if (sensorId > 0 && m_storage->lastFetchTime(DataStorage::forecastStateFileName(sensorId)).isValid()) {
+        state = m_storage->loadForecastState(sensorId);
+    }
+    state.sensorId = sensorId;
+    return state;
+}
+
+bool DataRepository::saveForecastState(const ForecastState& state)
+{
+    return m_storage->saveForecastState(state);
+}
+
+std::optional<SensorData> DataRepository::mergeIntoStorage(DataStorage* storage, int sensorId, const SensorData& data)
+{
+    if (sensorId <= 0) return std::nullopt;
+
+    SeriesMergeStats stats;
+    std::optional<SensorData> merged =
+        storage->mergeSensorSeries(sensorId, data, SeriesMergePolicy::PreferIncoming, &stats);
+    if (merged && stats.added == 0 && stats.replaced == 0) {
+        // Seria nie została przepisana - czas pobrania w katalogu cache trzeba odnotować osobno (isFresh()).
+        storage->markFetched(DataStorage::sensorSeriesFileName(sensorId));
+    }
+    return merged;
+}
+
+SensorDataCache& DataRepository::sensorDataCache()
+{
+    return m_sensorDataCache;
+}
+
+void DataRepository::onStationsFetched(const std::vector<MeasuringStation>& stations)
+{
+    std::vector<MeasuringStation> served = m_servedStations;
+    m_servedStations.clear();
+    m_stationsPending = false;
+
+    if (!stations.empty() && !m_storage->saveStationsToJson(stations)) {
+        qWarning() << "Nie udało się zapisać listy stacji do cache.";
+    }
+
+    if (served.empty() || served != stations) {
+        emit stationsReady(stations);
+    } else {
+        qDebug() << "Lista stacji z API nie różni się od cache.";
+    }
+}
+
+void DataRepository::onSensorsFetched(int stationId, const std::vector<Sensor>& sensors)
+{
+    std::vector<Sensor> served = m_pendingSensors.take(stationId);
+
+    if (!sensors.empty() && !m_storage->saveSensorsToJson(stationId, sensors)) {
+        qWarning() << "Nie udało się zapisać listy czujników dla stacji" << stationId;
+    }
+
+    if (served.empty() || served != sensors) {
+        emit sensorsReady(stationId, sensors);
+    } else {
+        qDebug() << "Lista czujników stacji" << stationId << "nie różni się od cache.";
+    }
+}
+
+void DataRepository::onSensorDataFetched(int sensorId, const SensorData& data)
+{
+    if (data.key.isEmpty() || data.values.empty()) {
+        finishSensorDataRefresh(sensorId, std::make_shared<const SensorData>(data), false);
+        return;
+    }
+
+    // Odpowiedź API obejmuje tylko kilka ostatnich dni - jest scalana z historią w cache, a GUI dostaje całą serię.
+    // Scalanie (odczyt, dekodowanie i zapis serii) odbywa się w tle, więc odświeżenie nie blokuje wątku GUI;
+    // żądanie pozostaje oczekujące do końca scalania, dzięki czemu kolejne żądania o ten czujnik nie są dublowane.
+    auto* watcher = new QFutureWatcher<std::optional<SensorData>>(this);
+    m_sensorDataMerges.insert(sensorId, watcher);
+    connect(watcher, &QFutureWatcher<std::optional<SensorData>>::finished, this, [this, sensorId, watcher, data]() {
+        m_sensorDataMerges.remove(sensorId);
+        watcher->deleteLater();
+        std::optional<SensorData> merged = watcher->result();
+        if (!merged) {
+            qWarning() << "Nie udało się zapisać danych czujnika" << sensorId;
+            finishSensorDataRefresh(sensorId, std::make_shared<const SensorData>(data), true);
+            return;
+        }
+        auto current = std::make_shared<const SensorData>(std::move(*merged));
+        if (!current->values.empty()) {
+            m_sensorDataCache.put(sensorId, current);
+        }
+        finishSensorDataRefresh(sensorId, current, true);
+    });
+    DataStorage* storage = m_storage;
+    watcher->setFuture(QtConcurrent::run([storage, sensorId, data]() {
+        return mergeIntoStorage(storage, sensorId, data);
+    }));
+}
+
+void DataRepository::finishSensorDataRefresh(int sensorId, const std::shared_ptr<const SensorData>& current, bool isValid)
+{
+    std::shared_ptr<const SensorData> served = m_pendingSensorData.take(sensorId);
+
+    if (!served) {
+        emit sensorDataReady(sensorId, *current);
+    } else if (isValid && *served != *current) {
+        emit sensorDataReady(sensorId, *current);
+    } else {
+        qDebug() << "Dane czujnika" << sensorId << "nie różnią się od cache (lub API nie zwróciło wartości).";
+    }
+}
+
+void DataRepository::onAirQualityIndexFetched(const AirQualityIndex& index)
+{
+    AirQualityIndex served = m_pendingAirQualityIndex.take(index.stationId);
+
+    if (!m_storage->saveAirQualityIndexToJson(index.stationId, index)) {
+        qWarning() << "Nie udało się zapisać AQI dla stacji" << index.stationId;
+    }
+    // Przy zapisie w tle (DataStorage::setWriteBehindEnabled()) dopisanie do historii nie blokuje wątku GUI.
+    if (m_storage->appendAirQualityIndexHistory(index)) {
+        qDebug() << "Dopisano AQI stacji" << index.stationId << "do historii.";
+    }
+
+    if (served.stationId == -1 || served != index) {
+        emit airQualityIndexReady(index);
+    } else {
+        qDebug() << "AQI stacji" << index.stationId << "nie różni się od cache.";
+    }
+}
+
+void DataRepository::onRequestFailed(ApiService::RequestType type, int id, const QString& errorMsg)
+{
+    bool servedFromCache = false;
+
+    switch (type) {
+    case ApiService::StationsRequest:
+        servedFromCache = !m_servedStations.empty();
+        m_servedStations.clear();
+        m_stationsPending = false;
+        break;
+    case ApiService::SensorsRequest:
+        servedFromCache = !m_pendingSensors.take(id).empty();
+        break;
+    case ApiService::SensorDataRequest:
+        servedFromCache = m_pendingSensorData.take(id) != nullptr;
+        break;
+    case ApiService::AirQualityIndexRequest:
+        servedFromCache = m_pendingAirQualityIndex.take(id).stationId != -1;
+        break;
+    }
+
+    if (servedFromCache) {
+        qWarning() << "Nie udało się odświeżyć danych z cache:" << errorMsg;
+        emit revalidationFailed(errorMsg);
+    } else {
+        emit networkError(errorMsg);
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file DataRepository.h
+ * @brief Definicja klasy DataRepository - warstwy cache typu "stale-while-revalidate" pomiędzy GUI a ApiService.
+ */
+#ifndef DATAREPOSITORY_H
+#define DATAREPOSITORY_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "DataStructures.h"
+#include "ApiService.h"
+#include "HoltWintersForecaster.h" // ForecastState
+#include "SensorDataCache.h"
+
+class DataStorage;
+
+/**
+ * @struct CachePolicy
+ * @brief Czas świeżości (TTL) danych w cache, osobno dla każdego typu encji.
+ *
+ * Dane młodsze niż TTL są podawane wyłącznie z cache (bez zapytania do API).
+ * Dane starsze są podawane z cache natychmiast, a następnie odświeżane w tle.
+ */
+struct CachePolicy {
+    qint64 stationsTtlSecs = 24 * 3600;   ///< Lista stacji - raz na dobę.
+    qint64 sensorsTtlSecs = 24 * 3600;    ///< Lista czujników stacji - raz na dobę.
+    qint64 sensorDataTtlSecs = 3600;      ///< Dane pomiarowe - co godzinę.
+    qint64 airQualityIndexTtlSecs = 600;  ///< Indeks AQI - co 10 minut.
+};
+
+/**
+ * @class DataRepository
+ * @brief Udostępnia dane stacji, czujników, pomiarów i AQI według strategii "stale-while-revalidate".
+ *
+ * Każde żądanie `request*` najpierw odczytuje dane z DataStorage i natychmiast emituje odpowiedni sygnał
+ * (czas reakcji GUI to czas odczytu z dysku). Jeśli dane są starsze niż TTL z CachePolicy (lub ich brak),
+ * w tle wykonywane jest zapytanie do ApiService. Odpowiedź jest zapisywana do cache (dane pomiarowe są scalane
+ * z historią w wątku roboczym), a sygnał jest emitowany ponownie tylko wtedy, gdy dane różnią się od wcześniej podanych.
+ *
+ * Błędy sieci dla żądań, na które odpowiedziano już danymi z cache, nie są przekazywane jako networkError(),
+ * lecz jako revalidationFailed() - użytkownik nadal widzi ostatnie znane dane.
+ *
+ * Sparsowane dane pomiarowe są dodatkowo trzymane w pamięci (SensorDataCache), dzięki czemu powrót
+ * do ostatnio oglądanego czujnika nie wymaga ponownego odczytu i parsowania pliku JSON.
+ */
+class DataRepository : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param apiService Serwis API używany do odświeżania danych (nie przejmuje własności).
+     * @param storage Magazyn danych używany jako cache (nie przejmuje własności).
+     * @param parent Obiekt nadrzędny Qt.
+     */
+    DataRepository(ApiService* apiService, DataStorage* storage, QObject* parent = nullptr);
+
+    /** @brief Destruktor. Czeka na zakończenie scalania danych pomiarowych w tle. */
+    ~DataRepository() override;
+
+    /** @brief Ustawia czasy świeżości danych dla poszczególnych typów encji. */
+    void setCachePolicy(const CachePolicy& policy);
+    /** @brief Zwraca aktualne czasy świeżości danych. */
+    CachePolicy cachePolicy() const;
+
+    /**
+     * @brief Żąda listy wszystkich stacji.
+     * @param forceRefresh Jeśli `true`, pomija cache i zawsze pyta API.
+     */
+    void requestStations(bool forceRefresh = false);
+
+    /**
+     * @brief Żąda listy czujników dla stacji.
+     * @param stationId ID stacji.
+     * @param forceRefresh Jeśli `true`, pomija cache i zawsze pyta API.
+     */
+    void requestSensors(int stationId, bool forceRefresh = false);
+
+    /**
+     * @brief Żąda danych pomiarowych czujnika.
+     * @param sensorId ID czujnika.
+     * @param forceRefresh Jeśli `true`, pomija cache i zawsze pyta API.
+     */
+    void requestSensorData(int sensorId, bool forceRefresh = false);
+
+    /**
+     * @brief Żąda indeksu jakości powietrza dla stacji.
+     * @param stationId ID stacji.
+     * @param forceRefresh Jeśli `true`, pomija cache i zawsze pyta API.
+     */
+    void requestAirQualityIndex(int stationId, bool forceRefresh = false);
+
+    /**
+     * @brief Zwraca dane pomiarowe czujnika z pamięci podręcznej, a gdy ich tam nie ma - z pliku w DataStorage.
+     * Nie wykonuje zapytań do API i nie emituje sygnałów. Trafienie w pamięci podręcznej nie kopiuje serii.
+     * @param sensorId ID czujnika.
+     * @return Współdzielone dane czujnika (nigdy `nullptr`); pusty obiekt SensorData, jeśli nie ma ich
+     *         ani w pamięci, ani na dysku.
+     */
+    std::shared_ptr<const SensorData> loadSensorData(int sensorId);
+
+    /**
+     * @brief Scala dane pomiarowe czujnika z serią w DataStorage i aktualizuje pamięć podręczną.
+     * Pomiary z dat spoza `data` zostają w cache; dla dat zapisanych wcześniej zostają wartości z `data`.
+     * @param sensorId ID czujnika.
+     * @param data Dane do zapisania.
+     * @return `true` jeśli zapis do pliku się powiódł (przy zapisie w tle - jeśli dane przyjęto do kolejki).
+     */
+    bool saveSensorData(int sensorId, const SensorData& data);
+
+    /**
+     * @brief Zwraca zapisany stan modelu prognozy czujnika (DataStorage::loadForecastState()).
+     * @param sensorId ID czujnika.
+     * @return Stan modelu; domyślny ForecastState z ustawionym `sensorId`, jeśli stanu nie zapisano.
+     */
+    ForecastState loadForecastState(int sensorId);
+
+    /**
+     * @brief Zapisuje stan modelu prognozy czujnika (w tle, jeśli DataStorage ma włączony zapis w tle).
+     * @return `true` jeśli zapis się powiódł lub dane przyjęto do kolejki zapisu.
+     */
+    bool saveForecastState(const ForecastState& state);
+
+    /** @brief Zwraca pamięć podręczną sparsowanych danych pomiarowych (np. do odczytu statystyk trafień). */
+    SensorDataCache& sensorDataCache();
+
+signals:
+    /** @brief Lista stacji z cache lub (gdy się zmieniła) z API. */
+    void stationsReady(const std::vector<MeasuringStation>& stations);
+    /** @brief Lista czujników stacji z cache lub (gdy się zmieniła) z API. */
+    void sensorsReady(int stationId, const std::vector<Sensor>& sensors);
+    /** @brief Dane pomiarowe czujnika z cache lub (gdy się zmieniły) z API. */
+    void sensorDataReady(int sensorId, const SensorData& data);
+    /** @brief Indeks AQI stacji z cache lub (gdy się zmienił) z API. */
+    void airQualityIndexReady(const AirQualityIndex& index);
+
+    /** @brief Błąd żądania, dla którego nie było danych w cache. Komunikat jak w ApiService::networkError(). */
+    void networkError(const QString& errorMsg);
+    /** @brief Błąd odświeżania danych, które zostały już podane z cache. */
+    void revalidationFailed(const QString& errorMsg);
+
+private slots:
+    void onStationsFetched(const std::vector<MeasuringStation>& stations);
+    void onSensorsFetched(int stationId, const std::vector<Sensor>& sensors);
+    void onSensorDataFetched(int sensorId, const SensorData& data);
+    void onAirQualityIndexFetched(const AirQualityIndex& index);
+    void onRequestFailed(ApiService::RequestType type, int id, const QString& errorMsg);
+
+private:
+    /**
+     * @brief Sprawdza, czy plik w cache pobrano później niż podany TTL temu (wg katalogu cache, bez odczytu z dysku).
+     * @return `false` jeśli pliku nie ma w katalogu cache lub pobrano go dawniej niż `ttlSecs` temu.
+     */
+    bool isFresh(const QString& filename, qint64 ttlSecs) const;
+
+    /**
+     * @brief Scala dane z serią w cache (DataStorage::mergeSensorSeries(), nowe wartości wygrywają).
+     * Nie korzysta ze stanu repozytorium, więc może działać w wątku roboczym.
+     * @return Seria po scaleniu lub std::nullopt przy błędzie.
+     */
+    static std::optional<SensorData> mergeIntoStorage(DataStorage* storage, int sensorId, const SensorData& data);
+
+    /**
+     * @brief Kończy odświeżanie danych czujnika: zdejmuje żądanie z oczekujących i emituje sensorDataReady(),
+     *        jeśli dane nie były podane z cache lub różnią się od podanych.
+     * @param current Seria po scaleniu (lub odpowiedź API, gdy scalenie się nie powiodło).
+     * @param isValid Czy odpowiedź API zawierała wartości.
+     */
+    void finishSensorDataRefresh(int sensorId, const std::shared_ptr<const SensorData>& current, bool isValid);
+
+    ApiService* m_apiService;   ///< Serwis API (nie jest własnością repozytorium).
+    DataStorage* m_storage;     ///< Magazyn danych (nie jest własnością repozytorium).
+    CachePolicy m_policy;       ///< Czasy świeżości danych.
+    SensorDataCache m_sensorDataCache; ///< Sparsowane dane pomiarowe ostatnio używanych czujników.
+
+    // --- Żądania oczekujące na odpowiedź API ---
+    // Przechowują dane, które zostały już podane z cache (do porównania z odpowiedzią).
+    // Obecność klucza oznacza, że żądanie jest w toku (kolejne żądania o ten sam zasób nie są dublowane).
+
+    ///< Czy oczekuje odświeżenie listy stacji.
+    bool m_stationsPending = false;
+    ///< Lista stacji podana z cache dla oczekującego odświeżenia (pusta, jeśli nie było cache).
+    std::vector<MeasuringStation> m_servedStations;
+    ///< Czujniki podane z cache, wg ID stacji.
+    QHash<int, std::vector<Sensor>> m_pendingSensors;
+    ///< Dane pomiarowe podane z cache (współdzielone z SensorDataCache; `nullptr` - nie było cache), wg ID czujnika.
+    QHash<int, std::shared_ptr<const SensorData>> m_pendingSensorData;
+    ///< Indeksy AQI podane z cache, wg ID stacji.
+    QHash<int, AirQualityIndex> m_pendingAirQualityIndex;
+    ///< Scalanie odpowiedzi API z serią w cache trwające w tle, wg ID czujnika.
+    QHash<int, QFutureWatcher<std::optional<SensorData>>*> m_sensorDataMerges;
+};
+
+#endif // DATAREPOSITORY_H
@@ -1,14 +1,266 @@
 #include "DataStorage.h"
+#include "SeriesCodec.h"
+#include "StringPool.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QDebug>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
 
-DataStorage::DataStorage(const QString& storagePath) : m_storagePath(storagePath)
+namespace {
+
+/// Początek stopki z sumą kontrolną dopisywanej przez DataStorage::writeFile().
+constexpr char ChecksumFooterPrefix[] = "#crc32:";
+
+/// Przyrostek nazwy, pod którą odkładany jest uszkodzony plik cache (usuwany przez DataStorage::compact()).
+constexpr char QuarantineSuffix[] = ".corrupt";
+
+/// Wersja formatu plików JSON zapisywana w katalogu cache (SeriesCodec ma własną wersję).
+constexpr int JsonFormatVersion = 1;
+
+/// Stan stopki z sumą kontrolną na końcu pliku.
+enum class FooterState { Missing, Valid, Invalid };
+
+/**
+ * @brief Odczytuje stopkę "\n#crc32:xxxxxxxx size:N\n" z końca `data` (całego pliku lub jego końcówki).
+ * @param footerStart Otrzymuje położenie stopki w `data`.
+ * @param expectedCrc Otrzymuje sumę kontrolną zapisaną w stopce.
+ * @param expectedSize Otrzymuje zapisaną w stopce długość danych.
+ * @return Missing, jeśli plik nie ma stopki; Invalid, jeśli stopki nie da się odczytać.
+ */
+FooterState parseChecksumFooter(const QByteArray& data, int& footerStart, quint32& expectedCrc, qint64& expectedSize)
+{
+    footerStart = data.lastIndexOf(QByteArray("\n") + ChecksumFooterPrefix);
+    if (footerStart < 0 || data.size() - footerStart > 64) {
+        return FooterState::Missing;
+    }
+    const QByteArray footer = data.mid(footerStart + 1).trimmed();
+    const QList<QByteArray> fields = footer.mid(static_cast<int>(qstrlen(ChecksumFooterPrefix))).split(' ');
+    bool crcOk = false;
+    bool sizeOk = false;
+    expectedCrc = fields.value(0).toUInt(&crcOk, 16);
+    expectedSize = fields.value(1).startsWith("size:") ? fields.value(1).mid(5).toLongLong(&sizeOk) : -1;
+    return crcOk && sizeOk ? FooterState::Valid : FooterState::Invalid;
+}
+
+/**
+ * @brief Odcina stopkę "\n#crc32:xxxxxxxx size:N\n" z końca `data`.
+ * @param expectedCrc Otrzymuje sumę kontrolną zapisaną w stopce.
+ * @return Missing, jeśli plik nie ma stopki (dane bez zmian); Invalid, jeśli stopki nie da się odczytać lub długość
+ *         danych się nie zgadza.
+ */
+FooterState stripChecksumFooter(QByteArray& data, quint32& expectedCrc)
+{
+    int footerStart = 0;
+    qint64 expectedSize = 0;
+    const FooterState footer = parseChecksumFooter(data, footerStart, expectedCrc, expectedSize);
+    if (footer == FooterState::Missing) {
+        return footer;
+    }
+    data.truncate(footerStart);
+    return footer == FooterState::Valid && expectedSize == data.size() ? FooterState::Valid : FooterState::Invalid;
+}
+
+/**
+ * @brief Sprawdza stopkę sumy kontrolnej otwartego pliku, czytając go porcjami (pamięć nie zależy od rozmiaru pliku).
+ * @return Długość danych bez stopki (cały plik, jeśli nie ma stopki); -1, jeśli stopka lub suma kontrolna się nie zgadza.
+ */
+qint64 verifiedPayloadSize(QFile& file)
+{
+    const qint64 fileSize = file.size();
+    const qint64 tailSize = std::min<qint64>(fileSize, 64);
+    if (!file.seek(fileSize - tailSize)) {
+        return -1;
+    }
+    const QByteArray tail = file.read(tailSize);
+    int footerStart = 0;
+    quint32 expectedCrc = 0;
+    qint64 expectedSize = 0;
+    const FooterState footer = parseChecksumFooter(tail, footerStart, expectedCrc, expectedSize);
+    if (footer == FooterState::Missing) {
+        return fileSize;
+    }
+    const qint64 payloadSize = fileSize - tailSize + footerStart;
+    if (footer == FooterState::Invalid || expectedSize != payloadSize || !file.seek(0)) {
+        return -1;
+    }
+    quint32 crc = 0;
+    for (qint64 pos = 0; pos < payloadSize;) {
+        const QByteArray chunk = file.read(std::min<qint64>(payloadSize - pos, 64 * 1024));
+        if (chunk.isEmpty()) {
+            return -1;
+        }
+        crc = DataStorage::checksum(chunk, crc);
+        pos += chunk.size();
+    }
+    return crc == expectedCrc ? payloadSize : -1;
+}
+
+/// Pliki z ID w nazwie ("{prefix}{id}{suffix}") i ich podkatalog w układzie StorageLayout::Sharded.
+struct CacheFilePattern {
+    const char* prefix;
+    const char* suffix;
+    CacheEntityType type;
+    const char* directory;
+};
+
+const CacheFilePattern CacheFilePatterns[] = {
+    {"sensor_", "_series.bin", CacheEntityType::SensorSeries, "series"},
+    {"sensor_", "_data.json", CacheEntityType::SensorData, "sensor_data"},
+    {"sensor_", "_forecast.json", CacheEntityType::ForecastState, "forecast"},
+    {"station_", "_sensors.json", CacheEntityType::Sensors, "sensors"},
+    {"station_", "_aqi.json", CacheEntityType::AirQualityIndex, "aqi"},
+};
+
+/// Rozpoznaje rodzaj danych i ID po nazwie pliku zapisanej przez DataStorage.
+CacheEntry describeCacheFile(const QString& filename)
+{
+    CacheEntry entry;
+    entry.fileName = filename;
+    if (filename == DataStorage::stationsFileName()) {
+        entry.type = CacheEntityType::Stations;
+    } else if (filename == DataStorage::alertRulesFileName() || filename == DataStorage::alertStateFileName()) {
+        entry.type = CacheEntityType::AlertRules;
+    } else {
+        for (const CacheFilePattern& pattern : CacheFilePatterns) {
+            const QLatin1String prefix(pattern.prefix);
+            const QLatin1String suffix(pattern.suffix);
+            if (!filename.startsWith(prefix) || !filename.endsWith(suffix)) {
+                continue;
+            }
+            bool ok = false;
+            const int id = filename.mid(prefix.size(), filename.size() - prefix.size() - suffix.size()).toInt(&ok);
+            if (ok && id > 0) {
+                entry.type = pattern.type;
+                entry.id = id;
+                break;
+            }
+        }
+    }
+    return entry;
+}
+
+/// Ścieżka pliku względem katalogu przechowywania w układzie StorageLayout::Sharded.
+QString shardedFilePath(const QString& filename)
+{
+    const CacheEntry entry = describeCacheFile(filename);
+    for (const CacheFilePattern& pattern : CacheFilePatterns) {
+        if (entry.id > 0 && pattern.type == entry.type) {
+            return QString("%1/%2/%3").arg(QLatin1String(pattern.directory)).arg(entry.id / DataStorage::IdsPerShard)
+                .arg(filename);
+        }
+    }
+    return filename;
+}
+
+/// Uzupełnia wpis katalogu o metadane zawartości pliku (bez stopki): sumę kontrolną, wersję formatu, zakres dat serii.
+void describeCachePayload(CacheEntry& entry, const QByteArray& payload)
+{
+    entry.checksum = DataStorage::checksum(payload);
+    entry.formatVersion = JsonFormatVersion;
+    if (entry.type != CacheEntityType::SensorSeries) {
+        return;
+    }
+    entry.formatVersion = SeriesCodec::FormatVersion;
+    const std::optional<std::vector<SeriesCodec::BlockInfo>> blocks = SeriesCodec::blocks(payload);
+    if (!blocks || blocks->empty()) {
+        return;
+    }
+    qint64 first = std::numeric_limits<qint64>::max();
+    qint64 last = std::numeric_limits<qint64>::min();
+    for (const SeriesCodec::BlockInfo& block : *blocks) {
+        first = std::min(first, block.minMSecs);
+        last = std::max(last, block.maxMSecs);
+    }
+    entry.firstDate = QDateTime::fromMSecsSinceEpoch(first);
+    entry.lastDate = QDateTime::fromMSecsSinceEpoch(last);
+}
+
+/// Czujnik w eksporcie: klucz, zakres dat i położenie danych - pomiary są czytane z pliku dopiero przy zapisie wierszy.
+struct ExportSource {
+    int sensorId = -1;
+    QByteArray key;                                             ///< Klucz danych (kod parametru) w UTF-8.
+    qint64 firstMSecs = std::numeric_limits<qint64>::max();    ///< Najwcześniejszy pomiar (ms od epoki).
+    qint64 lastMSecs = std::numeric_limits<qint64>::min();     ///< Najpóźniejszy pomiar (ms od epoki).
+    QString path;                                               ///< Plik serii; pusty dla starszego JSON.
+    qint64 fileSize = 0;                                        ///< Rozmiar pliku serii przy odczycie indeksu.
+    QDateTime fileModified;                                     ///< Data modyfikacji pliku serii przy odczycie indeksu.
+    qint64 dataStart = 0;                                       ///< Położenie sekcji danych serii w pliku.
+    std::vector<SeriesCodec::BlockInfo> blocks;                 ///< Bloki serii wg najwcześniejszej daty.
+    std::size_t nextBlock = 0;                                  ///< Pierwszy jeszcze nieodczytany blok.
+    std::function<SensorData()> loadLegacy;                     ///< Wczytuje starszy plik JSON (ponownie dla każdego okna).
+    qint64 legacyLoadedUntil = std::numeric_limits<qint64>::min(); ///< Pomiary JSON sprzed tej daty są już odczytane.
+    std::vector<std::pair<qint64, double>> points;              ///< Odczytane, jeszcze niezapisane pomiary wg daty.
+};
+
+/**
+ * Odczytuje z pliku kolejne bloki serii zaczynające się przed `untilMSecs` (każdy blok tylko raz) - a dla starszego
+ * JSON pomiary sprzed `untilMSecs` - i dołącza ich pomiary z przedziału [fromMSecs, toMSecs) do `source.points`,
+ * zachowując porządek dat. Plik serii zmieniony od odczytu indeksu (np. przez zapis w tle) przerywa odczyt.
+ */
+bool readExportPoints(ExportSource& source, qint64 fromMSecs, qint64 toMSecs, qint64 untilMSecs, ExportStats& stats)
+{
+    std::vector<MeasurementValue> values;
+    if (source.path.isEmpty()) {
+        if (source.legacyLoadedUntil >= untilMSecs) {
+            return true;
+        }
+        const qint64 loadFrom = std::max(fromMSecs, source.legacyLoadedUntil);
+        const qint64 loadTo = std::min(toMSecs, untilMSecs);
+        for (const MeasurementValue& mv : source.loadLegacy().values) {
+            if (!mv.date.isValid()) {
+                continue;
+            }
+            const qint64 msecs = mv.date.toMSecsSinceEpoch();
+            if (msecs >= loadFrom && msecs < loadTo) {
+                values.push_back(mv);
+            }
+        }
+        source.legacyLoadedUntil = untilMSecs;
+    } else if (source.nextBlock < source.blocks.size() && source.blocks[source.nextBlock].minMSecs < untilMSecs) {
+        QFile file(source.path);
+        if (!file.open(QIODevice::ReadOnly) || file.size() != source.fileSize
+            || file.fileTime(QFileDevice::FileModificationTime) != source.fileModified) {
+            qWarning() << "Sensor series changed or disappeared during export:" << source.path;
+            return false;
+        }
+        while (source.nextBlock < source.blocks.size() && source.blocks[source.nextBlock].minMSecs < untilMSecs) {
+            const SeriesCodec::BlockInfo& block = source.blocks[source.nextBlock];
+            if (!file.seek(source.dataStart + block.offset)
+                || !SeriesCodec::readBlockData(file.read(block.size), block, values, fromMSecs, toMSecs)) {
+                return false;
+            }
+            source.nextBlock++;
+            stats.blocksRead++;
+        }
+    }
+    if (values.empty()) {
+        return true;
+    }
+    const std::size_t pending = source.points.size();
+    for (const MeasurementValue& mv : values) {
+        source.points.emplace_back(mv.date.toMSecsSinceEpoch(), mv.value);
+    }
+    auto byDate = [](const auto& a, const auto& b) { return a.first < b.first; };
+    std::stable_sort(source.points.begin() + static_cast<std::ptrdiff_t>(pending), source.points.end(), byDate);
+    std::inplace_merge(source.points.begin(), source.points.begin() + static_cast<std::ptrdiff_t>(pending),
+                       source.points.end(), byDate);
+    return true;
+}
+
+} // namespace
+
+DataStorage::DataStorage(const QString& storagePath)
+    : m_storagePath(storagePath), m_aqiHistory(storagePath), m_manifest(storagePath)
 {
 
     QDir dir(m_storagePath);
@@ -19,6 +271,469 @@ DataStorage::DataStorage(const QString& storagePath) : m_storagePath(storagePath
             qWarning() << "Failed to create storage directory:" << m_storagePath;
         }
     }
+    if (!m_manifest.load()) {
+        rebuildManifest();
+    }
+}
+
+DataStorage::~DataStorage()
+{
+    setWriteBehindEnabled(false);
+}
+
+AqiHistoryStore& DataStorage::airQualityIndexHistory()
+{
+    flushAirQualityIndexHistory();
+    return m_aqiHistory;
+}
+
+bool DataStorage::appendAirQualityIndexHistory(const AirQualityIndex& index)
+{
+    if (!m_writeQueue) {
+        return m_aqiHistory.append(index);
+    }
+    if (index.stationId <= 0 || !index.stCalcDate.isValid()) {
+        qWarning() << "Cannot append AQI to history, invalid stationId or stCalcDate:" << index.stationId;
+        return false;
+    }
+    const int stationId = index.stationId;
+    {
+        QMutexLocker locker(&m_pendingAqiHistoryMutex);
+        m_pendingAqiHistory[stationId].push_back(index);
+    }
+    // Nowsze zlecenie zastępuje czekające w kolejce - zadanie dopisuje wszystkie zebrane dotąd indeksy stacji.
+    return m_writeQueue->enqueue(AqiHistoryStore::fileName(stationId), [this, stationId] {
+        std::vector<AirQualityIndex> indices;
+        {
+            QMutexLocker locker(&m_pendingAqiHistoryMutex);
+            indices.swap(m_pendingAqiHistory[stationId]);
+        }
+        return indices.empty() || m_aqiHistory.appendBatch(stationId, indices) >= 0;
+    });
+}
+
+void DataStorage::flushAirQualityIndexHistory()
+{
+    if (!m_writeQueue) {
+        return;
+    }
+    QList<int> stationIds;
+    {
+        QMutexLocker locker(&m_pendingAqiHistoryMutex);
+        stationIds = m_pendingAqiHistory.keys();
+    }
+    for (int stationId : stationIds) {
+        m_writeQueue->flushKey(AqiHistoryStore::fileName(stationId));
+    }
+}
+
+const CacheManifest& DataStorage::cacheManifest() const
+{
+    if (m_writeQueue) {
+        m_writeQueue->flush(); // wpisy zaległych zapisów muszą już być w katalogu
+    }
+    return m_manifest;
+}
+
+void DataStorage::rebuildManifest()
+{
+    // Jednorazowy przegląd katalogu (brak lub uszkodzenie pliku katalogu, np. pierwsze uruchomienie po aktualizacji).
+    std::vector<CacheEntry> entries;
+    const QFileInfoList files = cacheFiles(QStringList() << QStringLiteral("*.json") << QStringLiteral("*_series.bin"));
+    for (const QFileInfo& info : files) {
+        if (info.fileName() == CacheManifest::fileName()) {
+            continue;
+        }
+        QFile file(info.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray payload = file.readAll();
+        quint32 expectedCrc = 0;
+        if (stripChecksumFooter(payload, expectedCrc) == FooterState::Invalid) {
+            continue; // uszkodzony plik zostanie usunięty przy pierwszym odczycie
+        }
+        CacheEntry entry = describeCacheFile(info.fileName());
+        describeCachePayload(entry, payload);
+        entry.size = info.size();
+        entry.lastFetch = info.lastModified();
+        entries.push_back(entry);
+    }
+    if (entries.empty()) {
+        return; // pusty katalog - katalog cache powstanie przy pierwszym zapisie
+    }
+    if (m_manifest.replaceAll(entries)) {
+        qInfo() << "Rebuilt cache manifest from" << entries.size() << "files in" << m_storagePath;
+    }
+}
+
+CompactionStats DataStorage::compact(const RetentionPolicy& policy, const QDateTime& now)
+{
+    CompactionStats stats;
+    stats.bytesBefore = cacheManifest().totalSize() + historySize();
+    const QDateTime cutoff = policy.maxAgeDays > 0 ? now.addDays(-policy.maxAgeDays) : QDateTime();
+
+    // Pliki bez ID (lista stacji, reguły alertów, pliki o innych nazwach) i pliki chronione (setSeriesRetained())
+    // nie podlegają zasadom przechowywania.
+    auto removableEntries = [this] {
+        std::vector<CacheEntry> entries = m_manifest.entries();
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const CacheEntry& entry) {
+            return entry.id <= 0 || entry.retained;
+        }), entries.end());
+        return entries;
+    };
+
+    {
+        QMutexLocker locker(&m_fileMutex);
+        for (const QFileInfo& info : cacheFiles(QStringList() << QLatin1String("*") + QLatin1String(QuarantineSuffix))) {
+            if (QFile::remove(info.filePath())) {
+                stats.filesRemoved++;
+            }
+        }
+    }
+    for (const CacheEntry& entry : m_manifest.entries(CacheEntityType::SensorSeries)) {
+        if (entry.retained) {
+            compactSeriesFile(entry.fileName, QDateTime(), stats); // tylko scalenie bloków, bez usuwania pomiarów
+        }
+    }
+    for (const CacheEntry& entry : removableEntries()) {
+        const bool stale = cutoff.isValid() && entry.lastFetch.isValid() && entry.lastFetch < cutoff;
+        const bool expiredSeries = cutoff.isValid() && entry.lastDate.isValid() && entry.lastDate < cutoff;
+        if (stale || expiredSeries) {
+            if (m_writeQueue) {
+                m_writeQueue->flushKey(entry.fileName);
+            }
+            QMutexLocker locker(&m_fileMutex);
+            // Plik mógł zostać zapisany ponownie od odczytu katalogu - wtedy nie jest już przeterminowany.
+            const std::optional<CacheEntry> current = m_manifest.entry(entry.fileName);
+            if (current && current->lastFetch == entry.lastFetch && removeFileLocked(entry.fileName)) {
+                stats.filesRemoved++;
+            }
+        } else if (entry.type == CacheEntityType::SensorSeries) {
+            compactSeriesFile(entry.fileName, cutoff, stats);
+        }
+    }
+
+    if (cutoff.isValid()) {
+        flushAirQualityIndexHistory();
+        for (int stationId : m_aqiHistory.stationIds()) {
+            stats.historyRecordsRemoved += std::max<qint64>(0, m_aqiHistory.removeBefore(stationId, cutoff));
+        }
+    }
+
+    if (policy.diskBudgetBytes > 0) {
+        qint64 total = m_manifest.totalSize() + historySize();
+        if (total > policy.diskBudgetBytes) {
+            std::vector<CacheEntry> entries = removableEntries();
+            std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) {
+                return a.lastFetch < b.lastFetch;
+            });
+            for (const CacheEntry& entry : entries) {
+                if (total <= policy.diskBudgetBytes) {
+                    break;
+                }
+                if (m_writeQueue) {
+                    m_writeQueue->flushKey(entry.fileName);
+                }
+                QMutexLocker locker(&m_fileMutex);
+                if (removeFileLocked(entry.fileName)) {
+                    stats.filesRemoved++;
+                }
+                total -= entry.size; // wpis znika z katalogu także wtedy, gdy pliku już nie było
+            }
+        }
+        if (total > policy.diskBudgetBytes) {
+            qWarning() << "Cache still exceeds disk budget after compaction:" << total << "bytes, budget"
+                       << policy.diskBudgetBytes;
+        }
+    }
+
+    stats.bytesAfter = m_manifest.totalSize() + historySize();
+    qInfo() << "Cache compaction: removed" << stats.filesRemoved << "files, rewrote" << stats.filesRewritten
+            << "series, removed" << stats.historyRecordsRemoved << "AQI history records," << stats.bytesBefore << "->"
+            << stats.bytesAfter << "bytes";
+    return stats;
+}
+
+bool DataStorage::setSeriesRetained(int sensorId, bool retained)
+{
+    const QString filename = sensorSeriesFileName(sensorId);
+    if (m_writeQueue) {
+        m_writeQueue->flushKey(filename);
+    }
+    QMutexLocker locker(&m_fileMutex);
+    std::optional<CacheEntry> entry = m_manifest.entry(filename);
+    if (!entry) {
+        qWarning() << "Cannot change retention of missing sensor series:" << filename;
+        return false;
+    }
+    if (entry->retained != retained) {
+        entry->retained = retained;
+        m_manifest.update(*entry);
+    }
+    return true;
+}
+
+bool DataStorage::compactSeriesFile(const QString& filename, const QDateTime& cutoff, CompactionStats& stats)
+{
+    if (m_writeQueue) {
+        m_writeQueue->flushKey(filename);
+    }
+    QMutexLocker locker(&m_fileMutex);
+    const std::optional<QByteArray> bytes = readFileContents(filename);
+    const std::optional<std::vector<SeriesCodec::BlockInfo>> blocks =
+        bytes ? SeriesCodec::blocks(*bytes) : std::nullopt;
+    if (!blocks) {
+        return false;
+    }
+
+    // Seria zapisana z mniejszymi blokami (lub po obcięciu) ma więcej bloków niż potrzeba - scalenie zmniejsza
+    // narzut indeksu i nagłówków bloków.
+    quint64 count = 0;
+    bool hasExpired = false;
+    for (const SeriesCodec::BlockInfo& block : *blocks) {
+        count += block.count;
+        hasExpired = hasExpired || (cutoff.isValid() && block.minMSecs < cutoff.toMSecsSinceEpoch());
+    }
+    const std::size_t neededBlocks = static_cast<std::size_t>((count + SeriesCodec::DefaultBlockSize - 1)
+                                                              / SeriesCodec::DefaultBlockSize);
+    if (!hasExpired && blocks->size() <= neededBlocks) {
+        return false;
+    }
+
+    const std::optional<SensorData> data = SeriesCodec::decode(*bytes, cutoff);
+    if (!data) {
+        return false;
+    }
+    if (data->values.empty()) {
+        if (removeFileLocked(filename)) {
+            stats.filesRemoved++;
+            return true;
+        }
+        return false;
+    }
+    if (!writeFileLocked(filename, SeriesCodec::encode(*data))) {
+        return false;
+    }
+    stats.filesRewritten++;
+    return true;
+}
+
+bool DataStorage::removeFileLocked(const QString& filename)
+{
+    bool removed = false;
+    for (StorageLayout layout : {StorageLayout::Flat, StorageLayout::Sharded}) {
+        const QString path = filePath(filename, layout);
+        if (QFile::exists(path)) {
+            removed = QFile::remove(path) || removed;
+        }
+    }
+    m_manifest.remove(filename);
+    if (removed) {
+        qDebug() << "Removed cache file" << filename;
+    }
+    return removed;
+}
+
+qint64 DataStorage::historySize() const
+{
+    qint64 total = 0;
+    for (int stationId : m_aqiHistory.stationIds()) {
+        total += QFileInfo(m_storagePath + QDir::separator() + AqiHistoryStore::fileName(stationId)).size();
+    }
+    return total;
+}
+
+bool DataStorage::exportSensorSeries(const std::vector<int>& sensorIds, const QString& filePath,
+                                     const ExportOptions& options, ExportStats* stats)
+{
+    const qint64 fromMSecs = options.from.isValid() ? options.from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    const qint64 toMSecs = options.to.isValid() ? options.to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+    ExportStats result;
+
+    // Klucz, zakres dat i indeks bloków czujnika - plik serii jest sprawdzany (suma kontrolna) porcjami, a z pamięci
+    // zostaje tylko nagłówek; pomiary są czytane blokami dopiero przy zapisie wierszy. Starszy JSON jest tu czytany
+    // tylko dla klucza i zakresu dat. Zwraca `false` dla czujników bez danych w przedziale.
+    auto openSource = [&](int sensorId, ExportSource& source) {
+        source.sensorId = sensorId;
+        QString key;
+        const QString seriesFile = sensorSeriesFileName(sensorId);
+        if (sensorId > 0 && getLastModified(seriesFile).isValid()) {
+            source.path = locateFile(seriesFile);
+            QFile file(source.path);
+            const qint64 seriesSize = file.open(QIODevice::ReadOnly) ? verifiedPayloadSize(file) : -1;
+            std::optional<std::vector<SeriesCodec::BlockInfo>> blocks =
+                seriesSize >= 0 ? SeriesCodec::readIndex(file, seriesSize, &key, &source.dataStart) : std::nullopt;
+            if (!blocks) {
+                if (file.isOpen() && seriesSize < 0) {
+                    // Zła suma kontrolna - sprawdzenie przy zablokowanym m_fileMutex i odłożenie pliku, jak przy odczycie
+                    QMutexLocker locker(&m_fileMutex);
+                    readFileContents(seriesFile);
+                }
+                qWarning() << "Skipping unreadable sensor series in export:" << sensorId;
+                return false;
+            }
+            source.fileSize = file.size();
+            source.fileModified = file.fileTime(QFileDevice::FileModificationTime);
+            for (const SeriesCodec::BlockInfo& block : *blocks) {
+                if (block.maxMSecs >= fromMSecs && block.minMSecs < toMSecs) {
+                    source.firstMSecs = std::min(source.firstMSecs, block.minMSecs);
+                    source.lastMSecs = std::max(source.lastMSecs, block.maxMSecs);
+                    source.blocks.push_back(block);
+                }
+            }
+            std::stable_sort(source.blocks.begin(), source.blocks.end(),
+                             [](const auto& a, const auto& b) { return a.minMSecs < b.minMSecs; });
+        } else {
+            source.loadLegacy = [this, sensorId] { return loadSensorDataFromJson(sensorDataFileName(sensorId)); };
+            const SensorData data = source.loadLegacy();
+            key = data.key;
+            for (const MeasurementValue& mv : data.values) {
+                const qint64 msecs = mv.date.isValid() ? mv.date.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+                if (mv.date.isValid() && msecs >= fromMSecs && msecs < toMSecs) {
+                    source.firstMSecs = std::min(source.firstMSecs, msecs);
+                    source.lastMSecs = std::max(source.lastMSecs, msecs);
+                }
+            }
+        }
+        source.key = key.toUtf8();
+        return !key.isEmpty() && source.firstMSecs <= source.lastMSecs && source.lastMSecs >= fromMSecs
+               && source.firstMSecs < toMSecs;
+    };
+    auto trackBuffered = [&result](std::size_t buffered) {
+        result.peakBufferedPoints = std::max<quint64>(result.peakBufferedPoints, buffered);
+    };
+    const std::vector<int> ids = sensorIds.empty() ? cachedSensorDataIds() : sensorIds;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't open export file for writing:" << filePath << file.errorString();
+        return false;
+    }
+    std::unique_ptr<TableWriter> writer = TableWriter::create(options.format, &file);
+    bool ok = true;
+
+    if (options.layout == ExportLayout::Long) {
+        ok = writer->begin({{"sensor_id", ColumnType::Int32}, {"param", ColumnType::Utf8},
+                            {"timestamp", ColumnType::Timestamp}, {"value", ColumnType::Float64}});
+        // Czujnik po czujniku: odczyt bloku, zapis pomiarów, których nie poprzedza żaden dalszy blok, i zwolnienie
+        for (std::size_t i = 0; ok && i < ids.size(); ++i) {
+            ExportSource source;
+            if (!openSource(ids[i], source)) {
+                continue;
+            }
+            result.sensorCount++;
+            for (;;) {
+                const bool moreBlocks = source.nextBlock < source.blocks.size();
+                const qint64 until = moreBlocks ? source.blocks[source.nextBlock].minMSecs + 1
+                                                : std::numeric_limits<qint64>::max();
+                if (!readExportPoints(source, fromMSecs, toMSecs, until, result)) {
+                    qWarning() << "Error decoding sensor series in export:" << source.sensorId;
+                    ok = false;
+                    break;
+                }
+                trackBuffered(source.points.size());
+                const qint64 ready = source.nextBlock < source.blocks.size() ? source.blocks[source.nextBlock].minMSecs
+                                                                              : std::numeric_limits<qint64>::max();
+                std::size_t written = 0;
+                for (; ok && written < source.points.size() && source.points[written].first < ready; ++written) {
+                    writer->setInt32(0, source.sensorId);
+                    writer->setUtf8(1, source.key);
+                    writer->setTimestamp(2, source.points[written].first);
+                    writer->setFloat64(3, source.points[written].second);
+                    ok = writer->endRow();
+                }
+                source.points.erase(source.points.begin(), source.points.begin() + static_cast<std::ptrdiff_t>(written));
+                if (!ok || ready == std::numeric_limits<qint64>::max()) {
+                    break;
+                }
+            }
+        }
+    } else {
+        std::vector<ExportSource> sources;
+        for (int sensorId : ids) {
+            ExportSource source;
+            if (openSource(sensorId, source)) {
+                sources.push_back(std::move(source));
+            }
+        }
+        result.sensorCount = static_cast<int>(sources.size());
+
+        std::vector<ColumnSpec> columns = {{"timestamp", ColumnType::Timestamp}};
+        qint64 start = std::numeric_limits<qint64>::max();
+        qint64 end = std::numeric_limits<qint64>::min();
+        for (const ExportSource& source : sources) {
+            columns.push_back({QString::fromUtf8(source.key) + '_' + QString::number(source.sensorId), ColumnType::Float64});
+            start = std::min(start, std::max(source.firstMSecs, fromMSecs));
+            end = std::max(end, std::min(source.lastMSecs + 1, toMSecs));
+        }
+        ok = writer->begin(columns);
+
+        // Okna dat: w pamięci są tylko pomiary wszystkich czujników z bloków nachodzących na jedno okno, scalane po dacie.
+        // Każdy czujnik ma kursor bloków - blok jest odczytywany z pliku raz, a jego pomiary spoza okna czekają na kolejne okna.
+        const qint64 window = static_cast<qint64>(ExportWindowDays) * 24 * 3600 * 1000;
+        std::vector<std::size_t> positions(sources.size());
+        for (qint64 windowStart = start; ok && windowStart < end; windowStart += window) {
+            const qint64 windowEnd = std::min(end, windowStart + window);
+            std::size_t buffered = 0;
+            for (std::size_t i = 0; ok && i < sources.size(); ++i) {
+                positions[i] = 0;
+                if (!readExportPoints(sources[i], fromMSecs, toMSecs, windowEnd, result)) {
+                    qWarning() << "Error decoding sensor series in export:" << sources[i].sensorId;
+                    ok = false;
+                }
+                buffered += sources[i].points.size();
+            }
+            trackBuffered(buffered);
+            while (ok) {
+                qint64 next = std::numeric_limits<qint64>::max();
+                for (std::size_t i = 0; i < sources.size(); ++i) {
+                    const std::vector<std::pair<qint64, double>>& points = sources[i].points;
+                    if (positions[i] < points.size() && points[positions[i]].first < windowEnd) {
+                        next = std::min(next, points[positions[i]].first);
+                    }
+                }
+                if (next == std::numeric_limits<qint64>::max()) {
+                    break;
+                }
+                writer->setTimestamp(0, next);
+                for (std::size_t i = 0; i < sources.size(); ++i) {
+                    const std::vector<std::pair<qint64, double>>& points = sources[i].points;
+                    std::size_t& pos = positions[i];
+                    if (pos < points.size() && points[pos].first == next) {
+                        while (pos + 1 < points.size() && points[pos + 1].first == next) {
+                            pos++; // powtórzona data - zostaje ostatnia wartość
+                        }
+                        writer->setFloat64(static_cast<int>(i) + 1, points[pos].second);
+                        pos++;
+                    }
+                }
+                ok = writer->endRow();
+            }
+            for (std::size_t i = 0; i < sources.size(); ++i) {
+                std::vector<std::pair<qint64, double>>& points = sources[i].points;
+                points.erase(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(positions[i]));
+            }
+        }
+    }
+
+    ok = ok && writer->finish();
+    result.rowCount = writer->rowCount();
+    result.bytesWritten = writer->bytesWritten();
+    if (stats) {
+        *stats = result;
+    }
+    if (!ok) {
+        file.cancelWriting();
+        qWarning() << "Export failed:" << filePath;
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "Couldn't write export file:" << filePath << file.errorString();
+        return false;
+    }
+    qInfo() << "Exported" << result.rowCount << "rows of" << result.sensorCount << "sensors to" << filePath;
+    return true;
 }
 
 QString DataStorage::getStoragePath() const
@@ -26,6 +741,356 @@ QString DataStorage::getStoragePath() const
     return m_storagePath;
 }
 
+QString DataStorage::filePath(const QString& filename) const
+{
+    return filePath(filename, m_layout);
+}
+
+QString DataStorage::filePath(const QString& filename, StorageLayout layout) const
+{
+    return m_storagePath + QDir::separator() + (layout == StorageLayout::Sharded ? shardedFilePath(filename) : filename);
+}
+
+QString DataStorage::locateFile(const QString& filename) const
+{
+    const StorageLayout layout = m_layout;
+    const QString path = filePath(filename, layout);
+    if (QFile::exists(path)) {
+        return path;
+    }
+    const QString otherPath = filePath(filename, layout == StorageLayout::Flat ? StorageLayout::Sharded : StorageLayout::Flat);
+    return QFile::exists(otherPath) ? otherPath : path;
+}
+
+QString DataStorage::relativeFilePath(const QString& filename) const
+{
+    return m_layout == StorageLayout::Sharded ? shardedFilePath(filename) : filename;
+}
+
+void DataStorage::setLayout(StorageLayout layout)
+{
+    m_layout = layout;
+}
+
+StorageLayout DataStorage::layout() const
+{
+    return m_layout;
+}
+
+QFileInfoList DataStorage::cacheFiles(const QStringList& nameFilters) const
+{
+    QFileInfoList files = QDir(m_storagePath).entryInfoList(nameFilters, QDir::Files);
+    for (const CacheFilePattern& pattern : CacheFilePatterns) {
+        const QDir typeDir(m_storagePath + QDir::separator() + QLatin1String(pattern.directory));
+        if (!typeDir.exists()) {
+            continue;
+        }
+        for (const QString& shard : typeDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            files.append(QDir(typeDir.filePath(shard)).entryInfoList(nameFilters, QDir::Files));
+        }
+    }
+    return files;
+}
+
+void DataStorage::setChecksumsEnabled(bool enabled)
+{
+    m_checksumsEnabled = enabled;
+}
+
+bool DataStorage::checksumsEnabled() const
+{
+    return m_checksumsEnabled;
+}
+
+void DataStorage::setWriteBehindEnabled(bool enabled, int batchDelayMs)
+{
+    if (enabled && !m_writeQueue) {
+        m_writeQueue = std::make_unique<WriteBehindQueue>(WriteBehindQueue::DefaultCapacity, batchDelayMs);
+    } else if (!enabled && m_writeQueue) {
+        m_writeQueue->shutdown();
+        m_writeQueue.reset();
+    }
+}
+
+bool DataStorage::writeBehindEnabled() const
+{
+    return m_writeQueue != nullptr;
+}
+
+bool DataStorage::flush()
+{
+    return m_writeQueue ? m_writeQueue->flush() : true;
+}
+
+WriteBehindStats DataStorage::writeBehindStats() const
+{
+    return m_writeQueue ? m_writeQueue->stats() : WriteBehindStats();
+}
+
+quint32 DataStorage::checksum(const QByteArray& data, quint32 previous)
+{
+    // CRC-32 (wielomian 0xEDB88320, jak w zlib/PNG), tablica liczona przy pierwszym użyciu.
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = previous ^ 0xFFFFFFFFu;
+    for (const char byte : data) {
+        crc = table[(crc ^ static_cast<quint8>(byte)) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool DataStorage::writeFile(const QString& filename, const QByteArray& payload, bool userEditable) const
+{
+    QMutexLocker locker(&m_fileMutex);
+    return writeFileLocked(filename, payload, userEditable);
+}
+
+bool DataStorage::writeFileLocked(const QString& filename, const QByteArray& payload, bool userEditable) const
+{
+    const StorageLayout layout = m_layout;
+    const QString relativePath = layout == StorageLayout::Sharded ? shardedFilePath(filename) : filename;
+    if (relativePath != filename && !QDir(m_storagePath).mkpath(relativePath.left(relativePath.lastIndexOf('/')))) {
+        qWarning() << "Couldn't create shard directory for" << relativePath;
+        return false;
+    }
+
+    // QSaveFile zapisuje do pliku tymczasowego w tym samym katalogu, a commit() synchronizuje go z dyskiem
+    // i podmienia plik docelowy - przerwany zapis zostawia poprzednią wersję pliku zamiast uciętej.
+    QSaveFile file(filePath(filename, layout));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't open file for writing:" << file.fileName() << file.errorString();
+        return false;
+    }
+    QByteArray footer;
+    if (m_checksumsEnabled && !userEditable) {
+        footer = "\n" + QByteArray(ChecksumFooterPrefix)
+                 + QByteArray::number(checksum(payload), 16).rightJustified(8, '0')
+                 + " size:" + QByteArray::number(payload.size()) + "\n";
+    }
+    file.write(payload);
+    file.write(footer);
+    if (!file.commit()) {
+        qWarning() << "Couldn't write file:" << file.fileName() << file.errorString();
+        return false;
+    }
+    qDebug() << "Saved" << file.fileName();
+
+    // Kopia w drugim układzie (sprzed zmiany układu) jest już nieaktualna.
+    const QString otherPath = filePath(filename, layout == StorageLayout::Flat ? StorageLayout::Sharded : StorageLayout::Flat);
+    if (otherPath != file.fileName() && QFile::exists(otherPath)) {
+        QFile::remove(otherPath);
+    }
+
+    CacheEntry entry = describeCacheFile(filename);
+    describeCachePayload(entry, payload);
+    entry.size = payload.size() + footer.size();
+    entry.lastFetch = QDateTime::currentDateTime();
+    if (const std::optional<CacheEntry> previous = m_manifest.entry(filename)) {
+        entry.retained = previous->retained; // ponowny zapis (np. nowe dane z API) nie zdejmuje ochrony
+    }
+    m_manifest.update(entry);
+    return true;
+}
+
+bool DataStorage::submitWrite(const QString& filename, std::function<QByteArray()> serialize, bool userEditable)
+{
+    if (!m_writeQueue) {
+        return writeFile(filename, serialize(), userEditable);
+    }
+    return m_writeQueue->enqueue(filename, [this, filename, serialize = std::move(serialize), userEditable] {
+        return writeFile(filename, serialize(), userEditable);
+    });
+}
+
+std::optional<QByteArray> DataStorage::readFile(const QString& filename, bool userEditable) const
+{
+    if (m_writeQueue) {
+        m_writeQueue->flushKey(filename);
+    }
+    QByteArray data;
+    const ReadStatus status = readVerified(filename, userEditable, data);
+    if (status == ReadStatus::Ok) {
+        return data;
+    }
+    if (status == ReadStatus::Unreadable) {
+        return std::nullopt;
+    }
+    // Brak pliku lub zła suma kontrolna mogą wynikać z zapisu podmieniającego plik w trakcie odczytu -
+    // decyzja o usunięciu wpisu zapada dopiero po ponownym odczycie przy zablokowanym m_fileMutex.
+    QMutexLocker locker(&m_fileMutex);
+    return readFileContents(filename, userEditable);
+}
+
+std::optional<QByteArray> DataStorage::readFileContents(const QString& filename, bool userEditable) const
+{
+    QByteArray data;
+    switch (readVerified(filename, userEditable, data)) {
+    case ReadStatus::Ok:
+        return data;
+    case ReadStatus::Missing:
+        m_manifest.remove(filename); // plik usunięty poza DataStorage
+        return std::nullopt;
+    case ReadStatus::Corrupt:
+        // Uszkodzony wpis cache - po usunięciu z katalogu DataRepository pobierze dane ponownie z API.
+        quarantineFileLocked(filename);
+        return std::nullopt;
+    case ReadStatus::Unreadable:
+        break;
+    }
+    return std::nullopt;
+}
+
+DataStorage::ReadStatus DataStorage::readVerified(const QString& filename, bool userEditable, QByteArray& data) const
+{
+    QFile file(locateFile(filename));
+    if (!file.exists()) {
+        qInfo() << "File does not exist:" << file.fileName();
+        return ReadStatus::Missing;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Couldn't open file for reading:" << file.fileName() << file.errorString();
+        return ReadStatus::Unreadable;
+    }
+    data = file.readAll();
+    file.close();
+
+    // Stopka "\n#crc32:xxxxxxxx size:N\n" na końcu pliku; pliki bez stopki (starsze lub zapisane przy wyłączonych
+    // sumach kontrolnych) są wczytywane bez weryfikacji.
+    if (userEditable) {
+        return ReadStatus::Ok;
+    }
+    quint32 expectedCrc = 0;
+    const FooterState footer = stripChecksumFooter(data, expectedCrc);
+    if (footer == FooterState::Invalid || (footer == FooterState::Valid && checksum(data) != expectedCrc)) {
+        qWarning() << "Checksum mismatch in cache file:" << file.fileName();
+        return ReadStatus::Corrupt;
+    }
+    return ReadStatus::Ok;
+}
+
+void DataStorage::quarantineFileLocked(const QString& filename) const
+{
+    const QString path = locateFile(filename);
+    const QString quarantinePath = path + QLatin1String(QuarantineSuffix);
+    QFile::remove(quarantinePath); // starsza kopia tego samego pliku
+    if (QFile::rename(path, quarantinePath)) {
+        qWarning() << "Moved corrupted cache file to" << quarantinePath;
+    } else {
+        qWarning() << "Couldn't move corrupted cache file" << path << "- removing it";
+        QFile::remove(path);
+    }
+    m_manifest.remove(filename);
+}
+
+QDateTime DataStorage::getLastModified(const QString& filename) const
+{
+    if (m_writeQueue) {
+        m_writeQueue->flushKey(filename);
+    }
+    QFileInfo info(locateFile(filename));
+    if (!info.exists()) {
+        return QDateTime();
+    }
+    return info.lastModified();
+}
+
+QDateTime DataStorage::lastFetchTime(const QString& filename) const
+{
+    if (m_writeQueue) {
+        m_writeQueue->flushKey(filename);
+    }
+    const std::optional<CacheEntry> entry = m_manifest.entry(filename);
+    return entry ? entry->lastFetch : QDateTime();
+}
+
+bool DataStorage::markFetched(const QString& filename)
+{
+    QMutexLocker locker(&m_fileMutex); // wątek zapisu nie podmieni w tym czasie wpisu
+    std::optional<CacheEntry> entry = m_manifest.entry(filename);
+    if (!entry) {
+        return false;
+    }
+    entry->lastFetch = QDateTime::currentDateTime();
+    m_manifest.update(*entry);
+    return true;
+}
+
+std::vector<int> DataStorage::cachedIds(std::initializer_list<CacheEntityType> types) const
+{
+    const CacheManifest& manifest = cacheManifest();
+    std::vector<int> ids;
+    for (CacheEntityType type : types) {
+        for (const CacheEntry& entry : manifest.entries(type)) {
+            if (entry.id > 0) {
+                ids.push_back(entry.id);
+            }
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::vector<int> DataStorage::cachedSensorDataIds() const
+{
+    return cachedIds({CacheEntityType::SensorSeries, CacheEntityType::SensorData});
+}
+
+std::vector<int> DataStorage::cachedSensorsStationIds() const
+{
+    return cachedIds({CacheEntityType::Sensors});
+}
+
+QString DataStorage::stationsFileName()
+{
+    return QStringLiteral("stations.json");
+}
+
+QString DataStorage::sensorDataFileName(int sensorId)
+{
+    return QString("sensor_%1_data.json").arg(sensorId);
+}
+
+QString DataStorage::sensorSeriesFileName(int sensorId)
+{
+    return QString("sensor_%1_series.bin").arg(sensorId);
+}
+
+QString DataStorage::sensorsFileName(int stationId)
+{
+    return QString("station_%1_sensors.json").arg(stationId);
+}
+
+QString DataStorage::airQualityIndexFileName(int stationId)
+{
+    return QString("station_%1_aqi.json").arg(stationId);
+}
+
+QString DataStorage::forecastStateFileName(int sensorId)
+{
+    return QString("sensor_%1_forecast.json").arg(sensorId);
+}
+
+QString DataStorage::alertRulesFileName()
+{
+    return QStringLiteral("alert_rules.json");
+}
+
+QString DataStorage::alertStateFileName()
+{
+    return QStringLiteral("alert_state.json");
+}
+
 QJsonObject DataStorage::communeToJson(const Commune& commune) {
     QJsonObject obj;
     obj["communeName"] = commune.communeName;
@@ -36,9 +1101,9 @@ QJsonObject DataStorage::communeToJson(const Commune& commune) {
 
 Commune DataStorage::communeFromJson(const QJsonObject& obj) {
     Commune commune;
-    commune.communeName = obj["communeName"].toString();
-    commune.districtName = obj["districtName"].toString();
-    commune.provinceName = obj["provinceName"].toString();
+    commune.communeName = StringPool::intern(obj["communeName"].toString());
+    commune.districtName = StringPool::intern(obj["districtName"].toString());
+    commune.provinceName = StringPool::intern(obj["provinceName"].toString());
     return commune;
 }
 
@@ -54,7 +1119,7 @@ QJsonObject DataStorage::cityToJson(const City& city) {
 City DataStorage::cityFromJson(const QJsonObject& obj) {
     City city;
     city.id = obj["id"].toInt(-1);
-    city.name = obj["name"].toString();
+    city.name = StringPool::intern(obj["name"].toString());
     city.commune = communeFromJson(obj["commune"].toObject());
     city.addressStreet = obj["addressStreet"].toString();
     return city;
@@ -119,7 +1184,7 @@ QJsonObject DataStorage::sensorDataToJson(const SensorData& data) {
 
 SensorData DataStorage::sensorDataFromJson(const QJsonObject& obj) {
     SensorData data;
-    data.key = obj["key"].toString();
+    data.key = StringPool::intern(obj["key"].toString());
     QJsonArray valuesArray = obj["values"].toArray();
     for(const QJsonValue& val : valuesArray) {
         if (val.isObject()) {
@@ -130,41 +1195,23 @@ SensorData DataStorage::sensorDataFromJson(const QJsonObject& obj) {
 }
 
 bool DataStorage::saveStationsToJson(const std::vector<MeasuringStation>& stations, const QString& filename) {
-    QJsonArray stationsArray;
-    for (const auto& station : stations) {
-        stationsArray.append(stationToJson(station));
-    }
-    QJsonDocument doc(stationsArray);
-
-    QFile file(m_storagePath + QDir::separator() + filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for writing:" << file.fileName() << file.errorString();
-        return false;
-    }
-    file.write(doc.toJson());
-    file.close();
-    qDebug() << "Stations saved to" << file.fileName();
-    return true;
+    return submitWrite(filename, [this, stations] {
+        QJsonArray stationsArray;
+        for (const auto& station : stations) {
+            stationsArray.append(stationToJson(station));
+        }
+        return QJsonDocument(stationsArray).toJson();
+    });
 }
 
 std::vector<MeasuringStation> DataStorage::loadStationsFromJson(const QString& filename) {
     std::vector<MeasuringStation> stations;
-    QFile file(m_storagePath + QDir::separator() + filename);
-
-    if (!file.exists()) {
-        qInfo() << "Stations file does not exist:" << file.fileName();
+    const std::optional<QByteArray> jsonData = readFile(filename);
+    if (!jsonData) {
         return stations;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for reading:" << file.fileName() << file.errorString();
-        return stations;
-    }
-
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
     if (!doc.isArray()) {
         qWarning() << "Error parsing stations JSON: Not an array.";
         return stations;
@@ -176,7 +1223,7 @@ std::vector<MeasuringStation> DataStorage::loadStationsFromJson(const QString& f
             stations.push_back(stationFromJson(value.toObject()));
         }
     }
-    qDebug() << "Stations loaded from" << file.fileName() << "- Count:" << stations.size();
+    qDebug() << "Stations loaded from" << filePath(filename) << "- Count:" << stations.size();
     return stations;
 }
 
@@ -185,68 +1232,156 @@ bool DataStorage::saveSensorDataToJson(const SensorData& data, const QString& fi
         qWarning() << "Cannot save empty SensorData (no key).";
         return false;
     }
-    QJsonDocument doc(sensorDataToJson(data));
-
-    QFile file(m_storagePath + QDir::separator() + filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for writing:" << file.fileName() << file.errorString();
-        return false;
-    }
-    file.write(doc.toJson());
-    file.close();
-    qDebug() << "Sensor data saved to" << file.fileName();
-    return true;
+    return submitWrite(filename, [this, data] {
+        return QJsonDocument(sensorDataToJson(data)).toJson();
+    });
 }
 
 SensorData DataStorage::loadSensorDataFromJson(const QString& filename) {
     SensorData data;
-    QFile file(m_storagePath + QDir::separator() + filename);
-
-    if (!file.exists()) {
-        qInfo() << "Sensor data file does not exist:" << file.fileName();
-        return data;
-    }
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for reading:" << file.fileName() << file.errorString();
+    const std::optional<QByteArray> jsonData = readFile(filename);
+    if (!jsonData) {
         return data;
     }
 
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
     if (!doc.isObject()) {
         qWarning() << "Error parsing sensor data JSON: Not an object.";
         return data;
     }
 
     data = sensorDataFromJson(doc.object());
-    qDebug() << "Sensor data loaded from" << file.fileName() << "- Key:" << data.key << "Values:" << data.values.size();
+    qDebug() << "Sensor data loaded from" << filePath(filename) << "- Key:" << data.key << "Values:" << data.values.size();
     return data;
 }
 
-bool DataStorage::saveSensorsToJson(int stationId, const std::vector<Sensor>& sensors) {
-    if (stationId <= 0) {
-        qWarning() << "Cannot save sensors, invalid stationId:" << stationId;
+bool DataStorage::saveSensorSeries(int sensorId, const SensorData& data) {
+    if (sensorId <= 0 || data.key.isEmpty()) {
+        qWarning() << "Cannot save sensor series, invalid sensorId or empty key:" << sensorId;
         return false;
     }
-    QString filename = QString("station_%1_sensors.json").arg(stationId);
-    QJsonArray sensorsArray;
-    for (const auto& sensor : sensors) {
-        sensorsArray.append(sensorToJson(sensor));
+    return submitWrite(sensorSeriesFileName(sensorId), [data] {
+        return SeriesCodec::encode(data);
+    });
+}
+
+std::optional<SensorData> DataStorage::mergeSensorSeries(int sensorId, const SensorData& data, SeriesMergePolicy policy,
+                                                         SeriesMergeStats* stats) {
+    if (sensorId <= 0) {
+        qWarning() << "Cannot merge sensor series, invalid sensorId:" << sensorId;
+        return std::nullopt;
     }
-    QJsonDocument doc(sensorsArray);
+    std::vector<MeasurementValue> incoming;
+    incoming.reserve(data.values.size());
+    std::copy_if(data.values.begin(), data.values.end(), std::back_inserter(incoming),
+                 [](const MeasurementValue& mv) { return mv.date.isValid(); });
+    // Stabilnie - przy powtórzonej dacie w `data` liczy się pierwszy pomiar.
+    std::stable_sort(incoming.begin(), incoming.end(), [](const MeasurementValue& a, const MeasurementValue& b) {
+        return a.date < b.date;
+    });
+
+    QMutexLocker seriesLocker(&m_seriesLocks[static_cast<std::size_t>(sensorId % SeriesLockCount)]);
+    SensorData current = loadCachedSensorData(sensorId);
+    const bool hadSeries = !current.key.isEmpty();
+    if (current.key.isEmpty()) {
+        current.key = data.key;
+    }
+    if (current.key.isEmpty() || (!data.key.isEmpty() && data.key != current.key)) {
+        qWarning() << "Cannot merge sensor series" << sensorId << "- parameter" << data.key
+                   << "differs from cached or is unknown:" << current.key;
+        return std::nullopt;
+    }
+    std::stable_sort(current.values.begin(), current.values.end(),
+                     [](const MeasurementValue& a, const MeasurementValue& b) { return a.date < b.date; });
+
+    // Scalanie dwóch posortowanych ciągów; powtórzona data w `incoming` po pierwszym wystąpieniu jest pomijana.
+    SeriesMergeStats result;
+    std::vector<MeasurementValue> merged;
+    merged.reserve(current.values.size() + incoming.size());
+    auto in = incoming.cbegin();
+    auto appendNew = [&](const MeasurementValue& mv) {
+        if (merged.empty() || merged.back().date != mv.date) {
+            merged.push_back(mv);
+            result.added++;
+        } else {
+            result.unchanged++;
+        }
+    };
+    for (const MeasurementValue& mv : current.values) {
+        while (in != incoming.cend() && in->date < mv.date) {
+            appendNew(*in++);
+        }
+        merged.push_back(mv);
+        bool matched = false;
+        for (; in != incoming.cend() && in->date == mv.date; ++in) {
+            MeasurementValue& kept = merged.back();
+            if (matched || std::isnan(in->value) || kept.value == in->value) {
+                result.unchanged++;
+            } else if (std::isnan(kept.value)) {
+                kept.value = in->value;
+                result.added++;
+            } else if (policy == SeriesMergePolicy::PreferIncoming) {
+                kept.value = in->value;
+                result.replaced++;
+            } else {
+                result.unchanged++;
+            }
+            matched = true;
+        }
+    }
+    while (in != incoming.cend()) {
+        appendNew(*in++);
+    }
+    current.values = std::move(merged);
 
-    QFile file(m_storagePath + QDir::separator() + filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for writing:" << file.fileName() << file.errorString();
+    if (stats) {
+        *stats = result;
+    }
+    if ((result.added > 0 || result.replaced > 0 || !hadSeries) && !saveSensorSeries(sensorId, current)) {
+        return std::nullopt;
+    }
+    return current;
+}
+
+SensorData DataStorage::loadSensorSeries(int sensorId, const QDateTime& from, const QDateTime& to) {
+    if (sensorId <= 0) {
+        qWarning() << "Cannot load sensor series, invalid sensorId:" << sensorId;
+        return SensorData();
+    }
+    const QString filename = sensorSeriesFileName(sensorId);
+    const std::optional<QByteArray> bytes = readFile(filename);
+    if (!bytes) {
+        return SensorData();
+    }
+    std::optional<SensorData> data = SeriesCodec::decode(*bytes, from, to);
+    if (!data) {
+        qWarning() << "Error decoding sensor series:" << filePath(filename);
+        return SensorData();
+    }
+    data->key = StringPool::intern(data->key);
+    qDebug() << "Sensor series loaded from" << filePath(filename) << "- Key:" << data->key << "Values:" << data->values.size();
+    return *data;
+}
+
+SensorData DataStorage::loadCachedSensorData(int sensorId) {
+    if (sensorId > 0 && getLastModified(sensorSeriesFileName(sensorId)).isValid()) {
+        return loadSensorSeries(sensorId);
+    }
+    return loadSensorDataFromJson(sensorDataFileName(sensorId));
+}
+
+bool DataStorage::saveSensorsToJson(int stationId, const std::vector<Sensor>& sensors) {
+    if (stationId <= 0) {
+        qWarning() << "Cannot save sensors, invalid stationId:" << stationId;
         return false;
     }
-    file.write(doc.toJson());
-    file.close();
-    qDebug() << "Sensors for station" << stationId << "saved to" << file.fileName();
-    return true;
+    return submitWrite(sensorsFileName(stationId), [this, sensors] {
+        QJsonArray sensorsArray;
+        for (const auto& sensor : sensors) {
+            sensorsArray.append(sensorToJson(sensor));
+        }
+        return QJsonDocument(sensorsArray).toJson();
+    });
 }
 
 std::vector<Sensor> DataStorage::loadSensorsFromJson(int stationId) {
@@ -255,23 +1390,13 @@ std::vector<Sensor> DataStorage::loadSensorsFromJson(int stationId) {
         qWarning() << "Cannot load sensors, invalid stationId:" << stationId;
         return sensors;
     }
-    QString filename = QString("station_%1_sensors.json").arg(stationId);
-    QFile file(m_storagePath + QDir::separator() + filename);
-
-    if (!file.exists()) {
-        qInfo() << "Sensors file does not exist for station" << stationId << ":" << file.fileName();
+    QString filename = sensorsFileName(stationId);
+    const std::optional<QByteArray> jsonData = readFile(filename);
+    if (!jsonData) {
         return sensors;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for reading:" << file.fileName() << file.errorString();
-        return sensors;
-    }
-
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
     if (!doc.isArray()) {
         qWarning() << "Error parsing sensors JSON for station" << stationId << ": Not an array.";
         return sensors;
@@ -288,7 +1413,7 @@ std::vector<Sensor> DataStorage::loadSensorsFromJson(int stationId) {
             }
         }
     }
-    qDebug() << "Sensors for station" << stationId << "loaded from" << file.fileName() << "- Count:" << sensors.size();
+    qDebug() << "Sensors for station" << stationId << "loaded from" << filePath(filename) << "- Count:" << sensors.size();
     return sensors;
 }
 
@@ -303,9 +1428,9 @@ QJsonObject DataStorage::parameterToJson(const Parameter& param) {
 
 Parameter DataStorage::parameterFromJson(const QJsonObject& obj) {
     Parameter param;
-    param.paramName = obj["paramName"].toString();
-    param.paramFormula = obj["paramFormula"].toString();
-    param.paramCode = obj["paramCode"].toString();
+    param.paramName = StringPool::intern(obj["paramName"].toString());
+    param.paramFormula = StringPool::intern(obj["paramFormula"].toString());
+    param.paramCode = StringPool::intern(obj["paramCode"].toString());
     param.idParam = obj["idParam"].toInt(-1);
     return param;
 }
@@ -326,20 +1451,6 @@ Sensor DataStorage::sensorFromJson(const QJsonObject& obj) {
     return sensor;
 }
 
-QJsonObject DataStorage::indexLevelToJson(const IndexLevel& level) {
-    QJsonObject obj;
-    obj["id"] = level.id;
-    obj["indexLevelName"] = level.indexLevelName;
-    return obj;
-}
-
-IndexLevel DataStorage::indexLevelFromJson(const QJsonObject& obj) {
-    IndexLevel level;
-    level.id = obj["id"].toInt(-1);
-    level.indexLevelName = obj["indexLevelName"].toString("N/A");
-    return level;
-}
-
 QJsonObject DataStorage::airQualityIndexToJson(const AirQualityIndex& index) {
     QJsonObject obj;
     obj["stationId"] = index.stationId;
@@ -347,14 +1458,12 @@ QJsonObject DataStorage::airQualityIndexToJson(const AirQualityIndex& index) {
     obj["stCalcDate"] = index.stCalcDate.isValid() ? index.stCalcDate.toString(Qt::ISODateWithMs) : QJsonValue();
     obj["stSourceDataDate"] = index.stSourceDataDate.isValid() ? index.stSourceDataDate.toString(Qt::ISODateWithMs) : QJsonValue();
 
-    obj["stIndexLevel"] = indexLevelToJson(index.stIndexLevel);
-    obj["so2IndexLevel"] = indexLevelToJson(index.so2IndexLevel);
-    obj["no2IndexLevel"] = indexLevelToJson(index.no2IndexLevel);
-    obj["coIndexLevel"] = indexLevelToJson(index.coIndexLevel);
-    obj["pm10IndexLevel"] = indexLevelToJson(index.pm10IndexLevel);
-    obj["pm25IndexLevel"] = indexLevelToJson(index.pm25IndexLevel);
-    obj["o3IndexLevel"] = indexLevelToJson(index.o3IndexLevel);
-    obj["c6h6IndexLevel"] = indexLevelToJson(index.c6h6IndexLevel);
+    obj["stIndexLevel"] = static_cast<int>(index.stIndexLevel);
+    QJsonArray levels;
+    for (qint8 level : index.pollutantLevels) {
+        levels.append(static_cast<int>(level));
+    }
+    obj["levels"] = levels;
     return obj;
 }
 
@@ -385,14 +1494,18 @@ AirQualityIndex DataStorage::airQualityIndexFromJson(const QJsonObject& obj) {
         }
     }
 
-    index.stIndexLevel = indexLevelFromJson(obj["stIndexLevel"].toObject());
-    index.so2IndexLevel = indexLevelFromJson(obj["so2IndexLevel"].toObject());
-    index.no2IndexLevel = indexLevelFromJson(obj["no2IndexLevel"].toObject());
-    index.coIndexLevel = indexLevelFromJson(obj["coIndexLevel"].toObject());
-    index.pm10IndexLevel = indexLevelFromJson(obj["pm10IndexLevel"].toObject());
-    index.pm25IndexLevel = indexLevelFromJson(obj["pm25IndexLevel"].toObject());
-    index.o3IndexLevel = indexLevelFromJson(obj["o3IndexLevel"].toObject());
-    index.c6h6IndexLevel = indexLevelFromJson(obj["c6h6IndexLevel"].toObject());
+    // Format zwarty: ID poziomów ("stIndexLevel" i tablica "levels" w kolejności enum Pollutant).
+    // Starsze pliki zawierają obiekty {"id", "indexLevelName"} pod kluczami z PollutantIndexKeys.
+    const QJsonValue stLevel = obj["stIndexLevel"];
+    index.stIndexLevel = toIndexLevel(stLevel.isObject() ? stLevel.toObject()["id"].toInt(NoIndexLevel)
+                                                         : stLevel.toInt(NoIndexLevel));
+    const QJsonArray levels = obj["levels"].toArray();
+    for (std::size_t p = 0; p < PollutantCount; ++p) {
+        const int level = obj.contains("levels")
+                              ? levels.at(static_cast<int>(p)).toInt(NoIndexLevel)
+                              : obj[QLatin1String(PollutantIndexKeys[p])].toObject()["id"].toInt(NoIndexLevel);
+        index.pollutantLevels[p] = toIndexLevel(level);
+    }
     return index;
 }
 
@@ -401,18 +1514,9 @@ bool DataStorage::saveAirQualityIndexToJson(int stationId, const AirQualityIndex
         qWarning() << "Cannot save AQI, invalid stationId or mismatch:" << stationId << "vs" << index.stationId;
         return false;
     }
-    QString filename = QString("station_%1_aqi.json").arg(stationId);
-    QJsonDocument doc(airQualityIndexToJson(index));
-
-    QFile file(m_storagePath + QDir::separator() + filename);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for writing:" << file.fileName() << file.errorString();
-        return false;
-    }
-    file.write(doc.toJson());
-    file.close();
-    qDebug() << "AQI for station" << stationId << "saved to" << file.fileName();
-    return true;
+    return submitWrite(airQualityIndexFileName(stationId), [this, index] {
+        return QJsonDocument(airQualityIndexToJson(index)).toJson();
+    });
 }
 
 AirQualityIndex DataStorage::loadAirQualityIndexFromJson(int stationId) {
@@ -421,23 +1525,13 @@ AirQualityIndex DataStorage::loadAirQualityIndexFromJson(int stationId) {
         qWarning() << "Cannot load AQI, invalid stationId:" << stationId;
         return index;
     }
-    QString filename = QString("station_%1_aqi.json").arg(stationId);
-    QFile file(m_storagePath + QDir::separator() + filename);
-
-    if (!file.exists()) {
-        qInfo() << "AQI file does not exist for station" << stationId << ":" << file.fileName();
+    QString filename = airQualityIndexFileName(stationId);
+    const std::optional<QByteArray> jsonData = readFile(filename);
+    if (!jsonData) {
         return index;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open file for reading:" << file.fileName() << file.errorString();
-        return index;
-    }
-
-    QByteArray jsonData = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData);
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
     if (!doc.isObject()) {
         qWarning() << "Error parsing AQI JSON for station" << stationId << ": Not an object.";
         return index;
@@ -450,6 +1544,228 @@ AirQualityIndex DataStorage::loadAirQualityIndexFromJson(int stationId) {
         return index;
     }
 
-    qDebug() << "AQI for station" << stationId << "loaded from" << file.fileName();
+    qDebug() << "AQI for station" << stationId << "loaded from" << filePath(filename);
     return index;
 }
+
+namespace {
+
+QJsonArray doublesToJson(const std::vector<double>& values)
+{
+    QJsonArray array;
+    for (double v : values) {
+        array.append(std::isnan(v) ? QJsonValue() : QJsonValue(v));
+    }
+    return array;
+}
+
+std::vector<double> doublesFromJson(const QJsonArray& array)
+{
+    std::vector<double> values;
+    values.reserve(static_cast<size_t>(array.size()));
+    for (const QJsonValue& v : array) {
+        values.push_back(v.isDouble() ? v.toDouble() : std::numeric_limits<double>::quiet_NaN());
+    }
+    return values;
+}
+
+} // namespace
+
+QJsonObject DataStorage::forecastStateToJson(const ForecastState& state) {
+    QJsonObject obj;
+    obj["sensorId"] = state.sensorId;
+    obj["seasonLength"] = state.seasonLength;
+    obj["alpha"] = state.alpha;
+    obj["beta"] = state.beta;
+    obj["gamma"] = state.gamma;
+    obj["phi"] = state.phi;
+    obj["level"] = state.level;
+    obj["trend"] = state.trend;
+    obj["seasonal"] = doublesToJson(state.seasonal);
+    obj["seasonIndex"] = state.seasonIndex;
+    // ms od epoki (liczba całkowita < 2^53, więc dokładna w JSON) - bez niejednoznaczności czasu lokalnego przy zmianie czasu
+    obj["lastStepMSecs"] = state.lastStepMSecs == std::numeric_limits<qint64>::min()
+                               ? QJsonValue()
+                               : QJsonValue(static_cast<double>(state.lastStepMSecs));
+    obj["warmup"] = doublesToJson(state.warmup);
+    obj["observationCount"] = static_cast<double>(state.observationCount);
+    obj["errorVariance"] = std::isnan(state.errorVariance) ? QJsonValue() : QJsonValue(state.errorVariance);
+    return obj;
+}
+
+ForecastState DataStorage::forecastStateFromJson(const QJsonObject& obj) {
+    ForecastState state;
+    state.sensorId = obj["sensorId"].toInt(-1);
+    state.seasonLength = obj["seasonLength"].toInt(state.seasonLength);
+    state.alpha = obj["alpha"].toDouble(state.alpha);
+    state.beta = obj["beta"].toDouble(state.beta);
+    state.gamma = obj["gamma"].toDouble(state.gamma);
+    state.phi = obj["phi"].toDouble(state.phi);
+    state.level = obj["level"].toDouble(0.0);
+    state.trend = obj["trend"].toDouble(0.0);
+    state.seasonal = doublesFromJson(obj["seasonal"].toArray());
+    state.seasonIndex = obj["seasonIndex"].toInt(0);
+
+    const QJsonValue lastStep = obj["lastStepMSecs"];
+    if (lastStep.isDouble()) {
+        state.lastStepMSecs = static_cast<qint64>(lastStep.toDouble());
+    }
+    state.warmup = doublesFromJson(obj["warmup"].toArray());
+    state.observationCount = static_cast<quint64>(obj["observationCount"].toDouble(0.0));
+    const QJsonValue variance = obj["errorVariance"];
+    state.errorVariance = variance.isDouble() ? variance.toDouble() : std::numeric_limits<double>::quiet_NaN();
+    return state;
+}
+
+bool DataStorage::saveForecastState(const ForecastState& state) {
+    if (state.sensorId <= 0) {
+        qWarning() << "Cannot save forecast state, invalid sensorId:" << state.sensorId;
+        return false;
+    }
+    return submitWrite(forecastStateFileName(state.sensorId), [this, state] {
+        return QJsonDocument(forecastStateToJson(state)).toJson(QJsonDocument::Compact);
+    });
+}
+
+ForecastState DataStorage::loadForecastState(int sensorId) {
+    ForecastState state;
+    if (sensorId <= 0) {
+        qWarning() << "Cannot load forecast state, invalid sensorId:" << sensorId;
+        return state;
+    }
+    const std::optional<QByteArray> jsonData = readFile(forecastStateFileName(sensorId));
+    if (!jsonData) {
+        return state;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
+    if (!doc.isObject()) {
+        qWarning() << "Error parsing forecast state JSON for sensor" << sensorId << ": Not an object.";
+        return state;
+    }
+
+    state = forecastStateFromJson(doc.object());
+    if (state.sensorId != sensorId) {
+        qWarning() << "Loaded forecast state has mismatching sensorId" << state.sensorId;
+        return ForecastState();
+    }
+    return state;
+}
+
+QJsonObject DataStorage::alertRuleToJson(const AlertRule& rule) {
+    QJsonObject obj;
+    obj["id"] = rule.id;
+    obj["name"] = rule.name;
+    obj["enabled"] = rule.enabled;
+    obj["source"] = rule.source == AlertSource::AirQualityIndex ? "aqi" : "measurement";
+    obj["paramCode"] = rule.paramCode;
+    obj["sensorId"] = rule.sensorId;
+    obj["stationId"] = rule.stationId;
+    obj["provinceName"] = rule.provinceName;
+    obj["windowHours"] = rule.windowHours;
+    obj["minCoverage"] = rule.minCoverage;
+    obj["comparison"] = rule.comparison == AlertComparison::GreaterOrEqual ? ">=" : ">";
+    obj["threshold"] = rule.threshold;
+    obj["clearThreshold"] = std::isnan(rule.clearThreshold) ? QJsonValue() : QJsonValue(rule.clearThreshold);
+    return obj;
+}
+
+AlertRule DataStorage::alertRuleFromJson(const QJsonObject& obj) {
+    AlertRule rule;
+    rule.id = obj["id"].toInt(-1);
+    rule.name = obj["name"].toString();
+    rule.enabled = obj["enabled"].toBool(true);
+    rule.source = obj["source"].toString() == "aqi" ? AlertSource::AirQualityIndex : AlertSource::Measurement;
+    rule.paramCode = obj["paramCode"].toString();
+    rule.sensorId = obj["sensorId"].toInt(-1);
+    rule.stationId = obj["stationId"].toInt(-1);
+    rule.provinceName = obj["provinceName"].toString();
+    rule.windowHours = obj["windowHours"].toInt(0);
+    rule.minCoverage = obj["minCoverage"].toDouble(rule.minCoverage);
+    rule.comparison = obj["comparison"].toString() == ">=" ? AlertComparison::GreaterOrEqual : AlertComparison::Greater;
+    rule.threshold = obj["threshold"].toDouble(0.0);
+    const QJsonValue clearThreshold = obj["clearThreshold"];
+    rule.clearThreshold = clearThreshold.isDouble() ? clearThreshold.toDouble() : std::numeric_limits<double>::quiet_NaN();
+    if (rule.clearThreshold > rule.threshold) {
+        qWarning() << "Alert rule" << rule.id << rule.name << "has clearThreshold" << rule.clearThreshold
+                   << "above threshold" << rule.threshold << "- clamping to threshold.";
+        rule.clearThreshold = rule.threshold;
+    }
+    return rule;
+}
+
+bool DataStorage::saveAlertRules(const std::vector<AlertRule>& rules, const QString& filename) {
+    return submitWrite(filename, [this, rules] {
+        QJsonArray rulesArray;
+        for (const AlertRule& rule : rules) {
+            rulesArray.append(alertRuleToJson(rule));
+        }
+        return QJsonDocument(rulesArray).toJson();
+    }, true);
+}
+
+std::vector<AlertRule> DataStorage::loadAlertRules(const QString& filename) {
+    std::vector<AlertRule> rules;
+    const std::optional<QByteArray> jsonData = readFile(filename, true);
+    if (!jsonData) {
+        return rules;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
+    if (!doc.isArray()) {
+        qWarning() << "Error parsing alert rules JSON: Not an array.";
+        return rules;
+    }
+
+    for (const QJsonValue& value : doc.array()) {
+        if (value.isObject()) {
+            rules.push_back(alertRuleFromJson(value.toObject()));
+        }
+    }
+    qDebug() << "Alert rules loaded from" << filePath(filename) << "- Count:" << rules.size();
+    return rules;
+}
+
+bool DataStorage::saveAlertProgress(const AlertProgress& progress) {
+    return submitWrite(alertStateFileName(), [progress] {
+        auto toJson = [](const QHash<int, qint64>& dates) {
+            QJsonObject obj;
+            for (auto it = dates.constBegin(); it != dates.constEnd(); ++it) {
+                obj[QString::number(it.key())] = static_cast<double>(it.value());
+            }
+            return obj;
+        };
+        QJsonObject obj;
+        obj["sensors"] = toJson(progress.sensors);
+        obj["stations"] = toJson(progress.stations);
+        return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    });
+}
+
+AlertProgress DataStorage::loadAlertProgress() {
+    AlertProgress progress;
+    const std::optional<QByteArray> jsonData = readFile(alertStateFileName());
+    if (!jsonData) {
+        return progress;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(*jsonData);
+    if (!doc.isObject()) {
+        qWarning() << "Error parsing alert state JSON: Not an object.";
+        return progress;
+    }
+
+    auto fromJson = [](const QJsonObject& obj, QHash<int, qint64>& dates) {
+        for (const QString& key : obj.keys()) {
+            bool ok = false;
+            const int id = key.toInt(&ok);
+            const QJsonValue msecs = obj.value(key);
+            if (ok && id > 0 && msecs.isDouble()) {
+                dates.insert(id, static_cast<qint64>(msecs.toDouble()));
+            }
+        }
+    };
+    fromJson(doc.object()["sensors"].toObject(), progress.sensors);
+    fromJson(doc.object()["stations"].toObject(), progress.stations);
+    return progress;
+}
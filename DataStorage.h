@@ -5,13 +5,114 @@
 #ifndef DATASTORAGE_H
 #define DATASTORAGE_H
 
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QString>
+#include <QStringList>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 #include "DataStructures.h" // Potrzebne struktury danych
+#include "HoltWintersForecaster.h" // ForecastState
+#include "AlertEngine.h" // AlertRule, AlertProgress
+#include "AqiHistoryStore.h"
+#include "CacheManifest.h"
+#include "TableWriter.h"
+#include "WriteBehindQueue.h"
 
 class QJsonObject;
 class QJsonArray;
 
+/**
+ * @enum StorageLayout
+ * @brief Układ plików cache w katalogu przechowywania.
+ */
+enum class StorageLayout {
+    Flat,   ///< Wszystkie pliki bezpośrednio w katalogu przechowywania.
+    Sharded ///< Pliki z ID w nazwie w podkatalogach wg rodzaju danych i prefiksu ID, np. "series/12/sensor_1234_series.bin".
+};
+
+/**
+ * @struct RetentionPolicy
+ * @brief Zasady usuwania starych danych z cache przez DataStorage::compact().
+ */
+struct RetentionPolicy {
+    int maxAgeDays = 0;         ///< Pliki nieodświeżane dłużej, pomiary i indeksy AQI starsze niż tyle dni są usuwane (0 - bez limitu).
+    qint64 diskBudgetBytes = 0; ///< Limit rozmiaru cache; ponad nim usuwane są najdawniej pobrane pliki (0 - bez limitu).
+    // Serie chronione przez DataStorage::setSeriesRetained() nie podlegają żadnemu z limitów.
+};
+
+/**
+ * @struct CompactionStats
+ * @brief Wynik przebiegu DataStorage::compact().
+ */
+struct CompactionStats {
+    int filesRemoved = 0;             ///< Usunięte pliki (przeterminowane, ponad limit rozmiaru lub uszkodzone).
+    int filesRewritten = 0;           ///< Serie przepisane bez starych pomiarów lub ze scalonymi blokami.
+    qint64 historyRecordsRemoved = 0; ///< Usunięte rekordy historii indeksów AQI.
+    qint64 bytesBefore = 0;           ///< Rozmiar cache (z historią AQI) przed przebiegiem.
+    qint64 bytesAfter = 0;            ///< Rozmiar cache (z historią AQI) po przebiegu.
+};
+
+/**
+ * @enum SeriesMergePolicy
+ * @brief Która wartość zostaje, gdy scalany pomiar ma datę zapisaną już w serii (DataStorage::mergeSensorSeries()).
+ */
+enum class SeriesMergePolicy {
+    KeepExisting,  ///< Zostaje wartość z cache (chyba że jest NaN) - import archiwum nie nadpisuje danych.
+    PreferIncoming ///< Nowa wartość zastępuje zapisaną (chyba że jest NaN) - poprawione wartości z API.
+};
+
+/**
+ * @struct SeriesMergeStats
+ * @brief Wynik DataStorage::mergeSensorSeries().
+ */
+struct SeriesMergeStats {
+    quint64 added = 0;     ///< Pomiary z nową datą i wartości NaN w cache uzupełnione nową wartością.
+    quint64 replaced = 0;  ///< Wartości w cache zastąpione innymi (tylko SeriesMergePolicy::PreferIncoming).
+    quint64 unchanged = 0; ///< Pomiary, które nie zmieniły serii (ta sama lub zachowana wartość, powtórzona data).
+};
+
+/**
+ * @enum ExportLayout
+ * @brief Układ tabeli eksportu danych pomiarowych.
+ */
+enum class ExportLayout {
+    Long, ///< Wiersz na pomiar: sensor_id, param, timestamp, value.
+    Wide  ///< Wiersz na datę: timestamp i kolumna "{param}_{sensorId}" dla każdego czujnika (brak pomiaru - pusta wartość).
+};
+
+/**
+ * @struct ExportOptions
+ * @brief Ustawienia DataStorage::exportSensorSeries().
+ */
+struct ExportOptions {
+    ExportFormat format = ExportFormat::Csv;  ///< Format pliku.
+    ExportLayout layout = ExportLayout::Long; ///< Układ tabeli.
+    QDateTime from;                           ///< Początek przedziału dat (włącznie); nieprawidłowa - bez ograniczenia.
+    QDateTime to;                             ///< Koniec przedziału dat (wyłącznie); nieprawidłowa - bez ograniczenia.
+};
+
+/**
+ * @struct ExportStats
+ * @brief Wynik DataStorage::exportSensorSeries().
+ */
+struct ExportStats {
+    int sensorCount = 0;     ///< Czujniki z danymi w przedziale dat.
+    quint64 rowCount = 0;    ///< Zapisane wiersze.
+    qint64 bytesWritten = 0; ///< Rozmiar pliku w bajtach.
+    quint64 blocksRead = 0;  ///< Bloki serii odczytane z dysku.
+    quint64 peakBufferedPoints = 0; ///< Największa liczba odczytanych, jeszcze niezapisanych pomiarów naraz.
+};
+
 /**
  * @class DataStorage
  * @brief Zapewnia mechanizmy do trwałego przechowywania danych aplikacji (stacje, czujniki, dane pomiarowe, AQI) w plikach JSON.
@@ -19,6 +120,25 @@ class QJsonArray;
  * Umożliwia zapisywanie i wczytywanie danych, co pozwala na działanie aplikacji w trybie offline
  * lub jako fallback w przypadku problemów z dostępem do API. Pliki są zapisywane w określonym
  * katalogu przechowywania (`storagePath`).
+ *
+ * Każdy zapis jest atomowy (QSaveFile: plik tymczasowy, synchronizacja z dyskiem i podmiana pliku), więc awaria
+ * w trakcie zapisu zostawia poprzednią wersję pliku. Pliki cache mają dodatkowo stopkę z sumą kontrolną CRC-32
+ * i długością danych; plik z niezgodną stopką jest przy odczycie usuwany i traktowany jak brak danych, dzięki czemu
+ * DataRepository pobiera je ponownie z API zamiast parsować uszkodzoną zawartość.
+ *
+ * Po włączeniu zapisu w tle (setWriteBehindEnabled()) metody save* sprawdzają tylko argumenty i przekazują
+ * serializację oraz zapis pliku do WriteBehindQueue - wątek wywołujący (GUI, obsługa odpowiedzi API) nie czeka na dysk,
+ * a kolejne zapisy tego samego pliku, które nie zdążyły trafić na dysk, są scalane. Odczyt pliku (load*,
+ * getLastModified(), lastFetchTime(), cached*Ids()) czeka najpierw na zaległy zapis, więc zawsze widzi ostatnio zlecone dane.
+ *
+ * Każdy zapisany plik jest opisany w katalogu cache (CacheManifest: rozmiar, zakres dat serii, czas zapisu, wersja
+ * formatu, suma kontrolna), więc pytanie "co mamy offline" nie wymaga otwierania plików. Jeśli katalogu nie ma,
+ * konstruktor odbudowuje go jednorazowo z plików w katalogu przechowywania.
+ *
+ * W układzie StorageLayout::Sharded pliki czujników i stacji trafiają do podkatalogów (rodzaj danych / ID / IdsPerShard),
+ * więc żaden katalog nie rośnie do tysięcy plików. Odczyt znajduje plik w obu układach (np. pliki zapisane przed zmianą
+ * układu), a zapis usuwa kopię w drugim układzie. compact() usuwa dane według RetentionPolicy i scala bloki serii;
+ * można go wywoływać w wątku roboczym równolegle z odczytami i zapisami.
  */
 class DataStorage
 {
@@ -30,6 +150,9 @@ public:
      */
     DataStorage(const QString& storagePath = ".");
 
+    /** @brief Destruktor; wykonuje zaległe zapisy w tle przed zamknięciem. */
+    ~DataStorage();
+
     /**
      * @brief Zapisuje wektor stacji pomiarowych do pliku JSON.
      * @param stations Wektor obiektów MeasuringStation do zapisania.
@@ -60,6 +183,45 @@ public:
      */
     SensorData loadSensorDataFromJson(const QString& filename);
 
+    /**
+     * @brief Zapisuje dane pomiarowe czujnika w skompresowanym formacie binarnym (SeriesCodec).
+     * Nazwa pliku jest generowana automatycznie jako "sensor_{sensorId}_series.bin"; zajmuje kilka bajtów na pomiar.
+     * @param sensorId ID czujnika.
+     * @param data Dane do zapisania.
+     * @return `true` jeśli zapis się powiódł, `false` jeśli `sensorId` jest nieprawidłowe, `data.key` jest pusty
+     *         lub wystąpił błąd zapisu.
+     */
+    bool saveSensorSeries(int sensorId, const SensorData& data);
+
+    /**
+     * @brief Scala pomiary z serią czujnika w cache i zapisuje ją (saveSensorSeries()), jeśli seria się zmieniła.
+     *
+     * Pomiary z dat spoza `data` zostają w serii, więc zapis kilkudniowego okna z API nie usuwa historii zebranej
+     * wcześniej lub zaimportowanej (ArchiveImporter). O wartości dla daty zapisanej już w serii decyduje `policy`;
+     * pomiar NaN nigdy nie zastępuje wartości. Scalanie serii jednego czujnika z kilku wątków jest szeregowane.
+     * @param sensorId ID czujnika.
+     * @param data Nowe pomiary (w dowolnej kolejności); pusty `data.key` oznacza parametr zapisany w cache.
+     * @param policy Która wartość zostaje dla powtórzonej daty.
+     * @param stats Jeśli nie nullptr, otrzymuje liczby dodanych, zastąpionych i pominiętych pomiarów.
+     * @return Seria po scaleniu (posortowana po dacie) albo std::nullopt, jeśli `data.key` różni się od parametru
+     *         w cache, parametr jest nieznany lub zapis się nie powiódł.
+     */
+    std::optional<SensorData> mergeSensorSeries(int sensorId, const SensorData& data, SeriesMergePolicy policy,
+                                                SeriesMergeStats* stats = nullptr);
+
+    /**
+     * @brief Wczytuje skompresowane dane pomiarowe czujnika, opcjonalnie tylko z przedziału dat [from, to).
+     * Dekodowane są tylko bloki nachodzące na przedział. Nieprawidłowe `from`/`to` oznaczają przedział otwarty.
+     * @return Obiekt SensorData. Zwraca domyślny (pusty) obiekt, jeśli plik nie istnieje lub jest nieprawidłowy.
+     */
+    SensorData loadSensorSeries(int sensorId, const QDateTime& from = QDateTime(), const QDateTime& to = QDateTime());
+
+    /**
+     * @brief Wczytuje dane pomiarowe czujnika z cache: z pliku skompresowanego, a jeśli go nie ma - ze starszego
+     *        pliku JSON ("sensor_{sensorId}_data.json").
+     */
+    SensorData loadCachedSensorData(int sensorId);
+
     /**
      * @brief Zapisuje wektor czujników dla konkretnej stacji do pliku JSON.
      * Nazwa pliku jest generowana automatycznie jako "station_{stationId}_sensors.json".
@@ -96,15 +258,317 @@ public:
      */
     AirQualityIndex loadAirQualityIndexFromJson(int stationId);
 
+    /**
+     * @brief Zapisuje stan modelu prognozy czujnika do pliku JSON.
+     * Nazwa pliku jest generowana automatycznie jako "sensor_{sensorId}_forecast.json".
+     * @param state Stan modelu; `state.sensorId` musi być dodatni.
+     * @return `true` jeśli zapis się powiódł, `false` jeśli ID jest nieprawidłowe lub wystąpił błąd zapisu.
+     */
+    bool saveForecastState(const ForecastState& state);
+
+    /**
+     * @brief Wczytuje stan modelu prognozy czujnika z pliku JSON.
+     * @param sensorId ID czujnika.
+     * @return Stan modelu. Zwraca domyślny stan (z `sensorId = -1`), jeśli plik nie istnieje, jest nieprawidłowy
+     *         lub dotyczy innego czujnika.
+     */
+    ForecastState loadForecastState(int sensorId);
+
+    /**
+     * @brief Zapisuje reguły alertów do pliku JSON (czytelny format - plik może być edytowany ręcznie).
+     * @param rules Reguły do zapisania.
+     * @param filename Nazwa pliku JSON (względem `storagePath`). Domyślnie "alert_rules.json".
+     * @return `true` jeśli zapis się powiódł, `false` w przeciwnym razie.
+     */
+    bool saveAlertRules(const std::vector<AlertRule>& rules, const QString& filename = alertRulesFileName());
+
+    /**
+     * @brief Wczytuje reguły alertów z pliku JSON.
+     * @param filename Nazwa pliku JSON (względem `storagePath`). Domyślnie "alert_rules.json".
+     * @return Wektor reguł. Zwraca pusty wektor, jeśli plik nie istnieje lub jest nieprawidłowy.
+     */
+    std::vector<AlertRule> loadAlertRules(const QString& filename = alertRulesFileName());
+
+    /**
+     * @brief Zapisuje daty, do których zmiany stanu alertów zostały zgłoszone (AlertEngine::progress()).
+     * @return `true` jeśli zapis się powiódł (przy zapisie w tle - jeśli dane przyjęto do kolejki).
+     */
+    bool saveAlertProgress(const AlertProgress& progress);
+
+    /**
+     * @brief Wczytuje daty zgłoszonych zmian stanu alertów.
+     * @return Wczytane daty lub pusty AlertProgress, jeśli plik nie istnieje lub jest nieprawidłowy.
+     */
+    AlertProgress loadAlertProgress();
+
+    /**
+     * @brief Zwraca historię indeksów AQI stacji zapisywaną w katalogu przechowywania (czeka najpierw na zaległe
+     *        dopisania z appendAirQualityIndexHistory()).
+     * W przeciwieństwie do saveAirQualityIndexToJson() (tylko ostatni indeks) historia zachowuje każdy pobrany indeks.
+     */
+    AqiHistoryStore& airQualityIndexHistory();
+
+    /**
+     * @brief Dopisuje indeks do historii AQI stacji `index.stationId`; przy zapisie w tle tylko zleca zapis.
+     * Indeksy zlecone przed wykonaniem zapisu są dopisywane razem (AqiHistoryStore::appendBatch()).
+     * @return `true`, jeśli indeks dopisano (przy zapisie w tle - jeśli przyjęto go do kolejki); `false` dla
+     *         nieprawidłowego indeksu, duplikatu stCalcDate (przy zapisie synchronicznym) lub błędu zapisu.
+     */
+    bool appendAirQualityIndexHistory(const AirQualityIndex& index);
+
+    /**
+     * @brief Zwraca katalog plików cache zapisanych przez DataStorage (czeka najpierw na zaległe zapisy w tle).
+     * Pliki zapisane lub usunięte poza DataStorage są uwzględniane dopiero przy próbie ich odczytu.
+     */
+    const CacheManifest& cacheManifest() const;
+
+    /**
+     * @brief Włącza lub wyłącza dopisywanie stopki z sumą kontrolną do zapisywanych plików cache (domyślnie włączone).
+     * Stopki istniejących plików są weryfikowane przy odczycie niezależnie od tego ustawienia.
+     */
+    void setChecksumsEnabled(bool enabled);
+    /** @brief Czy zapisywane pliki cache mają stopkę z sumą kontrolną. */
+    bool checksumsEnabled() const;
+
+    /**
+     * @brief Suma kontrolna CRC-32 (jak w zlib) używana w stopkach plików cache.
+     * @param previous Suma poprzednich porcji danych - pozwala liczyć sumę pliku czytanego porcjami (jak crc32() w zlib).
+     */
+    static quint32 checksum(const QByteArray& data, quint32 previous = 0);
+
+    /**
+     * @brief Włącza lub wyłącza zapis w tle (domyślnie wyłączony). Wyłączenie wykonuje zaległe zapisy.
+     *
+     * Przy włączonym zapisie w tle metody save* zwracają `true` po przyjęciu danych do kolejki; błędy zapisu są
+     * logowane i zgłaszane przez flush(). Ustawienie należy zmieniać, gdy z obiektu nie korzystają inne wątki.
+     * @param enabled Czy zapisywać w tle.
+     * @param batchDelayMs Czas zbierania partii zapisów w milisekundach.
+     */
+    void setWriteBehindEnabled(bool enabled, int batchDelayMs = WriteBehindQueue::DefaultBatchDelayMs);
+    /** @brief Czy zapis odbywa się w tle. */
+    bool writeBehindEnabled() const;
+
+    /**
+     * @brief Czeka na wykonanie wszystkich zleconych zapisów w tle (bez zapisu w tle nic nie robi).
+     * @return `false`, jeśli któryś z zakończonych w tym czasie zapisów się nie powiódł.
+     */
+    bool flush();
+
+    /** @brief Liczniki kolejki zapisu w tle (zerowe, jeśli zapis w tle jest wyłączony). */
+    WriteBehindStats writeBehindStats() const;
+
+    /**
+     * @brief Ustawia układ zapisywanych plików (domyślnie StorageLayout::Flat). Istniejące pliki są przenoszone
+     *        przy kolejnym zapisie; do tego czasu są odczytywane ze starego miejsca.
+     */
+    void setLayout(StorageLayout layout);
+    /** @brief Układ zapisywanych plików. */
+    StorageLayout layout() const;
+
+    /**
+     * @brief Ścieżka pliku względem katalogu przechowywania w bieżącym układzie (np. "series/12/sensor_1234_series.bin").
+     * Pliki bez ID w nazwie (lista stacji, reguły alertów) zawsze leżą bezpośrednio w katalogu przechowywania.
+     */
+    QString relativeFilePath(const QString& filename) const;
+
+    /**
+     * @brief Jeden przebieg porządkowania cache według `policy`.
+     *
+     * Usuwa uszkodzone pliki odłożone przez odczyt (".corrupt") oraz pliki czujników i stacji nieodświeżane dłużej
+     * niż `policy.maxAgeDays` (serie - także gdy wszystkie pomiary
+     * są starsze), przepisuje serie bez starszych pomiarów lub z niepełnymi blokami, usuwa stare rekordy historii AQI,
+     * a na koniec - jeśli cache przekracza `policy.diskBudgetBytes` - najdawniej pobrane pliki. Lista stacji, reguły
+     * alertów i serie chronione (setSeriesRetained()) nie są usuwane ani obcinane; ich bloki są tylko scalane.
+     * Metoda może działać w wątku roboczym; zapisy zlecone w trakcie nie są tracone.
+     * @param now Bieżący czas (do testów).
+     */
+    CompactionStats compact(const RetentionPolicy& policy, const QDateTime& now = QDateTime::currentDateTime());
+
+    /**
+     * @brief Wyłącza serię czujnika z zasad przechowywania compact() (np. historię zaimportowaną z archiwum).
+     * Ochrona jest zapisana w katalogu cache i zostaje przy kolejnych zapisach serii.
+     * @return `false`, jeśli seria nie istnieje.
+     */
+    bool setSeriesRetained(int sensorId, bool retained = true);
+
+    /// Liczba kolejnych ID w jednym podkatalogu układu StorageLayout::Sharded.
+    static constexpr int IdsPerShard = 100;
+
+    /**
+     * @brief Eksportuje dane pomiarowe wielu czujników do jednego pliku CSV lub Arrow IPC.
+     *
+     * Suma kontrolna pliku serii jest sprawdzana porcjami, a z pliku zostaje w pamięci tylko indeks bloków; bloki są
+     * czytane z dysku dopiero wtedy, gdy ich pomiary trafiają do wyniku. Układ ExportLayout::Long przetwarza czujniki
+     * po kolei (odczyt bloku, zapis wierszy, zwolnienie), a ExportLayout::Wide łączy czujniki oknami po
+     * ExportWindowDays dni, czytając tylko bloki nachodzące na bieżące okno. Starsze pliki JSON są czytane ponownie
+     * dla każdego okna. W pamięci są więc tylko pomiary bieżących bloków, niezależnie od rozmiaru cache i pliku
+     * wynikowego. W obrębie czujnika (i w układzie szerokim) wiersze są posortowane po dacie. Plik serii zmieniony
+     * w trakcie eksportu (np. przez zapis w tle) przerywa eksport. Plik wynikowy jest zapisywany atomowo (QSaveFile) -
+     * przy błędzie poprzednia wersja zostaje.
+     * @param sensorIds ID czujników; pusty wektor oznacza wszystkie czujniki z zapisanymi danymi.
+     * @param filePath Ścieżka pliku wynikowego (dowolna, nie tylko w katalogu przechowywania).
+     * @param stats Jeśli nie nullptr, otrzymuje liczbę czujników, wierszy, bajtów i odczytanych bloków.
+     * @return `true`, jeśli plik został zapisany (także gdy nie ma żadnych pomiarów).
+     */
+    bool exportSensorSeries(const std::vector<int>& sensorIds, const QString& filePath,
+                            const ExportOptions& options = ExportOptions(), ExportStats* stats = nullptr);
+
+    /// Długość okna dat, w którym układ ExportLayout::Wide łączy pomiary czujników.
+    static constexpr int ExportWindowDays = 7;
+
     /**
      * @brief Zwraca aktualnie używaną ścieżkę do katalogu przechowywania danych.
      * @return Ścieżka do katalogu jako QString.
      */
     QString getStoragePath() const;
 
+    /**
+     * @brief Zwraca czas ostatniej modyfikacji pliku w katalogu przechowywania.
+     * Używane przez DataRepository do oceny świeżości danych w cache.
+     * @param filename Nazwa pliku (względem `storagePath`).
+     * @return Czas ostatniego zapisu lub nieprawidłowy QDateTime, jeśli plik nie istnieje.
+     */
+    QDateTime getLastModified(const QString& filename) const;
+
+    /**
+     * @brief Zwraca czas pobrania pliku zapisany w katalogu cache (CacheEntry::lastFetch), bez odczytu z dysku.
+     * Używane przez DataRepository do oceny świeżości danych w cache.
+     * @param filename Nazwa pliku (względem `storagePath`).
+     * @return Czas ostatniego zapisu lub markFetched(); nieprawidłowy QDateTime, jeśli pliku nie ma w katalogu cache.
+     */
+    QDateTime lastFetchTime(const QString& filename) const;
+
+    /**
+     * @brief Ustawia czas pobrania pliku w katalogu cache na bieżący bez przepisywania pliku
+     *        (np. odpowiedź API nie zmieniła danych w cache).
+     * @return `false`, jeśli pliku nie ma w katalogu cache.
+     */
+    bool markFetched(const QString& filename);
+
+    /**
+     * @brief Zwraca identyfikatory czujników, dla których w katalogu są zapisane dane pomiarowe.
+     * Na podstawie katalogu cache (serie "sensor_{sensorId}_series.bin" i pliki "sensor_{sensorId}_data.json");
+     * katalog przechowywania nie jest przeglądany.
+     * @return Posortowane rosnąco ID czujników.
+     */
+    std::vector<int> cachedSensorDataIds() const;
+
+    /**
+     * @brief Zwraca identyfikatory stacji, dla których w katalogu są zapisane listy czujników.
+     * Na podstawie katalogu cache (pliki "station_{stationId}_sensors.json"); katalog przechowywania nie jest przeglądany.
+     * @return Posortowane rosnąco ID stacji.
+     */
+    std::vector<int> cachedSensorsStationIds() const;
+
+    /// Nazwa pliku z listą stacji używana domyślnie przez saveStationsToJson/loadStationsFromJson.
+    static QString stationsFileName();
+    /// Nazwa pliku z danymi pomiarowymi czujnika ("sensor_{sensorId}_data.json").
+    static QString sensorDataFileName(int sensorId);
+    /// Nazwa pliku ze skompresowanymi danymi pomiarowymi czujnika ("sensor_{sensorId}_series.bin").
+    static QString sensorSeriesFileName(int sensorId);
+    /// Nazwa pliku z listą czujników stacji ("station_{stationId}_sensors.json").
+    static QString sensorsFileName(int stationId);
+    /// Nazwa pliku z indeksem AQI stacji ("station_{stationId}_aqi.json").
+    static QString airQualityIndexFileName(int stationId);
+    /// Nazwa pliku ze stanem modelu prognozy czujnika ("sensor_{sensorId}_forecast.json").
+    static QString forecastStateFileName(int sensorId);
+    /// Nazwa pliku z regułami alertów ("alert_rules.json").
+    static QString alertRulesFileName();
+    /// Nazwa pliku z datami zgłoszonych zmian stanu alertów ("alert_state.json").
+    static QString alertStateFileName();
+
 private:
     ///< Ścieżka do katalogu, w którym zapisywane są pliki JSON.
     QString m_storagePath;
+    ///< Czy zapisywane pliki cache mają stopkę z sumą kontrolną (odczytywane także w wątku zapisu).
+    std::atomic_bool m_checksumsEnabled{true};
+    ///< Układ zapisywanych plików (odczytywany także w wątku zapisu).
+    std::atomic<StorageLayout> m_layout{StorageLayout::Flat};
+    ///< Szereguje zapisy plików z przepisywaniem i usuwaniem przez compact().
+    mutable QMutex m_fileMutex;
+    /// Liczba blokad scalania serii (czujnik jest przypisany do blokady wg ID).
+    static constexpr int SeriesLockCount = 64;
+    ///< Szeregują mergeSensorSeries() dla jednego czujnika (odczyt, scalenie i zlecenie zapisu).
+    std::array<QMutex, SeriesLockCount> m_seriesLocks;
+    ///< Historia indeksów AQI stacji (pliki binarne w tym samym katalogu).
+    AqiHistoryStore m_aqiHistory;
+    ///< Chroni m_pendingAqiHistory (wypełniane w wątku wywołującym, opróżniane w wątku zapisu).
+    QMutex m_pendingAqiHistoryMutex;
+    ///< Indeksy AQI czekające na dopisanie do historii, wg ID stacji (klucz zostaje po zapisie - do flushAirQualityIndexHistory()).
+    QHash<int, std::vector<AirQualityIndex>> m_pendingAqiHistory;
+    ///< Katalog plików cache (aktualizowany także w wątku zapisu).
+    mutable CacheManifest m_manifest;
+    ///< Kolejka zapisu w tle (nullptr - zapis synchroniczny). Ostatnie pole: jest niszczona jako pierwsza.
+    std::unique_ptr<WriteBehindQueue> m_writeQueue;
+
+    /**
+     * @brief Zwraca ID plików podanych rodzajów z katalogu cache (czeka najpierw na zaległe zapisy w tle).
+     * @return Posortowane rosnąco, dodatnie identyfikatory bez powtórzeń.
+     */
+    std::vector<int> cachedIds(std::initializer_list<CacheEntityType> types) const;
+
+    /// Odbudowuje katalog cache z plików w katalogu przechowywania.
+    void rebuildManifest();
+
+    /// Czeka na zaległe dopisania do historii AQI zlecone przez appendAirQualityIndexHistory().
+    void flushAirQualityIndexHistory();
+
+    /// Pełna ścieżka pliku w katalogu przechowywania (w bieżącym układzie).
+    QString filePath(const QString& filename) const;
+    /// Pełna ścieżka pliku w układzie `layout`.
+    QString filePath(const QString& filename, StorageLayout layout) const;
+    /// Pełna ścieżka istniejącego pliku: w bieżącym układzie, a jeśli go tam nie ma - w drugim.
+    QString locateFile(const QString& filename) const;
+
+    /// Pliki pasujące do `nameFilters` w katalogu przechowywania i podkatalogach układu StorageLayout::Sharded.
+    QFileInfoList cacheFiles(const QStringList& nameFilters) const;
+
+    /// Usuwa plik (w obu układach) i jego wpis w katalogu cache. Wymaga zablokowanego m_fileMutex.
+    bool removeFileLocked(const QString& filename);
+    /// Przepisuje serię bez pomiarów sprzed `cutoff` i z pełnymi blokami, jeśli to coś zmienia; pusta seria jest usuwana.
+    bool compactSeriesFile(const QString& filename, const QDateTime& cutoff, CompactionStats& stats);
+    /// Łączny rozmiar plików historii AQI.
+    qint64 historySize() const;
+
+    /**
+     * @brief Zapisuje plik atomowo (QSaveFile), z opcjonalną stopką sumy kontrolnej.
+     * @param userEditable `true` dla plików edytowanych ręcznie (np. reguły alertów) - zapis bez stopki.
+     * @return `true` jeśli plik został zapisany i podmieniony.
+     */
+    bool writeFile(const QString& filename, const QByteArray& payload, bool userEditable = false) const;
+    /// Jak writeFile(); wymaga zablokowanego m_fileMutex.
+    bool writeFileLocked(const QString& filename, const QByteArray& payload, bool userEditable = false) const;
+
+    /**
+     * @brief Zapisuje plik od razu albo, przy włączonym zapisie w tle, zleca serializację i zapis kolejce.
+     * @param serialize Tworzy zawartość pliku; wywoływana w wątku zapisu, musi więc mieć własne kopie danych.
+     * @return Wynik writeFile() albo `true` po przyjęciu zadania do kolejki.
+     */
+    bool submitWrite(const QString& filename, std::function<QByteArray()> serialize, bool userEditable = false);
+
+    /// Wynik odczytu pliku przez readVerified().
+    enum class ReadStatus {
+        Ok,         ///< Plik wczytany (suma kontrolna zgodna lub brak stopki).
+        Missing,    ///< Pliku nie ma.
+        Unreadable, ///< Nie udało się otworzyć pliku.
+        Corrupt     ///< Suma kontrolna lub stopka się nie zgadza.
+    };
+
+    /**
+     * @brief Wczytuje plik i weryfikuje stopkę sumy kontrolnej (jeśli jest).
+     * Odczyt odbywa się bez blokady; brak pliku lub złą sumę kontrolną sprawdza ponownie przy zablokowanym
+     * m_fileMutex, aby nie usunąć pliku właśnie podmienionego przez zapis w tle lub compact().
+     * @param userEditable `true` dla plików edytowanych ręcznie - stopka nie jest weryfikowana, plik nie jest usuwany.
+     * @return Zawartość bez stopki; std::nullopt, jeśli pliku nie ma, nie da się go odczytać lub suma kontrolna
+     *         się nie zgadza (uszkodzony plik jest wtedy odkładany pod nazwą z przyrostkiem ".corrupt").
+     */
+    std::optional<QByteArray> readFile(const QString& filename, bool userEditable = false) const;
+    /// Jak readFile(), ale bez czekania na zaległy zapis w tle; wymaga zablokowanego m_fileMutex.
+    std::optional<QByteArray> readFileContents(const QString& filename, bool userEditable = false) const;
+    /// Wczytuje plik do `data` i weryfikuje sumę kontrolną, bez zmian w plikach i katalogu cache.
+    ReadStatus readVerified(const QString& filename, bool userEditable, QByteArray& data) const;
+    /// Odkłada uszkodzony plik pod nazwą z przyrostkiem ".corrupt" i usuwa jego wpis. Wymaga zablokowanego m_fileMutex.
+    void quarantineFileLocked(const QString& filename) const;
 
     // --- Prywatne metody pomocnicze do konwersji na/z QJsonObject ---
     // (Dokumentacja dla nich może być mniej szczegółowa lub pominięta, jeśli są proste)
@@ -144,15 +608,22 @@ private:
     /// Konwertuje QJsonObject na obiekt Parameter.
     Parameter parameterFromJson(const QJsonObject& obj);
 
-    /// Konwertuje obiekt IndexLevel na QJsonObject.
-    QJsonObject indexLevelToJson(const IndexLevel& level);
-    /// Konwertuje QJsonObject na obiekt IndexLevel.
-    IndexLevel indexLevelFromJson(const QJsonObject& obj);
-
-    /// Konwertuje obiekt AirQualityIndex na QJsonObject. Używa formatu ISODateWithMs dla dat.
+    /// Konwertuje obiekt AirQualityIndex na QJsonObject. Używa formatu ISODateWithMs dla dat, poziomy zapisuje jako ID
+    /// ("stIndexLevel" i tablica "levels" w kolejności enum Pollutant).
     QJsonObject airQualityIndexToJson(const AirQualityIndex& index);
-    /// Konwertuje QJsonObject na obiekt AirQualityIndex. Używa formatu ISODateWithMs dla dat.
+    /// Konwertuje QJsonObject na obiekt AirQualityIndex. Używa formatu ISODateWithMs dla dat; odczytuje też starszy
+    /// format z obiektami poziomów pod kluczami "so2IndexLevel" ... "c6h6IndexLevel".
     AirQualityIndex airQualityIndexFromJson(const QJsonObject& obj);
+
+    /// Konwertuje stan modelu prognozy na QJsonObject. Wartości NaN są zapisywane jako null.
+    QJsonObject forecastStateToJson(const ForecastState& state);
+    /// Konwertuje QJsonObject na stan modelu prognozy.
+    ForecastState forecastStateFromJson(const QJsonObject& obj);
+
+    /// Konwertuje regułę alertu na QJsonObject.
+    QJsonObject alertRuleToJson(const AlertRule& rule);
+    /// Konwertuje QJsonObject na regułę alertu.
+    AlertRule alertRuleFromJson(const QJsonObject& obj);
 };
 
 #endif // DATASTORAGE_H
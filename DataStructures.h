@@ -7,8 +7,11 @@
 
 #include <QString>
 #include <QDateTime>
+#include <array>
+#include <cstddef>
 #include <vector>
 #include <limits>
+#include <cmath>
 
 /**
  * @brief Przechowuje informacje o gminie, powiecie i województwie.
@@ -86,33 +89,115 @@ struct SensorData {
 };
 
 /**
- * @brief Reprezentuje poziom indeksu jakości powietrza (ogólny lub dla konkretnego zanieczyszczenia).
- * Odpowiada strukturze '*IndexLevel' w danych API GIOS dla indeksu AQI.
+ * @enum Pollutant
+ * @brief Zanieczyszczenia uwzględniane w indeksie jakości powietrza.
+ * Wartości są indeksami tablicy AirQualityIndex::pollutantLevels i tablic stałych poniżej.
  */
-struct IndexLevel {
-    int id = -1;            ///< ID poziomu indeksu (zwykle 0-5, -1 jeśli nieznany/brak danych).
-    QString indexLevelName; ///< Tekstowa nazwa poziomu (np. "Dobry", "Zły", "Brak indeksu", "N/A").
+enum class Pollutant {
+    SO2 = 0, ///< Dwutlenek siarki.
+    NO2,     ///< Dwutlenek azotu.
+    CO,      ///< Tlenek węgla.
+    PM10,    ///< Pył zawieszony PM10.
+    PM25,    ///< Pył zawieszony PM2.5.
+    O3,      ///< Ozon.
+    C6H6     ///< Benzen.
 };
 
+/// Liczba zanieczyszczeń w enum Pollutant.
+constexpr std::size_t PollutantCount = 7;
+
+/// Klucze poziomów zanieczyszczeń w odpowiedzi API aqindex/getIndex, w kolejności enum Pollutant.
+constexpr std::array<const char*, PollutantCount> PollutantIndexKeys = {{
+    "so2IndexLevel", "no2IndexLevel", "coIndexLevel", "pm10IndexLevel", "pm25IndexLevel", "o3IndexLevel", "c6h6IndexLevel"
+}};
+
+/// ID poziomu oznaczające brak indeksu (brak danych lub indeks niedostępny).
+constexpr int NoIndexLevel = -1;
+/// Liczba poziomów indeksu (0 - Bardzo dobry ... 5 - Bardzo zły).
+constexpr int IndexLevelCount = 6;
+
+/// Nazwy poziomów indeksu wg GIOŚ (UTF-8), indeksowane ID poziomu.
+constexpr std::array<const char*, IndexLevelCount> IndexLevelNames = {{
+    "Bardzo dobry", "Dobry", "Umiarkowany", "Dostateczny", "Zły", "Bardzo zły"
+}};
+
+/// Sprowadza ID poziomu do zakresu 0-5; inne wartości oznaczają brak indeksu (NoIndexLevel).
+constexpr qint8 toIndexLevel(int levelId) {
+    return static_cast<qint8>(levelId >= 0 && levelId < IndexLevelCount ? levelId : NoIndexLevel);
+}
+
+/// Zwraca nazwę poziomu indeksu z tablicy IndexLevelNames; "Brak indeksu" poza zakresem 0-5.
+inline QString indexLevelName(int levelId) {
+    return levelId >= 0 && levelId < IndexLevelCount ? QString::fromUtf8(IndexLevelNames[static_cast<std::size_t>(levelId)])
+                                                     : QStringLiteral("Brak indeksu");
+}
+
 /**
  * @brief Przechowuje zagregowany indeks jakości powietrza (AQI) dla stacji.
- * Odpowiada głównemu obiektowi w odpowiedzi API dla indeksu AQI.
+ * Odpowiada głównemu obiektowi w odpowiedzi API dla indeksu AQI. Poziomy są przechowywane jako ID (0-5 lub
+ * NoIndexLevel), a nazwy wyznaczane z tablicy IndexLevelNames - struktura nie zawiera napisów poza datami.
  */
 struct AirQualityIndex {
     int stationId = -1;     ///< ID stacji, której dotyczy indeks (-1 jeśli nieznany lub błąd).
     QDateTime stCalcDate;   ///< Data i czas obliczenia indeksu przez system GIOS.
     QDateTime stSourceDataDate; ///< Data i czas ostatnich danych źródłowych użytych do obliczenia indeksu.
-    IndexLevel stIndexLevel; ///< Ogólny (najgorszy) poziom indeksu dla stacji.
-
-    // Poziomy indeksów dla poszczególnych zanieczyszczeń
-    IndexLevel so2IndexLevel;   ///< Indeks dla SO2.
-    IndexLevel no2IndexLevel;   ///< Indeks dla NO2.
-    IndexLevel coIndexLevel;    ///< Indeks dla CO.
-    IndexLevel pm10IndexLevel;  ///< Indeks dla PM10.
-    IndexLevel pm25IndexLevel;  ///< Indeks dla PM2.5.
-    IndexLevel o3IndexLevel;    ///< Indeks dla O3.
-    IndexLevel c6h6IndexLevel;  ///< Indeks dla C6H6 (benzen).
+    qint8 stIndexLevel = NoIndexLevel; ///< Ogólny (najgorszy) poziom indeksu dla stacji.
+    /// Poziomy indeksów dla poszczególnych zanieczyszczeń, indeksowane enum Pollutant.
+    std::array<qint8, PollutantCount> pollutantLevels = {{NoIndexLevel, NoIndexLevel, NoIndexLevel, NoIndexLevel,
+                                                          NoIndexLevel, NoIndexLevel, NoIndexLevel}};
+
+    /** @brief Zwraca poziom indeksu zanieczyszczenia (NoIndexLevel, jeśli brak). */
+    int level(Pollutant pollutant) const { return pollutantLevels[static_cast<std::size_t>(pollutant)]; }
+    /** @brief Ustawia poziom indeksu zanieczyszczenia (wartości spoza 0-5 oznaczają brak indeksu). */
+    void setLevel(Pollutant pollutant, int levelId) { pollutantLevels[static_cast<std::size_t>(pollutant)] = toIndexLevel(levelId); }
 };
 
+// --- Operatory porównania ---
+// Używane m.in. przez DataRepository do wykrywania, czy odświeżone dane różnią się od zawartości cache.
+
+inline bool operator==(const Commune& a, const Commune& b) {
+    return a.communeName == b.communeName && a.districtName == b.districtName && a.provinceName == b.provinceName;
+}
+inline bool operator!=(const Commune& a, const Commune& b) { return !(a == b); }
+
+inline bool operator==(const City& a, const City& b) {
+    return a.id == b.id && a.name == b.name && a.commune == b.commune && a.addressStreet == b.addressStreet;
+}
+inline bool operator!=(const City& a, const City& b) { return !(a == b); }
+
+inline bool operator==(const MeasuringStation& a, const MeasuringStation& b) {
+    return a.id == b.id && a.stationName == b.stationName && a.gegrLat == b.gegrLat
+           && a.gegrLon == b.gegrLon && a.city == b.city;
+}
+inline bool operator!=(const MeasuringStation& a, const MeasuringStation& b) { return !(a == b); }
+
+inline bool operator==(const Parameter& a, const Parameter& b) {
+    return a.paramName == b.paramName && a.paramFormula == b.paramFormula
+           && a.paramCode == b.paramCode && a.idParam == b.idParam;
+}
+inline bool operator!=(const Parameter& a, const Parameter& b) { return !(a == b); }
+
+inline bool operator==(const Sensor& a, const Sensor& b) {
+    return a.id == b.id && a.stationId == b.stationId && a.param == b.param;
+}
+inline bool operator!=(const Sensor& a, const Sensor& b) { return !(a == b); }
+
+/// Dwie wartości NaN są traktowane jako równe (obie oznaczają brak pomiaru).
+inline bool operator==(const MeasurementValue& a, const MeasurementValue& b) {
+    bool sameValue = (std::isnan(a.value) && std::isnan(b.value)) || a.value == b.value;
+    return a.date == b.date && sameValue;
+}
+inline bool operator!=(const MeasurementValue& a, const MeasurementValue& b) { return !(a == b); }
+
+inline bool operator==(const SensorData& a, const SensorData& b) {
+    return a.key == b.key && a.values == b.values;
+}
+inline bool operator!=(const SensorData& a, const SensorData& b) { return !(a == b); }
+
+inline bool operator==(const AirQualityIndex& a, const AirQualityIndex& b) {
+    return a.stationId == b.stationId && a.stCalcDate == b.stCalcDate && a.stSourceDataDate == b.stSourceDataDate
+           && a.stIndexLevel == b.stIndexLevel && a.pollutantLevels == b.pollutantLevels;
+}
+inline bool operator!=(const AirQualityIndex& a, const AirQualityIndex& b) { return !(a == b); }
 
 #endif // DATASTRUCTURES_H
@@ -0,0 +1,220 @@
+#include "FleetAnalyzer.h"
+#include "DataStorage.h"
+#include "HoltWintersForecaster.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <map>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/// Wynik przetworzenia jednego czujnika w wątku roboczym.
+struct SensorOutcome {
+    bool loaded = false;
+    FleetSensorRow row;
+    QuantileSketch sketch;
+};
+
+/// Stan agregacji jednej grupy.
+struct GroupAccumulator {
+    FleetAggregate aggregate;
+    double weightedSum = 0.0;
+    QuantileSketch sketch;
+};
+
+void accumulate(GroupAccumulator& acc, const SensorOutcome& outcome)
+{
+    const FleetSensorRow& row = outcome.row;
+    acc.aggregate.sensorCount++;
+    if (row.validCount == 0) {
+        return;
+    }
+
+    acc.aggregate.valueCount += static_cast<quint64>(row.validCount);
+    acc.weightedSum += *row.result.average * row.validCount;
+    if (!acc.aggregate.maxValue || row.result.maxVal->value > *acc.aggregate.maxValue) {
+        acc.aggregate.maxValue = row.result.maxVal->value;
+    }
+    if (row.result.trend == AnalysisResult::INCREASING) {
+        acc.aggregate.increasingCount++;
+    } else if (row.result.trend == AnalysisResult::DECREASING) {
+        acc.aggregate.decreasingCount++;
+    }
+    acc.sketch.merge(outcome.sketch);
+}
+
+std::vector<FleetAggregate> finalize(std::map<QString, GroupAccumulator>& groups)
+{
+    std::vector<FleetAggregate> result;
+    result.reserve(groups.size());
+    for (auto& entry : groups) {
+        GroupAccumulator& acc = entry.second;
+        acc.aggregate.group = entry.first;
+        if (acc.aggregate.valueCount > 0) {
+            acc.aggregate.average = acc.weightedSum / static_cast<double>(acc.aggregate.valueCount);
+            std::vector<double> percentiles = acc.sketch.quantiles({0.50, 0.90, 0.98});
+            acc.aggregate.p50 = percentiles[0];
+            acc.aggregate.p90 = percentiles[1];
+            acc.aggregate.p98 = percentiles[2];
+        }
+        result.push_back(acc.aggregate);
+    }
+    return result;
+}
+
+} // namespace
+
+FleetAnalyzer::FleetAnalyzer(DataStorage* storage) : m_storage(storage)
+{
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+void FleetAnalyzer::setOptions(const AnalyzerOptions& options)
+{
+    m_options = options;
+}
+
+AnalyzerOptions FleetAnalyzer::options() const
+{
+    return m_options;
+}
+
+void FleetAnalyzer::setMaxThreadCount(int count)
+{
+    m_pool.setMaxThreadCount(std::max(1, count));
+}
+
+int FleetAnalyzer::maxThreadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+QString FleetAnalyzer::unknownGroupName()
+{
+    return QStringLiteral("(nieznane)");
+}
+
+QHash<int, FleetAnalyzer::SensorMetadata> FleetAnalyzer::loadMetadata()
+{
+    QHash<int, std::pair<QString, QString>> stations; // ID stacji -> (nazwa, województwo)
+    for (const MeasuringStation& station : m_storage->loadStationsFromJson()) {
+        stations.insert(station.id, {station.stationName, station.city.commune.provinceName});
+    }
+
+    DataStorage* storage = m_storage;
+    const QList<std::vector<Sensor>> sensorLists = QtConcurrent::blockingMapped<QList<std::vector<Sensor>>>(
+        &m_pool, m_storage->cachedSensorsStationIds(),
+        [storage](int stationId) { return storage->loadSensorsFromJson(stationId); });
+
+    QHash<int, SensorMetadata> metadata;
+    for (const std::vector<Sensor>& sensors : sensorLists) {
+        for (const Sensor& sensor : sensors) {
+            SensorMetadata meta;
+            meta.stationId = sensor.stationId;
+            meta.paramCode = sensor.param.paramCode;
+            auto station = stations.constFind(sensor.stationId);
+            if (station != stations.constEnd()) {
+                meta.stationName = station->first;
+                meta.provinceName = station->second;
+            }
+            metadata.insert(sensor.id, meta);
+        }
+    }
+    return metadata;
+}
+
+FleetReport FleetAnalyzer::run(const std::vector<int>& sensorIds)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    FleetReport report;
+    report.threadCount = m_pool.maxThreadCount();
+
+    const std::vector<int> ids = sensorIds.empty() ? m_storage->cachedSensorDataIds() : sensorIds;
+    const QHash<int, SensorMetadata> metadata = loadMetadata();
+
+    DataStorage* storage = m_storage;
+    const AnalyzerOptions options = m_options;
+    auto analyzeSensor = [storage, options, &metadata](int sensorId) {
+        SensorOutcome outcome;
+        SensorData data = storage->loadCachedSensorData(sensorId);
+        if (data.key.isEmpty()) {
+            return outcome;
+        }
+        outcome.loaded = true;
+
+        FleetSensorRow& row = outcome.row;
+        row.sensorId = sensorId;
+        row.paramCode = data.key;
+        auto meta = metadata.constFind(sensorId);
+        if (meta != metadata.constEnd()) {
+            row.stationId = meta->stationId;
+            row.stationName = meta->stationName;
+            row.provinceName = meta->provinceName;
+            if (!meta->paramCode.isEmpty()) {
+                row.paramCode = meta->paramCode;
+            }
+        }
+
+        for (const MeasurementValue& mv : data.values) {
+            if (mv.date.isValid() && !std::isnan(mv.value)) {
+                outcome.sketch.add(mv.value);
+                row.validCount++;
+            }
+        }
+
+        DataAnalyzer analyzer;
+        analyzer.setOptions(options);
+        row.result = analyzer.analyze(data.values);
+
+        ForecastState state = storage->loadForecastState(sensorId);
+        state.sensorId = sensorId;
+        HoltWintersForecaster forecaster(state);
+        forecaster.update(data.values);
+        const std::vector<MeasurementValue> forecast = forecaster.forecast(24);
+        if (!forecast.empty()) {
+            double sum = 0.0;
+            double maxValue = forecast.front().value;
+            for (const MeasurementValue& mv : forecast) {
+                sum += mv.value;
+                maxValue = std::max(maxValue, mv.value);
+            }
+            row.forecastMean24h = sum / static_cast<double>(forecast.size());
+            row.forecastMax24h = maxValue;
+        }
+        return outcome;
+    };
+
+    const QList<SensorOutcome> outcomes =
+        QtConcurrent::blockingMapped<QList<SensorOutcome>>(&m_pool, ids, analyzeSensor);
+
+    std::map<QString, GroupAccumulator> byParameter;
+    std::map<QString, GroupAccumulator> byProvince;
+    report.rows.reserve(static_cast<size_t>(outcomes.size()));
+    for (const SensorOutcome& outcome : outcomes) {
+        if (!outcome.loaded) {
+            report.failedCount++;
+            continue;
+        }
+        report.rows.push_back(outcome.row);
+
+        const QString& param = outcome.row.paramCode;
+        const QString& province = outcome.row.provinceName;
+        accumulate(byParameter[param.isEmpty() ? unknownGroupName() : param], outcome);
+        accumulate(byProvince[province.isEmpty() ? unknownGroupName() : province], outcome);
+    }
+
+    std::sort(report.rows.begin(), report.rows.end(), [](const FleetSensorRow& a, const FleetSensorRow& b) {
+        return a.sensorId < b.sensorId;
+    });
+    report.byParameter = finalize(byParameter);
+    report.byProvince = finalize(byProvince);
+    report.elapsedMs = timer.elapsed();
+
+    qInfo() << "Analiza floty zakończona:" << report.rows.size() << "czujników," << report.failedCount << "błędów,"
+            << report.threadCount << "wątków," << report.elapsedMs << "ms";
+    return report;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file FleetAnalyzer.h
+ * @brief Definicja klasy FleetAnalyzer - równoległej analizy wszystkich czujników zapisanych w DataStorage.
+ */
+#ifndef FLEETANALYZER_H
+#define FLEETANALYZER_H
+
+#include <QString>
+#include <QHash>
+#include <QThreadPool>
+#include <optional>
+#include <vector>
+#include "DataAnalyzer.h"
+
+class DataStorage;
+
+/**
+ * @struct FleetSensorRow
+ * @brief Wynik analizy jednego czujnika w raporcie floty.
+ */
+struct FleetSensorRow {
+    int sensorId = -1;          ///< ID czujnika.
+    int stationId = -1;         ///< ID stacji (-1, jeśli brak zapisanej listy czujników stacji).
+    QString stationName;        ///< Nazwa stacji (pusta, jeśli nieznana).
+    QString provinceName;       ///< Województwo (puste, jeśli nieznane).
+    QString paramCode;          ///< Kod parametru (z listy czujników, a gdy jej brak - klucz danych).
+    int validCount = 0;         ///< Liczba prawidłowych (nie-NaN) pomiarów.
+    AnalysisResult result;      ///< Wynik DataAnalyzer::analyze().
+    std::optional<double> forecastMean24h; ///< Średnia prognozy na 24 h (HoltWintersForecaster); brak przed inicjalizacją modelu.
+    std::optional<double> forecastMax24h;  ///< Maksimum prognozy na 24 h.
+};
+
+/**
+ * @struct FleetAggregate
+ * @brief Zagregowane statystyki grupy czujników (jednego parametru lub jednego województwa).
+ */
+struct FleetAggregate {
+    QString group;                  ///< Kod parametru lub nazwa województwa.
+    int sensorCount = 0;            ///< Liczba czujników w grupie.
+    quint64 valueCount = 0;         ///< Łączna liczba prawidłowych pomiarów.
+    std::optional<double> average;  ///< Średnia ze wszystkich pomiarów grupy (ważona liczbą pomiarów czujników).
+    std::optional<double> maxValue; ///< Maksymalny pomiar w grupie.
+    std::optional<double> p50;      ///< Percentyl 50 wszystkich pomiarów grupy (z połączonych szkiców kwantyli).
+    std::optional<double> p90;      ///< Percentyl 90 (patrz p50).
+    std::optional<double> p98;      ///< Percentyl 98 (patrz p50).
+    int increasingCount = 0;        ///< Liczba czujników z trendem rosnącym.
+    int decreasingCount = 0;        ///< Liczba czujników z trendem malejącym.
+};
+
+/**
+ * @struct FleetReport
+ * @brief Raport z analizy wszystkich czujników.
+ */
+struct FleetReport {
+    std::vector<FleetSensorRow> rows;         ///< Wyniki czujników, posortowane rosnąco po ID czujnika.
+    std::vector<FleetAggregate> byParameter;  ///< Agregaty wg kodu parametru, posortowane po nazwie grupy.
+    std::vector<FleetAggregate> byProvince;   ///< Agregaty wg województwa, posortowane po nazwie grupy.
+    int failedCount = 0;                      ///< Liczba czujników, których danych nie udało się wczytać.
+    int threadCount = 0;                      ///< Liczba wątków użytych do analizy.
+    qint64 elapsedMs = 0;                     ///< Czas wykonania raportu w milisekundach.
+};
+
+/**
+ * @class FleetAnalyzer
+ * @brief Analizuje równolegle dane wszystkich czujników zapisanych w DataStorage.
+ *
+ * Metadane (stacja, województwo, parametr) są odczytywane z zapisanej listy stacji i list czujników stacji.
+ * Wczytywanie i parsowanie plików JSON oraz analiza każdego czujnika są wykonywane w puli wątków
+ * (QtConcurrent::blockingMapped). QtConcurrent przydziela wątkom kolejne porcje czujników dynamicznie,
+ * więc wolniejsze czujniki (dłuższe serie) nie blokują pozostałych wątków. Agregacja jest wykonywana
+ * na końcu w wątku wywołującym; percentyle grup pochodzą z połączenia szkiców kwantyli czujników.
+ *
+ * Prognoza 24 h każdego czujnika wychodzi od zapisanego stanu modelu (DataStorage::loadForecastState()), do którego
+ * dopisywane są tylko nowsze pomiary, więc nie wymaga ponownego dopasowania do całej historii. Zaktualizowany stan
+ * nie jest zapisywany - pliki stanu zapisuje tylko GUI, co wyklucza równoczesny zapis tego samego pliku z dwóch wątków.
+ *
+ * Metoda run() jest blokująca - z GUI należy wywoływać ją w tle (np. QtConcurrent::run). Analizator
+ * używa własnej puli wątków, więc może być bezpiecznie wywołany z wątku globalnej puli.
+ */
+class FleetAnalyzer
+{
+public:
+    /**
+     * @brief Konstruktor.
+     * @param storage Magazyn danych, z którego wczytywane są dane (nie przejmuje własności).
+     *                Odczyty DataStorage są bezpieczne wątkowo, więc mogą być wykonywane równolegle; odczyt może
+     *                jednak zmienić stan magazynu (usunięcie wpisu brakującego pliku, odłożenie uszkodzonego pliku).
+     */
+    explicit FleetAnalyzer(DataStorage* storage);
+
+    FleetAnalyzer(const FleetAnalyzer&) = delete;
+    FleetAnalyzer& operator=(const FleetAnalyzer&) = delete;
+
+    /** @brief Ustawia opcje analizy używane dla każdego czujnika (np. metodę trendu). */
+    void setOptions(const AnalyzerOptions& options);
+    /** @brief Zwraca opcje analizy. */
+    AnalyzerOptions options() const;
+
+    /** @brief Ustawia maksymalną liczbę wątków analizy (domyślnie liczba rdzeni). */
+    void setMaxThreadCount(int count);
+    /** @brief Zwraca maksymalną liczbę wątków analizy. */
+    int maxThreadCount() const;
+
+    /**
+     * @brief Wykonuje analizę czujników.
+     * @param sensorIds ID czujników do analizy; pusty wektor oznacza wszystkie czujniki z zapisanymi danymi.
+     * @return Raport z wynikami czujników i agregatami.
+     */
+    FleetReport run(const std::vector<int>& sensorIds = {});
+
+    /** @brief Nazwa grupy dla czujników bez znanego parametru lub województwa. */
+    static QString unknownGroupName();
+
+private:
+    /// Metadane czujnika z zapisanych list stacji i czujników.
+    struct SensorMetadata {
+        int stationId = -1;
+        QString stationName;
+        QString provinceName;
+        QString paramCode;
+    };
+
+    /// Wczytuje metadane wszystkich czujników z zapisanych list czujników stacji (równolegle).
+    QHash<int, SensorMetadata> loadMetadata();
+
+    DataStorage* m_storage;     ///< Magazyn danych (nie jest własnością analizatora).
+    AnalyzerOptions m_options;  ///< Opcje analizy czujników.
+    QThreadPool m_pool;         ///< Własna pula wątków (niezależna od globalnej).
+};
+
+#endif // FLEETANALYZER_H
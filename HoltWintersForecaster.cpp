@@ -0,0 +1,158 @@
+#include "HoltWintersForecaster.h"
+#include "TimeSeriesResampler.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cmath>
+
+HoltWintersForecaster::HoltWintersForecaster(const ForecastState& state) : m_state(state)
+{
+    m_state.seasonLength = std::max(2, m_state.seasonLength);
+    m_state.alpha = std::clamp(m_state.alpha, 0.001, 1.0);
+    m_state.beta = std::clamp(m_state.beta, 0.0, 1.0);
+    m_state.gamma = std::clamp(m_state.gamma, 0.0, 1.0);
+    m_state.phi = std::clamp(m_state.phi, 0.0, 1.0);
+
+    // Stan niezgodny z długością sezonu (np. uszkodzony plik) - model startuje od nowa
+    const std::size_t season = static_cast<std::size_t>(m_state.seasonLength);
+    if ((!m_state.seasonal.empty() && m_state.seasonal.size() != season) || m_state.warmup.size() >= season
+        || m_state.seasonIndex < 0 || m_state.seasonIndex >= m_state.seasonLength) {
+        m_state.seasonal.clear();
+        m_state.warmup.clear();
+        m_state.seasonIndex = 0;
+    }
+}
+
+const ForecastState& HoltWintersForecaster::state() const
+{
+    return m_state;
+}
+
+double HoltWintersForecaster::oneStepErrorStdDev() const
+{
+    return std::sqrt(m_state.errorVariance);
+}
+
+int HoltWintersForecaster::update(const std::vector<MeasurementValue>& values)
+{
+    const qint64 stepMSecs = StepSecs * 1000;
+    const bool hasHistory = m_state.lastStepMSecs != std::numeric_limits<qint64>::min();
+
+    std::vector<MeasurementValue> fresh;
+    for (const MeasurementValue& mv : values) {
+        if (mv.date.isValid() && !std::isnan(mv.value)
+            && (!hasHistory || mv.date.toMSecsSinceEpoch() >= m_state.lastStepMSecs + stepMSecs)) {
+            fresh.push_back(mv);
+        }
+    }
+    if (fresh.empty()) {
+        return 0;
+    }
+
+    ResampleOptions options;
+    options.stepSecs = StepSecs;
+    const ResampledSeries hourly = TimeSeriesResampler::resample(fresh, options);
+
+    int steps = 0;
+    if (hasHistory) {
+        const qint64 gap = (hourly.startMSecs - m_state.lastStepMSecs) / stepMSecs - 1;
+        if (gap > static_cast<qint64>(MaxGapSeasons) * m_state.seasonLength) {
+            m_state.seasonal.clear();
+            m_state.warmup.clear();
+            m_state.seasonIndex = 0;
+            m_state.trend = 0.0;
+            m_state.errorVariance = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            for (qint64 i = 0; i < gap; ++i) {
+                step(std::numeric_limits<double>::quiet_NaN());
+                ++steps;
+            }
+        }
+    }
+
+    for (double value : hourly.values) {
+        step(value);
+        ++steps;
+    }
+    m_state.lastStepMSecs = hourly.startMSecs + static_cast<qint64>(hourly.size() - 1) * stepMSecs;
+    return steps;
+}
+
+void HoltWintersForecaster::step(double value)
+{
+    if (!std::isnan(value)) {
+        m_state.observationCount++;
+    }
+
+    if (!m_state.isInitialized()) {
+        m_state.warmup.push_back(value);
+        if (static_cast<int>(m_state.warmup.size()) == m_state.seasonLength) {
+            initializeFromWarmup();
+        }
+        return;
+    }
+
+    const std::size_t s = static_cast<std::size_t>(m_state.seasonIndex);
+    const double dampedTrend = m_state.phi * m_state.trend;
+    if (std::isnan(value)) {
+        // Brak pomiaru - model przesuwa się o krok zgodnie z prognozą
+        m_state.level += dampedTrend;
+        m_state.trend = dampedTrend;
+    } else {
+        const double error = value - (m_state.level + dampedTrend + m_state.seasonal[s]);
+        m_state.errorVariance = std::isnan(m_state.errorVariance) ? error * error
+                                                                  : 0.95 * m_state.errorVariance + 0.05 * error * error;
+
+        const double previousLevel = m_state.level;
+        m_state.level = m_state.alpha * (value - m_state.seasonal[s]) + (1.0 - m_state.alpha) * (previousLevel + dampedTrend);
+        m_state.trend = m_state.beta * (m_state.level - previousLevel) + (1.0 - m_state.beta) * dampedTrend;
+        m_state.seasonal[s] = m_state.gamma * (value - m_state.level) + (1.0 - m_state.gamma) * m_state.seasonal[s];
+    }
+    m_state.seasonIndex = (m_state.seasonIndex + 1) % m_state.seasonLength;
+}
+
+void HoltWintersForecaster::initializeFromWarmup()
+{
+    double sum = 0.0;
+    int count = 0;
+    for (double v : m_state.warmup) {
+        if (!std::isnan(v)) {
+            sum += v;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        m_state.warmup.clear();
+        return;
+    }
+
+    const double mean = sum / count;
+    m_state.level = mean;
+    m_state.trend = 0.0;
+    m_state.seasonal.resize(m_state.warmup.size());
+    for (std::size_t i = 0; i < m_state.warmup.size(); ++i) {
+        m_state.seasonal[i] = std::isnan(m_state.warmup[i]) ? 0.0 : m_state.warmup[i] - mean;
+    }
+    m_state.warmup.clear();
+    m_state.seasonIndex = 0;
+}
+
+std::vector<MeasurementValue> HoltWintersForecaster::forecast(int horizonSteps) const
+{
+    std::vector<MeasurementValue> result;
+    if (!m_state.isInitialized() || horizonSteps <= 0) {
+        return result;
+    }
+
+    result.reserve(static_cast<std::size_t>(horizonSteps));
+    const qint64 stepMSecs = StepSecs * 1000;
+    double trendSum = 0.0;
+    double dampingPower = 1.0;
+    for (int k = 1; k <= horizonSteps; ++k) {
+        dampingPower *= m_state.phi;
+        trendSum += dampingPower;
+        const std::size_t s = static_cast<std::size_t>((m_state.seasonIndex + k - 1) % m_state.seasonLength);
+        const double value = m_state.level + trendSum * m_state.trend + m_state.seasonal[s];
+        result.push_back({QDateTime::fromMSecsSinceEpoch(m_state.lastStepMSecs + k * stepMSecs), std::max(0.0, value)});
+    }
+    return result;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file HoltWintersForecaster.h
+ * @brief Definicja klasy HoltWintersForecaster - krótkoterminowej prognozy pomiarów czujnika z przyrostowym stanem modelu.
+ */
+#ifndef HOLTWINTERSFORECASTER_H
+#define HOLTWINTERSFORECASTER_H
+
+#include <QtGlobal>
+#include <limits>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @struct ForecastState
+ * @brief Stan modelu Holta-Wintersa jednego czujnika (zapisywany przez DataStorage::saveForecastState()).
+ */
+struct ForecastState {
+    int sensorId = -1;          ///< ID czujnika.
+    int seasonLength = 24;      ///< Długość sezonu w krokach (doba dla danych godzinowych).
+    double alpha = 0.3;         ///< Współczynnik wygładzania poziomu.
+    double beta = 0.02;         ///< Współczynnik wygładzania trendu.
+    double gamma = 0.1;         ///< Współczynnik wygładzania składowej sezonowej.
+    double phi = 0.95;          ///< Tłumienie trendu w prognozie (1 - brak tłumienia).
+
+    double level = 0.0;         ///< Bieżący poziom.
+    double trend = 0.0;         ///< Bieżący trend (na krok).
+    std::vector<double> seasonal; ///< Składowe sezonowe (seasonLength wartości) - pusty przed inicjalizacją.
+    int seasonIndex = 0;        ///< Indeks składowej sezonowej dla następnego kroku.
+    qint64 lastStepMSecs = std::numeric_limits<qint64>::min(); ///< Początek ostatniego uwzględnionego kroku (ms od epoki).
+    std::vector<double> warmup; ///< Wartości pierwszego sezonu zbierane przed inicjalizacją (NaN - brak).
+    quint64 observationCount = 0; ///< Liczba uwzględnionych pomiarów godzinowych.
+    double errorVariance = std::numeric_limits<double>::quiet_NaN(); ///< Wygładzona wariancja błędu prognozy o 1 krok.
+
+    /** @brief Czy model ma już wyznaczony poziom i składowe sezonowe (można prognozować). */
+    bool isInitialized() const { return !seasonal.empty(); }
+};
+
+/**
+ * @class HoltWintersForecaster
+ * @brief Prognoza krótkoterminowa (np. 24 h) metodą Holta-Wintersa: addytywny sezon dobowy i tłumiony trend.
+ *
+ * Model jest aktualizowany przyrostowo: każda nowa godzina zmienia tylko poziom, trend i jedną składową sezonową
+ * (O(1) na pomiar), bez ponownego dopasowania do całej historii. Stan (ForecastState) jest zapisywany przez
+ * DataStorage, więc po ponownym uruchomieniu aplikacji wystarczy dopisać pomiary nowsze niż lastStepMSecs.
+ * Pomiary są uśredniane do godzin (TimeSeriesResampler); brakujące godziny przesuwają model bez aktualizacji,
+ * a przerwa dłuższa niż MaxGapSeasons sezonów powoduje ponowną inicjalizację.
+ */
+class HoltWintersForecaster
+{
+public:
+    /// Krok modelu w sekundach (dane godzinowe).
+    static constexpr qint64 StepSecs = 3600;
+    /// Przerwa (w sezonach), po której model jest inicjalizowany od nowa.
+    static constexpr int MaxGapSeasons = 7;
+
+    /** @brief Tworzy model z podanym stanem (np. wczytanym z DataStorage lub domyślnym dla nowego czujnika). */
+    explicit HoltWintersForecaster(const ForecastState& state = {});
+
+    /**
+     * @brief Uwzględnia w modelu pomiary nowsze niż ostatnio przetworzone.
+     * @param values Dane czujnika (kolejność dowolna; NaN i błędne daty są pomijane; starsze pomiary są ignorowane).
+     * @return Liczba nowych kroków godzinowych uwzględnionych w modelu (wraz z brakującymi godzinami).
+     * @note Ostatnia (najnowsza) godzina danych jest uwzględniana od razu; późniejsze korekty jej wartości są pomijane.
+     */
+    int update(const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Prognozuje kolejne godziny po ostatnim uwzględnionym kroku.
+     * @param horizonSteps Liczba godzin prognozy (np. 24).
+     * @return Prognozowane wartości (nieujemne) z datami kolejnych godzin; pusty wektor przed inicjalizacją modelu.
+     */
+    std::vector<MeasurementValue> forecast(int horizonSteps) const;
+
+    /** @brief Odchylenie standardowe błędu prognozy o jeden krok (NaN, gdy nieznane). */
+    double oneStepErrorStdDev() const;
+
+    /** @brief Bieżący stan modelu (do zapisania). */
+    const ForecastState& state() const;
+
+private:
+    /// Uwzględnia jeden krok: wartość (NaN - brak pomiaru) w kolejnej godzinie.
+    void step(double value);
+    /// Inicjalizuje poziom i składowe sezonowe z zebranego pierwszego sezonu.
+    void initializeFromWarmup();
+
+    ForecastState m_state;
+};
+
+#endif // HOLTWINTERSFORECASTER_H
@@ -2,7 +2,11 @@
 #include "ui_MainWindow.h"
 #include "ApiService.h"
 #include "DataStorage.h"
+#include "DataRepository.h"
 #include "DataAnalyzer.h"
+#include "MultiSeriesChart.h"
+#include "FleetAnalyzer.h"
+#include "AqiCalculator.h"
 
 #include <QListWidget>
 #include <QMessageBox>
@@ -10,6 +14,7 @@
 #include <QStandardPaths>
 #include <QDateTimeEdit>
 #include <QPushButton>
+#include <QtConcurrent/QtConcurrent>
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -22,20 +27,68 @@
 #include <QtCharts/QLegendMarker>
 #include <QLabel>
 
+namespace {
+
+/**
+ * @brief Zasady porządkowania cache wg zmiennych środowiskowych (domyślnie bez limitów).
+ *
+ * AIRQUALITY_CACHE_MAX_AGE_DAYS - usuwanie pomiarów starszych niż podana liczba dni; AIRQUALITY_CACHE_BUDGET_MB - limit
+ * rozmiaru cache. Historia zaimportowana przez ArchiveImporter nie podlega żadnemu z limitów.
+ */
+RetentionPolicy cacheRetentionPolicy()
+{
+    RetentionPolicy policy;
+    policy.maxAgeDays = qMax(0, qEnvironmentVariableIntValue("AIRQUALITY_CACHE_MAX_AGE_DAYS"));
+    policy.diskBudgetBytes = qMax(0LL, qEnvironmentVariable("AIRQUALITY_CACHE_BUDGET_MB").toLongLong()) * 1024 * 1024;
+    if (policy.maxAgeDays > 0 || policy.diskBudgetBytes > 0) {
+        qInfo() << "Porządkowanie cache: maksymalny wiek" << policy.maxAgeDays << "dni, limit"
+                << policy.diskBudgetBytes / (1024 * 1024) << "MiB (0 - bez limitu).";
+    }
+    return policy;
+}
+
+/**
+ * @brief Ustawia zapis lub odtwarzanie odpowiedzi API wg zmiennych środowiskowych.
+ *
+ * AIRQUALITY_CAPTURE_DIR - katalog zapisu odpowiedzi z sieci; AIRQUALITY_REPLAY_DIR - katalog odpowiedzi odtwarzanych
+ * zamiast sieci, z opóźnieniem AIRQUALITY_REPLAY_LATENCY_MS i przepustowością AIRQUALITY_REPLAY_BYTES_PER_SEC.
+ */
+void configureApiCapture(ApiService* apiService)
+{
+    const QString captureDir = qEnvironmentVariable("AIRQUALITY_CAPTURE_DIR");
+    if (!captureDir.isEmpty()) {
+        apiService->setCaptureDirectory(captureDir);
+        qInfo() << "Zapisywanie odpowiedzi API do katalogu:" << captureDir;
+    }
+
+    const QString replayDir = qEnvironmentVariable("AIRQUALITY_REPLAY_DIR");
+    if (!replayDir.isEmpty()) {
+        ReplayOptions options;
+        options.latencyMs = qEnvironmentVariableIntValue("AIRQUALITY_REPLAY_LATENCY_MS");
+        options.bytesPerSecond = qEnvironmentVariable("AIRQUALITY_REPLAY_BYTES_PER_SEC").toLongLong();
+        apiService->setReplayDirectory(replayDir, options);
+        qInfo() << "Odtwarzanie odpowiedzi API z katalogu:" << replayDir << "opóźnienie [ms]:" << options.latencyMs
+                << "przepustowość [B/s]:" << options.bytesPerSecond;
+    }
+}
+
+} // namespace
+
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_apiService(new ApiService(this))
     , m_dataStorage(new DataStorage("."))
+    , m_repository(new DataRepository(m_apiService, m_dataStorage, this))
     , m_analyzer(new DataAnalyzer())
     , m_chart(new QChart())
     , m_chartView(new QChartView(m_chart))
-    , m_series(new QSplineSeries())
     , m_axisX(new QDateTimeAxis)
     , m_axisY(new QValueAxis)
 {
     ui->setupUi(this);
+    configureApiCapture(m_apiService);
 
     QList<int> initialSizes;
     initialSizes << 380 << 620;
@@ -45,35 +98,39 @@ MainWindow::MainWindow(QWidget *parent)
     ui->startDateTimeEdit->setDisplayFormat(polishDateTimeFormat);
     ui->endDateTimeEdit->setDisplayFormat(polishDateTimeFormat);
 
-    m_chart->addSeries(m_series);
-
     m_axisX->setTickCount(10);
     m_axisX->setFormat("yyyy-MM-dd HH:mm");
     m_axisX->setTitleText("Data i Czas");
     m_chart->addAxis(m_axisX, Qt::AlignBottom);
-    m_series->attachAxis(m_axisX);
 
     m_axisY->setLabelFormat("%.1f");
     m_axisY->setTitleText("Wartość");
     m_chart->addAxis(m_axisY, Qt::AlignLeft);
-    m_series->attachAxis(m_axisY);
+
+    m_seriesChart = new MultiSeriesChart(m_chart, m_axisX, m_axisY);
+    m_fleetAnalyzer = new FleetAnalyzer(m_dataStorage);
+    m_fleetReportWatcher = new QFutureWatcher<FleetReport>(this);
+    connect(m_fleetReportWatcher, &QFutureWatcher<FleetReport>::finished, this, &MainWindow::handleFleetReportFinished);
+    m_compactionWatcher = new QFutureWatcher<CompactionStats>(this);
+    connect(m_compactionWatcher, &QFutureWatcher<CompactionStats>::finished, this, &MainWindow::handleCompactionFinished);
 
     m_chart->legend()->setVisible(true);
     m_chart->legend()->setAlignment(Qt::AlignBottom);
     m_chart->setTitle("Dane Pomiarowe");
 
     if(ui->chartLayout) {
-        ui->chartLayout->insertWidget(2, m_chartView);
+        ui->chartLayout->insertWidget(3, m_chartView);
     } else {
         qWarning("Plik UI nie zawiera layoutu o nazwie 'chartLayout'. Wykres nie będzie wyświetlany.");
     }
     m_chartView->setRenderHint(QPainter::Antialiasing);
 
-    connect(m_apiService, &ApiService::stationsReady, this, &MainWindow::handleStationsReady);
-    connect(m_apiService, &ApiService::sensorsReady, this, &MainWindow::handleSensorsReady);
-    connect(m_apiService, &ApiService::sensorDataReady, this, &MainWindow::handleSensorDataReady);
-    connect(m_apiService, &ApiService::airQualityIndexReady, this, &MainWindow::handleAirQualityIndexReady);
-    connect(m_apiService, &ApiService::networkError, this, &MainWindow::handleNetworkError);
+    connect(m_repository, &DataRepository::stationsReady, this, &MainWindow::handleStationsReady);
+    connect(m_repository, &DataRepository::sensorsReady, this, &MainWindow::handleSensorsReady);
+    connect(m_repository, &DataRepository::sensorDataReady, this, &MainWindow::handleSensorDataReady);
+    connect(m_repository, &DataRepository::airQualityIndexReady, this, &MainWindow::handleAirQualityIndexReady);
+    connect(m_repository, &DataRepository::networkError, this, &MainWindow::handleNetworkError);
+    connect(m_repository, &DataRepository::revalidationFailed, this, &MainWindow::handleRevalidationFailed);
 
     connect(ui->filterDataButton, &QPushButton::clicked, this, &MainWindow::on_filterDataButton_clicked);
     connect(ui->cityFilterLineEdit, &QLineEdit::textChanged, this, &MainWindow::filterStations);
@@ -90,11 +147,39 @@ MainWindow::MainWindow(QWidget *parent)
     ui->clearCityFilterButton->setEnabled(false);
 
     qInfo() << "Ścieżka przechowywania danych:" << m_dataStorage->getStoragePath();
+    // Zapisy cache (przyciski Zapisz i odpowiedzi API) odbywają się w tle - GUI nie czeka na dysk.
+    m_dataStorage->setWriteBehindEnabled(true);
+    // Nowe pliki trafiają do podkatalogów według rodzaju i ID; pliki z płaskiego układu są nadal odczytywane.
+    m_dataStorage->setLayout(StorageLayout::Sharded);
+    const CacheManifest& manifest = m_dataStorage->cacheManifest();
+    qInfo() << "Pliki w cache:" << manifest.size() << "- łącznie" << manifest.totalSize() / 1024 << "KiB, serie pomiarów dla"
+            << manifest.entries(CacheEntityType::SensorSeries).size() << "czujników.";
+
+    std::vector<AlertRule> alertRules = m_dataStorage->loadAlertRules();
+    if (alertRules.empty()) {
+        alertRules = AlertEngine::defaultRules();
+        m_dataStorage->saveAlertRules(alertRules);
+    }
+    m_alertEngine.setRules(alertRules);
+    // Zmiany stanu zgłoszone w poprzednich sesjach nie są pokazywane ponownie po pierwszym wczytaniu danych.
+    m_alertEngine.restoreProgress(m_dataStorage->loadAlertProgress());
+    m_alertEngine.setStations(m_dataStorage->loadStationsFromJson());
+    qInfo() << "Wczytano" << alertRules.size() << "reguł alertów.";
+
+    DataStorage* dataStorage = m_dataStorage;
+    m_compactionWatcher->setFuture(QtConcurrent::run([dataStorage, policy = cacheRetentionPolicy()]() {
+        return dataStorage->compact(policy);
+    }));
     setUiFetchingState(false, false, false);
 }
 
 MainWindow::~MainWindow()
 {
+    m_fleetReportWatcher->waitForFinished();
+    m_compactionWatcher->waitForFinished();
+    delete m_fleetAnalyzer;
+    m_dataStorage->setWriteBehindEnabled(false); // zaległe zapisy trafiają na dysk przed zamknięciem
+    delete m_seriesChart;
     delete ui;
 }
 
@@ -136,7 +221,7 @@ void MainWindow::on_fetchStationsButton_clicked()
     ui->sensorsListWidget->setEnabled(false);
     ui->cityFilterLineEdit->clear();
 
-    m_apiService->fetchAllStations();
+    m_repository->requestStations(true);
 }
 
 void MainWindow::on_loadStationsButton_clicked()
@@ -188,7 +273,7 @@ void MainWindow::on_saveStationsButton_clicked()
     }
     ui->statusbar->showMessage("Zapisywanie stacji do pliku...");
     if(m_dataStorage->saveStationsToJson(m_currentStations)) {
-        ui->statusbar->showMessage("Stacje zapisane pomyślnie.", 3000);
+        ui->statusbar->showMessage("Stacje przekazane do zapisu.", 3000);
     } else {
         QMessageBox::warning(this, "Błąd Zapisu", "Nie udało się zapisać stacji do pliku.");
         ui->statusbar->showMessage("Błąd zapisu stacji.", 5000);
@@ -215,8 +300,8 @@ void MainWindow::on_stationsListWidget_itemClicked(QListWidgetItem *item)
 
         ui->loadSensorDataButton->setEnabled(false);
 
-        m_apiService->fetchSensorsForStation(stationId);
-        m_apiService->fetchAirQualityIndex(stationId);
+        m_repository->requestSensors(stationId);
+        m_repository->requestAirQualityIndex(stationId);
     }
     else {
         m_lastClickedStationId = -1;
@@ -233,7 +318,9 @@ void MainWindow::on_sensorsListWidget_itemClicked(QListWidgetItem *item)
         ui->statusbar->showMessage(QString("Pobieranie danych dla czujnika ID: %1...").arg(sensorId));
         setUiFetchingState(m_isFetchingStations, m_isFetchingSensors, true);
 
-        clearChart();
+        if (!isOverlayEnabled()) {
+            clearChart();
+        }
         clearAnalysisResults();
 
         ui->saveSensorDataButton->setEnabled(false);
@@ -242,7 +329,7 @@ void MainWindow::on_sensorsListWidget_itemClicked(QListWidgetItem *item)
         ui->startDateTimeEdit->setEnabled(false);
         ui->endDateTimeEdit->setEnabled(false);
 
-        m_apiService->fetchSensorData(sensorId);
+        m_repository->requestSensorData(sensorId);
     }
 }
 
@@ -256,7 +343,9 @@ void MainWindow::on_loadSensorDataButton_clicked()
         return;
     }
     ui->statusbar->showMessage(QString("Ładowanie danych dla czujnika %1 z pliku...").arg(sensorId));
-    clearChart();
+    if (!isOverlayEnabled()) {
+        clearChart();
+    }
     clearAnalysisResults();
     loadSensorDataFromFile(sensorId);
 }
@@ -264,16 +353,16 @@ void MainWindow::on_loadSensorDataButton_clicked()
 bool MainWindow::loadSensorDataFromFile(int sensorId) {
     if (sensorId <= 0) return false;
 
-    QString filename = QString("sensor_%1_data.json").arg(sensorId);
-    qDebug() << "Wczytywanie danych czujnika z pliku:" << filename << "w ścieżce:" << m_dataStorage->getStoragePath();
+    qDebug() << "Wczytywanie danych czujnika" << sensorId << "z cache w ścieżce:" << m_dataStorage->getStoragePath();
 
-    SensorData data = m_dataStorage->loadSensorDataFromJson(filename);
-    qDebug() << "Wczytane dane - Klucz:" << data.key << "Liczba wartości:" << data.values.size();
+    std::shared_ptr<const SensorData> data = m_repository->loadSensorData(sensorId);
+    qDebug() << "Wczytane dane - Klucz:" << data->key << "Liczba wartości:" << data->values.size();
 
-    if (!data.key.isEmpty() && !data.values.empty()) {
+    if (!data->key.isEmpty() && !data->values.empty()) {
         m_currentSensorData = data;
-        setupDateTimeEditsWithDataRange(m_currentSensorData.values);
-        updateChart(m_currentSensorData.values, m_currentSensorData.key);
+        updateSensorForecast(sensorId, data->values);
+        setupDateTimeEditsWithDataRange(m_currentSensorData->values);
+        updateChart(sensorId, m_currentSensorData->values, m_currentSensorData->key, true);
         ui->statusbar->showMessage(QString("Dane dla czujnika %1 załadowane z pliku.").arg(sensorId), 3000);
 
         ui->saveSensorDataButton->setEnabled(true);
@@ -286,9 +375,9 @@ bool MainWindow::loadSensorDataFromFile(int sensorId) {
     } else {
         qWarning() << "Wczytane dane są puste lub nieprawidłowe dla czujnika" << sensorId;
         ui->statusbar->showMessage(QString("Brak zapisanych danych dla czujnika %1 w pliku.").arg(sensorId), 5000);
-        m_currentSensorData = SensorData();
+        m_currentSensorData = std::make_shared<const SensorData>();
 
-        clearChart();
+        removeChartSeries(sensorId);
         clearAnalysisResults();
         ui->saveSensorDataButton->setEnabled(false);
         ui->analyzeButton->setEnabled(false);
@@ -308,19 +397,19 @@ void MainWindow::on_saveSensorDataButton_clicked()
         return;
     }
     qDebug() << "on_saveSensorDataButton_clicked: Sprawdzanie m_currentSensorData. Klucz:"
-             << m_currentSensorData.key << "Liczba wartości:" << m_currentSensorData.values.size();
+             << m_currentSensorData->key << "Liczba wartości:" << m_currentSensorData->values.size();
 
-    if (m_currentSensorData.key.isEmpty() || m_currentSensorData.values.empty()) {
+    if (m_currentSensorData->key.isEmpty() || m_currentSensorData->values.empty()) {
         QMessageBox::information(this, "Brak Danych", "Brak aktualnych (pełnych) danych pomiarowych do zapisania dla wybranego czujnika.");
         return;
     }
 
-    QString filename = QString("sensor_%1_data.json").arg(sensorId);
+    QString filename = DataStorage::sensorSeriesFileName(sensorId);
     qDebug() << "Zapisywanie pełnych danych czujnika do pliku:" << filename << "w ścieżce:" << m_dataStorage->getStoragePath();
     ui->statusbar->showMessage(QString("Zapisywanie danych dla czujnika %1...").arg(sensorId));
 
-    if (m_dataStorage->saveSensorDataToJson(m_currentSensorData, filename)) {
-        ui->statusbar->showMessage(QString("Dane dla czujnika %1 zapisane pomyślnie.").arg(sensorId), 3000);
+    if (m_repository->saveSensorData(sensorId, *m_currentSensorData)) {
+        ui->statusbar->showMessage(QString("Dane dla czujnika %1 przekazane do zapisu.").arg(sensorId), 3000);
     } else {
         QMessageBox::warning(this, "Błąd Zapisu", QString("Nie udało się zapisać danych dla czujnika %1.").arg(sensorId));
         ui->statusbar->showMessage(QString("Błąd zapisu danych dla czujnika %1.").arg(sensorId), 5000);
@@ -329,25 +418,26 @@ void MainWindow::on_saveSensorDataButton_clicked()
 
 void MainWindow::on_analyzeButton_clicked()
 {
-    if (m_currentSensorData.key.isEmpty() || m_currentSensorData.values.empty()) {
+    if (m_currentSensorData->key.isEmpty() || m_currentSensorData->values.empty()) {
         QMessageBox::information(this, "Brak Danych", "Brak danych do analizy. Pobierz lub wczytaj dane dla czujnika.");
         return;
     }
     qDebug() << "on_analyzeButton_clicked: Analiza m_currentSensorData. Klucz:"
-             << m_currentSensorData.key << "Liczba wartości:" << m_currentSensorData.values.size();
+             << m_currentSensorData->key << "Liczba wartości:" << m_currentSensorData->values.size();
 
-    qDebug() << "Kliknięto przycisk Analizuj dla pełnych danych czujnika, klucz:" << m_currentSensorData.key;
+    qDebug() << "Kliknięto przycisk Analizuj dla pełnych danych czujnika, klucz:" << m_currentSensorData->key;
     ui->statusbar->showMessage("Analizowanie pełnego zestawu danych...");
 
-    AnalysisResult results = m_analyzer->analyze(m_currentSensorData.values);
+    AnalysisResult results = m_analyzer->analyze(m_currentSensorData->values);
     updateAnalysisResults(results);
+    updateForecastDisplay(getSelectedSensorId());
     ui->statusbar->showMessage("Analiza pełnego zestawu danych zakończona.", 3000);
 }
 
 
 void MainWindow::on_filterDataButton_clicked()
 {
-    if (m_currentSensorData.values.empty()) {
+    if (m_currentSensorData->values.empty()) {
         QMessageBox::information(this, "Brak Danych", "Najpierw załaduj dane dla czujnika.");
         return;
     }
@@ -362,10 +452,10 @@ void MainWindow::on_filterDataButton_clicked()
 
     qDebug() << "Filtrowanie danych od" << startDate.toString(Qt::ISODate) << "do" << endDate.toString(Qt::ISODate);
 
-    std::vector<MeasurementValue> filteredValues = filterDataByDateRange(m_currentSensorData.values, startDate, endDate);
-    qDebug() << "Oryginalne wartości:" << m_currentSensorData.values.size() << "Przefiltrowane wartości:" << filteredValues.size();
+    std::vector<MeasurementValue> filteredValues = filterDataByDateRange(m_currentSensorData->values, startDate, endDate);
+    qDebug() << "Oryginalne wartości:" << m_currentSensorData->values.size() << "Przefiltrowane wartości:" << filteredValues.size();
 
-    updateChart(filteredValues, m_currentSensorData.key);
+    updateChart(getSelectedSensorId(), filteredValues, m_currentSensorData->key, false);
 
     if (!filteredValues.empty()) {
         AnalysisResult filteredResults = m_analyzer->analyze(filteredValues);
@@ -406,6 +496,7 @@ void MainWindow::handleStationsReady(const std::vector<MeasuringStation>& statio
 {
     qDebug() << "Otrzymano" << stations.size() << "stacji.";
     m_currentStations = stations;
+    m_alertEngine.setStations(stations);
     filterStations(ui->cityFilterLineEdit->text());
     ui->saveStationsButton->setEnabled(!stations.empty());
     ui->statusbar->showMessage(QString("Pobrano %1 stacji.").arg(stations.size()), 3000);
@@ -413,51 +504,75 @@ void MainWindow::handleStationsReady(const std::vector<MeasuringStation>& statio
     setUiFetchingState(false, m_isFetchingSensors, m_isFetchingSensorData);
 }
 
-void MainWindow::handleSensorsReady(const std::vector<Sensor>& sensors)
+void MainWindow::handleSensorsReady(int stationId, const std::vector<Sensor>& sensors)
 {
-    qDebug() << "Otrzymano" << sensors.size() << "czujników.";
+    qDebug() << "Otrzymano" << sensors.size() << "czujników dla stacji" << stationId;
+    m_alertEngine.setSensors(sensors);
+    if (stationId != m_lastClickedStationId) {
+        qDebug() << "Pominięto czujniki dla stacji" << stationId << "- wybrano już inną stację.";
+        return;
+    }
     m_currentSensors = sensors;
     updateSensorsList(sensors);
+    ui->sensorsListWidget->setEnabled(true);
     ui->statusbar->showMessage(QString("Pobrano %1 czujników dla wybranej stacji.").arg(sensors.size()), 3000);
-    if (m_lastClickedStationId > 0 && !sensors.empty()) {
-        qDebug() << "Próba zapisu listy czujników dla stacji" << m_lastClickedStationId;
-        if (!m_dataStorage->saveSensorsToJson(m_lastClickedStationId, sensors)) {
-            qWarning() << "Nie udało się zapisać listy czujników dla stacji" << m_lastClickedStationId;
-        }
-    }
 
     setUiFetchingState(m_isFetchingStations, false, m_isFetchingSensorData);
 }
 
-void MainWindow::handleSensorDataReady(const SensorData& data)
+void MainWindow::handleSensorDataReady(int sensorId, const SensorData& data)
 {
-    qDebug() << "Otrzymano dane dla klucza:" << data.key << "z" << data.values.size() << "wartościami.";
-    m_currentSensorData = data;
+    qDebug() << "Otrzymano dane czujnika" << sensorId << "dla klucza:" << data.key << "z" << data.values.size() << "wartościami.";
+    std::vector<AlertEvent> alertEvents;
+    if (!data.values.empty()) {
+        m_analyzer->updateSeriesSketch(sensorId, data.values);
+        updateSensorForecast(sensorId, data.values);
+        alertEvents = m_alertEngine.addSensorData(sensorId, data);
+        m_dataStorage->saveAlertProgress(m_alertEngine.progress());
+        const std::vector<Anomaly> anomalies = m_analyzer->updateSeriesAnomalies(sensorId, data.values);
+        if (!anomalies.empty()) {
+            qInfo() << "Czujnik" << sensorId << "- wykryto" << anomalies.size() << "nowych podejrzanych pomiarów, ostatni:"
+                    << AnomalyDetector::typeName(anomalies.back().type) << anomalies.back().date.toString("yyyy-MM-dd HH:mm")
+                    << "wartość" << anomalies.back().value;
+        }
+    }
+    if (sensorId != getSelectedSensorId()) {
+        qDebug() << "Pominięto dane czujnika" << sensorId << "- wybrano już inny czujnik.";
+        reportAlertEvents(alertEvents);
+        return;
+    }
+    // Repozytorium emituje obiekt trzymany w swojej pamięci podręcznej - wtedy jest współdzielony bez kopiowania serii.
+    std::shared_ptr<const SensorData> cached = m_repository->sensorDataCache().peek(sensorId);
+    m_currentSensorData = (cached && cached.get() == &data) ? cached : std::make_shared<const SensorData>(data);
 
-    if (!m_currentSensorData.key.isEmpty() && !m_currentSensorData.values.empty()) {
+    if (!m_currentSensorData->key.isEmpty() && !m_currentSensorData->values.empty()) {
         qDebug() << "handleSensorDataReady: Dane są prawidłowe. Aktualizacja UI.";
-        setupDateTimeEditsWithDataRange(m_currentSensorData.values);
-        updateChart(m_currentSensorData.values, m_currentSensorData.key);
+        setupDateTimeEditsWithDataRange(m_currentSensorData->values);
+        updateChart(sensorId, m_currentSensorData->values, m_currentSensorData->key, true);
         ui->saveSensorDataButton->setEnabled(true);
         ui->analyzeButton->setEnabled(true);
         ui->filterDataButton->setEnabled(true);
         ui->startDateTimeEdit->setEnabled(true);
         ui->endDateTimeEdit->setEnabled(true);
-        ui->statusbar->showMessage(QString("Pobrano dane dla parametru: %1").arg(data.key), 3000);
+        const std::size_t anomalyCount = m_analyzer->seriesAnomalies(sensorId).size();
+        ui->statusbar->showMessage(anomalyCount > 0
+                                       ? QString("Pobrano dane dla parametru: %1 (podejrzane pomiary: %2)").arg(data.key).arg(anomalyCount)
+                                       : QString("Pobrano dane dla parametru: %1").arg(data.key), 3000);
     } else {
         qWarning() << "Otrzymano sygnał sensorDataReady, ale klucz danych jest pusty lub brak wartości. Czyszczenie UI.";
         QMessageBox::information(this, "Brak Danych", "Nie udało się pobrać danych pomiarowych dla tego czujnika lub brak wartości w odpowiedzi API.");
         ui->statusbar->showMessage("Brak danych pomiarowych dla wybranego czujnika.", 5000);
-        clearChart();
+        removeChartSeries(sensorId);
         clearAnalysisResults();
         ui->saveSensorDataButton->setEnabled(false);
         ui->analyzeButton->setEnabled(false);
         ui->filterDataButton->setEnabled(false);
         ui->startDateTimeEdit->setEnabled(false);
         ui->endDateTimeEdit->setEnabled(false);
-        m_currentSensorData = SensorData();
+        m_currentSensorData = std::make_shared<const SensorData>();
     }
 
+    reportAlertEvents(alertEvents); // po komunikacie o pobraniu danych, aby go nie zasłonił
     setUiFetchingState(m_isFetchingStations, m_isFetchingSensors, false);
 }
 
@@ -466,19 +581,25 @@ void MainWindow::handleAirQualityIndexReady(const AirQualityIndex& index)
 {
     qDebug() << "Otrzymano AQI dla stacji ID:" << index.stationId;
     if (index.stationId != -1) {
+        reportAlertEvents(m_alertEngine.addAirQualityIndex(index));
+        m_dataStorage->saveAlertProgress(m_alertEngine.progress());
+        if (index.stationId != m_lastClickedStationId) {
+            qDebug() << "Pominięto AQI dla stacji" << index.stationId << "- wybrano już inną stację.";
+            return;
+        }
         m_currentAirQualityIndex = index;
         updateAirQualityIndexDisplay(index);
-
-        qDebug() << "Próba zapisu AQI dla stacji" << index.stationId;
-        if (!m_dataStorage->saveAirQualityIndexToJson(index.stationId, index)) {
-            qWarning() << "Nie udało się zapisać AQI dla stacji" << index.stationId;
-        }
-
     } else {
-        qWarning() << "Otrzymano nieprawidłowy AQI (ID=-1), nie zapisuję i nie aktualizuję UI.";
+        qWarning() << "Otrzymano nieprawidłowy AQI (ID=-1), nie aktualizuję UI.";
     }
 }
 
+void MainWindow::handleRevalidationFailed(const QString& errorMsg)
+{
+    qWarning() << "Nie udało się odświeżyć danych:" << errorMsg;
+    ui->statusbar->showMessage("Brak połączenia z API - wyświetlane są dane z pamięci podręcznej.", 5000);
+}
+
 void MainWindow::handleNetworkError(const QString& errorMsg)
 {
     qWarning() << "Błąd Sieci/Przetwarzania:" << errorMsg;
@@ -577,6 +698,15 @@ void MainWindow::handleNetworkError(const QString& errorMsg)
                     setUiFetchingState(m_isFetchingStations, false, m_isFetchingSensorData);
                 } else {
                     qDebug() << "Nie znaleziono AQI w cache dla stacji" << currentStationId;
+                    AirQualityIndex localIndex = computeLocalAirQualityIndex(currentStationId);
+                    if (localIndex.stationId != -1) {
+                        m_currentAirQualityIndex = localIndex;
+                        updateAirQualityIndexDisplay(localIndex);
+                        ui->statusbar->showMessage(QString("Błąd sieci. Wyświetlono indeks obliczony lokalnie z zapisanych pomiarów stacji %1.").arg(currentStationId), 5000);
+                        handled = true;
+
+                        setUiFetchingState(m_isFetchingStations, false, m_isFetchingSensorData);
+                    }
                 }
             } else {
                 qWarning() << "Nie można wczytać AQI z cache, brak ID stacji.";
@@ -605,7 +735,7 @@ void MainWindow::handleNetworkError(const QString& errorMsg)
             ui->startDateTimeEdit->setEnabled(false);
             ui->endDateTimeEdit->setEnabled(false);
             ui->saveSensorDataButton->setEnabled(false);
-            clearChart();
+            removeChartSeries(currentSensorId);
             clearAnalysisResults();
         }
         else if (wasFetchingStations) setUiFetchingState(false, m_isFetchingSensors, m_isFetchingSensorData);
@@ -689,102 +819,219 @@ void MainWindow::updateSensorsList(const std::vector<Sensor>& sensors)
 }
 
 
-void MainWindow::updateChart(const std::vector<MeasurementValue>& valuesToPlot, const QString& seriesKey)
+void MainWindow::updateChart(int seriesId, const std::vector<MeasurementValue>& valuesToPlot, const QString& seriesKey, bool incremental)
 {
-    m_series->clear();
-
-    if (valuesToPlot.empty()) {
-        m_chart->setTitle(QString("Brak danych dla '%1'").arg(seriesKey.isEmpty() ? "wybranego czujnika" : seriesKey));
-        m_axisX->setRange(QDateTime::currentDateTime().addDays(-1), QDateTime::currentDateTime());
-        m_axisY->setRange(0, 10);
+    if (!isOverlayEnabled()) {
+        m_seriesChart->removeAllExcept(seriesId);
+    }
 
-        if (!m_chart->legend()->markers(m_series).isEmpty()) {
-            m_chart->legend()->markers(m_series).first()->setVisible(false);
+    QString seriesName = seriesKey;
+    if (isOverlayEnabled()) {
+        for (const auto& station : m_currentStations) {
+            if (station.id == m_lastClickedStationId) {
+                seriesName = QString("%1 - %2").arg(seriesKey).arg(station.stationName);
+                break;
+            }
         }
-        return;
     }
 
-    m_series->setName(seriesKey);
+    if (incremental) {
+        m_seriesChart->updateSeries(seriesId, seriesName, valuesToPlot);
+    } else {
+        m_seriesChart->replaceSeries(seriesId, seriesName, valuesToPlot);
+    }
+    std::vector<MeasurementValue> anomalyPoints;
+    for (const Anomaly& anomaly : m_analyzer->seriesAnomalies(seriesId)) {
+        anomalyPoints.push_back({anomaly.date, anomaly.value});
+    }
+    m_seriesChart->setSeriesMarkers(seriesId, anomalyPoints);
 
-    qint64 minTimestamp = std::numeric_limits<qint64>::max();
-    qint64 maxTimestamp = std::numeric_limits<qint64>::min();
-    double minValue = std::numeric_limits<double>::max();
-    double maxValue = -std::numeric_limits<double>::max();
-    bool validValueFound = false;
+    qDebug() << "Seria" << seriesId << "- narysowane punkty:" << m_seriesChart->plottedPointCount(seriesId)
+             << "z" << valuesToPlot.size() << "(serii na wykresie:" << m_seriesChart->seriesCount() << ")";
 
-    QList<QPointF> points;
-    points.reserve(valuesToPlot.size());
+    updateChartTitle(seriesKey);
+}
 
-    for (const auto& mv : valuesToPlot) {
-        if (mv.date.isValid() && !std::isnan(mv.value)) {
-            points.append(QPointF(mv.date.toMSecsSinceEpoch(), mv.value));
+void MainWindow::updateChartTitle(const QString& seriesKey)
+{
+    QDateTime minDate, maxDate;
+    if (!m_seriesChart->timeRange(minDate, maxDate)) {
+        m_chart->setTitle(QString("Brak ważnych danych dla '%1'").arg(seriesKey.isEmpty() ? "wybranego czujnika" : seriesKey));
+        return;
+    }
 
-            qint64 currentTimestamp = mv.date.toMSecsSinceEpoch();
-            minTimestamp = std::min(minTimestamp, currentTimestamp);
-            maxTimestamp = std::max(maxTimestamp, currentTimestamp);
-            minValue = std::min(minValue, mv.value);
-            maxValue = std::max(maxValue, mv.value);
-            validValueFound = true;
-        } else {
-            qDebug() << "Pominięcie nieprawidłowego punktu: Data=" << mv.date << "Wartość=" << mv.value;
-        }
+    QString title;
+    if (m_seriesChart->seriesCount() > 1) {
+        title = QString("Porównanie %1 serii (%2 - %3)")
+                    .arg(m_seriesChart->seriesCount())
+                    .arg(minDate.toString("yyyy-MM-dd HH:mm"))
+                    .arg(maxDate.toString("yyyy-MM-dd HH:mm"));
+    } else {
+        title = QString("Dane dla %1 (%2 - %3)")
+                    .arg(seriesKey)
+                    .arg(minDate.toString("yyyy-MM-dd HH:mm"))
+                    .arg(maxDate.toString("yyyy-MM-dd HH:mm"));
     }
+    m_chart->setTitle(title);
+}
 
-    m_series->replace(points);
+void MainWindow::removeChartSeries(int seriesId)
+{
+    if (!isOverlayEnabled() || m_seriesChart->seriesCount() <= 1) {
+        clearChart();
+        return;
+    }
+    m_seriesChart->removeSeries(seriesId);
+    updateChartTitle(m_currentSensorData->key);
+}
 
-    if (validValueFound) {
-        QDateTime minDate = QDateTime::fromMSecsSinceEpoch(minTimestamp);
-        QDateTime maxDate = QDateTime::fromMSecsSinceEpoch(maxTimestamp);
+bool MainWindow::isOverlayEnabled() const
+{
+    return ui->overlayCheckBox && ui->overlayCheckBox->isChecked();
+}
 
-        if (minTimestamp == maxTimestamp) {
-            m_axisX->setMin(minDate.addSecs(-3600));
-            m_axisX->setMax(maxDate.addSecs(3600));
+void MainWindow::on_overlayCheckBox_toggled(bool checked)
+{
+    qDebug() << "Tryb nakładania serii:" << checked;
+    if (!checked) {
+        int sensorId = getSelectedSensorId();
+        m_seriesChart->removeAllExcept(sensorId);
+        if (m_seriesChart->seriesCount() == 0) {
+            clearChart();
         } else {
-            qint64 timeRange = maxTimestamp - minTimestamp;
-            qint64 timePadding = std::max((qint64)3600 * 1000, timeRange / 20);
-            m_axisX->setMin(QDateTime::fromMSecsSinceEpoch(minTimestamp - timePadding));
-            m_axisX->setMax(QDateTime::fromMSecsSinceEpoch(maxTimestamp + timePadding));
+            updateChartTitle(m_currentSensorData->key);
         }
+    }
+}
 
-        double yRange = maxValue - minValue;
-        double yPadding;
-        if (yRange <= 1e-9) {
-            yPadding = std::max(1.0, std::abs(minValue * 0.1));
-        } else {
-            yPadding = yRange * 0.1;
-        }
-        double finalMinY = std::floor(minValue - yPadding);
-        double finalMaxY = std::ceil(maxValue + yPadding);
+void MainWindow::on_clearChartButton_clicked()
+{
+    clearChart();
+}
 
-        if(std::isfinite(finalMinY) && std::isfinite(finalMaxY) && finalMaxY > finalMinY) {
-            m_axisY->setMin(finalMinY);
-            m_axisY->setMax(finalMaxY);
-        } else {
-            qWarning() << "Nieprawidłowy obliczony zakres osi Y (Min:" << finalMinY << "Max:" << finalMaxY << "), ustawianie domyślnego.";
-            if (std::isfinite(minValue) && std::isfinite(maxValue)) {
-                m_axisY->setRange(minValue - std::max(1.0, std::abs(minValue*0.1)), maxValue + std::max(1.0, std::abs(maxValue*0.1)));
-            } else {
-                m_axisY->setRange(0, 10);
-            }
-        }
+void MainWindow::on_fleetReportButton_clicked()
+{
+    if (m_fleetReportWatcher->isRunning()) {
+        return;
+    }
 
-        QString title = QString("Dane dla %1 (%2 - %3)")
-                            .arg(seriesKey)
-                            .arg(minDate.toString("yyyy-MM-dd HH:mm"))
-                            .arg(maxDate.toString("yyyy-MM-dd HH:mm"));
-        m_chart->setTitle(title);
+    ui->fleetReportButton->setEnabled(false);
+    ui->statusbar->showMessage("Analizowanie wszystkich czujników zapisanych w cache...");
+    m_fleetAnalyzer->setOptions(m_analyzer->options());
+
+    FleetAnalyzer* fleetAnalyzer = m_fleetAnalyzer;
+    m_fleetReportWatcher->setFuture(QtConcurrent::run([fleetAnalyzer]() {
+        return fleetAnalyzer->run();
+    }));
+}
 
-        if (!m_chart->legend()->markers(m_series).isEmpty()) {
-            m_chart->legend()->markers(m_series).first()->setVisible(true);
+void MainWindow::handleFleetReportFinished()
+{
+    ui->fleetReportButton->setEnabled(true);
+    FleetReport report = m_fleetReportWatcher->result();
+    ui->statusbar->showMessage(QString("Raport floty: %1 czujników w %2 ms.")
+                                   .arg(report.rows.size()).arg(report.elapsedMs), 5000);
+    showFleetReport(report);
+}
+
+void MainWindow::handleCompactionFinished()
+{
+    const CompactionStats stats = m_compactionWatcher->result();
+    qInfo() << "Porządkowanie cache zakończone: usunięto" << stats.filesRemoved << "plików, przepisano"
+            << stats.filesRewritten << "serii, usunięto" << stats.historyRecordsRemoved << "wpisów historii AQI;"
+            << stats.bytesBefore / 1024 << "->" << stats.bytesAfter / 1024 << "KiB.";
+}
+
+void MainWindow::showFleetReport(const FleetReport& report)
+{
+    if (report.rows.empty()) {
+        QMessageBox::information(this, "Raport floty", "Brak danych pomiarowych w cache. Pobierz dane czujników, aby utworzyć raport.");
+        return;
+    }
+
+    auto formatGroup = [](const FleetAggregate& group) {
+        auto number = [](const std::optional<double>& value) {
+            return value ? QString::number(*value, 'f', 1) : QString("-");
+        };
+        return QString("%1: %2 czujn., średnia %3, P50 %4, P90 %5, P98 %6, max %7 (trend ↑%8 ↓%9)")
+            .arg(group.group)
+            .arg(group.sensorCount)
+            .arg(number(group.average))
+            .arg(number(group.p50))
+            .arg(number(group.p90))
+            .arg(number(group.p98))
+            .arg(number(group.maxValue))
+            .arg(group.increasingCount)
+            .arg(group.decreasingCount);
+    };
+
+    QStringList parameterLines;
+    for (const FleetAggregate& group : report.byParameter) {
+        parameterLines << formatGroup(group);
+    }
+    QStringList provinceLines;
+    for (const FleetAggregate& group : report.byProvince) {
+        provinceLines << formatGroup(group);
+    }
+
+    std::vector<const FleetSensorRow*> forecastRows;
+    for (const FleetSensorRow& row : report.rows) {
+        if (row.forecastMax24h) forecastRows.push_back(&row);
+    }
+    const std::size_t forecastLimit = std::min<std::size_t>(forecastRows.size(), 10);
+    std::partial_sort(forecastRows.begin(), forecastRows.begin() + forecastLimit, forecastRows.end(),
+                      [](const FleetSensorRow* a, const FleetSensorRow* b) { return *a->forecastMax24h > *b->forecastMax24h; });
+    QStringList forecastLines;
+    for (std::size_t i = 0; i < forecastLimit; ++i) {
+        const FleetSensorRow* row = forecastRows[i];
+        forecastLines << QString("%1 (%2, czujnik %3): średnia %4, max %5")
+                             .arg(row->stationName.isEmpty() ? QString("-") : row->stationName)
+                             .arg(row->paramCode)
+                             .arg(row->sensorId)
+                             .arg(QString::number(*row->forecastMean24h, 'f', 1))
+                             .arg(QString::number(*row->forecastMax24h, 'f', 1));
+    }
+
+    QMessageBox box(this);
+    box.setWindowTitle("Raport floty");
+    box.setIcon(QMessageBox::Information);
+    box.setText(QString("Przeanalizowano %1 czujników w %2 ms (wątki: %3, błędy odczytu: %4).\n\nWg parametru:\n%5")
+                    .arg(report.rows.size())
+                    .arg(report.elapsedMs)
+                    .arg(report.threadCount)
+                    .arg(report.failedCount)
+                    .arg(parameterLines.join("\n")));
+    box.setDetailedText("Wg województwa:\n" + provinceLines.join("\n")
+                        + "\n\nNajwyższe prognozy 24h (maksimum):\n"
+                        + (forecastLines.isEmpty() ? QString("brak modeli prognozy") : forecastLines.join("\n")));
+    box.exec();
+}
+
+void MainWindow::on_robustTrendCheckBox_toggled(bool checked)
+{
+    AnalyzerOptions options = m_analyzer->options();
+    options.trendMethod = checked ? TrendMethod::TheilSen : TrendMethod::LeastSquares;
+    m_analyzer->setOptions(options);
+    qDebug() << "Metoda trendu:" << (checked ? "Theil-Sen" : "regresja liniowa");
+}
+
+AirQualityIndex MainWindow::computeLocalAirQualityIndex(int stationId) const
+{
+    std::vector<SensorData> series;
+    for (const Sensor& sensor : m_currentSensors) {
+        if (sensor.stationId != stationId || !AqiCalculator::pollutantFromCode(sensor.param.paramCode)) {
+            continue;
         }
-    } else {
-        m_chart->setTitle(QString("Brak ważnych danych dla '%1'").arg(seriesKey));
-        m_axisX->setRange(QDateTime::currentDateTime().addDays(-1), QDateTime::currentDateTime());
-        m_axisY->setRange(0, 10);
-        if (!m_chart->legend()->markers(m_series).isEmpty()) {
-            m_chart->legend()->markers(m_series).first()->setVisible(false);
+        SensorData data = *m_repository->loadSensorData(sensor.id); // najpierw pamięć podręczna repozytorium
+        if (!data.values.empty()) {
+            data.key = sensor.param.paramCode;
+            series.push_back(std::move(data));
         }
     }
+
+    AirQualityIndex index = AqiCalculator::computeIndex(stationId, series);
+    qDebug() << "Lokalny indeks AQI dla stacji" << stationId << "z" << series.size() << "serii:" << indexLevelName(index.stIndexLevel);
+    return index;
 }
 
 void MainWindow::updateAirQualityIndexDisplay(const AirQualityIndex& index) {
@@ -814,7 +1061,15 @@ void MainWindow::updateAirQualityIndexDisplay(const AirQualityIndex& index) {
         }
     }
 
-    if(ui->aqiStationLabel) ui->aqiStationLabel->setText(QString("Indeks dla: %1").arg(stationName));
+    if(ui->aqiStationLabel) {
+        ui->aqiStationLabel->setText(QString("Indeks dla: %1").arg(stationName));
+        const QDateTime now = QDateTime::currentDateTime();
+        const AqiLevelDurations lastMonth =
+            m_dataStorage->airQualityIndexHistory().levelDurations(index.stationId, now.addDays(-30), now);
+        ui->aqiStationLabel->setToolTip(QString("Ostatnie 30 dni (historia indeksów): %1: %2 h, %3: %4 h")
+                                            .arg(indexLevelName(4)).arg(lastMonth.hours(4), 0, 'f', 1)
+                                            .arg(indexLevelName(5)).arg(lastMonth.hours(5), 0, 'f', 1));
+    }
     if(ui->aqiCalcDateLabel) {
         QString calcDateText = QString("Obliczony: %1")
         .arg(index.stCalcDate.isValid() ? index.stCalcDate.toString("dd.MM.yyyy HH:mm") : "Brak danych");
@@ -823,32 +1078,25 @@ void MainWindow::updateAirQualityIndexDisplay(const AirQualityIndex& index) {
                                              .arg(index.stSourceDataDate.isValid() ? index.stSourceDataDate.toString("dd.MM.yyyy HH:mm") : "Brak danych"));
     }
 
-    auto setRichTextLabel = [](QLabel* label, const QString& prefix, const IndexLevel& level) {
+    // Kolory poziomów indeksu wg GIOŚ, indeksowane ID poziomu (0 - Bardzo dobry ... 5 - Bardzo zły).
+    static constexpr std::array<const char*, IndexLevelCount> levelColors = {{
+        "#2bb51f", "#6ab51f", "#b3b51f", "#b5831f", "#b5291f", "#4124b5"
+    }};
+
+    auto setRichTextLabel = [](QLabel* label, const QString& prefix, int levelId) {
         if (!label) return;
 
         QString richText;
         QString toolTipText;
-        QString textColorHex = "#000000";
 
         label->setTextFormat(Qt::RichText);
 
-        if (level.id != -1 && !level.indexLevelName.isEmpty() && level.indexLevelName != "Brak indeksu") {
-            QString levelName = level.indexLevelName;
-            toolTipText = QString("ID poziomu: %1").arg(level.id);
-
-            QString levelNameLower = level.indexLevelName.toLower();
-            if (levelNameLower == QLatin1String("bardzo dobry")) { textColorHex = "#2bb51f"; }
-            else if (levelNameLower == QLatin1String("dobry")) { textColorHex = "#6ab51f"; }
-            else if (levelNameLower == QLatin1String("umiarkowany")) { textColorHex = "#b3b51f"; }
-            else if (levelNameLower == QLatin1String("dostateczny")) { textColorHex = "#b5831f"; }
-            else if (levelNameLower == QLatin1String("zły")) { textColorHex = "#b5291f"; }
-            else if (levelNameLower == QLatin1String("bardzo zły")) { textColorHex = "#4124b5"; }
-            else { textColorHex = "#808080"; }
-
+        if (levelId >= 0 && levelId < IndexLevelCount) {
+            toolTipText = QString("ID poziomu: %1").arg(levelId);
             richText = QString("%1 <span style=\"color:%2; font-weight: bold;\">%3</span>")
                            .arg(prefix)
-                           .arg(textColorHex)
-                           .arg(levelName);
+                           .arg(QLatin1String(levelColors[static_cast<std::size_t>(levelId)]))
+                           .arg(indexLevelName(levelId));
         } else {
             richText = prefix + " Brak danych";
             toolTipText = "Indeks niedostępny lub brak danych";
@@ -859,13 +1107,14 @@ void MainWindow::updateAirQualityIndexDisplay(const AirQualityIndex& index) {
     };
 
     setRichTextLabel(ui->aqiOverallLabel, "Ogólny:", index.stIndexLevel);
-    setRichTextLabel(ui->aqiPM10Label, "PM10:", index.pm10IndexLevel);
-    setRichTextLabel(ui->aqiPM25Label, "PM2.5:", index.pm25IndexLevel);
-    setRichTextLabel(ui->aqiO3Label, "O3:", index.o3IndexLevel);
-    setRichTextLabel(ui->aqiNO2Label, "NO2:", index.no2IndexLevel);
-    setRichTextLabel(ui->aqiSO2Label, "SO2:", index.so2IndexLevel);
-    setRichTextLabel(ui->aqiCOLabel, "CO:", index.coIndexLevel);
-    setRichTextLabel(ui->aqiC6H6Label, "C6H6:", index.c6h6IndexLevel);
+    const std::pair<QLabel*, Pollutant> pollutantLabels[] = {
+        {ui->aqiPM10Label, Pollutant::PM10}, {ui->aqiPM25Label, Pollutant::PM25}, {ui->aqiO3Label, Pollutant::O3},
+        {ui->aqiNO2Label, Pollutant::NO2},   {ui->aqiSO2Label, Pollutant::SO2},   {ui->aqiCOLabel, Pollutant::CO},
+        {ui->aqiC6H6Label, Pollutant::C6H6},
+    };
+    for (const auto& [label, pollutant] : pollutantLabels) {
+        setRichTextLabel(label, AqiCalculator::pollutantCode(pollutant) + ":", index.level(pollutant));
+    }
 }
 
 void MainWindow::updateAnalysisResults(const AnalysisResult& result) {
@@ -906,6 +1155,19 @@ void MainWindow::updateAnalysisResults(const AnalysisResult& result) {
         if(ui->analysisAvgLabel) ui->analysisAvgLabel->setText("Średnia: Brak danych");
     }
 
+    if (result.p50 && result.p90 && result.p98) {
+        if(ui->analysisPercentilesLabel) {
+            QString percentilesText = QString("P50 / P90 / P98: <b>%1</b> / <b>%2</b> / <b>%3</b>")
+                                          .arg(QString::number(*result.p50, 'f', 2))
+                                          .arg(QString::number(*result.p90, 'f', 2))
+                                          .arg(QString::number(*result.p98, 'f', 2));
+            ui->analysisPercentilesLabel->setTextFormat(Qt::RichText);
+            ui->analysisPercentilesLabel->setText(percentilesText);
+        }
+    } else {
+        if(ui->analysisPercentilesLabel) ui->analysisPercentilesLabel->setText("P50 / P90 / P98: Brak danych");
+    }
+
     QString trendStr = "Trend: ";
     QString slopeToolTip = "";
 
@@ -932,6 +1194,10 @@ void MainWindow::updateAnalysisResults(const AnalysisResult& result) {
         break;
     }
 
+    if (result.trendPValue) {
+        slopeToolTip += QString("\nTest Manna-Kendalla: p = %1").arg(*result.trendPValue, 0, 'g', 3);
+    }
+
     if(ui->analysisTrendLabel) {
         ui->analysisTrendLabel->setTextFormat(Qt::RichText);
         ui->analysisTrendLabel->setText(trendStr);
@@ -939,6 +1205,67 @@ void MainWindow::updateAnalysisResults(const AnalysisResult& result) {
     }
 }
 
+void MainWindow::reportAlertEvents(const std::vector<AlertEvent>& events) {
+    if (events.empty()) return;
+
+    for (const AlertEvent& event : events) {
+        if (event.raised) {
+            qWarning() << AlertEngine::describe(event);
+        } else {
+            qInfo() << AlertEngine::describe(event);
+        }
+    }
+    ui->statusbar->showMessage(QString("%1 (aktywne alerty: %2)")
+                                   .arg(AlertEngine::describe(events.back()))
+                                   .arg(m_alertEngine.activeAlertCount()), 10000);
+}
+
+void MainWindow::updateSensorForecast(int sensorId, const std::vector<MeasurementValue>& values) {
+    auto it = m_forecasters.find(sensorId);
+    if (it == m_forecasters.end()) {
+        it = m_forecasters.emplace(sensorId, HoltWintersForecaster(m_repository->loadForecastState(sensorId))).first;
+    }
+
+    const int newSteps = it->second.update(values);
+    if (newSteps > 0) {
+        qDebug() << "Prognoza czujnika" << sensorId << "- uwzględniono" << newSteps << "nowych godzin.";
+        m_repository->saveForecastState(it->second.state());
+    }
+}
+
+void MainWindow::updateForecastDisplay(int sensorId) {
+    if (!ui->analysisForecastLabel) return;
+
+    auto it = m_forecasters.find(sensorId);
+    const std::vector<MeasurementValue> forecast =
+        it != m_forecasters.end() ? it->second.forecast(24) : std::vector<MeasurementValue>();
+    if (forecast.empty()) {
+        ui->analysisForecastLabel->setText("Prognoza 24h: Za mało danych (wymagana pełna doba pomiarów)");
+        ui->analysisForecastLabel->setToolTip("");
+        return;
+    }
+
+    double sum = 0.0;
+    const MeasurementValue* peak = &forecast.front();
+    QString toolTip = "Prognoza godzinowa (Holt-Winters):";
+    for (const MeasurementValue& mv : forecast) {
+        sum += mv.value;
+        if (mv.value > peak->value) peak = &mv;
+        toolTip += QString("\n%1: %2").arg(mv.date.toString("HH:mm dd.MM")).arg(QString::number(mv.value, 'f', 1));
+    }
+    const double errorStdDev = it->second.oneStepErrorStdDev();
+    if (!std::isnan(errorStdDev)) {
+        toolTip += QString("\nOdchylenie błędu prognozy na 1 h: %1").arg(QString::number(errorStdDev, 'f', 2));
+    }
+
+    ui->analysisForecastLabel->setTextFormat(Qt::RichText);
+    ui->analysisForecastLabel->setText(QString("Prognoza 24h: średnia <b>%1</b>, max <b>%2</b> (%3)")
+                                           .arg(QString::number(sum / static_cast<double>(forecast.size()), 'f', 2))
+                                           .arg(QString::number(peak->value, 'f', 2))
+                                           .arg(peak->date.toString("HH:mm dd.MM")));
+    ui->analysisForecastLabel->setToolTip(toolTip);
+}
+
 void MainWindow::displayErrorMessage(const QString& message) {
     QMessageBox::critical(this, "Błąd Krytyczny", message);
 }
@@ -946,7 +1273,7 @@ void MainWindow::displayErrorMessage(const QString& message) {
 void MainWindow::clearSensorDetails() {
     qDebug() << ">>> Czyszczenie Szczegółów Czujnika <<<";
     m_currentSensors.clear();
-    m_currentSensorData = SensorData();
+    m_currentSensorData = std::make_shared<const SensorData>();
     updateSensorsList({});
     ui->sensorsListWidget->setEnabled(false);
 
@@ -959,29 +1286,27 @@ void MainWindow::clearSensorDetails() {
     ui->startDateTimeEdit->setDateTime(QDateTime::currentDateTime().addDays(-1));
     ui->endDateTimeEdit->setDateTime(QDateTime::currentDateTime());
 
-    clearChart();
+    if (!isOverlayEnabled()) {
+        clearChart();
+    }
     clearAnalysisResults();
 }
 
 void MainWindow::clearChart() {
     qDebug() << ">>> Czyszczenie Wykresu <<<";
-    m_series->clear();
+    m_seriesChart->clear();
     m_chart->setTitle("Wybierz czujnik i pobierz/wczytaj dane");
-
-    m_axisX->setRange(QDateTime::currentDateTime().addDays(-1), QDateTime::currentDateTime());
-    m_axisY->setRange(0, 10);
-
-    if (!m_chart->legend()->markers(m_series).isEmpty()) {
-        m_chart->legend()->markers(m_series).first()->setVisible(false);
-    }
 }
 
 void MainWindow::clearAnalysisResults() {
     if(ui->analysisMinLabel) ui->analysisMinLabel->setText("Min:");
     if(ui->analysisMaxLabel) ui->analysisMaxLabel->setText("Max:");
     if(ui->analysisAvgLabel) ui->analysisAvgLabel->setText("Średnia:");
+    if(ui->analysisPercentilesLabel) ui->analysisPercentilesLabel->setText("P50 / P90 / P98:");
     if(ui->analysisTrendLabel) ui->analysisTrendLabel->setText("Trend:");
     if(ui->analysisTrendLabel) ui->analysisTrendLabel->setToolTip("");
+    if(ui->analysisForecastLabel) ui->analysisForecastLabel->setText("Prognoza 24h:");
+    if(ui->analysisForecastLabel) ui->analysisForecastLabel->setToolTip("");
 }
 
 void MainWindow::clearAirQualityIndexDisplay() {
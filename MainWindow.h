@@ -6,9 +6,14 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QFutureWatcher>
 #include <vector>
+#include <map>
+#include <memory>
 #include "DataStructures.h" // Podstawowe struktury danych
 #include "DataAnalyzer.h"   // Do wyników analizy
+#include "HoltWintersForecaster.h"
+#include "AlertEngine.h"
 
 // Forward declarations dla klas QtCharts
 #include <QtCharts/QChartView>
@@ -21,7 +26,12 @@
 namespace Ui { class MainWindow; }
 class ApiService;
 class DataStorage;
+class DataRepository;
+class MultiSeriesChart;
 class DataAnalyzer;
+class FleetAnalyzer;
+struct FleetReport;
+struct CompactionStats;
 class QListWidgetItem;
 class QDateTimeEdit;
 
@@ -72,21 +82,35 @@ private slots:
     void on_filterDataButton_clicked();
     /** @brief Slot obsługujący kliknięcie przycisku "Wyczyść Filtr". Czyści pole filtrowania stacji po mieście. */
     void on_clearCityFilterButton_clicked();
+    /** @brief Slot obsługujący przełączenie trybu nakładania serii. Po wyłączeniu zostawia na wykresie tylko wybrany czujnik. */
+    void on_overlayCheckBox_toggled(bool checked);
+    /** @brief Slot obsługujący kliknięcie przycisku "Wyczyść wykres". Usuwa wszystkie serie z wykresu. */
+    void on_clearChartButton_clicked();
+    /** @brief Slot obsługujący przełączenie metody trendu (regresja liniowa / Theil-Sen z testem Manna-Kendalla). */
+    void on_robustTrendCheckBox_toggled(bool checked);
+    /** @brief Slot obsługujący kliknięcie przycisku raportu floty. Uruchamia w tle analizę wszystkich czujników zapisanych w cache. */
+    void on_fleetReportButton_clicked();
+    /** @brief Slot wywoływany po zakończeniu analizy floty. Wyświetla podsumowanie raportu. */
+    void handleFleetReportFinished();
+    /** @brief Slot wywoływany po zakończeniu porządkowania cache w tle. Loguje statystyki. */
+    void handleCompactionFinished();
 
     /** @brief Slot obsługujący zmianę tekstu w polu filtrowania stacji po mieście. Aktualizuje listę stacji. */
     void filterStations(const QString &text);
 
-    // Sloty obsługujące sygnały z ApiService
-    /** @brief Slot obsługujący sygnał ApiService::stationsReady. Aktualizuje listę stacji w GUI. */
+    // Sloty obsługujące sygnały z DataRepository
+    /** @brief Slot obsługujący sygnał DataRepository::stationsReady. Aktualizuje listę stacji w GUI. */
     void handleStationsReady(const std::vector<MeasuringStation>& stations);
-    /** @brief Slot obsługujący sygnał ApiService::sensorsReady. Aktualizuje listę czujników w GUI. */
-    void handleSensorsReady(const std::vector<Sensor>& sensors);
-    /** @brief Slot obsługujący sygnał ApiService::sensorDataReady. Aktualizuje wykres i wyniki analizy danymi pomiarowymi. */
-    void handleSensorDataReady(const SensorData& data);
-    /** @brief Slot obsługujący sygnał ApiService::airQualityIndexReady. Aktualizuje wyświetlanie indeksu AQI. */
+    /** @brief Slot obsługujący sygnał DataRepository::sensorsReady. Aktualizuje listę czujników w GUI (jeśli dotyczą wybranej stacji). */
+    void handleSensorsReady(int stationId, const std::vector<Sensor>& sensors);
+    /** @brief Slot obsługujący sygnał DataRepository::sensorDataReady. Aktualizuje wykres i wyniki analizy danymi pomiarowymi (jeśli dotyczą wybranego czujnika). */
+    void handleSensorDataReady(int sensorId, const SensorData& data);
+    /** @brief Slot obsługujący sygnał DataRepository::airQualityIndexReady. Aktualizuje wyświetlanie indeksu AQI. */
     void handleAirQualityIndexReady(const AirQualityIndex& index);
-    /** @brief Slot obsługujący sygnał ApiService::networkError. Wyświetla komunikat o błędzie i/lub proponuje wczytanie danych z pliku. */
+    /** @brief Slot obsługujący sygnał DataRepository::networkError. Wyświetla komunikat o błędzie i/lub proponuje wczytanie danych z pliku. */
     void handleNetworkError(const QString& errorMsg);
+    /** @brief Slot obsługujący sygnał DataRepository::revalidationFailed. Informuje, że wyświetlane są dane z cache. */
+    void handleRevalidationFailed(const QString& errorMsg);
 
     // Metody prywatne - logika pomocnicza
 private:
@@ -94,8 +118,21 @@ private:
     void updateStationsList(const std::vector<MeasuringStation>& stations);
     /** @brief Aktualizuje QListWidget (ui->sensorsListWidget) na podstawie podanego wektora czujników. */
     void updateSensorsList(const std::vector<Sensor>& sensors);
-    /** @brief Aktualizuje wykres (m_chart, m_series) nowymi danymi pomiarowymi. */
-    void updateChart(const std::vector<MeasurementValue>& valuesToPlot, const QString& seriesKey);
+    /**
+     * @brief Aktualizuje serię wykresu nowymi danymi pomiarowymi.
+     * Bez trybu nakładania pozostałe serie są usuwane z wykresu.
+     * @param seriesId Identyfikator serii (ID czujnika).
+     * @param valuesToPlot Dane do narysowania.
+     * @param seriesKey Kod parametru (np. "PM10").
+     * @param incremental Czy dopisać tylko nowe punkty do istniejącej serii (`false` - pełna podmiana, np. po filtrowaniu).
+     */
+    void updateChart(int seriesId, const std::vector<MeasurementValue>& valuesToPlot, const QString& seriesKey, bool incremental);
+    /** @brief Ustawia tytuł wykresu na podstawie liczby serii i ich wspólnego zakresu czasu. */
+    void updateChartTitle(const QString& seriesKey);
+    /** @brief Usuwa serię z wykresu (w trybie bez nakładania czyści cały wykres). */
+    void removeChartSeries(int seriesId);
+    /** @brief Czy włączony jest tryb nakładania serii (porównywanie czujników/stacji). */
+    bool isOverlayEnabled() const;
     /** @brief Aktualizuje etykiety w GUI wynikami analizy danych (min, max, średnia, trend). */
     void updateAnalysisResults(const AnalysisResult& result);
     /** @brief Aktualizuje etykiety w GUI danymi o indeksie jakości powietrza (AQI). */
@@ -104,6 +141,24 @@ private:
     void displayErrorMessage(const QString& message);
     /** @brief Czyści sekcję szczegółów czujnika (lista czujników, wykres, analiza, AQI, przyciski). */
     void clearSensorDetails();
+    /**
+     * @brief Oblicza indeks AQI stacji lokalnie (AqiCalculator) z danych jej czujników.
+     * Dane są pobierane przez DataRepository::loadSensorData() - z pamięci podręcznej, a dopiero potem z dysku.
+     * Używane, gdy indeksu nie udało się pobrać z API ani wczytać z cache.
+     * @return Indeks; stationId = -1, jeśli brak zapisanych danych czujników stacji.
+     */
+    AirQualityIndex computeLocalAirQualityIndex(int stationId) const;
+    /**
+     * @brief Uwzględnia nowe pomiary w modelu prognozy czujnika i zapisuje jego stan (DataRepository).
+     * Model jest wczytywany z pliku przy pierwszym użyciu, a później przechowywany w pamięci.
+     */
+    void updateSensorForecast(int sensorId, const std::vector<MeasurementValue>& values);
+    /** @brief Aktualizuje etykietę z prognozą 24 h dla czujnika. */
+    void updateForecastDisplay(int sensorId);
+    /** @brief Loguje zmiany stanu alertów i pokazuje ostatnią w pasku stanu. */
+    void reportAlertEvents(const std::vector<AlertEvent>& events);
+    /** @brief Wyświetla podsumowanie raportu floty (agregaty wg parametru i województwa). */
+    void showFleetReport(const FleetReport& report);
     /** @brief Czyści dane i tytuł wykresu. */
     void clearChart();
     /** @brief Czyści etykiety z wynikami analizy danych. */
@@ -146,16 +201,28 @@ private:
     ApiService *m_apiService;
     ///< Wskaźnik na serwis zapisu/odczytu danych z plików.
     DataStorage *m_dataStorage;
+    ///< Wskaźnik na warstwę cache (stale-while-revalidate) pomiędzy GUI a ApiService.
+    DataRepository *m_repository;
     ///< Wskaźnik na obiekt wykonujący analizę danych.
     DataAnalyzer *m_analyzer;
+    ///< Analiza wszystkich czujników zapisanych w cache (raport floty).
+    FleetAnalyzer *m_fleetAnalyzer = nullptr;
+    ///< Obserwator analizy floty wykonywanej w tle.
+    QFutureWatcher<FleetReport> *m_fleetReportWatcher = nullptr;
+    ///< Obserwator porządkowania cache (retencja, limit miejsca) uruchamianego w tle przy starcie.
+    QFutureWatcher<CompactionStats> *m_compactionWatcher = nullptr;
+    ///< Modele prognozy czujników (ID czujnika -> model), wczytywane przez DataRepository przy pierwszym użyciu.
+    std::map<int, HoltWintersForecaster> m_forecasters;
+    ///< Reguły alertów (wczytywane z DataStorage) oceniane dla napływających pomiarów i indeksów AQI.
+    AlertEngine m_alertEngine;
 
     // --- Buforowane dane ---
     ///< Aktualnie załadowana/pobrana lista wszystkich stacji (lub przefiltrowana).
     std::vector<MeasuringStation> m_currentStations;
     ///< Aktualnie załadowana/pobrana lista czujników dla wybranej stacji.
     std::vector<Sensor> m_currentSensors;
-    ///< Aktualnie załadowane/pobrane dane pomiarowe dla wybranego czujnika.
-    SensorData m_currentSensorData;
+    ///< Aktualnie załadowane/pobrane dane pomiarowe dla wybranego czujnika (współdzielone z pamięcią podręczną repozytorium; nigdy `nullptr`).
+    std::shared_ptr<const SensorData> m_currentSensorData = std::make_shared<const SensorData>();
         ///< Aktualnie załadowany/pobrany indeks AQI dla wybranej stacji.
     AirQualityIndex m_currentAirQualityIndex;
 
@@ -164,8 +231,8 @@ private:
     QChart *m_chart;
     ///< Widget wyświetlający wykres.
     QChartView *m_chartView;
-    ///< Seria danych wyświetlana na wykresie (typ Spline).
-    QSplineSeries *m_series;
+    ///< Serie danych wyświetlane na wykresie (jedna na czujnik, ze wspólną osią czasu).
+    MultiSeriesChart *m_seriesChart = nullptr;
     ///< Oś X (czasowa) wykresu.
     QDateTimeAxis *m_axisX;
     ///< Oś Y (wartości) wykresu.
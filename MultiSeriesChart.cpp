@@ -0,0 +1,446 @@
+#include "MultiSeriesChart.h"
+#include <QDebug>
+#include <QtCharts/QLegend>
+#include <QtCharts/QLegendMarker>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MultiSeriesChart::MultiSeriesChart(QChart* chart, QDateTimeAxis* axisX, QValueAxis* axisY)
+    : m_chart(chart), m_axisX(axisX), m_axisY(axisY)
+{
+}
+
+MultiSeriesChart::~MultiSeriesChart()
+{
+    clear();
+}
+
+std::vector<QPointF> MultiSeriesChart::toSortedPoints(const std::vector<MeasurementValue>& values)
+{
+    std::vector<QPointF> points;
+    points.reserve(values.size());
+    for (const auto& mv : values) {
+        if (mv.date.isValid() && !std::isnan(mv.value)) {
+            points.emplace_back(static_cast<qreal>(mv.date.toMSecsSinceEpoch()), mv.value);
+        }
+    }
+    std::stable_sort(points.begin(), points.end(), [](const QPointF& a, const QPointF& b) {
+        return a.x() < b.x();
+    });
+    return points;
+}
+
+void MultiSeriesChart::appendBucket(const std::vector<QPointF>& raw, std::size_t begin, std::size_t end, QList<QPointF>& out)
+{
+    if (begin >= end) return;
+
+    std::size_t minIdx = begin;
+    std::size_t maxIdx = begin;
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        if (raw[i].y() < raw[minIdx].y()) minIdx = i;
+        if (raw[i].y() > raw[maxIdx].y()) maxIdx = i;
+    }
+
+    if (minIdx == maxIdx) {
+        out.append(raw[minIdx]);
+    } else if (minIdx < maxIdx) {
+        out.append(raw[minIdx]);
+        out.append(raw[maxIdx]);
+    } else {
+        out.append(raw[maxIdx]);
+        out.append(raw[minIdx]);
+    }
+}
+
+void MultiSeriesChart::recomputeValueRange(SeriesState& state)
+{
+    state.minValue = std::numeric_limits<double>::infinity();
+    state.maxValue = -std::numeric_limits<double>::infinity();
+    extendValueRange(state, state.raw.begin(), state.raw.end());
+}
+
+void MultiSeriesChart::extendValueRange(SeriesState& state, std::vector<QPointF>::const_iterator begin,
+                                        std::vector<QPointF>::const_iterator end)
+{
+    for (auto it = begin; it != end; ++it) {
+        state.minValue = std::min(state.minValue, it->y());
+        state.maxValue = std::max(state.maxValue, it->y());
+    }
+}
+
+bool MultiSeriesChart::applyRevisions(SeriesState& state, const std::vector<QPointF>& points, std::size_t count)
+{
+    if (count != state.raw.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (points[i].x() != state.raw[i].x()) {
+            return false;
+        }
+    }
+
+    bool revised = false;
+    bool extremeChanged = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double oldValue = state.raw[i].y();
+        if (points[i].y() == oldValue) {
+            continue;
+        }
+        revised = true;
+        extremeChanged = extremeChanged || oldValue == state.minValue || oldValue == state.maxValue;
+        state.raw[i] = points[i];
+        state.minValue = std::min(state.minValue, points[i].y());
+        state.maxValue = std::max(state.maxValue, points[i].y());
+        if (state.bucketSize == 1) {
+            state.series->replace(static_cast<int>(i), points[i]); // bez decymacji punkt i jest i-tym punktem serii
+        }
+    }
+    if (extremeChanged) {
+        recomputeValueRange(state);
+    }
+    if (revised && state.bucketSize > 1) {
+        rebuild(state); // kubełki z poprawioną wartością mogą mieć inne minimum i maksimum
+    }
+    return true;
+}
+
+MultiSeriesChart::SeriesState& MultiSeriesChart::ensureSeries(int seriesId, const QString& name)
+{
+    auto it = m_series.find(seriesId);
+    if (it == m_series.end()) {
+        SeriesState state;
+        state.series = new QSplineSeries();
+        m_chart->addSeries(state.series);
+        state.series->attachAxis(m_axisX);
+        state.series->attachAxis(m_axisY);
+        it = m_series.emplace(seriesId, state).first;
+    }
+    it->second.series->setName(name);
+    return it->second;
+}
+
+void MultiSeriesChart::rebuild(SeriesState& state)
+{
+    const std::size_t n = state.raw.size();
+    const std::size_t maxPoints = static_cast<std::size_t>(m_maxPointsPerSeries);
+
+    // Każdy kubełek daje do dwóch punktów (min i max).
+    state.bucketSize = (n > maxPoints) ? static_cast<int>((2 * n + maxPoints - 1) / maxPoints) : 1;
+    state.partialPlotted = 0;
+
+    QList<QPointF> plotted;
+    if (state.bucketSize == 1) {
+        plotted = QList<QPointF>(state.raw.begin(), state.raw.end());
+        state.consumedRaw = n;
+    } else {
+        const std::size_t bucket = static_cast<std::size_t>(state.bucketSize);
+        plotted.reserve(static_cast<qsizetype>(2 * (n / bucket + 1)));
+        std::size_t full = (n / bucket) * bucket;
+        for (std::size_t b = 0; b < full; b += bucket) {
+            appendBucket(state.raw, b, b + bucket, plotted);
+        }
+        state.consumedRaw = full;
+        if (full < n) {
+            qsizetype before = plotted.size();
+            appendBucket(state.raw, full, n, plotted);
+            state.partialPlotted = static_cast<int>(plotted.size() - before);
+        }
+    }
+
+    state.series->replace(plotted);
+}
+
+void MultiSeriesChart::appendPending(SeriesState& state)
+{
+    const std::size_t n = state.raw.size();
+    if (state.consumedRaw >= n) return;
+
+    if (state.bucketSize == 1) {
+        state.series->append(QList<QPointF>(state.raw.begin() + static_cast<std::ptrdiff_t>(state.consumedRaw), state.raw.end()));
+        state.consumedRaw = n;
+    } else {
+        if (state.partialPlotted > 0) {
+            state.series->removePoints(state.series->count() - state.partialPlotted, state.partialPlotted);
+            state.partialPlotted = 0;
+        }
+
+        const std::size_t bucket = static_cast<std::size_t>(state.bucketSize);
+        QList<QPointF> out;
+        while (state.consumedRaw + bucket <= n) {
+            appendBucket(state.raw, state.consumedRaw, state.consumedRaw + bucket, out);
+            state.consumedRaw += bucket;
+        }
+        if (state.consumedRaw < n) {
+            qsizetype before = out.size();
+            appendBucket(state.raw, state.consumedRaw, n, out);
+            state.partialPlotted = static_cast<int>(out.size() - before);
+        }
+        state.series->append(out);
+    }
+
+    if (state.series->count() > 2 * m_maxPointsPerSeries) {
+        rebuild(state);
+    }
+}
+
+void MultiSeriesChart::updateSeries(int seriesId, const QString& name, const std::vector<MeasurementValue>& values)
+{
+    auto it = m_series.find(seriesId);
+    std::vector<QPointF> points = toSortedPoints(values);
+
+    if (it == m_series.end() || it->second.raw.empty() || points.empty()) {
+        replaceSeries(seriesId, name, values);
+        return;
+    }
+
+    SeriesState& state = it->second;
+    state.series->setName(name);
+
+    const qreal firstNew = points.front().x();
+    const qreal lastOld = state.raw.back().x();
+
+    // Usunięcie punktów, które wypadły z okna nowych danych.
+    auto dropEnd = std::lower_bound(state.raw.begin(), state.raw.end(), firstNew,
+                                    [](const QPointF& p, qreal x) { return p.x() < x; });
+    std::size_t dropCount = static_cast<std::size_t>(dropEnd - state.raw.begin());
+    bool needRebuild = dropCount > 0 && state.bucketSize > 1; // kubełki zaczynają się od pierwszego punktu
+    if (dropCount > 0 && !needRebuild) {
+        const bool extremeDropped = std::any_of(state.raw.begin(), dropEnd, [&state](const QPointF& p) {
+            return p.y() == state.minValue || p.y() == state.maxValue;
+        });
+        state.series->removePoints(0, static_cast<int>(dropCount));
+        state.consumedRaw -= dropCount;
+        state.raw.erase(state.raw.begin(), dropEnd);
+        if (extremeDropped) {
+            recomputeValueRange(state);
+        }
+    }
+
+    // Punkty do ostatniego narysowanego: poprawione wartości są podmieniane w miejscu.
+    auto tailBegin = std::upper_bound(points.begin(), points.end(), lastOld,
+                                      [](qreal x, const QPointF& p) { return x < p.x(); });
+    const std::size_t overlap = static_cast<std::size_t>(tailBegin - points.begin());
+    if (needRebuild || !applyRevisions(state, points, overlap)) {
+        // Inny zestaw dat wewnątrz serii (lub przesunięte kubełki) - przebudowa z nowych danych.
+        state.raw = std::move(points);
+        recomputeValueRange(state);
+        rebuild(state);
+        rescaleAxes();
+        return;
+    }
+
+    // Dopisanie punktów nowszych niż ostatni narysowany.
+    const std::size_t oldSize = state.raw.size();
+    state.raw.insert(state.raw.end(), tailBegin, points.end());
+    extendValueRange(state, state.raw.begin() + static_cast<std::ptrdiff_t>(oldSize), state.raw.end());
+    appendPending(state);
+    rescaleAxes();
+}
+
+void MultiSeriesChart::replaceSeries(int seriesId, const QString& name, const std::vector<MeasurementValue>& values)
+{
+    SeriesState& state = ensureSeries(seriesId, name);
+    state.raw = toSortedPoints(values);
+    recomputeValueRange(state);
+    rebuild(state);
+    rescaleAxes();
+}
+
+void MultiSeriesChart::setSeriesMarkers(int seriesId, const std::vector<MeasurementValue>& markers)
+{
+    auto it = m_series.find(seriesId);
+    if (it == m_series.end()) return;
+    SeriesState& state = it->second;
+
+    QList<QPointF> points;
+    if (!state.raw.empty()) {
+        for (const QPointF& p : toSortedPoints(markers)) {
+            if (p.x() >= state.raw.front().x() && p.x() <= state.raw.back().x()) {
+                points.append(p);
+            }
+        }
+    }
+
+    if (points.isEmpty()) {
+        if (state.markers) {
+            m_chart->removeSeries(state.markers);
+            delete state.markers;
+            state.markers = nullptr;
+        }
+        return;
+    }
+
+    if (!state.markers) {
+        state.markers = new QScatterSeries();
+        state.markers->setMarkerShape(QScatterSeries::MarkerShapeCircle);
+        state.markers->setMarkerSize(9.0);
+        state.markers->setColor(Qt::red);
+        state.markers->setBorderColor(Qt::darkRed);
+        m_chart->addSeries(state.markers);
+        state.markers->attachAxis(m_axisX);
+        state.markers->attachAxis(m_axisY);
+        for (QLegendMarker* legendMarker : m_chart->legend()->markers(state.markers)) {
+            legendMarker->setVisible(false);
+        }
+    }
+    state.markers->setName(state.series->name() + " - anomalie");
+    state.markers->replace(points);
+}
+
+void MultiSeriesChart::detach(SeriesState& state)
+{
+    m_chart->removeSeries(state.series);
+    delete state.series;
+    if (state.markers) {
+        m_chart->removeSeries(state.markers);
+        delete state.markers;
+    }
+}
+
+void MultiSeriesChart::removeSeries(int seriesId)
+{
+    auto it = m_series.find(seriesId);
+    if (it == m_series.end()) return;
+
+    detach(it->second);
+    m_series.erase(it);
+    rescaleAxes();
+}
+
+void MultiSeriesChart::removeAllExcept(int seriesId)
+{
+    for (auto it = m_series.begin(); it != m_series.end();) {
+        if (it->first == seriesId) {
+            ++it;
+            continue;
+        }
+        detach(it->second);
+        it = m_series.erase(it);
+    }
+    rescaleAxes();
+}
+
+void MultiSeriesChart::clear()
+{
+    for (auto& entry : m_series) {
+        detach(entry.second);
+    }
+    m_series.clear();
+    rescaleAxes();
+}
+
+bool MultiSeriesChart::hasSeries(int seriesId) const
+{
+    return m_series.find(seriesId) != m_series.end();
+}
+
+int MultiSeriesChart::seriesCount() const
+{
+    return static_cast<int>(m_series.size());
+}
+
+int MultiSeriesChart::plottedPointCount(int seriesId) const
+{
+    auto it = m_series.find(seriesId);
+    return it == m_series.end() ? -1 : it->second.series->count();
+}
+
+void MultiSeriesChart::setMaxPointsPerSeries(int maxPoints)
+{
+    m_maxPointsPerSeries = std::max(16, maxPoints);
+}
+
+int MultiSeriesChart::maxPointsPerSeries() const
+{
+    return m_maxPointsPerSeries;
+}
+
+bool MultiSeriesChart::timeRange(QDateTime& minDate, QDateTime& maxDate) const
+{
+    bool found = false;
+    qreal minX = 0.0, maxX = 0.0;
+    for (const auto& entry : m_series) {
+        const std::vector<QPointF>& raw = entry.second.raw;
+        if (raw.empty()) continue;
+        if (!found) {
+            minX = raw.front().x();
+            maxX = raw.back().x();
+            found = true;
+        } else {
+            minX = std::min(minX, raw.front().x());
+            maxX = std::max(maxX, raw.back().x());
+        }
+    }
+    if (found) {
+        minDate = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(minX));
+        maxDate = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(maxX));
+    }
+    return found;
+}
+
+bool MultiSeriesChart::valueRange(double& minValue, double& maxValue) const
+{
+    bool found = false;
+    for (const auto& entry : m_series) {
+        const SeriesState& state = entry.second;
+        if (state.raw.empty()) continue;
+        minValue = found ? std::min(minValue, state.minValue) : state.minValue;
+        maxValue = found ? std::max(maxValue, state.maxValue) : state.maxValue;
+        found = true;
+    }
+    return found;
+}
+
+void MultiSeriesChart::rescaleAxes()
+{
+    qint64 minTimestamp = std::numeric_limits<qint64>::max();
+    qint64 maxTimestamp = std::numeric_limits<qint64>::min();
+    double minValue = std::numeric_limits<double>::max();
+    double maxValue = -std::numeric_limits<double>::max();
+    bool validValueFound = false;
+
+    for (const auto& entry : m_series) {
+        const std::vector<QPointF>& raw = entry.second.raw;
+        if (raw.empty()) continue;
+        minTimestamp = std::min(minTimestamp, static_cast<qint64>(raw.front().x()));
+        maxTimestamp = std::max(maxTimestamp, static_cast<qint64>(raw.back().x()));
+        minValue = std::min(minValue, entry.second.minValue);
+        maxValue = std::max(maxValue, entry.second.maxValue);
+        validValueFound = true;
+    }
+
+    if (!validValueFound) {
+        m_axisX->setRange(QDateTime::currentDateTime().addDays(-1), QDateTime::currentDateTime());
+        m_axisY->setRange(0, 10);
+        return;
+    }
+
+    if (minTimestamp == maxTimestamp) {
+        m_axisX->setMin(QDateTime::fromMSecsSinceEpoch(minTimestamp).addSecs(-3600));
+        m_axisX->setMax(QDateTime::fromMSecsSinceEpoch(maxTimestamp).addSecs(3600));
+    } else {
+        qint64 timeRange = maxTimestamp - minTimestamp;
+        qint64 timePadding = std::max((qint64)3600 * 1000, timeRange / 20);
+        m_axisX->setMin(QDateTime::fromMSecsSinceEpoch(minTimestamp - timePadding));
+        m_axisX->setMax(QDateTime::fromMSecsSinceEpoch(maxTimestamp + timePadding));
+    }
+
+    double yRange = maxValue - minValue;
+    double yPadding;
+    if (yRange <= 1e-9) {
+        yPadding = std::max(1.0, std::abs(minValue * 0.1));
+    } else {
+        yPadding = yRange * 0.1;
+    }
+    double finalMinY = std::floor(minValue - yPadding);
+    double finalMaxY = std::ceil(maxValue + yPadding);
+
+    if (std::isfinite(finalMinY) && std::isfinite(finalMaxY) && finalMaxY > finalMinY) {
+        m_axisY->setMin(finalMinY);
+        m_axisY->setMax(finalMaxY);
+    } else {
+        qWarning() << "Nieprawidłowy obliczony zakres osi Y (Min:" << finalMinY << "Max:" << finalMaxY << "), ustawianie domyślnego.";
+        m_axisY->setRange(0, 10);
+    }
+}
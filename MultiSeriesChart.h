@@ -0,0 +1,156 @@
+/**
+ * @file MultiSeriesChart.h
+ * @brief Definicja klasy MultiSeriesChart - zarządzania wieloma seriami danych na jednym wykresie QtCharts.
+ */
+#ifndef MULTISERIESCHART_H
+#define MULTISERIESCHART_H
+
+#include <QString>
+#include <QPointF>
+#include <QDateTime>
+#include <limits>
+#include <map>
+#include <vector>
+#include "DataStructures.h"
+
+#include <QtCharts/QChart>
+#include <QtCharts/QSplineSeries>
+#include <QtCharts/QScatterSeries>
+#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QValueAxis>
+
+/**
+ * @class MultiSeriesChart
+ * @brief Utrzymuje N serii (np. wszystkie czujniki stacji lub PM10 z kilku stacji) na wspólnej osi czasu.
+ *
+ * Każda seria ma własną decymację: gdy liczba punktów przekracza `maxPointsPerSeries`, kolejne kubełki
+ * `bucketSize` punktów są reprezentowane przez ich minimum i maksimum (zachowuje to piki zanieczyszczeń).
+ * Aktualizacja istniejącej serii jest przyrostowa - dopisywane są punkty nowsze niż ostatni narysowany,
+ * punkty starsze niż początek nowych danych są usuwane z początku serii (przesuwające się okno API), a zmienione
+ * wartości dla już narysowanych dat (korekty API) są podmieniane w miejscu. Pełne przebudowanie serii (replace())
+ * następuje tylko przy pierwszym narysowaniu, zmianie decymacji lub zmianie zestawu dat wewnątrz serii.
+ * Zakres wartości każdej serii jest utrzymywany przyrostowo, więc dopasowanie osi nie przegląda wszystkich punktów.
+ */
+class MultiSeriesChart
+{
+public:
+    /**
+     * @brief Konstruktor.
+     * @param chart Wykres, do którego dodawane są serie (nie przejmuje własności).
+     * @param axisX Wspólna oś czasu (musi być już dodana do wykresu).
+     * @param axisY Wspólna oś wartości (musi być już dodana do wykresu).
+     */
+    MultiSeriesChart(QChart* chart, QDateTimeAxis* axisX, QValueAxis* axisY);
+
+    /** @brief Destruktor. Usuwa wszystkie serie z wykresu. */
+    ~MultiSeriesChart();
+
+    MultiSeriesChart(const MultiSeriesChart&) = delete;
+    MultiSeriesChart& operator=(const MultiSeriesChart&) = delete;
+
+    /**
+     * @brief Ustawia lub przyrostowo aktualizuje serię.
+     * Jeśli seria o podanym ID nie istnieje, jest tworzona. W przeciwnym razie dopisywane są tylko nowe punkty,
+     * a wartości zmienione dla już narysowanych dat są podmieniane.
+     * @param seriesId Identyfikator serii (np. ID czujnika).
+     * @param name Nazwa serii wyświetlana w legendzie.
+     * @param values Pełny aktualny zestaw danych serii (kolejność dowolna; wartości NaN i błędne daty są pomijane).
+     */
+    void updateSeries(int seriesId, const QString& name, const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Zastępuje całą zawartość serii (bez prób aktualizacji przyrostowej), np. po filtrowaniu zakresu dat.
+     * @param seriesId Identyfikator serii.
+     * @param name Nazwa serii wyświetlana w legendzie.
+     * @param values Nowy zestaw danych serii.
+     */
+    void replaceSeries(int seriesId, const QString& name, const std::vector<MeasurementValue>& values);
+
+    /**
+     * @brief Ustawia znaczniki (np. wykrytych anomalii) rysowane na serii jako punkty bez linii.
+     * Znaczniki spoza zakresu czasu serii są pomijane; pusty wektor usuwa znaczniki. Znaczniki nie pojawiają się w legendzie.
+     * @param seriesId Identyfikator istniejącej serii.
+     * @param markers Punkty do oznaczenia.
+     */
+    void setSeriesMarkers(int seriesId, const std::vector<MeasurementValue>& markers);
+
+    /** @brief Usuwa serię z wykresu. */
+    void removeSeries(int seriesId);
+    /** @brief Usuwa wszystkie serie poza podaną. */
+    void removeAllExcept(int seriesId);
+    /** @brief Usuwa wszystkie serie z wykresu. */
+    void clear();
+
+    /** @brief Czy seria o podanym ID jest na wykresie. */
+    bool hasSeries(int seriesId) const;
+    /** @brief Liczba serii na wykresie. */
+    int seriesCount() const;
+    /** @brief Liczba punktów faktycznie narysowanych dla serii (po decymacji), -1 jeśli seria nie istnieje. */
+    int plottedPointCount(int seriesId) const;
+
+    /** @brief Ustawia docelową maksymalną liczbę rysowanych punktów na serię (min. 16). Nie przebudowuje istniejących serii. */
+    void setMaxPointsPerSeries(int maxPoints);
+    /** @brief Zwraca docelową maksymalną liczbę rysowanych punktów na serię. */
+    int maxPointsPerSeries() const;
+
+    /**
+     * @brief Zwraca zakres czasu wszystkich serii.
+     * @return `true` jeśli na wykresie jest choć jeden punkt; wtedy `minDate`/`maxDate` są ustawione.
+     */
+    bool timeRange(QDateTime& minDate, QDateTime& maxDate) const;
+
+    /**
+     * @brief Zwraca zakres wartości wszystkich serii (przed decymacją).
+     * @return `true` jeśli na wykresie jest choć jeden punkt; wtedy `minValue`/`maxValue` są ustawione.
+     */
+    bool valueRange(double& minValue, double& maxValue) const;
+
+private:
+    /// Stan pojedynczej serii.
+    struct SeriesState {
+        QSplineSeries* series = nullptr; ///< Seria QtCharts (własność wykresu po addSeries).
+        std::vector<QPointF> raw;        ///< Wszystkie prawidłowe punkty, posortowane rosnąco po czasie.
+        int bucketSize = 1;              ///< Liczba surowych punktów na kubełek decymacji (1 = bez decymacji).
+        std::size_t consumedRaw = 0;     ///< Liczba surowych punktów w pełnych (zamkniętych) kubełkach.
+        int partialPlotted = 0;          ///< Liczba punktów narysowanych dla ostatniego, niepełnego kubełka.
+        QScatterSeries* markers = nullptr; ///< Znaczniki serii (tworzone przy pierwszym setSeriesMarkers()).
+        double minValue = std::numeric_limits<double>::infinity();  ///< Najmniejsza wartość w `raw`.
+        double maxValue = -std::numeric_limits<double>::infinity(); ///< Największa wartość w `raw`.
+    };
+
+    /// Usuwa z wykresu serię i jej znaczniki.
+    void detach(SeriesState& state);
+
+    /// Zamienia dane wejściowe na posortowane punkty (x = ms od epoki), pomijając NaN i błędne daty.
+    static std::vector<QPointF> toSortedPoints(const std::vector<MeasurementValue>& values);
+    /// Dopisuje do `out` punkty reprezentujące kubełek [begin, end) - min i max w kolejności czasowej.
+    static void appendBucket(const std::vector<QPointF>& raw, std::size_t begin, std::size_t end, QList<QPointF>& out);
+
+    /// Przelicza zakres wartości serii od nowa (po przebudowie lub usunięciu punktu z wartością skrajną).
+    static void recomputeValueRange(SeriesState& state);
+    /// Rozszerza zakres wartości serii o punkty [begin, end).
+    static void extendValueRange(SeriesState& state, std::vector<QPointF>::const_iterator begin,
+                                 std::vector<QPointF>::const_iterator end);
+    /**
+     * @brief Podmienia wartości już narysowanych punktów na wartości z `points` (te same daty, co w `state.raw`).
+     * @return `false`, jeśli zestaw dat się różni - wtedy serię trzeba przebudować.
+     */
+    bool applyRevisions(SeriesState& state, const std::vector<QPointF>& points, std::size_t count);
+
+    /// Zwraca stan serii, tworząc ją w razie potrzeby.
+    SeriesState& ensureSeries(int seriesId, const QString& name);
+    /// Przebudowuje całą serię na podstawie `state.raw`, dobierając nowy rozmiar kubełka.
+    void rebuild(SeriesState& state);
+    /// Dopisuje do serii punkty z `state.raw` od `state.consumedRaw` (z uwzględnieniem niepełnego kubełka).
+    void appendPending(SeriesState& state);
+    /// Dopasowuje wspólne osie do zakresu wszystkich serii (ze skrajnych punktów i zakresów wartości serii).
+    void rescaleAxes();
+
+    QChart* m_chart;             ///< Wykres (nie jest własnością).
+    QDateTimeAxis* m_axisX;      ///< Wspólna oś czasu.
+    QValueAxis* m_axisY;         ///< Wspólna oś wartości.
+    int m_maxPointsPerSeries = 2000; ///< Docelowa maksymalna liczba punktów na serię.
+    std::map<int, SeriesState> m_series; ///< Serie wg identyfikatora.
+};
+
+#endif // MULTISERIESCHART_H
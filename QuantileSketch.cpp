@@ -0,0 +1,233 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QuantileSketch::QuantileSketch(int k, quint32 seed)
+    : m_k(std::max(8, k)),
+      m_min(std::numeric_limits<double>::quiet_NaN()),
+      m_max(std::numeric_limits<double>::quiet_NaN()),
+      m_rng(seed)
+{
+    grow();
+}
+
+std::size_t QuantileSketch::capacity(int level) const
+{
+    const int depth = static_cast<int>(m_levels.size()) - level - 1;
+    return static_cast<std::size_t>(std::ceil(std::pow(2.0 / 3.0, depth) * m_k)) + 1;
+}
+
+void QuantileSketch::grow()
+{
+    m_levels.emplace_back();
+    m_maxSize = 0;
+    for (int h = 0; h < static_cast<int>(m_levels.size()); ++h) {
+        m_maxSize += capacity(h);
+    }
+}
+
+void QuantileSketch::compress()
+{
+    for (int h = 0; h < static_cast<int>(m_levels.size()); ++h) {
+        if (m_levels[h].size() < capacity(h)) {
+            continue;
+        }
+        if (h + 1 >= static_cast<int>(m_levels.size())) {
+            grow();
+        }
+
+        std::vector<double>& level = m_levels[h];
+        std::sort(level.begin(), level.end());
+
+        // Przy nieparzystej liczbie wartości najmniejsza zostaje na bieżącym poziomie.
+        const std::size_t n = level.size();
+        const std::size_t first = n % 2;
+        const std::size_t offset = m_rng() & 1u;
+        std::vector<double>& next = m_levels[h + 1];
+        for (std::size_t i = first; i < n; i += 2) {
+            next.push_back(level[i + offset]);
+        }
+        level.resize(first);
+
+        m_size = 0;
+        for (const auto& l : m_levels) {
+            m_size += l.size();
+        }
+        if (m_size < m_maxSize) {
+            break;
+        }
+    }
+}
+
+void QuantileSketch::add(double value)
+{
+    if (std::isnan(value)) {
+        return;
+    }
+
+    if (m_count == 0) {
+        m_min = value;
+        m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    ++m_count;
+
+    m_levels[0].push_back(value);
+    ++m_size;
+    if (m_size >= m_maxSize) {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.m_count == 0) {
+        return;
+    }
+
+    while (m_levels.size() < other.m_levels.size()) {
+        grow();
+    }
+    for (std::size_t h = 0; h < other.m_levels.size(); ++h) {
+        m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(), other.m_levels[h].end());
+    }
+
+    if (m_count == 0) {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    } else {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+    m_count += other.m_count;
+
+    m_size = 0;
+    for (const auto& l : m_levels) {
+        m_size += l.size();
+    }
+    while (m_size >= m_maxSize) {
+        compress();
+    }
+}
+
+std::vector<QuantileSketch::WeightedValue> QuantileSketch::sortedWeightedValues() const
+{
+    std::vector<WeightedValue> items;
+    items.reserve(m_size);
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+        const quint64 weight = quint64(1) << h;
+        for (double v : m_levels[h]) {
+            items.push_back(WeightedValue{v, weight});
+        }
+    }
+    std::sort(items.begin(), items.end(), [](const WeightedValue& a, const WeightedValue& b) {
+        return a.value < b.value;
+    });
+    return items;
+}
+
+std::vector<double> QuantileSketch::quantiles(const std::vector<double>& qs) const
+{
+    std::vector<double> result(qs.size(), std::numeric_limits<double>::quiet_NaN());
+    if (m_count == 0) {
+        return result;
+    }
+
+    const std::vector<WeightedValue> items = sortedWeightedValues();
+    quint64 totalWeight = 0;
+    for (const auto& item : items) {
+        totalWeight += item.weight;
+    }
+
+    for (std::size_t i = 0; i < qs.size(); ++i) {
+        const double q = qs[i];
+        if (q <= 0.0) {
+            result[i] = m_min;
+            continue;
+        }
+        if (q >= 1.0) {
+            result[i] = m_max;
+            continue;
+        }
+
+        const double target = q * static_cast<double>(totalWeight);
+        quint64 cumulative = 0;
+        result[i] = m_max;
+        for (const auto& item : items) {
+            cumulative += item.weight;
+            if (static_cast<double>(cumulative) >= target) {
+                result[i] = item.value;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    return quantiles({q}).front();
+}
+
+double QuantileSketch::rank(double value) const
+{
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    quint64 below = 0;
+    quint64 totalWeight = 0;
+    for (std::size_t h = 0; h < m_levels.size(); ++h) {
+        const quint64 weight = quint64(1) << h;
+        for (double v : m_levels[h]) {
+            totalWeight += weight;
+            if (v <= value) {
+                below += weight;
+            }
+        }
+    }
+    return static_cast<double>(below) / static_cast<double>(totalWeight);
+}
+
+quint64 QuantileSketch::count() const
+{
+    return m_count;
+}
+
+bool QuantileSketch::isEmpty() const
+{
+    return m_count == 0;
+}
+
+double QuantileSketch::min() const
+{
+    return m_min;
+}
+
+double QuantileSketch::max() const
+{
+    return m_max;
+}
+
+int QuantileSketch::k() const
+{
+    return m_k;
+}
+
+std::size_t QuantileSketch::retainedItems() const
+{
+    return m_size;
+}
+
+void QuantileSketch::clear()
+{
+    m_levels.clear();
+    m_size = 0;
+    m_count = 0;
+    m_min = std::numeric_limits<double>::quiet_NaN();
+    m_max = std::numeric_limits<double>::quiet_NaN();
+    grow();
+}
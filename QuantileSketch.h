@@ -0,0 +1,108 @@
+/**
+ * @file QuantileSketch.h
+ * @brief Definicja klasy QuantileSketch - strumieniowego szkicu kwantyli KLL o stałej pamięci.
+ */
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QtGlobal>
+#include <vector>
+#include <random>
+
+/**
+ * @class QuantileSketch
+ * @brief Szkic kwantyli KLL (Karnin-Lang-Liberty) - przybliżone percentyle strumienia wartości.
+ *
+ * Wartości są dopisywane pojedynczo (add()), bez przechowywania całej historii. Szkic składa się z poziomów
+ * (kompaktorów); element na poziomie h reprezentuje 2^h wartości wejściowych. Gdy poziom się zapełni,
+ * jest sortowany, a co druga wartość (z losowym przesunięciem) przechodzi na poziom wyżej.
+ *
+ * - Pamięć: nie więcej niż ok. 3·k wartości niezależnie od liczby elementów (dla k = 200 to kilkanaście KiB).
+ * - Błąd rangi: rzędu 1/k (dla k = 200 typowo poniżej 1%); dla mniej niż k wartości wynik jest dokładny.
+ * - Szkice można łączyć (merge()) - np. percentyle dla wszystkich czujników PM10 z szkiców pojedynczych czujników.
+ *
+ * Klasa nie jest bezpieczna wątkowo; każdy wątek powinien używać własnego szkicu i łączyć je na końcu.
+ */
+class QuantileSketch
+{
+public:
+    /**
+     * @brief Konstruktor.
+     * @param k Parametr dokładności (rozmiar największego kompaktora, min. 8). Domyślnie 200.
+     * @param seed Ziarno generatora losowego (stałe domyślnie, aby wyniki były powtarzalne).
+     */
+    explicit QuantileSketch(int k = 200, quint32 seed = 0x5eed);
+
+    /** @brief Dodaje wartość do szkicu. Wartości NaN są ignorowane. */
+    void add(double value);
+
+    /**
+     * @brief Dołącza do szkicu zawartość innego szkicu.
+     * Wynik odpowiada (z tą samą gwarancją błędu) szkicowi zbudowanemu z obu strumieni naraz.
+     * @param other Szkic do dołączenia (może mieć inne k; używane jest k tego szkicu).
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Zwraca przybliżony kwantyl (definicja najbliższej rangi).
+     * @param q Rząd kwantyla z przedziału [0, 1], np. 0.98 dla P98.
+     * @return Wartość kwantyla; NaN dla pustego szkicu. Dla q <= 0 i q >= 1 zwraca dokładne min/max.
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief Zwraca kilka kwantyli naraz (jedno sortowanie zamiast osobnego dla każdego kwantyla).
+     * @param qs Rzędy kwantyli.
+     * @return Wartości w tej samej kolejności co `qs`.
+     */
+    std::vector<double> quantiles(const std::vector<double>& qs) const;
+
+    /**
+     * @brief Zwraca przybliżony odsetek wartości mniejszych lub równych podanej.
+     * @return Wartość z przedziału [0, 1]; 0 dla pustego szkicu.
+     */
+    double rank(double value) const;
+
+    /** @brief Liczba dodanych wartości (dokładna). */
+    quint64 count() const;
+    /** @brief Czy szkic jest pusty. */
+    bool isEmpty() const;
+    /** @brief Dokładne minimum dodanych wartości (NaN dla pustego szkicu). */
+    double min() const;
+    /** @brief Dokładne maksimum dodanych wartości (NaN dla pustego szkicu). */
+    double max() const;
+    /** @brief Parametr dokładności k. */
+    int k() const;
+    /** @brief Liczba wartości faktycznie przechowywanych w szkicu (miara zużycia pamięci). */
+    std::size_t retainedItems() const;
+
+    /** @brief Usuwa wszystkie wartości (zachowuje k). */
+    void clear();
+
+private:
+    /// Wartość z wagą (2^poziom), używana przy wyznaczaniu kwantyli.
+    struct WeightedValue {
+        double value;
+        quint64 weight;
+    };
+
+    /// Pojemność poziomu `level` - maleje geometrycznie (współczynnik 2/3) w dół od najwyższego poziomu.
+    std::size_t capacity(int level) const;
+    /// Dodaje nowy najwyższy poziom i przelicza maksymalny rozmiar szkicu.
+    void grow();
+    /// Kompaktuje najniższe przepełnione poziomy, aż rozmiar spadnie poniżej maksimum.
+    void compress();
+    /// Zwraca wszystkie przechowywane wartości z wagami, posortowane rosnąco.
+    std::vector<WeightedValue> sortedWeightedValues() const;
+
+    int m_k;                                     ///< Parametr dokładności.
+    std::vector<std::vector<double>> m_levels;   ///< Kompaktory; poziom h ma wagę 2^h.
+    std::size_t m_size = 0;                      ///< Łączna liczba przechowywanych wartości.
+    std::size_t m_maxSize = 0;                   ///< Suma pojemności wszystkich poziomów.
+    quint64 m_count = 0;                         ///< Liczba dodanych wartości.
+    double m_min;                                ///< Dokładne minimum.
+    double m_max;                                ///< Dokładne maksimum.
+    std::minstd_rand m_rng;                      ///< Generator przesunięć przy kompaktowaniu.
+};
+
+#endif // QUANTILESKETCH_H
@@ -0,0 +1,145 @@
+#include "SensorDataCache.h"
+#include <QMutexLocker>
+
+SensorDataCache::SensorDataCache(std::size_t maxBytes) : m_maxBytes(maxBytes)
+{
+}
+
+std::size_t SensorDataCache::estimateBytes(const SensorData& data)
+{
+    // Narzut wpisu: węzeł listy, węzeł mapy i nagłówek SensorData.
+    const std::size_t entryOverhead = sizeof(Entry) + 4 * sizeof(void*);
+    return entryOverhead
+           + static_cast<std::size_t>(data.key.size()) * sizeof(QChar)
+           + data.values.size() * sizeof(MeasurementValue);
+}
+
+std::shared_ptr<const SensorData> SensorDataCache::get(int sensorId)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(sensorId);
+    if (it == m_index.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->data;
+}
+
+void SensorDataCache::put(int sensorId, SensorData data)
+{
+    put(sensorId, std::make_shared<const SensorData>(std::move(data)));
+}
+
+void SensorDataCache::put(int sensorId, std::shared_ptr<const SensorData> data)
+{
+    if (!data) {
+        return;
+    }
+    std::size_t bytes = estimateBytes(*data);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(sensorId);
+    if (it != m_index.end()) {
+        m_currentBytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    if (bytes > m_maxBytes) {
+        return;
+    }
+
+    m_lru.push_front(Entry{sensorId, std::move(data), bytes});
+    m_index[sensorId] = m_lru.begin();
+    m_currentBytes += bytes;
+    evictToBudget();
+}
+
+bool SensorDataCache::contains(int sensorId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_index.find(sensorId) != m_index.end();
+}
+
+std::shared_ptr<const SensorData> SensorDataCache::peek(int sensorId) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(sensorId);
+    return it != m_index.end() ? it->second->data : nullptr;
+}
+
+void SensorDataCache::remove(int sensorId)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(sensorId);
+    if (it == m_index.end()) {
+        return;
+    }
+    m_currentBytes -= it->second->bytes;
+    m_lru.erase(it->second);
+    m_index.erase(it);
+}
+
+void SensorDataCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_lru.clear();
+    m_index.clear();
+    m_currentBytes = 0;
+}
+
+void SensorDataCache::setMaxBytes(std::size_t maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBytes = maxBytes;
+    evictToBudget();
+}
+
+std::size_t SensorDataCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBytes;
+}
+
+std::size_t SensorDataCache::currentBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_currentBytes;
+}
+
+std::size_t SensorDataCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lru.size();
+}
+
+quint64 SensorDataCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 SensorDataCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+void SensorDataCache::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void SensorDataCache::evictToBudget()
+{
+    while (m_currentBytes > m_maxBytes && !m_lru.empty()) {
+        const Entry& oldest = m_lru.back();
+        m_currentBytes -= oldest.bytes;
+        m_index.erase(oldest.sensorId);
+        m_lru.pop_back();
+    }
+}
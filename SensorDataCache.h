@@ -0,0 +1,104 @@
+/**
+ * @file SensorDataCache.h
+ * @brief Definicja klasy SensorDataCache - ograniczonej rozmiarem pamięci podręcznej LRU sparsowanych danych pomiarowych.
+ */
+#ifndef SENSORDATACACHE_H
+#define SENSORDATACACHE_H
+
+#include <QMutex>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <cstddef>
+#include "DataStructures.h"
+
+/**
+ * @class SensorDataCache
+ * @brief Pamięć podręczna LRU obiektów SensorData indeksowana ID czujnika, ograniczona przybliżoną liczbą bajtów.
+ *
+ * Po przekroczeniu budżetu (`maxBytes`) usuwane są najdawniej używane wpisy. Klasa zlicza trafienia i chybienia,
+ * co pozwala ocenić skuteczność cache. Wszystkie metody są bezpieczne wątkowo.
+ *
+ * Dane są przechowywane jako niezmienne obiekty współdzielone - trafienie zwraca wskaźnik (O(1), bez kopiowania serii),
+ * a wpis usunięty z cache pozostaje ważny dla wszystkich, którzy go jeszcze trzymają.
+ */
+class SensorDataCache
+{
+public:
+    /**
+     * @brief Konstruktor.
+     * @param maxBytes Maksymalny przybliżony rozmiar danych w cache (w bajtach). Domyślnie 32 MiB.
+     */
+    explicit SensorDataCache(std::size_t maxBytes = 32 * 1024 * 1024);
+
+    /**
+     * @brief Pobiera dane czujnika z cache i oznacza je jako ostatnio używane.
+     * @param sensorId ID czujnika.
+     * @return Współdzielone dane lub `nullptr`, jeśli danych nie ma w cache (chybienie).
+     */
+    std::shared_ptr<const SensorData> get(int sensorId);
+
+    /**
+     * @brief Dodaje lub zastępuje dane czujnika w cache.
+     * Wpisy większe niż cały budżet nie są zapamiętywane.
+     * @param sensorId ID czujnika.
+     * @param data Dane do zapamiętania (współdzielone - nie są kopiowane; `nullptr` jest pomijany).
+     */
+    void put(int sensorId, std::shared_ptr<const SensorData> data);
+
+    /** @brief Wariant put() dla danych przekazywanych przez wartość (przenoszonych do nowego obiektu współdzielonego). */
+    void put(int sensorId, SensorData data);
+
+    /** @brief Sprawdza obecność wpisu bez zmiany kolejności LRU i liczników. */
+    bool contains(int sensorId) const;
+    /** @brief Zwraca wpis (lub `nullptr`) bez zmiany kolejności LRU i liczników. */
+    std::shared_ptr<const SensorData> peek(int sensorId) const;
+    /** @brief Usuwa wpis dla podanego czujnika (jeśli istnieje). */
+    void remove(int sensorId);
+    /** @brief Usuwa wszystkie wpisy (liczniki trafień/chybień pozostają bez zmian). */
+    void clear();
+
+    /** @brief Zmienia budżet pamięci; w razie potrzeby od razu usuwa najdawniej używane wpisy. */
+    void setMaxBytes(std::size_t maxBytes);
+    /** @brief Zwraca budżet pamięci w bajtach. */
+    std::size_t maxBytes() const;
+    /** @brief Zwraca przybliżony rozmiar danych aktualnie przechowywanych w cache. */
+    std::size_t currentBytes() const;
+    /** @brief Zwraca liczbę wpisów w cache. */
+    std::size_t size() const;
+
+    /** @brief Liczba trafień (udanych wywołań get()). */
+    quint64 hits() const;
+    /** @brief Liczba chybień (wywołań get() bez danych w cache). */
+    quint64 misses() const;
+    /** @brief Zeruje liczniki trafień i chybień. */
+    void resetStats();
+
+    /**
+     * @brief Szacuje rozmiar obiektu SensorData w pamięci (wraz z narzutem wpisu w cache).
+     * @param data Dane do oszacowania.
+     * @return Przybliżona liczba bajtów.
+     */
+    static std::size_t estimateBytes(const SensorData& data);
+
+private:
+    /// Pojedynczy wpis listy LRU (najnowsze na początku).
+    struct Entry {
+        int sensorId;
+        std::shared_ptr<const SensorData> data;
+        std::size_t bytes;
+    };
+
+    /// Usuwa wpisy z końca listy LRU, dopóki rozmiar przekracza budżet. Wymaga zablokowanego m_mutex.
+    void evictToBudget();
+
+    mutable QMutex m_mutex;     ///< Chroni wszystkie pola poniżej.
+    std::list<Entry> m_lru;     ///< Wpisy w kolejności od ostatnio używanego.
+    std::unordered_map<int, std::list<Entry>::iterator> m_index; ///< ID czujnika -> pozycja na liście LRU.
+    std::size_t m_maxBytes;     ///< Budżet pamięci.
+    std::size_t m_currentBytes = 0; ///< Suma `bytes` wszystkich wpisów.
+    quint64 m_hits = 0;         ///< Licznik trafień.
+    quint64 m_misses = 0;       ///< Licznik chybień.
+};
+
+#endif // SENSORDATACACHE_H
@@ -0,0 +1,628 @@
+#include "SeriesCodec.h"
+#include <QIODevice>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr char Magic[4] = {'A', 'Q', 'S', 'C'};
+constexpr int IndexEntrySize = 28;
+constexpr int BlockHeaderSize = 17; // data i wartość pierwszego pomiaru, tryb wartości
+
+/// Zapis strumienia bitów (od najstarszego bitu).
+class BitWriter
+{
+public:
+    explicit BitWriter(QByteArray& out) : m_out(out) {}
+
+    void write(quint64 value, int bits)
+    {
+        while (bits > 0) {
+            const int room = 8 - m_used;
+            const int n = std::min(room, bits);
+            const quint64 chunk = (value >> (bits - n)) & ((quint64(1) << n) - 1);
+            m_current = static_cast<quint8>(m_current | (chunk << (room - n)));
+            m_used += n;
+            bits -= n;
+            if (m_used == 8) {
+                m_out.append(static_cast<char>(m_current));
+                m_current = 0;
+                m_used = 0;
+            }
+        }
+    }
+
+    void finish()
+    {
+        if (m_used > 0) {
+            m_out.append(static_cast<char>(m_current));
+            m_current = 0;
+            m_used = 0;
+        }
+    }
+
+private:
+    QByteArray& m_out;
+    quint8 m_current = 0;
+    int m_used = 0;
+};
+
+/// Odczyt strumienia bitów zapisanego przez BitWriter; zwraca `false` po przekroczeniu końca danych.
+class BitReader
+{
+public:
+    BitReader(const uchar* data, qint64 size) : m_data(data), m_totalBits(size * 8) {}
+
+    bool read(int bits, quint64& value)
+    {
+        if (m_pos + bits > m_totalBits) {
+            return false;
+        }
+        value = 0;
+        while (bits > 0) {
+            const int bitInByte = static_cast<int>(m_pos & 7);
+            const int avail = 8 - bitInByte;
+            const int n = std::min(avail, bits);
+            const quint64 chunk = (m_data[m_pos >> 3] >> (avail - n)) & ((1u << n) - 1);
+            value = (value << n) | chunk;
+            m_pos += n;
+            bits -= n;
+        }
+        return true;
+    }
+
+private:
+    const uchar* m_data;
+    qint64 m_totalBits;
+    qint64 m_pos = 0;
+};
+
+int leadingZeros(quint64 x)
+{
+    int n = 0;
+    for (quint64 mask = quint64(1) << 63; mask && !(x & mask); mask >>= 1) {
+        ++n;
+    }
+    return n;
+}
+
+int trailingZeros(quint64 x)
+{
+    int n = 0;
+    for (; n < 64 && !(x & (quint64(1) << n)); ++n) {
+    }
+    return n;
+}
+
+quint64 doubleBits(double value)
+{
+    quint64 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(quint64 bits)
+{
+    double value = 0.0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    uchar buffer[sizeof(T)];
+    qToLittleEndian<T>(value, buffer);
+    out.append(reinterpret_cast<const char*>(buffer), sizeof(T));
+}
+
+constexpr int MaxDecimalDigits = 6;
+constexpr double PowersOf10[MaxDecimalDigits + 1] = {1.0, 10.0, 100.0, 1e3, 1e4, 1e5, 1e6};
+constexpr double MaxExactInteger = 9007199254740992.0; // 2^53
+
+/// Liczba pierwszych bitów 1 (najwyżej `max`) - prefiks kodu o zmiennej długości.
+bool readPrefix(BitReader& reader, int max, int& prefix)
+{
+    quint64 bit = 0;
+    for (prefix = 0; prefix < max; ++prefix) {
+        if (!reader.read(1, bit)) {
+            return false;
+        }
+        if (bit == 0) {
+            break;
+        }
+    }
+    return true;
+}
+
+/// Data: delta-of-delta w przedziałach coraz dłuższych kodów (stały odstęp - 1 bit).
+void writeDeltaOfDelta(BitWriter& writer, qint64 dod)
+{
+    if (dod == 0) {
+        writer.write(0b0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writer.write(0b10, 2);
+        writer.write(static_cast<quint64>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writer.write(0b110, 3);
+        writer.write(static_cast<quint64>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writer.write(0b1110, 4);
+        writer.write(static_cast<quint64>(dod + 2047), 12);
+    } else if (dod >= std::numeric_limits<qint32>::min() && dod <= std::numeric_limits<qint32>::max()) {
+        writer.write(0b11110, 5);
+        writer.write(static_cast<quint32>(static_cast<qint32>(dod)), 32);
+    } else {
+        writer.write(0b11111, 5);
+        writer.write(static_cast<quint64>(dod), 64);
+    }
+}
+
+bool readDeltaOfDelta(BitReader& reader, qint64& dod)
+{
+    int prefix = 0;
+    quint64 bits = 0;
+    if (!readPrefix(reader, 5, prefix)) {
+        return false;
+    }
+    switch (prefix) {
+    case 0:
+        dod = 0;
+        break;
+    case 1:
+        if (!reader.read(7, bits)) return false;
+        dod = static_cast<qint64>(bits) - 63;
+        break;
+    case 2:
+        if (!reader.read(9, bits)) return false;
+        dod = static_cast<qint64>(bits) - 255;
+        break;
+    case 3:
+        if (!reader.read(12, bits)) return false;
+        dod = static_cast<qint64>(bits) - 2047;
+        break;
+    case 4:
+        if (!reader.read(32, bits)) return false;
+        dod = static_cast<qint32>(static_cast<quint32>(bits));
+        break;
+    default:
+        if (!reader.read(64, bits)) return false;
+        dod = static_cast<qint64>(bits);
+        break;
+    }
+    return true;
+}
+
+/// Najmniejsza liczba cyfr po przecinku (0-6), przy której wszystkie wartości bloku są dokładnie całkowitymi
+/// wielokrotnościami 10^-d (NaN dozwolony); -1, jeśli takiej nie ma (blok jest wtedy kodowany XOR).
+int decimalDigits(const std::vector<std::pair<qint64, double>>& points, std::size_t begin, std::size_t end)
+{
+    const quint64 canonicalNaN = doubleBits(std::numeric_limits<double>::quiet_NaN());
+    for (int digits = 0; digits <= MaxDecimalDigits; ++digits) {
+        bool exact = true;
+        for (std::size_t i = begin; i < end && exact; ++i) {
+            const double value = points[i].second;
+            if (std::isnan(value)) {
+                exact = doubleBits(value) == canonicalNaN;
+                continue;
+            }
+            // -0.0 nie ma odpowiednika całkowitego - blok z nim jest kodowany XOR.
+            const double scaled = std::round(value * PowersOf10[digits]);
+            exact = std::abs(scaled) < MaxExactInteger && !(value == 0.0 && std::signbit(value))
+                    && doubleBits(scaled / PowersOf10[digits]) == doubleBits(value);
+        }
+        if (exact) {
+            return digits;
+        }
+    }
+    return -1;
+}
+
+/// Wartość dziesiętna: różnica liczb całkowitych (wartość · 10^d) w przedziałach coraz dłuższych kodów.
+void writeDecimal(BitWriter& writer, double value, int digits, qint64& prevScaled)
+{
+    if (std::isnan(value)) {
+        writer.write(0b11111, 5);
+        return;
+    }
+    const qint64 scaled = static_cast<qint64>(std::round(value * PowersOf10[digits]));
+    const qint64 diff = scaled - prevScaled;
+    if (diff == 0) {
+        writer.write(0b0, 1);
+    } else if (diff >= -63 && diff <= 64) {
+        writer.write(0b10, 2);
+        writer.write(static_cast<quint64>(diff + 63), 7);
+    } else if (diff >= -2047 && diff <= 2048) {
+        writer.write(0b110, 3);
+        writer.write(static_cast<quint64>(diff + 2047), 12);
+    } else if (diff >= -524287 && diff <= 524288) {
+        writer.write(0b1110, 4);
+        writer.write(static_cast<quint64>(diff + 524287), 20);
+    } else {
+        writer.write(0b11110, 5);
+        writer.write(static_cast<quint64>(scaled), 64);
+    }
+    prevScaled = scaled;
+}
+
+bool readDecimal(BitReader& reader, int digits, qint64& prevScaled, double& value)
+{
+    int prefix = 0;
+    quint64 bits = 0;
+    if (!readPrefix(reader, 5, prefix)) {
+        return false;
+    }
+    switch (prefix) {
+    case 0:
+        break;
+    case 1:
+        if (!reader.read(7, bits)) return false;
+        prevScaled += static_cast<qint64>(bits) - 63;
+        break;
+    case 2:
+        if (!reader.read(12, bits)) return false;
+        prevScaled += static_cast<qint64>(bits) - 2047;
+        break;
+    case 3:
+        if (!reader.read(20, bits)) return false;
+        prevScaled += static_cast<qint64>(bits) - 524287;
+        break;
+    case 4:
+        if (!reader.read(64, bits)) return false;
+        prevScaled = static_cast<qint64>(bits);
+        break;
+    default:
+        value = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+    value = static_cast<double>(prevScaled) / PowersOf10[digits];
+    return true;
+}
+
+/// Wartość dowolna: XOR z poprzednią; zapisywane są tylko bity znaczące, w oknie poprzedniej wartości, jeśli się mieszczą.
+struct XorState {
+    quint64 prevValue = 0;
+    int prevLeading = -1;
+    int prevTrailing = 0;
+};
+
+void writeXor(BitWriter& writer, double value, XorState& state)
+{
+    const quint64 bits = doubleBits(value);
+    const quint64 x = bits ^ state.prevValue;
+    state.prevValue = bits;
+    if (x == 0) {
+        writer.write(0b0, 1);
+        return;
+    }
+    const int leading = std::min(leadingZeros(x), 31);
+    const int trailing = trailingZeros(x);
+    if (state.prevLeading >= 0 && leading >= state.prevLeading && trailing >= state.prevTrailing) {
+        writer.write(0b10, 2);
+        writer.write(x >> state.prevTrailing, 64 - state.prevLeading - state.prevTrailing);
+        return;
+    }
+    const int length = 64 - leading - trailing;
+    writer.write(0b11, 2);
+    writer.write(static_cast<quint64>(leading), 5);
+    writer.write(static_cast<quint64>(length == 64 ? 0 : length), 6);
+    writer.write(x >> trailing, length);
+    state.prevLeading = leading;
+    state.prevTrailing = trailing;
+}
+
+bool readXor(BitReader& reader, XorState& state, double& value)
+{
+    int prefix = 0;
+    quint64 bits = 0;
+    if (!readPrefix(reader, 2, prefix)) {
+        return false;
+    }
+    if (prefix == 1) {
+        if (state.prevLeading < 0 || !reader.read(64 - state.prevLeading - state.prevTrailing, bits)) {
+            return false;
+        }
+        state.prevValue ^= bits << state.prevTrailing;
+    } else if (prefix == 2) {
+        quint64 leading = 0;
+        quint64 length = 0;
+        if (!reader.read(5, leading) || !reader.read(6, length)) {
+            return false;
+        }
+        if (length == 0) {
+            length = 64;
+        }
+        if (leading + length > 64 || !reader.read(static_cast<int>(length), bits)) {
+            return false;
+        }
+        state.prevLeading = static_cast<int>(leading);
+        state.prevTrailing = static_cast<int>(64 - leading - length);
+        state.prevValue ^= bits << state.prevTrailing;
+    }
+    value = bitsDouble(state.prevValue);
+    return true;
+}
+
+/// Koduje pomiary [begin, end) jako jeden blok: data i wartość pierwszego pomiaru, tryb wartości, strumień bitów.
+void encodeBlock(const std::vector<std::pair<qint64, double>>& points, std::size_t begin, std::size_t end,
+                 QByteArray& out)
+{
+    const int digits = decimalDigits(points, begin, end);
+    const double first = points[begin].second;
+    appendLittleEndian<qint64>(out, points[begin].first);
+    appendLittleEndian<quint64>(out, doubleBits(first));
+    out.append(static_cast<char>(digits + 1)); // 0 - XOR, 1-7 - wartości dziesiętne z (tryb - 1) cyframi
+
+    BitWriter writer(out);
+    qint64 prevMSecs = points[begin].first;
+    qint64 prevDelta = 0;
+    qint64 prevScaled = digits >= 0 && !std::isnan(first) ? static_cast<qint64>(std::round(first * PowersOf10[digits])) : 0;
+    XorState xorState;
+    xorState.prevValue = doubleBits(first);
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        const qint64 delta = points[i].first - prevMSecs;
+        writeDeltaOfDelta(writer, delta - prevDelta);
+        prevDelta = delta;
+        prevMSecs = points[i].first;
+
+        if (digits >= 0) {
+            writeDecimal(writer, points[i].second, digits, prevScaled);
+        } else {
+            writeXor(writer, points[i].second, xorState);
+        }
+    }
+    writer.finish();
+}
+
+/// Dekoduje blok; dopisuje do `out` pomiary z datą w [fromMSecs, toMSecs).
+bool decodeBlock(const uchar* data, qint64 size, quint32 count, qint64 fromMSecs, qint64 toMSecs,
+                 std::vector<MeasurementValue>& out)
+{
+    if (count == 0 || size < BlockHeaderSize || data[16] > MaxDecimalDigits + 1) {
+        return false;
+    }
+    qint64 msecs = qFromLittleEndian<qint64>(data);
+    double value = bitsDouble(qFromLittleEndian<quint64>(data + 8));
+    const int digits = static_cast<int>(data[16]) - 1;
+    auto keep = [&]() {
+        if (msecs >= fromMSecs && msecs < toMSecs) {
+            MeasurementValue mv;
+            mv.date = QDateTime::fromMSecsSinceEpoch(msecs);
+            mv.value = value;
+            out.push_back(mv);
+        }
+    };
+    keep();
+
+    BitReader reader(data + BlockHeaderSize, size - BlockHeaderSize);
+    qint64 prevDelta = 0;
+    qint64 prevScaled = digits >= 0 && !std::isnan(value) ? static_cast<qint64>(std::round(value * PowersOf10[digits])) : 0;
+    XorState xorState;
+    xorState.prevValue = doubleBits(value);
+    for (quint32 i = 1; i < count; ++i) {
+        qint64 dod = 0;
+        if (!readDeltaOfDelta(reader, dod)) {
+            return false;
+        }
+        prevDelta += dod;
+        msecs += prevDelta;
+
+        const bool ok = digits >= 0 ? readDecimal(reader, digits, prevScaled, value) : readXor(reader, xorState, value);
+        if (!ok) {
+            return false;
+        }
+        keep();
+    }
+    return true;
+}
+
+/// Nagłówek serii odczytany przez parseHeader().
+struct Header {
+    QString key;
+    quint32 pointCount = 0;
+    std::vector<SeriesCodec::BlockInfo> blocks;
+    qint64 dataStart = 0;
+};
+
+/// Odczytuje nagłówek z początku `bytes`; położenia bloków są sprawdzane względem `totalSize` (-1 - rozmiar `bytes`).
+std::optional<Header> parseHeader(const QByteArray& bytes, qint64 totalSize = -1)
+{
+    const uchar* in = reinterpret_cast<const uchar*>(bytes.constData());
+    const qint64 size = bytes.size();
+    const qint64 seriesSize = totalSize < 0 ? size : totalSize;
+    if (size < 10 || !std::equal(Magic, Magic + 4, bytes.constData())
+        || qFromLittleEndian<quint16>(in + 4) != SeriesCodec::FormatVersion) {
+        return std::nullopt;
+    }
+    const quint16 keyLength = qFromLittleEndian<quint16>(in + 8);
+    qint64 pos = 10;
+    if (pos + keyLength + 8 > size) {
+        return std::nullopt;
+    }
+    Header header;
+    header.key = QString::fromUtf8(bytes.constData() + pos, keyLength);
+    pos += keyLength;
+    header.pointCount = qFromLittleEndian<quint32>(in + pos);
+    const quint32 blockCount = qFromLittleEndian<quint32>(in + pos + 4);
+    pos += 8;
+    if (pos + static_cast<qint64>(blockCount) * IndexEntrySize > size) {
+        return std::nullopt;
+    }
+    header.dataStart = pos + static_cast<qint64>(blockCount) * IndexEntrySize;
+
+    quint64 total = 0;
+    header.blocks.reserve(blockCount);
+    for (quint32 b = 0; b < blockCount; ++b, pos += IndexEntrySize) {
+        SeriesCodec::BlockInfo info;
+        info.minMSecs = qFromLittleEndian<qint64>(in + pos);
+        info.maxMSecs = qFromLittleEndian<qint64>(in + pos + 8);
+        info.count = qFromLittleEndian<quint32>(in + pos + 16);
+        info.offset = qFromLittleEndian<quint32>(in + pos + 20);
+        info.size = qFromLittleEndian<quint32>(in + pos + 24);
+        if (header.dataStart + info.offset + info.size > seriesSize) {
+            return std::nullopt;
+        }
+        total += info.count;
+        header.blocks.push_back(info);
+    }
+    if (total != header.pointCount) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+} // namespace
+
+QByteArray SeriesCodec::encode(const SensorData& data, int blockSize)
+{
+    blockSize = std::clamp(blockSize, 2, int(std::numeric_limits<quint16>::max()));
+
+    std::vector<std::pair<qint64, double>> points;
+    points.reserve(data.values.size());
+    for (const MeasurementValue& mv : data.values) {
+        if (mv.date.isValid()) {
+            points.emplace_back(mv.date.toMSecsSinceEpoch(), mv.value);
+        }
+    }
+
+    QByteArray blocksData;
+    std::vector<BlockInfo> index;
+    for (std::size_t begin = 0; begin < points.size(); begin += static_cast<std::size_t>(blockSize)) {
+        const std::size_t end = std::min(points.size(), begin + static_cast<std::size_t>(blockSize));
+        BlockInfo info;
+        const auto range = std::minmax_element(points.begin() + begin, points.begin() + end,
+                                               [](const auto& a, const auto& b) { return a.first < b.first; });
+        info.minMSecs = range.first->first;
+        info.maxMSecs = range.second->first;
+        info.count = static_cast<quint32>(end - begin);
+        info.offset = static_cast<quint32>(blocksData.size());
+        encodeBlock(points, begin, end, blocksData);
+        info.size = static_cast<quint32>(blocksData.size()) - info.offset;
+        index.push_back(info);
+    }
+
+    const QByteArray key = data.key.toUtf8();
+    QByteArray out;
+    out.reserve(14 + key.size() + static_cast<int>(index.size()) * IndexEntrySize + blocksData.size());
+    out.append(Magic, 4);
+    appendLittleEndian<quint16>(out, FormatVersion);
+    appendLittleEndian<quint16>(out, static_cast<quint16>(blockSize));
+    appendLittleEndian<quint16>(out, static_cast<quint16>(key.size()));
+    out.append(key);
+    appendLittleEndian<quint32>(out, static_cast<quint32>(points.size()));
+    appendLittleEndian<quint32>(out, static_cast<quint32>(index.size()));
+    for (const BlockInfo& info : index) {
+        appendLittleEndian<qint64>(out, info.minMSecs);
+        appendLittleEndian<qint64>(out, info.maxMSecs);
+        appendLittleEndian<quint32>(out, info.count);
+        appendLittleEndian<quint32>(out, info.offset);
+        appendLittleEndian<quint32>(out, info.size);
+    }
+    out.append(blocksData);
+    return out;
+}
+
+std::optional<SensorData> SeriesCodec::decode(const QByteArray& bytes, const QDateTime& from, const QDateTime& to)
+{
+    const std::optional<Header> header = parseHeader(bytes);
+    if (!header) {
+        return std::nullopt;
+    }
+    const qint64 fromMSecs = from.isValid() ? from.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+    const qint64 toMSecs = to.isValid() ? to.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+
+    SensorData data;
+    data.key = header->key;
+    data.values.reserve(from.isValid() || to.isValid() ? 0 : header->pointCount);
+    const uchar* in = reinterpret_cast<const uchar*>(bytes.constData()) + header->dataStart;
+    for (const BlockInfo& info : header->blocks) {
+        if (info.maxMSecs < fromMSecs || info.minMSecs >= toMSecs) {
+            continue;
+        }
+        if (!decodeBlock(in + info.offset, info.size, info.count, fromMSecs, toMSecs, data.values)) {
+            return std::nullopt;
+        }
+    }
+    return data;
+}
+
+std::optional<std::vector<SeriesCodec::BlockInfo>> SeriesCodec::blocks(const QByteArray& bytes, QString* key)
+{
+    std::optional<Header> header = parseHeader(bytes);
+    if (!header) {
+        return std::nullopt;
+    }
+    if (key) {
+        *key = header->key;
+    }
+    return std::move(header->blocks);
+}
+
+bool SeriesCodec::readBlock(const QByteArray& bytes, const BlockInfo& block, std::vector<MeasurementValue>& out,
+                            qint64 fromMSecs, qint64 toMSecs)
+{
+    // Początek sekcji danych z długości klucza i liczby bloków - bez ponownego odczytu indeksu
+    const uchar* in = reinterpret_cast<const uchar*>(bytes.constData());
+    const qint64 size = bytes.size();
+    if (size < 10) {
+        return false;
+    }
+    const qint64 countsPos = 10 + qFromLittleEndian<quint16>(in + 8);
+    if (countsPos + 8 > size) {
+        return false;
+    }
+    const qint64 dataStart = countsPos + 8 + static_cast<qint64>(qFromLittleEndian<quint32>(in + countsPos + 4)) * IndexEntrySize;
+    if (dataStart + block.offset + block.size > size) {
+        return false;
+    }
+    return decodeBlock(in + dataStart + block.offset, block.size, block.count, fromMSecs, toMSecs, out);
+}
+
+std::optional<std::vector<SeriesCodec::BlockInfo>> SeriesCodec::readIndex(QIODevice& device, qint64 seriesSize,
+                                                                          QString* key, qint64* dataStart)
+{
+    // Nagłówek czytany w trzech krokach (stała część, klucz z licznikami, indeks) - bez danych bloków
+    if (!device.seek(0)) {
+        return std::nullopt;
+    }
+    QByteArray bytes = device.read(10);
+    if (bytes.size() < 10) {
+        return std::nullopt;
+    }
+    const quint16 keyLength = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(bytes.constData()) + 8);
+    bytes += device.read(keyLength + 8);
+    if (bytes.size() < 10 + keyLength + 8) {
+        return std::nullopt;
+    }
+    const quint32 blockCount =
+        qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(bytes.constData()) + 10 + keyLength + 4);
+    const qint64 indexSize = static_cast<qint64>(blockCount) * IndexEntrySize;
+    if (10 + keyLength + 8 + indexSize > seriesSize) {
+        return std::nullopt;
+    }
+    bytes += device.read(indexSize);
+
+    std::optional<Header> header = parseHeader(bytes, seriesSize);
+    if (!header) {
+        return std::nullopt;
+    }
+    if (key) {
+        *key = header->key;
+    }
+    if (dataStart) {
+        *dataStart = header->dataStart;
+    }
+    return std::move(header->blocks);
+}
+
+bool SeriesCodec::readBlockData(const QByteArray& blockData, const BlockInfo& block, std::vector<MeasurementValue>& out,
+                                qint64 fromMSecs, qint64 toMSecs)
+{
+    if (blockData.size() != static_cast<qint64>(block.size)) {
+        return false;
+    }
+    return decodeBlock(reinterpret_cast<const uchar*>(blockData.constData()), blockData.size(), block.count,
+                       fromMSecs, toMSecs, out);
+}
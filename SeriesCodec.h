@@ -0,0 +1,107 @@
+/**
+ * @file SeriesCodec.h
+ * @brief Definicja klasy SeriesCodec - kompresji serii pomiarów (XOR wartości i delta-of-delta dat, jak w Gorilla).
+ */
+#ifndef SERIESCODEC_H
+#define SERIESCODEC_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "DataStructures.h"
+
+class QIODevice;
+
+/**
+ * @class SeriesCodec
+ * @brief Koduje serię pomiarów czujnika (SensorData) do zwartego formatu binarnego podzielonego na bloki.
+ *
+ * Pomiary godzinowe są bardzo regularne: kolejne daty różnią się o dokładnie 1 h, a wartości zmieniają się powoli.
+ * Data jest więc zapisywana jako różnica drugiego rzędu (delta-of-delta) - dla stałego odstępu to 1 bit. Wartości
+ * z API mają zwykle kilka cyfr po przecinku: jeśli wszystkie wartości bloku są dokładnie liczbami dziesiętnymi
+ * o najwyżej 6 cyfrach, zapisywana jest różnica kolejnych wartości jako liczb całkowitych (wartość · 10^d). W przeciwnym
+ * razie wartość jest zapisywana jako XOR z poprzednią (jak w Gorilla) - tylko bity znaczące, powtórzona wartość to 1 bit.
+ * Oba tryby są bezstratne (bit w bit, także NaN). Typowa seria zajmuje 1-3 bajty na pomiar zamiast ~60 w JSON.
+ *
+ * Seria jest dzielona na bloki po `blockSize` pomiarów, kodowane niezależnie. Indeks bloków w nagłówku (zakres dat,
+ * liczba pomiarów, położenie) pozwala zdekodować tylko bloki nachodzące na zadany przedział dat. Kolejność pomiarów
+ * jest zachowywana (API zwraca je od najnowszego); pomiary z nieprawidłową datą są pomijane.
+ *
+ * Format (little-endian): "AQSC", wersja i rozmiar bloku (quint16), długość i bajty UTF-8 klucza,
+ * liczba pomiarów i bloków (quint32), wpisy indeksu (28 bajtów na blok), dane bloków.
+ */
+class SeriesCodec
+{
+public:
+    /// Wersja formatu.
+    static constexpr quint16 FormatVersion = 1;
+    /// Domyślna liczba pomiarów w bloku (~10 dni danych godzinowych).
+    static constexpr int DefaultBlockSize = 256;
+
+    /// Wpis indeksu bloków.
+    struct BlockInfo {
+        qint64 minMSecs = 0;  ///< Najwcześniejsza data w bloku (ms od epoki).
+        qint64 maxMSecs = 0;  ///< Najpóźniejsza data w bloku (ms od epoki).
+        quint32 count = 0;    ///< Liczba pomiarów.
+        quint32 offset = 0;   ///< Położenie danych bloku względem początku sekcji danych.
+        quint32 size = 0;     ///< Długość danych bloku w bajtach.
+    };
+
+    /**
+     * @brief Koduje serię.
+     * @param data Seria (klucz i pomiary w dowolnej kolejności; NaN jest zachowywany).
+     * @param blockSize Liczba pomiarów w bloku (2-65535).
+     * @return Zakodowana seria.
+     */
+    static QByteArray encode(const SensorData& data, int blockSize = DefaultBlockSize);
+
+    /**
+     * @brief Dekoduje serię lub jej fragment z datami w przedziale [from, to).
+     * Nieprawidłowe `from`/`to` oznaczają przedział otwarty z danej strony; bloki spoza przedziału nie są dekodowane.
+     * @return Seria; std::nullopt, jeśli dane są uszkodzone lub w innej wersji formatu.
+     */
+    static std::optional<SensorData> decode(const QByteArray& bytes, const QDateTime& from = QDateTime(),
+                                            const QDateTime& to = QDateTime());
+
+    /**
+     * @brief Odczytuje tylko nagłówek (klucz i indeks bloków), bez dekodowania pomiarów.
+     * @param key Jeśli nie nullptr, otrzymuje klucz serii.
+     * @return Indeks bloków; std::nullopt, jeśli nagłówek jest uszkodzony.
+     */
+    static std::optional<std::vector<BlockInfo>> blocks(const QByteArray& bytes, QString* key = nullptr);
+
+    /**
+     * @brief Dekoduje jeden blok serii (wpis z blocks()) i dopisuje do `out` jego pomiary z datą w [fromMSecs, toMSecs).
+     * Pozwala czytać bloki raz odczytanej serii stopniowo, np. w kolejności dat.
+     * @param bytes Cała zakodowana seria, z której pochodzi `block`.
+     * @return `false`, jeśli dane bloku są uszkodzone.
+     */
+    static bool readBlock(const QByteArray& bytes, const BlockInfo& block, std::vector<MeasurementValue>& out,
+                          qint64 fromMSecs = std::numeric_limits<qint64>::min(),
+                          qint64 toMSecs = std::numeric_limits<qint64>::max());
+
+    /**
+     * @brief Odczytuje z urządzenia (np. pliku) tylko nagłówek serii - bez danych bloków.
+     * Razem z readBlockData() pozwala czytać serię z pliku blok po bloku, bez wczytywania całości do pamięci.
+     * @param seriesSize Długość zakodowanej serii w urządzeniu (bez np. stopki pliku) - do sprawdzenia położenia bloków.
+     * @param key Jeśli nie nullptr, otrzymuje klucz serii.
+     * @param dataStart Jeśli nie nullptr, otrzymuje położenie sekcji danych; blok zaczyna się w `dataStart + offset`.
+     * @return Indeks bloków; std::nullopt, jeśli nagłówek jest uszkodzony lub nie da się go odczytać.
+     */
+    static std::optional<std::vector<BlockInfo>> readIndex(QIODevice& device, qint64 seriesSize, QString* key = nullptr,
+                                                           qint64* dataStart = nullptr);
+
+    /**
+     * @brief Jak readBlock(), ale dla samych danych bloku (`block.size` bajtów odczytanych spod `dataStart + offset`).
+     * @return `false`, jeśli dane bloku są uszkodzone lub mają inną długość.
+     */
+    static bool readBlockData(const QByteArray& blockData, const BlockInfo& block, std::vector<MeasurementValue>& out,
+                              qint64 fromMSecs = std::numeric_limits<qint64>::min(),
+                              qint64 toMSecs = std::numeric_limits<qint64>::max());
+
+    SeriesCodec() = delete;
+};
+
+#endif // SERIESCODEC_H
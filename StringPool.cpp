@@ -0,0 +1,50 @@
+#include "StringPool.h"
+#include <QReadWriteLock>
+#include <QSet>
+
+namespace {
+
+/// Stan globalnej puli; napisy są tylko dodawane, więc większość wywołań kończy się na blokadzie do odczytu.
+struct PoolData {
+    QReadWriteLock lock;
+    QSet<QString> strings;
+};
+
+PoolData& pool()
+{
+    static PoolData data;
+    return data;
+}
+
+} // namespace
+
+QString StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return value;
+    }
+
+    PoolData& data = pool();
+    {
+        QReadLocker locker(&data.lock);
+        auto it = data.strings.constFind(value);
+        if (it != data.strings.constEnd()) {
+            return *it;
+        }
+    }
+
+    QWriteLocker locker(&data.lock);
+    auto it = data.strings.constFind(value); // inny wątek mógł go dodać w międzyczasie
+    if (it != data.strings.constEnd()) {
+        return *it;
+    }
+    data.strings.insert(value);
+    return value;
+}
+
+int StringPool::size()
+{
+    PoolData& data = pool();
+    QReadLocker locker(&data.lock);
+    return static_cast<int>(data.strings.size());
+}
@@ -0,0 +1,38 @@
+/**
+ * @file StringPool.h
+ * @brief Definicja klasy StringPool - wspólnej puli powtarzających się napisów katalogu (parametry, województwa, gminy).
+ */
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+
+/**
+ * @class StringPool
+ * @brief Globalna pula napisów (interning) dla powtarzalnych pól katalogu stacji i czujników.
+ *
+ * Te same nazwy województw, powiatów, gmin, miejscowości oraz kody i nazwy parametrów powtarzają się w tysiącach
+ * rekordów. QString jest współdzielony niejawnie (implicit sharing), więc zwrócenie kopii napisu z puli sprawia, że
+ * wszystkie rekordy wskazują na jeden bufor zamiast na osobne alokacje po parsowaniu. Porównanie dwóch napisów z puli
+ * kończy się już na porównaniu wskaźników do wspólnego bufora (dla równych napisów).
+ *
+ * DataParser i DataStorage wywołują intern() przy wczytywaniu. Pula przechowuje tylko napisy katalogowe (zbiór
+ * ograniczony), dlatego nie jest czyszczona. Metody są bezpieczne wątkowo (np. równoległe wczytywanie w FleetAnalyzer).
+ */
+class StringPool
+{
+public:
+    /**
+     * @brief Zwraca napis z puli równy `value` (dodaje go, jeśli jeszcze go nie ma).
+     * @param value Napis do zinternowania.
+     * @return Kopia współdzieląca bufor z napisem w puli; pusty napis jest zwracany bez zmian.
+     */
+    static QString intern(const QString& value);
+
+    /** @brief Liczba różnych napisów w puli. */
+    static int size();
+
+    StringPool() = delete;
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,710 @@
+#include "TableWriter.h"
+#include <QDebug>
+#include <QIODevice>
+#include <QtEndian>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+int valueWidth(ColumnType type)
+{
+    switch (type) {
+    case ColumnType::Int32: return 4;
+    case ColumnType::Timestamp: return 8;
+    case ColumnType::Float64: return 8;
+    case ColumnType::Utf8: return 0;
+    }
+    return 0;
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian<T>(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(quint64 bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+qint64 align8(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+// --- CSV ---
+
+/// Dopisuje liczbę całkowitą bez tworzenia tekstu pośredniego.
+void appendInteger(QByteArray& out, qint64 value)
+{
+    char buffer[24];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<int>(result.ptr - buffer));
+}
+
+/// Dopisuje liczbę w najkrótszej postaci, która odczytana daje tę samą wartość.
+void appendDouble(QByteArray& out, double value)
+{
+    char buffer[32];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<int>(result.ptr - buffer));
+}
+
+void appendDigits(QByteArray& out, int value, int width)
+{
+    char buffer[4];
+    for (int i = width - 1; i >= 0; --i) {
+        buffer[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(buffer, width);
+}
+
+/// Dopisuje datę w ISO 8601 UTC ("2024-01-01T13:00:00Z"; milisekundy tylko, gdy są niezerowe).
+void appendTimestamp(QByteArray& out, qint64 msecs)
+{
+    constexpr qint64 MSecsPerDay = 86400000;
+    qint64 days = msecs / MSecsPerDay;
+    qint64 msOfDay = msecs % MSecsPerDay;
+    if (msOfDay < 0) {
+        msOfDay += MSecsPerDay;
+        days--;
+    }
+    // Data kalendarzowa z liczby dni od 1970-01-01 (algorytm "civil_from_days" H. Hinnanta).
+    const qint64 z = days + 719468;
+    const qint64 era = (z >= 0 ? z : z - 146096) / 146097;
+    const qint64 doe = z - era * 146097;
+    const qint64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const qint64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const qint64 mp = (5 * doy + 2) / 153;
+    const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+
+    appendDigits(out, year, 4);
+    out.append('-');
+    appendDigits(out, month, 2);
+    out.append('-');
+    appendDigits(out, day, 2);
+    out.append('T');
+    appendDigits(out, static_cast<int>(msOfDay / 3600000), 2);
+    out.append(':');
+    appendDigits(out, static_cast<int>(msOfDay / 60000 % 60), 2);
+    out.append(':');
+    appendDigits(out, static_cast<int>(msOfDay / 1000 % 60), 2);
+    if (msOfDay % 1000 != 0) {
+        out.append('.');
+        appendDigits(out, static_cast<int>(msOfDay % 1000), 3);
+    }
+    out.append('Z');
+}
+
+/// Dopisuje pole tekstowe, w cudzysłowie, jeśli zawiera przecinek, cudzysłów lub koniec linii.
+void appendCsvText(QByteArray& out, const char* data, int size)
+{
+    bool quote = false;
+    for (int i = 0; i < size && !quote; ++i) {
+        quote = data[i] == ',' || data[i] == '"' || data[i] == '\n' || data[i] == '\r';
+    }
+    if (!quote) {
+        out.append(data, size);
+        return;
+    }
+    out.append('"');
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == '"') {
+            out.append('"');
+        }
+        out.append(data[i]);
+    }
+    out.append('"');
+}
+
+class CsvTableWriter : public TableWriter
+{
+public:
+    explicit CsvTableWriter(QIODevice* device) : TableWriter(device) {}
+
+protected:
+    bool writeHeader() override
+    {
+        QByteArray line;
+        for (std::size_t i = 0; i < m_columns.size(); ++i) {
+            if (i > 0) {
+                line.append(',');
+            }
+            const QByteArray name = m_columns[i].spec.name.toUtf8();
+            appendCsvText(line, name.constData(), name.size());
+        }
+        line.append('\n');
+        return write(line);
+    }
+
+    bool writeBatch() override
+    {
+        for (int row = 0; row < m_batchRows; ++row) {
+            for (std::size_t i = 0; i < m_columns.size(); ++i) {
+                if (i > 0) {
+                    m_text.append(',');
+                }
+                const Column& column = m_columns[i];
+                if (!isValid(column, row)) {
+                    continue;
+                }
+                const char* values = column.values.constData();
+                switch (column.spec.type) {
+                case ColumnType::Int32:
+                    appendInteger(m_text, qFromLittleEndian<qint32>(values + row * 4));
+                    break;
+                case ColumnType::Timestamp:
+                    appendTimestamp(m_text, qFromLittleEndian<qint64>(values + row * 8));
+                    break;
+                case ColumnType::Float64:
+                    appendDouble(m_text, bitsDouble(qFromLittleEndian<quint64>(values + row * 8)));
+                    break;
+                case ColumnType::Utf8: {
+                    const qint32 begin = qFromLittleEndian<qint32>(column.offsets.constData() + row * 4);
+                    const qint32 end = qFromLittleEndian<qint32>(column.offsets.constData() + (row + 1) * 4);
+                    appendCsvText(m_text, values + begin, end - begin);
+                    break;
+                }
+                }
+            }
+            m_text.append('\n');
+            if (m_text.size() >= TextBufferSize && !flushText()) {
+                return false;
+            }
+        }
+        return flushText();
+    }
+
+    bool writeFooter() override { return true; }
+
+private:
+    static constexpr int TextBufferSize = 1 << 20;
+
+    bool flushText()
+    {
+        const bool ok = write(m_text);
+        m_text.resize(0); // zachowuje zaalokowany bufor
+        return ok;
+    }
+
+    QByteArray m_text; ///< Bufor tekstu wierszy przed zapisem do urządzenia.
+};
+
+// --- Arrow IPC ---
+
+/**
+ * Minimalny zapis FlatBuffers (format metadanych Arrow), budowany od końca jak w oficjalnej bibliotece:
+ * obiekty zagnieżdżone powstają przed obiektami, które się do nich odwołują. Offset obiektu to jego odległość
+ * od końca bufora.
+ */
+class FlatBufferBuilder
+{
+public:
+    using Offset = quint32;
+
+    quint32 size() const { return static_cast<quint32>(m_buffer.size() - m_head); }
+
+    Offset createString(const QByteArray& text)
+    {
+        align(4, static_cast<std::size_t>(text.size()) + 1);
+        pushBytes("", 1);
+        pushBytes(text.constData(), static_cast<std::size_t>(text.size()));
+        pushScalar<quint32>(static_cast<quint32>(text.size()));
+        return size();
+    }
+
+    Offset createOffsetVector(const std::vector<Offset>& offsets)
+    {
+        align(4, offsets.size() * 4);
+        for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) {
+            pushOffset(*it);
+        }
+        pushScalar<quint32>(static_cast<quint32>(offsets.size()));
+        return size();
+    }
+
+    /// Wektor struktur zapisanych już w kolejności elementów (little-endian).
+    Offset createStructVector(const QByteArray& packed, int count, std::size_t alignment)
+    {
+        align(4, static_cast<std::size_t>(packed.size()));
+        align(alignment, static_cast<std::size_t>(packed.size()));
+        pushBytes(packed.constData(), static_cast<std::size_t>(packed.size()));
+        pushScalar<quint32>(static_cast<quint32>(count));
+        return size();
+    }
+
+    void startTable()
+    {
+        m_fields.clear();
+        m_tableStart = size();
+    }
+
+    template <typename T>
+    void addScalar(int slot, T value)
+    {
+        pushScalar<T>(value);
+        m_fields.push_back({slot, size()});
+    }
+
+    void addOffset(int slot, Offset offset)
+    {
+        pushOffset(offset);
+        m_fields.push_back({slot, size()});
+    }
+
+    Offset endTable()
+    {
+        pushScalar<qint32>(0); // miejsce na odległość do vtable
+        const Offset table = size();
+        int slotCount = 0;
+        for (const FieldLocation& field : m_fields) {
+            slotCount = std::max(slotCount, field.slot + 1);
+        }
+        std::vector<quint16> vtableEntries(static_cast<std::size_t>(slotCount), 0);
+        for (const FieldLocation& field : m_fields) {
+            vtableEntries[static_cast<std::size_t>(field.slot)] = static_cast<quint16>(table - field.offset);
+        }
+        for (auto it = vtableEntries.rbegin(); it != vtableEntries.rend(); ++it) {
+            pushScalar<quint16>(*it);
+        }
+        pushScalar<quint16>(static_cast<quint16>(table - m_tableStart));
+        pushScalar<quint16>(static_cast<quint16>(4 + 2 * slotCount));
+        const Offset vtable = size();
+        qToLittleEndian<qint32>(static_cast<qint32>(vtable - table), &m_buffer[m_buffer.size() - table]);
+        m_fields.clear();
+        return table;
+    }
+
+    QByteArray finish(Offset root)
+    {
+        align(m_minAlign, 4);
+        pushOffset(root);
+        return QByteArray(m_buffer.data() + m_head, static_cast<int>(size()));
+    }
+
+private:
+    struct FieldLocation {
+        int slot;
+        Offset offset;
+    };
+
+    void reserve(std::size_t bytes)
+    {
+        if (m_head >= bytes) {
+            return;
+        }
+        const std::size_t used = size();
+        const std::size_t capacity = std::max<std::size_t>(2 * m_buffer.size(), used + bytes + 256);
+        std::vector<char> grown(capacity);
+        std::copy(m_buffer.end() - static_cast<std::ptrdiff_t>(used), m_buffer.end(), grown.end() - static_cast<std::ptrdiff_t>(used));
+        m_head = capacity - used;
+        m_buffer.swap(grown);
+    }
+
+    void pushBytes(const char* data, std::size_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+        reserve(count);
+        m_head -= count;
+        std::memcpy(m_buffer.data() + m_head, data, count);
+    }
+
+    /// Wyrównuje tak, aby po dopisaniu `additional` bajtów rozmiar był wielokrotnością `alignment`.
+    void align(std::size_t alignment, std::size_t additional = 0)
+    {
+        m_minAlign = std::max(m_minAlign, alignment);
+        static const char zeros[8] = {};
+        pushBytes(zeros, (alignment - (size() + additional) % alignment) % alignment);
+    }
+
+    template <typename T>
+    void pushScalar(T value)
+    {
+        align(sizeof(T));
+        char buffer[sizeof(T)];
+        qToLittleEndian<T>(value, buffer);
+        pushBytes(buffer, sizeof(T));
+    }
+
+    void pushOffset(Offset offset)
+    {
+        align(4);
+        pushScalar<quint32>(size() + 4 - offset);
+    }
+
+    std::vector<char> m_buffer;
+    std::size_t m_head = 0;
+    std::size_t m_minAlign = 1;
+    Offset m_tableStart = 0;
+    std::vector<FieldLocation> m_fields;
+};
+
+// Stałe ze schematów Arrow (Schema.fbs, Message.fbs, File.fbs).
+constexpr qint16 ArrowMetadataV5 = 4;
+constexpr quint8 ArrowHeaderSchema = 1;
+constexpr quint8 ArrowHeaderRecordBatch = 3;
+constexpr quint8 ArrowTypeInt = 2;
+constexpr quint8 ArrowTypeFloatingPoint = 3;
+constexpr quint8 ArrowTypeUtf8 = 5;
+constexpr quint8 ArrowTypeTimestamp = 10;
+constexpr qint16 ArrowPrecisionDouble = 2;
+constexpr qint16 ArrowTimeUnitMillisecond = 1;
+const char ArrowMagic[] = "ARROW1";
+
+class ArrowTableWriter : public TableWriter
+{
+public:
+    explicit ArrowTableWriter(QIODevice* device) : TableWriter(device) {}
+
+protected:
+    bool writeHeader() override
+    {
+        if (!write(QByteArray(ArrowMagic, 6) + QByteArray(2, '\0'))) {
+            return false;
+        }
+        FlatBufferBuilder fbb;
+        const FlatBufferBuilder::Offset schema = buildSchema(fbb);
+        return writeMessage(finishMessage(fbb, ArrowHeaderSchema, schema, 0)) >= 0;
+    }
+
+    bool writeBatch() override
+    {
+        // Opis kolumn (długość, liczba braków) i położenie buforów w treści komunikatu
+        QByteArray nodes;
+        QByteArray buffers;
+        qint64 bodyLength = 0;
+        auto addBuffer = [&](qint64 length) {
+            appendLittleEndian<qint64>(buffers, bodyLength);
+            appendLittleEndian<qint64>(buffers, length);
+            bodyLength += align8(length);
+        };
+        for (const Column& column : m_columns) {
+            appendLittleEndian<qint64>(nodes, m_batchRows);
+            appendLittleEndian<qint64>(nodes, column.nullCount);
+            addBuffer(column.nullCount > 0 ? column.validity.size() : 0);
+            if (column.spec.type == ColumnType::Utf8) {
+                addBuffer(column.offsets.size());
+            }
+            addBuffer(column.values.size());
+        }
+
+        FlatBufferBuilder fbb;
+        const int bufferCount = buffers.size() / 16;
+        const FlatBufferBuilder::Offset nodesVector = fbb.createStructVector(nodes, static_cast<int>(m_columns.size()), 8);
+        const FlatBufferBuilder::Offset buffersVector = fbb.createStructVector(buffers, bufferCount, 8);
+        fbb.startTable();
+        fbb.addScalar<qint64>(0, m_batchRows);
+        fbb.addOffset(1, nodesVector);
+        fbb.addOffset(2, buffersVector);
+        const FlatBufferBuilder::Offset recordBatch = fbb.endTable();
+
+        Block block;
+        block.offset = bytesWritten();
+        block.metadataLength = writeMessage(finishMessage(fbb, ArrowHeaderRecordBatch, recordBatch, bodyLength));
+        block.bodyLength = bodyLength;
+        if (block.metadataLength < 0) {
+            return false;
+        }
+        for (const Column& column : m_columns) {
+            if ((column.nullCount > 0 && !writePadded(column.validity))
+                || (column.spec.type == ColumnType::Utf8 && !writePadded(column.offsets))
+                || !writePadded(column.values)) {
+                return false;
+            }
+        }
+        m_blocks.push_back(block);
+        return true;
+    }
+
+    bool writeFooter() override
+    {
+        // Znacznik końca strumienia, potem stopka pliku z położeniem partii
+        QByteArray endOfStream;
+        appendLittleEndian<quint32>(endOfStream, 0xFFFFFFFFu);
+        appendLittleEndian<qint32>(endOfStream, 0);
+        if (!write(endOfStream)) {
+            return false;
+        }
+
+        FlatBufferBuilder fbb;
+        const FlatBufferBuilder::Offset schema = buildSchema(fbb);
+        QByteArray blocks;
+        for (const Block& block : m_blocks) {
+            appendLittleEndian<qint64>(blocks, block.offset);
+            appendLittleEndian<qint32>(blocks, block.metadataLength);
+            appendLittleEndian<qint32>(blocks, 0);
+            appendLittleEndian<qint64>(blocks, block.bodyLength);
+        }
+        const FlatBufferBuilder::Offset dictionaries = fbb.createStructVector(QByteArray(), 0, 8);
+        const FlatBufferBuilder::Offset recordBatches = fbb.createStructVector(blocks, static_cast<int>(m_blocks.size()), 8);
+        fbb.startTable();
+        fbb.addScalar<qint16>(0, ArrowMetadataV5);
+        fbb.addOffset(1, schema);
+        fbb.addOffset(2, dictionaries);
+        fbb.addOffset(3, recordBatches);
+        const QByteArray footer = fbb.finish(fbb.endTable());
+
+        QByteArray trailer;
+        appendLittleEndian<qint32>(trailer, footer.size());
+        trailer.append(ArrowMagic, 6);
+        return write(footer) && write(trailer);
+    }
+
+private:
+    /// Położenie partii w pliku (struktura Block ze stopki).
+    struct Block {
+        qint64 offset = 0;
+        qint32 metadataLength = 0;
+        qint64 bodyLength = 0;
+    };
+
+    FlatBufferBuilder::Offset buildSchema(FlatBufferBuilder& fbb) const
+    {
+        std::vector<FlatBufferBuilder::Offset> fields;
+        for (const Column& column : m_columns) {
+            const FlatBufferBuilder::Offset name = fbb.createString(column.spec.name.toUtf8());
+            quint8 typeType = ArrowTypeUtf8;
+            FlatBufferBuilder::Offset type = 0;
+            switch (column.spec.type) {
+            case ColumnType::Int32:
+                typeType = ArrowTypeInt;
+                fbb.startTable();
+                fbb.addScalar<qint32>(0, 32);
+                fbb.addScalar<quint8>(1, 1);
+                type = fbb.endTable();
+                break;
+            case ColumnType::Timestamp: {
+                typeType = ArrowTypeTimestamp;
+                const FlatBufferBuilder::Offset timezone = fbb.createString("UTC");
+                fbb.startTable();
+                fbb.addScalar<qint16>(0, ArrowTimeUnitMillisecond);
+                fbb.addOffset(1, timezone);
+                type = fbb.endTable();
+                break;
+            }
+            case ColumnType::Float64:
+                typeType = ArrowTypeFloatingPoint;
+                fbb.startTable();
+                fbb.addScalar<qint16>(0, ArrowPrecisionDouble);
+                type = fbb.endTable();
+                break;
+            case ColumnType::Utf8:
+                fbb.startTable();
+                type = fbb.endTable();
+                break;
+            }
+            const FlatBufferBuilder::Offset children = fbb.createOffsetVector({});
+            fbb.startTable();
+            fbb.addOffset(0, name);
+            fbb.addScalar<quint8>(1, 1); // nullable
+            fbb.addScalar<quint8>(2, typeType);
+            fbb.addOffset(3, type);
+            fbb.addOffset(5, children);
+            fields.push_back(fbb.endTable());
+        }
+        const FlatBufferBuilder::Offset fieldsVector = fbb.createOffsetVector(fields);
+        fbb.startTable();
+        fbb.addScalar<qint16>(0, 0); // little-endian
+        fbb.addOffset(1, fieldsVector);
+        return fbb.endTable();
+    }
+
+    static QByteArray finishMessage(FlatBufferBuilder& fbb, quint8 headerType, FlatBufferBuilder::Offset header,
+                                    qint64 bodyLength)
+    {
+        fbb.startTable();
+        fbb.addScalar<qint16>(0, ArrowMetadataV5);
+        fbb.addScalar<quint8>(1, headerType);
+        fbb.addOffset(2, header);
+        fbb.addScalar<qint64>(3, bodyLength);
+        return fbb.finish(fbb.endTable());
+    }
+
+    /// Zapisuje metadane komunikatu z prefiksem i wyrównaniem; zwraca ich długość z prefiksem (-1 przy błędzie).
+    qint32 writeMessage(const QByteArray& metadata)
+    {
+        const qint32 paddedLength = static_cast<qint32>(align8(metadata.size()));
+        QByteArray prefix;
+        appendLittleEndian<quint32>(prefix, 0xFFFFFFFFu);
+        appendLittleEndian<qint32>(prefix, paddedLength);
+        if (!write(prefix) || !writePadded(metadata)) {
+            return -1;
+        }
+        return 8 + paddedLength;
+    }
+
+    bool writePadded(const QByteArray& bytes)
+    {
+        static const char zeros[8] = {};
+        return write(bytes) && write(zeros, align8(bytes.size()) - bytes.size());
+    }
+
+    std::vector<Block> m_blocks; ///< Zapisane partie (do stopki pliku).
+};
+
+} // namespace
+
+std::unique_ptr<TableWriter> TableWriter::create(ExportFormat format, QIODevice* device)
+{
+    if (format == ExportFormat::ArrowIpc) {
+        return std::make_unique<ArrowTableWriter>(device);
+    }
+    return std::make_unique<CsvTableWriter>(device);
+}
+
+TableWriter::TableWriter(QIODevice* device) : m_device(device)
+{
+}
+
+TableWriter::~TableWriter() = default;
+
+bool TableWriter::begin(const std::vector<ColumnSpec>& columns)
+{
+    m_columns.clear();
+    for (const ColumnSpec& spec : columns) {
+        Column column;
+        column.spec = spec;
+        if (spec.type == ColumnType::Utf8) {
+            appendLittleEndian<qint32>(column.offsets, 0);
+        }
+        m_columns.push_back(column);
+    }
+    return !m_failed && writeHeader();
+}
+
+void TableWriter::setInt32(int column, qint32 value)
+{
+    appendLittleEndian<qint32>(prepareValue(column), value);
+}
+
+void TableWriter::setTimestamp(int column, qint64 msecsSinceEpoch)
+{
+    appendLittleEndian<qint64>(prepareValue(column), msecsSinceEpoch);
+}
+
+void TableWriter::setFloat64(int column, double value)
+{
+    if (std::isnan(value)) {
+        return; // brak pomiaru
+    }
+    appendLittleEndian<quint64>(prepareValue(column), doubleBits(value));
+}
+
+void TableWriter::setUtf8(int column, const QByteArray& utf8)
+{
+    prepareValue(column).append(utf8);
+}
+
+QByteArray& TableWriter::prepareValue(int column)
+{
+    Column& target = m_columns[static_cast<std::size_t>(column)];
+    if (target.isSet) {
+        // Ponowne ustawienie w tym samym wierszu zastępuje poprzednią wartość
+        const int start = target.spec.type == ColumnType::Utf8
+            ? qFromLittleEndian<qint32>(target.offsets.constData() + m_batchRows * 4)
+            : m_batchRows * valueWidth(target.spec.type);
+        target.values.resize(start);
+    }
+    target.isSet = true;
+    return target.values;
+}
+
+bool TableWriter::endRow()
+{
+    if (m_failed) {
+        return false;
+    }
+    for (Column& column : m_columns) {
+        if (m_batchRows % 8 == 0) {
+            column.validity.append('\0');
+        }
+        if (column.isSet) {
+            column.validity[column.validity.size() - 1] = static_cast<char>(
+                column.validity[column.validity.size() - 1] | (1 << (m_batchRows % 8)));
+        } else {
+            column.values.append(valueWidth(column.spec.type), '\0');
+            column.nullCount++;
+        }
+        if (column.spec.type == ColumnType::Utf8) {
+            appendLittleEndian<qint32>(column.offsets, column.values.size());
+        }
+        column.isSet = false;
+    }
+    m_batchRows++;
+    m_rowCount++;
+    return m_batchRows < BatchRows || flushBatch();
+}
+
+bool TableWriter::finish()
+{
+    return flushBatch() && writeFooter();
+}
+
+quint64 TableWriter::rowCount() const
+{
+    return m_rowCount;
+}
+
+qint64 TableWriter::bytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+bool TableWriter::flushBatch()
+{
+    if (m_failed) {
+        return false;
+    }
+    const bool ok = m_batchRows == 0 || writeBatch();
+    for (Column& column : m_columns) {
+        // resize(0) zostawia zaalokowaną pamięć do ponownego użycia w kolejnej partii
+        column.values.resize(0);
+        column.validity.resize(0);
+        column.nullCount = 0;
+        if (column.spec.type == ColumnType::Utf8) {
+            column.offsets.resize(0);
+            appendLittleEndian<qint32>(column.offsets, 0);
+        }
+    }
+    m_batchRows = 0;
+    return ok;
+}
+
+bool TableWriter::write(const char* data, qint64 size)
+{
+    if (m_failed) {
+        return false;
+    }
+    if (size > 0 && m_device->write(data, size) != size) {
+        qWarning() << "Export write failed:" << m_device->errorString();
+        m_failed = true;
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+bool TableWriter::isValid(const Column& column, int row) const
+{
+    return (static_cast<quint8>(column.validity[row / 8]) >> (row % 8)) & 1;
+}
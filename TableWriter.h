@@ -0,0 +1,132 @@
+/**
+ * @file TableWriter.h
+ * @brief Definicja klasy TableWriter - strumieniowego zapisu tabel do plików CSV i Apache Arrow IPC.
+ */
+#ifndef TABLEWRITER_H
+#define TABLEWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QIODevice;
+
+/**
+ * @enum ExportFormat
+ * @brief Format pliku eksportu.
+ */
+enum class ExportFormat {
+    Csv,     ///< Tekst CSV z nagłówkiem (cudzysłowy jak w RFC 4180, koniec linii "\n"); daty w ISO 8601 UTC, brak wartości jako puste pole.
+    ArrowIpc ///< Plik Apache Arrow IPC (".arrow", format pliku wersji V5), czytelny np. dla pyarrow i pandas.
+};
+
+/**
+ * @enum ColumnType
+ * @brief Typ kolumny tabeli.
+ */
+enum class ColumnType {
+    Int32,     ///< Liczba całkowita 32-bitowa.
+    Timestamp, ///< Data w milisekundach od epoki (w Arrow: timestamp[ms, UTC]).
+    Float64,   ///< Liczba zmiennoprzecinkowa.
+    Utf8       ///< Tekst UTF-8.
+};
+
+/**
+ * @struct ColumnSpec
+ * @brief Nazwa i typ kolumny.
+ */
+struct ColumnSpec {
+    QString name;                          ///< Nazwa kolumny.
+    ColumnType type = ColumnType::Float64; ///< Typ kolumny.
+};
+
+/**
+ * @class TableWriter
+ * @brief Zapisuje tabelę wiersz po wierszu do urządzenia (np. QSaveFile) w stałej pamięci.
+ *
+ * Wiersze są zbierane kolumnowo w partiach po BatchRows wierszy; pełna partia jest zapisywana (CSV - jako tekst,
+ * Arrow - jako jeden RecordBatch) i bufory są używane ponownie, więc zużycie pamięci nie zależy od liczby wierszy.
+ * Wartości są kopiowane do buforów bajtowych - zapis wiersza nie tworzy obiektów QString.
+ *
+ * Użycie: begin(), dla każdego wiersza wywołania set*() (pominięta kolumna to brak wartości) i endRow(), na końcu
+ * finish(). Błąd zapisu jest logowany i zwracany jako `false`; kolejne wywołania również zwracają `false`.
+ */
+class TableWriter
+{
+public:
+    /// Liczba wierszy w partii.
+    static constexpr int BatchRows = 65536;
+
+    /**
+     * @brief Tworzy obiekt zapisujący w danym formacie.
+     * @param device Otwarte do zapisu urządzenie (nie przejmuje własności).
+     */
+    static std::unique_ptr<TableWriter> create(ExportFormat format, QIODevice* device);
+
+    virtual ~TableWriter();
+
+    TableWriter(const TableWriter&) = delete;
+    TableWriter& operator=(const TableWriter&) = delete;
+
+    /** @brief Zapisuje nagłówek (CSV) lub schemat (Arrow). */
+    bool begin(const std::vector<ColumnSpec>& columns);
+
+    void setInt32(int column, qint32 value);               ///< Ustawia wartość kolumny typu Int32 w bieżącym wierszu.
+    void setTimestamp(int column, qint64 msecsSinceEpoch); ///< Ustawia wartość kolumny typu Timestamp.
+    void setFloat64(int column, double value);             ///< Ustawia wartość kolumny typu Float64 (NaN to brak wartości).
+    void setUtf8(int column, const QByteArray& utf8);      ///< Ustawia wartość kolumny typu Utf8 (bajty UTF-8).
+
+    /** @brief Kończy bieżący wiersz; zapisuje partię, gdy jest pełna. */
+    bool endRow();
+    /** @brief Zapisuje ostatnią partię i zakończenie pliku. */
+    bool finish();
+
+    /** @brief Liczba zakończonych wierszy. */
+    quint64 rowCount() const;
+    /** @brief Liczba bajtów zapisanych do urządzenia. */
+    qint64 bytesWritten() const;
+
+protected:
+    /// Bufory jednej kolumny dla bieżącej partii (format kolumn Arrow).
+    struct Column {
+        ColumnSpec spec;
+        QByteArray values;   ///< Wartości stałej szerokości (little-endian) albo bajty tekstów (Utf8).
+        QByteArray offsets;  ///< Utf8: początki tekstów (qint32, o jeden więcej niż wierszy).
+        QByteArray validity; ///< Mapa bitowa obecności wartości (bit ustawiony = wartość obecna).
+        qint64 nullCount = 0;
+        bool isSet = false;  ///< Czy wartość w bieżącym wierszu została ustawiona.
+    };
+
+    explicit TableWriter(QIODevice* device);
+
+    /// Zapisuje nagłówek lub schemat.
+    virtual bool writeHeader() = 0;
+    /// Zapisuje zebraną partię (m_batchRows > 0).
+    virtual bool writeBatch() = 0;
+    /// Zapisuje zakończenie pliku.
+    virtual bool writeFooter() = 0;
+
+    /// Zapisuje bajty do urządzenia; błąd jest logowany.
+    bool write(const char* data, qint64 size);
+    bool write(const QByteArray& bytes) { return write(bytes.constData(), bytes.size()); }
+
+    /// Czy wartość wiersza `row` bieżącej partii jest obecna.
+    bool isValid(const Column& column, int row) const;
+
+    std::vector<Column> m_columns; ///< Kolumny z buforami bieżącej partii.
+    int m_batchRows = 0;           ///< Liczba wierszy w bieżącej partii.
+
+private:
+    /// Oznacza wartość kolumny w bieżącym wierszu jako ustawioną i zwraca bufor, do którego należy ją dopisać.
+    QByteArray& prepareValue(int column);
+    /// Zapisuje partię i czyści bufory (z zachowaniem zaalokowanej pamięci).
+    bool flushBatch();
+
+    QIODevice* m_device;       ///< Urządzenie docelowe (nie jest własnością obiektu).
+    quint64 m_rowCount = 0;    ///< Liczba zakończonych wierszy.
+    qint64 m_bytesWritten = 0; ///< Liczba zapisanych bajtów.
+    bool m_failed = false;     ///< Czy wystąpił błąd zapisu.
+};
+
+#endif // TABLEWRITER_H
@@ -0,0 +1,300 @@
+#include "TestAlertEngine.h"
+
+QDateTime TestAlertEngine::hour(int index) {
+    return QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate).addSecs(static_cast<qint64>(index) * 3600);
+}
+
+SensorData TestAlertEngine::constantHours(const QString& key, int firstHour, int count, double value) {
+    SensorData data;
+    data.key = key;
+    for (int i = firstHour + count - 1; i >= firstHour; --i) { // od najnowszych, jak w API GIOS
+        data.values.push_back({hour(i), value});
+    }
+    return data;
+}
+
+AlertRule TestAlertEngine::pm10DailyRule() {
+    AlertRule rule;
+    rule.name = "PM10 24h";
+    rule.paramCode = "PM10";
+    rule.windowHours = 24;
+    rule.threshold = 50.0;
+    rule.clearThreshold = 45.0;
+    return rule;
+}
+
+// Testy dla AlertEngine
+
+void TestAlertEngine::addSensorData_RollingMeanWithHysteresis() {
+    AlertEngine engine;
+    const int ruleId = engine.addRule(pm10DailyRule());
+    QVERIFY(ruleId > 0);
+
+    QVERIFY(engine.addSensorData(1, constantHours("PM10", 0, 24, 40.0)).empty());
+
+    // Średnia 24 h przekracza 50 po 4 godzinach z wartością 100: (20·40 + 4·100) / 24 = 50 (jeszcze nie), po 5 - 52.5
+    std::vector<AlertEvent> events = engine.addSensorData(1, constantHours("PM10", 24, 12, 100.0));
+    QCOMPARE(events.size(), std::size_t(1));
+    QVERIFY(events[0].raised);
+    QCOMPARE(events[0].ruleId, ruleId);
+    QCOMPARE(events[0].sensorId, 1);
+    QCOMPARE(events[0].date, hour(28));
+    QCOMPARE(events[0].value, 52.5);
+    QCOMPARE(engine.activeAlertCount(), 1);
+
+    // Spadek średniej między 45 a 50 nie wyłącza alertu (histereza); wyłącza go dopiero spadek poniżej 45
+    events = engine.addSensorData(1, constantHours("PM10", 36, 48, 10.0));
+    QCOMPARE(events.size(), std::size_t(1));
+    QVERIFY(!events[0].raised);
+    QVERIFY(events[0].value < 45.0);
+    QCOMPARE(engine.activeAlertCount(), 0);
+}
+
+void TestAlertEngine::addSensorData_OnlyNewMeasurementsEvaluated() {
+    AlertRule rule;
+    rule.name = "PM10 powyżej 100";
+    rule.paramCode = "PM10";
+    rule.threshold = 100.0;
+    AlertEngine engine;
+    engine.addRule(rule);
+
+    QCOMPARE(engine.addSensorData(1, constantHours("PM10", 0, 10, 150.0)).size(), std::size_t(1));
+    // Ponownie te same dane (np. odświeżenie z cache) - brak nowych pomiarów
+    QVERIFY(engine.addSensorData(1, constantHours("PM10", 0, 10, 10.0)).empty());
+    QCOMPARE(engine.activeAlertCount(), 1);
+
+    // Okno zachodzące na poprzednie - oceniane są tylko godziny 10-14
+    std::vector<AlertEvent> events = engine.addSensorData(1, constantHours("PM10", 5, 10, 10.0));
+    QCOMPARE(events.size(), std::size_t(1));
+    QVERIFY(!events[0].raised);
+    QCOMPARE(events[0].date, hour(10));
+}
+
+void TestAlertEngine::addSensorData_LongHistoryScansOnlyNewPoints() {
+    AlertEngine engine;
+    QVERIFY(engine.addRule(pm10DailyRule()) > 0);
+
+    // Rok historii w kolejności rosnącej, jak seria scalona w DataStorage
+    const int historyHours = 365 * 24;
+    SensorData merged;
+    merged.key = "PM10";
+    for (int i = 0; i < historyHours; ++i) {
+        merged.values.push_back({hour(i), 20.0});
+    }
+    QVERIFY(engine.addSensorData(1, merged).empty());
+    QCOMPARE(engine.lastScannedCount(), std::size_t(historyHours));
+
+    // Kolejne odświeżenia dopisują po jednym pomiarze - przeglądany jest tylko nowy i pierwszy już oceniony
+    std::vector<AlertEvent> events;
+    for (int i = historyHours; i < historyHours + 12 && events.empty(); ++i) {
+        merged.values.push_back({hour(i), 200.0});
+        events = engine.addSensorData(1, merged);
+        QCOMPARE(engine.lastScannedCount(), std::size_t(2));
+    }
+    QCOMPARE(events.size(), std::size_t(1)); // (19·20 + 5·200) / 24 > 50
+    QVERIFY(events[0].raised);
+    QCOMPARE(events[0].date, hour(historyHours + 4));
+
+    // Odpowiedź API (malejąco) z jednym nowym pomiarem
+    engine.addSensorData(1, constantHours("PM10", historyHours + 5, 72, 200.0));
+    QCOMPARE(engine.lastScannedCount(), std::size_t(72));
+    QVERIFY(engine.addSensorData(1, constantHours("PM10", historyHours + 6, 72, 200.0)).empty());
+    QCOMPARE(engine.lastScannedCount(), std::size_t(2));
+}
+
+void TestAlertEngine::addSensorData_RequiresWindowCoverage() {
+    AlertEngine engine;
+    engine.addRule(pm10DailyRule());
+
+    // 17 z 24 godzin to mniej niż 75% - średnia nie jest oceniana
+    QVERIFY(engine.addSensorData(1, constantHours("PM10", 0, 17, 200.0)).empty());
+    QCOMPARE(engine.addSensorData(1, constantHours("PM10", 17, 1, 200.0)).size(), std::size_t(1));
+}
+
+void TestAlertEngine::addSensorData_RulesMatchParameterAndSensor() {
+    AlertRule rule;
+    rule.name = "NO2 czujnika 7";
+    rule.paramCode = "no2";
+    rule.sensorId = 7;
+    rule.threshold = 200.0;
+    AlertEngine engine;
+    engine.addRule(rule);
+    engine.addRule(pm10DailyRule());
+
+    QVERIFY(engine.addSensorData(1, constantHours("NO2", 0, 5, 500.0)).empty());   // inny czujnik
+    QVERIFY(engine.addSensorData(7, constantHours("PM2.5", 0, 5, 500.0)).empty()); // inny parametr
+
+    std::vector<AlertEvent> events = engine.addSensorData(8, constantHours("NO2", 0, 5, 500.0));
+    QVERIFY(events.empty());
+
+    Sensor sensor;
+    sensor.id = 9;
+    sensor.stationId = 3;
+    sensor.param.paramCode = "NO2";
+    engine.setSensors({sensor});
+    QVERIFY(engine.addSensorData(9, constantHours("", 0, 5, 500.0)).empty()); // reguła dotyczy tylko czujnika 7
+
+    sensor.id = 7;
+    engine.setSensors({sensor});
+    events = engine.addSensorData(7, constantHours("", 5, 5, 500.0)); // parametr i stacja z metadanych czujnika
+    QCOMPARE(events.size(), std::size_t(1));
+    QCOMPARE(events[0].stationId, 3);
+}
+
+void TestAlertEngine::addSensorData_ProvincePredicate() {
+    AlertRule rule = pm10DailyRule();
+    rule.windowHours = 0;
+    rule.provinceName = "mazowieckie";
+    AlertEngine engine;
+    engine.addRule(rule);
+
+    MeasuringStation warsaw;
+    warsaw.id = 10;
+    warsaw.city.commune.provinceName = "MAZOWIECKIE";
+    MeasuringStation cracow;
+    cracow.id = 20;
+    cracow.city.commune.provinceName = "MAŁOPOLSKIE";
+    engine.setStations({warsaw, cracow});
+
+    Sensor inWarsaw;
+    inWarsaw.id = 1;
+    inWarsaw.stationId = 10;
+    inWarsaw.param.paramCode = "PM10";
+    Sensor inCracow = inWarsaw;
+    inCracow.id = 2;
+    inCracow.stationId = 20;
+    engine.setSensors({inWarsaw, inCracow});
+
+    QCOMPARE(engine.addSensorData(1, constantHours("PM10", 0, 3, 80.0)).size(), std::size_t(1));
+    QVERIFY(engine.addSensorData(2, constantHours("PM10", 0, 3, 80.0)).empty());
+    QVERIFY(engine.addSensorData(3, constantHours("PM10", 0, 3, 80.0)).empty()); // stacja nieznana
+}
+
+void TestAlertEngine::addAirQualityIndex_LevelAtLeast() {
+    AlertRule rule;
+    rule.name = "AQI co najmniej 4 (mazowieckie)";
+    rule.source = AlertSource::AirQualityIndex;
+    rule.comparison = AlertComparison::GreaterOrEqual;
+    rule.threshold = 4.0;
+    rule.provinceName = "mazowieckie";
+    AlertRule pm25 = rule;
+    pm25.name = "AQI PM2.5 co najmniej 3";
+    pm25.paramCode = "PM2.5";
+    pm25.threshold = 3.0;
+    pm25.provinceName.clear();
+    AlertEngine engine;
+    const int overallId = engine.addRule(rule);
+    const int pm25Id = engine.addRule(pm25);
+
+    MeasuringStation station;
+    station.id = 10;
+    station.city.commune.provinceName = "mazowieckie";
+    engine.setStations({station});
+
+    AirQualityIndex index;
+    index.stationId = 10;
+    index.stCalcDate = hour(1);
+    index.stIndexLevel = 4;
+    index.setLevel(Pollutant::PM25, 2);
+    std::vector<AlertEvent> events = engine.addAirQualityIndex(index);
+    QCOMPARE(events.size(), std::size_t(1));
+    QCOMPARE(events[0].ruleId, overallId);
+    QCOMPARE(events[0].value, 4.0);
+
+    QVERIFY(engine.addAirQualityIndex(index).empty()); // ten sam indeks - bez oceny
+
+    index.stCalcDate = hour(2);
+    index.stIndexLevel = 3;
+    index.setLevel(Pollutant::PM25, 3);
+    events = engine.addAirQualityIndex(index);
+    QCOMPARE(events.size(), std::size_t(2));
+    QVERIFY(!events[0].raised);
+    QCOMPARE(events[0].ruleId, overallId);
+    QVERIFY(events[1].raised);
+    QCOMPARE(events[1].ruleId, pm25Id);
+
+    index.stationId = 20; // inne województwo (nieznane) - tylko reguła bez predykatu województwa
+    index.stIndexLevel = 5;
+    events = engine.addAirQualityIndex(index);
+    QCOMPARE(events.size(), std::size_t(1));
+    QCOMPARE(events[0].ruleId, pm25Id);
+}
+
+void TestAlertEngine::addRule_ValidatesAndRemoves() {
+    AlertEngine engine;
+    AlertRule noParam;
+    noParam.threshold = 10.0;
+    QCOMPARE(engine.addRule(noParam), -1);
+
+    AlertRule rule = pm10DailyRule();
+    rule.id = 5;
+    QCOMPARE(engine.addRule(rule), 5);
+    QCOMPARE(engine.addRule(rule), -1); // ID zajęte
+    rule.id = -1;
+    QCOMPARE(engine.addRule(rule), 6);
+    QCOMPARE(engine.rules().size(), std::size_t(2));
+
+    rule.windowHours = 0;
+    rule.id = 7;
+    engine.addRule(rule);
+    QCOMPARE(engine.addSensorData(1, constantHours("PM10", 0, 1, 80.0)).size(), std::size_t(1));
+    QCOMPARE(engine.activeAlertCount(), 1);
+
+    QVERIFY(engine.removeRule(7));
+    QVERIFY(!engine.removeRule(7));
+    QCOMPARE(engine.activeAlertCount(), 0);
+    QCOMPARE(engine.rules().size(), std::size_t(2));
+}
+
+void TestAlertEngine::addRule_RejectsClearThresholdAboveThreshold() {
+    AlertEngine engine;
+    AlertRule rule = pm10DailyRule();
+    rule.clearThreshold = 55.0;
+    QCOMPARE(engine.addRule(rule), -1);
+
+    AlertRule valid = pm10DailyRule();
+    valid.clearThreshold = 50.0; // równy progowi - dozwolony
+    engine.setRules({rule, valid});
+    QCOMPARE(engine.rules().size(), std::size_t(1));
+    QCOMPARE(engine.rules()[0].clearThreshold, 50.0);
+}
+
+void TestAlertEngine::restoreProgress_SkipsReportedEvents() {
+    AlertRule rule;
+    rule.name = "PM10 powyżej 100";
+    rule.paramCode = "PM10";
+    rule.threshold = 100.0;
+    AlertEngine engine;
+    engine.addRule(rule);
+
+    SensorData data = constantHours("PM10", 0, 10, 150.0);
+    QCOMPARE(engine.addSensorData(1, data).size(), std::size_t(1));
+    AirQualityIndex index;
+    index.stationId = 7;
+    index.stCalcDate = hour(9);
+    index.stIndexLevel = 5;
+    AlertRule aqiRule = AlertEngine::defaultRules()[2];
+    engine.addRule(aqiRule);
+    QCOMPARE(engine.addAirQualityIndex(index).size(), std::size_t(1));
+    const AlertProgress progress = engine.progress();
+    QCOMPARE(progress.sensors.value(1), hour(9).toMSecsSinceEpoch());
+    QCOMPARE(progress.stations.value(7), hour(9).toMSecsSinceEpoch());
+
+    // Po ponownym uruchomieniu te same dane odtwarzają stan alertów bez ponownego zgłaszania zdarzeń
+    AlertEngine restarted;
+    restarted.setRules(engine.rules());
+    restarted.restoreProgress(progress);
+    QVERIFY(restarted.addSensorData(1, data).empty());
+    QVERIFY(restarted.addAirQualityIndex(index).empty());
+    QCOMPARE(restarted.activeAlertCount(), 2);
+
+    // Nowe pomiary są zgłaszane jak zwykle
+    std::vector<AlertEvent> events = restarted.addSensorData(1, constantHours("PM10", 10, 2, 20.0));
+    QCOMPARE(events.size(), std::size_t(1));
+    QVERIFY(!events[0].raised);
+    QCOMPARE(events[0].date, hour(10));
+
+    // Ponowne ustawienie reguł nie powtarza zdarzeń dla już ocenionych danych
+    restarted.setRules(restarted.rules());
+    QVERIFY(restarted.addSensorData(1, constantHours("PM10", 0, 12, 150.0)).empty());
+}
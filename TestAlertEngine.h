@@ -0,0 +1,31 @@
+#ifndef TESTALERTENGINE_H
+#define TESTALERTENGINE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "AlertEngine.h"
+#include "DataStructures.h"
+
+class TestAlertEngine : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDateTime hour(int index);
+    SensorData constantHours(const QString& key, int firstHour, int count, double value);
+    AlertRule pm10DailyRule();
+
+private slots:
+    void addSensorData_RollingMeanWithHysteresis();
+    void addSensorData_OnlyNewMeasurementsEvaluated();
+    void addSensorData_LongHistoryScansOnlyNewPoints();
+    void addSensorData_RequiresWindowCoverage();
+    void addSensorData_RulesMatchParameterAndSensor();
+    void addSensorData_ProvincePredicate();
+    void addAirQualityIndex_LevelAtLeast();
+    void addRule_ValidatesAndRemoves();
+    void addRule_RejectsClearThresholdAboveThreshold();
+    void restoreProgress_SkipsReportedEvents();
+};
+
+#endif
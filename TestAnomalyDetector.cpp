@@ -0,0 +1,153 @@
+#include "TestAnomalyDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <vector>
+
+QDateTime TestAnomalyDetector::hour(int index) {
+    return QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate).addSecs(static_cast<qint64>(index) * 3600);
+}
+
+// Testy dla AnomalyDetector
+
+void TestAnomalyDetector::add_DetectsSpike() {
+    AnomalyDetector detector;
+    for (int i = 0; i < 30; ++i) {
+        QVERIFY(!detector.add({hour(i), 19.0 + i % 3}).has_value());
+    }
+
+    std::optional<Anomaly> spike = detector.add({hour(30), 200.0}); // ok. 10x tła
+    QVERIFY(spike.has_value());
+    QVERIFY(spike->type == AnomalyType::Spike);
+    QCOMPARE(spike->date, hour(30));
+    QVERIFY(spike->score > 6.0);
+
+    // Umiarkowany wzrost nie jest pikiem; sam pik nie przesuwa mediany okna
+    QVERIFY(!detector.add({hour(31), 25.0}).has_value());
+}
+
+void TestAnomalyDetector::add_SmoothSeriesHasNoAnomalies() {
+    AnomalyDetector detector;
+    for (int i = 0; i < 500; ++i) {
+        QVERIFY(!detector.add({hour(i), 20.0 + 10.0 * std::sin(i / 4.0)}).has_value());
+    }
+}
+
+void TestAnomalyDetector::add_NoSpikeCheckBeforeMinHistory() {
+    AnomalyDetectorOptions options;
+    options.minHistory = 8;
+    AnomalyDetector detector(options);
+    for (int i = 0; i < 7; ++i) {
+        QVERIFY(!detector.add({hour(i), 10.0 + i}).has_value());
+    }
+    QVERIFY(!detector.add({hour(7), 500.0}).has_value()); // w oknie dopiero 7 pomiarów
+}
+
+void TestAnomalyDetector::add_DetectsFlatline() {
+    AnomalyDetector detector;
+    for (int i = 0; i < 10; ++i) {
+        detector.add({hour(i), 10.0 + i});
+    }
+    for (int k = 1; k <= 5; ++k) {
+        QVERIFY(!detector.add({hour(10 + k), 15.5}).has_value());
+    }
+
+    std::optional<Anomaly> flat = detector.add({hour(16), 15.5}); // szósta identyczna wartość
+    QVERIFY(flat.has_value());
+    QVERIFY(flat->type == AnomalyType::Flatline);
+    QCOMPARE(flat->score, 6.0);
+}
+
+void TestAnomalyDetector::add_FlatlineReportedOncePerRun() {
+    AnomalyDetector detector;
+    int flatlines = 0;
+    for (int i = 0; i < 20; ++i) { // jedna długa seria powtórzeń
+        std::optional<Anomaly> anomaly = detector.add({hour(i), 12.0});
+        flatlines += anomaly && anomaly->type == AnomalyType::Flatline;
+    }
+    QCOMPARE(flatlines, 1);
+
+    // Inna wartość kończy serię; kolejna seria jest zgłaszana ponownie
+    QVERIFY(!detector.add({hour(20), 13.0}).has_value());
+    for (int i = 21; i < 40; ++i) {
+        std::optional<Anomaly> anomaly = detector.add({hour(i), 12.0});
+        flatlines += anomaly && anomaly->type == AnomalyType::Flatline;
+    }
+    QCOMPARE(flatlines, 2);
+}
+
+void TestAnomalyDetector::add_NegativeValueOutOfRange() {
+    AnomalyDetector detector;
+    std::optional<Anomaly> negative = detector.add({hour(0), -3.0});
+    QVERIFY(negative.has_value());
+    QVERIFY(negative->type == AnomalyType::OutOfRange);
+
+    AnomalyDetectorOptions options;
+    options.maxValue = 1000.0;
+    AnomalyDetector bounded(options);
+    QVERIFY(bounded.add({hour(0), 1500.0})->type == AnomalyType::OutOfRange);
+    QVERIFY(!bounded.add({hour(1), 999.0}).has_value());
+}
+
+void TestAnomalyDetector::add_OutOfRangeBreaksRepeatRun() {
+    AnomalyDetector detector;
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(!detector.add({hour(i), 15.5}).has_value());
+    }
+    // Każda wartość spoza zakresu jest zgłaszana i przerywa serię powtórzeń
+    QVERIFY(detector.add({hour(5), -1.0})->type == AnomalyType::OutOfRange);
+    QVERIFY(detector.add({hour(6), -1.0})->type == AnomalyType::OutOfRange);
+    for (int i = 7; i < 12; ++i) {
+        QVERIFY(!detector.add({hour(i), 15.5}).has_value());
+    }
+    std::optional<Anomaly> flat = detector.add({hour(12), 15.5}); // szósta wartość nowej serii
+    QVERIFY(flat.has_value());
+    QVERIFY(flat->type == AnomalyType::Flatline);
+}
+
+void TestAnomalyDetector::add_SpikeScoreMatchesSortedWindow() {
+    AnomalyDetectorOptions options;
+    options.windowSize = 15;
+    options.zThreshold = 0.0; // każdy pomiar po minHistory jest zgłaszany z odpornym z-score
+    options.minScale = 0.0;
+    options.flatlineLength = 1000;
+    AnomalyDetector detector(options);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> distribution(0, 40);
+    std::deque<double> window;
+
+    for (int i = 0; i < 400; ++i) {
+        const double value = distribution(random) / 2.0; // powtarzające się wartości
+        std::optional<Anomaly> anomaly = detector.add({hour(i), value});
+        if (static_cast<int>(window.size()) >= options.minHistory) {
+            std::vector<double> sorted(window.begin(), window.end());
+            std::sort(sorted.begin(), sorted.end());
+            auto median = [](const std::vector<double>& v) {
+                return v.size() % 2 ? v[v.size() / 2] : 0.5 * (v[v.size() / 2 - 1] + v[v.size() / 2]);
+            };
+            const double m = median(sorted);
+            std::vector<double> deviations;
+            for (double v : sorted) {
+                deviations.push_back(std::abs(v - m));
+            }
+            std::sort(deviations.begin(), deviations.end());
+            const double scale = 1.4826 * median(deviations);
+            if (scale > 0.0 && value != m) {
+                QVERIFY(anomaly.has_value());
+                QVERIFY(std::abs(anomaly->score - (value - m) / scale) < 1e-9);
+            }
+        }
+        window.push_back(value);
+        if (static_cast<int>(window.size()) > options.windowSize) {
+            window.pop_front();
+        }
+    }
+}
+
+void TestAnomalyDetector::add_IgnoresNaN() {
+    AnomalyDetector detector;
+    QVERIFY(!detector.add({hour(0), std::numeric_limits<double>::quiet_NaN()}).has_value());
+    QVERIFY(!detector.add({QDateTime(), 5.0}).has_value());
+}
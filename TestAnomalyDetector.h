@@ -0,0 +1,28 @@
+#ifndef TESTANOMALYDETECTOR_H
+#define TESTANOMALYDETECTOR_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "AnomalyDetector.h"
+#include "DataStructures.h"
+
+class TestAnomalyDetector : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDateTime hour(int index);
+
+private slots:
+    void add_DetectsSpike();
+    void add_SmoothSeriesHasNoAnomalies();
+    void add_NoSpikeCheckBeforeMinHistory();
+    void add_DetectsFlatline();
+    void add_FlatlineReportedOncePerRun();
+    void add_NegativeValueOutOfRange();
+    void add_OutOfRangeBreaksRepeatRun();
+    void add_SpikeScoreMatchesSortedWindow();
+    void add_IgnoresNaN();
+};
+
+#endif
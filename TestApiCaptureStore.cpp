@@ -0,0 +1,115 @@
+#include "TestApiCaptureStore.h"
+#include "ArchiveImporter.h"
+#include <QDir>
+#include <QFile>
+
+namespace {
+
+ApiResponse makeResponse(int status, const QString& reason, const QByteArray& body) {
+    ApiResponse response;
+    response.httpStatus = status;
+    response.reasonPhrase = reason;
+    response.body = body;
+    response.headers.append(qMakePair(QByteArray("Content-Type"), QByteArray("application/json")));
+    return response;
+}
+
+} // namespace
+
+void TestApiCaptureStore::initTestCase() {
+    QVERIFY(tempDir.isValid());
+}
+
+// Testy dla ApiCaptureStore
+
+void TestApiCaptureStore::save_ReplaysResponsesInOrder() {
+    const QString dir = tempDir.path() + "/order";
+    ApiCaptureStore store(dir);
+    QVERIFY(store.save("/data/getData/1001", makeResponse(200, "OK", R"({"key": "PM10", "values": []})")));
+    QVERIFY(store.save("/data/getData/1001", makeResponse(200, "OK", R"({"key": "PM10", "values": [1]})")));
+    QVERIFY(!store.save("/data/getData/1001", ApiResponse())); // brak odpowiedzi serwera
+    QCOMPARE(store.count("/data/getData/1001"), 2);
+    QVERIFY(QFile::exists(dir + "/data/getData/1001_000001.json"));
+    QVERIFY(QFile::exists(dir + "/data/getData/1001_000001.headers"));
+    // Zapis ma układ rozpoznawany przez import archiwum
+    int id = -1;
+    QCOMPARE(ArchiveImporter::captureKind(dir + "/data/getData/1001_000002.json", &id),
+             ArchiveImporter::CaptureKind::Measurements);
+    QCOMPARE(id, 1001);
+
+    ApiCaptureStore replay(dir);
+    const std::optional<ApiResponse> first = replay.next("/data/getData/1001");
+    QVERIFY(first.has_value());
+    QVERIFY(first->isSuccess());
+    QCOMPARE(first->httpStatus, 200);
+    QCOMPARE(first->reasonPhrase, QString("OK"));
+    QCOMPARE(first->body, QByteArray(R"({"key": "PM10", "values": []})"));
+    QCOMPARE(first->headers.size(), 1);
+    QCOMPARE(first->headers.first().first, QByteArray("Content-Type"));
+    QCOMPARE(first->headers.first().second, QByteArray("application/json"));
+
+    const std::optional<ApiResponse> second = replay.next("/data/getData/1001");
+    QVERIFY(second.has_value());
+    QCOMPARE(second->body, QByteArray(R"({"key": "PM10", "values": [1]})"));
+    // Po ostatniej odpowiedzi zwracana jest ponownie ostatnia
+    const std::optional<ApiResponse> third = replay.next("/data/getData/1001");
+    QVERIFY(third.has_value());
+    QCOMPARE(third->body, second->body);
+
+    QVERIFY(!replay.next("/data/getData/1002").has_value());
+}
+
+void TestApiCaptureStore::save_ContinuesSequenceInExistingDirectory() {
+    const QString dir = tempDir.path() + "/sequence";
+    {
+        ApiCaptureStore store(dir);
+        QVERIFY(store.save("/station/findAll", makeResponse(200, "OK", "[1]")));
+    }
+    ApiCaptureStore store(dir);
+    QVERIFY(store.save("/station/findAll", makeResponse(200, "OK", "[2]")));
+    QVERIFY(QFile::exists(dir + "/station/findAll_000002.json"));
+    QCOMPARE(store.count("/station/findAll"), 2);
+    QCOMPARE(store.next("/station/findAll")->body, QByteArray("[1]"));
+    QCOMPARE(store.next("/station/findAll")->body, QByteArray("[2]"));
+}
+
+void TestApiCaptureStore::next_ReportsHttpErrorsAndMissingResponses() {
+    const QString dir = tempDir.path() + "/errors";
+    ApiCaptureStore store(dir);
+    QVERIFY(store.save("/aqindex/getIndex/7", makeResponse(404, "Not Found", "")));
+
+    const std::optional<ApiResponse> response = store.next("/aqindex/getIndex/7");
+    QVERIFY(response.has_value());
+    QVERIFY(!response->isSuccess());
+    QCOMPARE(response->httpStatus, 404);
+    QCOMPARE(response->errorString, QString("HTTP 404 Not Found"));
+    QVERIFY(!store.next("/aqindex/getIndex/8").has_value());
+    QCOMPARE(store.count("/aqindex/getIndex/8"), 0);
+}
+
+void TestApiCaptureStore::next_ServesUnnumberedResponseAsSuccess() {
+    const QString dir = tempDir.path() + "/manual";
+    QVERIFY(QDir().mkpath(dir + "/station/sensors"));
+    QFile file(dir + "/station/sensors/52.json");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("[]") == 2);
+    file.close();
+
+    ApiCaptureStore store(dir);
+    const std::optional<ApiResponse> response = store.next("/station/sensors/52");
+    QVERIFY(response.has_value());
+    QVERIFY(response->isSuccess());
+    QCOMPARE(response->httpStatus, 200);
+    QCOMPARE(response->body, QByteArray("[]"));
+    QVERIFY(response->headers.isEmpty());
+}
+
+void TestApiCaptureStore::replayOptions_DelayIncludesTransferTime() {
+    ReplayOptions options;
+    QCOMPARE(options.delayMs(1000000), qint64(0));
+    options.latencyMs = 50;
+    QCOMPARE(options.delayMs(1000000), qint64(50));
+    options.bytesPerSecond = 1000;
+    QCOMPARE(options.delayMs(1500), qint64(1550));
+    QCOMPARE(options.delayMs(1), qint64(51)); // czas przesłania jest zaokrąglany w górę
+}
@@ -0,0 +1,26 @@
+#ifndef TESTAPICAPTURESTORE_H
+#define TESTAPICAPTURESTORE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "ApiCaptureStore.h"
+
+class TestApiCaptureStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+
+private slots:
+    void initTestCase();
+
+    void save_ReplaysResponsesInOrder();
+    void save_ContinuesSequenceInExistingDirectory();
+    void next_ReportsHttpErrorsAndMissingResponses();
+    void next_ServesUnnumberedResponseAsSuccess();
+    void replayOptions_DelayIncludesTransferTime();
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "TestApiService.h"
+#include <QSignalSpy>
+#include <QTcpSocket>
+
+bool TestApiService::startServer(QTcpServer& server, const QByteArray& response) {
+    connect(&server, &QTcpServer::newConnection, &server, [&server, response]() {
+        while (QTcpSocket* socket = server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, socket, [socket, response]() {
+                socket->readAll();
+                socket->write(response);
+                socket->disconnectFromHost();
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+    return server.listen(QHostAddress::LocalHost);
+}
+
+void TestApiService::initTestCase() {
+    QVERIFY(tempDir.isValid());
+}
+
+// Testy dla ApiService (ścieżka sieciowa)
+
+void TestApiService::fetchAllStations_ConnectionErrorReportsNetworkError() {
+    // Port zwolniony zaraz po zajęciu - połączenie zostanie odrzucone
+    QTcpServer closed;
+    QVERIFY(closed.listen(QHostAddress::LocalHost));
+    const quint16 port = closed.serverPort();
+    closed.close();
+
+    const QString captureDir = tempDir.path() + "/connection_error";
+    ApiService service;
+    service.setBaseUrl(QString("http://127.0.0.1:%1").arg(port));
+    service.setCaptureDirectory(captureDir);
+    QSignalSpy readySpy(&service, &ApiService::stationsReady);
+    QSignalSpy failedSpy(&service, &ApiService::requestFailed);
+
+    service.fetchAllStations();
+    QTRY_COMPARE_WITH_TIMEOUT(failedSpy.count(), 1, 10000);
+    QCOMPARE(readySpy.count(), 0);
+    QCOMPARE(failedSpy.first().at(0).value<ApiService::RequestType>(), ApiService::StationsRequest);
+    QVERIFY(failedSpy.first().at(2).toString().startsWith("Błąd sieci (stacje): "));
+    // Bez odpowiedzi serwera nie ma czego zapisać
+    QCOMPARE(ApiCaptureStore(captureDir).count("/station/findAll"), 0);
+}
+
+void TestApiService::fetchAirQualityIndex_Http404ReportsNotFound() {
+    QTcpServer server;
+    QVERIFY(startServer(server, "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\nContent-Length: 2\r\n"
+                                "Connection: close\r\n\r\n{}"));
+
+    const QString captureDir = tempDir.path() + "/not_found";
+    ApiService service;
+    service.setBaseUrl(QString("http://127.0.0.1:%1").arg(server.serverPort()));
+    service.setCaptureDirectory(captureDir);
+    QSignalSpy readySpy(&service, &ApiService::airQualityIndexReady);
+    QSignalSpy failedSpy(&service, &ApiService::requestFailed);
+
+    service.fetchAirQualityIndex(7);
+    QTRY_COMPARE_WITH_TIMEOUT(failedSpy.count(), 1, 10000);
+    QCOMPARE(readySpy.count(), 0);
+    QCOMPARE(failedSpy.first().at(1).toInt(), 7);
+    QCOMPARE(failedSpy.first().at(2).toString(),
+             QString("Indeks Jakości Powietrza niedostępny dla tej stacji (nie znaleziono)."));
+
+    // Odpowiedź z błędem HTTP jest zapisywana i odtwarzana z tym samym statusem
+    ApiCaptureStore capture(captureDir);
+    QCOMPARE(capture.count("/aqindex/getIndex/7"), 1);
+    const std::optional<ApiResponse> replayed = capture.next("/aqindex/getIndex/7");
+    QVERIFY(replayed.has_value());
+    QCOMPARE(replayed->httpStatus, 404);
+    QVERIFY(!replayed->isSuccess());
+}
+
+void TestApiService::fetchSensorData_HttpErrorIsNotParsed() {
+    QTcpServer server;
+    QVERIFY(startServer(server, "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 5\r\n"
+                                "Connection: close\r\n\r\nerror"));
+
+    ApiService service;
+    service.setBaseUrl(QString("http://127.0.0.1:%1").arg(server.serverPort()));
+    QSignalSpy readySpy(&service, &ApiService::sensorDataReady);
+    QSignalSpy failedSpy(&service, &ApiService::requestFailed);
+
+    service.fetchSensorData(1001);
+    QTRY_COMPARE_WITH_TIMEOUT(failedSpy.count(), 1, 10000);
+    QCOMPARE(readySpy.count(), 0);
+    QVERIFY(failedSpy.first().at(2).toString().startsWith("Błąd sieci (dane pomiarowe): "));
+}
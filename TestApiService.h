@@ -0,0 +1,28 @@
+#ifndef TESTAPISERVICE_H
+#define TESTAPISERVICE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTcpServer>
+#include <QTemporaryDir>
+#include "ApiService.h"
+
+class TestApiService : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+
+    /// Uruchamia lokalny serwer, który na każde żądanie odpowiada `response` (surowa odpowiedź HTTP).
+    bool startServer(QTcpServer& server, const QByteArray& response);
+
+private slots:
+    void initTestCase();
+
+    void fetchAllStations_ConnectionErrorReportsNetworkError();
+    void fetchAirQualityIndex_Http404ReportsNotFound();
+    void fetchSensorData_HttpErrorIsNotParsed();
+};
+
+#endif
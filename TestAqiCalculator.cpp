@@ -0,0 +1,106 @@
+#include "TestAqiCalculator.h"
+#include <limits>
+
+SensorData TestAqiCalculator::createTestSensorData(const QString& key, const QDateTime& start, const std::vector<double>& values) {
+    SensorData sd;
+    sd.key = key;
+    for (size_t i = 0; i < values.size(); ++i) {
+        sd.values.push_back({start.addSecs(static_cast<qint64>(i) * 3600), values[i]});
+    }
+    return sd;
+}
+
+// Testy dla AqiCalculator
+
+void TestAqiCalculator::levelForConcentration_Boundaries() {
+    // Górna granica należy do niższego poziomu
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM10, 0.0), 0);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM10, 20.0), 0);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM10, 20.1), 1);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM10, 150.0), 4);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM10, 150.1), 5);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::PM25, 36.0), 2);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::O3, 181.0), 4);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::CO, 2500.0), 0);
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::C6H6, 12.0), 2);
+}
+
+void TestAqiCalculator::levelForConcentration_NaN() {
+    QCOMPARE(AqiCalculator::levelForConcentration(Pollutant::NO2, std::numeric_limits<double>::quiet_NaN()), -1);
+    QCOMPARE(int(toIndexLevel(-1)), NoIndexLevel);
+    QCOMPARE(int(toIndexLevel(6)), NoIndexLevel);
+    QCOMPARE(indexLevelName(NoIndexLevel), QString("Brak indeksu"));
+}
+
+void TestAqiCalculator::pollutantFromCode_Variants() {
+    QVERIFY(AqiCalculator::pollutantFromCode("PM2.5") == Pollutant::PM25);
+    QVERIFY(AqiCalculator::pollutantFromCode("pm25") == Pollutant::PM25);
+    QVERIFY(AqiCalculator::pollutantFromCode("C6H6") == Pollutant::C6H6);
+    QVERIFY(!AqiCalculator::pollutantFromCode("NOx").has_value());
+    QCOMPARE(AqiCalculator::pollutantCode(Pollutant::PM25), QString("PM2.5"));
+}
+
+void TestAqiCalculator::computeIndex_WorstPollutantWins() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    std::vector<SensorData> series = {
+        createTestSensorData("PM10", start, {10.0, 90.0}),  // ostatnia godzina: 90 -> Dostateczny
+        createTestSensorData("NO2", start, {30.0, 35.0}),   // 35 -> Bardzo dobry
+        createTestSensorData("NOx", start, {900.0, 900.0}), // nie wchodzi do indeksu
+    };
+
+    AirQualityIndex index = AqiCalculator::computeIndex(7, series);
+    QCOMPARE(index.stationId, 7);
+    QCOMPARE(index.stSourceDataDate, start.addSecs(3600));
+    QCOMPARE(index.level(Pollutant::PM10), 3);
+    QCOMPARE(indexLevelName(index.level(Pollutant::PM10)), QString("Dostateczny"));
+    QCOMPARE(index.level(Pollutant::NO2), 0);
+    QCOMPARE(index.level(Pollutant::O3), -1);
+    QCOMPARE(int(index.stIndexLevel), 3);
+}
+
+void TestAqiCalculator::computeIndex_IgnoresStaleMeasurements() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<SensorData> series = {
+        createTestSensorData("PM10", start, {15.0, nan, nan, nan, nan, 25.0}), // godzina 5: 25 -> Dobry
+        createTestSensorData("SO2", start, {600.0}),                           // godzina 0: poza oknem 3h
+        createTestSensorData("O3", start.addSecs(3 * 3600), {130.0}),          // godzina 3: w oknie 3h
+    };
+
+    AirQualityIndex index = AqiCalculator::computeIndex(1, series, 3);
+    QCOMPARE(index.stSourceDataDate, start.addSecs(5 * 3600));
+    QCOMPARE(index.level(Pollutant::PM10), 1);
+    QCOMPARE(index.level(Pollutant::SO2), -1);
+    QCOMPARE(index.level(Pollutant::O3), 2);
+    QCOMPARE(int(index.stIndexLevel), 2);
+}
+
+void TestAqiCalculator::computeIndex_NoData() {
+    SensorData empty;
+    empty.key = "PM10";
+    AirQualityIndex index = AqiCalculator::computeIndex(1, {empty});
+    QCOMPARE(index.stationId, -1);
+}
+
+void TestAqiCalculator::computeHourlyIndices_PerHour() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<SensorData> series = {
+        createTestSensorData("PM2.5", start, {10.0, 60.0, nan}),
+        createTestSensorData("PM2.5", start, {20.0, 5.0, nan}),      // drugi czujnik PM2.5 - liczy się wyższe stężenie
+        createTestSensorData("NO2", start.addSecs(1800), {120.0}), // 00:30 -> godzina 00:00
+    };
+
+    std::vector<AirQualityIndex> indices = AqiCalculator::computeHourlyIndices(3, series);
+    QCOMPARE(indices.size(), size_t(2)); // godzina 2 nie ma prawidłowych pomiarów
+
+    QCOMPARE(indices[0].stSourceDataDate, start);
+    QCOMPARE(indices[0].level(Pollutant::PM25), 1);
+    QCOMPARE(indices[0].level(Pollutant::NO2), 2);
+    QCOMPARE(int(indices[0].stIndexLevel), 2);
+
+    QCOMPARE(indices[1].stSourceDataDate, start.addSecs(3600));
+    QCOMPARE(indices[1].level(Pollutant::PM25), 3);
+    QCOMPARE(indices[1].level(Pollutant::NO2), -1);
+    QCOMPARE(int(indices[1].stIndexLevel), 3);
+}
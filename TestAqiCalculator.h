@@ -0,0 +1,26 @@
+#ifndef TESTAQICALCULATOR_H
+#define TESTAQICALCULATOR_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "AqiCalculator.h"
+#include "DataStructures.h"
+
+class TestAqiCalculator : public QObject
+{
+    Q_OBJECT
+
+private:
+    SensorData createTestSensorData(const QString& key, const QDateTime& start, const std::vector<double>& values);
+
+private slots:
+    void levelForConcentration_Boundaries();
+    void levelForConcentration_NaN();
+    void pollutantFromCode_Variants();
+    void computeIndex_WorstPollutantWins();
+    void computeIndex_IgnoresStaleMeasurements();
+    void computeIndex_NoData();
+    void computeHourlyIndices_PerHour();
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "TestAqiHistoryStore.h"
+#include <QFile>
+
+QDateTime TestAqiHistoryStore::hour(int index) {
+    return QDateTime::fromString("2024-03-01T00:00:00Z", Qt::ISODate).addSecs(static_cast<qint64>(index) * 3600);
+}
+
+AirQualityIndex TestAqiHistoryStore::snapshot(int stationId, int hourIndex, int level) {
+    AirQualityIndex index;
+    index.stationId = stationId;
+    index.stCalcDate = hour(hourIndex);
+    index.stSourceDataDate = hour(hourIndex - 1);
+    index.stIndexLevel = toIndexLevel(level);
+    index.setLevel(Pollutant::PM10, level);
+    return index;
+}
+
+// Testy dla AqiHistoryStore
+
+void TestAqiHistoryStore::append_SkipsRepeatedCalcDate() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+
+    QVERIFY(store.append(snapshot(10, 0, 1)));
+    QVERIFY(!store.append(snapshot(10, 0, 1))); // ponowne odpytanie API - ten sam stCalcDate
+    QVERIFY(store.append(snapshot(10, 1, 2)));
+    QCOMPARE(store.count(10), qint64(2));
+    QCOMPARE(QFileInfo(dir.filePath(AqiHistoryStore::fileName(10))).size(),
+             qint64(AqiHistoryStore::HeaderSize + 2 * AqiHistoryStore::RecordSize));
+
+    AirQualityIndex latest = store.latest(10);
+    QVERIFY(latest == snapshot(10, 1, 2));
+    QCOMPARE(store.latest(11).stationId, -1);
+    QVERIFY(store.stationIds() == std::vector<int>{10});
+}
+
+void TestAqiHistoryStore::append_OlderIndexKeepsOrder() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+
+    QCOMPARE(store.appendBatch(5, {snapshot(5, 4, 1), snapshot(5, 2, 1), snapshot(5, 4, 3)}), 2);
+    QVERIFY(store.append(snapshot(5, 3, 2)));  // starszy niż ostatni rekord - wstawienie
+    QVERIFY(!store.append(snapshot(5, 2, 0))); // duplikat w środku historii
+    QCOMPARE(store.appendBatch(5, {snapshot(5, 1, 0), snapshot(5, 3, 0), snapshot(5, 6, 0), snapshot(7, 9, 0)}), 2);
+
+    std::vector<AirQualityIndex> history = store.range(5);
+    QCOMPARE(history.size(), std::size_t(5));
+    const int expectedHours[] = {1, 2, 3, 4, 6};
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        QCOMPARE(history[i].stCalcDate, hour(expectedHours[i]));
+    }
+    QCOMPARE(int(history[2].stIndexLevel), 2); // rekord z godziny 3 nie został nadpisany
+    QCOMPARE(store.count(7), qint64(0));
+}
+
+void TestAqiHistoryStore::range_ReturnsHalfOpenInterval() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+    std::vector<AirQualityIndex> batch;
+    for (int h = 0; h < 100; ++h) {
+        batch.push_back(snapshot(3, h, h % IndexLevelCount));
+    }
+    QCOMPARE(store.appendBatch(3, batch), 100);
+
+    std::vector<AirQualityIndex> slice = store.range(3, hour(10), hour(20));
+    QCOMPARE(slice.size(), std::size_t(10));
+    QVERIFY(slice.front() == batch[10]);
+    QVERIFY(slice.back() == batch[19]);
+
+    QCOMPARE(store.range(3, hour(95)).size(), std::size_t(5));
+    QCOMPARE(store.range(3, QDateTime(), hour(1)).size(), std::size_t(1));
+    QVERIFY(store.range(3, hour(200), hour(300)).empty());
+    QVERIFY(store.range(4).empty());
+}
+
+void TestAqiHistoryStore::levelDurations_SumsHoursPerLevel() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+    AirQualityIndex noPm10 = snapshot(8, 5, 1);
+    noPm10.setLevel(Pollutant::PM10, NoIndexLevel);
+    QCOMPARE(store.appendBatch(8, {snapshot(8, 0, 4), snapshot(8, 1, 4), snapshot(8, 2, 1), noPm10, snapshot(8, 6, 5)}), 5);
+
+    // 0-2 h: Zły, 2-4 h: Dobry (maks. 2 h), 4-5 h: luka, 5-6 h: Dobry, 6-7 h: Bardzo zły (do końca przedziału)
+    AqiLevelDurations overall = store.levelDurations(8, hour(0), hour(7));
+    QCOMPARE(overall.hours(4), 2.0);
+    QCOMPARE(overall.hours(1), 3.0);
+    QCOMPARE(overall.hours(5), 1.0);
+    QCOMPARE(overall.uncoveredSeconds, qint64(3600));
+    QCOMPARE(overall.noIndexSeconds, qint64(0));
+
+    // Przedział zaczynający się w trakcie obowiązywania rekordu sprzed `from`
+    AqiLevelDurations partial = store.levelDurations(8, hour(1).addSecs(1800), hour(3));
+    QCOMPARE(partial.seconds[4], qint64(1800));
+    QCOMPARE(partial.seconds[1], qint64(3600));
+
+    AqiLevelDurations pm10 = store.levelDurations(8, hour(0), hour(7), Pollutant::PM10);
+    QCOMPARE(pm10.noIndexSeconds, qint64(3600));
+    QCOMPARE(pm10.hours(1), 2.0);
+}
+
+void TestAqiHistoryStore::load_IgnoresIncompleteTrailingRecord() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+    QVERIFY(store.append(snapshot(9, 0, 1)));
+    QVERIFY(store.append(snapshot(9, 1, 2)));
+
+    QFile file(dir.filePath(AqiHistoryStore::fileName(9)));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5)); // przerwany zapis ostatniego rekordu
+    file.close();
+
+    QCOMPARE(store.range(9).size(), std::size_t(1));
+    QVERIFY(store.append(snapshot(9, 2, 3))); // niepełny rekord jest obcinany przed dopisaniem
+    std::vector<AirQualityIndex> history = store.range(9);
+    QCOMPARE(history.size(), std::size_t(2));
+    QVERIFY(history.back() == snapshot(9, 2, 3));
+}
+
+void TestAqiHistoryStore::removeBefore_DropsOldRecords() {
+    QTemporaryDir dir;
+    AqiHistoryStore store(dir.path());
+    std::vector<AirQualityIndex> batch;
+    for (int h = 0; h < 10; ++h) {
+        batch.push_back(snapshot(6, h, 1));
+    }
+    QCOMPARE(store.appendBatch(6, batch), 10);
+
+    QCOMPARE(store.removeBefore(6, hour(0)), qint64(0));
+    QCOMPARE(store.removeBefore(6, hour(4)), qint64(4));
+    std::vector<AirQualityIndex> history = store.range(6);
+    QCOMPARE(history.size(), std::size_t(6));
+    QVERIFY(history.front() == batch[4]);
+    QVERIFY(store.append(snapshot(6, 10, 2))); // dopisywanie działa po przepisaniu pliku
+
+    QCOMPARE(store.removeBefore(6, hour(100)), qint64(7));
+    QVERIFY(!QFile::exists(dir.filePath(AqiHistoryStore::fileName(6))));
+    QVERIFY(store.stationIds().empty());
+    QCOMPARE(store.removeBefore(7, hour(100)), qint64(0));
+}
@@ -0,0 +1,27 @@
+#ifndef TESTAQIHISTORYSTORE_H
+#define TESTAQIHISTORYSTORE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "AqiHistoryStore.h"
+#include "DataStructures.h"
+
+class TestAqiHistoryStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDateTime hour(int index);
+    AirQualityIndex snapshot(int stationId, int hourIndex, int level);
+
+private slots:
+    void append_SkipsRepeatedCalcDate();
+    void append_OlderIndexKeepsOrder();
+    void range_ReturnsHalfOpenInterval();
+    void levelDurations_SumsHoursPerLevel();
+    void load_IgnoresIncompleteTrailingRecord();
+    void removeBefore_DropsOldRecords();
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "TestArchiveImporter.h"
+#include "AqiHistoryStore.h"
+#include <QDir>
+#include <QFile>
+#include <limits>
+
+bool TestArchiveImporter::writeFile(const QString& root, const QString& relativePath, const QByteArray& content) {
+    const QString path = root + "/" + relativePath;
+    if (!QDir(root).mkpath(QFileInfo(relativePath).path())) {
+        return false;
+    }
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+void TestArchiveImporter::initTestCase() {
+    QVERIFY(tempDir.isValid());
+}
+
+// Testy dla ArchiveImporter
+
+void TestArchiveImporter::captureKind_RecognizesApiPaths() {
+    int id = -1;
+    QCOMPARE(ArchiveImporter::captureKind("/captures/station/findAll.json"), ArchiveImporter::CaptureKind::Stations);
+    QCOMPARE(ArchiveImporter::captureKind("/captures/station/sensors/52.json", &id), ArchiveImporter::CaptureKind::Sensors);
+    QCOMPARE(id, 52);
+    QCOMPARE(ArchiveImporter::captureKind("captures/data/getData/1234_20240101T120000.json", &id),
+             ArchiveImporter::CaptureKind::Measurements);
+    QCOMPARE(id, 1234);
+    QCOMPARE(ArchiveImporter::captureKind("aqindex/getIndex/7.json", &id), ArchiveImporter::CaptureKind::AqiIndex);
+    QCOMPARE(id, 7);
+    QCOMPARE(ArchiveImporter::captureKind("data/getData/12ab.json"), ArchiveImporter::CaptureKind::Unknown);
+    QCOMPARE(ArchiveImporter::captureKind("data/other/12.json"), ArchiveImporter::CaptureKind::Unknown);
+    QCOMPARE(ArchiveImporter::captureKind("notes.json"), ArchiveImporter::CaptureKind::Unknown);
+}
+
+void TestArchiveImporter::importDirectory_ApiCaptures() {
+    const QString cacheDir = tempDir.path() + "/captures_cache";
+    const QString captures = tempDir.path() + "/captures";
+    QVERIFY(QDir().mkpath(cacheDir));
+    QVERIFY(writeFile(captures, "station/findAll.json",
+                      R"([{"id": 100, "stationName": "Kraków, Aleja Krasińskiego", "city": {"id": 1, "name": "Kraków"}}])"));
+    QVERIFY(writeFile(captures, "station/sensors/100.json",
+                      R"([{"id": 1001, "stationId": 100, "param": {"paramCode": "PM10", "idParam": 3}}])"));
+    // Dwie odpowiedzi z nakładającymi się godzinami
+    QVERIFY(writeFile(captures, "data/getData/1001_1.json", R"({"key": "PM10", "values": [
+        {"date": "2024-01-01 02:00:00", "value": 22.0},
+        {"date": "2024-01-01 01:00:00", "value": 21.0},
+        {"date": "2024-01-01 00:00:00", "value": null}]})"));
+    QVERIFY(writeFile(captures, "data/getData/1001_2.json", R"({"key": "PM10", "values": [
+        {"date": "2024-01-01 03:00:00", "value": 23.0},
+        {"date": "2024-01-01 02:00:00", "value": 22.0}]})"));
+    QVERIFY(writeFile(captures, "aqindex/getIndex/100_1.json",
+                      R"({"id": 100, "stCalcDate": "2024-01-01 01:20:00", "stIndexLevel": {"id": 1}})"));
+    QVERIFY(writeFile(captures, "aqindex/getIndex/100_2.json",
+                      R"({"id": 100, "stCalcDate": "2024-01-01 02:20:00", "stIndexLevel": {"id": 2}})"));
+    QVERIFY(writeFile(captures, "aqindex/getIndex/100_3.json",
+                      R"({"id": 100, "stCalcDate": "2024-01-01 02:20:00", "stIndexLevel": {"id": 2}})"));
+    QVERIFY(writeFile(captures, "notes.json", "{}"));
+
+    DataStorage storage(cacheDir);
+    ArchiveImporter importer(&storage);
+    importer.setMaxThreadCount(4);
+    const ImportStats stats = importer.importDirectory(captures);
+
+    QCOMPARE(stats.filesRead, 7);
+    QCOMPARE(stats.filesFailed, 1);
+    QCOMPARE(stats.metadataSaved, 2);
+    QCOMPARE(stats.sensorsUpdated, 1);
+    QCOMPARE(stats.pointsRead, quint64(4));
+    QCOMPARE(stats.pointsAdded, quint64(3));
+    QCOMPARE(stats.duplicatesSkipped, quint64(1));
+    QCOMPARE(stats.indicesAdded, 2); // trzecia odpowiedź powtarza stCalcDate drugiej
+
+    QCOMPARE(storage.loadStationsFromJson().size(), std::size_t(1));
+    QCOMPARE(storage.loadSensorsFromJson(100).size(), std::size_t(1));
+    const SensorData data = storage.loadCachedSensorData(1001);
+    QCOMPARE(data.key, QString("PM10"));
+    QCOMPARE(data.values.size(), std::size_t(3));
+    QCOMPARE(data.values.front().value, 21.0);
+    QCOMPARE(data.values.back().value, 23.0);
+    QCOMPARE(storage.airQualityIndexHistory().count(100), qint64(2));
+
+    // Ponowny import niczego nie dodaje
+    const ImportStats again = importer.importDirectory(captures);
+    QCOMPARE(again.pointsAdded, quint64(0));
+    QCOMPARE(again.duplicatesSkipped, quint64(4));
+    QCOMPARE(again.sensorsUpdated, 0);
+    QCOMPARE(again.indicesAdded, 0);
+    QCOMPARE(again.metadataSaved, 0);
+}
+
+void TestArchiveImporter::importFiles_CsvMergesWithExistingData() {
+    const QString cacheDir = tempDir.path() + "/csv_cache";
+    QVERIFY(QDir().mkpath(cacheDir));
+    DataStorage storage(cacheDir);
+
+    const QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    SensorData existing;
+    existing.key = "PM10";
+    existing.values.push_back({start, 10.0});
+    existing.values.push_back({start.addSecs(3600), std::numeric_limits<double>::quiet_NaN()});
+    QVERIFY(storage.saveSensorSeries(5, existing));
+
+    QVERIFY(writeFile(tempDir.path(), "archive/long.csv",
+                      "sensor_id,param,timestamp,value\n"
+                      "5,PM10,2024-01-01T00:00:00Z,99\n"      // jest w cache - zostaje 10
+                      "5,PM10,2024-01-01T01:00:00Z,11\n"      // uzupełnia NaN
+                      "5,PM10,2024-01-01T02:00:00Z,12\n"
+                      "5,PM10,2024-01-01T02:00:00Z,12\n"      // powtórzony wiersz
+                      "5,PM10,2024-01-01T03:00:00Z,\n"        // brak wartości
+                      "bad,row\n"
+                      "5,PM10,2024-01-01T04:00:00Z,14"));     // ostatni wiersz bez końca linii
+    QVERIFY(writeFile(tempDir.path(), "archive/wide.csv",
+                      "timestamp,NO2_7,PM10_5\n"
+                      "2024-01-01T00:00:00Z,1,\n"
+                      "2024-01-01T05:00:00Z,2,15\n"));
+
+    ArchiveImporter importer(&storage);
+    importer.setMaxThreadCount(2);
+    const ImportStats stats = importer.importFiles(QStringList{tempDir.path() + "/archive/long.csv",
+                                                               tempDir.path() + "/archive/wide.csv"});
+    QCOMPARE(stats.filesRead, 2);
+    QCOMPARE(stats.filesFailed, 0);
+    QCOMPARE(stats.rowsSkipped, quint64(1));
+    QCOMPARE(stats.sensorsUpdated, 2);
+    QCOMPARE(stats.pointsRead, quint64(5 + 3));
+    QCOMPARE(stats.pointsAdded, quint64(6));
+    QCOMPARE(stats.duplicatesSkipped, quint64(2));
+
+    const SensorData pm10 = storage.loadCachedSensorData(5);
+    QCOMPARE(pm10.values.size(), std::size_t(5));
+    const double expected[] = {10.0, 11.0, 12.0, 14.0, 15.0};
+    for (std::size_t i = 0; i < pm10.values.size(); ++i) {
+        QCOMPARE(pm10.values[i].value, expected[i]);
+    }
+    QCOMPARE(pm10.values[3].date, start.addSecs(4 * 3600));
+
+    const SensorData no2 = storage.loadCachedSensorData(7);
+    QCOMPARE(no2.key, QString("NO2"));
+    QCOMPARE(no2.values.size(), std::size_t(2));
+}
+
+void TestArchiveImporter::importFiles_RejectsParameterMismatch() {
+    const QString cacheDir = tempDir.path() + "/mismatch_cache";
+    QVERIFY(QDir().mkpath(cacheDir));
+    DataStorage storage(cacheDir);
+
+    SensorData existing;
+    existing.key = "SO2";
+    existing.values.push_back({QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate), 1.0});
+    QVERIFY(storage.saveSensorSeries(9, existing));
+
+    QVERIFY(writeFile(tempDir.path(), "mismatch/data.csv",
+                      "sensor_id,param,timestamp,value\n"
+                      "9,PM10,2024-01-01T01:00:00Z,5\n"
+                      "11,,2024-01-01T01:00:00Z,5\n")); // nowy czujnik bez kodu parametru
+    QVERIFY(writeFile(tempDir.path(), "mismatch/header.csv", "date,station,level\n2024-01-01,1,2\n"));
+
+    ArchiveImporter importer(&storage);
+    const ImportStats stats = importer.importFiles(QStringList{tempDir.path() + "/mismatch/data.csv",
+                                                               tempDir.path() + "/mismatch/header.csv"});
+    QCOMPARE(stats.filesRead, 1);
+    QCOMPARE(stats.filesFailed, 1);
+    QCOMPARE(stats.sensorsRejected, 2);
+    QCOMPARE(stats.pointsAdded, quint64(0));
+    QCOMPARE(storage.loadCachedSensorData(9).values.size(), std::size_t(1));
+    QVERIFY(storage.loadCachedSensorData(11).key.isEmpty());
+}
+
+void TestArchiveImporter::importFiles_HistorySurvivesLiveSave() {
+    const QString cacheDir = tempDir.path() + "/live_cache";
+    QVERIFY(QDir().mkpath(cacheDir));
+    DataStorage storage(cacheDir);
+    ApiService apiService;
+    DataRepository repository(&apiService, &storage);
+
+    // Rok historii z archiwum
+    const QDateTime start = QDateTime::fromString("2023-01-01T00:00:00Z", Qt::ISODate);
+    QByteArray csv = "sensor_id,param,timestamp,value\n";
+    for (int day = 0; day < 365; ++day) {
+        csv += "21,PM10," + start.addDays(day).toString(Qt::ISODate).toUtf8() + ",30\n";
+    }
+    QVERIFY(writeFile(tempDir.path(), "live/history.csv", csv));
+    ArchiveImporter importer(&storage);
+    QCOMPARE(importer.importFiles(QStringList{tempDir.path() + "/live/history.csv"}).pointsAdded, quint64(365));
+
+    // Zapis odpowiedzi API z ostatnich dni (z poprawioną wartością ostatniego dnia archiwum)
+    SensorData live;
+    live.key = "PM10";
+    live.values.push_back({start.addDays(366), 12.0});
+    live.values.push_back({start.addDays(365), 11.0});
+    live.values.push_back({start.addDays(364), 10.0});
+    QVERIFY(repository.saveSensorData(21, live));
+    QVERIFY(storage.flush());
+
+    const SensorData data = storage.loadCachedSensorData(21);
+    QCOMPARE(data.values.size(), std::size_t(367));
+    QCOMPARE(data.values.front().date, start);
+    QCOMPARE(data.values.front().value, 30.0);
+    QCOMPARE(data.values[364].value, 10.0);
+    QCOMPARE(data.values.back().value, 12.0);
+    QVERIFY(*repository.loadSensorData(21) == data);
+
+    // Zaimportowana historia nie znika przy porządkowaniu cache
+    RetentionPolicy policy;
+    policy.maxAgeDays = 30;
+    storage.compact(policy, start.addDays(400));
+    QCOMPARE(storage.loadCachedSensorData(21).values.size(), std::size_t(367));
+}
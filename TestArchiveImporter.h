@@ -0,0 +1,32 @@
+#ifndef TESTARCHIVEIMPORTER_H
+#define TESTARCHIVEIMPORTER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "ArchiveImporter.h"
+#include "DataStorage.h"
+#include "DataRepository.h"
+#include "DataStructures.h"
+
+class TestArchiveImporter : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+
+    /// Zapisuje plik `relativePath` w katalogu `root` (tworzy podkatalogi).
+    bool writeFile(const QString& root, const QString& relativePath, const QByteArray& content);
+
+private slots:
+    void initTestCase();
+
+    void captureKind_RecognizesApiPaths();
+    void importDirectory_ApiCaptures();
+    void importFiles_CsvMergesWithExistingData();
+    void importFiles_RejectsParameterMismatch();
+    void importFiles_HistorySurvivesLiveSave();
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "TestCacheManifest.h"
+#include <QFile>
+
+CacheEntry TestCacheManifest::makeEntry(const QString& fileName, CacheEntityType type, int id, qint64 size) {
+    CacheEntry entry;
+    entry.fileName = fileName;
+    entry.type = type;
+    entry.id = id;
+    entry.size = size;
+    entry.lastFetch = QDateTime::fromString("2024-03-01T12:00:00.250Z", Qt::ISODateWithMs);
+    entry.formatVersion = 1;
+    entry.checksum = 0xCBF43926;
+    return entry;
+}
+
+// Testy dla CacheManifest
+
+void TestCacheManifest::load_EmptyDirectoryReturnsFalse() {
+    QTemporaryDir dir;
+    CacheManifest manifest(dir.path());
+    QVERIFY(!manifest.load());
+    QCOMPARE(manifest.size(), 0);
+    QCOMPARE(manifest.totalSize(), qint64(0));
+    QVERIFY(!manifest.entry("stations.json").has_value());
+}
+
+void TestCacheManifest::updateRemove_ReplayedFromJournal() {
+    QTemporaryDir dir;
+    CacheEntry series = makeEntry("sensor_7_series.bin", CacheEntityType::SensorSeries, 7, 900);
+    series.firstDate = QDateTime::fromString("2024-02-01T00:00:00Z", Qt::ISODate);
+    series.lastDate = QDateTime::fromString("2024-03-01T00:00:00Z", Qt::ISODate);
+    {
+        CacheManifest manifest(dir.path());
+        manifest.update(makeEntry("sensor_9_series.bin", CacheEntityType::SensorSeries, 9, 100));
+        manifest.update(series);
+        manifest.update(makeEntry("stations.json", CacheEntityType::Stations, -1, 5000));
+        manifest.update(makeEntry("sensor_9_series.bin", CacheEntityType::SensorSeries, 9, 300)); // nowsza wersja
+        manifest.update(makeEntry("station_4_sensors.json", CacheEntityType::Sensors, 4, 40));
+        manifest.remove("station_4_sensors.json");
+        manifest.remove("missing.json"); // brak wpisu - nic nie jest dopisywane
+    }
+    // Tylko dziennik, bez migawki
+    QVERIFY(!QFile::exists(dir.filePath(CacheManifest::fileName())));
+
+    CacheManifest reloaded(dir.path());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.size(), 3);
+    QCOMPARE(reloaded.totalSize(), qint64(900 + 300 + 5000));
+    QVERIFY(*reloaded.entry("sensor_7_series.bin") == series);
+    QCOMPARE(reloaded.entry("sensor_9_series.bin")->size, qint64(300));
+    QVERIFY(!reloaded.entry("station_4_sensors.json").has_value());
+
+    std::vector<CacheEntry> seriesEntries = reloaded.entries(CacheEntityType::SensorSeries);
+    QCOMPARE(seriesEntries.size(), std::size_t(2));
+    QCOMPARE(seriesEntries[0].id, 7);
+    QCOMPARE(seriesEntries[1].id, 9);
+    QCOMPARE(reloaded.entries().front().fileName, QString("sensor_7_series.bin"));
+}
+
+void TestCacheManifest::compact_MergesJournalIntoSnapshot() {
+    QTemporaryDir dir;
+    CacheManifest manifest(dir.path());
+    for (int i = 0; i < CacheManifest::MinCompactRecords - 1; ++i) {
+        manifest.update(makeEntry("sensor_1_series.bin", CacheEntityType::SensorSeries, 1, i));
+    }
+    QVERIFY(QFile::exists(dir.filePath(CacheManifest::journalFileName())));
+    QVERIFY(!QFile::exists(dir.filePath(CacheManifest::fileName())));
+
+    // Dziennik dłuższy niż liczba wpisów - scalany automatycznie
+    manifest.update(makeEntry("sensor_2_series.bin", CacheEntityType::SensorSeries, 2, 20));
+    QVERIFY(QFile::exists(dir.filePath(CacheManifest::fileName())));
+    QVERIFY(!QFile::exists(dir.filePath(CacheManifest::journalFileName())));
+
+    manifest.remove("sensor_2_series.bin");
+    QVERIFY(manifest.compact());
+    QVERIFY(!QFile::exists(dir.filePath(CacheManifest::journalFileName())));
+
+    CacheManifest reloaded(dir.path());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.size(), 1);
+    QCOMPARE(reloaded.entry("sensor_1_series.bin")->size, qint64(CacheManifest::MinCompactRecords - 2));
+
+    QVERIFY(reloaded.replaceAll({makeEntry("stations.json", CacheEntityType::Stations, -1, 10)}));
+    CacheManifest replaced(dir.path());
+    QVERIFY(replaced.load());
+    QCOMPARE(replaced.size(), 1);
+    QVERIFY(replaced.entry("stations.json").has_value());
+}
+
+void TestCacheManifest::load_SkipsDamagedJournalRecord() {
+    QTemporaryDir dir;
+    {
+        CacheManifest manifest(dir.path());
+        manifest.update(makeEntry("sensor_3_series.bin", CacheEntityType::SensorSeries, 3, 30));
+        manifest.update(makeEntry("sensor_4_series.bin", CacheEntityType::SensorSeries, 4, 40));
+    }
+    // Przerwany zapis ostatniej linii dziennika
+    QFile journal(dir.filePath(CacheManifest::journalFileName()));
+    QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+    journal.write("{\"file\":\"sensor_5_series.bin\",\"type\":\"sensorSe");
+    journal.close();
+
+    CacheManifest reloaded(dir.path());
+    QVERIFY(reloaded.load());
+    QCOMPARE(reloaded.size(), 2);
+    QVERIFY(!reloaded.entry("sensor_5_series.bin").has_value());
+    QVERIFY(!QFile::exists(dir.filePath(CacheManifest::journalFileName()))); // scalony z migawką
+
+    // Kolejny wpis dopisany po odczycie jest odtwarzany
+    reloaded.update(makeEntry("sensor_6_series.bin", CacheEntityType::SensorSeries, 6, 60));
+    CacheManifest again(dir.path());
+    QVERIFY(again.load());
+    QCOMPARE(again.size(), 3);
+    QCOMPARE(again.entry("sensor_6_series.bin")->size, qint64(60));
+}
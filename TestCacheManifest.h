@@ -0,0 +1,23 @@
+#ifndef TESTCACHEMANIFEST_H
+#define TESTCACHEMANIFEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "CacheManifest.h"
+
+class TestCacheManifest : public QObject
+{
+    Q_OBJECT
+
+private:
+    CacheEntry makeEntry(const QString& fileName, CacheEntityType type, int id, qint64 size);
+
+private slots:
+    void load_EmptyDirectoryReturnsFalse();
+    void updateRemove_ReplayedFromJournal();
+    void compact_MergesJournalIntoSnapshot();
+    void load_SkipsDamagedJournalRecord();
+};
+
+#endif
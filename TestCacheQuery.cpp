@@ -0,0 +1,139 @@
+#include "TestCacheQuery.h"
+#include <limits>
+
+SensorData TestCacheQuery::createHourlySeries(const QString& key, const QDateTime& start, int hours) {
+    SensorData sd;
+    sd.key = key;
+    for (int i = 0; i < hours; ++i) {
+        sd.values.push_back({start.addSecs(static_cast<qint64>(i) * 3600), static_cast<double>(i)});
+    }
+    return sd;
+}
+
+void TestCacheQuery::initTestCase() {
+    QVERIFY(tempDir.isValid());
+    storage = new DataStorage(tempDir.path());
+
+    std::vector<MeasuringStation> stations(2);
+    stations[0].id = 100;
+    stations[0].stationName = "Kraków, Aleja Krasińskiego";
+    stations[0].city.name = "Kraków";
+    stations[0].city.commune.provinceName = "MAŁOPOLSKIE";
+    stations[1].id = 200;
+    stations[1].stationName = "Katowice, Kossutha";
+    stations[1].city.name = "Katowice";
+    stations[1].city.commune.provinceName = "ŚLĄSKIE";
+    QVERIFY(storage->saveStationsToJson(stations));
+
+    auto makeSensor = [](int id, int stationId, const QString& paramCode) {
+        Sensor s;
+        s.id = id;
+        s.stationId = stationId;
+        s.param.paramCode = paramCode;
+        return s;
+    };
+    QVERIFY(storage->saveSensorsToJson(100, {makeSensor(1001, 100, "PM10"), makeSensor(1002, 100, "NO2")}));
+    QVERIFY(storage->saveSensorsToJson(200, {makeSensor(2001, 200, "PM10")}));
+
+    const QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    SensorData pm10 = createHourlySeries("PM10", start, 48);
+    pm10.values[5].value = std::numeric_limits<double>::quiet_NaN(); // brak pomiaru nie trafia do wyniku
+    QVERIFY(storage->saveSensorSeries(1001, pm10));
+    QVERIFY(storage->saveSensorSeries(1002, createHourlySeries("NO2", start, 24)));
+    // Seria z poprzedniego roku - poza przedziałem dat zapytań z 2024 r.
+    QVERIFY(storage->saveSensorSeries(2001, createHourlySeries("PM10", start.addYears(-1), 24)));
+    // Czujnik bez zapisanej listy czujników stacji, w starszym formacie JSON
+    QVERIFY(storage->saveSensorDataToJson(createHourlySeries("SO2", start, 3), DataStorage::sensorDataFileName(3001)));
+}
+
+void TestCacheQuery::cleanupTestCase() {
+    delete storage;
+    storage = nullptr;
+}
+
+// Testy dla CacheQuery
+
+void TestCacheQuery::collect_FiltersByProvinceAndParameter() {
+    CacheQuery query(storage);
+    query.setMaxThreadCount(2);
+    CacheQueryFilter filter;
+    filter.provinces = QStringList{"małopolskie"}; // bez rozróżniania wielkości liter
+    filter.paramCodes = QStringList{"PM10"};
+    QueryResult result = query.collect(filter);
+
+    QCOMPARE(result.sensors.size(), std::size_t(1));
+    const QuerySensor& sensor = result.sensors[0];
+    QCOMPARE(sensor.sensorId, 1001);
+    QCOMPARE(sensor.stationId, 100);
+    QCOMPARE(sensor.cityName, QString("Kraków"));
+    QCOMPARE(sensor.provinceName, QString("MAŁOPOLSKIE"));
+    QCOMPARE(sensor.paramCode, QString("PM10"));
+    QCOMPARE(sensor.offset, std::size_t(0));
+    QCOMPARE(sensor.count, std::size_t(47));
+
+    QCOMPARE(result.values.size(), std::size_t(47));
+    QCOMPARE(result.timestamps.size(), result.values.size());
+    QCOMPARE(result.sensorIds.size(), result.values.size());
+    QCOMPARE(result.sensorIds.back(), 1001);
+    QCOMPARE(result.values[4], 4.0);
+    QCOMPARE(result.values[5], 6.0);
+    QVERIFY(std::is_sorted(result.timestamps.begin(), result.timestamps.end()));
+    QCOMPARE(result.stats.sensorsRead, 1); // listy czujników stacji z ŚLĄSKIE nie są nawet wczytywane
+    QCOMPARE(result.stats.pointCount, quint64(47));
+}
+
+void TestCacheQuery::collect_TimeRangePrunesSeries() {
+    CacheQuery query(storage);
+    CacheQueryFilter filter;
+    filter.from = QDateTime::fromString("2024-01-01T12:00:00", Qt::ISODate);
+    filter.to = QDateTime::fromString("2024-01-02T00:00:00", Qt::ISODate);
+    QueryResult result = query.collect(filter);
+
+    QCOMPARE(result.stats.sensorsPruned, 1); // seria 2001 z poprzedniego roku
+    QCOMPARE(result.stats.sensorsRead, 3);
+    QCOMPARE(result.stats.failedCount, 0);
+    QCOMPARE(result.sensors.size(), std::size_t(2));
+    QCOMPARE(result.sensors[0].sensorId, 1001);
+    QCOMPARE(result.sensors[0].count, std::size_t(12));
+    QCOMPARE(result.sensors[1].sensorId, 1002);
+    QCOMPARE(result.sensors[1].offset, std::size_t(12));
+    QCOMPARE(result.sensors[1].count, std::size_t(12));
+    QCOMPARE(result.timestamps.front(), filter.from.toMSecsSinceEpoch());
+    QVERIFY(result.timestamps.back() < filter.to.toMSecsSinceEpoch());
+    QCOMPARE(result.sensorIds[12], 1002);
+}
+
+void TestCacheQuery::collect_SensorWithoutMetadataUsesDataKey() {
+    CacheQuery query(storage);
+    CacheQueryFilter filter;
+    filter.paramCodes = QStringList{"SO2"};
+    QueryResult result = query.collect(filter);
+
+    QCOMPARE(result.sensors.size(), std::size_t(1));
+    QCOMPARE(result.sensors[0].sensorId, 3001);
+    QCOMPARE(result.sensors[0].stationId, -1);
+    QCOMPARE(result.sensors[0].paramCode, QString("SO2"));
+    QCOMPARE(result.values.size(), std::size_t(3));
+
+    // Warunek na miasto wymaga metadanych stacji
+    filter.cities = QStringList{"Kraków"};
+    QVERIFY(query.collect(filter).sensors.empty());
+}
+
+void TestCacheQuery::stream_StopsWhenCallbackReturnsFalse() {
+    CacheQuery query(storage);
+    query.setMaxThreadCount(1);
+    int calls = 0;
+    bool countsMatch = true;
+    std::size_t points = 0;
+    QueryStats stats = query.stream(CacheQueryFilter(), [&](const QuerySensor& sensor, const std::vector<MeasurementValue>& values) {
+        calls++;
+        countsMatch = countsMatch && sensor.count == values.size();
+        points += values.size();
+        return false;
+    });
+    QCOMPARE(calls, 1);
+    QVERIFY(countsMatch);
+    QCOMPARE(stats.sensorsMatched, 1);
+    QCOMPARE(stats.pointCount, quint64(points));
+}
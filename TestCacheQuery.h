@@ -0,0 +1,31 @@
+#ifndef TESTCACHEQUERY_H
+#define TESTCACHEQUERY_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "CacheQuery.h"
+#include "DataStorage.h"
+#include "DataStructures.h"
+
+class TestCacheQuery : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+    DataStorage* storage = nullptr;
+
+    SensorData createHourlySeries(const QString& key, const QDateTime& start, int hours);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void collect_FiltersByProvinceAndParameter();
+    void collect_TimeRangePrunesSeries();
+    void collect_SensorWithoutMetadataUsesDataKey();
+    void stream_StopsWhenCallbackReturnsFalse();
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include "testdataanalyzer.h"
 #include <limits>
+#include <random>
+#include <algorithm>
+#include <numeric>
 
 std::vector<MeasurementValue> TestDataAnalyzer::createTestData(const std::vector<double>& values, const QDateTime& startTime, int stepSeconds) {
     std::vector<MeasurementValue> data;
@@ -145,3 +148,441 @@ void TestDataAnalyzer::analyze_DataWithZeroVariance()
     QCOMPARE(result.trend, AnalysisResult::STABLE);
     QVERIFY(std::abs(result.trendSlope) < 1e-9);
 }
+
+
+// Testy statystyk w oknach kroczących
+
+void TestDataAnalyzer::rollingMean_TrailingWindow()
+{
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    std::vector<MeasurementValue> values = createTestData({1.0, 2.0, 3.0, 4.0, 5.0}, start);
+    std::vector<MeasurementValue> result = analyzer.rollingMean(values, 3);
+
+    QCOMPARE(result.size(), size_t(5));
+    QCOMPARE(result[0].value, 1.0);
+    QCOMPARE(result[1].value, 1.5);
+    QCOMPARE(result[2].value, 2.0);
+    QCOMPARE(result[3].value, 3.0);
+    QCOMPARE(result[4].value, 4.0);
+    QCOMPARE(result[4].date, start.addSecs(4 * 3600));
+}
+
+void TestDataAnalyzer::rollingMean_MinValidCount()
+{
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    std::vector<MeasurementValue> values = createTestData({10.0, nan, nan, 20.0, 30.0, 40.0}, start);
+    std::vector<MeasurementValue> result = analyzer.rollingMean(values, 3, 2);
+
+    // Okna kończące się o 0:00 i 3:00 mają mniej niż 2 ważne pomiary.
+    QCOMPARE(result.size(), size_t(2));
+    QCOMPARE(result[0].date, start.addSecs(4 * 3600));
+    QCOMPARE(result[0].value, 25.0);
+    QCOMPARE(result[1].value, 30.0);
+}
+
+void TestDataAnalyzer::rollingMean_DescendingInput()
+{
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    std::vector<MeasurementValue> values = createTestData({1.0, 2.0, 3.0, 4.0}, start);
+    std::vector<MeasurementValue> reversed(values.rbegin(), values.rend());
+
+    std::vector<MeasurementValue> expected = analyzer.rollingMean(values, 2);
+    std::vector<MeasurementValue> result = analyzer.rollingMean(reversed, 2);
+
+    QCOMPARE(result.size(), expected.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        QCOMPARE(result[i].date, expected[i].date);
+        QCOMPARE(result[i].value, expected[i].value);
+    }
+}
+
+void TestDataAnalyzer::rollingMax_WindowExpiry()
+{
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    std::vector<MeasurementValue> values = createTestData({5.0, 1.0, 3.0, 2.0, 0.0, 4.0}, start);
+    std::vector<MeasurementValue> result = analyzer.rollingMax(values, 3);
+
+    QCOMPARE(result.size(), size_t(6));
+    QCOMPARE(result[0].value, 5.0);
+    QCOMPARE(result[1].value, 5.0);
+    QCOMPARE(result[2].value, 5.0);
+    QCOMPARE(result[3].value, 3.0);
+    QCOMPARE(result[4].value, 3.0);
+    QCOMPARE(result[5].value, 4.0);
+
+    QVERIFY(analyzer.rollingMax(values, 0).empty());
+}
+
+void TestDataAnalyzer::dailyMeans_ExceedanceDays()
+{
+    // Trzy doby pomiarów godzinowych PM10: średnie 40, 60 i 55; ostatnia doba niekompletna (12 h).
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    std::vector<double> raw;
+    for (int h = 0; h < 24; ++h) raw.push_back(40.0);
+    for (int h = 0; h < 24; ++h) raw.push_back(h % 2 == 0 ? 50.0 : 70.0);
+    for (int h = 0; h < 12; ++h) raw.push_back(55.0);
+    std::vector<MeasurementValue> values = createTestData(raw, start);
+
+    std::vector<MeasurementValue> daily = analyzer.dailyMeans(values);
+    QCOMPARE(daily.size(), size_t(3));
+    QCOMPARE(daily[0].date, start);
+    QCOMPARE(daily[0].value, 40.0);
+    QCOMPARE(daily[1].value, 60.0);
+    QCOMPARE(analyzer.countExceedances(daily, 50.0), 2);
+
+    std::vector<MeasurementValue> complete = analyzer.dailyMeans(values, 18);
+    QCOMPARE(complete.size(), size_t(2));
+    QCOMPARE(analyzer.countExceedances(complete, 50.0), 1);
+}
+
+void TestDataAnalyzer::dailyMaxima_Ozone8hMean()
+{
+    // Jeden pik 8 godzin po 130 µg/m³ przy tle 60 µg/m³ - dokładnie jedno okno 8h ma średnią 130.
+    QDateTime start(QDate(2024, 7, 1), QTime(0, 0));
+    std::vector<double> raw(48, 60.0);
+    for (int h = 8; h < 16; ++h) raw[h] = 130.0;
+    std::vector<MeasurementValue> values = createTestData(raw, start);
+
+    std::vector<MeasurementValue> eightHour = analyzer.rollingMean(values, 8, 6);
+    std::vector<MeasurementValue> dailyMax = analyzer.dailyMaxima(eightHour);
+
+    QCOMPARE(dailyMax.size(), size_t(2));
+    QCOMPARE(dailyMax[0].value, 130.0);
+    QCOMPARE(dailyMax[1].value, 60.0);
+    QCOMPARE(analyzer.countExceedances(dailyMax, 120.0), 1);
+}
+
+
+// Testy percentyli i szkiców kwantyli
+
+void TestDataAnalyzer::analyze_Percentiles()
+{
+    std::vector<double> raw;
+    for (int i = 1; i <= 100; ++i) raw.push_back(i);
+    std::vector<MeasurementValue> values = createTestData(raw, QDateTime(QDate(2024, 1, 1), QTime(0, 0)));
+    AnalysisResult result = analyzer.analyze(values);
+
+    QVERIFY(result.p50.has_value());
+    QCOMPARE(*result.p50, 50.0);
+    QCOMPARE(*result.p90, 90.0);
+    QCOMPARE(*result.p98, 98.0);
+
+    AnalysisResult empty = analyzer.analyze({});
+    QVERIFY(!empty.p50.has_value());
+}
+
+void TestDataAnalyzer::seriesSketch_IncrementalUpdate()
+{
+    DataAnalyzer localAnalyzer;
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    QVERIFY(localAnalyzer.seriesSketch(1) == nullptr);
+
+    // Drugie wywołanie zawiera te same 3 godziny co pierwsze plus 2 nowe - dopisane mają być tylko nowe.
+    localAnalyzer.updateSeriesSketch(1, createTestData({1.0, 2.0, 3.0}, start));
+    localAnalyzer.updateSeriesSketch(1, createTestData({1.0, 2.0, 3.0, 4.0, 5.0}, start));
+
+    const QuantileSketch* sketch = localAnalyzer.seriesSketch(1);
+    QVERIFY(sketch != nullptr);
+    QCOMPARE(sketch->count(), quint64(5));
+    QCOMPARE(sketch->max(), 5.0);
+
+    localAnalyzer.removeSeriesSketch(1);
+    QVERIFY(localAnalyzer.seriesSketch(1) == nullptr);
+}
+
+void TestDataAnalyzer::mergedSketch_CombinesSeries()
+{
+    DataAnalyzer localAnalyzer;
+    QDateTime start(QDate(2024, 1, 1), QTime(0, 0));
+    localAnalyzer.updateSeriesSketch(1, createTestData({10.0, 20.0}, start));
+    localAnalyzer.updateSeriesSketch(2, createTestData({30.0, 40.0}, start));
+    localAnalyzer.updateSeriesSketch(3, createTestData({1000.0}, start));
+
+    QuantileSketch merged = localAnalyzer.mergedSketch({1, 2, 99});
+    QCOMPARE(merged.count(), quint64(4));
+    QCOMPARE(merged.min(), 10.0);
+    QCOMPARE(merged.max(), 40.0);
+    QCOMPARE(merged.quantile(0.5), 20.0);
+}
+
+
+// Testy odpornego trendu (Theil-Sen, Mann-Kendall)
+
+void TestDataAnalyzer::analyze_TheilSenIgnoresSpike()
+{
+    // Spadek o 1 na godzinę i jeden pik na końcu - regresja liniowa wskazuje wzrost.
+    std::vector<double> raw;
+    for (int i = 0; i < 24; ++i) raw.push_back(50.0 - i);
+    raw.back() = 500.0;
+    std::vector<MeasurementValue> values = createTestData(raw, QDateTime(QDate(2024, 1, 1), QTime(0, 0)));
+
+    AnalysisResult leastSquares = analyzer.analyze(values);
+    QCOMPARE(leastSquares.trend, AnalysisResult::INCREASING);
+    QVERIFY(!leastSquares.trendPValue.has_value());
+
+    DataAnalyzer robustAnalyzer;
+    AnalyzerOptions options;
+    options.trendMethod = TrendMethod::TheilSen;
+    robustAnalyzer.setOptions(options);
+    AnalysisResult robust = robustAnalyzer.analyze(values);
+
+    QCOMPARE(robust.trend, AnalysisResult::DECREASING);
+    QVERIFY(qFuzzyCompare(robust.trendSlope, -1.0 / 3600.0));
+    QVERIFY(robust.trendPValue.has_value());
+    QVERIFY(*robust.trendPValue < 0.05);
+}
+
+void TestDataAnalyzer::analyze_TheilSenInsignificantTrendIsStable()
+{
+    DataAnalyzer robustAnalyzer;
+    AnalyzerOptions options;
+    options.trendMethod = TrendMethod::TheilSen;
+    robustAnalyzer.setOptions(options);
+
+    std::vector<MeasurementValue> values = createTestData({10.0, 12.0, 9.0, 11.0, 10.0, 12.0, 9.0, 11.0},
+                                                          QDateTime(QDate(2024, 1, 1), QTime(0, 0)));
+    AnalysisResult result = robustAnalyzer.analyze(values);
+
+    QCOMPARE(result.trend, AnalysisResult::STABLE);
+    QVERIFY(*result.trendPValue > 0.05);
+}
+
+void TestDataAnalyzer::theilSen_MatchesNaiveMedian()
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 5.0);
+
+    for (int n : {2, 3, 10, 57, 300}) {
+        std::vector<double> x(n), y(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = i * 3600.0;
+            y[i] = 40.0 - 2e-4 * x[i] + noise(rng);
+        }
+        std::shuffle(x.begin(), x.end(), rng);
+
+        std::vector<double> slopes;
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                slopes.push_back((y[j] - y[i]) / (x[j] - x[i]));
+            }
+        }
+        std::sort(slopes.begin(), slopes.end());
+        size_t m = slopes.size();
+        double expected = (m % 2 == 1) ? slopes[m / 2] : (slopes[m / 2 - 1] + slopes[m / 2]) / 2.0;
+
+        QCOMPARE(TrendEstimator::theilSenSlope(x, y), expected);
+    }
+}
+
+void TestDataAnalyzer::mannKendall_KnownValues()
+{
+    MannKendallResult increasing = TrendEstimator::mannKendall({1.0, 2.0, 3.0, 4.0, 5.0});
+    QCOMPARE(increasing.s, 10.0);
+    QVERIFY(qFuzzyCompare(increasing.variance, 50.0 / 3.0));
+    QCOMPARE(increasing.tau, 1.0);
+    QVERIFY(std::abs(increasing.pValue - 0.0275) < 1e-3);
+
+    // Remisy zmniejszają wariancję: n = 4, jedna grupa 2 równych wartości -> (4·3·13 - 2·1·9) / 18.
+    MannKendallResult ties = TrendEstimator::mannKendall({1.0, 1.0, 2.0, 0.0});
+    QCOMPARE(ties.s, -1.0);
+    QVERIFY(qFuzzyCompare(ties.variance, 138.0 / 18.0));
+    QCOMPARE(ties.z, 0.0);
+    QCOMPARE(ties.pValue, 1.0);
+}
+
+void TestDataAnalyzer::benchmark_TheilSen100k()
+{
+    const int n = 100000;
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(0.0, 5.0);
+    std::vector<double> x(n), y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = i * 3600.0;
+        y[i] = 30.0 + 2e-6 * x[i] + noise(rng);
+        if (i % 1000 == 0) y[i] = 500.0;
+    }
+
+    double slope = 0.0;
+    QBENCHMARK {
+        slope = TrendEstimator::theilSenSlope(x, y);
+    }
+    QVERIFY(std::abs(slope - 2e-6) < 1e-8);
+}
+
+void TestDataAnalyzer::benchmark_MannKendall100k()
+{
+    const int n = 100000;
+    std::mt19937 rng(13);
+    std::normal_distribution<double> noise(0.0, 5.0);
+    std::vector<double> y(n);
+    for (int i = 0; i < n; ++i) {
+        y[i] = 30.0 + 1e-4 * i + noise(rng);
+    }
+
+    MannKendallResult result;
+    QBENCHMARK {
+        result = TrendEstimator::mannKendall(y);
+    }
+    QVERIFY(result.z > 0.0);
+    QVERIFY(result.pValue < 0.05);
+}
+
+// Testy macierzy korelacji
+
+void TestDataAnalyzer::correlation_PerfectAndInverse()
+{
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    std::vector<ResampledSeries> series = TimeSeriesResampler::align({
+        createTestData({1.0, 2.0, 4.0, 3.0, 5.0}, start),
+        createTestData({12.0, 14.0, 18.0, 16.0, 20.0}, start), // 2x + 10
+        createTestData({5.0, 4.0, 2.0, 3.0, 1.0}, start),      // 6 - x
+        createTestData({7.0, 7.0, 7.0, 7.0, 7.0}, start),      // stała
+    });
+
+    CorrelationMatrix m = analyzer.correlationMatrix(series);
+    QCOMPARE(m.size, size_t(4));
+    QCOMPARE(m.at(0, 0), 1.0);
+    QVERIFY(std::abs(m.at(0, 1) - 1.0) < 1e-12);
+    QVERIFY(std::abs(m.at(0, 2) + 1.0) < 1e-12);
+    QCOMPARE(m.at(1, 2), m.at(2, 1));
+    QVERIFY(std::isnan(m.at(0, 3))); // korelacja ze stałą serią jest nieokreślona
+    QCOMPARE(m.pairCount(0, 3), 5);
+}
+
+void TestDataAnalyzer::correlation_PairwiseMissingValues()
+{
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<ResampledSeries> series = TimeSeriesResampler::align({
+        createTestData({1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, start),
+        createTestData({2.0, nan, 6.0, 8.0, nan, 12.0}, start),
+        createTestData({nan, nan, nan, nan, 1.0, 2.0}, start),
+    });
+
+    CorrelationMatrix m = analyzer.correlationMatrix(series);
+    QCOMPARE(m.pairCount(0, 1), 4);
+    QVERIFY(std::abs(m.at(0, 1) - 1.0) < 1e-12); // liczona tylko z kroków, w których obie serie mają wartość
+    QCOMPARE(m.pairCount(1, 2), 1);
+    QVERIFY(std::isnan(m.at(1, 2)));           // poniżej minPairs
+    QCOMPARE(m.pairCount(0, 2), 2);
+    QVERIFY(std::isnan(m.at(0, 2)));
+}
+
+void TestDataAnalyzer::correlation_SpearmanMonotonic()
+{
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    std::vector<ResampledSeries> series = TimeSeriesResampler::align({
+        createTestData({1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, start),
+        createTestData({1.0, 8.0, 27.0, 64.0, 125.0, 1000.0}, start), // zależność monotoniczna, nieliniowa
+    });
+
+    CorrelationOptions options;
+    options.method = CorrelationMethod::Spearman;
+    CorrelationMatrix spearman = analyzer.correlationMatrix(series, options);
+    QVERIFY(std::abs(spearman.at(0, 1) - 1.0) < 1e-12);
+
+    CorrelationMatrix pearson = analyzer.correlationMatrix(series);
+    QVERIFY(pearson.at(0, 1) < 0.95);
+}
+
+void TestDataAnalyzer::correlation_MisalignedSeriesRejected()
+{
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    std::vector<ResampledSeries> series = {
+        TimeSeriesResampler::resample(createTestData({1.0, 2.0, 3.0}, start)),
+        TimeSeriesResampler::resample(createTestData({1.0, 2.0, 3.0}, start.addSecs(3600))),
+    };
+    QVERIFY(analyzer.correlationMatrix(series).isEmpty());
+    QVERIFY(analyzer.correlationMatrix({}).isEmpty());
+}
+
+void TestDataAnalyzer::correlation_MatchesNaivePearson()
+{
+    // Ponad jeden blok serii (32) i jeden odcinek czasu (256), z losowymi brakami
+    const size_t seriesCount = 40;
+    const size_t steps = 300;
+    std::mt19937 rng(17);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<double> common(steps);
+    for (double& v : common) v = noise(rng);
+    std::vector<std::vector<double>> columns(seriesCount, std::vector<double>(steps));
+    for (size_t i = 0; i < seriesCount; ++i) {
+        for (size_t t = 0; t < steps; ++t) {
+            columns[i][t] = uniform(rng) < 0.1 ? std::numeric_limits<double>::quiet_NaN()
+                                               : 1000.0 + 40.0 * common[t] * (i % 2 ? 1.0 : -1.0) + 30.0 * noise(rng);
+        }
+    }
+
+    CorrelationOptions options;
+    options.maxThreadCount = 2;
+    CorrelationMatrix m = CorrelationMatrix::compute(columns, options);
+
+    for (size_t i = 0; i < seriesCount; ++i) {
+        for (size_t j = i + 1; j < seriesCount; ++j) {
+            std::vector<double> x, y;
+            for (size_t t = 0; t < steps; ++t) {
+                if (!std::isnan(columns[i][t]) && !std::isnan(columns[j][t])) {
+                    x.push_back(columns[i][t]);
+                    y.push_back(columns[j][t]);
+                }
+            }
+            const double mx = std::accumulate(x.begin(), x.end(), 0.0) / x.size();
+            const double my = std::accumulate(y.begin(), y.end(), 0.0) / y.size();
+            double cov = 0.0, vx = 0.0, vy = 0.0;
+            for (size_t k = 0; k < x.size(); ++k) {
+                cov += (x[k] - mx) * (y[k] - my);
+                vx += (x[k] - mx) * (x[k] - mx);
+                vy += (y[k] - my) * (y[k] - my);
+            }
+            QCOMPARE(m.pairCount(i, j), static_cast<int>(x.size()));
+            QVERIFY(std::abs(m.at(i, j) - cov / std::sqrt(vx * vy)) < 1e-10);
+        }
+    }
+}
+
+void TestDataAnalyzer::benchmark_Correlation300x720()
+{
+    const size_t seriesCount = 300;
+    const size_t steps = 720; // miesiąc danych godzinowych
+    std::mt19937 rng(19);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<std::vector<double>> columns(seriesCount, std::vector<double>(steps));
+    for (auto& column : columns) {
+        for (double& v : column) v = noise(rng);
+    }
+
+    CorrelationMatrix m;
+    QBENCHMARK {
+        m = CorrelationMatrix::compute(columns);
+    }
+    QCOMPARE(m.size, seriesCount);
+}
+
+void TestDataAnalyzer::seriesAnomalies_IncrementalUpdate()
+{
+    DataAnalyzer localAnalyzer;
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    std::vector<double> values;
+    for (int i = 0; i < 30; ++i) values.push_back(19.0 + i % 3);
+    values.push_back(250.0);
+    values.push_back(-1.0);
+    std::vector<MeasurementValue> data = createTestData(values, start);
+    std::reverse(data.begin(), data.end()); // API zwraca dane od najnowszych
+
+    std::vector<Anomaly> fresh = localAnalyzer.updateSeriesAnomalies(7, data);
+    QCOMPARE(fresh.size(), size_t(2));
+    QVERIFY(fresh[0].type == AnomalyType::Spike);
+    QVERIFY(fresh[1].type == AnomalyType::OutOfRange);
+
+    // Ponowne przesłanie tych samych danych z jedną nową godziną - stare pomiary nie są sprawdzane drugi raz
+    data.insert(data.begin(), MeasurementValue{start.addSecs(32 * 3600), 20.0});
+    QVERIFY(localAnalyzer.updateSeriesAnomalies(7, data).empty());
+    QCOMPARE(localAnalyzer.seriesAnomalies(7).size(), size_t(2));
+    QVERIFY(localAnalyzer.seriesAnomalies(8).empty());
+
+    localAnalyzer.clearSeriesAnomalies();
+    QVERIFY(localAnalyzer.seriesAnomalies(7).empty());
+}
@@ -29,6 +29,33 @@ private slots:
     void analyze_StableTrend_TwoPoints();
     void analyze_MixedDataWithNaN();
     void analyze_DataWithZeroVariance();
+
+    void rollingMean_TrailingWindow();
+    void rollingMean_MinValidCount();
+    void rollingMean_DescendingInput();
+    void rollingMax_WindowExpiry();
+    void dailyMeans_ExceedanceDays();
+    void dailyMaxima_Ozone8hMean();
+
+    void analyze_Percentiles();
+    void seriesSketch_IncrementalUpdate();
+    void mergedSketch_CombinesSeries();
+
+    void analyze_TheilSenIgnoresSpike();
+    void analyze_TheilSenInsignificantTrendIsStable();
+    void theilSen_MatchesNaiveMedian();
+    void mannKendall_KnownValues();
+    void benchmark_TheilSen100k();
+    void benchmark_MannKendall100k();
+
+    void correlation_PerfectAndInverse();
+    void correlation_PairwiseMissingValues();
+    void correlation_SpearmanMonotonic();
+    void correlation_MisalignedSeriesRejected();
+    void correlation_MatchesNaivePearson();
+    void benchmark_Correlation300x720();
+
+    void seriesAnomalies_IncrementalUpdate();
 };
 
 #endif
@@ -109,6 +109,25 @@ void TestDataParser::parseStations_MissingFields()
     }
 }
 
+void TestDataParser::parseStations_InternsRepeatedNames()
+{
+    QByteArray jsonData = R"(
+        [
+            { "id": 1, "stationName": "A", "city": { "id": 1, "name": "Warszawa",
+              "commune": { "communeName": "Warszawa", "districtName": "Warszawa", "provinceName": "MAZOWIECKIE" } } },
+            { "id": 2, "stationName": "B", "city": { "id": 2, "name": "Radom",
+              "commune": { "communeName": "Radom", "districtName": "Radom", "provinceName": "MAZOWIECKIE" } } }
+        ]
+    )";
+    std::vector<MeasuringStation> stations = parser.parseStations(jsonData);
+    QCOMPARE(stations.size(), size_t(2));
+
+    // Powtarzające się nazwy współdzielą jeden bufor z puli zamiast osobnych kopii
+    QCOMPARE(stations[0].city.commune.provinceName.constData(), stations[1].city.commune.provinceName.constData());
+    QCOMPARE(stations[0].city.name.constData(), stations[0].city.commune.communeName.constData());
+    QVERIFY(stations[0].city.name.constData() != stations[1].city.name.constData());
+}
+
 
 // Testy dla parseSensors
 
@@ -281,12 +300,11 @@ void TestDataParser::parseAirQualityIndex_ValidData()
     QCOMPARE(index.stationId, 555);
     QCOMPARE(index.stCalcDate, QDateTime::fromString("2024-05-10 14:00:00", "yyyy-MM-dd HH:mm:ss"));
     QCOMPARE(index.stSourceDataDate, QDateTime::fromString("2024-05-10 13:00:00", "yyyy-MM-dd HH:mm:ss"));
-    QCOMPARE(index.stIndexLevel.id, 1);
-    QCOMPARE(index.stIndexLevel.indexLevelName, QString("Dobry"));
-    QCOMPARE(index.pm25IndexLevel.id, 2);
-    QCOMPARE(index.pm25IndexLevel.indexLevelName, QString("Umiarkowany"));
-    QCOMPARE(index.so2IndexLevel.id, 0);
-    QCOMPARE(index.so2IndexLevel.indexLevelName, QString("Bardzo dobry"));
+    QCOMPARE(int(index.stIndexLevel), 1);
+    QCOMPARE(indexLevelName(index.stIndexLevel), QString("Dobry"));
+    QCOMPARE(index.level(Pollutant::PM25), 2);
+    QCOMPARE(indexLevelName(index.level(Pollutant::PM25)), QString("Umiarkowany"));
+    QCOMPARE(index.level(Pollutant::SO2), 0);
 }
 
 void TestDataParser::parseAirQualityIndex_MissingIndexLevels()
@@ -303,14 +321,11 @@ void TestDataParser::parseAirQualityIndex_MissingIndexLevels()
     )";
     AirQualityIndex index = parser.parseAirQualityIndex(jsonData);
     QCOMPARE(index.stationId, 556);
-    QCOMPARE(index.stIndexLevel.id, 2);
-    QCOMPARE(index.pm10IndexLevel.id, 2);
-    QCOMPARE(index.so2IndexLevel.id, -1);
-    QCOMPARE(index.so2IndexLevel.indexLevelName, QString("N/A"));
-    QCOMPARE(index.no2IndexLevel.id, -1);
-    QCOMPARE(index.no2IndexLevel.indexLevelName, QString("N/A"));
-    QCOMPARE(index.pm25IndexLevel.id, -1);
-    QCOMPARE(index.pm25IndexLevel.indexLevelName, QString("N/A"));
+    QCOMPARE(int(index.stIndexLevel), 2);
+    QCOMPARE(index.level(Pollutant::PM10), 2);
+    QCOMPARE(index.level(Pollutant::SO2), -1);
+    QCOMPARE(index.level(Pollutant::NO2), -1);
+    QCOMPARE(index.level(Pollutant::PM25), -1);
 }
 
 void TestDataParser::parseAirQualityIndex_NullIndexLevels()
@@ -327,11 +342,9 @@ void TestDataParser::parseAirQualityIndex_NullIndexLevels()
     )";
     AirQualityIndex index = parser.parseAirQualityIndex(jsonData);
     QCOMPARE(index.stationId, 557);
-    QCOMPARE(index.stIndexLevel.id, 0);
-    QCOMPARE(index.pm10IndexLevel.id, -1);
-    QCOMPARE(index.pm10IndexLevel.indexLevelName, QString("N/A"));
-    QCOMPARE(index.pm25IndexLevel.id, -1);
-    QCOMPARE(index.pm25IndexLevel.indexLevelName, QString("N/A"));
+    QCOMPARE(int(index.stIndexLevel), 0);
+    QCOMPARE(index.level(Pollutant::PM10), -1);
+    QCOMPARE(index.level(Pollutant::PM25), -1);
 }
 
 void TestDataParser::parseAirQualityIndex_NoDataOrInvalidId()
@@ -355,3 +368,74 @@ void TestDataParser::parseAirQualityIndex_MalformedJson()
     AirQualityIndex index = parser.parseAirQualityIndex(jsonData);
     QCOMPARE(index.stationId, -1);
 }
+
+
+// Testy dla parseCsvHeader i parseCsvRows
+
+void TestDataParser::parseCsvRows_LongLayout()
+{
+    CsvArchiveLayout layout = parser.parseCsvHeader("\xEF\xBB\xBFsensor_id,param,timestamp,value\r\n");
+    QVERIFY(layout.isValid());
+    QCOMPARE(layout.separator, ',');
+    QCOMPARE(layout.sensorIdColumn, 0);
+    QCOMPARE(layout.paramColumn, 1);
+    QCOMPARE(layout.timestampColumn, 2);
+    QCOMPARE(layout.valueColumn, 3);
+
+    std::map<int, SensorData> series;
+    // Wiersz rozdzielony między fragmenty pliku jest parsowany w całości w kolejnym wywołaniu.
+    int skipped = parser.parseCsvRows("5,PM10,2024-01-01T13:00:00Z,12.5\r\n"
+                                      "5,PM10,2024-01-01 14:00:00,\n"
+                                      "\n"
+                                      "7,\"NO2\",2024-01-01T13:00:00.250Z,3\n",
+                                      layout, series);
+    QCOMPARE(skipped, 0);
+    skipped = parser.parseCsvRows("x,PM10,2024-01-01T15:00:00Z,1\n"
+                                  "5,PM10,not a date,1\n"
+                                  "5,PM10\n"
+                                  "5,PM10,2024-01-01T15:00:00Z,14\n",
+                                  layout, series);
+    QCOMPARE(skipped, 3);
+
+    QCOMPARE(series.size(), std::size_t(2));
+    const SensorData& pm10 = series[5];
+    QCOMPARE(pm10.key, QString("PM10"));
+    QCOMPARE(pm10.values.size(), std::size_t(3));
+    QCOMPARE(pm10.values[0].date, QDateTime::fromString("2024-01-01T13:00:00Z", Qt::ISODate));
+    QCOMPARE(pm10.values[0].value, 12.5);
+    QCOMPARE(pm10.values[1].date, QDateTime::fromString("2024-01-01 14:00:00", "yyyy-MM-dd HH:mm:ss"));
+    QVERIFY(std::isnan(pm10.values[1].value));
+    QCOMPARE(pm10.values[2].value, 14.0);
+
+    const SensorData& no2 = series[7];
+    QCOMPARE(no2.key, QString("NO2"));
+    QCOMPARE(no2.values.size(), std::size_t(1));
+    QCOMPARE(no2.values[0].date.toMSecsSinceEpoch(),
+             QDateTime::fromString("2024-01-01T13:00:00Z", Qt::ISODate).toMSecsSinceEpoch() + 250);
+}
+
+void TestDataParser::parseCsvRows_WideLayoutWithSemicolons()
+{
+    CsvArchiveLayout layout = parser.parseCsvHeader("timestamp;PM2.5_12;NO2_7;comment");
+    QVERIFY(layout.isValid());
+    QCOMPARE(layout.separator, ';');
+    QCOMPARE(layout.sensorIdColumn, -1);
+    QCOMPARE(layout.sensorColumns.size(), std::size_t(4));
+    QCOMPARE(layout.sensorColumns[1].first, 12);
+    QCOMPARE(layout.sensorColumns[1].second, QString("PM2.5"));
+    QCOMPARE(layout.sensorColumns[3].first, -1);
+
+    std::map<int, SensorData> series;
+    const int skipped = parser.parseCsvRows("2024-01-01 01:00:00;12,5;;ok\n"
+                                            "2024-01-01 02:00:00;13;4,25;\n",
+                                            layout, series);
+    QCOMPARE(skipped, 0);
+    QCOMPARE(series[12].key, QString("PM2.5"));
+    QCOMPARE(series[12].values.size(), std::size_t(2));
+    QCOMPARE(series[12].values[0].value, 12.5); // przecinek dziesiętny
+    QCOMPARE(series[7].key, QString("NO2"));
+    QCOMPARE(series[7].values.size(), std::size_t(1)); // pusta komórka to brak pomiaru
+    QCOMPARE(series[7].values[0].value, 4.25);
+
+    QVERIFY(!parser.parseCsvHeader("date,station,level").isValid());
+}
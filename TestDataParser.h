@@ -20,6 +20,7 @@ private slots:
     void parseStations_EmptyArray();
     void parseStations_MalformedJson();
     void parseStations_MissingFields();
+    void parseStations_InternsRepeatedNames();
 
     // Testy dla parseSensors
     void parseSensors_ValidData();
@@ -39,6 +40,10 @@ private slots:
     void parseAirQualityIndex_NullIndexLevels();
     void parseAirQualityIndex_NoDataOrInvalidId();
     void parseAirQualityIndex_MalformedJson();
+
+    // Testy dla parseCsvHeader i parseCsvRows
+    void parseCsvRows_LongLayout();
+    void parseCsvRows_WideLayoutWithSemicolons();
 };
 
 #endif
@@ -0,0 +1,194 @@
+#include "TestDataRepository.h"
+#include "ApiCaptureStore.h"
+#include "DataParser.h"
+#include <QSignalSpy>
+
+namespace {
+
+const QByteArray SensorsJson = R"([
+    {"id": 101, "stationId": 50, "param": {"paramName": "Pył zawieszony PM10", "paramFormula": "PM10", "paramCode": "PM10", "idParam": 3}},
+    {"id": 102, "stationId": 50, "param": {"paramName": "Dwutlenek azotu", "paramFormula": "NO2", "paramCode": "NO2", "idParam": 6}}
+])";
+
+} // namespace
+
+bool TestDataRepository::addReplayResponse(const QString& replayDir, const QString& endpoint, const QByteArray& body) {
+    ApiResponse response;
+    response.httpStatus = 200;
+    response.reasonPhrase = "OK";
+    response.body = body;
+    return ApiCaptureStore(replayDir).save(endpoint, response);
+}
+
+SensorData TestDataRepository::hourlyData(const QStringList& hours, const std::vector<double>& values) {
+    SensorData data;
+    data.key = "PM10";
+    for (int i = 0; i < hours.size(); ++i) {
+        data.values.push_back({QDateTime::fromString("2024-05-10 " + hours.at(i), "yyyy-MM-dd HH:mm:ss"),
+                               values[static_cast<std::size_t>(i)]});
+    }
+    return data;
+}
+
+void TestDataRepository::initTestCase() {
+    QVERIFY(tempDir.isValid());
+}
+
+// Testy dla strategii stale-while-revalidate
+
+void TestDataRepository::requestSensorData_ServesCacheThenRefreshes() {
+    const QString replayDir = tempDir.path() + "/refresh_replay";
+    QVERIFY(addReplayResponse(replayDir, "/data/getData/1001", R"({"key": "PM10", "values": [
+        {"date": "2024-05-10 14:00:00", "value": 30.0},
+        {"date": "2024-05-10 13:00:00", "value": 25.0}
+    ]})"));
+    DataStorage storage(tempDir.path() + "/refresh_cache");
+    ApiService service;
+    service.setReplayDirectory(replayDir);
+    DataRepository repository(&service, &storage);
+    CachePolicy policy;
+    policy.sensorDataTtlSecs = 0; // dane w cache są zawsze nieaktualne
+    repository.setCachePolicy(policy);
+    QVERIFY(repository.saveSensorData(1001, hourlyData({"12:00:00", "13:00:00"}, {20.0, 22.0})));
+
+    std::vector<SensorData> emitted;
+    connect(&repository, &DataRepository::sensorDataReady, this, [&emitted](int, const SensorData& data) {
+        emitted.push_back(data);
+    });
+
+    repository.requestSensorData(1001);
+    QCOMPARE(emitted.size(), std::size_t(1)); // dane z cache - od razu, przed odpowiedzią API
+    QCOMPARE(emitted[0].values.size(), std::size_t(2));
+
+    // Scalanie z historią odbywa się w tle - wynik przychodzi po powrocie z requestSensorData()
+    QTRY_COMPARE_WITH_TIMEOUT(emitted.size(), std::size_t(2), 10000);
+    QVERIFY(repository.sensorDataCache().peek(1001) != nullptr);
+    QCOMPARE(repository.sensorDataCache().peek(1001)->values.size(), std::size_t(3));
+    // Odpowiedź API jest scalana z historią w cache: nowa godzina dopisana, 13:00 poprawiona
+    const SensorData& refreshed = emitted[1];
+    QCOMPARE(refreshed.values.size(), std::size_t(3));
+    const SensorData cached = storage.loadCachedSensorData(1001);
+    QCOMPARE(cached.values.size(), std::size_t(3));
+    bool corrected = false;
+    for (const MeasurementValue& mv : cached.values) {
+        corrected = corrected || (mv.date.time().hour() == 13 && mv.value == 25.0);
+    }
+    QVERIFY(corrected);
+}
+
+void TestDataRepository::requestSensors_FreshCacheSkipsFetch() {
+    DataStorage storage(tempDir.path() + "/fresh_cache");
+    ApiService service;
+    service.setReplayDirectory(tempDir.path() + "/fresh_replay"); // brak odpowiedzi - zapytanie skończyłoby się błędem
+    DataRepository repository(&service, &storage);
+    QVERIFY(storage.saveSensorsToJson(50, DataParser().parseSensors(SensorsJson)));
+
+    QSignalSpy readySpy(&repository, &DataRepository::sensorsReady);
+    QSignalSpy revalidationSpy(&repository, &DataRepository::revalidationFailed);
+    QSignalSpy errorSpy(&repository, &DataRepository::networkError);
+    QSignalSpy fetchSpy(&service, &ApiService::requestFailed);
+
+    repository.requestSensors(50);
+    QCOMPARE(readySpy.count(), 1);
+    QTest::qWait(200);
+    QCOMPARE(fetchSpy.count(), 0); // domyślny TTL czujników to doba - API nie jest odpytywane
+    QCOMPARE(revalidationSpy.count(), 0);
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(readySpy.count(), 1);
+}
+
+void TestDataRepository::requestSensorData_DuplicateRequestsFetchOnce() {
+    const QString replayDir = tempDir.path() + "/duplicate_replay";
+    QVERIFY(addReplayResponse(replayDir, "/data/getData/1002", R"({"key": "PM10", "values": [
+        {"date": "2024-05-10 14:00:00", "value": 30.0}
+    ]})"));
+    DataStorage storage(tempDir.path() + "/duplicate_cache");
+    ApiService service;
+    ReplayOptions slow;
+    slow.latencyMs = 300; // pierwsze zapytanie jest jeszcze w toku, gdy przychodzi drugie
+    service.setReplayDirectory(replayDir, slow);
+    DataRepository repository(&service, &storage);
+
+    QSignalSpy readySpy(&repository, &DataRepository::sensorDataReady);
+    QSignalSpy fetchedSpy(&service, &ApiService::sensorDataReady);
+
+    repository.requestSensorData(1002);
+    repository.requestSensorData(1002);
+    QTRY_COMPARE_WITH_TIMEOUT(readySpy.count(), 1, 10000);
+    QTest::qWait(500);
+    QCOMPARE(fetchedSpy.count(), 1);
+    QCOMPARE(readySpy.count(), 1);
+}
+
+void TestDataRepository::requestSensors_FailureWithCacheIsRevalidationFailed() {
+    DataStorage storage(tempDir.path() + "/failure_cache");
+    ApiService service;
+    service.setReplayDirectory(tempDir.path() + "/failure_replay"); // brak odpowiedzi - błąd jak przy braku sieci
+    DataRepository repository(&service, &storage);
+    CachePolicy policy;
+    policy.sensorsTtlSecs = 0;
+    repository.setCachePolicy(policy);
+    QVERIFY(storage.saveSensorsToJson(50, DataParser().parseSensors(SensorsJson)));
+
+    QSignalSpy readySpy(&repository, &DataRepository::sensorsReady);
+    QSignalSpy revalidationSpy(&repository, &DataRepository::revalidationFailed);
+    QSignalSpy errorSpy(&repository, &DataRepository::networkError);
+
+    // Użytkownik widzi już dane z cache - błąd odświeżania nie jest błędem sieci
+    repository.requestSensors(50);
+    QTRY_COMPARE_WITH_TIMEOUT(revalidationSpy.count(), 1, 10000);
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(readySpy.count(), 1);
+
+    // Bez danych w cache ten sam błąd jest zgłaszany jako networkError()
+    repository.requestSensors(51);
+    QTRY_COMPARE_WITH_TIMEOUT(errorSpy.count(), 1, 10000);
+    QCOMPARE(revalidationSpy.count(), 1);
+    QCOMPARE(readySpy.count(), 1);
+}
+
+void TestDataRepository::requestSensors_UnchangedApiDataNotEmittedTwice() {
+    const QString replayDir = tempDir.path() + "/unchanged_replay";
+    QVERIFY(addReplayResponse(replayDir, "/station/sensors/50", SensorsJson));
+    DataStorage storage(tempDir.path() + "/unchanged_cache");
+    ApiService service;
+    service.setReplayDirectory(replayDir);
+    DataRepository repository(&service, &storage);
+    CachePolicy policy;
+    policy.sensorsTtlSecs = 0;
+    repository.setCachePolicy(policy);
+    QVERIFY(storage.saveSensorsToJson(50, DataParser().parseSensors(SensorsJson)));
+
+    QSignalSpy readySpy(&repository, &DataRepository::sensorsReady);
+    QSignalSpy fetchedSpy(&service, &ApiService::sensorsReady);
+
+    repository.requestSensors(50);
+    QCOMPARE(readySpy.count(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(fetchedSpy.count(), 1, 10000);
+    QTest::qWait(200); // odpowiedź API trafia do repozytorium przez kolejkę zdarzeń
+    QCOMPARE(readySpy.count(), 1);
+    QCOMPARE(storage.loadSensorsFromJson(50).size(), std::size_t(2));
+}
+
+// Testy dla stanu modelu prognozy
+
+void TestDataRepository::forecastState_LoadsSavedStateOnly() {
+    DataStorage storage(tempDir.path() + "/forecast_cache");
+    ApiService service;
+    DataRepository repository(&service, &storage);
+
+    ForecastState missing = repository.loadForecastState(7);
+    QCOMPARE(missing.sensorId, 7);
+    QVERIFY(!missing.isInitialized());
+
+    ForecastState state;
+    state.sensorId = 7;
+    state.level = 12.5;
+    state.seasonal.assign(static_cast<std::size_t>(state.seasonLength), 0.5);
+    QVERIFY(repository.saveForecastState(state));
+
+    ForecastState loaded = repository.loadForecastState(7);
+    QCOMPARE(loaded.sensorId, 7);
+    QVERIFY(loaded.isInitialized());
+    QCOMPARE(loaded.level, 12.5);
+}
@@ -0,0 +1,36 @@
+#ifndef TESTDATAREPOSITORY_H
+#define TESTDATAREPOSITORY_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "ApiService.h"
+#include "DataRepository.h"
+#include "DataStorage.h"
+
+class TestDataRepository : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+
+    /// Zapisuje odpowiedź API (status 200) odtwarzaną przez ApiService::setReplayDirectory().
+    bool addReplayResponse(const QString& replayDir, const QString& endpoint, const QByteArray& body);
+    SensorData hourlyData(const QStringList& hours, const std::vector<double>& values);
+
+private slots:
+    void initTestCase();
+
+    // Testy dla strategii stale-while-revalidate
+    void requestSensorData_ServesCacheThenRefreshes();
+    void requestSensors_FreshCacheSkipsFetch();
+    void requestSensorData_DuplicateRequestsFetchOnce();
+    void requestSensors_FailureWithCacheIsRevalidationFailed();
+    void requestSensors_UnchangedApiDataNotEmittedTwice();
+
+    // Testy dla stanu modelu prognozy
+    void forecastState_LoadsSavedStateOnly();
+};
+
+#endif
@@ -1,8 +1,12 @@
 #include "testdatastorage.h"
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
+#include <QThread>
 #include <limits>
 #include <cmath>
+#include "SeriesCodec.h"
 
 TestDataStorage::TestDataStorage() {}
 
@@ -55,10 +59,10 @@ AirQualityIndex TestDataStorage::createTestAQI(int stationId) {
     aqi.stationId = stationId;
     aqi.stCalcDate = QDateTime::currentDateTime();
     aqi.stSourceDataDate = QDateTime::currentDateTime().addSecs(-600);
-    aqi.stIndexLevel = {1, "Dobry"};
-    aqi.pm10IndexLevel = {1, "Dobry"};
-    aqi.pm25IndexLevel = {2, "Umiarkowany"};
-    aqi.so2IndexLevel = {-1, "N/A"};
+    aqi.stIndexLevel = 1;
+    aqi.setLevel(Pollutant::PM10, 1);
+    aqi.setLevel(Pollutant::PM25, 2);
+    aqi.setLevel(Pollutant::SO2, NoIndexLevel);
     return aqi;
 }
 
@@ -262,6 +266,85 @@ void TestDataStorage::loadSensorData_NonExistentFile() {
 
 // Testy dla indeksu AQI
 
+void TestDataStorage::saveLoadSensorSeries_RoundTripAndRange() {
+    SensorData originalData = createTestSensorData("PM10");
+    QVERIFY(storage->saveSensorSeries(31, originalData));
+    QVERIFY(QFile::exists(tempDir.filePath(DataStorage::sensorSeriesFileName(31))));
+
+    SensorData loadedData = storage->loadSensorSeries(31);
+    QCOMPARE(loadedData.key, originalData.key);
+    QCOMPARE(loadedData.values.size(), originalData.values.size());
+    QCOMPARE(loadedData.values[0].date, originalData.values[0].date);
+    QCOMPARE(loadedData.values[0].value, 10.5);
+    QVERIFY(std::isnan(loadedData.values[1].value));
+
+    // Tylko pomiary z przedziału [from, to)
+    SensorData range = storage->loadSensorSeries(31, originalData.values[1].date, originalData.values[2].date);
+    QCOMPARE(range.values.size(), std::size_t(1));
+    QCOMPARE(range.values[0].date, originalData.values[1].date);
+
+    QVERIFY(!storage->saveSensorSeries(0, originalData));
+    QVERIFY(!storage->saveSensorSeries(32, SensorData()));
+    QVERIFY(storage->loadSensorSeries(33).key.isEmpty());
+}
+
+void TestDataStorage::loadCachedSensorData_PrefersSeriesOverJson() {
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("NO2"), DataStorage::sensorDataFileName(34)));
+    QCOMPARE(storage->loadCachedSensorData(34).key, QString("NO2")); // starszy cache JSON
+
+    QVERIFY(storage->saveSensorSeries(34, createTestSensorData("O3")));
+    QCOMPARE(storage->loadCachedSensorData(34).key, QString("O3"));
+    const std::vector<int> ids = storage->cachedSensorDataIds();
+    QCOMPARE(std::count(ids.begin(), ids.end(), 34), std::ptrdiff_t(1));
+}
+
+void TestDataStorage::mergeSensorSeries_KeepsHistoryAndAppliesPolicy() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    SensorData history;
+    history.key = "PM10";
+    for (int h = 0; h < 4; ++h) {
+        history.values.push_back({start.addSecs(h * 3600), h == 3 ? nan : 10.0 + h});
+    }
+    QVERIFY(storage->saveSensorSeries(35, history));
+
+    // Okno z API: poprawiona wartość, uzupełniony NaN, NaN zamiast wartości i nowa data (kolejność jak w API)
+    SensorData window;
+    window.key = "PM10";
+    window.values.push_back({start.addSecs(4 * 3600), 14.0});
+    window.values.push_back({start.addSecs(3 * 3600), 13.0});
+    window.values.push_back({start.addSecs(2 * 3600), nan});
+    window.values.push_back({start.addSecs(1 * 3600), 21.0});
+
+    SeriesMergeStats stats;
+    std::optional<SensorData> merged = storage->mergeSensorSeries(35, window, SeriesMergePolicy::PreferIncoming, &stats);
+    QVERIFY(merged.has_value());
+    QCOMPARE(stats.added, quint64(2));
+    QCOMPARE(stats.replaced, quint64(1));
+    QCOMPARE(stats.unchanged, quint64(1));
+    const SensorData loaded = storage->loadCachedSensorData(35);
+    QVERIFY(loaded == *merged);
+    const double expected[] = {10.0, 21.0, 12.0, 13.0, 14.0};
+    QCOMPARE(loaded.values.size(), std::size_t(5));
+    for (std::size_t i = 0; i < loaded.values.size(); ++i) {
+        QCOMPARE(loaded.values[i].date, start.addSecs(static_cast<qint64>(i) * 3600));
+        QCOMPARE(loaded.values[i].value, expected[i]);
+    }
+
+    // KeepExisting nie nadpisuje wartości; brak zmian - bez zapisu
+    SensorData archive;
+    archive.values.push_back({start, 99.0});
+    merged = storage->mergeSensorSeries(35, archive, SeriesMergePolicy::KeepExisting, &stats);
+    QVERIFY(merged.has_value());
+    QCOMPARE(stats.added + stats.replaced, quint64(0));
+    QCOMPARE(merged->values.front().value, 10.0);
+
+    // Inny parametr jest odrzucany
+    archive.key = "NO2";
+    QVERIFY(!storage->mergeSensorSeries(35, archive, SeriesMergePolicy::PreferIncoming).has_value());
+    QCOMPARE(storage->loadCachedSensorData(35).key, QString("PM10"));
+}
+
 void TestDataStorage::saveLoadAQI_ValidData() {
     int stationId = 222;
     AirQualityIndex originalAQI = createTestAQI(stationId);
@@ -271,11 +354,11 @@ void TestDataStorage::saveLoadAQI_ValidData() {
 
     QCOMPARE(loadedAQI.stationId, originalAQI.stationId);
     QCOMPARE(loadedAQI.stCalcDate, originalAQI.stCalcDate);
-    QCOMPARE(loadedAQI.stIndexLevel.id, originalAQI.stIndexLevel.id);
-    QCOMPARE(loadedAQI.stIndexLevel.indexLevelName, originalAQI.stIndexLevel.indexLevelName);
-    QCOMPARE(loadedAQI.pm10IndexLevel.id, originalAQI.pm10IndexLevel.id);
-    QCOMPARE(loadedAQI.so2IndexLevel.id, originalAQI.so2IndexLevel.id);
-    QCOMPARE(loadedAQI.so2IndexLevel.indexLevelName, originalAQI.so2IndexLevel.indexLevelName);
+    QCOMPARE(int(loadedAQI.stIndexLevel), int(originalAQI.stIndexLevel));
+    QCOMPARE(loadedAQI.level(Pollutant::PM10), 1);
+    QCOMPARE(loadedAQI.level(Pollutant::PM25), 2);
+    QCOMPARE(loadedAQI.level(Pollutant::SO2), NoIndexLevel);
+    QVERIFY(loadedAQI == originalAQI);
 }
 
 void TestDataStorage::saveAQI_InvalidOrMismatchedId() {
@@ -321,3 +404,646 @@ void TestDataStorage::loadAQI_MismatchedStationIdInFile() {
     AirQualityIndex loadedAQI = storage->loadAirQualityIndexFromJson(correctStationId);
     QCOMPARE(loadedAQI.stationId, -1);
 }
+
+void TestDataStorage::loadAQI_LegacyLevelObjects() {
+    // Pliki zapisane przed wprowadzeniem tablicy "levels" - poziomy jako obiekty {"id", "indexLevelName"}.
+    int stationId = 666;
+    QJsonObject legacy;
+    legacy["stationId"] = stationId;
+    legacy["stCalcDate"] = "2024-05-10T14:00:00.000";
+    legacy["stIndexLevel"] = QJsonObject{{"id", 3}, {"indexLevelName", "Dostateczny"}};
+    legacy["pm10IndexLevel"] = QJsonObject{{"id", 3}, {"indexLevelName", "Dostateczny"}};
+    legacy["o3IndexLevel"] = QJsonObject{{"id", -1}, {"indexLevelName", "N/A"}};
+    QFile file(tempDir.filePath(DataStorage::airQualityIndexFileName(stationId)));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(legacy).toJson());
+    file.close();
+
+    AirQualityIndex loadedAQI = storage->loadAirQualityIndexFromJson(stationId);
+    QCOMPARE(loadedAQI.stationId, stationId);
+    QCOMPARE(int(loadedAQI.stIndexLevel), 3);
+    QCOMPARE(loadedAQI.level(Pollutant::PM10), 3);
+    QCOMPARE(loadedAQI.level(Pollutant::O3), NoIndexLevel);
+    QCOMPARE(loadedAQI.level(Pollutant::NO2), NoIndexLevel);
+}
+
+void TestDataStorage::saveLoadForecastState_RoundTrip() {
+    ForecastState state;
+    state.sensorId = 321;
+    state.alpha = 0.25;
+    state.level = 42.5;
+    state.trend = -0.125;
+    state.seasonal = {1.5, -2.0, 0.5};
+    state.seasonLength = 3;
+    state.seasonIndex = 2;
+    state.lastStepMSecs = 1704067200000;
+    state.observationCount = 77;
+    // errorVariance pozostaje NaN - zapisywane jako null
+
+    QVERIFY(storage->saveForecastState(state));
+    ForecastState loaded = storage->loadForecastState(321);
+
+    QCOMPARE(loaded.sensorId, 321);
+    QCOMPARE(loaded.alpha, 0.25);
+    QCOMPARE(loaded.level, 42.5);
+    QCOMPARE(loaded.trend, -0.125);
+    QCOMPARE(loaded.seasonal, state.seasonal);
+    QCOMPARE(loaded.seasonLength, 3);
+    QCOMPARE(loaded.seasonIndex, 2);
+    QCOMPARE(loaded.lastStepMSecs, state.lastStepMSecs);
+    QCOMPARE(loaded.observationCount, quint64(77));
+    QVERIFY(std::isnan(loaded.errorVariance));
+
+    QVERIFY(!storage->saveForecastState(ForecastState())); // sensorId = -1
+}
+
+void TestDataStorage::loadForecastState_NonExistentFile() {
+    ForecastState loaded = storage->loadForecastState(99999);
+    QCOMPARE(loaded.sensorId, -1);
+    QVERIFY(!loaded.isInitialized());
+}
+
+void TestDataStorage::saveLoadAlertRules_RoundTrip() {
+    QVERIFY(storage->loadAlertRules("missing_rules.json").empty());
+
+    std::vector<AlertRule> rules = AlertEngine::defaultRules();
+    rules[0].id = 3;
+    rules[0].provinceName = "mazowieckie";
+    rules[0].enabled = false;
+    QVERIFY(storage->saveAlertRules(rules));
+
+    std::vector<AlertRule> loaded = storage->loadAlertRules();
+    QCOMPARE(loaded.size(), rules.size());
+    QCOMPARE(loaded[0].id, 3);
+    QCOMPARE(loaded[0].name, rules[0].name);
+    QCOMPARE(loaded[0].paramCode, QString("PM10"));
+    QCOMPARE(loaded[0].provinceName, QString("mazowieckie"));
+    QVERIFY(!loaded[0].enabled);
+    QCOMPARE(loaded[0].windowHours, 24);
+    QCOMPARE(loaded[0].threshold, 50.0);
+    QCOMPARE(loaded[0].clearThreshold, 45.0);
+    QVERIFY(loaded[2].source == AlertSource::AirQualityIndex);
+    QVERIFY(loaded[2].comparison == AlertComparison::GreaterOrEqual);
+    QVERIFY(std::isnan(loaded[2].clearThreshold));
+}
+
+void TestDataStorage::loadAlertRules_ClampsClearThreshold() {
+    std::vector<AlertRule> rules = AlertEngine::defaultRules();
+    rules[0].clearThreshold = 60.0; // powyżej progu 50 - plik edytowany ręcznie
+    QVERIFY(storage->saveAlertRules(rules));
+
+    std::vector<AlertRule> loaded = storage->loadAlertRules();
+    QCOMPARE(loaded.size(), rules.size());
+    QCOMPARE(loaded[0].clearThreshold, 50.0);
+    QCOMPARE(loaded[1].clearThreshold, 22.5);
+}
+
+void TestDataStorage::saveLoadAlertProgress_RoundTrip() {
+    QVERIFY(storage->loadAlertProgress().sensors.isEmpty());
+
+    AlertProgress progress;
+    progress.sensors.insert(52, Q_INT64_C(1704067200000));
+    progress.stations.insert(114, Q_INT64_C(1704070800000));
+    QVERIFY(storage->saveAlertProgress(progress));
+
+    AlertProgress loaded = storage->loadAlertProgress();
+    QCOMPARE(loaded.sensors.size(), 1);
+    QCOMPARE(loaded.sensors.value(52), Q_INT64_C(1704067200000));
+    QCOMPARE(loaded.stations.size(), 1);
+    QCOMPARE(loaded.stations.value(114), Q_INT64_C(1704070800000));
+}
+
+void TestDataStorage::cachedIds_ListsSavedFiles() {
+    QTemporaryDir listDir;
+    QVERIFY(listDir.isValid());
+    DataStorage listStorage(listDir.path());
+
+    QVERIFY(listStorage.cachedSensorDataIds().empty());
+
+    SensorData data = createTestSensorData("PM10");
+    QVERIFY(listStorage.saveSensorDataToJson(data, DataStorage::sensorDataFileName(52)));
+    QVERIFY(listStorage.saveSensorDataToJson(data, DataStorage::sensorDataFileName(7)));
+    QVERIFY(listStorage.saveSensorDataToJson(data, "sensor_abc_data.json")); // nie jest ID - pomijany
+    QVERIFY(listStorage.saveSensorSeries(52, data));
+    QVERIFY(listStorage.saveSensorSeries(9, data));
+    QVERIFY(listStorage.saveSensorsToJson(300, createTestSensors(300)));
+
+    QCOMPARE(listStorage.cachedSensorDataIds(), std::vector<int>({7, 9, 52}));
+    QCOMPARE(listStorage.cachedSensorsStationIds(), std::vector<int>({300}));
+}
+
+void TestDataStorage::checksum_KnownValue() {
+    QCOMPARE(DataStorage::checksum(QByteArray("123456789")), quint32(0xCBF43926)); // wektor testowy CRC-32
+    QCOMPARE(DataStorage::checksum(QByteArray()), quint32(0));
+}
+
+void TestDataStorage::save_ReplacesFileWithoutTemporaryFiles() {
+    QTemporaryDir saveDir;
+    QVERIFY(saveDir.isValid());
+    DataStorage saveStorage(saveDir.path());
+
+    SensorData first = createTestSensorData("PM10");
+    SensorData second = createTestSensorData("NO2");
+    QString filename = DataStorage::sensorDataFileName(11);
+    QVERIFY(saveStorage.saveSensorDataToJson(first, filename));
+    QVERIFY(saveStorage.saveSensorDataToJson(second, filename));
+    QStringList files = QDir(saveDir.path()).entryList(QDir::Files | QDir::NoDotAndDotDot);
+    files.removeAll(CacheManifest::fileName());
+    files.removeAll(CacheManifest::journalFileName());
+    QCOMPARE(files, QStringList() << filename);
+    QCOMPARE(saveStorage.loadSensorDataFromJson(filename).key, QString("NO2"));
+
+    QFile file(saveDir.filePath(filename));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll().contains("#crc32:"));
+    file.close();
+
+    // Bez stopki plik jest zwykłym JSON-em i nadal się wczytuje
+    saveStorage.setChecksumsEnabled(false);
+    QVERIFY(saveStorage.saveSensorDataToJson(first, filename));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(!file.readAll().contains("#crc32:"));
+    file.close();
+    QCOMPARE(saveStorage.loadSensorDataFromJson(filename).key, QString("PM10"));
+}
+
+void TestDataStorage::loadSensorData_CorruptedFileIsRemoved() {
+    QString filename = DataStorage::sensorDataFileName(12);
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("PM10"), filename));
+
+    QFile file(tempDir.filePath(filename));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray content = file.readAll();
+    int pos = content.indexOf("PM10");
+    QVERIFY(pos > 0);
+    content[pos] = 'X'; // uszkodzenie danych przy zachowaniu poprawnego JSON-a
+    file.seek(0);
+    file.write(content);
+    file.close();
+
+    SensorData loaded = storage->loadSensorDataFromJson(filename);
+    QVERIFY(loaded.key.isEmpty());
+    QVERIFY(!QFile::exists(tempDir.filePath(filename))); // usunięty - DataRepository pobierze dane ponownie
+    QVERIFY(QFile::exists(tempDir.filePath(filename + ".corrupt"))); // odłożony, nie skasowany przy odczycie
+    QVERIFY(!storage->lastFetchTime(filename).isValid());
+
+    // Ponowny zapis i compact() usuwają odłożoną kopię, a nowy plik jest czytelny
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("PM10"), filename));
+    QCOMPARE(storage->loadSensorDataFromJson(filename).key, QString("PM10"));
+    RetentionPolicy keepAll;
+    QVERIFY(storage->compact(keepAll).filesRemoved >= 1);
+    QVERIFY(!QFile::exists(tempDir.filePath(filename + ".corrupt")));
+    QVERIFY(QFile::exists(tempDir.filePath(filename)));
+}
+
+void TestDataStorage::writeBehind_LoadSeesQueuedWrites() {
+    QTemporaryDir queueDir;
+    QVERIFY(queueDir.isValid());
+    QString filename = DataStorage::sensorDataFileName(21);
+    {
+        DataStorage queueStorage(queueDir.path());
+        queueStorage.setWriteBehindEnabled(true, 1000);
+        QVERIFY(queueStorage.writeBehindEnabled());
+
+        QVERIFY(queueStorage.saveSensorDataToJson(createTestSensorData("PM10"), filename));
+        QVERIFY(queueStorage.saveSensorDataToJson(createTestSensorData("NO2"), filename));
+        QVERIFY(queueStorage.saveStationsToJson(createTestStations(3)));
+        QVERIFY(!queueStorage.saveSensorDataToJson(SensorData(), filename)); // walidacja nadal w wątku wywołującym
+
+        // Odczyt czeka na zaległy zapis pliku, nie na koniec okna zbierania partii
+        QCOMPARE(queueStorage.loadSensorDataFromJson(filename).key, QString("NO2"));
+        QVERIFY(queueStorage.cachedSensorDataIds() == std::vector<int>{21});
+        QVERIFY(queueStorage.flush());
+        QCOMPARE(queueStorage.writeBehindStats().coalesced, quint64(1));
+
+        // Zapis zlecony tuż przed zniszczeniem obiektu trafia na dysk
+        QVERIFY(queueStorage.saveSensorsToJson(5, createTestSensors(5)));
+    }
+    DataStorage reopened(queueDir.path());
+    QCOMPARE(reopened.loadSensorsFromJson(5).size(), std::size_t(3));
+    QCOMPARE(reopened.loadStationsFromJson().size(), std::size_t(3));
+}
+
+void TestDataStorage::writeBehind_QueuesAqiHistoryAppends() {
+    QTemporaryDir queueDir;
+    QVERIFY(queueDir.isValid());
+    DataStorage queueStorage(queueDir.path());
+    queueStorage.setWriteBehindEnabled(true, 1000);
+    const QDateTime start = QDateTime::currentDateTime().addDays(-1);
+
+    // Kolejne indeksy przed zapisem są scalane w jedno zlecenie, ale żaden nie ginie
+    for (int i = 0; i < 5; ++i) {
+        AirQualityIndex index = createTestAQI(8);
+        index.stCalcDate = start.addSecs(3600LL * i);
+        QVERIFY(queueStorage.appendAirQualityIndexHistory(index));
+    }
+    QVERIFY(!queueStorage.appendAirQualityIndexHistory(AirQualityIndex()));
+
+    // Odczyt historii czeka na zaległe dopisania
+    QCOMPARE(queueStorage.airQualityIndexHistory().count(8), qint64(5));
+    QVERIFY(queueStorage.writeBehindStats().coalesced > 0);
+    QCOMPARE(queueStorage.airQualityIndexHistory().latest(8).stCalcDate, start.addSecs(4 * 3600));
+}
+
+void TestDataStorage::cacheManifest_TracksSavesAndRemovals() {
+    QTemporaryDir manifestDir;
+    QVERIFY(manifestDir.isValid());
+    {
+        DataStorage manifestStorage(manifestDir.path());
+        manifestStorage.setWriteBehindEnabled(true, 1000);
+        QCOMPARE(manifestStorage.cacheManifest().size(), 0);
+
+        SensorData data = createTestSensorData("PM10");
+        QVERIFY(manifestStorage.saveSensorSeries(31, data));
+        QVERIFY(manifestStorage.saveSensorDataToJson(data, DataStorage::sensorDataFileName(32)));
+        QVERIFY(manifestStorage.saveSensorsToJson(400, createTestSensors(400)));
+
+        // Wpisy zaległych zapisów są widoczne po cacheManifest()
+        const CacheManifest& manifest = manifestStorage.cacheManifest();
+        QCOMPARE(manifest.size(), 3);
+        std::optional<CacheEntry> series = manifest.entry(DataStorage::sensorSeriesFileName(31));
+        QVERIFY(series.has_value());
+        QCOMPARE(int(series->type), int(CacheEntityType::SensorSeries));
+        QCOMPARE(series->id, 31);
+        QCOMPARE(series->size, QFileInfo(manifestDir.filePath(series->fileName)).size());
+        QCOMPARE(series->formatVersion, int(SeriesCodec::FormatVersion));
+        QCOMPARE(series->firstDate, data.values.front().date);
+        QCOMPARE(series->lastDate, data.values.back().date);
+        QVERIFY(series->lastFetch.isValid());
+
+        std::vector<CacheEntry> sensors = manifest.entries(CacheEntityType::Sensors);
+        QCOMPARE(sensors.size(), std::size_t(1));
+        QCOMPARE(sensors[0].id, 400);
+        QVERIFY(!sensors[0].firstDate.isValid());
+
+        // Plik usunięty poza DataStorage znika z katalogu przy próbie odczytu
+        QVERIFY(QFile::remove(manifestDir.filePath(DataStorage::sensorDataFileName(32))));
+        QVERIFY(manifestStorage.loadSensorDataFromJson(DataStorage::sensorDataFileName(32)).key.isEmpty());
+        QVERIFY(!manifest.entry(DataStorage::sensorDataFileName(32)).has_value());
+    }
+    DataStorage reopened(manifestDir.path());
+    QCOMPARE(reopened.cacheManifest().size(), 2);
+    QCOMPARE(reopened.cacheManifest().entries(CacheEntityType::SensorSeries)[0].id, 31);
+}
+
+void TestDataStorage::cacheManifest_RebuiltFromExistingFiles() {
+    QTemporaryDir rebuildDir;
+    QVERIFY(rebuildDir.isValid());
+    CacheEntry savedSeries;
+    {
+        DataStorage first(rebuildDir.path());
+        QVERIFY(first.saveSensorSeries(8, createTestSensorData("NO2")));
+        QVERIFY(first.saveStationsToJson(createTestStations(2)));
+        savedSeries = *first.cacheManifest().entry(DataStorage::sensorSeriesFileName(8));
+    }
+    // Brak pliku katalogu (np. dane sprzed wprowadzenia katalogu) - odbudowa z plików
+    QFile::remove(rebuildDir.filePath(CacheManifest::fileName()));
+    QFile::remove(rebuildDir.filePath(CacheManifest::journalFileName()));
+
+    DataStorage rebuilt(rebuildDir.path());
+    const CacheManifest& manifest = rebuilt.cacheManifest();
+    QCOMPARE(manifest.size(), 2);
+    QVERIFY(QFile::exists(rebuildDir.filePath(CacheManifest::fileName())));
+    std::optional<CacheEntry> series = manifest.entry(DataStorage::sensorSeriesFileName(8));
+    QVERIFY(series.has_value());
+    QCOMPARE(series->checksum, savedSeries.checksum);
+    QCOMPARE(series->size, savedSeries.size);
+    QCOMPARE(series->firstDate, savedSeries.firstDate);
+    QCOMPARE(series->lastDate, savedSeries.lastDate);
+    QCOMPARE(int(manifest.entry(DataStorage::stationsFileName())->type), int(CacheEntityType::Stations));
+    QCOMPARE(manifest.totalSize(), savedSeries.size + QFileInfo(rebuildDir.filePath(DataStorage::stationsFileName())).size());
+}
+
+void TestDataStorage::cacheManifest_TracksLastFetchWithoutRewrite() {
+    QTemporaryDir fetchDir;
+    QVERIFY(fetchDir.isValid());
+    DataStorage fetchStorage(fetchDir.path());
+    const QString filename = DataStorage::sensorSeriesFileName(11);
+
+    QVERIFY(!fetchStorage.lastFetchTime(filename).isValid());
+    QVERIFY(!fetchStorage.markFetched(filename));
+
+    QVERIFY(fetchStorage.saveSensorSeries(11, createTestSensorData("PM10")));
+    const QDateTime saved = fetchStorage.lastFetchTime(filename);
+    QVERIFY(saved.isValid());
+    const quint32 checksum = fetchStorage.cacheManifest().entry(filename)->checksum;
+
+    QThread::msleep(20);
+    QVERIFY(fetchStorage.markFetched(filename));
+    QVERIFY(fetchStorage.lastFetchTime(filename) > saved);
+    QCOMPARE(fetchStorage.cacheManifest().entry(filename)->checksum, checksum);
+    QVERIFY(fetchStorage.getLastModified(filename) <= saved.addSecs(1)); // plik nie został przepisany
+
+    DataStorage reopened(fetchDir.path());
+    QCOMPARE(reopened.lastFetchTime(filename), fetchStorage.lastFetchTime(filename));
+}
+
+void TestDataStorage::shardedLayout_MovesFilesOnSave() {
+    QTemporaryDir shardDir;
+    QVERIFY(shardDir.isValid());
+    DataStorage shardStorage(shardDir.path());
+    QVERIFY(shardStorage.saveSensorSeries(1234, createTestSensorData("PM10")));
+    QVERIFY(shardStorage.saveStationsToJson(createTestStations(2)));
+    QVERIFY(QFile::exists(shardDir.filePath(DataStorage::sensorSeriesFileName(1234))));
+
+    shardStorage.setLayout(StorageLayout::Sharded);
+    const QString shardedPath = shardStorage.relativeFilePath(DataStorage::sensorSeriesFileName(1234));
+    QCOMPARE(shardedPath, QString("series/12/sensor_1234_series.bin"));
+    QCOMPARE(shardStorage.relativeFilePath(DataStorage::stationsFileName()), DataStorage::stationsFileName());
+
+    // Plik ze starego układu jest nadal odczytywany, a przy zapisie przenoszony
+    QCOMPARE(shardStorage.loadSensorSeries(1234).key, QString("PM10"));
+    QVERIFY(shardStorage.saveSensorSeries(1234, createTestSensorData("NO2")));
+    QVERIFY(shardStorage.saveSensorsToJson(77, createTestSensors(77)));
+    QVERIFY(QFile::exists(shardDir.filePath(shardedPath)));
+    QVERIFY(!QFile::exists(shardDir.filePath(DataStorage::sensorSeriesFileName(1234))));
+    QVERIFY(QFile::exists(shardDir.filePath("sensors/0/station_77_sensors.json")));
+    QVERIFY(QFile::exists(shardDir.filePath(DataStorage::stationsFileName())));
+
+    QCOMPARE(shardStorage.cachedSensorDataIds(), std::vector<int>({1234}));
+    QCOMPARE(shardStorage.cachedSensorsStationIds(), std::vector<int>({77}));
+
+    // Płaski układ (np. starsza konfiguracja) znajduje pliki w podkatalogach; odbudowa katalogu cache też
+    QFile::remove(shardDir.filePath(CacheManifest::fileName()));
+    QFile::remove(shardDir.filePath(CacheManifest::journalFileName()));
+    DataStorage flatStorage(shardDir.path());
+    QCOMPARE(flatStorage.loadCachedSensorData(1234).key, QString("NO2"));
+    QCOMPARE(flatStorage.loadSensorsFromJson(77).size(), std::size_t(3));
+    QCOMPARE(flatStorage.cacheManifest().size(), 3);
+}
+
+void TestDataStorage::compact_AppliesRetentionPolicy() {
+    QTemporaryDir compactDir;
+    QVERIFY(compactDir.isValid());
+    DataStorage compactStorage(compactDir.path());
+    compactStorage.setLayout(StorageLayout::Sharded);
+    const QDateTime now = QDateTime::currentDateTime();
+
+    // 60 dni pomiarów godzinowych, z czego ostatnie 30 dni ma zostać
+    SensorData series;
+    series.key = "PM10";
+    for (int h = 0; h < 60 * 24; ++h) {
+        series.values.push_back({now.addSecs(-3600LL * h), 20.0 + h % 7});
+    }
+    QVERIFY(compactStorage.saveSensorSeries(5, series));
+    QVERIFY(compactStorage.saveStationsToJson(createTestStations(2)));
+    QVERIFY(compactStorage.saveSensorsToJson(6, createTestSensors(6)));
+
+    AirQualityIndex oldIndex = createTestAQI(6);
+    oldIndex.stCalcDate = now.addDays(-45);
+    AirQualityIndex recentIndex = createTestAQI(6);
+    recentIndex.stCalcDate = now.addDays(-1);
+    QCOMPARE(compactStorage.airQualityIndexHistory().appendBatch(6, {oldIndex, recentIndex}), 2);
+
+    RetentionPolicy policy;
+    policy.maxAgeDays = 30;
+    CompactionStats stats = compactStorage.compact(policy, now);
+    QCOMPARE(stats.filesRewritten, 1);
+    QCOMPARE(stats.filesRemoved, 0);
+    QCOMPARE(stats.historyRecordsRemoved, qint64(1));
+    QVERIFY(stats.bytesAfter < stats.bytesBefore);
+
+    SensorData trimmed = compactStorage.loadSensorSeries(5);
+    QCOMPARE(trimmed.values.size(), std::size_t(30 * 24 + 1)); // pomiar dokładnie z granicy zostaje
+    QVERIFY(trimmed.values.back().date >= now.addDays(-30));
+    QVERIFY(compactStorage.cacheManifest().entry(DataStorage::sensorSeriesFileName(5))->firstDate >= now.addDays(-30));
+    QCOMPARE(compactStorage.airQualityIndexHistory().count(6), qint64(1));
+
+    // Drugi przebieg nic nie zmienia
+    stats = compactStorage.compact(policy, now);
+    QCOMPARE(stats.filesRewritten + stats.filesRemoved, 0);
+
+    // 100 dni później wszystko z ID jest przeterminowane; lista stacji zostaje
+    stats = compactStorage.compact(policy, now.addDays(100));
+    QCOMPARE(stats.filesRemoved, 2);
+    QVERIFY(compactStorage.cachedSensorDataIds().empty());
+    QVERIFY(compactStorage.cachedSensorsStationIds().empty());
+    QCOMPARE(compactStorage.loadStationsFromJson().size(), std::size_t(2));
+    QCOMPARE(compactStorage.cacheManifest().size(), 1);
+}
+
+void TestDataStorage::compact_KeepsCacheWithinDiskBudget() {
+    QTemporaryDir budgetDir;
+    QVERIFY(budgetDir.isValid());
+    DataStorage budgetStorage(budgetDir.path());
+    budgetStorage.setWriteBehindEnabled(true, 1000);
+    QVERIFY(budgetStorage.saveStationsToJson(createTestStations(3)));
+    for (int id = 1; id <= 3; ++id) {
+        QVERIFY(budgetStorage.saveSensorDataToJson(createTestSensorData("PM10"), DataStorage::sensorDataFileName(id)));
+    }
+    const qint64 total = budgetStorage.cacheManifest().totalSize();
+
+    RetentionPolicy policy;
+    policy.diskBudgetBytes = total;
+    QCOMPARE(budgetStorage.compact(policy).filesRemoved, 0);
+
+    policy.diskBudgetBytes = total - 1;
+    CompactionStats stats = budgetStorage.compact(policy);
+    QCOMPARE(stats.filesRemoved, 1);
+    QVERIFY(stats.bytesAfter <= policy.diskBudgetBytes);
+    QCOMPARE(budgetStorage.cachedSensorDataIds().size(), std::size_t(2));
+
+    // Lista stacji nie jest usuwana nawet wtedy, gdy sama przekracza limit
+    policy.diskBudgetBytes = 1;
+    stats = budgetStorage.compact(policy);
+    QCOMPARE(stats.filesRemoved, 2);
+    QVERIFY(budgetStorage.cachedSensorDataIds().empty());
+    QCOMPARE(budgetStorage.loadStationsFromJson().size(), std::size_t(3));
+}
+
+void TestDataStorage::compact_SkipsRetainedSeries() {
+    QTemporaryDir compactDir;
+    QVERIFY(compactDir.isValid());
+    DataStorage compactStorage(compactDir.path());
+    const QDateTime now = QDateTime::currentDateTime();
+
+    SensorData history;
+    history.key = "PM10";
+    for (int d = 0; d < 200; ++d) {
+        history.values.push_back({now.addDays(-d), 10.0 + d % 5});
+    }
+    QVERIFY(compactStorage.saveSensorSeries(7, history));
+    QVERIFY(compactStorage.saveSensorSeries(8, history));
+    QVERIFY(!compactStorage.setSeriesRetained(9));
+    QVERIFY(compactStorage.setSeriesRetained(7));
+
+    // Ochrona zostaje przy ponownym zapisie serii (np. nowe dane z API) i po ponownym wczytaniu katalogu
+    QVERIFY(compactStorage.saveSensorSeries(7, history));
+    DataStorage reopened(compactDir.path());
+    QVERIFY(reopened.cacheManifest().entry(DataStorage::sensorSeriesFileName(7))->retained);
+    QVERIFY(!reopened.cacheManifest().entry(DataStorage::sensorSeriesFileName(8))->retained);
+
+    RetentionPolicy policy;
+    policy.maxAgeDays = 30;
+    policy.diskBudgetBytes = 1;
+    CompactionStats stats = reopened.compact(policy, now.addDays(500));
+    QCOMPARE(stats.filesRemoved, 1);
+    QCOMPARE(reopened.loadSensorSeries(7).values.size(), history.values.size());
+    QVERIFY(reopened.loadSensorSeries(8).values.empty());
+}
+
+void TestDataStorage::exportSensorSeries_LongLayout() {
+    QTemporaryDir exportDir;
+    QVERIFY(exportDir.isValid());
+    DataStorage exportStorage(exportDir.path());
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1704067200000)); // 2024-01-01T00:00:00Z
+
+    SensorData pm10;
+    pm10.key = "PM10";
+    pm10.values = {{start.addSecs(3600), 12.5}, {start, 10.0}}; // od najnowszego, jak z API
+    QVERIFY(exportStorage.saveSensorSeries(5, pm10));
+    SensorData no2;
+    no2.key = "NO2";
+    no2.values = {{start.addSecs(3600), std::numeric_limits<double>::quiet_NaN()}};
+    QVERIFY(exportStorage.saveSensorDataToJson(no2, DataStorage::sensorDataFileName(7)));
+
+    const QString path = exportDir.filePath("export.csv");
+    ExportStats stats;
+    QVERIFY(exportStorage.exportSensorSeries({}, path, ExportOptions(), &stats));
+    QCOMPARE(stats.sensorCount, 2);
+    QCOMPARE(stats.rowCount, quint64(3));
+    QCOMPARE(stats.bytesWritten, QFileInfo(path).size());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("sensor_id,param,timestamp,value\n"
+                                        "5,PM10,2024-01-01T00:00:00Z,10\n"
+                                        "5,PM10,2024-01-01T01:00:00Z,12.5\n"
+                                        "7,NO2,2024-01-01T01:00:00Z,\n"));
+    file.close();
+
+    ExportOptions options;
+    options.from = start.addSecs(3600);
+    options.format = ExportFormat::ArrowIpc;
+    QVERIFY(exportStorage.exportSensorSeries({5}, exportDir.filePath("export.arrow"), options, &stats));
+    QCOMPARE(stats.sensorCount, 1);
+    QCOMPARE(stats.rowCount, quint64(1));
+    QFile arrowFile(exportDir.filePath("export.arrow"));
+    QVERIFY(arrowFile.open(QIODevice::ReadOnly));
+    QVERIFY(arrowFile.readAll().endsWith("ARROW1"));
+}
+
+void TestDataStorage::exportSensorSeries_WideLayout() {
+    QTemporaryDir exportDir;
+    QVERIFY(exportDir.isValid());
+    DataStorage exportStorage(exportDir.path());
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1704067200000)); // 2024-01-01T00:00:00Z
+
+    SensorData pm10;
+    pm10.key = "PM10";
+    pm10.values = {{start, 10.0}, {start.addSecs(3600), 12.5}};
+    QVERIFY(exportStorage.saveSensorSeries(5, pm10));
+    SensorData no2;
+    no2.key = "NO2";
+    no2.values = {{start.addSecs(7200), 3.0}, {start.addSecs(3600), std::numeric_limits<double>::quiet_NaN()}};
+    QVERIFY(exportStorage.saveSensorDataToJson(no2, DataStorage::sensorDataFileName(7)));
+    // Pomiar kilka okien eksportu później
+    SensorData so2;
+    so2.key = "SO2";
+    so2.values = {{start.addDays(3 * DataStorage::ExportWindowDays), 1.0}};
+    QVERIFY(exportStorage.saveSensorSeries(9, so2));
+
+    ExportOptions options;
+    options.layout = ExportLayout::Wide;
+    const QString path = exportDir.filePath("wide.csv");
+    ExportStats stats;
+    QVERIFY(exportStorage.exportSensorSeries({5, 7, 9}, path, options, &stats));
+    QCOMPARE(stats.sensorCount, 3);
+    QCOMPARE(stats.rowCount, quint64(4));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("timestamp,PM10_5,NO2_7,SO2_9\n"
+                                        "2024-01-01T00:00:00Z,10,,\n"
+                                        "2024-01-01T01:00:00Z,12.5,,\n"
+                                        "2024-01-01T02:00:00Z,,3,\n"
+                                        "2024-01-22T00:00:00Z,,,1\n"));
+    file.close();
+
+    // Czujniki bez danych w przedziale dat nie mają kolumn
+    options.to = start.addSecs(3600);
+    QVERIFY(exportStorage.exportSensorSeries({5, 7, 9}, path, options, &stats));
+    QCOMPARE(stats.sensorCount, 1);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("timestamp,PM10_5\n2024-01-01T00:00:00Z,10\n"));
+}
+
+void TestDataStorage::exportSensorSeries_WideLayoutAcrossBlocks() {
+    QTemporaryDir exportDir;
+    QVERIFY(exportDir.isValid());
+    DataStorage exportStorage(exportDir.path());
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1704067200000)); // 2024-01-01T00:00:00Z
+
+    // 60 dni pomiarów godzinowych od najnowszego (bloki serii w odwrotnej kolejności dat) i 30 dni co 2 h w JSON
+    SensorData pm10;
+    pm10.key = "PM10";
+    for (int h = 60 * 24 - 1; h >= 0; --h) {
+        pm10.values.push_back({start.addSecs(3600LL * h), static_cast<double>(h)});
+    }
+    QVERIFY(exportStorage.saveSensorSeries(5, pm10));
+    SensorData no2;
+    no2.key = "NO2";
+    for (int h = 0; h < 30 * 24; h += 2) {
+        no2.values.push_back({start.addSecs(3600LL * (h + 240)), 1.0});
+    }
+    QVERIFY(exportStorage.saveSensorDataToJson(no2, DataStorage::sensorDataFileName(7)));
+
+    ExportOptions options;
+    options.layout = ExportLayout::Wide;
+    options.from = start.addDays(1);
+    const QString path = exportDir.filePath("wide.csv");
+    ExportStats stats;
+    QVERIFY(exportStorage.exportSensorSeries({5, 7}, path, options, &stats));
+    QCOMPARE(stats.rowCount, quint64(59 * 24));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readLine() == "timestamp,PM10_5,NO2_7\n");
+    int row = 0;
+    int no2Values = 0;
+    while (!file.atEnd()) {
+        const QStringList cells = QString::fromUtf8(file.readLine()).trimmed().split(',');
+        QCOMPARE(cells.size(), 3);
+        const int h = 24 + row++; // wiersze rosnąco po dacie, bez powtórzeń
+        QCOMPARE(QDateTime::fromString(cells[0], Qt::ISODate), start.addSecs(3600LL * h));
+        QCOMPARE(cells[1].toInt(), h);
+        no2Values += !cells[2].isEmpty();
+    }
+    QCOMPARE(row, 59 * 24);
+    QCOMPARE(no2Values, static_cast<int>(no2.values.size()));
+}
+
+void TestDataStorage::exportSensorSeries_StreamsBlocksFromDisk() {
+    QTemporaryDir exportDir;
+    QVERIFY(exportDir.isValid());
+    DataStorage exportStorage(exportDir.path());
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1704067200000)); // 2024-01-01T00:00:00Z
+
+    // 3 czujniki po ~200 dni pomiarów godzinowych - po 19 bloków serii każdy
+    const int hours = 200 * 24;
+    const quint64 blocksPerSensor = (hours + SeriesCodec::DefaultBlockSize - 1) / SeriesCodec::DefaultBlockSize;
+    for (int sensorId = 1; sensorId <= 3; ++sensorId) {
+        SensorData data;
+        data.key = "PM10";
+        for (int h = 0; h < hours; ++h) {
+            data.values.push_back({start.addSecs(3600LL * h), static_cast<double>(h)});
+        }
+        QVERIFY(exportStorage.saveSensorSeries(sensorId, data));
+    }
+
+    // Układ długi: każdy blok jest czytany z dysku raz, a w pamięci są naraz pomiary co najwyżej dwóch bloków
+    ExportStats stats;
+    QVERIFY(exportStorage.exportSensorSeries({1, 2, 3}, exportDir.filePath("long.csv"), ExportOptions(), &stats));
+    QCOMPARE(stats.rowCount, quint64(3 * hours));
+    QCOMPARE(stats.blocksRead, 3 * blocksPerSensor);
+    QVERIFY(stats.peakBufferedPoints > 0);
+    QVERIFY(stats.peakBufferedPoints <= quint64(2 * SeriesCodec::DefaultBlockSize));
+
+    // Układ szeroki: w pamięci są tylko bloki nachodzące na bieżące okno, nie całe serie
+    ExportOptions options;
+    options.layout = ExportLayout::Wide;
+    QVERIFY(exportStorage.exportSensorSeries({1, 2, 3}, exportDir.filePath("wide.csv"), options, &stats));
+    QCOMPARE(stats.rowCount, quint64(hours));
+    QCOMPARE(stats.blocksRead, 3 * blocksPerSensor);
+    const quint64 windowHours = DataStorage::ExportWindowDays * 24;
+    QVERIFY(stats.peakBufferedPoints <= 3 * (windowHours + 2 * SeriesCodec::DefaultBlockSize));
+    QVERIFY(stats.peakBufferedPoints < quint64(hours));
+}
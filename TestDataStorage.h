@@ -47,12 +47,54 @@ private slots:
     void saveLoadSensorData_WithNaN();
     void saveSensorData_EmptyData();
     void loadSensorData_NonExistentFile();
+    void saveLoadSensorSeries_RoundTripAndRange();
+    void loadCachedSensorData_PrefersSeriesOverJson();
+    void mergeSensorSeries_KeepsHistoryAndAppliesPolicy();
 
     // Testy dla indeksu AQI
     void saveLoadAQI_ValidData();
     void saveAQI_InvalidOrMismatchedId();
     void loadAQI_NonExistentFile();
     void loadAQI_MismatchedStationIdInFile();
+    void loadAQI_LegacyLevelObjects();
+
+    // Testy dla stanu modelu prognozy
+    void saveLoadForecastState_RoundTrip();
+    void loadForecastState_NonExistentFile();
+
+    // Testy dla reguł alertów
+    void saveLoadAlertRules_RoundTrip();
+    void loadAlertRules_ClampsClearThreshold();
+    void saveLoadAlertProgress_RoundTrip();
+
+    // Testy dla listy zapisanych plików
+    void cachedIds_ListsSavedFiles();
+
+    // Testy dla atomowego zapisu i sum kontrolnych
+    void checksum_KnownValue();
+    void save_ReplacesFileWithoutTemporaryFiles();
+    void loadSensorData_CorruptedFileIsRemoved();
+
+    // Testy dla zapisu w tle
+    void writeBehind_LoadSeesQueuedWrites();
+    void writeBehind_QueuesAqiHistoryAppends();
+
+    // Testy dla katalogu plików cache
+    void cacheManifest_TracksSavesAndRemovals();
+    void cacheManifest_RebuiltFromExistingFiles();
+    void cacheManifest_TracksLastFetchWithoutRewrite();
+
+    // Testy dla układu katalogów i porządkowania cache
+    void shardedLayout_MovesFilesOnSave();
+    void compact_AppliesRetentionPolicy();
+    void compact_KeepsCacheWithinDiskBudget();
+    void compact_SkipsRetainedSeries();
+
+    // Testy dla eksportu danych pomiarowych
+    void exportSensorSeries_LongLayout();
+    void exportSensorSeries_WideLayout();
+    void exportSensorSeries_WideLayoutAcrossBlocks();
+    void exportSensorSeries_StreamsBlocksFromDisk();
 };
 
 #endif
@@ -0,0 +1,153 @@
+#include "TestFleetAnalyzer.h"
+#include <QFile>
+#include <limits>
+#include <cmath>
+
+SensorData TestFleetAnalyzer::createTestSensorData(const QString& key, const std::vector<double>& values) {
+    SensorData sd;
+    sd.key = key;
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    for (size_t i = 0; i < values.size(); ++i) {
+        sd.values.push_back({start.addSecs(static_cast<qint64>(i) * 3600), values[i]});
+    }
+    return sd;
+}
+
+const FleetAggregate* TestFleetAnalyzer::findGroup(const std::vector<FleetAggregate>& groups, const QString& name) {
+    for (const FleetAggregate& group : groups) {
+        if (group.group == name) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
+
+void TestFleetAnalyzer::initTestCase() {
+    QVERIFY(tempDir.isValid());
+    storage = new DataStorage(tempDir.path());
+
+    // Dwie stacje w różnych województwach
+    std::vector<MeasuringStation> stations(2);
+    stations[0].id = 100;
+    stations[0].stationName = "Stacja A";
+    stations[0].city.commune.provinceName = "MAŁOPOLSKIE";
+    stations[1].id = 200;
+    stations[1].stationName = "Stacja B";
+    stations[1].city.commune.provinceName = "ŚLĄSKIE";
+    QVERIFY(storage->saveStationsToJson(stations));
+
+    auto makeSensor = [](int id, int stationId, const QString& paramCode) {
+        Sensor s;
+        s.id = id;
+        s.stationId = stationId;
+        s.param.paramCode = paramCode;
+        return s;
+    };
+    QVERIFY(storage->saveSensorsToJson(100, {makeSensor(1001, 100, "PM10"), makeSensor(1002, 100, "NO2")}));
+    QVERIFY(storage->saveSensorsToJson(200, {makeSensor(2001, 200, "PM10")}));
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("PM10", {10.0, 20.0, 30.0}), DataStorage::sensorDataFileName(1001)));
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("NO2", {5.0, 7.0}), DataStorage::sensorDataFileName(1002)));
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("PM10", {40.0, nan}), DataStorage::sensorDataFileName(2001)));
+    // Czujnik bez zapisanej listy czujników stacji - parametr z klucza danych, województwo nieznane
+    QVERIFY(storage->saveSensorDataToJson(createTestSensorData("SO2", {3.0}), DataStorage::sensorDataFileName(3001)));
+
+    // Uszkodzony plik danych
+    QFile broken(tempDir.filePath(DataStorage::sensorDataFileName(4001)));
+    QVERIFY(broken.open(QIODevice::WriteOnly));
+    broken.write("{ not json");
+    broken.close();
+}
+
+void TestFleetAnalyzer::cleanupTestCase() {
+    delete storage;
+    storage = nullptr;
+}
+
+// Testy dla FleetAnalyzer
+
+void TestFleetAnalyzer::run_RowsWithMetadata() {
+    FleetAnalyzer fleet(storage);
+    fleet.setMaxThreadCount(2);
+    FleetReport report = fleet.run();
+
+    QCOMPARE(report.rows.size(), size_t(4));
+    QCOMPARE(report.failedCount, 1);
+    QCOMPARE(report.threadCount, 2);
+
+    QCOMPARE(report.rows[0].sensorId, 1001);
+    QCOMPARE(report.rows[0].stationId, 100);
+    QCOMPARE(report.rows[0].stationName, QString("Stacja A"));
+    QCOMPARE(report.rows[0].provinceName, QString("MAŁOPOLSKIE"));
+    QCOMPARE(report.rows[0].paramCode, QString("PM10"));
+    QCOMPARE(report.rows[0].validCount, 3);
+    QVERIFY(report.rows[0].result.average.has_value());
+    QCOMPARE(*report.rows[0].result.average, 20.0);
+
+    QCOMPARE(report.rows[2].sensorId, 2001);
+    QCOMPARE(report.rows[2].validCount, 1);
+
+    QCOMPARE(report.rows[3].sensorId, 3001);
+    QCOMPARE(report.rows[3].stationId, -1);
+    QCOMPARE(report.rows[3].paramCode, QString("SO2"));
+    QVERIFY(report.rows[3].provinceName.isEmpty());
+}
+
+void TestFleetAnalyzer::run_AggregatesByParameter() {
+    FleetAnalyzer fleet(storage);
+    FleetReport report = fleet.run();
+
+    QCOMPARE(report.byParameter.size(), size_t(3));
+    QCOMPARE(report.byParameter[0].group, QString("NO2")); // posortowane po nazwie grupy
+
+    const FleetAggregate* pm10 = findGroup(report.byParameter, "PM10");
+    QVERIFY(pm10 != nullptr);
+    QCOMPARE(pm10->sensorCount, 2);
+    QCOMPARE(pm10->valueCount, quint64(4));
+    QVERIFY(pm10->average.has_value());
+    QCOMPARE(*pm10->average, 25.0); // (10 + 20 + 30 + 40) / 4 - średnia ważona liczbą pomiarów
+    QCOMPARE(*pm10->maxValue, 40.0);
+    QCOMPARE(*pm10->p50, 20.0);
+    QCOMPARE(*pm10->p98, 40.0);
+}
+
+void TestFleetAnalyzer::run_AggregatesByProvince() {
+    FleetAnalyzer fleet(storage);
+    FleetReport report = fleet.run();
+
+    const FleetAggregate* malopolskie = findGroup(report.byProvince, "MAŁOPOLSKIE");
+    QVERIFY(malopolskie != nullptr);
+    QCOMPARE(malopolskie->sensorCount, 2);
+    QCOMPARE(malopolskie->valueCount, quint64(5));
+    QCOMPARE(*malopolskie->maxValue, 30.0);
+
+    const FleetAggregate* unknown = findGroup(report.byProvince, FleetAnalyzer::unknownGroupName());
+    QVERIFY(unknown != nullptr);
+    QCOMPARE(unknown->sensorCount, 1);
+    QCOMPARE(*unknown->average, 3.0);
+}
+
+void TestFleetAnalyzer::run_SelectedSensorsOnly() {
+    FleetAnalyzer fleet(storage);
+    FleetReport report = fleet.run({1002, 2001});
+
+    QCOMPARE(report.rows.size(), size_t(2));
+    QCOMPARE(report.failedCount, 0);
+    QCOMPARE(report.rows[0].sensorId, 1002);
+    QCOMPARE(report.rows[1].sensorId, 2001);
+    QCOMPARE(report.byParameter.size(), size_t(2));
+}
+
+void TestFleetAnalyzer::run_EmptyStorage() {
+    QTemporaryDir emptyDir;
+    QVERIFY(emptyDir.isValid());
+    DataStorage emptyStorage(emptyDir.path());
+    FleetAnalyzer fleet(&emptyStorage);
+    FleetReport report = fleet.run();
+
+    QVERIFY(report.rows.empty());
+    QVERIFY(report.byParameter.empty());
+    QVERIFY(report.byProvince.empty());
+    QCOMPARE(report.failedCount, 0);
+}
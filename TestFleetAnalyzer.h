@@ -0,0 +1,33 @@
+#ifndef TESTFLEETANALYZER_H
+#define TESTFLEETANALYZER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "FleetAnalyzer.h"
+#include "DataStorage.h"
+#include "DataStructures.h"
+
+class TestFleetAnalyzer : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir tempDir;
+    DataStorage* storage = nullptr;
+
+    SensorData createTestSensorData(const QString& key, const std::vector<double>& values);
+    const FleetAggregate* findGroup(const std::vector<FleetAggregate>& groups, const QString& name);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void run_RowsWithMetadata();
+    void run_AggregatesByParameter();
+    void run_AggregatesByProvince();
+    void run_SelectedSensorsOnly();
+    void run_EmptyStorage();
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "TestHoltWintersForecaster.h"
+#include <cmath>
+
+namespace {
+constexpr double Pi = 3.14159265358979323846;
+}
+
+QDateTime TestHoltWintersForecaster::hour(int index) {
+    return QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate).addSecs(static_cast<qint64>(index) * 3600);
+}
+
+std::vector<MeasurementValue> TestHoltWintersForecaster::dailyCycle(int firstHour, int count) {
+    std::vector<MeasurementValue> values;
+    for (int i = firstHour; i < firstHour + count; ++i) {
+        values.push_back({hour(i), 30.0 + 10.0 * std::sin(2.0 * Pi * (i % 24) / 24.0)});
+    }
+    return values;
+}
+
+// Testy dla HoltWintersForecaster
+
+void TestHoltWintersForecaster::forecast_EmptyBeforeFirstSeason() {
+    HoltWintersForecaster forecaster;
+    QVERIFY(forecaster.forecast(24).empty());
+
+    QCOMPARE(forecaster.update(dailyCycle(0, 23)), 23);
+    QVERIFY(!forecaster.state().isInitialized());
+    QVERIFY(forecaster.forecast(24).empty());
+
+    QCOMPARE(forecaster.update(dailyCycle(23, 1)), 1);
+    QVERIFY(forecaster.state().isInitialized());
+    QCOMPARE(forecaster.forecast(24).size(), std::size_t(24));
+}
+
+void TestHoltWintersForecaster::forecast_FollowsDailyCycle() {
+    HoltWintersForecaster forecaster;
+    forecaster.update(dailyCycle(0, 14 * 24));
+
+    const std::vector<MeasurementValue> forecast = forecaster.forecast(24);
+    QCOMPARE(forecast.size(), std::size_t(24));
+    const std::vector<MeasurementValue> expected = dailyCycle(14 * 24, 24);
+    for (std::size_t k = 0; k < forecast.size(); ++k) {
+        QCOMPARE(forecast[k].date, expected[k].date);
+        QVERIFY2(std::abs(forecast[k].value - expected[k].value) < 1.0,
+                 qPrintable(QString("krok %1: %2 zamiast %3").arg(k).arg(forecast[k].value).arg(expected[k].value)));
+    }
+    QVERIFY(forecaster.oneStepErrorStdDev() < 1.0);
+}
+
+void TestHoltWintersForecaster::update_IncrementalMatchesBulk() {
+    HoltWintersForecaster bulk;
+    bulk.update(dailyCycle(0, 72));
+
+    // Okna zachodzące na siebie - jak kolejne odpowiedzi API z danymi z ostatnich dni
+    HoltWintersForecaster incremental;
+    incremental.update(dailyCycle(0, 30));
+    incremental.update(dailyCycle(10, 40));
+    incremental.update(dailyCycle(40, 32));
+
+    QCOMPARE(incremental.state().lastStepMSecs, bulk.state().lastStepMSecs);
+    QCOMPARE(incremental.state().observationCount, bulk.state().observationCount);
+    QCOMPARE(incremental.state().level, bulk.state().level);
+    QCOMPARE(incremental.state().seasonal, bulk.state().seasonal);
+}
+
+void TestHoltWintersForecaster::update_IgnoresAlreadyProcessedHours() {
+    HoltWintersForecaster forecaster;
+    QCOMPARE(forecaster.update(dailyCycle(0, 48)), 48);
+    const ForecastState before = forecaster.state();
+
+    QCOMPARE(forecaster.update(dailyCycle(0, 48)), 0);
+    QCOMPARE(forecaster.state().level, before.level);
+    QCOMPARE(forecaster.state().observationCount, before.observationCount);
+}
+
+void TestHoltWintersForecaster::update_ShortGapAdvancesModel() {
+    HoltWintersForecaster forecaster;
+    forecaster.update(dailyCycle(0, 48));
+    const quint64 observations = forecaster.state().observationCount;
+
+    QCOMPARE(forecaster.update(dailyCycle(54, 1)), 7); // 6 brakujących godzin + nowy pomiar
+    QCOMPARE(forecaster.state().observationCount, observations + 1);
+    QCOMPARE(forecaster.state().lastStepMSecs, hour(54).toMSecsSinceEpoch());
+    QCOMPARE(forecaster.state().seasonIndex, 55 % 24);
+}
+
+void TestHoltWintersForecaster::update_LongGapReinitializes() {
+    HoltWintersForecaster forecaster;
+    forecaster.update(dailyCycle(0, 48));
+    QVERIFY(forecaster.state().isInitialized());
+
+    const int restart = 48 + (HoltWintersForecaster::MaxGapSeasons + 1) * 24;
+    forecaster.update(dailyCycle(restart, 10));
+    QVERIFY(!forecaster.state().isInitialized());
+    QCOMPARE(forecaster.state().warmup.size(), std::size_t(10));
+    QVERIFY(forecaster.forecast(24).empty());
+}
+
+void TestHoltWintersForecaster::constructor_ResetsInconsistentState() {
+    ForecastState state;
+    state.sensorId = 5;
+    state.seasonLength = 24;
+    state.seasonal = std::vector<double>(12, 1.0); // niezgodne z długością sezonu
+    state.alpha = 7.0;
+
+    HoltWintersForecaster forecaster(state);
+    QVERIFY(!forecaster.state().isInitialized());
+    QCOMPARE(forecaster.state().alpha, 1.0);
+    QCOMPARE(forecaster.state().sensorId, 5);
+}
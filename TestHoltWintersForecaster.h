@@ -0,0 +1,27 @@
+#ifndef TESTHOLTWINTERSFORECASTER_H
+#define TESTHOLTWINTERSFORECASTER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "HoltWintersForecaster.h"
+#include "DataStructures.h"
+
+class TestHoltWintersForecaster : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDateTime hour(int index);
+    std::vector<MeasurementValue> dailyCycle(int firstHour, int count);
+
+private slots:
+    void forecast_EmptyBeforeFirstSeason();
+    void forecast_FollowsDailyCycle();
+    void update_IncrementalMatchesBulk();
+    void update_IgnoresAlreadyProcessedHours();
+    void update_ShortGapAdvancesModel();
+    void update_LongGapReinitializes();
+    void constructor_ResetsInconsistentState();
+};
+
+#endif
@@ -4,11 +4,32 @@
 #include "testdataparser.h"
 #include "testdataanalyzer.h"
 #include "testdatastorage.h"
+#include "TestDataRepository.h"
+#include "TestSensorDataCache.h"
+#include "TestQuantileSketch.h"
+#include "TestFleetAnalyzer.h"
+#include "TestHoltWintersForecaster.h"
+#include "TestAlertEngine.h"
+#include "TestStringPool.h"
+#include "TestAqiHistoryStore.h"
+#include "TestWriteBehindQueue.h"
+#include "TestSeriesCodec.h"
+#include "TestCacheManifest.h"
+#include "TestCacheQuery.h"
+#include "TestTableWriter.h"
+#include "TestArchiveImporter.h"
+#include "TestApiCaptureStore.h"
+#include "TestApiService.h"
+#include "TestAqiCalculator.h"
+#include "TestTimeSeriesResampler.h"
+#include "TestAnomalyDetector.h"
+#include "TestMultiSeriesChart.h"
 
 int main(int argc, char** argv) {
 
-    Q_UNUSED(argc);
-    Q_UNUSED(argv);
+    // Pętla zdarzeń dla testów czekających na sygnały z wątków tła (np. ApiService);
+    // QApplication, bo wykresy QtCharts (MultiSeriesChart) wymagają aplikacji z GUI.
+    QApplication app(argc, argv);
 
     int status = 0;
 
@@ -30,6 +51,126 @@ int main(int argc, char** argv) {
         status |= QTest::qExec(&tc, argc, argv);
     }
 
+    qInfo() << "Uruchamianie testów dla DataRepository...";
+    {
+        TestDataRepository tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla SensorDataCache...";
+    {
+        TestSensorDataCache tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla QuantileSketch...";
+    {
+        TestQuantileSketch tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla FleetAnalyzer...";
+    {
+        TestFleetAnalyzer tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla AqiCalculator...";
+    {
+        TestAqiCalculator tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla TimeSeriesResampler...";
+    {
+        TestTimeSeriesResampler tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla AnomalyDetector...";
+    {
+        TestAnomalyDetector tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla MultiSeriesChart...";
+    {
+        TestMultiSeriesChart tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla HoltWintersForecaster...";
+    {
+        TestHoltWintersForecaster tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla AlertEngine...";
+    {
+        TestAlertEngine tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla StringPool...";
+    {
+        TestStringPool tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla AqiHistoryStore...";
+    {
+        TestAqiHistoryStore tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla WriteBehindQueue...";
+    {
+        TestWriteBehindQueue tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla SeriesCodec...";
+    {
+        TestSeriesCodec tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla CacheManifest...";
+    {
+        TestCacheManifest tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla CacheQuery...";
+    {
+        TestCacheQuery tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla TableWriter...";
+    {
+        TestTableWriter tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla ArchiveImporter...";
+    {
+        TestArchiveImporter tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla ApiCaptureStore...";
+    {
+        TestApiCaptureStore tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    qInfo() << "Uruchamianie testów dla ApiService...";
+    {
+        TestApiService tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
     qInfo() << "Zakończono wszystkie testy.";
     return status;
 }
@@ -0,0 +1,138 @@
+#include "TestMultiSeriesChart.h"
+
+QDateTime TestMultiSeriesChart::hour(int index) {
+    return QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate).addSecs(static_cast<qint64>(index) * 3600);
+}
+
+std::vector<MeasurementValue> TestMultiSeriesChart::hourlySeries(int first, int count, double base) {
+    std::vector<MeasurementValue> values;
+    for (int i = first; i < first + count; ++i) {
+        values.push_back({hour(i), base + i % 5});
+    }
+    return values;
+}
+
+void TestMultiSeriesChart::init() {
+    m_chart = new QChart();
+    m_axisX = new QDateTimeAxis();
+    m_axisY = new QValueAxis();
+    m_chart->addAxis(m_axisX, Qt::AlignBottom);
+    m_chart->addAxis(m_axisY, Qt::AlignLeft);
+}
+
+void TestMultiSeriesChart::cleanup() {
+    delete m_chart; // usuwa też osie
+    m_chart = nullptr;
+}
+
+// Testy dla MultiSeriesChart
+
+void TestMultiSeriesChart::updateSeries_AppendsOnlyNewPoints() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    chart.updateSeries(1, "PM10", hourlySeries(0, 10, 20.0));
+    QCOMPARE(chart.plottedPointCount(1), 10);
+
+    std::vector<MeasurementValue> values = hourlySeries(0, 10, 20.0);
+    values.push_back({hour(10), 80.0});
+    values.push_back({hour(11), 5.0});
+    chart.updateSeries(1, "PM10", values);
+    QCOMPARE(chart.plottedPointCount(1), 12);
+
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(minValue, 5.0);
+    QCOMPARE(maxValue, 80.0);
+}
+
+void TestMultiSeriesChart::updateSeries_DropsPointsOutsideWindow() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    std::vector<MeasurementValue> values = hourlySeries(0, 10, 20.0);
+    values[0].value = 300.0; // maksimum wypada z okna
+    chart.updateSeries(1, "PM10", values);
+
+    chart.updateSeries(1, "PM10", hourlySeries(2, 10, 20.0));
+    QCOMPARE(chart.plottedPointCount(1), 10);
+
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(minValue, 20.0);
+    QCOMPARE(maxValue, 24.0);
+    QDateTime minDate, maxDate;
+    QVERIFY(chart.timeRange(minDate, maxDate));
+    QCOMPARE(minDate, hour(2));
+    QCOMPARE(maxDate, hour(11));
+}
+
+void TestMultiSeriesChart::updateSeries_ReplacesRevisedValues() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    chart.updateSeries(1, "PM10", hourlySeries(0, 10, 20.0));
+
+    // API poprawia wartość z wcześniejszej godziny i dokłada nową
+    std::vector<MeasurementValue> revised = hourlySeries(0, 11, 20.0);
+    revised[3].value = 150.0;
+    chart.updateSeries(1, "PM10", revised);
+    QCOMPARE(chart.plottedPointCount(1), 11);
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(maxValue, 150.0);
+    QVERIFY(m_axisY->max() >= 150.0);
+
+    // Cofnięcie korekty zawęża zakres z powrotem
+    chart.updateSeries(1, "PM10", hourlySeries(0, 11, 20.0));
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(maxValue, 24.0);
+    QVERIFY(m_axisY->max() < 150.0);
+}
+
+void TestMultiSeriesChart::updateSeries_RevisedValueInDecimatedSeries() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    chart.setMaxPointsPerSeries(16);
+    chart.updateSeries(1, "PM10", hourlySeries(0, 100, 20.0));
+    QVERIFY(chart.plottedPointCount(1) <= 32);
+
+    std::vector<MeasurementValue> revised = hourlySeries(0, 100, 20.0);
+    revised[50].value = 500.0;
+    chart.updateSeries(1, "PM10", revised);
+    QVERIFY(chart.plottedPointCount(1) <= 32);
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(maxValue, 500.0);
+    QVERIFY(m_axisY->max() >= 500.0); // pik zachowany w kubełku i w zakresie osi
+}
+
+void TestMultiSeriesChart::updateSeries_RebuildsWhenDatesChange() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    std::vector<MeasurementValue> gap = hourlySeries(0, 10, 20.0);
+    gap.erase(gap.begin() + 4);
+    chart.updateSeries(1, "PM10", gap);
+    QCOMPARE(chart.plottedPointCount(1), 9);
+
+    std::vector<MeasurementValue> filled = hourlySeries(0, 10, 20.0);
+    filled[4].value = 2.0; // brakujący pomiar dostarczony później
+    chart.updateSeries(1, "PM10", filled);
+    QCOMPARE(chart.plottedPointCount(1), 10);
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(minValue, 2.0);
+}
+
+void TestMultiSeriesChart::rescaleAxes_CoversAllSeries() {
+    MultiSeriesChart chart(m_chart, m_axisX, m_axisY);
+    double minValue = 0.0, maxValue = 0.0;
+    QVERIFY(!chart.valueRange(minValue, maxValue));
+
+    chart.updateSeries(1, "PM10", hourlySeries(0, 24, 20.0));
+    chart.updateSeries(2, "PM2.5", hourlySeries(12, 24, 60.0));
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(minValue, 20.0);
+    QCOMPARE(maxValue, 64.0);
+    QVERIFY(m_axisY->min() <= 20.0);
+    QVERIFY(m_axisY->max() >= 64.0);
+    QVERIFY(m_axisX->min() <= hour(0));
+    QVERIFY(m_axisX->max() >= hour(35));
+
+    chart.removeSeries(2);
+    QVERIFY(chart.valueRange(minValue, maxValue));
+    QCOMPARE(maxValue, 24.0);
+    QVERIFY(m_axisY->max() < 60.0);
+}
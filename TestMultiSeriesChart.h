@@ -0,0 +1,33 @@
+#ifndef TESTMULTISERIESCHART_H
+#define TESTMULTISERIESCHART_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "MultiSeriesChart.h"
+#include "DataStructures.h"
+
+class TestMultiSeriesChart : public QObject
+{
+    Q_OBJECT
+
+private:
+    QChart* m_chart = nullptr;
+    QDateTimeAxis* m_axisX = nullptr;
+    QValueAxis* m_axisY = nullptr;
+
+    QDateTime hour(int index);
+    std::vector<MeasurementValue> hourlySeries(int first, int count, double base);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void updateSeries_AppendsOnlyNewPoints();
+    void updateSeries_DropsPointsOutsideWindow();
+    void updateSeries_ReplacesRevisedValues();
+    void updateSeries_RevisedValueInDecimatedSeries();
+    void updateSeries_RebuildsWhenDatesChange();
+    void rescaleAxes_CoversAllSeries();
+};
+
+#endif
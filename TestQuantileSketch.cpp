@@ -0,0 +1,103 @@
+#include "TestQuantileSketch.h"
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cmath>
+
+std::vector<double> TestQuantileSketch::createShuffledRange(int count, quint32 seed) {
+    std::vector<double> values(count);
+    for (int i = 0; i < count; ++i) {
+        values[i] = static_cast<double>(i);
+    }
+    std::shuffle(values.begin(), values.end(), std::mt19937(seed));
+    return values;
+}
+
+// Testy dla QuantileSketch
+
+void TestQuantileSketch::quantile_EmptySketch()
+{
+    QuantileSketch sketch;
+    QVERIFY(sketch.isEmpty());
+    QCOMPARE(sketch.count(), quint64(0));
+    QVERIFY(std::isnan(sketch.quantile(0.5)));
+    QCOMPARE(sketch.rank(10.0), 0.0);
+}
+
+void TestQuantileSketch::quantile_ExactForSmallInput()
+{
+    QuantileSketch sketch;
+    for (double v : {5.0, 1.0, 4.0, 2.0, 3.0}) {
+        sketch.add(v);
+    }
+
+    QCOMPARE(sketch.count(), quint64(5));
+    QCOMPARE(sketch.quantile(0.0), 1.0);
+    QCOMPARE(sketch.quantile(0.5), 3.0);
+    QCOMPARE(sketch.quantile(0.9), 5.0);
+    QCOMPARE(sketch.quantile(1.0), 5.0);
+    QCOMPARE(sketch.rank(2.0), 0.4);
+}
+
+void TestQuantileSketch::quantile_BoundedErrorOnLargeInput()
+{
+    const int n = 100000;
+    QuantileSketch sketch;
+    for (double v : createShuffledRange(n, 1)) {
+        sketch.add(v);
+    }
+
+    QCOMPARE(sketch.count(), quint64(n));
+    QVERIFY(sketch.retainedItems() <= size_t(3 * sketch.k()));
+    QCOMPARE(sketch.min(), 0.0);
+    QCOMPARE(sketch.max(), static_cast<double>(n - 1));
+
+    for (double q : {0.5, 0.9, 0.98}) {
+        double rankError = std::abs(sketch.quantile(q) - q * n) / n;
+        QVERIFY2(rankError < 0.02, qPrintable(QString("q=%1 blad rangi=%2").arg(q).arg(rankError)));
+    }
+}
+
+void TestQuantileSketch::add_IgnoresNaN()
+{
+    QuantileSketch sketch;
+    sketch.add(std::numeric_limits<double>::quiet_NaN());
+    sketch.add(7.0);
+    QCOMPARE(sketch.count(), quint64(1));
+    QCOMPARE(sketch.quantile(0.5), 7.0);
+}
+
+void TestQuantileSketch::merge_MatchesSingleStream()
+{
+    const int n = 60000;
+    std::vector<double> values = createShuffledRange(n, 2);
+
+    QuantileSketch first;
+    QuantileSketch second;
+    QuantileSketch third;
+    for (int i = 0; i < n; ++i) {
+        (i < n / 2 ? first : (i < 5 * n / 6 ? second : third)).add(values[i]);
+    }
+    first.merge(second);
+    first.merge(third);
+
+    QCOMPARE(first.count(), quint64(n));
+    QCOMPARE(first.max(), static_cast<double>(n - 1));
+    QVERIFY(first.retainedItems() <= size_t(3 * first.k()));
+    for (double q : {0.5, 0.9, 0.98}) {
+        double rankError = std::abs(first.quantile(q) - q * n) / n;
+        QVERIFY2(rankError < 0.02, qPrintable(QString("q=%1 blad rangi=%2").arg(q).arg(rankError)));
+    }
+}
+
+void TestQuantileSketch::clear_ResetsSketch()
+{
+    QuantileSketch sketch;
+    for (int i = 0; i < 1000; ++i) {
+        sketch.add(i);
+    }
+    sketch.clear();
+    QVERIFY(sketch.isEmpty());
+    QCOMPARE(sketch.retainedItems(), size_t(0));
+    QVERIFY(std::isnan(sketch.max()));
+}
@@ -0,0 +1,25 @@
+#ifndef TESTQUANTILESKETCH_H
+#define TESTQUANTILESKETCH_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "QuantileSketch.h"
+#include <vector>
+
+class TestQuantileSketch : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::vector<double> createShuffledRange(int count, quint32 seed);
+
+private slots:
+    void quantile_EmptySketch();
+    void quantile_ExactForSmallInput();
+    void quantile_BoundedErrorOnLargeInput();
+    void add_IgnoresNaN();
+    void merge_MatchesSingleStream();
+    void clear_ResetsSketch();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "TestSensorDataCache.h"
+
+SensorData TestSensorDataCache::createTestSensorData(const QString& key, int count) {
+    SensorData sd;
+    sd.key = key;
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00", Qt::ISODate);
+    for (int i = 0; i < count; ++i) {
+        sd.values.push_back({start.addSecs(i * 3600), 10.0 + i});
+    }
+    return sd;
+}
+
+// Testy dla SensorDataCache
+
+void TestSensorDataCache::get_MissOnEmptyCache()
+{
+    SensorDataCache cache;
+    QVERIFY(cache.get(1) == nullptr);
+    QCOMPARE(cache.misses(), quint64(1));
+    QCOMPARE(cache.hits(), quint64(0));
+}
+
+void TestSensorDataCache::putGet_HitReturnsData()
+{
+    SensorDataCache cache;
+    SensorData data = createTestSensorData("PM10", 24);
+    cache.put(42, data);
+
+    std::shared_ptr<const SensorData> loaded = cache.get(42);
+    QVERIFY(loaded != nullptr);
+    QCOMPARE(loaded->key, QString("PM10"));
+    QCOMPARE(loaded->values.size(), data.values.size());
+    QCOMPARE(cache.hits(), quint64(1));
+    QCOMPARE(cache.size(), size_t(1));
+    QCOMPARE(cache.currentBytes(), SensorDataCache::estimateBytes(data));
+}
+
+void TestSensorDataCache::put_ReplacesExistingEntry()
+{
+    SensorDataCache cache;
+    cache.put(1, createTestSensorData("PM10", 10));
+    cache.put(1, createTestSensorData("PM10", 20));
+
+    QCOMPARE(cache.size(), size_t(1));
+    QCOMPARE(cache.get(1)->values.size(), size_t(20));
+}
+
+void TestSensorDataCache::evict_LeastRecentlyUsedFirst()
+{
+    SensorData data = createTestSensorData("NO2", 100);
+    std::size_t entryBytes = SensorDataCache::estimateBytes(data);
+    SensorDataCache cache(entryBytes * 2);
+
+    cache.put(1, data);
+    cache.put(2, data);
+    QVERIFY(cache.get(1) != nullptr); // 1 staje się ostatnio używanym
+    cache.put(3, data);                // wypiera 2
+
+    QVERIFY(cache.contains(1));
+    QVERIFY(!cache.contains(2));
+    QVERIFY(cache.contains(3));
+    QVERIFY(cache.currentBytes() <= cache.maxBytes());
+}
+
+void TestSensorDataCache::put_EntryLargerThanBudgetIsSkipped()
+{
+    SensorDataCache cache(64);
+    cache.put(1, createTestSensorData("SO2", 100));
+    QVERIFY(!cache.contains(1));
+    QCOMPARE(cache.currentBytes(), size_t(0));
+}
+
+void TestSensorDataCache::setMaxBytes_ShrinksCache()
+{
+    SensorData data = createTestSensorData("O3", 50);
+    SensorDataCache cache;
+    for (int id = 1; id <= 5; ++id) {
+        cache.put(id, data);
+    }
+    QCOMPARE(cache.size(), size_t(5));
+
+    cache.setMaxBytes(SensorDataCache::estimateBytes(data) * 2);
+    QCOMPARE(cache.size(), size_t(2));
+    QVERIFY(cache.contains(5));
+    QVERIFY(cache.contains(4));
+}
+
+void TestSensorDataCache::get_HitSharesEntry()
+{
+    SensorData data = createTestSensorData("PM2.5", 48);
+    std::size_t entryBytes = SensorDataCache::estimateBytes(data);
+    SensorDataCache cache(entryBytes);
+    cache.put(7, data);
+
+    std::shared_ptr<const SensorData> first = cache.get(7);
+    std::shared_ptr<const SensorData> second = cache.get(7);
+    QVERIFY(first != nullptr);
+    QCOMPARE(first.get(), second.get()); // trafienie nie kopiuje serii
+    QCOMPARE(cache.peek(7).get(), first.get());
+    QCOMPARE(cache.hits(), quint64(2)); // peek() nie zmienia liczników
+
+    cache.put(8, data); // wypiera 7 - dane pozostają ważne dla trzymających wskaźnik
+    QVERIFY(!cache.contains(7));
+    QCOMPARE(first->values.size(), std::size_t(48));
+}
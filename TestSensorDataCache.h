@@ -0,0 +1,26 @@
+#ifndef TESTSENSORDATACACHE_H
+#define TESTSENSORDATACACHE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "SensorDataCache.h"
+#include "DataStructures.h"
+
+class TestSensorDataCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    SensorData createTestSensorData(const QString& key, int count);
+
+private slots:
+    void get_MissOnEmptyCache();
+    void putGet_HitReturnsData();
+    void put_ReplacesExistingEntry();
+    void evict_LeastRecentlyUsedFirst();
+    void put_EntryLargerThanBudgetIsSkipped();
+    void setMaxBytes_ShrinksCache();
+    void get_HitSharesEntry();
+};
+
+#endif
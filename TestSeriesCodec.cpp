@@ -0,0 +1,169 @@
+#include "TestSeriesCodec.h"
+#include <cmath>
+#include <random>
+
+SensorData TestSeriesCodec::hourlySeries(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.5);
+    const QDateTime newest = QDateTime::fromString("2024-05-01T12:00:00Z", Qt::ISODate);
+
+    SensorData data;
+    data.key = "PM10";
+    double level = 25.0;
+    for (int i = 0; i < count; ++i) {
+        level = std::max(0.0, level + step(rng));
+        MeasurementValue mv;
+        mv.date = newest.addSecs(-3600LL * i);
+        mv.value = std::round(level * 10.0) / 10.0;
+        data.values.push_back(mv);
+    }
+    return data;
+}
+
+bool TestSeriesCodec::sameSeries(const SensorData& a, const SensorData& b) {
+    if (a.key != b.key || a.values.size() != b.values.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.values.size(); ++i) {
+        const double x = a.values[i].value;
+        const double y = b.values[i].value;
+        if (a.values[i].date != b.values[i].date || !((std::isnan(x) && std::isnan(y)) || x == y)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Testy dla SeriesCodec
+
+void TestSeriesCodec::roundTrip_HourlySeriesWithNaN() {
+    SensorData data = hourlySeries(1000);
+    data.values[3].value = std::numeric_limits<double>::quiet_NaN();
+    data.values[500].value = std::numeric_limits<double>::quiet_NaN();
+
+    std::optional<SensorData> decoded = SeriesCodec::decode(SeriesCodec::encode(data));
+    QVERIFY(decoded.has_value());
+    QVERIFY(sameSeries(*decoded, data));
+}
+
+void TestSeriesCodec::roundTrip_IrregularDatesAndSpecialValues() {
+    SensorData data;
+    data.key = "PM2.5 µg/m³";
+    const QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const qint64 offsetsSecs[] = {0, 3600, 3601, 7300, 7200, 86400 * 40, 86400 * 40 + 1, -86400 * 400, 0, 100};
+    const double values[] = {0.0, -0.0, 1e-310, -5.25, std::numeric_limits<double>::infinity(), 1e300,
+                             std::numeric_limits<double>::quiet_NaN(), 3.0, 3.0, 123456.789};
+    for (int i = 0; i < 10; ++i) {
+        MeasurementValue mv;
+        mv.date = start.addMSecs(offsetsSecs[i] * 1000 + (i == 2 ? 17 : 0));
+        mv.value = values[i];
+        data.values.push_back(mv);
+    }
+
+    for (int blockSize : {2, 3, 256}) {
+        std::optional<SensorData> decoded = SeriesCodec::decode(SeriesCodec::encode(data, blockSize));
+        QVERIFY(decoded.has_value());
+        QVERIFY(sameSeries(*decoded, data));
+        QVERIFY(std::signbit(decoded->values[1].value)); // -0.0 zachowane bit w bit
+    }
+}
+
+void TestSeriesCodec::roundTrip_EmptySeries() {
+    SensorData data;
+    data.key = "NO2";
+    std::optional<SensorData> decoded = SeriesCodec::decode(SeriesCodec::encode(data));
+    QVERIFY(decoded.has_value());
+    QCOMPARE(decoded->key, QString("NO2"));
+    QVERIFY(decoded->values.empty());
+}
+
+void TestSeriesCodec::encode_FewBytesPerPoint() {
+    const int count = 24 * 365;
+    const QByteArray encoded = SeriesCodec::encode(hourlySeries(count));
+    const double bytesPerPoint = double(encoded.size()) / count;
+    qInfo() << "SeriesCodec:" << encoded.size() << "bajtów," << bytesPerPoint << "B/pomiar";
+    QVERIFY(bytesPerPoint < 6.0);
+
+    std::optional<std::vector<SeriesCodec::BlockInfo>> blocks = SeriesCodec::blocks(encoded);
+    QVERIFY(blocks.has_value());
+    QCOMPARE(int(blocks->size()), (count + SeriesCodec::DefaultBlockSize - 1) / SeriesCodec::DefaultBlockSize);
+}
+
+void TestSeriesCodec::decode_RangeDecodesOnlyOverlappingBlocks() {
+    const SensorData data = hourlySeries(1000);
+    const QByteArray encoded = SeriesCodec::encode(data, 100);
+    std::optional<std::vector<SeriesCodec::BlockInfo>> blocks = SeriesCodec::blocks(encoded);
+    QVERIFY(blocks.has_value());
+    QCOMPARE(blocks->size(), std::size_t(10));
+
+    // Pomiary od najnowszego: indeksy 250-349 to przedział [date(349), date(249)).
+    const QDateTime from = data.values[349].date;
+    const QDateTime to = data.values[249].date;
+    std::optional<SensorData> decoded = SeriesCodec::decode(encoded, from, to);
+    QVERIFY(decoded.has_value());
+    QCOMPARE(decoded->values.size(), std::size_t(100));
+    QCOMPARE(decoded->values.front().date, data.values[250].date);
+    QCOMPARE(decoded->values.back().date, data.values[349].date);
+
+    // Uszkodzenie bloku spoza przedziału nie przeszkadza w odczycie - nie jest dekodowany.
+    QByteArray damaged = encoded;
+    const int lastBlockStart = damaged.size() - int(blocks->back().size);
+    damaged.truncate(lastBlockStart + 16);
+    damaged.append(QByteArray(int(blocks->back().size) - 16, '\xff'));
+    QVERIFY(SeriesCodec::decode(damaged, from, to).has_value());
+    QVERIFY(!SeriesCodec::decode(damaged).has_value());
+}
+
+void TestSeriesCodec::readBlock_DecodesSingleBlock() {
+    SensorData data = hourlySeries(450);
+    const QByteArray encoded = SeriesCodec::encode(data, 100);
+    std::optional<std::vector<SeriesCodec::BlockInfo>> blocks = SeriesCodec::blocks(encoded);
+    QVERIFY(blocks.has_value());
+
+    // Bloki czytane po kolei dają całą serię
+    SensorData joined;
+    joined.key = data.key;
+    for (const SeriesCodec::BlockInfo& block : *blocks) {
+        QVERIFY(SeriesCodec::readBlock(encoded, block, joined.values));
+    }
+    QVERIFY(sameSeries(joined, data));
+
+    // Przedział dat i blok spoza danych
+    std::vector<MeasurementValue> values;
+    const qint64 from = data.values[40].date.toMSecsSinceEpoch();
+    QVERIFY(SeriesCodec::readBlock(encoded, blocks->front(), values, from));
+    QCOMPARE(values.size(), std::size_t(41));
+    SeriesCodec::BlockInfo outside = blocks->back();
+    outside.offset += 1000;
+    QVERIFY(!SeriesCodec::readBlock(encoded, outside, values));
+}
+
+void TestSeriesCodec::decode_CorruptedDataReturnsNullopt() {
+    const QByteArray encoded = SeriesCodec::encode(hourlySeries(300));
+    QVERIFY(!SeriesCodec::decode(QByteArray()).has_value());
+    QVERIFY(!SeriesCodec::decode(QByteArray("AQSC")).has_value());
+    QVERIFY(!SeriesCodec::decode(encoded.left(encoded.size() - 10)).has_value()); // ucięty blok
+
+    QByteArray wrongVersion = encoded;
+    wrongVersion[4] = char(99);
+    QVERIFY(!SeriesCodec::decode(wrongVersion).has_value());
+}
+
+void TestSeriesCodec::benchmark_Encode100k() {
+    const SensorData data = hourlySeries(100000);
+    QByteArray encoded;
+    QBENCHMARK {
+        encoded = SeriesCodec::encode(data);
+    }
+    QVERIFY(!encoded.isEmpty());
+}
+
+void TestSeriesCodec::benchmark_Decode100k() {
+    const QByteArray encoded = SeriesCodec::encode(hourlySeries(100000));
+    std::optional<SensorData> decoded;
+    QBENCHMARK {
+        decoded = SeriesCodec::decode(encoded);
+    }
+    QVERIFY(decoded.has_value());
+    QCOMPARE(decoded->values.size(), std::size_t(100000));
+}
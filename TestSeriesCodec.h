@@ -0,0 +1,32 @@
+#ifndef TESTSERIESCODEC_H
+#define TESTSERIESCODEC_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "SeriesCodec.h"
+#include "DataStructures.h"
+
+class TestSeriesCodec : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Seria godzinowa od najnowszego pomiaru (jak w API), wartości z jednym miejscem po przecinku.
+    SensorData hourlySeries(int count, unsigned seed = 1);
+    /// Czy serie mają ten sam klucz i te same pomiary (NaN jest równy NaN).
+    bool sameSeries(const SensorData& a, const SensorData& b);
+
+private slots:
+    void roundTrip_HourlySeriesWithNaN();
+    void roundTrip_IrregularDatesAndSpecialValues();
+    void roundTrip_EmptySeries();
+    void encode_FewBytesPerPoint();
+    void decode_RangeDecodesOnlyOverlappingBlocks();
+    void readBlock_DecodesSingleBlock();
+    void decode_CorruptedDataReturnsNullopt();
+
+    void benchmark_Encode100k();
+    void benchmark_Decode100k();
+};
+
+#endif
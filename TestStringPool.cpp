@@ -0,0 +1,38 @@
+#include "TestStringPool.h"
+#include <QtConcurrent/QtConcurrent>
+
+// Testy dla StringPool
+
+void TestStringPool::intern_ReturnsSharedBuffer() {
+    const QString first = StringPool::intern(QString("ŚWIĘTOKRZYSKIE"));
+    const QString second = StringPool::intern(QString("ŚWIĘTO") + QString("KRZYSKIE")); // osobna alokacja
+    QCOMPARE(second, first);
+    QCOMPARE(second.constData(), first.constData());
+
+    const int size = StringPool::size();
+    StringPool::intern(first);
+    QCOMPARE(StringPool::size(), size);
+}
+
+void TestStringPool::intern_EmptyStringUnchanged() {
+    const int size = StringPool::size();
+    QVERIFY(StringPool::intern(QString()).isNull());
+    QVERIFY(StringPool::intern(QString("")).isEmpty());
+    QCOMPARE(StringPool::size(), size);
+}
+
+void TestStringPool::intern_ConcurrentCallsShareOneEntry() {
+    QList<int> inputs;
+    for (int i = 0; i < 2000; ++i) {
+        inputs << i % 16;
+    }
+    const int size = StringPool::size();
+    const QList<QString> results = QtConcurrent::blockingMapped<QList<QString>>(inputs, [](int i) {
+        return StringPool::intern(QString("TestStringPool_%1").arg(i));
+    });
+
+    QCOMPARE(StringPool::size(), size + 16);
+    for (int i = 0; i < results.size(); ++i) {
+        QCOMPARE(results[i].constData(), results[i % 16].constData());
+    }
+}
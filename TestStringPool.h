@@ -0,0 +1,18 @@
+#ifndef TESTSTRINGPOOL_H
+#define TESTSTRINGPOOL_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "StringPool.h"
+
+class TestStringPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void intern_ReturnsSharedBuffer();
+    void intern_EmptyStringUnchanged();
+    void intern_ConcurrentCallsShareOneEntry();
+};
+
+#endif
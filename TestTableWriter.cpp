@@ -0,0 +1,104 @@
+#include "TestTableWriter.h"
+#include <QBuffer>
+#include <QtEndian>
+#include <limits>
+
+namespace {
+
+const qint64 Jan2024 = Q_INT64_C(1704067200000); // 2024-01-01T00:00:00Z
+
+std::vector<ColumnSpec> testColumns()
+{
+    return {{"sensor_id", ColumnType::Int32}, {"param", ColumnType::Utf8},
+            {"timestamp", ColumnType::Timestamp}, {"value", ColumnType::Float64}};
+}
+
+} // namespace
+
+// Testy dla TableWriter
+
+void TestTableWriter::csv_WritesHeaderValuesAndEmptyFields() {
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    std::unique_ptr<TableWriter> writer = TableWriter::create(ExportFormat::Csv, &buffer);
+    QVERIFY(writer->begin(testColumns()));
+
+    writer->setInt32(0, 1001);
+    writer->setUtf8(1, "PM10");
+    writer->setTimestamp(2, Jan2024 + 13 * 3600 * 1000);
+    writer->setFloat64(3, 0.1);
+    QVERIFY(writer->endRow());
+    writer->setInt32(0, -5);
+    writer->setTimestamp(2, -1); // przed 1970 r., z milisekundami
+    writer->setFloat64(3, std::numeric_limits<double>::quiet_NaN());
+    QVERIFY(writer->endRow());
+    QVERIFY(writer->finish());
+
+    QCOMPARE(buffer.data(), QByteArray("sensor_id,param,timestamp,value\n"
+                                       "1001,PM10,2024-01-01T13:00:00Z,0.1\n"
+                                       "-5,,1969-12-31T23:59:59.999Z,\n"));
+    QCOMPARE(writer->rowCount(), quint64(2));
+    QCOMPARE(writer->bytesWritten(), qint64(buffer.data().size()));
+}
+
+void TestTableWriter::csv_QuotesTextWithSeparators() {
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    std::unique_ptr<TableWriter> writer = TableWriter::create(ExportFormat::Csv, &buffer);
+    QVERIFY(writer->begin({{"name, city", ColumnType::Utf8}, {"value", ColumnType::Float64}}));
+    writer->setUtf8(0, QString("Kraków, \"Aleja\"").toUtf8());
+    writer->setFloat64(1, 1e-7);
+    QVERIFY(writer->endRow());
+    QVERIFY(writer->finish());
+
+    QCOMPARE(buffer.data(), QString("\"name, city\",value\n\"Kraków, \"\"Aleja\"\"\",1e-07\n").toUtf8());
+}
+
+void TestTableWriter::csv_WritesRowsInBatches() {
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    std::unique_ptr<TableWriter> writer = TableWriter::create(ExportFormat::Csv, &buffer);
+    QVERIFY(writer->begin({{"value", ColumnType::Int32}}));
+    const int rows = TableWriter::BatchRows + 10;
+    for (int i = 0; i < rows; ++i) {
+        writer->setInt32(0, i);
+        QVERIFY(writer->endRow());
+    }
+    QVERIFY(buffer.data().size() > 0); // pełna partia jest zapisywana przed finish()
+    QVERIFY(writer->finish());
+
+    QCOMPARE(writer->rowCount(), quint64(rows));
+    QCOMPARE(buffer.data().count('\n'), rows + 1);
+    QVERIFY(buffer.data().endsWith(QByteArray::number(rows - 1) + '\n'));
+}
+
+void TestTableWriter::arrow_WritesFileStructure() {
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    std::unique_ptr<TableWriter> writer = TableWriter::create(ExportFormat::ArrowIpc, &buffer);
+    QVERIFY(writer->begin(testColumns()));
+    for (int i = 0; i < 3; ++i) {
+        writer->setInt32(0, 1001);
+        writer->setUtf8(1, "PM10");
+        writer->setTimestamp(2, Jan2024 + i * 3600 * 1000);
+        if (i != 1) {
+            writer->setFloat64(3, 10.0 * i);
+        }
+        QVERIFY(writer->endRow());
+    }
+    QVERIFY(writer->finish());
+
+    const QByteArray bytes = buffer.data();
+    QVERIFY(bytes.startsWith(QByteArray("ARROW1\0\0", 8)));
+    QVERIFY(bytes.endsWith("ARROW1"));
+    // Pierwszy komunikat (schemat) zaczyna się znacznikiem kontynuacji i ma wyrównane metadane
+    QCOMPARE(qFromLittleEndian<quint32>(bytes.constData() + 8), 0xFFFFFFFFu);
+    QCOMPARE(qFromLittleEndian<qint32>(bytes.constData() + 12) % 8, 0);
+    // Długość stopki wskazuje na znacznik końca strumienia tuż przed nią
+    const qint32 footerLength = qFromLittleEndian<qint32>(bytes.constData() + bytes.size() - 10);
+    const qint64 footerStart = bytes.size() - 10 - footerLength;
+    QVERIFY(footerLength > 0 && footerStart > 16);
+    QCOMPARE(qFromLittleEndian<quint32>(bytes.constData() + footerStart - 8), 0xFFFFFFFFu);
+    QCOMPARE(qFromLittleEndian<qint32>(bytes.constData() + footerStart - 4), 0);
+    QCOMPARE(writer->bytesWritten(), qint64(bytes.size()));
+}
@@ -0,0 +1,19 @@
+#ifndef TESTTABLEWRITER_H
+#define TESTTABLEWRITER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "TableWriter.h"
+
+class TestTableWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void csv_WritesHeaderValuesAndEmptyFields();
+    void csv_QuotesTextWithSeparators();
+    void csv_WritesRowsInBatches();
+    void arrow_WritesFileStructure();
+};
+
+#endif
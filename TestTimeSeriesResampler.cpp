@@ -0,0 +1,150 @@
+#include "TestTimeSeriesResampler.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+std::vector<MeasurementValue> TestTimeSeriesResampler::createHourlyValues(const QDateTime& start, const std::vector<double>& values) {
+    std::vector<MeasurementValue> result;
+    for (size_t i = 0; i < values.size(); ++i) {
+        result.push_back({start.addSecs(static_cast<qint64>(i) * 3600), values[i]});
+    }
+    return result;
+}
+
+// Testy dla TimeSeriesResampler
+
+void TestTimeSeriesResampler::resample_MarksGaps() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<MeasurementValue> values = createHourlyValues(start, {1.0, nan, nan, 4.0, 5.0});
+    values.push_back({start.addSecs(7 * 3600), 8.0}); // brakujące godziny 5 i 6
+
+    ResampledSeries series = TimeSeriesResampler::resample(values);
+    QCOMPARE(series.size(), size_t(8));
+    QCOMPARE(series.timeAt(0), start);
+    QCOMPARE(series.timeAt(7), start.addSecs(7 * 3600));
+    QCOMPARE(series.missingCount(), size_t(4));
+    QVERIFY(std::isnan(series.values[1]));
+    QCOMPARE(series.flags[1], quint8(ResampledSeries::Missing));
+    QCOMPARE(series.values[3], 4.0);
+
+    QCOMPARE(series.gaps.size(), size_t(2));
+    QCOMPARE(series.gaps[0].first, size_t(1));
+    QCOMPARE(series.gaps[0].length, size_t(2));
+    QCOMPARE(series.gaps[1].first, size_t(5));
+    QCOMPARE(series.gaps[1].length, size_t(2));
+
+    QCOMPARE(series.toMeasurements().size(), size_t(4));
+    QCOMPARE(series.toMeasurements(true).size(), size_t(8));
+}
+
+void TestTimeSeriesResampler::resample_AveragesWithinStep() {
+    QDateTime start = QDateTime::fromString("2024-01-01T10:00:00Z", Qt::ISODate);
+    std::vector<MeasurementValue> values = {
+        {start.addSecs(600), 10.0},  // 10:10
+        {start.addSecs(2400), 20.0}, // 10:40
+        {start.addSecs(3600), 5.0},  // 11:00
+    };
+
+    ResampledSeries series = TimeSeriesResampler::resample(values);
+    QCOMPARE(series.size(), size_t(2));
+    QCOMPARE(series.timeAt(0), start);
+    QCOMPARE(series.values[0], 15.0);
+    QCOMPARE(series.values[1], 5.0);
+    QVERIFY(series.gaps.empty());
+}
+
+void TestTimeSeriesResampler::resample_DescendingInput() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    std::vector<MeasurementValue> values = createHourlyValues(start, {1.0, 2.0, 3.0});
+    std::reverse(values.begin(), values.end()); // API zwraca dane od najnowszych
+
+    ResampledSeries series = TimeSeriesResampler::resample(values);
+    QCOMPARE(series.size(), size_t(3));
+    QCOMPARE(series.values[0], 1.0);
+    QCOMPARE(series.values[2], 3.0);
+}
+
+void TestTimeSeriesResampler::fill_Linear() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ResampleOptions options;
+    options.fill = GapFill::Linear;
+
+    ResampledSeries series = TimeSeriesResampler::resample(createHourlyValues(start, {10.0, nan, nan, 40.0}), options);
+    QCOMPARE(series.values[1], 20.0);
+    QCOMPARE(series.values[2], 30.0);
+    QCOMPARE(series.flags[1], quint8(ResampledSeries::Interpolated));
+    QCOMPARE(series.missingCount(), size_t(0));
+    QCOMPARE(series.gaps.size(), size_t(1)); // luki opisują stan przed uzupełnieniem
+}
+
+void TestTimeSeriesResampler::fill_LinearRespectsLimit() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ResampleOptions options;
+    options.fill = GapFill::Linear;
+    options.maxFillSteps = 2;
+
+    // Luka 3h (za długa) i luka 1h
+    ResampledSeries series = TimeSeriesResampler::resample(
+        createHourlyValues(start, {1.0, nan, nan, nan, 5.0, nan, 7.0}), options);
+    QCOMPARE(series.missingCount(), size_t(3));
+    QVERIFY(std::isnan(series.values[2]));
+    QCOMPARE(series.values[5], 6.0);
+}
+
+void TestTimeSeriesResampler::fill_ForwardRespectsLimit() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ResampleOptions options;
+    options.fill = GapFill::Forward;
+    options.maxFillSteps = 2;
+
+    ResampledSeries series = TimeSeriesResampler::resample(
+        createHourlyValues(start, {3.0, nan, nan, nan, 9.0}), options);
+    QCOMPARE(series.values[1], 3.0);
+    QCOMPARE(series.values[2], 3.0);
+    QCOMPARE(series.flags[2], quint8(ResampledSeries::ForwardFilled));
+    QVERIFY(std::isnan(series.values[3]));
+    QCOMPARE(series.missingCount(), size_t(1));
+}
+
+void TestTimeSeriesResampler::resample_ExplicitRange() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    ResampleOptions options;
+    options.fill = GapFill::Linear;
+
+    ResampledSeries series = TimeSeriesResampler::resample(createHourlyValues(start, {1.0, 2.0, 3.0}),
+                                                           start.addSecs(-2 * 3600), start.addSecs(3600), options);
+    QCOMPARE(series.size(), size_t(4));
+    QCOMPARE(series.timeAt(0), start.addSecs(-2 * 3600));
+    // Kroki przed pierwszym pomiarem nie są interpolowane, pomiar spoza zakresu jest pominięty
+    QVERIFY(std::isnan(series.values[0]));
+    QVERIFY(std::isnan(series.values[1]));
+    QCOMPARE(series.values[3], 2.0);
+}
+
+void TestTimeSeriesResampler::align_CommonGrid() {
+    QDateTime start = QDateTime::fromString("2024-01-01T00:00:00Z", Qt::ISODate);
+    std::vector<std::vector<MeasurementValue>> input = {
+        createHourlyValues(start, {1.0, 2.0}),
+        createHourlyValues(start.addSecs(2 * 3600), {7.0}),
+    };
+
+    std::vector<ResampledSeries> aligned = TimeSeriesResampler::align(input);
+    QCOMPARE(aligned.size(), size_t(2));
+    QCOMPARE(aligned[0].size(), size_t(3));
+    QCOMPARE(aligned[1].size(), size_t(3));
+    QCOMPARE(aligned[0].startMSecs, aligned[1].startMSecs);
+    QVERIFY(std::isnan(aligned[0].values[2]));
+    QVERIFY(std::isnan(aligned[1].values[0]));
+    QCOMPARE(aligned[1].values[2], 7.0);
+}
+
+void TestTimeSeriesResampler::resample_EmptyInput() {
+    QVERIFY(TimeSeriesResampler::resample({}).isEmpty());
+    std::vector<MeasurementValue> onlyNaN = {{QDateTime::currentDateTime(), std::numeric_limits<double>::quiet_NaN()}};
+    QVERIFY(TimeSeriesResampler::resample(onlyNaN).isEmpty());
+    QVERIFY(TimeSeriesResampler::align({}).empty());
+}
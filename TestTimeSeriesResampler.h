@@ -0,0 +1,28 @@
+#ifndef TESTTIMESERIESRESAMPLER_H
+#define TESTTIMESERIESRESAMPLER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "TimeSeriesResampler.h"
+#include "DataStructures.h"
+
+class TestTimeSeriesResampler : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::vector<MeasurementValue> createHourlyValues(const QDateTime& start, const std::vector<double>& values);
+
+private slots:
+    void resample_MarksGaps();
+    void resample_AveragesWithinStep();
+    void resample_DescendingInput();
+    void fill_Linear();
+    void fill_LinearRespectsLimit();
+    void fill_ForwardRespectsLimit();
+    void resample_ExplicitRange();
+    void align_CommonGrid();
+    void resample_EmptyInput();
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "TestWriteBehindQueue.h"
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+
+// Testy dla WriteBehindQueue
+
+void TestWriteBehindQueue::enqueue_CoalescesPendingWritesOfSameKey() {
+    WriteBehindQueue queue(16, 0);
+    QSemaphore started;
+    QSemaphore release;
+    QStringList written;
+    QMutex writtenMutex;
+
+    // Pierwszy zapis blokuje wątek zapisu, więc kolejne zlecenia czekają w kolejce.
+    QVERIFY(queue.enqueue("gate", [&] { started.release(); release.acquire(); return true; }));
+    started.acquire();
+    for (int i = 1; i <= 3; ++i) {
+        QVERIFY(queue.enqueue("sensor_1_data.json", [&, i] {
+            QMutexLocker locker(&writtenMutex);
+            written << QString("sensor_1_data.json:%1").arg(i);
+            return true;
+        }));
+    }
+    QVERIFY(queue.enqueue("stations.json", [&] {
+        QMutexLocker locker(&writtenMutex);
+        written << "stations.json";
+        return true;
+    }));
+    QCOMPARE(queue.pendingCount(), 2);
+    QVERIFY(queue.isPending("gate"));
+
+    release.release();
+    QVERIFY(queue.flush());
+    QCOMPARE(written, QStringList() << "sensor_1_data.json:3" << "stations.json"); // kolejność pierwszego zlecenia
+    const WriteBehindStats stats = queue.stats();
+    QCOMPARE(stats.enqueued, quint64(5));
+    QCOMPARE(stats.coalesced, quint64(2));
+    QCOMPARE(stats.written, quint64(3));
+    QCOMPARE(stats.failed, quint64(0));
+    QVERIFY(!queue.isPending("stations.json"));
+}
+
+void TestWriteBehindQueue::flush_WaitsForAllWritesAndReportsFailures() {
+    WriteBehindQueue queue(16, 1000); // flush() nie czeka na koniec okna zbierania partii
+    std::atomic<int> done{0};
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(queue.enqueue(QString("file_%1").arg(i), [&] { done++; return true; }));
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(queue.flush());
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(done.load(), 10);
+
+    QVERIFY(queue.enqueue("broken", [] { return false; }));
+    QVERIFY(!queue.flush());
+    QCOMPARE(queue.stats().failed, quint64(1));
+    QVERIFY(queue.flush()); // błąd jest zgłaszany tylko raz
+}
+
+void TestWriteBehindQueue::flushKey_WaitsOnlyForPendingKey() {
+    WriteBehindQueue queue(16, 1000);
+    std::atomic<bool> written{false};
+    QVERIFY(queue.enqueue("a", [&] { written = true; return true; }));
+
+    queue.flushKey("other"); // nic nie czeka - wraca od razu
+    queue.flushKey("a");
+    QVERIFY(written.load());
+    QVERIFY(!queue.isPending("a"));
+    QCOMPARE(queue.pendingCount(), 0);
+}
+
+void TestWriteBehindQueue::shutdown_DrainsQueueAndWritesSynchronouslyAfterwards() {
+    std::atomic<int> done{0};
+    {
+        WriteBehindQueue queue(4, 1000);
+        for (int i = 0; i < 20; ++i) { // więcej kluczy niż pojemność - enqueue czeka na miejsce
+            QVERIFY(queue.enqueue(QString::number(i), [&] { done++; return true; }));
+        }
+        queue.shutdown();
+        QCOMPARE(done.load(), 20);
+
+        QVERIFY(queue.enqueue("late", [&] { done++; return true; }));
+        QCOMPARE(done.load(), 21); // po shutdown() zapis w wątku wywołującym
+        QVERIFY(!queue.enqueue("late-broken", [] { return false; }));
+    }
+    QCOMPARE(done.load(), 21);
+}
+
+void TestWriteBehindQueue::enqueue_DuringShutdownKeepsOrderOfSameKey() {
+    WriteBehindQueue queue(16, 0);
+    QSemaphore started;
+    QSemaphore release;
+    QMutex contentMutex;
+    QString content;
+
+    // Starszy zapis klucza trwa, gdy inny wątek wywołuje shutdown(), a kolejny zapis tego klucza przychodzi w tym czasie.
+    QVERIFY(queue.enqueue("sensor_1_series.bin", [&] {
+        started.release();
+        release.acquire();
+        QMutexLocker locker(&contentMutex);
+        content = "old";
+        return true;
+    }));
+    started.acquire();
+    QThread* stopper = QThread::create([&queue] { queue.shutdown(); });
+    stopper->start();
+    QThread::msleep(50);
+    QVERIFY(queue.enqueue("sensor_1_series.bin", [&] {
+        QMutexLocker locker(&contentMutex);
+        content = "new";
+        return true;
+    }));
+
+    release.release();
+    stopper->wait();
+    delete stopper;
+    QCOMPARE(content, QString("new"));
+    QCOMPARE(queue.stats().written, quint64(2));
+}
@@ -0,0 +1,20 @@
+#ifndef TESTWRITEBEHINDQUEUE_H
+#define TESTWRITEBEHINDQUEUE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "WriteBehindQueue.h"
+
+class TestWriteBehindQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void enqueue_CoalescesPendingWritesOfSameKey();
+    void flush_WaitsForAllWritesAndReportsFailures();
+    void flushKey_WaitsOnlyForPendingKey();
+    void shutdown_DrainsQueueAndWritesSynchronouslyAfterwards();
+    void enqueue_DuringShutdownKeepsOrderOfSameKey();
+};
+
+#endif
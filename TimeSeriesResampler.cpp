@@ -0,0 +1,183 @@
+#include "TimeSeriesResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QDateTime ResampledSeries::timeAt(std::size_t i) const
+{
+    return QDateTime::fromMSecsSinceEpoch(startMSecs + static_cast<qint64>(i) * stepSecs * 1000);
+}
+
+std::size_t ResampledSeries::missingCount() const
+{
+    return static_cast<std::size_t>(std::count(flags.begin(), flags.end(), quint8(Missing)));
+}
+
+std::vector<MeasurementValue> ResampledSeries::toMeasurements(bool includeMissing) const
+{
+    std::vector<MeasurementValue> result;
+    result.reserve(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (includeMissing || flags[i] != Missing) {
+            result.push_back({timeAt(i), values[i]});
+        }
+    }
+    return result;
+}
+
+qint64 TimeSeriesResampler::floorToStep(qint64 msecs, qint64 stepMSecs)
+{
+    qint64 q = msecs / stepMSecs;
+    if (msecs % stepMSecs < 0) {
+        --q;
+    }
+    return q * stepMSecs;
+}
+
+ResampledSeries TimeSeriesResampler::resample(const std::vector<MeasurementValue>& values, const ResampleOptions& options)
+{
+    if (options.stepSecs <= 0) {
+        return ResampledSeries();
+    }
+
+    qint64 first = std::numeric_limits<qint64>::max();
+    qint64 last = std::numeric_limits<qint64>::min();
+    for (const MeasurementValue& mv : values) {
+        if (mv.date.isValid() && !std::isnan(mv.value)) {
+            const qint64 t = mv.date.toMSecsSinceEpoch();
+            first = std::min(first, t);
+            last = std::max(last, t);
+        }
+    }
+    if (first > last) {
+        ResampledSeries empty;
+        empty.stepSecs = options.stepSecs;
+        return empty;
+    }
+
+    const qint64 stepMSecs = options.stepSecs * 1000;
+    return resampleToGrid(values, floorToStep(first, stepMSecs), floorToStep(last, stepMSecs), options);
+}
+
+ResampledSeries TimeSeriesResampler::resample(const std::vector<MeasurementValue>& values, const QDateTime& from,
+                                              const QDateTime& to, const ResampleOptions& options)
+{
+    if (options.stepSecs <= 0 || !from.isValid() || !to.isValid() || to < from) {
+        return ResampledSeries();
+    }
+
+    const qint64 stepMSecs = options.stepSecs * 1000;
+    return resampleToGrid(values, floorToStep(from.toMSecsSinceEpoch(), stepMSecs),
+                          floorToStep(to.toMSecsSinceEpoch(), stepMSecs), options);
+}
+
+std::vector<ResampledSeries> TimeSeriesResampler::align(const std::vector<std::vector<MeasurementValue>>& series,
+                                                        const ResampleOptions& options)
+{
+    std::vector<ResampledSeries> result(series.size());
+    if (options.stepSecs <= 0) {
+        return result;
+    }
+
+    qint64 first = std::numeric_limits<qint64>::max();
+    qint64 last = std::numeric_limits<qint64>::min();
+    for (const std::vector<MeasurementValue>& values : series) {
+        for (const MeasurementValue& mv : values) {
+            if (mv.date.isValid() && !std::isnan(mv.value)) {
+                const qint64 t = mv.date.toMSecsSinceEpoch();
+                first = std::min(first, t);
+                last = std::max(last, t);
+            }
+        }
+    }
+    if (first > last) {
+        return result;
+    }
+
+    const qint64 stepMSecs = options.stepSecs * 1000;
+    first = floorToStep(first, stepMSecs);
+    last = floorToStep(last, stepMSecs);
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        result[i] = resampleToGrid(series[i], first, last, options);
+    }
+    return result;
+}
+
+ResampledSeries TimeSeriesResampler::resampleToGrid(const std::vector<MeasurementValue>& values, qint64 firstMSecs,
+                                                    qint64 lastMSecs, const ResampleOptions& options)
+{
+    const qint64 stepMSecs = options.stepSecs * 1000;
+    const std::size_t size = static_cast<std::size_t>((lastMSecs - firstMSecs) / stepMSecs) + 1;
+
+    ResampledSeries series;
+    series.startMSecs = firstMSecs;
+    series.stepSecs = options.stepSecs;
+    series.values.assign(size, 0.0);
+    series.flags.assign(size, ResampledSeries::Missing);
+
+    // Sumy i liczności pomiarów w krokach - średnia, gdy w jednym kroku jest kilka pomiarów
+    std::vector<int> counts(size, 0);
+    for (const MeasurementValue& mv : values) {
+        if (!mv.date.isValid() || std::isnan(mv.value)) {
+            continue;
+        }
+        const qint64 t = mv.date.toMSecsSinceEpoch();
+        if (t < firstMSecs || t >= lastMSecs + stepMSecs) {
+            continue;
+        }
+        const std::size_t slot = static_cast<std::size_t>((t - firstMSecs) / stepMSecs);
+        series.values[slot] += mv.value;
+        counts[slot]++;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t i = 0; i < size; ++i) {
+        if (counts[i] > 0) {
+            series.values[i] /= counts[i];
+            series.flags[i] = ResampledSeries::Measured;
+        } else {
+            series.values[i] = nan;
+            if (!series.gaps.empty() && series.gaps.back().first + series.gaps.back().length == i) {
+                series.gaps.back().length++;
+            } else {
+                series.gaps.push_back({i, 1});
+            }
+        }
+    }
+
+    fillGaps(series, options);
+    return series;
+}
+
+void TimeSeriesResampler::fillGaps(ResampledSeries& series, const ResampleOptions& options)
+{
+    if (options.fill == GapFill::None) {
+        return;
+    }
+
+    const std::size_t limit = options.maxFillSteps > 0 ? static_cast<std::size_t>(options.maxFillSteps)
+                                                       : std::numeric_limits<std::size_t>::max();
+    for (const GapSpan& gap : series.gaps) {
+        // Luka na początku siatki nie ma pomiaru z lewej strony - nie da się jej uzupełnić
+        if (gap.first == 0) {
+            continue;
+        }
+        const std::size_t left = gap.first - 1;
+        const std::size_t right = gap.first + gap.length; // == size(), gdy luka sięga końca siatki
+
+        if (options.fill == GapFill::Forward) {
+            const std::size_t count = std::min(gap.length, limit);
+            for (std::size_t i = gap.first; i < gap.first + count; ++i) {
+                series.values[i] = series.values[left];
+                series.flags[i] = ResampledSeries::ForwardFilled;
+            }
+        } else if (right < series.size() && gap.length <= limit) {
+            const double y0 = series.values[left];
+            const double dy = (series.values[right] - y0) / static_cast<double>(gap.length + 1);
+            for (std::size_t i = gap.first; i < right; ++i) {
+                series.values[i] = y0 + dy * static_cast<double>(i - left);
+                series.flags[i] = ResampledSeries::Interpolated;
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/**
+ * @file TimeSeriesResampler.h
+ * @brief Definicja klasy TimeSeriesResampler - wyrównywania serii pomiarowych do regularnej siatki czasu.
+ */
+#ifndef TIMESERIESRESAMPLER_H
+#define TIMESERIESRESAMPLER_H
+
+#include <QDateTime>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+#include "DataStructures.h"
+
+/**
+ * @enum GapFill
+ * @brief Sposób uzupełniania luk w serii wyrównanej do siatki.
+ */
+enum class GapFill {
+    None,   ///< Luki pozostają jako NaN.
+    Linear, ///< Interpolacja liniowa między pomiarami po obu stronach luki.
+    Forward ///< Powielenie ostatniego pomiaru przed luką.
+};
+
+/**
+ * @struct ResampleOptions
+ * @brief Opcje wyrównywania serii.
+ */
+struct ResampleOptions {
+    qint64 stepSecs = 3600;     ///< Krok siatki w sekundach (domyślnie godzina). Siatka jest wyrównana do wielokrotności kroku od epoki Unix.
+    GapFill fill = GapFill::None; ///< Sposób uzupełniania luk.
+    /**
+     * @brief Limit uzupełniania w krokach siatki (0 - bez limitu).
+     * Dla GapFill::Linear luki dłuższe niż limit nie są uzupełniane wcale, dla GapFill::Forward
+     * uzupełniane jest tylko pierwszych `maxFillSteps` kroków luki.
+     */
+    int maxFillSteps = 3;
+};
+
+/**
+ * @struct GapSpan
+ * @brief Ciągły fragment siatki bez pomiaru (przed uzupełnianiem).
+ */
+struct GapSpan {
+    std::size_t first = 0;  ///< Indeks pierwszego brakującego kroku.
+    std::size_t length = 0; ///< Liczba brakujących kroków.
+};
+
+/**
+ * @struct ResampledSeries
+ * @brief Gęsta seria wyrównana do regularnej siatki czasu.
+ *
+ * Wartość i-tego kroku odpowiada chwili startMSecs + i·stepSecs. Flagi pozwalają odróżnić pomiary od luk
+ * i wartości uzupełnionych, więc kolejne etapy (np. korelacje) mogą pracować bezpośrednio na tablicy `values`.
+ */
+struct ResampledSeries {
+    /// Pochodzenie wartości kroku siatki.
+    enum SampleFlag : quint8 {
+        Measured = 0,      ///< Średnia pomiarów z kroku.
+        Missing = 1,       ///< Brak pomiaru (wartość NaN).
+        Interpolated = 2,  ///< Uzupełnione interpolacją liniową.
+        ForwardFilled = 3  ///< Uzupełnione ostatnim pomiarem.
+    };
+
+    qint64 startMSecs = 0;         ///< Początek siatki (ms od epoki Unix).
+    qint64 stepSecs = 3600;        ///< Krok siatki w sekundach.
+    std::vector<double> values;    ///< Wartości kroków (NaN dla luk).
+    std::vector<quint8> flags;     ///< Flagi SampleFlag kroków.
+    std::vector<GapSpan> gaps;     ///< Luki wykryte przed uzupełnianiem, w kolejności czasu.
+
+    /** @brief Liczba kroków siatki. */
+    std::size_t size() const { return values.size(); }
+    /** @brief Czy seria jest pusta. */
+    bool isEmpty() const { return values.empty(); }
+    /** @brief Chwila i-tego kroku (czas lokalny). */
+    QDateTime timeAt(std::size_t i) const;
+    /** @brief Liczba kroków, które nadal nie mają wartości (flaga Missing). */
+    std::size_t missingCount() const;
+    /**
+     * @brief Zamienia serię na pomiary (np. dla wykresu lub DataAnalyzer).
+     * @param includeMissing Czy dołączyć kroki bez wartości (jako NaN).
+     */
+    std::vector<MeasurementValue> toMeasurements(bool includeMissing = false) const;
+};
+
+/**
+ * @class TimeSeriesResampler
+ * @brief Wyrównuje serie pomiarowe do regularnej siatki, oznacza luki i opcjonalnie je uzupełnia.
+ *
+ * Pomiary są przypisywane do kroku siatki, w którym leżą (zaokrąglenie w dół); kilka pomiarów w jednym kroku
+ * jest uśrednianych. Wartości NaN i błędne daty są pomijane, kolejność wejścia jest dowolna.
+ * Koszt: O(n + m), gdzie m to liczba kroków siatki.
+ */
+class TimeSeriesResampler
+{
+public:
+    /**
+     * @brief Wyrównuje serię do siatki od kroku pierwszego do kroku ostatniego prawidłowego pomiaru.
+     * @param values Dane pomiarowe.
+     * @param options Opcje wyrównania.
+     * @return Seria wyrównana; pusta, jeśli brak prawidłowych pomiarów lub krok <= 0.
+     */
+    static ResampledSeries resample(const std::vector<MeasurementValue>& values, const ResampleOptions& options = {});
+
+    /**
+     * @brief Wyrównuje serię do siatki obejmującej podany zakres (włącznie).
+     * Pomiary spoza zakresu są pomijane; kroki na brzegach bez pomiarów są lukami (nieuzupełnianymi interpolacją).
+     * @return Seria wyrównana; pusta, jeśli zakres jest nieprawidłowy lub krok <= 0.
+     */
+    static ResampledSeries resample(const std::vector<MeasurementValue>& values, const QDateTime& from,
+                                    const QDateTime& to, const ResampleOptions& options = {});
+
+    /**
+     * @brief Wyrównuje kilka serii do wspólnej siatki (od najwcześniejszego do najpóźniejszego pomiaru wszystkich serii).
+     * Wszystkie wyniki mają ten sam startMSecs i rozmiar, więc i-te elementy dotyczą tej samej chwili.
+     * @return Serie w kolejności wejścia; puste, jeśli żadna seria nie ma prawidłowych pomiarów.
+     */
+    static std::vector<ResampledSeries> align(const std::vector<std::vector<MeasurementValue>>& series,
+                                              const ResampleOptions& options = {});
+
+private:
+    /// Zaokrągla chwilę (ms) w dół do wielokrotności kroku.
+    static qint64 floorToStep(qint64 msecs, qint64 stepMSecs);
+    /// Buduje siatkę [firstMSecs, lastMSecs] (już wyrównane do kroku), oznacza luki i uzupełnia je.
+    static ResampledSeries resampleToGrid(const std::vector<MeasurementValue>& values, qint64 firstMSecs,
+                                          qint64 lastMSecs, const ResampleOptions& options);
+    /// Uzupełnia luki zgodnie z opcjami.
+    static void fillGaps(ResampledSeries& series, const ResampleOptions& options);
+};
+
+#endif // TIMESERIESRESAMPLER_H
@@ -0,0 +1,387 @@
+#include "TrendEstimator.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+/// Punkty posortowane rosnąco po X, bez powtórzeń X.
+struct SortedPoints {
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+SortedPoints prepareSortedPoints(const std::vector<double>& x, const std::vector<double>& y)
+{
+    const std::size_t n = std::min(x.size(), y.size());
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&x](std::size_t a, std::size_t b) { return x[a] < x[b]; });
+
+    SortedPoints points;
+    points.x.reserve(n);
+    points.y.reserve(n);
+    std::size_t i = 0;
+    while (i < n) {
+        const double currentX = x[order[i]];
+        double sumY = 0.0;
+        std::size_t count = 0;
+        while (i < n && x[order[i]] == currentX) {
+            sumY += y[order[i]];
+            ++count;
+            ++i;
+        }
+        points.x.push_back(currentX);
+        points.y.push_back(sumY / static_cast<double>(count));
+    }
+    return points;
+}
+
+/**
+ * Zlicza pary (i < j) z values[j] <= values[i] sortowaniem przez scalanie (wstępującym, bez rekurencji).
+ * Sortuje `values`; `buffer` jest buforem roboczym tego samego rozmiaru.
+ */
+std::uint64_t countNonStrictInversions(std::vector<double>& values, std::vector<double>& buffer)
+{
+    const std::size_t n = values.size();
+    std::uint64_t inversions = 0;
+    for (std::size_t width = 1; width < n; width *= 2) {
+        for (std::size_t lo = 0; lo < n; lo += 2 * width) {
+            const std::size_t mid = std::min(lo + width, n);
+            const std::size_t hi = std::min(lo + 2 * width, n);
+            std::size_t a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                if (values[b] <= values[a]) {
+                    inversions += mid - a;
+                    buffer[k++] = values[b++];
+                } else {
+                    buffer[k++] = values[a++];
+                }
+            }
+            while (a < mid) buffer[k++] = values[a++];
+            while (b < hi) buffer[k++] = values[b++];
+        }
+        values.swap(buffer);
+    }
+    return inversions;
+}
+
+/// Liczba par punktów o nachyleniu <= theta (inwersje ciągu y - theta·x).
+std::uint64_t countSlopesAtMost(const SortedPoints& points, double theta,
+                                std::vector<double>& work, std::vector<double>& buffer)
+{
+    for (std::size_t i = 0; i < points.x.size(); ++i) {
+        work[i] = points.y[i] - theta * points.x[i];
+    }
+    return countNonStrictInversions(work, buffer);
+}
+
+/**
+ * Wyznacza nachylenia par z przedziału (lo, hi].
+ * Punkty są ustawiane w kolejności y - lo·x (przy remisie - malejąco po indeksie); para należy do przedziału
+ * dokładnie wtedy, gdy w tej kolejności tworzy inwersję ciągu y - hi·x, a jej punkty są w kolejności rosnących X.
+ */
+void collectSlopesInRange(const SortedPoints& points, double lo, double hi, std::vector<double>& out)
+{
+    struct Item {
+        double value;
+        std::size_t index;
+    };
+
+    const std::size_t n = points.x.size();
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> atLo(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        atLo[i] = points.y[i] - lo * points.x[i];
+    }
+    std::sort(order.begin(), order.end(), [&atLo](std::size_t a, std::size_t b) {
+        return atLo[a] < atLo[b] || (atLo[a] == atLo[b] && a > b);
+    });
+
+    std::vector<Item> items(n);
+    std::vector<Item> buffer(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        items[i] = Item{points.y[order[i]] - hi * points.x[order[i]], order[i]};
+    }
+
+    for (std::size_t width = 1; width < n; width *= 2) {
+        for (std::size_t lo2 = 0; lo2 < n; lo2 += 2 * width) {
+            const std::size_t mid = std::min(lo2 + width, n);
+            const std::size_t hi2 = std::min(lo2 + 2 * width, n);
+            std::size_t a = lo2, b = mid, k = lo2;
+            while (a < mid && b < hi2) {
+                if (items[b].value <= items[a].value) {
+                    const std::size_t j = items[b].index;
+                    for (std::size_t t = a; t < mid; ++t) {
+                        const std::size_t i = items[t].index;
+                        if (i < j) {
+                            out.push_back((points.y[j] - points.y[i]) / (points.x[j] - points.x[i]));
+                        }
+                    }
+                    buffer[k++] = items[b++];
+                } else {
+                    buffer[k++] = items[a++];
+                }
+            }
+            while (a < mid) buffer[k++] = items[a++];
+            while (b < hi2) buffer[k++] = items[b++];
+        }
+        items.swap(buffer);
+    }
+}
+
+/// Przedział nachyleń (lo, hi] wraz z liczbą par o nachyleniu <= lo i <= hi.
+struct SlopeBracket {
+    double lo;
+    double hi;
+    std::uint64_t countLo;
+    std::uint64_t countHi;
+};
+
+/**
+ * Wyznacza nachylenia o rangach rankLow i rankHigh (rankHigh - rankLow <= 1), zawężając przedział `bracket`.
+ * Niezmiennik: countLo <= rankLow oraz countHi > rankHigh.
+ */
+void selectSlopes(const SortedPoints& points, std::uint64_t rankLow, std::uint64_t rankHigh, SlopeBracket bracket,
+                  double tolerance, std::vector<double>& work, std::vector<double>& buffer,
+                  double& slopeLow, double& slopeHigh)
+{
+    const std::uint64_t enumerateLimit = std::max<std::uint64_t>(points.x.size(), 1024);
+    const double target = (static_cast<double>(rankLow) + static_cast<double>(rankHigh)) / 2.0 + 0.5;
+    bool interpolate = true;
+
+    while (bracket.countHi - bracket.countLo > enumerateLimit) {
+        if (bracket.hi - bracket.lo <= tolerance) {
+            slopeLow = slopeHigh = bracket.hi;
+            return;
+        }
+
+        // Interpolacja liniowa rangi w przedziale daje dwa punkty tuż poniżej i tuż powyżej szukanej rangi,
+        // dzięki czemu przesuwają się oba końce przedziału (czysta regula falsi utyka na jednym końcu).
+        // Gdy interpolacja nie zmniejszyła przedziału co najmniej czterokrotnie, następny krok to bisekcja.
+        const std::uint64_t previousWidth = bracket.countHi - bracket.countLo;
+        double thetas[2];
+        int thetaCount = 0;
+        if (interpolate) {
+            const double width = static_cast<double>(previousWidth);
+            const double margin = std::max(static_cast<double>(enumerateLimit) / 4.0, width / 64.0);
+            for (double rank : {target - margin, target + margin}) {
+                const double fraction = (rank - static_cast<double>(bracket.countLo)) / width;
+                thetas[thetaCount++] = bracket.lo + (bracket.hi - bracket.lo) * fraction;
+            }
+        } else {
+            thetas[thetaCount++] = bracket.lo + (bracket.hi - bracket.lo) / 2.0;
+        }
+
+        bool progressed = false;
+        for (int t = 0; t < thetaCount; ++t) {
+            const double theta = thetas[t];
+            if (!(theta > bracket.lo && theta < bracket.hi)) {
+                continue;
+            }
+            progressed = true;
+            const std::uint64_t count = countSlopesAtMost(points, theta, work, buffer);
+            if (count > rankHigh) {
+                bracket.hi = theta;
+                bracket.countHi = count;
+            } else if (count <= rankLow) {
+                bracket.lo = theta;
+                bracket.countLo = count;
+            } else {
+                // theta rozdziela obie rangi - każdą wyznaczamy w jej części przedziału.
+                double unused = 0.0;
+                selectSlopes(points, rankLow, rankLow, SlopeBracket{bracket.lo, theta, bracket.countLo, count},
+                             tolerance, work, buffer, slopeLow, unused);
+                selectSlopes(points, rankHigh, rankHigh, SlopeBracket{theta, bracket.hi, count, bracket.countHi},
+                             tolerance, work, buffer, unused, slopeHigh);
+                return;
+            }
+        }
+
+        if (!progressed) {
+            if (!interpolate) {
+                // Przedział o szerokości pojedynczej wartości double - wszystkie nachylenia w nim są równe hi.
+                slopeLow = slopeHigh = bracket.hi;
+                return;
+            }
+            interpolate = false;
+            continue;
+        }
+        interpolate = (bracket.countHi - bracket.countLo) * 4 <= previousWidth;
+    }
+
+    std::vector<double> slopes;
+    slopes.reserve(static_cast<std::size_t>(bracket.countHi - bracket.countLo));
+    collectSlopesInRange(points, bracket.lo, bracket.hi, slopes);
+    if (slopes.empty()) {
+        slopeLow = slopeHigh = bracket.hi;
+        return;
+    }
+
+    auto nth = [&slopes, &bracket](std::uint64_t rank) {
+        const std::size_t local = static_cast<std::size_t>(
+            std::min<std::uint64_t>(rank - bracket.countLo, slopes.size() - 1));
+        std::nth_element(slopes.begin(), slopes.begin() + static_cast<std::ptrdiff_t>(local), slopes.end());
+        return slopes[local];
+    };
+    slopeLow = nth(rankLow);
+    slopeHigh = (rankHigh == rankLow) ? slopeLow : nth(rankHigh);
+}
+
+/**
+ * Zwraca medianę nachyleń wszystkich par punktów (średnią dwóch środkowych dla parzystej liczby par).
+ * Początkowy przedział jest wyznaczany z próbki losowych par, co pomija kosztowne zawężanie
+ * od skrajnych nachyleń (np. wywołanych pojedynczym pikiem).
+ */
+double medianSlope(const SortedPoints& points)
+{
+    const std::size_t n = points.x.size();
+    const std::uint64_t pairs = static_cast<std::uint64_t>(n) * (n - 1) / 2;
+    const std::uint64_t rankLow = (pairs - 1) / 2;
+    const std::uint64_t rankHigh = pairs / 2;
+
+    // Skrajne nachylenia wszystkich par są osiągane dla sąsiednich punktów.
+    double minSlope = (points.y[1] - points.y[0]) / (points.x[1] - points.x[0]);
+    double maxSlope = minSlope;
+    for (std::size_t i = 1; i + 1 < n; ++i) {
+        const double s = (points.y[i + 1] - points.y[i]) / (points.x[i + 1] - points.x[i]);
+        minSlope = std::min(minSlope, s);
+        maxSlope = std::max(maxSlope, s);
+    }
+    if (minSlope == maxSlope) {
+        return minSlope;
+    }
+
+    std::vector<double> work(n);
+    std::vector<double> buffer(n);
+    const double tolerance = 1e-12 * (maxSlope - minSlope);
+
+    // Próbka nachyleń losowych par; jej kwantyle ±3 odchylenia wokół rangi mediany ograniczają przedział.
+    const std::size_t sampleSize = static_cast<std::size_t>(std::min<std::uint64_t>(pairs, std::max<std::size_t>(n, 2048)));
+    std::vector<double> sample;
+    sample.reserve(sampleSize);
+    std::mt19937_64 rng(0x7e11u);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    while (sample.size() < sampleSize) {
+        std::size_t i = pick(rng);
+        std::size_t j = pick(rng);
+        if (i == j) continue;
+        if (i > j) std::swap(i, j);
+        sample.push_back((points.y[j] - points.y[i]) / (points.x[j] - points.x[i]));
+    }
+    std::sort(sample.begin(), sample.end());
+
+    const double m = static_cast<double>(sampleSize);
+    const double margin = 3.0 * std::sqrt(m);
+    const double lowIndex = (static_cast<double>(rankLow) + 0.5) / static_cast<double>(pairs) * m - margin;
+    const double highIndex = (static_cast<double>(rankHigh) + 0.5) / static_cast<double>(pairs) * m + margin;
+
+    SlopeBracket bracket{minSlope - std::max(1.0, std::abs(minSlope)), maxSlope, 0, 0};
+    bool haveLo = false;
+    bool haveHi = false;
+    if (lowIndex >= 0.0) {
+        const double candidate = sample[static_cast<std::size_t>(lowIndex)];
+        const std::uint64_t count = countSlopesAtMost(points, candidate, work, buffer);
+        if (count <= rankLow) {
+            bracket.lo = candidate;
+            bracket.countLo = count;
+            haveLo = true;
+        }
+    }
+    if (highIndex < m) {
+        const double candidate = sample[static_cast<std::size_t>(highIndex)];
+        const std::uint64_t count = countSlopesAtMost(points, candidate, work, buffer);
+        if (count > rankHigh) {
+            bracket.hi = candidate;
+            bracket.countHi = count;
+            haveHi = true;
+        }
+    }
+    if (!haveLo) {
+        bracket.countLo = countSlopesAtMost(points, bracket.lo, work, buffer);
+    }
+    if (!haveHi) {
+        bracket.countHi = countSlopesAtMost(points, bracket.hi, work, buffer);
+    }
+    if (bracket.countLo > rankLow || bracket.countHi <= rankHigh) {
+        // Niespójność zaokrągleń przy skrajnych nachyleniach - zwracamy najbliższe ograniczenie.
+        return bracket.countLo > rankLow ? minSlope : maxSlope;
+    }
+
+    double slopeLow = 0.0;
+    double slopeHigh = 0.0;
+    selectSlopes(points, rankLow, rankHigh, bracket, tolerance, work, buffer, slopeLow, slopeHigh);
+    return (slopeLow + slopeHigh) / 2.0;
+}
+
+} // namespace
+
+double TrendEstimator::theilSenSlope(const std::vector<double>& x, const std::vector<double>& y)
+{
+    SortedPoints points = prepareSortedPoints(x, y);
+    if (points.x.size() < 2) {
+        return 0.0;
+    }
+    return medianSlope(points);
+}
+
+MannKendallResult TrendEstimator::mannKendall(const std::vector<double>& y)
+{
+    MannKendallResult result;
+    const std::size_t n = y.size();
+    if (n < 3) {
+        return result;
+    }
+
+    // Rangi wartości (1..m) dla drzewa Fenwicka.
+    std::vector<double> sortedValues(y);
+    std::sort(sortedValues.begin(), sortedValues.end());
+    std::vector<double> uniqueValues;
+    uniqueValues.reserve(n);
+    double tieCorrection = 0.0;
+    for (std::size_t i = 0; i < n;) {
+        std::size_t j = i;
+        while (j < n && sortedValues[j] == sortedValues[i]) ++j;
+        const double t = static_cast<double>(j - i);
+        tieCorrection += t * (t - 1.0) * (2.0 * t + 5.0);
+        uniqueValues.push_back(sortedValues[i]);
+        i = j;
+    }
+
+    const std::size_t m = uniqueValues.size();
+    std::vector<std::int64_t> tree(m + 1, 0);
+    auto prefixCount = [&tree](std::size_t rank) {
+        std::int64_t sum = 0;
+        for (; rank > 0; rank -= rank & (~rank + 1)) sum += tree[rank];
+        return sum;
+    };
+
+    std::int64_t s = 0;
+    for (std::size_t j = 0; j < n; ++j) {
+        const std::size_t rank = static_cast<std::size_t>(
+            std::lower_bound(uniqueValues.begin(), uniqueValues.end(), y[j]) - uniqueValues.begin()) + 1;
+        const std::int64_t less = prefixCount(rank - 1);
+        const std::int64_t greater = static_cast<std::int64_t>(j) - prefixCount(rank);
+        s += less - greater;
+        for (std::size_t r = rank; r <= m; r += r & (~r + 1)) tree[r] += 1;
+    }
+
+    const double dn = static_cast<double>(n);
+    result.s = static_cast<double>(s);
+    result.variance = (dn * (dn - 1.0) * (2.0 * dn + 5.0) - tieCorrection) / 18.0;
+    result.tau = result.s / (dn * (dn - 1.0) / 2.0);
+
+    if (result.variance > 0.0) {
+        const double sd = std::sqrt(result.variance);
+        if (s > 0) {
+            result.z = (result.s - 1.0) / sd;
+        } else if (s < 0) {
+            result.z = (result.s + 1.0) / sd;
+        }
+        result.pValue = std::erfc(std::abs(result.z) / std::sqrt(2.0));
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file TrendEstimator.h
+ * @brief Definicja klasy TrendEstimator - odpornych estymatorów trendu (Theil-Sen, test Manna-Kendalla).
+ */
+#ifndef TRENDESTIMATOR_H
+#define TRENDESTIMATOR_H
+
+#include <vector>
+
+/**
+ * @struct MannKendallResult
+ * @brief Wynik testu Manna-Kendalla na istnienie monotonicznego trendu.
+ */
+struct MannKendallResult {
+    double s = 0.0;        ///< Statystyka S = liczba par zgodnych - liczba par niezgodnych.
+    double variance = 0.0; ///< Wariancja S (z poprawką na wartości powtarzające się).
+    double z = 0.0;        ///< Statystyka Z (z poprawką na ciągłość).
+    double pValue = 1.0;   ///< Dwustronna wartość p.
+    double tau = 0.0;      ///< Współczynnik tau Kendalla (S / liczba par).
+};
+
+/**
+ * @class TrendEstimator
+ * @brief Odporne na wartości odstające estymatory trendu, działające w czasie O(n log n).
+ *
+ * Estymator Theila-Sena to mediana nachyleń wszystkich n(n-1)/2 par punktów - pojedynczy pik
+ * zanieczyszczenia nie zmienia jego znaku, w przeciwieństwie do regresji liniowej. Zamiast wyznaczać
+ * wszystkie nachylenia (O(n²)), wyszukiwana jest wartość θ, dla której liczba par o nachyleniu ≤ θ
+ * równa się randze mediany. Liczba takich par to liczba inwersji ciągu y_i - θ·x_i (zliczana
+ * sortowaniem przez scalanie w O(n log n)). Przedział θ jest zawężany interpolacją rangi z bisekcją
+ * jako zabezpieczeniem, a gdy zawiera nie więcej niż ok. n nachyleń, są one wyznaczane jawnie.
+ */
+class TrendEstimator
+{
+public:
+    /**
+     * @brief Oblicza nachylenie Theila-Sena (dokładna mediana nachyleń par).
+     * @param x Współrzędne X (np. czas w sekundach), w dowolnej kolejności.
+     * @param y Współrzędne Y; ten sam rozmiar co `x`.
+     * @return Nachylenie; 0.0 gdy po scaleniu punktów o tym samym X zostają mniej niż 2 punkty.
+     * @note Punkty o tym samym X są zastępowane jednym punktem ze średnią wartością Y.
+     *       Wartości NaN muszą być odfiltrowane wcześniej.
+     */
+    static double theilSenSlope(const std::vector<double>& x, const std::vector<double>& y);
+
+    /**
+     * @brief Wykonuje test Manna-Kendalla dla serii uporządkowanej w czasie, w czasie O(n log n).
+     * @param y Wartości serii w kolejności czasowej. Wartości NaN muszą być odfiltrowane wcześniej.
+     * @return Wynik testu; dla mniej niż 3 wartości pValue = 1.
+     * @note Test zakłada niezależność obserwacji - przy silnej autokorelacji (np. dane godzinowe)
+     *       wartość p jest zaniżona i powinna być interpretowana ostrożnie.
+     */
+    static MannKendallResult mannKendall(const std::vector<double>& y);
+};
+
+#endif // TRENDESTIMATOR_H
@@ -0,0 +1,174 @@
+#include "WriteBehindQueue.h"
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QThread>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+WriteBehindQueue::WriteBehindQueue(int capacity, int batchDelayMs)
+    : m_capacity(std::max(1, capacity))
+    , m_batchDelayMs(std::max(0, batchDelayMs))
+{
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName(QStringLiteral("WriteBehindQueue"));
+    m_thread->start();
+}
+
+WriteBehindQueue::~WriteBehindQueue()
+{
+    shutdown();
+}
+
+bool WriteBehindQueue::enqueue(const QString& key, WriteTask task)
+{
+    QMutexLocker locker(&m_mutex);
+    // Do końca shutdown() zadania są kolejkowane: wątek zapisu opróżnia kolejkę, a zapis wykonany od razu mógłby zostać
+    // nadpisany starszym, czekającym lub trwającym zapisem tego samego klucza.
+    if (m_stopped) {
+        locker.unlock();
+        qWarning() << "Write-behind queue is stopped, writing synchronously:" << key;
+        return task();
+    }
+
+    m_stats.enqueued++;
+    for (;;) {
+        if (m_pending.contains(key)) {
+            m_pending.insert(key, std::move(task));
+            m_stats.coalesced++;
+            return true;
+        }
+        if (m_pending.size() < m_capacity) {
+            break;
+        }
+        // Kolejka pełna: przerwanie okna zbierania partii i oczekiwanie, aż wątek zapisu pobierze zadania.
+        m_wakeUp.wakeAll();
+        m_spaceAvailable.wait(&m_mutex);
+    }
+
+    const bool wasEmpty = m_order.empty();
+    m_order.push_back(key);
+    m_pending.insert(key, std::move(task));
+    if (wasEmpty) {
+        m_workAvailable.wakeOne();
+    }
+    return true;
+}
+
+bool WriteBehindQueue::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 failedBefore = m_stats.failed;
+    m_flushWaiters++;
+    m_wakeUp.wakeAll();
+    while (!m_order.empty() || !m_inFlight.isEmpty()) {
+        m_batchDone.wait(&m_mutex);
+    }
+    m_flushWaiters--;
+    return m_stats.failed == failedBefore;
+}
+
+void WriteBehindQueue::flushKey(const QString& key)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending.contains(key) && !m_inFlight.contains(key)) {
+        return;
+    }
+    m_flushWaiters++;
+    m_wakeUp.wakeAll();
+    while (m_pending.contains(key) || m_inFlight.contains(key)) {
+        m_batchDone.wait(&m_mutex);
+    }
+    m_flushWaiters--;
+}
+
+void WriteBehindQueue::shutdown()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_thread) {
+            return;
+        }
+        thread = m_thread;
+        m_thread = nullptr;
+        m_stopping = true;
+        m_workAvailable.wakeAll();
+        m_wakeUp.wakeAll();
+        m_spaceAvailable.wakeAll();
+    }
+    thread->wait();
+    delete thread;
+}
+
+bool WriteBehindQueue::isPending(const QString& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.contains(key) || m_inFlight.contains(key);
+}
+
+int WriteBehindQueue::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.size();
+}
+
+int WriteBehindQueue::capacity() const
+{
+    return m_capacity;
+}
+
+WriteBehindStats WriteBehindQueue::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void WriteBehindQueue::run()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        while (m_order.empty() && !m_stopping) {
+            m_workAvailable.wait(&m_mutex);
+        }
+        if (m_order.empty()) {
+            m_stopped = true; // shutdown() i kolejka opróżniona
+            break;
+        }
+
+        // Okno zbierania partii: kolejne zlecenia tych samych kluczy są w tym czasie scalane, a pliki zapisywane razem.
+        // flush(), shutdown() i zapełnienie kolejki przerywają oczekiwanie.
+        QDeadlineTimer deadline(m_batchDelayMs);
+        while (!m_stopping && m_flushWaiters == 0 && m_pending.size() < m_capacity && !deadline.hasExpired()) {
+            m_wakeUp.wait(&m_mutex, deadline);
+        }
+
+        std::vector<std::pair<QString, WriteTask>> batch;
+        batch.reserve(m_order.size());
+        for (const QString& key : m_order) {
+            batch.emplace_back(key, m_pending.take(key));
+            m_inFlight.insert(key);
+        }
+        m_order.clear();
+        m_spaceAvailable.wakeAll();
+        locker.unlock();
+
+        quint64 written = 0;
+        quint64 failed = 0;
+        for (auto& entry : batch) {
+            if (entry.second()) {
+                written++;
+            } else {
+                failed++;
+                qWarning() << "Write-behind write failed:" << entry.first;
+            }
+        }
+
+        locker.relock();
+        m_inFlight.clear();
+        m_stats.written += written;
+        m_stats.failed += failed;
+        m_stats.batches++;
+        m_batchDone.wakeAll();
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file WriteBehindQueue.h
+ * @brief Definicja klasy WriteBehindQueue - kolejki zapisów wykonywanych w tle przez osobny wątek.
+ */
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QWaitCondition>
+#include <deque>
+#include <functional>
+
+class QThread;
+
+/**
+ * @struct WriteBehindStats
+ * @brief Liczniki kolejki zapisów (od utworzenia kolejki).
+ */
+struct WriteBehindStats {
+    quint64 enqueued = 0;  ///< Liczba zleconych zapisów.
+    quint64 coalesced = 0; ///< Zapisy zastąpione nowszym zapisem tego samego klucza, zanim trafiły na dysk.
+    quint64 written = 0;   ///< Wykonane zapisy zakończone powodzeniem.
+    quint64 failed = 0;    ///< Wykonane zapisy zakończone błędem.
+    quint64 batches = 0;   ///< Liczba partii przetworzonych przez wątek zapisu.
+};
+
+/**
+ * @class WriteBehindQueue
+ * @brief Ograniczona kolejka zapisów (write-behind) z jednym wątkiem zapisującym w tle.
+ *
+ * Zlecenie zapisu (enqueue()) tylko wstawia zadanie do kolejki, więc wątek wywołujący (np. GUI albo obsługa odpowiedzi
+ * API) nie czeka na dysk. Zadania są identyfikowane kluczem (nazwą pliku): nowszy zapis klucza, który jeszcze czeka
+ * w kolejce, zastępuje poprzedni (zachowując jego miejsce w kolejce) - seria pobrań tego samego czujnika kończy się
+ * jednym zapisem pliku.
+ *
+ * Wątek zapisu czeka krótko (`batchDelayMs`) po pierwszym zleceniu, a potem wykonuje wszystkie zebrane zadania jedną
+ * partią. Kolejka jest ograniczona liczbą różnych kluczy (`capacity`); po jej zapełnieniu enqueue() nowego klucza
+ * czeka, aż wątek zapisu pobierze partię. flush() i flushKey() czekają na zapisanie zaległych zadań (bez okna
+ * zbierania partii), a shutdown() (także destruktor) wykonuje wszystkie zaległe zadania przed zatrzymaniem wątku.
+ * Metody są bezpieczne wątkowo; nie wolno ich jednak wywoływać z zadań zapisu.
+ */
+class WriteBehindQueue
+{
+public:
+    /// Zadanie zapisu; zwraca `true`, jeśli zapis się powiódł.
+    using WriteTask = std::function<bool()>;
+
+    /// Domyślna maksymalna liczba różnych kluczy w kolejce.
+    static constexpr int DefaultCapacity = 4096;
+    /// Domyślny czas zbierania partii w milisekundach.
+    static constexpr int DefaultBatchDelayMs = 50;
+
+    /**
+     * @brief Konstruktor; uruchamia wątek zapisu.
+     * @param capacity Maksymalna liczba różnych kluczy oczekujących w kolejce (co najmniej 1).
+     * @param batchDelayMs Czas zbierania partii w milisekundach (0 - zapis zaraz po zleceniu).
+     */
+    explicit WriteBehindQueue(int capacity = DefaultCapacity, int batchDelayMs = DefaultBatchDelayMs);
+
+    /** @brief Destruktor; wykonuje zaległe zapisy (shutdown()). */
+    ~WriteBehindQueue();
+
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+    /**
+     * @brief Zleca zapis klucza `key`; zastępuje zapis tego klucza, który jeszcze czeka w kolejce.
+     *
+     * W trakcie shutdown() zadanie trafia jeszcze do kolejki, więc nie wyprzedzi starszego zapisu tego samego klucza.
+     * Po opróżnieniu kolejki przez shutdown() zadanie jest wykonywane od razu, w wątku wywołującym.
+     * @return `true`, jeśli zadanie trafiło do kolejki (lub, po shutdown(), zostało wykonane z powodzeniem).
+     */
+    bool enqueue(const QString& key, WriteTask task);
+
+    /**
+     * @brief Czeka na wykonanie wszystkich zleconych zapisów.
+     * @return `false`, jeśli któryś z zapisów zakończonych w czasie oczekiwania się nie powiódł.
+     */
+    bool flush();
+
+    /**
+     * @brief Czeka na wykonanie zleconego zapisu klucza `key` (np. przed odczytem pliku).
+     * Nie czeka, jeśli zapis klucza nie jest ani w kolejce, ani w trakcie wykonywania.
+     */
+    void flushKey(const QString& key);
+
+    /** @brief Wykonuje zaległe zapisy i zatrzymuje wątek zapisu. Kolejne wywołania nic nie robią. */
+    void shutdown();
+
+    /** @brief Czy zapis klucza czeka w kolejce lub jest w trakcie wykonywania. */
+    bool isPending(const QString& key) const;
+
+    /** @brief Liczba kluczy oczekujących w kolejce (bez partii w trakcie zapisu). */
+    int pendingCount() const;
+
+    /** @brief Maksymalna liczba różnych kluczy oczekujących w kolejce. */
+    int capacity() const;
+
+    /** @brief Zwraca liczniki kolejki. */
+    WriteBehindStats stats() const;
+
+private:
+    /// Pętla wątku zapisu.
+    void run();
+
+    const int m_capacity;                 ///< Maksymalna liczba kluczy w kolejce.
+    const int m_batchDelayMs;             ///< Czas zbierania partii.
+
+    mutable QMutex m_mutex;               ///< Chroni wszystkie pola poniżej.
+    QWaitCondition m_workAvailable;       ///< Nowe zadanie w pustej kolejce.
+    QWaitCondition m_wakeUp;              ///< Przerwanie okna zbierania partii (flush, shutdown).
+    QWaitCondition m_spaceAvailable;      ///< Wątek zapisu pobrał partię z kolejki.
+    QWaitCondition m_batchDone;           ///< Wątek zapisu zakończył partię.
+    std::deque<QString> m_order;          ///< Klucze w kolejności pierwszego zlecenia.
+    QHash<QString, WriteTask> m_pending;  ///< Klucz -> najnowsze zadanie.
+    QSet<QString> m_inFlight;             ///< Klucze partii w trakcie zapisu.
+    int m_flushWaiters = 0;               ///< Liczba wątków czekających w flush()/flushKey().
+    bool m_stopping = false;              ///< Wywołano shutdown().
+    bool m_stopped = false;               ///< Wątek zapisu opróżnił kolejkę po shutdown() i zakończył pracę.
+    WriteBehindStats m_stats;             ///< Liczniki.
+    QThread* m_thread = nullptr;          ///< Wątek zapisu (nullptr po shutdown()).
+};
+
+#endif // WRITEBEHINDQUEUE_H